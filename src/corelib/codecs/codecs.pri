@@ -15,6 +15,8 @@ SOURCES += \
     codecs/qtsciicodec.cpp \
     codecs/qutfcodec.cpp
 
+contains(QT_CPU_FEATURES.$$QT_ARCH, sse2): SSSE3_SOURCES += codecs/qutfcodec_ssse3.cpp
+
 contains(QT_CONFIG,icu) {
     HEADERS += \
         codecs/qicucodec_p.h
@@ -139,6 +139,32 @@ static inline bool simdDecodeAscii(ushort *, const uchar *, const uchar *, const
 }
 #endif
 
+#if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_SSSE3)
+// in qutfcodec_ssse3.cpp
+bool qt_encode_utf8_ssse3(uchar *&dst, const ushort *&src, const ushort *end);
+bool qt_decode_utf8_ssse3(ushort *&dst, const uchar *&src, const uchar *end);
+
+static inline bool simdEncodeNonAscii(uchar *&dst, const ushort *&src, const ushort *end)
+{
+    return qCpuHasFeature(SSSE3) && qt_encode_utf8_ssse3(dst, src, end);
+}
+
+static inline bool simdDecodeNonAscii(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    return qCpuHasFeature(SSSE3) && qt_decode_utf8_ssse3(dst, src, end);
+}
+#else
+static inline bool simdEncodeNonAscii(uchar *, const ushort *, const ushort *)
+{
+    return false;
+}
+
+static inline bool simdDecodeNonAscii(ushort *, const uchar *, const uchar *)
+{
+    return false;
+}
+#endif
+
 QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
 {
     // create a QByteArray with the worst case scenario size
@@ -151,6 +177,8 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
         const ushort *nextAscii = end;
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
+        if (simdEncodeNonAscii(dst, src, end))
+            continue;
 
         do {
             ushort uc = *src++;
@@ -203,8 +231,14 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::Conve
             surrogate_high = -1;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
         } else {
-            if (src >= nextAscii && simdEncodeAscii(cursor, nextAscii, src, end))
-                break;
+            if (src >= nextAscii) {
+                if (simdEncodeAscii(cursor, nextAscii, src, end))
+                    break;
+                if (simdEncodeNonAscii(cursor, src, end)) {
+                    nextAscii = src;
+                    continue;
+                }
+            }
 
             uc = *src++;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
@@ -257,6 +291,8 @@ QString QUtf8::convertToUnicode(const char *chars, int len)
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            if (simdDecodeNonAscii(dst, src, end))
+                continue;
 
             do {
                 uchar b = *src++;
@@ -277,7 +313,7 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
 {
     bool headerdone = false;
     ushort replacement = QChar::ReplacementCharacter;
-    int need = 0;
+    int need = state ? state->remainingChars : 0;
     int invalid = 0;
     int res;
     uchar ch = 0;
@@ -312,8 +348,12 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
                 memcpy(&state->state_data[0], remainingCharsData, state->remainingChars);
                 return QString();
             } else if (res == QUtf8BaseTraits::Error) {
-                ++invalid;
-                *dst++ = replacement;
+                // what we kept is a start byte followed by continuation bytes;
+                // each of them is an error on its own, like in the stateless case
+                res = remainingCharsCount;
+                invalid += res;
+                for (int i = 0; i < res; ++i)
+                    *dst++ = replacement;
             } else if (!headerdone && res >= 0) {
                 // eat the UTF-8 BOM
                 headerdone = true;
@@ -331,8 +371,20 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     res = 0;
     const uchar *nextAscii = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            const uchar *asciiStart = src;
+            const bool allAscii = simdDecodeAscii(dst, nextAscii, src, end);
+            if (src != asciiStart)
+                headerdone = true;      // a BOM is only one as the first character
+            if (allAscii)
+                break;
+
+            // the regular decoder takes care of the BOM
+            if (headerdone && simdDecodeNonAscii(dst, src, end)) {
+                nextAscii = src;
+                continue;
+            }
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
@@ -11,7 +11,7 @@ DEFINES   += QT_NO_USING_NAMESPACE
 win32-msvc*|win32-icc:QMAKE_LFLAGS += /BASE:0x67000000
 irix-cc*:QMAKE_CXXFLAGS += -no_prelink -ptused
 
-CONFIG += optimize_full
+CONFIG += simd optimize_full
 
 # otherwise mingw headers do not declare common functions like putenv
 mingw:QMAKE_CXXFLAGS_CXX11 = -std=gnu++0x
@@ -41,6 +41,9 @@
 
 #include "qjson_p.h"
 #include <qalgorithms.h>
+#include <qfile.h>
+#include <qmutex.h>
+#include <qset.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -56,6 +59,49 @@ namespace QJsonPrivate
 static const Base emptyArray = { { Q_TO_LITTLE_ENDIAN(sizeof(Base)) }, { 0 }, { 0 } };
 static const Base emptyObject = { { Q_TO_LITTLE_ENDIAN(sizeof(Base)) }, { 0 }, { 0 } };
 
+/*
+    Containers of data that is validated on access, which have already
+    been checked. The keys are the offset of the container in the data
+    shifted left by one, with the lowest bit set for objects. Only data
+    loaded with QJsonDocument::ValidateOnAccess has a cache, for all other
+    data isValidOnAccess() returns without locking.
+ */
+struct ValidationCache
+{
+    QMutex mutex;
+    QSet<quint64> containers;
+};
+
+static inline quint64 validationKey(uint offset, QJsonValue::Type type)
+{
+    return (quint64(offset) << 1) | (type == QJsonValue::Object);
+}
+
+static inline bool isValidContainer(const Base *b, QJsonValue::Type type, bool recursive)
+{
+    if (type == QJsonValue::Object)
+        return static_cast<const Object *>(b)->isValid(recursive);
+    return static_cast<const Array *>(b)->isValid(recursive);
+}
+
+Data::~Data()
+{
+    if (ownsData)
+        free(rawData);
+    delete mappedFile;
+    delete validationCache;
+}
+
+/*
+    Nested containers of data that is validated on access, that have not
+    been accessed yet, are not known to fit into their parent. Corrupt
+    ones are replaced by null values when the data is compacted instead
+    of being copied.
+ */
+static inline bool isCorruptContainer(const Data *d, const Base *b, const Value &v)
+{
+    return (v.type == QJsonValue::Array || v.type == QJsonValue::Object) && !d->isValidOnAccess(b, v);
+}
 
 void Data::compact()
 {
@@ -68,12 +114,19 @@ void Data::compact()
     int reserve = 0;
     if (base->is_object) {
         Object *o = static_cast<Object *>(base);
-        for (int i = 0; i < (int)o->length; ++i)
-            reserve += o->entryAt(i)->usedStorage(o);
+        for (int i = 0; i < (int)o->length; ++i) {
+            const Entry *e = o->entryAt(i);
+            if (isCorruptContainer(this, o, e->value))
+                reserve += e->size();
+            else
+                reserve += e->usedStorage(o);
+        }
     } else {
         Array *a = static_cast<Array *>(base);
-        for (int i = 0; i < (int)a->length; ++i)
-            reserve += (*a)[i].usedStorage(a);
+        for (int i = 0; i < (int)a->length; ++i) {
+            if (!isCorruptContainer(this, a, (*a)[i]))
+                reserve += (*a)[i].usedStorage(a);
+        }
     }
 
     int size = sizeof(Base) + reserve + base->length*sizeof(offset);
@@ -101,6 +154,11 @@ void Data::compact()
             memcpy(ne, e, s);
             offset += s;
             int dataSize = e->value.usedStorage(o);
+            if (isCorruptContainer(this, o, e->value)) {
+                ne->value.type = QJsonValue::Null;
+                ne->value.value = 0;
+                dataSize = 0;
+            }
             if (dataSize) {
                 memcpy((char *)no + offset, e->value.data(o), dataSize);
                 ne->value.value = offset;
@@ -116,6 +174,11 @@ void Data::compact()
             Value &nv = (*na)[i];
             nv = v;
             int dataSize = v.usedStorage(a);
+            if (isCorruptContainer(this, a, v)) {
+                nv.type = QJsonValue::Null;
+                nv.value = 0;
+                dataSize = 0;
+            }
             if (dataSize) {
                 memcpy((char *)na + offset, v.data(a), dataSize);
                 nv.value = offset;
@@ -129,6 +192,10 @@ void Data::compact()
     header = h;
     this->alloc = alloc;
     compactionCounter = 0;
+
+    // the containers have moved
+    if (validationCache)
+        enableValidationOnAccess();
 }
 
 bool Data::valid() const
@@ -145,6 +212,60 @@ bool Data::valid() const
     return res;
 }
 
+/*
+    Checks the header and the root container, without descending into the
+    values it contains. Nested containers are checked by isValidOnAccess()
+    the first time they are accessed.
+ */
+bool Data::enableValidationOnAccess()
+{
+    if (!validationCache)
+        validationCache = new ValidationCache;
+    validationCache->containers.clear();
+
+    if (header->tag != QJsonDocument::BinaryFormatTag || header->version != 1u)
+        return false;
+
+    const Base *root = header->root();
+    if (sizeof(Header) + root->size > uint(alloc))
+        return false;
+    const QJsonValue::Type type = root->is_object ? QJsonValue::Object : QJsonValue::Array;
+    if (!isValidContainer(root, type, false))
+        return false;
+
+    validationCache->containers.insert(validationKey(offsetOf(root), type));
+    return true;
+}
+
+bool Data::checkOnAccess(const Base *parent, const Value &v) const
+{
+    // Always check that the container fits into its parent, even when the
+    // same data was accessed through another parent before, so that no
+    // container can contain itself.
+    const Base *b = v.base(parent);
+    if (b->size > parent->tableOffset - v.value)
+        return false;
+
+    const QJsonValue::Type type = QJsonValue::Type(uint(v.type));
+    const quint64 key = validationKey(offsetOf(b), type);
+    QMutexLocker locker(&validationCache->mutex);
+    if (validationCache->containers.contains(key))
+        return true;
+    if (!isValidContainer(b, type, false))
+        return false;
+    validationCache->containers.insert(key);
+    return true;
+}
+
+/*
+    The writer walks the data directly, so data that is validated on
+    access has to be checked completely before it is written.
+ */
+bool Data::isValidForWriting(const Base *b, QJsonValue::Type type) const
+{
+    return !validationCache || isValidContainer(b, type, true);
+}
+
 
 int Base::reserveSpace(uint dataSize, int posInTable, uint numItems, bool replace)
 {
@@ -203,7 +324,7 @@ int Object::indexOf(const QString &key, bool *exists)
     return min;
 }
 
-bool Object::isValid() const
+bool Object::isValid(bool recursive) const
 {
     if (tableOffset + length*sizeof(offset) > size)
         return false;
@@ -216,7 +337,7 @@ bool Object::isValid() const
         int s = e->size();
         if (table()[i] + s > tableOffset)
             return false;
-        if (!e->value.isValid(this))
+        if (!e->value.isValid(this, recursive))
             return false;
     }
     return true;
@@ -224,13 +345,13 @@ bool Object::isValid() const
 
 
 
-bool Array::isValid() const
+bool Array::isValid(bool recursive) const
 {
     if (tableOffset + length*sizeof(offset) > size)
         return false;
 
     for (uint i = 0; i < length; ++i) {
-        if (!at(i).isValid(this))
+        if (!at(i).isValid(this, recursive))
             return false;
     }
     return true;
@@ -299,7 +420,7 @@ int Value::usedStorage(const Base *b) const
     return alignedSize(s);
 }
 
-bool Value::isValid(const Base *b) const
+bool Value::isValid(const Base *b, bool recursive) const
 {
     int offset = 0;
     switch (type) {
@@ -311,6 +432,10 @@ bool Value::isValid(const Base *b) const
     case QJsonValue::Array:
     case QJsonValue::Object:
         offset = value;
+        // the data follows the header of the container, an offset of 0
+        // would make a nested container refer to itself
+        if (offset < (int)sizeof(Base))
+            return false;
         break;
     case QJsonValue::Null:
     case QJsonValue::Bool:
@@ -323,11 +448,18 @@ bool Value::isValid(const Base *b) const
     if (offset + sizeof(uint) > b->tableOffset)
         return false;
 
+    // Without recursion the nested containers are not touched at all, their
+    // size is checked by Data::isValidOnAccess() once they are accessed
+    if (!recursive && (type == QJsonValue::Array || type == QJsonValue::Object))
+        return offset + sizeof(Base) <= b->tableOffset;
+
     int s = usedStorage(b);
     if (!s)
         return true;
     if (s < 0 || offset + s > (int)b->tableOffset)
         return false;
+    if (!recursive)
+        return true;
     if (type == QJsonValue::Array)
         return static_cast<Array *>(base(b))->isValid();
     if (type == QJsonValue::Object)
@@ -67,6 +67,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QFile;
+
 /*
   This defines a binary data structure for Json data. The data structure is optimised for fast reading
   and minimum allocations. The whole data structure can be mmap'ed and used directly.
@@ -127,6 +129,7 @@ class Array;
 class Object;
 class Value;
 class Entry;
+struct ValidationCache;
 
 template<typename T>
 class q_littleendian
@@ -528,7 +531,7 @@ public:
     }
     int indexOf(const QString &key, bool *exists);
 
-    bool isValid() const;
+    bool isValid(bool recursive = true) const;
 };
 
 
@@ -538,7 +541,7 @@ public:
     inline Value at(int i) const;
     inline Value &operator [](int i);
 
-    bool isValid() const;
+    bool isValid(bool recursive = true) const;
 };
 
 
@@ -567,7 +570,7 @@ public:
     Latin1String asLatin1String(const Base *b) const;
     Base *base(const Base *b) const;
 
-    bool isValid(const Base *b) const;
+    bool isValid(const Base *b, bool recursive = true) const;
 
     static int requiredStorage(QJsonValue &v, bool *compressed);
     static uint valueToStore(const QJsonValue &v, uint offset);
@@ -711,13 +714,17 @@ public:
     };
     uint compactionCounter : 31;
     uint ownsData : 1;
+    QFile *mappedFile;
+    ValidationCache *validationCache;
 
     inline Data(char *raw, int a)
-        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true)
+        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true),
+          mappedFile(0), validationCache(0)
     {
     }
     inline Data(int reserved, QJsonValue::Type valueType)
-        : rawData(0), compactionCounter(0), ownsData(true)
+        : rawData(0), compactionCounter(0), ownsData(true),
+          mappedFile(0), validationCache(0)
     {
         Q_ASSERT(valueType == QJsonValue::Array || valueType == QJsonValue::Object);
 
@@ -732,8 +739,7 @@ public:
         b->tableOffset = sizeof(Base);
         b->length = 0;
     }
-    inline ~Data()
-    { if (ownsData) free(rawData); }
+    ~Data();
 
     uint offsetOf(const void *ptr) const { return (uint)(((char *)ptr - rawData)); }
 
@@ -750,7 +756,7 @@ public:
     Data *clone(Base *b, int reserve = 0)
     {
         int size = sizeof(Header) + b->size;
-        if (b == header->root() && ref.load() == 1 && alloc >= size + reserve)
+        if (b == header->root() && ref.load() == 1 && ownsData && alloc >= size + reserve)
             return this;
 
         if (reserve) {
@@ -766,13 +772,21 @@ public:
         h->version = 1;
         Data *d = new Data(raw, size);
         d->compactionCounter = (b == header->root()) ? compactionCounter : 0;
+        if (validationCache)
+            d->enableValidationOnAccess();
         return d;
     }
 
     void compact();
     bool valid() const;
+    bool enableValidationOnAccess();
+    inline bool isValidOnAccess(const Base *parent, const Value &v) const
+    { return !validationCache || checkOnAccess(parent, v); }
+    bool isValidForWriting(const Base *b, QJsonValue::Type type) const;
 
 private:
+    bool checkOnAccess(const Base *parent, const Value &v) const;
+
     Q_DISABLE_COPY(Data)
 };
 
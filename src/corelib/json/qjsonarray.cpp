@@ -1089,7 +1089,7 @@ void QJsonArray::detach(uint reserve)
         d->ref.ref();
         return;
     }
-    if (reserve == 0 && d->ref.load() == 1)
+    if (reserve == 0 && d->ref.load() == 1 && d->ownsData)
         return;
 
     QJsonPrivate::Data *x = d->clone(a, reserve);
@@ -1117,7 +1117,7 @@ void QJsonArray::compact()
 #if !defined(QT_NO_DEBUG_STREAM) && !defined(QT_JSON_READONLY)
 QDebug operator<<(QDebug dbg, const QJsonArray &a)
 {
-    if (!a.a) {
+    if (!a.a || !a.d->isValidForWriting(a.a, QJsonValue::Array)) {
         dbg << "QJsonArray()";
         return dbg;
     }
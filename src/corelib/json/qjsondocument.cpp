@@ -45,6 +45,8 @@
 #include <qjsonarray.h>
 #include <qstringlist.h>
 #include <qvariant.h>
+#include <qfile.h>
+#include <qscopedpointer.h>
 #include <qdebug.h>
 #include "qjsonwriter_p.h"
 #include "qjsonparser_p.h"
@@ -74,8 +76,8 @@ QT_BEGIN_NAMESPACE
     and isObject(). The array or object contained in the document can be retrieved using
     array() or object() and then read or manipulated.
 
-    A document can also be created from a stored binary representation using fromBinaryData() or
-    fromRawData().
+    A document can also be created from a stored binary representation using fromBinaryData(),
+    fromRawData() or fromBinaryFile().
 
     \sa {JSON Support in Qt}, {JSON Save Game Example}
 */
@@ -163,8 +165,25 @@ QJsonDocument &QJsonDocument::operator =(const QJsonDocument &other)
   \value BypassValidation Bypasses data validation. Only use if you received the
   data from a trusted place and know it's valid, as using of invalid data can crash
   the application.
+  \value ValidateOnAccess Only validate the top-level object or array before
+  returning the document. Nested objects and arrays are validated the first time
+  they are accessed, and read as undefined values if they are not valid. This
+  value was introduced in Qt 5.4.
   */
 
+static bool validateData(QJsonPrivate::Data *d, QJsonDocument::DataValidation validation)
+{
+    switch (validation) {
+    case QJsonDocument::BypassValidation:
+        return true;
+    case QJsonDocument::ValidateOnAccess:
+        return d->enableValidationOnAccess();
+    case QJsonDocument::Validate:
+        break;
+    }
+    return d->valid();
+}
+
 /*!
  Creates a QJsonDocument that uses the first \a size bytes from
  \a data. It assumes \a data contains a binary encoded JSON document.
@@ -192,7 +211,7 @@ QJsonDocument QJsonDocument::fromRawData(const char *data, int size, DataValidat
     QJsonPrivate::Data *d = new QJsonPrivate::Data((char *)data, size);
     d->ownsData = false;
 
-    if (validation != BypassValidation && !d->valid()) {
+    if (!validateData(d, validation)) {
         delete d;
         return QJsonDocument();
     }
@@ -249,7 +268,59 @@ QJsonDocument QJsonDocument::fromBinaryData(const QByteArray &data, DataValidati
     memcpy(raw, data.constData(), size);
     QJsonPrivate::Data *d = new QJsonPrivate::Data(raw, size);
 
-    if (validation != BypassValidation && !d->valid()) {
+    if (!validateData(d, validation)) {
+        delete d;
+        return QJsonDocument();
+    }
+
+    return QJsonDocument(d);
+}
+
+/*!
+ \since 5.4
+
+ Creates a QJsonDocument from the binary encoded JSON document stored in
+ the file \a fileName.
+
+ Where possible the file is mapped into memory instead of being read, so
+ with \a validation set to ValidateOnAccess only the parts of the document
+ that are used are loaded. The file has to stay unchanged as long as any
+ QJsonDocument, QJsonObject or QJsonArray still references the data.
+
+ If the file cannot be read or \a validation finds that the data is not
+ valid, the method returns a null document.
+
+ \sa fromBinaryData(), fromRawData(), isNull(), DataValidation
+ */
+QJsonDocument QJsonDocument::fromBinaryFile(const QString &fileName, DataValidation validation)
+{
+    QScopedPointer<QFile> file(new QFile(fileName));
+    if (!file->open(QIODevice::ReadOnly))
+        return QJsonDocument();
+
+    const qint64 size = file->size();
+    if (size < qint64(sizeof(QJsonPrivate::Header) + sizeof(QJsonPrivate::Base)) || size > INT_MAX)
+        return QJsonDocument();
+
+    uchar *data = file->map(0, size);
+    if (!data)
+        return fromBinaryData(file->readAll(), validation);
+
+    QJsonPrivate::Header h;
+    memcpy(&h, data, sizeof(QJsonPrivate::Header));
+    QJsonPrivate::Base root;
+    memcpy(&root, data + sizeof(QJsonPrivate::Header), sizeof(QJsonPrivate::Base));
+
+    if (h.tag != QJsonDocument::BinaryFormatTag || h.version != 1u ||
+        sizeof(QJsonPrivate::Header) + root.size > quint64(size))
+        return QJsonDocument();
+
+    QJsonPrivate::Data *d = new QJsonPrivate::Data(reinterpret_cast<char *>(data),
+                                                   sizeof(QJsonPrivate::Header) + root.size);
+    d->ownsData = false;
+    d->mappedFile = file.take();
+
+    if (!validateData(d, validation)) {
         delete d;
         return QJsonDocument();
     }
@@ -346,6 +417,10 @@ QByteArray QJsonDocument::toJson(JsonFormat format) const
     if (!d)
         return QByteArray();
 
+    QJsonPrivate::Base *root = d->header->root();
+    if (!d->isValidForWriting(root, root->isArray() ? QJsonValue::Array : QJsonValue::Object))
+        return QByteArray();
+
     QByteArray json;
 
     if (d->header->root()->isArray())
@@ -569,7 +644,8 @@ bool QJsonDocument::isNull() const
 #if !defined(QT_NO_DEBUG_STREAM) && !defined(QT_JSON_READONLY)
 QDebug operator<<(QDebug dbg, const QJsonDocument &o)
 {
-    if (!o.d) {
+    QJsonPrivate::Base *root = o.d ? o.d->header->root() : 0;
+    if (!root || !o.d->isValidForWriting(root, root->isArray() ? QJsonValue::Array : QJsonValue::Object)) {
         dbg << "QJsonDocument()";
         return dbg;
     }
@@ -96,7 +96,8 @@ public:
 
     enum DataValidation {
         Validate,
-        BypassValidation
+        BypassValidation,
+        ValidateOnAccess
     };
 
     static QJsonDocument fromRawData(const char *data, int size, DataValidation validation = Validate);
@@ -105,6 +106,8 @@ public:
     static QJsonDocument fromBinaryData(const QByteArray &data, DataValidation validation  = Validate);
     QByteArray toBinaryData() const;
 
+    static QJsonDocument fromBinaryFile(const QString &fileName, DataValidation validation = Validate);
+
     static QJsonDocument fromVariant(const QVariant &variant);
     QVariant toVariant() const;
 
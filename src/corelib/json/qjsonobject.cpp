@@ -980,7 +980,7 @@ void QJsonObject::detach(uint reserve)
         d->ref.ref();
         return;
     }
-    if (reserve == 0 && d->ref.load() == 1)
+    if (reserve == 0 && d->ref.load() == 1 && d->ownsData)
         return;
 
     QJsonPrivate::Data *x = d->clone(o, reserve);
@@ -1041,7 +1041,7 @@ void QJsonObject::setValueAt(int i, const QJsonValue &val)
 #if !defined(QT_NO_DEBUG_STREAM) && !defined(QT_JSON_READONLY)
 QDebug operator<<(QDebug dbg, const QJsonObject &o)
 {
-    if (!o.o) {
+    if (!o.o || !o.d->isValidForWriting(o.o, QJsonValue::Object)) {
         dbg << "QJsonObject()";
         return dbg;
     }
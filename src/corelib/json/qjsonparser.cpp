@@ -44,8 +44,10 @@
 #include <qcoreapplication.h>
 #endif
 #include <qdebug.h>
+#include <qvarlengtharray.h>
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
+#include "private/qlocale_p.h"
 #include "private/qutfcodec_p.h"
 
 //#define PARSER_DEBUG
@@ -700,12 +702,16 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
         return false;
     }
 
-    QByteArray number(start, json - start);
-    DEBUG << "numberstring" << number;
+    // null-terminated copy for the conversion functions, on the stack for all sane numbers
+    const int length = json - start;
+    QVarLengthArray<char, 64> number(length + 1);
+    memcpy(number.data(), start, length);
+    number[length] = '\0';
+    DEBUG << "numberstring" << number.constData();
 
     if (isInt) {
         bool ok;
-        int n = number.toInt(&ok);
+        qint64 n = QLocaleData::bytearrayToLongLong(number.constData(), 10, &ok);
         if (ok && n < (1<<25) && n > -(1<<25)) {
             val->int_value = n;
             val->latinOrIntValue = true;
@@ -719,7 +725,7 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
         quint64 ui;
         double d;
     };
-    d = number.toDouble(&ok);
+    d = QLocaleData::bytearrayToDouble(number.constData(), &ok);
 
     if (!ok) {
         lastError = QJsonParseError::IllegalNumber;
@@ -121,6 +121,11 @@ QJsonValue::QJsonValue(QJsonPrivate::Data *data, QJsonPrivate::Base *base, const
     }
     case Array:
     case Object:
+        if (!data->isValidOnAccess(base, v)) {
+            t = Undefined;
+            dbl = 0;
+            break;
+        }
         d = data;
         this->base = v.base(base);
         break;
@@ -135,6 +135,13 @@ unix|integrity {
             kernel/qeventdispatcher_unix_p.h \
             kernel/qtimerinfo_unix_p.h
 
+    contains(QT_CONFIG, epoll) {
+        SOURCES += \
+            kernel/qeventdispatcher_epoll.cpp
+        HEADERS += \
+            kernel/qeventdispatcher_epoll_p.h
+    }
+
     contains(QT_CONFIG, glib) {
         SOURCES += \
             kernel/qeventdispatcher_glib.cpp
@@ -82,6 +82,9 @@
 #    if !defined(QT_NO_GLIB)
 #      include "qeventdispatcher_glib_p.h"
 #    endif
+#    if !defined(QT_NO_EPOLL)
+#      include "qeventdispatcher_epoll_p.h"
+#    endif
 #    include "qeventdispatcher_unix_p.h"
 #  endif
 #endif
@@ -310,6 +313,10 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
+    if (currentThreadData->postEventList.hasLockFreeEvents()) {
+        QMutexLocker locker(&currentThreadData->postEventList.mutex);
+        currentThreadData->takeLockFreePostedEvents();
+    }
     return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
 }
 
@@ -457,6 +464,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         QMutexLocker locker(&threadData->postEventList.mutex);
+        threadData->takeLockFreePostedEvents();
         for (int i = 0; i < threadData->postEventList.size(); ++i) {
             const QPostEvent &pe = threadData->postEventList.at(i);
             if (pe.event) {
@@ -479,6 +487,11 @@ void QCoreApplicationPrivate::createEventDispatcher()
 #  if defined(Q_OS_BLACKBERRY)
     eventDispatcher = new QEventDispatcherBlackberry(q);
 #  else
+#  if !defined(QT_NO_EPOLL)
+    if (QEventDispatcherEpoll::isRequested())
+        eventDispatcher = new QEventDispatcherEpoll(q);
+    else
+#  endif
 #  if !defined(QT_NO_GLIB)
     if (qEnvironmentVariableIsEmpty("QT_NO_GLIB") && QEventDispatcherGlib::versionSupported())
         eventDispatcher = new QEventDispatcherGlib(q);
@@ -1288,6 +1301,35 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+#ifndef QT_NO_THREAD
+    // Queued signals are never compressed and always use the normal
+    // priority, so they can be handed over without taking the post event
+    // mutex. The event is pushed onto a lock-free stack that the receiving
+    // thread moves into postEventList before looking at it.
+    if (event->type() == QEvent::MetaCall && priority == Qt::NormalEventPriority) {
+        QPostEventList &list = data->postEventList;
+        list.lockFreePosters.ref();
+        // QObject::moveToThread() waits for lockFreePosters to drop to zero
+        // after changing the thread data, so if the receiver is still ours
+        // here, the event cannot be stranded in the old thread
+        if (data == *pdata) {
+            event->posted = true;
+            const bool wakeUp = list.pushLockFree(receiver, static_cast<QMetaCallEvent *>(event));
+            list.lockFreePosters.deref();
+
+            // nobody else has woken the receiving thread since it last
+            // emptied the stack, do so
+            if (wakeUp) {
+                QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadAcquire();
+                if (dispatcher)
+                    dispatcher->wakeUp();
+            }
+            return;
+        }
+        list.lockFreePosters.deref();
+    }
+#endif
+
     // lock the post event mutex
     data->postEventList.mutex.lock();
 
@@ -1307,6 +1349,9 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     QMutexUnlocker locker(&data->postEventList.mutex);
 
+    // keep the events posted through the lock-free path ahead of this one
+    data->takeLockFreePostedEvents();
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1414,6 +1459,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->takeLockFreePostedEvents();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1570,6 +1616,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     QThreadData *data = receiver ? receiver->d_func()->threadData : QThreadData::current();
     QMutexLocker locker(&data->postEventList.mutex);
+    data->takeLockFreePostedEvents();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1635,6 +1682,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->takeLockFreePostedEvents();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
@@ -0,0 +1,651 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplatformdefs.h"
+
+#include "qcoreapplication.h"
+#include "qelapsedtimer.h"
+#include "qsocketnotifier.h"
+#include "qthread.h"
+
+#include "qeventdispatcher_epoll_p.h"
+#include <private/qthread_p.h>
+#include <private/qcoreapplication_p.h>
+#include <private/qcore_unix_p.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+#ifndef QT_NO_EVENTFD
+#  include <sys/eventfd.h>
+#endif
+
+#ifndef QT_NO_EPOLL
+
+QT_BEGIN_NAMESPACE
+
+// the number of ready descriptors fetched per epoll_wait(); descriptors that
+// are still ready are reported again by the next (level-triggered) wait
+enum { MaxEpollEvents = 256 };
+
+static const char *socketNotifierTypeName(int type)
+{
+    static const char *t[] = { "Read", "Write", "Exception" };
+    return t[type];
+}
+
+static quint32 epollEventsFor(const QEpollSocketNotifiers *sn)
+{
+    quint32 events = 0;
+    if (sn->notifiers[QSocketNotifier::Read])
+        events |= EPOLLIN;
+    if (sn->notifiers[QSocketNotifier::Write])
+        events |= EPOLLOUT;
+    if (sn->notifiers[QSocketNotifier::Exception])
+        events |= EPOLLPRI;
+    return events;
+}
+
+QEventDispatcherEpollPrivate::QEventDispatcherEpollPrivate()
+    : epollFd(-1), timerFd(-1), timerFdArmed(false)
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1) {
+        perror("QEventDispatcherEpollPrivate(): Unable to create epoll instance");
+        qFatal("QEventDispatcherEpollPrivate(): Can not continue without an epoll instance");
+    }
+
+    bool pipefail = false;
+#ifndef QT_NO_EVENTFD
+    thread_pipe[0] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (thread_pipe[0] != -1)
+        thread_pipe[1] = -1;
+    else // fall through the next "if"
+#endif
+    if (qt_safe_pipe(thread_pipe, O_NONBLOCK) == -1) {
+        perror("QEventDispatcherEpollPrivate(): Unable to create thread pipe");
+        pipefail = true;
+    }
+
+    if (!pipefail) {
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.fd = thread_pipe[0];
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, thread_pipe[0], &ev) == -1) {
+            perror("QEventDispatcherEpollPrivate(): Unable to watch thread pipe");
+            pipefail = true;
+        }
+    }
+
+    if (pipefail)
+        qFatal("QEventDispatcherEpollPrivate(): Can not continue without a thread pipe");
+
+    // the timerfd must use the clock that QTimerInfoList measures timeouts with
+    timerFd = timerfd_create(QElapsedTimer::isMonotonic() ? CLOCK_MONOTONIC : CLOCK_REALTIME,
+                             TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd != -1) {
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.fd = timerFd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &ev) == -1) {
+            close(timerFd);
+            timerFd = -1;
+        }
+    }
+    timerFdDeadline.tv_sec = 0;
+    timerFdDeadline.tv_nsec = 0;
+
+    // the timer wheel changes the firing order of timers due together
+    timerList.setTimerWheelEnabled(QTimerInfoList::isTimerWheelRequested());
+}
+
+QEventDispatcherEpollPrivate::~QEventDispatcherEpollPrivate()
+{
+    close(thread_pipe[0]);
+    if (thread_pipe[1] != -1)
+        close(thread_pipe[1]);
+    if (timerFd != -1)
+        close(timerFd);
+    close(epollFd);
+
+    qDeleteAll(socketNotifiers);
+
+    // cleanup timers
+    qDeleteAll(timerList);
+}
+
+/*
+    Brings the epoll registration of \a fd in line with \a events. An empty
+    mask removes the descriptor from the epoll set altogether.
+*/
+bool QEventDispatcherEpollPrivate::updateEpoll(int fd, QEpollSocketNotifiers *sn, quint32 events)
+{
+    if (sn->events == events)
+        return true;
+
+    epoll_event ev;
+    ev.events = events;
+    ev.data.fd = fd;
+
+    int op = !sn->events ? EPOLL_CTL_ADD : (!events ? EPOLL_CTL_DEL : EPOLL_CTL_MOD);
+    int ret = epoll_ctl(epollFd, op, fd, &ev);
+    if (ret == -1) {
+        if (op == EPOLL_CTL_DEL && (errno == ENOENT || errno == EBADF)) {
+            // the descriptor was closed before its notifiers were disabled;
+            // the kernel already dropped it from the epoll set
+            ret = 0;
+        } else if (op == EPOLL_CTL_MOD && errno == ENOENT) {
+            // closed and reused behind our back, register the new one
+            ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        } else if (op == EPOLL_CTL_ADD && errno == EEXIST) {
+            ret = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+        }
+    }
+
+    if (ret == -1)
+        return false;
+    sn->events = events;
+    return true;
+}
+
+/*
+    Arms the timerfd to expire at the absolute time \a deadline, or disarms it
+    if \a deadline is 0. The timerfd is only touched when the deadline changes.
+*/
+bool QEventDispatcherEpollPrivate::updateTimerFd(const timespec *deadline)
+{
+    if (!deadline) {
+        if (!timerFdArmed)
+            return true;
+        timerFdArmed = false;
+    } else if (timerFdArmed && *deadline == timerFdDeadline) {
+        return true;
+    }
+
+    itimerspec its;
+    its.it_interval.tv_sec = 0;
+    its.it_interval.tv_nsec = 0;
+    its.it_value.tv_sec = 0;
+    its.it_value.tv_nsec = 0;
+    if (deadline) {
+        its.it_value = *deadline;
+        // an all-zero value would disarm the timer instead
+        if (!its.it_value.tv_sec && !its.it_value.tv_nsec)
+            its.it_value.tv_nsec = 1;
+    }
+
+    if (timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &its, 0) == -1) {
+        timerFdArmed = false;
+        return !deadline;
+    }
+    if (deadline) {
+        timerFdArmed = true;
+        timerFdDeadline = *deadline;
+    }
+    return true;
+}
+
+void QEventDispatcherEpollPrivate::processTimerFd()
+{
+    // the timers themselves are activated by QTimerInfoList::activateTimers()
+    quint64 expirations;
+    while (::read(timerFd, &expirations, sizeof(expirations)) > 0) {
+    }
+    timerFdArmed = false;
+}
+
+void QEventDispatcherEpollPrivate::markPending(QSocketNotifier *notifier)
+{
+    for (int i = 0; i < pendingNotifiers.size(); ++i) {
+        if (pendingNotifiers.at(i) == notifier)
+            return;
+    }
+    pendingNotifiers.append(notifier);
+}
+
+int QEventDispatcherEpollPrivate::doWait(QEventLoop::ProcessEventsFlags flags, int timeout)
+{
+    if (flags & QEventLoop::ExcludeSocketNotifiers) {
+        // the socket notifiers stay registered with epoll, so only wait for
+        // a wake up from another thread or for the next timer
+        pollfd pfd[2];
+        pfd[0].fd = thread_pipe[0];
+        pfd[1].fd = timerFd;
+        pfd[0].events = pfd[1].events = POLLIN;
+        pfd[0].revents = pfd[1].revents = 0;
+        int nsel = ::poll(pfd, timerFd != -1 ? 2 : 1, timeout);
+        if (nsel == -1) {
+            if (errno != EINTR && errno != EAGAIN)
+                perror("poll");
+            return 0;
+        }
+        if (pfd[1].revents & POLLIN)
+            processTimerFd();
+        if (pfd[0].revents & POLLIN) {
+            processThreadWakeUp();
+            return 1;
+        }
+        return 0;
+    }
+
+    epoll_event events[MaxEpollEvents];
+    int nsel = epoll_wait(epollFd, events, MaxEpollEvents, timeout);
+    if (nsel == -1) {
+        // a signal arrived; let the caller recompute the timeout and come back
+        if (errno != EINTR && errno != EAGAIN)
+            perror("epoll_wait");
+        return 0;
+    }
+
+    int nevents = 0;
+    for (int i = 0; i < nsel; ++i) {
+        const int fd = events[i].data.fd;
+        const quint32 revents = events[i].events;
+
+        if (fd == thread_pipe[0]) {
+            processThreadWakeUp();
+            ++nevents;
+            continue;
+        }
+        if (fd == timerFd) {
+            processTimerFd();
+            continue;
+        }
+
+        QEpollSocketNotifiers *sn = socketNotifiers.value(fd);
+        if (!sn)
+            continue;
+
+        // report errors and hang-ups the way select() does: the descriptor
+        // becomes readable and writable so that the next I/O call fails
+        bool activated = false;
+        if ((revents & (EPOLLIN | EPOLLHUP | EPOLLERR)) && sn->notifiers[QSocketNotifier::Read]) {
+            markPending(sn->notifiers[QSocketNotifier::Read]);
+            activated = true;
+        }
+        if ((revents & (EPOLLOUT | EPOLLHUP | EPOLLERR)) && sn->notifiers[QSocketNotifier::Write]) {
+            markPending(sn->notifiers[QSocketNotifier::Write]);
+            activated = true;
+        }
+        if ((revents & EPOLLPRI) && sn->notifiers[QSocketNotifier::Exception]) {
+            markPending(sn->notifiers[QSocketNotifier::Exception]);
+            activated = true;
+        }
+
+        // EPOLLHUP and EPOLLERR cannot be masked out; if nobody listens for
+        // them, stop watching the descriptor instead of spinning on it. The
+        // next change to its notifiers registers it again.
+        if (!activated)
+            updateEpoll(fd, sn, 0);
+    }
+
+    return nevents + activateSocketNotifiers();
+}
+
+void QEventDispatcherEpollPrivate::processThreadWakeUp()
+{
+    // some other thread woke us up... consume the data on the thread pipe so that
+    // epoll_wait doesn't immediately return next time
+#ifndef QT_NO_EVENTFD
+    if (thread_pipe[1] == -1) {
+        // eventfd
+        eventfd_t value;
+        eventfd_read(thread_pipe[0], &value);
+    } else
+#endif
+    {
+        char c[16];
+        while (::read(thread_pipe[0], c, sizeof(c)) > 0) {
+        }
+    }
+
+    if (!wakeUps.testAndSetRelease(1, 0)) {
+        // hopefully, this is dead code
+        qWarning("QEventDispatcherEpoll: internal error, wakeUps.testAndSetRelease(1, 0) failed!");
+    }
+}
+
+int QEventDispatcherEpollPrivate::activateSocketNotifiers()
+{
+    if (pendingNotifiers.isEmpty())
+        return 0;
+
+    // activate entries; unregisterSocketNotifier() removes notifiers that
+    // are disabled or deleted by an earlier activation from the list
+    int n_act = 0;
+    QEvent event(QEvent::SockAct);
+    while (!pendingNotifiers.isEmpty()) {
+        QSocketNotifier *notifier = pendingNotifiers.takeFirst();
+        QCoreApplication::sendEvent(notifier, &event);
+        ++n_act;
+    }
+    return n_act;
+}
+
+/*!
+    \class QEventDispatcherEpoll
+    \internal
+
+    \brief The QEventDispatcherEpoll class is an epoll(7) based event
+    dispatcher for Linux.
+
+    Unlike QEventDispatcherUNIX, which rebuilds and scans an fd_set for every
+    socket notifier on each iteration of the event loop, this dispatcher
+    registers a descriptor with the kernel once, when its notifier is enabled,
+    and afterwards only looks at the descriptors that are actually ready. The
+    cost of a loop iteration therefore does not depend on the number of
+    socket notifiers, and descriptors above FD_SETSIZE are supported.
+
+    The next timer is waited for with a timerfd(2) that is re-armed only when
+    the earliest deadline changes, so epoll_wait() does not need a timeout.
+    Setting \c QT_TIMER_WHEEL as well keeps coarse timers in a timer wheel.
+
+    It is used instead of the default dispatcher when the
+    \c QT_EVENT_DISPATCHER_EPOLL environment variable is set.
+*/
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QObject *parent)
+    : QAbstractEventDispatcher(*new QEventDispatcherEpollPrivate, parent)
+{ }
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QEventDispatcherEpollPrivate &dd, QObject *parent)
+    : QAbstractEventDispatcher(dd, parent)
+{ }
+
+QEventDispatcherEpoll::~QEventDispatcherEpoll()
+{
+}
+
+/*!
+    \internal
+
+    Returns \c true if the application asked for the epoll based dispatcher
+    by setting the \c QT_EVENT_DISPATCHER_EPOLL environment variable.
+*/
+bool QEventDispatcherEpoll::isRequested()
+{
+    return !qEnvironmentVariableIsEmpty("QT_EVENT_DISPATCHER_EPOLL");
+}
+
+/*!
+    \internal
+*/
+void QEventDispatcherEpoll::registerTimer(int timerId, int interval, Qt::TimerType timerType, QObject *obj)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1 || interval < 0 || !obj) {
+        qWarning("QEventDispatcherEpoll::registerTimer: invalid arguments");
+        return;
+    } else if (obj->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QObject::startTimer: timers cannot be started from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    d->timerList.registerTimer(timerId, interval, timerType, obj);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimer(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: invalid argument");
+        return false;
+    } else if (thread() != QThread::currentThread()) {
+        qWarning("QObject::killTimer: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimer(timerId);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimers(QObject *object)
+{
+#ifndef QT_NO_DEBUG
+    if (!object) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: invalid argument");
+        return false;
+    } else if (object->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QObject::killTimers: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimers(object);
+}
+
+QList<QEventDispatcherEpoll::TimerInfo>
+QEventDispatcherEpoll::registeredTimers(QObject *object) const
+{
+    if (!object) {
+        qWarning("QEventDispatcherEpoll:registeredTimers: invalid argument");
+        return QList<TimerInfo>();
+    }
+
+    Q_D(const QEventDispatcherEpoll);
+    return d->timerList.registeredTimers(object);
+}
+
+int QEventDispatcherEpoll::remainingTime(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::remainingTime: invalid argument");
+        return -1;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.timerRemainingTime(timerId);
+}
+
+void QEventDispatcherEpoll::registerSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    int type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (sockfd < 0) {
+        qWarning("QSocketNotifier: Internal error");
+        return;
+    } else if (notifier->thread() != thread()
+               || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be enabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    QEpollSocketNotifiers *sn = d->socketNotifiers.value(sockfd);
+    if (!sn) {
+        sn = new QEpollSocketNotifiers;
+        d->socketNotifiers.insert(sockfd, sn);
+    } else if (sn->notifiers[type]) {
+        qWarning("QSocketNotifier: Multiple socket notifiers for "
+                 "same socket %d and type %s", sockfd, socketNotifierTypeName(type));
+    }
+    sn->notifiers[type] = notifier;
+
+    if (!d->updateEpoll(sockfd, sn, epollEventsFor(sn))) {
+        qWarning("QSocketNotifier: Invalid socket %d and type '%s', disabling...",
+                 sockfd, socketNotifierTypeName(type));
+        notifier->setEnabled(false);
+    }
+}
+
+void QEventDispatcherEpoll::unregisterSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    int type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (sockfd < 0) {
+        qWarning("QSocketNotifier: Internal error");
+        return;
+    } else if (notifier->thread() != thread()
+               || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be disabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    QHash<int, QEpollSocketNotifiers *>::iterator it = d->socketNotifiers.find(sockfd);
+    if (it == d->socketNotifiers.end() || it.value()->notifiers[type] != notifier) // not found
+        return;
+
+    QEpollSocketNotifiers *sn = it.value();
+    sn->notifiers[type] = 0;
+    d->pendingNotifiers.removeAll(notifier);          // remove from activation list
+
+    const quint32 events = epollEventsFor(sn);
+    d->updateEpoll(sockfd, sn, events);
+    if (!events) {
+        d->socketNotifiers.erase(it);
+        delete sn;
+    }
+}
+
+bool QEventDispatcherEpoll::processEvents(QEventLoop::ProcessEventsFlags flags)
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.store(0);
+
+    // we are awake, broadcast it
+    emit awake();
+    QCoreApplicationPrivate::sendPostedEvents(0, 0, d->threadData);
+
+    int nevents = 0;
+    const bool canWait = (d->threadData->canWaitLocked()
+                          && !d->interrupt.load()
+                          && (flags & QEventLoop::WaitForMoreEvents));
+
+    if (canWait)
+        emit aboutToBlock();
+
+    // a wake-up that only moved coarse timers down the timer wheel did not
+    // process anything, so keep waiting
+    while (!d->interrupt.load()) {
+        // return the maximum time we can wait for an event.
+        int timeout = -1;
+        d->timerList.updateCurrentTime();
+        if (!(flags & QEventLoop::X11ExcludeTimers)) {
+            // let the kernel wake us up through the timerfd when the next
+            // timer is due; fall back to a timeout if it cannot be armed
+            timespec deadline;
+            d->timerList.repairTimersIfNeeded();
+            const bool haveTimers = d->timerList.timerDeadline(deadline);
+            if (d->timerFd == -1 || !d->updateTimerFd(haveTimers ? &deadline : 0)) {
+                timespec wait_tm = { 0l, 0l };
+                if (d->timerList.timerWait(wait_tm)) {
+                    // round up, so that we do not wake up just before the timer is due
+                    timeout = int(wait_tm.tv_sec * 1000 + (wait_tm.tv_nsec + 999999) / (1000 * 1000));
+                }
+            }
+        }
+
+        if (!canWait)
+            timeout = 0; // no time to wait
+
+        nevents = d->doWait(flags, timeout);
+
+        // activate timers
+        if (! (flags & QEventLoop::X11ExcludeTimers)) {
+            nevents += d->timerList.activateTimers();
+        }
+
+        if (nevents || !canWait)
+            break;
+    }
+    // return true if we handled events, false otherwise
+    return (nevents > 0);
+}
+
+bool QEventDispatcherEpoll::hasPendingEvents()
+{
+    extern uint qGlobalPostedEventsCount(); // from qapplication.cpp
+    return qGlobalPostedEventsCount();
+}
+
+void QEventDispatcherEpoll::wakeUp()
+{
+    Q_D(QEventDispatcherEpoll);
+    if (d->wakeUps.testAndSetAcquire(0, 1)) {
+#ifndef QT_NO_EVENTFD
+        if (d->thread_pipe[1] == -1) {
+            // eventfd
+            eventfd_t value = 1;
+            int ret;
+            EINTR_LOOP(ret, eventfd_write(d->thread_pipe[0], value));
+            return;
+        }
+#endif
+        char c = 0;
+        qt_safe_write( d->thread_pipe[1], &c, 1 );
+    }
+}
+
+void QEventDispatcherEpoll::interrupt()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.store(1);
+    wakeUp();
+}
+
+void QEventDispatcherEpoll::flush()
+{ }
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_EPOLL
@@ -147,6 +147,9 @@ QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
         qFatal("QEventDispatcherUNIXPrivate(): Can not continue without a thread pipe");
 
     sn_highest = -1;
+
+    // the timer wheel changes the firing order of timers due together
+    timerList.setTimerWheelEnabled(QTimerInfoList::isTimerWheelRequested());
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
@@ -594,7 +597,9 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     if (canWait)
         emit aboutToBlock();
 
-    if (!d->interrupt.load()) {
+    // a wake-up that only moved coarse timers down the timer wheel did not
+    // process anything, so keep waiting
+    while (!d->interrupt.load()) {
         // return the maximum time we can wait for an event.
         timespec *tm = 0;
         timespec wait_tm = { 0l, 0l };
@@ -618,6 +623,9 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
         if (! (flags & QEventLoop::X11ExcludeTimers)) {
             nevents += activateTimers();
         }
+
+        if (nevents || !canWait)
+            break;
     }
     // return true if we handled events, false otherwise
     return (nevents > 0);
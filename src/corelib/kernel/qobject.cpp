@@ -232,7 +232,7 @@ QObjectPrivate::~QObjectPrivate()
             QAbstractEventDispatcherPrivate::releaseTimerId(extraData->runningTimers.at(i));
     }
 
-    if (postedEvents)
+    if (postedEvents || threadData->postEventList.hasLockFreeEvents())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     threadData->deref();
@@ -272,32 +272,275 @@ static void computeOffsets(const QMetaObject *metaobject, int *signalOffset, int
     QObjectPrivate::signalIndex (not QMetaObject::indexOfSignal).
     Negative index means connections to all signals.
 
-    This vector is protected by the object mutex (signalSlotMutexes())
+    Changes to this vector are protected by the object mutex
+    (signalSlotLock()), but QMetaObject::activate() walks the lists
+    without locking it. Instead, it holds a reference on the vector for
+    the duration of the emission, and counts itself as active in the
+    current epoch. Connections unlinked from the lists and the list arrays
+    replaced when the vector grows are kept on the orphan lists of the
+    epoch they were unlinked in. The epoch advances once the emissions
+    that started in the one before it are done; the orphans of that
+    previous epoch can then no longer be reached and are freed, even if
+    emissions keep overlapping.
 
     Each Connection is also part of a 'senders' linked list. The mutex
     of the receiver must be locked when touching the pointers of this
     linked list.
 */
-class QObjectConnectionListVector : public QVector<QObjectPrivate::ConnectionList>
+class QObjectConnectionListVector
 {
 public:
-    bool orphaned; //the QObject owner of this vector has been destroyed while the vector was inUse
-    bool dirty; //some Connection have been disconnected (their receiver is 0) but not removed from the list yet
-    int inUse; //number of functions that are currently accessing this object or its connections
+    struct ListArray
+    {
+        explicit ListArray(int count)
+            : count(count), lists(new QObjectPrivate::ConnectionList[count]), nextInOrphanList(0)
+        { }
+        ~ListArray() { delete [] lists; }
+
+        int count;
+        QObjectPrivate::ConnectionList *lists;
+        ListArray *nextInOrphanList;
+    };
+
+    struct Orphans
+    {
+        Orphans() : connections(0), lists(0) { }
+        QObjectPrivate::Connection *connections;
+        ListArray *lists;
+    };
+
+    QAtomicInt ref; //one for the QObject owner of this vector, one for every emission in progress
+    bool orphaned; //the QObject owner of this vector has been destroyed
+    QAtomicInt dirty; //some Connection have been disconnected (their receiver is 0) but not removed from the list yet
+    quint64 currentConnectionId; //id of the connection added last
     QObjectPrivate::ConnectionList allsignals;
+    QAtomicPointer<ListArray> signalLists;
+    QAtomicInt epoch;
+    QAtomicInt activeEmissions[2]; //emissions in progress that started in an even or odd epoch
+    QAtomicPointer<QObjectPrivate::Connection> orphanedConnections; //unlinked in the current epoch
+    QAtomicPointer<ListArray> orphanedLists;
+    QAtomicPointer<QObjectPrivate::Connection> retiredConnections; //unlinked in the previous epoch
+    QAtomicPointer<ListArray> retiredLists;
 
     QObjectConnectionListVector()
-        : QVector<QObjectPrivate::ConnectionList>(), orphaned(false), dirty(false), inUse(0)
-    { }
+        : ref(1), orphaned(false), dirty(0), currentConnectionId(0), epoch(0)
+    {
+        activeEmissions[0].store(0);
+        activeEmissions[1].store(0);
+    }
+    ~QObjectConnectionListVector();
+
+    int count() const
+    {
+        const ListArray *array = signalLists.load();
+        return array ? array->count : 0;
+    }
+
+    const QObjectPrivate::ConnectionList &at(int at) const
+    {
+        if (at < 0)
+            return allsignals;
+        return signalLists.load()->lists[at];
+    }
 
     QObjectPrivate::ConnectionList &operator[](int at)
     {
         if (at < 0)
             return allsignals;
-        return QVector<QObjectPrivate::ConnectionList>::operator[](at);
+        return signalLists.load()->lists[at];
     }
+
+    int beginEmission();
+    void endEmission(int emissionEpoch) { activeEmissions[emissionEpoch & 1].deref(); }
+    bool hasOrphans() const
+    {
+        return orphanedConnections.load() || orphanedLists.load()
+            || retiredConnections.load() || retiredLists.load();
+    }
+
+    void resize(int count);
+    Orphans takeOrphans();
+    void cleanOrphans(QMutex *mutex);
+    static void freeOrphans(const Orphans &orphans);
 };
 
+QObjectConnectionListVector::~QObjectConnectionListVector()
+{
+    Q_ASSERT(!allsignals.first.load());
+    Orphans orphans;
+    orphans.connections = orphanedConnections.load();
+    orphans.lists = orphanedLists.load();
+    freeOrphans(orphans);
+    orphans.connections = retiredConnections.load();
+    orphans.lists = retiredLists.load();
+    freeOrphans(orphans);
+    delete signalLists.load();
+}
+
+/*!
+    \internal
+    Counts an emission as active in the current epoch and returns that
+    epoch, which must be passed to endEmission() once the emission is done.
+
+    The epoch is checked again after counting, so that the emission does
+    not count itself in an epoch that takeOrphans() has already left.
+ */
+int QObjectConnectionListVector::beginEmission()
+{
+    for (;;) {
+        const int current = epoch.loadAcquire();
+        activeEmissions[current & 1].fetchAndAddOrdered(1);
+        if (epoch.loadAcquire() == current)
+            return current;
+        activeEmissions[current & 1].deref();
+    }
+}
+
+/*!
+    \internal
+    Grows the vector to \a count lists. The signalSlotLock() of the owner must be locked.
+
+    The lists are copied to a new array, an activate() that already loaded
+    the old one keeps using it until it is freed with the orphans.
+ */
+void QObjectConnectionListVector::resize(int count)
+{
+    ListArray *oldArray = signalLists.load();
+    ListArray *newArray = new ListArray(count);
+    if (oldArray) {
+        for (int i = 0; i < oldArray->count; ++i)
+            newArray->lists[i] = oldArray->lists[i];
+        oldArray->nextInOrphanList = orphanedLists.load();
+        orphanedLists.store(oldArray);
+    }
+    signalLists.storeRelease(newArray);
+}
+
+/*!
+    \internal
+    Unlinks the disconnected connections from \a list and prepends them to \a orphans.
+
+    The unlinked connections keep their nextConnectionList pointer, so that
+    an activate() currently looking at one of them can continue its walk.
+ */
+static void unlinkDisconnected(QObjectPrivate::ConnectionList &list,
+                               QObjectPrivate::Connection *&orphans)
+{
+    // Set to the last entry in the connection list that was *not*
+    // unlinked.  This is needed to update the list's last pointer
+    // at the end of the cleanup.
+    QObjectPrivate::Connection *last = 0;
+
+    QAtomicPointer<QObjectPrivate::Connection> *prev = &list.first;
+    QObjectPrivate::Connection *c = prev->load();
+    while (c) {
+        QObjectPrivate::Connection *next = c->nextConnectionList.load();
+        if (c->receiver.load()) {
+            last = c;
+            prev = &c->nextConnectionList;
+        } else {
+            prev->storeRelease(next);
+            c->nextInOrphanList = orphans;
+            orphans = c;
+        }
+        c = next;
+    }
+
+    // Correct the connection list's last pointer.
+    // As conectionList.last could equal last, this could be a noop
+    list.last.storeRelease(last);
+}
+
+template <typename T>
+static T *appendOrphans(T *list, T *tail)
+{
+    if (!list)
+        return tail;
+    T *last = list;
+    while (last->nextInOrphanList)
+        last = last->nextInOrphanList;
+    last->nextInOrphanList = tail;
+    return list;
+}
+
+/*!
+    \internal
+    Unlinks the disconnected connections and returns the orphans that no
+    emission can see anymore. The signalSlotLock() of the owner must be
+    locked, the orphans must be freed with freeOrphans() once it is unlocked.
+ */
+QObjectConnectionListVector::Orphans QObjectConnectionListVector::takeOrphans()
+{
+    if (dirty.load()) {
+        QObjectPrivate::Connection *connections = orphanedConnections.load();
+        for (int signal = -1; signal < count(); ++signal)
+            unlinkDisconnected((*this)[signal], connections);
+        orphanedConnections.store(connections);
+        dirty.store(0);
+    }
+
+    Orphans orphans;
+    if (orphaned)
+        return orphans;
+
+    // Twice at most: the orphans of the current epoch become the retired
+    // ones, which are freed by the next advance.
+    for (int i = 0; i < 2 && hasOrphans(); ++i) {
+        // Only emissions of the previous epoch can still see the retired
+        // orphans. Emissions of the current one started after they were
+        // unlinked, and those still counting themselves in the previous
+        // epoch see the advance below and count again.
+        const int current = epoch.load();
+        if (activeEmissions[(current - 1) & 1].loadAcquire())
+            break;
+
+        orphans.connections = appendOrphans(orphans.connections,
+                                            retiredConnections.fetchAndStoreRelaxed(orphanedConnections.fetchAndStoreRelaxed(0)));
+        orphans.lists = appendOrphans(orphans.lists,
+                                      retiredLists.fetchAndStoreRelaxed(orphanedLists.fetchAndStoreRelaxed(0)));
+        epoch.fetchAndStoreOrdered(current + 1);
+    }
+    return orphans;
+}
+
+/*!
+    \internal
+    Frees the connections that became unreachable, \a mutex is the signalSlotLock()
+    of the owner and must not be locked. The owner must not have been destroyed.
+ */
+void QObjectConnectionListVector::cleanOrphans(QMutex *mutex)
+{
+    if (!dirty.load() && (!hasOrphans() || activeEmissions[(epoch.load() - 1) & 1].load()))
+        return;
+
+    QMutexLocker locker(mutex);
+    const Orphans orphans = takeOrphans();
+    locker.unlock();
+    freeOrphans(orphans);
+}
+
+void QObjectConnectionListVector::freeOrphans(const Orphans &orphans)
+{
+    QObjectPrivate::Connection *c = orphans.connections;
+    while (c) {
+        QObjectPrivate::Connection *next = c->nextInOrphanList;
+        Q_ASSERT(!c->receiver.load());
+        if (c->isSlotObject) {
+            c->isSlotObject = false;
+            c->slotObj->destroyIfLastRef();
+        }
+        c->deref();
+        c = next;
+    }
+
+    ListArray *array = orphans.lists;
+    while (array) {
+        ListArray *next = array->nextInOrphanList;
+        delete array;
+        array = next;
+    }
+}
+
 // Used by QAccessibleWidget
 bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
 {
@@ -306,15 +549,15 @@ bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
     if (signal_index < 0)
         return false;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
-        if (signal_index < connectionLists->count()) {
+    if (const QObjectConnectionListVector *lists = connectionLists.load()) {
+        if (signal_index < lists->count()) {
             const QObjectPrivate::Connection *c =
-                connectionLists->at(signal_index).first;
+                lists->at(signal_index).first.load();
 
             while (c) {
-                if (c->receiver == receiver)
+                if (c->receiver.load() == receiver)
                     return true;
-                c = c->nextConnectionList;
+                c = c->nextConnectionList.load();
             }
         }
     }
@@ -330,14 +573,14 @@ QObjectList QObjectPrivate::receiverList(const char *signal) const
     if (signal_index < 0)
         return returnValue;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
-        if (signal_index < connectionLists->count()) {
-            const QObjectPrivate::Connection *c = connectionLists->at(signal_index).first;
+    if (const QObjectConnectionListVector *lists = connectionLists.load()) {
+        if (signal_index < lists->count()) {
+            const QObjectPrivate::Connection *c = lists->at(signal_index).first.load();
 
             while (c) {
-                if (c->receiver)
-                    returnValue << c->receiver;
-                c = c->nextConnectionList;
+                if (QObject *receiver = c->receiver.load())
+                    returnValue << receiver;
+                c = c->nextConnectionList.load();
             }
         }
     }
@@ -367,22 +610,34 @@ QObjectList QObjectPrivate::senderList() const
 void QObjectPrivate::addConnection(int signal, Connection *c)
 {
     Q_ASSERT(c->sender == q_ptr);
-    if (!connectionLists)
-        connectionLists = new QObjectConnectionListVector();
-    if (signal >= connectionLists->count())
-        connectionLists->resize(signal + 1);
-
-    ConnectionList &connectionList = (*connectionLists)[signal];
-    if (connectionList.last) {
-        connectionList.last->nextConnectionList = c;
-    } else {
-        connectionList.first = c;
+    QObjectConnectionListVector *lists = connectionLists.load();
+    if (!lists) {
+        lists = new QObjectConnectionListVector();
+        connectionLists.storeRelease(lists);
+    }
+    if (signal >= lists->count()) {
+        // make room for all signals of the class right away, every resize copies the lists
+        const QMetaObject *metaObject = q_ptr->metaObject();
+        lists->resize(qMax(signal + 1, QMetaObjectPrivate::signalOffset(metaObject)
+                                       + QMetaObjectPrivate::get(metaObject)->signalCount));
     }
-    connectionList.last = c;
 
     cleanConnectionLists();
 
-    c->prev = &(QObjectPrivate::get(c->receiver)->senders);
+    // publish the connection only once it is complete, activate() may be walking the list
+    ConnectionList &connectionList = (*lists)[signal];
+    c->id = ++lists->currentConnectionId;
+    QThreadData *receiverThreadData = QObjectPrivate::get(c->receiver.load())->threadData;
+    receiverThreadData->ref();
+    c->receiverThreadData.store(receiverThreadData);
+    if (QObjectPrivate::Connection *last = connectionList.last.load()) {
+        last->nextConnectionList.storeRelease(c);
+    } else {
+        connectionList.first.storeRelease(c);
+    }
+    connectionList.last.storeRelease(c);
+
+    c->prev = &(QObjectPrivate::get(c->receiver.load())->senders);
     c->next = *c->prev;
     *c->prev = c;
     if (c->next)
@@ -397,37 +652,14 @@ void QObjectPrivate::addConnection(int signal, Connection *c)
 
 void QObjectPrivate::cleanConnectionLists()
 {
-    if (connectionLists->dirty && !connectionLists->inUse) {
-        // remove broken connections
-        for (int signal = -1; signal < connectionLists->count(); ++signal) {
-            QObjectPrivate::ConnectionList &connectionList =
-                (*connectionLists)[signal];
-
-            // Set to the last entry in the connection list that was *not*
-            // deleted.  This is needed to update the list's last pointer
-            // at the end of the cleanup.
-            QObjectPrivate::Connection *last = 0;
-
-            QObjectPrivate::Connection **prev = &connectionList.first;
-            QObjectPrivate::Connection *c = *prev;
-            while (c) {
-                if (c->receiver) {
-                    last = c;
-                    prev = &c->nextConnectionList;
-                    c = *prev;
-                } else {
-                    QObjectPrivate::Connection *next = c->nextConnectionList;
-                    *prev = next;
-                    c->deref();
-                    c = next;
-                }
-            }
-
-            // Correct the connection list's last pointer.
-            // As conectionList.last could equal last, this could be a noop
-            connectionList.last = last;
-        }
-        connectionLists->dirty = false;
+    QObjectConnectionListVector *lists = connectionLists.load();
+    if (lists->dirty.load()) {
+        // remove broken connections, they are freed with the other orphans
+        QObjectPrivate::Connection *orphans = lists->orphanedConnections.load();
+        for (int signal = -1; signal < lists->count(); ++signal)
+            unlinkDisconnected((*lists)[signal], orphans);
+        lists->orphanedConnections.store(orphans);
+        lists->dirty.store(0);
     }
 }
 
@@ -437,7 +669,8 @@ void QObjectPrivate::cleanConnectionLists()
 QMetaCallEvent::QMetaCallEvent(ushort method_offset, ushort method_relative, QObjectPrivate::StaticMetaCallFunction callFunction,
                                const QObject *sender, int signalId,
                                int nargs, int *types, void **args, QSemaphore *semaphore)
-    : QEvent(MetaCall), slotObj_(0), sender_(sender), signalId_(signalId),
+    : QEvent(MetaCall), nextPosted(0), postedReceiver(0),
+      slotObj_(0), sender_(sender), signalId_(signalId),
       nargs_(nargs), types_(types), args_(args), semaphore_(semaphore),
       callFunction_(callFunction), method_offset_(method_offset), method_relative_(method_relative)
 { }
@@ -447,7 +680,8 @@ QMetaCallEvent::QMetaCallEvent(ushort method_offset, ushort method_relative, QOb
  */
 QMetaCallEvent::QMetaCallEvent(QtPrivate::QSlotObjectBase *slotO, const QObject *sender, int signalId,
                                int nargs, int *types, void **args, QSemaphore *semaphore)
-    : QEvent(MetaCall), slotObj_(slotO), sender_(sender), signalId_(signalId),
+    : QEvent(MetaCall), nextPosted(0), postedReceiver(0),
+      slotObj_(slotO), sender_(sender), signalId_(signalId),
       nargs_(nargs), types_(types), args_(args), semaphore_(semaphore),
       callFunction_(0), method_offset_(0), method_relative_(ushort(-1))
 {
@@ -927,50 +1161,41 @@ QObject::~QObject()
         QMutexLocker locker(signalSlotMutex);
 
         // disconnect all receivers
-        if (d->connectionLists) {
-            ++d->connectionLists->inUse;
-            int connectionListsCount = d->connectionLists->count();
+        QObjectConnectionListVector *connectionLists = d->connectionLists.load();
+        if (connectionLists) {
+            // keep the unlinked connections alive while the mutex is unlocked in relock()
+            connectionLists->ref.ref();
+            int connectionListsCount = connectionLists->count();
             for (int signal = -1; signal < connectionListsCount; ++signal) {
                 QObjectPrivate::ConnectionList &connectionList =
-                    (*d->connectionLists)[signal];
+                    (*connectionLists)[signal];
 
-                while (QObjectPrivate::Connection *c = connectionList.first) {
-                    if (!c->receiver) {
-                        connectionList.first = c->nextConnectionList;
-                        c->deref();
+                while (QObjectPrivate::Connection *c = connectionList.first.load()) {
+                    // an activate() in progress may still walk the unlinked connection
+                    connectionList.first.storeRelease(c->nextConnectionList.load());
+                    c->nextInOrphanList = connectionLists->orphanedConnections.load();
+                    connectionLists->orphanedConnections.store(c);
+
+                    if (!c->receiver.load())
                         continue;
-                    }
 
-                    QMutex *m = signalSlotLock(c->receiver);
+                    QMutex *m = signalSlotLock(c->receiver.load());
                     bool needToUnlock = QOrderedMutexLocker::relock(signalSlotMutex, m);
 
-                    if (c->receiver) {
+                    if (c->receiver.load()) {
                         *c->prev = c->next;
                         if (c->next) c->next->prev = c->prev;
                     }
-                    c->receiver = 0;
+                    c->receiver.storeRelease(0);
                     if (needToUnlock)
                         m->unlock();
-
-                    connectionList.first = c->nextConnectionList;
-
-                    // The destroy operation must happen outside the lock
-                    if (c->isSlotObject) {
-                        c->isSlotObject = false;
-                        locker.unlock();
-                        c->slotObj->destroyIfLastRef();
-                        locker.relock();
-                    }
-                    c->deref();
                 }
+                connectionList.last.store(0);
             }
 
-            if (!--d->connectionLists->inUse) {
-                delete d->connectionLists;
-            } else {
-                d->connectionLists->orphaned = true;
-            }
-            d->connectionLists = 0;
+            connectionLists->dirty.store(0);
+            connectionLists->orphaned = true;
+            d->connectionLists.storeRelease(0);
         }
 
         /* Disconnect all senders:
@@ -999,29 +1224,37 @@ QObject::~QObject()
                 m->unlock();
                 continue;
             }
-            node->receiver = 0;
-            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists;
+            node->receiver.storeRelease(0);
+            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists.load();
             if (senderLists)
-                senderLists->dirty = true;
+                senderLists->dirty.store(1);
 
-            QtPrivate::QSlotObjectBase *slotObj = Q_NULLPTR;
-            if (node->isSlotObject) {
-                slotObj = node->slotObj;
-                node->isSlotObject = false;
-            }
+            // The functor is destroyed with the connection, unless an emission is in progress
+            QObjectConnectionListVector::Orphans orphans;
+            if (node->isSlotObject && senderLists)
+                orphans = senderLists->takeOrphans();
 
             node = node->next;
             if (needToUnlock)
                 m->unlock();
 
-            if (slotObj) {
+            if (orphans.connections || orphans.lists) {
                 if (node)
                     node->prev = &node;
                 locker.unlock();
-                slotObj->destroyIfLastRef();
+                QObjectConnectionListVector::freeOrphans(orphans);
                 locker.relock();
             }
         }
+
+        locker.unlock();
+        if (connectionLists) {
+            // drop the reference taken above and the one of this object,
+            // the last emission still walking the lists deletes them otherwise
+            connectionLists->ref.deref();
+            if (!connectionLists->ref.deref())
+                delete connectionLists;
+        }
     }
 
     if (!d->children.isEmpty())
@@ -1042,6 +1275,8 @@ QObjectPrivate::Connection::~Connection()
     }
     if (isSlotObject)
         slotObj->destroyIfLastRef();
+    if (QThreadData *td = receiverThreadData.load())
+        td->deref();
 }
 
 
@@ -1488,11 +1723,23 @@ void QObject::moveToThread(QThread *targetThread)
     // keep currentData alive (since we've got it locked)
     currentData->ref();
 
-    // move the object
+    // move the object, together with the events posted to it so far
+    currentData->takeLockFreePostedEvents();
     d_func()->setThreadData_helper(currentData, targetData);
 
+#ifndef QT_NO_THREAD
+    // a lock-free poster may still have seen the old thread data; let it
+    // finish and hand its event over to targetData
+    while (currentData->postEventList.lockFreePosters.fetchAndAddOrdered(0) != 0)
+        QThread::yieldCurrentThread();
+    currentData->takeLockFreePostedEvents();
+#endif
+
     locker.unlock();
 
+    // let the emitting threads know where the connected slots now run
+    d_func()->setReceiverThreadData_helper(targetData);
+
     // now currentData can commit suicide if it wants to
     currentData->deref();
 }
@@ -1546,6 +1793,25 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
     }
 }
 
+void QObjectPrivate::setReceiverThreadData_helper(QThreadData *targetData)
+{
+    Q_Q(QObject);
+    {
+        QMutexLocker locker(signalSlotLock(q));
+        for (Connection *c = senders; c; c = c->next) {
+            targetData->ref();
+            QThreadData *old = c->receiverThreadData.fetchAndStoreRelease(targetData);
+            if (old)
+                old->deref();
+        }
+    }
+
+    for (int i = 0; i < children.size(); ++i) {
+        QObject *child = children.at(i);
+        child->d_func()->setReceiverThreadData_helper(targetData);
+    }
+}
+
 void QObjectPrivate::_q_reregisterTimers(void *pointer)
 {
     Q_Q(QObject);
@@ -2394,13 +2660,13 @@ int QObject::receivers(const char *signal) const
         }
 
         QMutexLocker locker(signalSlotLock(this));
-        if (d->connectionLists) {
-            if (signal_index < d->connectionLists->count()) {
+        if (const QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+            if (signal_index < connectionLists->count()) {
                 const QObjectPrivate::Connection *c =
-                    d->connectionLists->at(signal_index).first;
+                    connectionLists->at(signal_index).first.load();
                 while (c) {
-                    receivers += c->receiver ? 1 : 0;
-                    c = c->nextConnectionList;
+                    receivers += c->receiver.load() ? 1 : 0;
+                    c = c->nextConnectionList.load();
                 }
             }
         }
@@ -2445,14 +2711,14 @@ bool QObject::isSignalConnected(const QMetaMethod &signal) const
         return d->isSignalConnected(signalIndex);
 
     QMutexLocker locker(signalSlotLock(this));
-    if (d->connectionLists) {
-        if (signalIndex < uint(d->connectionLists->count())) {
+    if (const QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        if (signalIndex < uint(connectionLists->count())) {
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signalIndex).first;
+                connectionLists->at(signalIndex).first.load();
             while (c) {
-                if (c->receiver)
+                if (c->receiver.load())
                     return true;
-                c = c->nextConnectionList;
+                c = c->nextConnectionList.load();
             }
         }
     }
@@ -3222,17 +3488,17 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
                                signalSlotLock(receiver));
 
     if (type & Qt::UniqueConnection) {
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
         if (connectionLists && connectionLists->count() > signal_index) {
             const QObjectPrivate::Connection *c2 =
-                (*connectionLists)[signal_index].first;
+                (*connectionLists)[signal_index].first.load();
 
             int method_index_absolute = method_index + method_offset;
 
             while (c2) {
-                if (c2->receiver == receiver && c2->method() == method_index_absolute)
+                if (c2->receiver.load() == receiver && c2->method() == method_index_absolute)
                     return 0;
-                c2 = c2->nextConnectionList;
+                c2 = c2->nextConnectionList.load();
             }
         }
         type &= Qt::UniqueConnection - 1;
@@ -3241,18 +3507,18 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     QScopedPointer<QObjectPrivate::Connection> c(new QObjectPrivate::Connection);
     c->sender = s;
     c->signal_index = signal_index;
-    c->receiver = r;
+    c->receiver.store(r);
     c->method_relative = method_index;
     c->method_offset = method_offset;
     c->connectionType = type;
     c->isSlotObject = false;
     c->argumentTypes.store(types);
-    c->nextConnectionList = 0;
     c->callFunction = callFunction;
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.data());
 
     locker.unlock();
+    QObjectPrivate::get(s)->connectionLists.load()->cleanOrphans(signalSlotLock(sender));
     QMetaMethod smethod = QMetaObjectPrivate::signal(smeta, signal_index);
     if (smethod.isValid())
         s->connectNotify(smethod);
@@ -3299,18 +3565,15 @@ bool QMetaObjectPrivate::disconnectHelper(QObjectPrivate::Connection *c,
 {
     bool success = false;
     while (c) {
-        if (c->receiver
-            && (receiver == 0 || (c->receiver == receiver
+        QObject *r = c->receiver.load();
+        if (r
+            && (receiver == 0 || (r == receiver
                            && (method_index < 0 || c->method() == method_index)
                            && (slot == 0 || (c->isSlotObject && c->slotObj->compare(slot)))))) {
-            bool needToUnlock = false;
-            QMutex *receiverMutex = 0;
-            if (c->receiver) {
-                receiverMutex = signalSlotLock(c->receiver);
-                // need to relock this receiver and sender in the correct order
-                needToUnlock = QOrderedMutexLocker::relock(senderMutex, receiverMutex);
-            }
-            if (c->receiver) {
+            // need to relock this receiver and sender in the correct order
+            QMutex *receiverMutex = signalSlotLock(r);
+            bool needToUnlock = QOrderedMutexLocker::relock(senderMutex, receiverMutex);
+            if (c->receiver.load()) {
                 *c->prev = c->next;
                 if (c->next)
                     c->next->prev = c->prev;
@@ -3319,21 +3582,15 @@ bool QMetaObjectPrivate::disconnectHelper(QObjectPrivate::Connection *c,
             if (needToUnlock)
                 receiverMutex->unlock();
 
-            c->receiver = 0;
-
-            if (c->isSlotObject) {
-                c->isSlotObject = false;
-                senderMutex->unlock();
-                c->slotObj->destroyIfLastRef();
-                senderMutex->lock();
-            }
+            // the functor is destroyed with the connection, see QObjectConnectionListVector::freeOrphans()
+            c->receiver.storeRelease(0);
 
             success = true;
 
             if (disconnectType == DisconnectOne)
                 return success;
         }
-        c = c->nextConnectionList;
+        c = c->nextConnectionList.load();
     }
     return success;
 }
@@ -3355,39 +3612,38 @@ bool QMetaObjectPrivate::disconnect(const QObject *sender,
     QMutex *senderMutex = signalSlotLock(sender);
     QMutexLocker locker(senderMutex);
 
-    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
     if (!connectionLists)
         return false;
 
-    // prevent incoming connections changing the connectionLists while unlocked
-    ++connectionLists->inUse;
+    // prevent the connections unlinked while unlocked from being freed
+    connectionLists->ref.ref();
 
     bool success = false;
     if (signal_index < 0) {
         // remove from all connection lists
         for (int sig_index = -1; sig_index < connectionLists->count(); ++sig_index) {
             QObjectPrivate::Connection *c =
-                (*connectionLists)[sig_index].first;
+                (*connectionLists)[sig_index].first.load();
             if (disconnectHelper(c, receiver, method_index, slot, senderMutex, disconnectType)) {
                 success = true;
-                connectionLists->dirty = true;
+                connectionLists->dirty.store(1);
             }
         }
     } else if (signal_index < connectionLists->count()) {
         QObjectPrivate::Connection *c =
-            (*connectionLists)[signal_index].first;
+            (*connectionLists)[signal_index].first.load();
         if (disconnectHelper(c, receiver, method_index, slot, senderMutex, disconnectType)) {
             success = true;
-            connectionLists->dirty = true;
+            connectionLists->dirty.store(1);
         }
     }
 
-    --connectionLists->inUse;
-    Q_ASSERT(connectionLists->inUse >= 0);
-    if (connectionLists->orphaned && !connectionLists->inUse)
-        delete connectionLists;
+    connectionLists->ref.deref();
+    const QObjectConnectionListVector::Orphans orphans = connectionLists->takeOrphans();
 
     locker.unlock();
+    QObjectConnectionListVector::freeOrphans(orphans);
     if (success) {
         QMetaMethod smethod = QMetaObjectPrivate::signal(smeta, signal_index);
         if (smethod.isValid())
@@ -3499,6 +3755,26 @@ void QMetaObject::connectSlotsByName(QObject *o)
     }
 }
 
+/*!
+    \internal
+
+    Posts \a ev to \a receiver, unless \a c was disconnected in the meantime.
+    The receiver disconnects its connections with its signalSlotLock() locked
+    when it is destroyed, so holding that lock keeps it alive while posting.
+*/
+static bool postUnlessDisconnected(QObjectPrivate::Connection *c, QObject *receiver, QMetaCallEvent *ev)
+{
+    if (receiver) {
+        QMutexLocker locker(signalSlotLock(receiver));
+        if (c->receiver.load() == receiver) {
+            QCoreApplication::postEvent(receiver, ev);
+            return true;
+        }
+    }
+    delete ev;
+    return false;
+}
+
 /*!
     \internal
 
@@ -3534,7 +3810,7 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     QMetaCallEvent *ev = c->isSlotObject ?
         new QMetaCallEvent(c->slotObj, sender, signal, nargs, types, args) :
         new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal, nargs, types, args);
-    QCoreApplication::postEvent(c->receiver, ev);
+    postUnlessDisconnected(c, c->receiver.loadAcquire(), ev);
 }
 
 /*!
@@ -3575,56 +3851,69 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
     Qt::HANDLE currentThreadId = QThread::currentThreadId();
 
     {
-    QMutexLocker locker(signalSlotLock(sender));
+    // The lists are walked without locking signalSlotLock(sender): the reference
+    // keeps the vector alive and the epoch every connection reachable from it,
+    // until the emission is done.
     struct ConnectionListsRef {
         QObjectConnectionListVector *connectionLists;
-        ConnectionListsRef(QObjectConnectionListVector *connectionLists) : connectionLists(connectionLists)
+        QObject *sender;
+        int epoch;
+        ConnectionListsRef(QObjectConnectionListVector *connectionLists, QObject *sender)
+            : connectionLists(connectionLists), sender(sender), epoch(0)
         {
-            if (connectionLists)
-                ++connectionLists->inUse;
+            if (connectionLists) {
+                connectionLists->ref.ref();
+                epoch = connectionLists->beginEmission();
+            }
         }
         ~ConnectionListsRef()
         {
             if (!connectionLists)
                 return;
 
-            --connectionLists->inUse;
-            Q_ASSERT(connectionLists->inUse >= 0);
-            if (connectionLists->orphaned) {
-                if (!connectionLists->inUse)
-                    delete connectionLists;
-            }
+            connectionLists->endEmission(epoch);
+            if (!connectionLists->ref.deref())
+                delete connectionLists;
+            else if (!connectionLists->orphaned)
+                connectionLists->cleanOrphans(signalSlotLock(sender));
         }
 
         QObjectConnectionListVector *operator->() const { return connectionLists; }
     };
-    ConnectionListsRef connectionLists = sender->d_func()->connectionLists;
+    ConnectionListsRef connectionLists(sender->d_func()->connectionLists.loadAcquire(), sender);
     if (!connectionLists.connectionLists) {
-        locker.unlock();
         if (qt_signal_spy_callback_set.signal_end_callback != 0)
             qt_signal_spy_callback_set.signal_end_callback(sender, signal_index);
         return;
     }
 
+    const QObjectConnectionListVector::ListArray *signalLists = connectionLists->signalLists.loadAcquire();
+
     const QObjectPrivate::ConnectionList *list;
-    if (signal_index < connectionLists->count())
-        list = &connectionLists->at(signal_index);
+    if (signalLists && signal_index < signalLists->count)
+        list = &signalLists->lists[signal_index];
     else
         list = &connectionLists->allsignals;
 
+    // We need to check against the id of the last connection of each list here to
+    // ensure that signals added during the signal emission are not emitted in this
+    // emission. Ids never wrap, and the last connections stay alive with the epoch.
+    const QObjectPrivate::Connection *last = list->last.loadAcquire();
+    const quint64 highestConnectionId = last ? last->id : 0;
+    last = connectionLists->allsignals.last.loadAcquire();
+    const quint64 highestAllSignalsConnectionId = last ? last->id : 0;
+
     do {
-        QObjectPrivate::Connection *c = list->first;
-        if (!c) continue;
-        // We need to check against last here to ensure that signals added
-        // during the signal emission are not emitted in this emission.
-        QObjectPrivate::Connection *last = list->last;
-
-        do {
-            if (!c->receiver)
+        const quint64 highestId = list == &connectionLists->allsignals
+                                  ? highestAllSignalsConnectionId : highestConnectionId;
+        QObjectPrivate::Connection *c = list->first.loadAcquire();
+        for (; c && c->id <= highestId; c = c->nextConnectionList.loadAcquire()) {
+            QObject * const receiver = c->receiver.loadAcquire();
+            if (!receiver)
                 continue;
 
-            QObject * const receiver = c->receiver;
-            const bool receiverInSameThread = currentThreadId == receiver->d_func()->threadData->threadId;
+            const QThreadData *receiverThreadData = c->receiverThreadData.loadAcquire();
+            const bool receiverInSameThread = currentThreadId == receiverThreadData->threadId;
 
             // determine if this connection should be sent immediately or
             // put into the event queue
@@ -3634,7 +3923,6 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
                 continue;
 #ifndef QT_NO_THREAD
             } else if (c->connectionType == Qt::BlockingQueuedConnection) {
-                locker.unlock();
                 if (receiverInSameThread) {
                     qWarning("Qt: Dead lock detected while activating a BlockingQueuedConnection: "
                     "Sender is %s(%p), receiver is %s(%p)",
@@ -3645,9 +3933,8 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
                 QMetaCallEvent *ev = c->isSlotObject ?
                     new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
                     new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore);
-                QCoreApplication::postEvent(receiver, ev);
-                semaphore.acquire();
-                locker.relock();
+                if (postUnlessDisconnected(c, receiver, ev))
+                    semaphore.acquire();
                 continue;
 #endif
             }
@@ -3660,20 +3947,9 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
             const QObjectPrivate::StaticMetaCallFunction callFunction = c->callFunction;
             const int method_relative = c->method_relative;
             if (c->isSlotObject) {
-                c->slotObj->ref();
-                QScopedPointer<QtPrivate::QSlotObjectBase, QSlotObjectBaseDeleter> obj(c->slotObj);
-                locker.unlock();
-                obj->call(receiver, argv ? argv : empty_argv);
-
-                // Make sure the slot object gets destroyed before the mutex is locked again, as the
-                // destructor of the slot object might also lock a mutex from the signalSlotLock() mutex pool,
-                // and that would deadlock if the pool happens to return the same mutex.
-                obj.reset();
-
-                locker.relock();
+                c->slotObj->call(receiver, argv ? argv : empty_argv);
             } else if (callFunction && c->method_offset <= receiver->metaObject()->methodOffset()) {
                 //we compare the vtable to make sure we are not in the destructor of the object.
-                locker.unlock();
                 if (qt_signal_spy_callback_set.slot_begin_callback != 0)
                     qt_signal_spy_callback_set.slot_begin_callback(receiver, c->method(), argv ? argv : empty_argv);
 
@@ -3681,10 +3957,8 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
 
                 if (qt_signal_spy_callback_set.slot_end_callback != 0)
                     qt_signal_spy_callback_set.slot_end_callback(receiver, c->method());
-                locker.relock();
             } else {
                 const int method = method_relative + c->method_offset;
-                locker.unlock();
 
                 if (qt_signal_spy_callback_set.slot_begin_callback != 0) {
                     qt_signal_spy_callback_set.slot_begin_callback(receiver,
@@ -3696,13 +3970,11 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
 
                 if (qt_signal_spy_callback_set.slot_end_callback != 0)
                     qt_signal_spy_callback_set.slot_end_callback(receiver, method);
-
-                locker.relock();
             }
 
             if (connectionLists->orphaned)
                 break;
-        } while (c != last && (c = c->nextConnectionList) != 0);
+        }
 
         if (connectionLists->orphaned)
             break;
@@ -3956,27 +4228,28 @@ void QObject::dumpObjectInfo()
     // first, look for connections where this object is the sender
     qDebug("  SIGNALS OUT");
 
-    if (d->connectionLists) {
-        for (int signal_index = 0; signal_index < d->connectionLists->count(); ++signal_index) {
+    if (const QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        for (int signal_index = 0; signal_index < connectionLists->count(); ++signal_index) {
             const QMetaMethod signal = QMetaObjectPrivate::signal(metaObject(), signal_index);
             qDebug("        signal: %s", signal.methodSignature().constData());
 
             // receivers
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signal_index).first;
+                connectionLists->at(signal_index).first.load();
             while (c) {
-                if (!c->receiver) {
+                const QObject *receiver = c->receiver.load();
+                if (!receiver) {
                     qDebug("          <Disconnected receiver>");
-                    c = c->nextConnectionList;
+                    c = c->nextConnectionList.load();
                     continue;
                 }
-                const QMetaObject *receiverMetaObject = c->receiver->metaObject();
+                const QMetaObject *receiverMetaObject = receiver->metaObject();
                 const QMetaMethod method = receiverMetaObject->method(c->method());
                 qDebug("          --> %s::%s %s",
                        receiverMetaObject->className(),
-                       c->receiver->objectName().isEmpty() ? "unnamed" : qPrintable(c->receiver->objectName()),
+                       receiver->objectName().isEmpty() ? "unnamed" : qPrintable(receiver->objectName()),
                        method.methodSignature().constData());
-                c = c->nextConnectionList;
+                c = c->nextConnectionList.load();
             }
         }
     } else {
@@ -4553,17 +4826,17 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
                                signalSlotLock(receiver));
 
     if (type & Qt::UniqueConnection) {
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
         if (connectionLists && connectionLists->count() > signal_index) {
             const QObjectPrivate::Connection *c2 =
-                (*connectionLists)[signal_index].first;
+                (*connectionLists)[signal_index].first.load();
 
             while (c2) {
-                if (c2->receiver == receiver && c2->isSlotObject && c2->slotObj->compare(slot)) {
+                if (c2->receiver.load() == receiver && c2->isSlotObject && c2->slotObj->compare(slot)) {
                     slotObj->destroyIfLastRef();
                     return QMetaObject::Connection();
                 }
-                c2 = c2->nextConnectionList;
+                c2 = c2->nextConnectionList.load();
             }
         }
         type = static_cast<Qt::ConnectionType>(type ^ Qt::UniqueConnection);
@@ -4572,7 +4845,7 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     QScopedPointer<QObjectPrivate::Connection> c(new QObjectPrivate::Connection);
     c->sender = s;
     c->signal_index = signal_index;
-    c->receiver = r;
+    c->receiver.store(r);
     c->slotObj = slotObj;
     c->connectionType = type;
     c->isSlotObject = true;
@@ -4584,6 +4857,7 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     QObjectPrivate::get(s)->addConnection(signal_index, c.data());
     QMetaObject::Connection ret(c.take());
     locker.unlock();
+    QObjectPrivate::get(s)->connectionLists.load()->cleanOrphans(signalSlotLock(sender));
 
     QMetaMethod method = QMetaObjectPrivate::signal(senderMetaObject, signal_index);
     Q_ASSERT(method.isValid());
@@ -4604,30 +4878,32 @@ bool QObject::disconnect(const QMetaObject::Connection &connection)
 {
     QObjectPrivate::Connection *c = static_cast<QObjectPrivate::Connection *>(connection.d_ptr);
 
-    if (!c || !c->receiver)
+    QObject *receiver = c ? c->receiver.load() : 0;
+    if (!receiver)
         return false;
 
     QMutex *senderMutex = signalSlotLock(c->sender);
-    QMutex *receiverMutex = signalSlotLock(c->receiver);
+    QMutex *receiverMutex = signalSlotLock(receiver);
 
+    QObjectConnectionListVector::Orphans orphans;
     {
         QOrderedMutexLocker locker(senderMutex, receiverMutex);
+        if (c->receiver.load() != receiver)
+            return false;
 
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(c->sender)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(c->sender)->connectionLists.load();
         Q_ASSERT(connectionLists);
-        connectionLists->dirty = true;
+        connectionLists->dirty.store(1);
 
         *c->prev = c->next;
         if (c->next)
             c->next->prev = c->prev;
-        c->receiver = 0;
-    }
+        c->receiver.storeRelease(0);
 
-    // destroy the QSlotObject, if possible
-    if (c->isSlotObject) {
-        c->slotObj->destroyIfLastRef();
-        c->isSlotObject = false;
+        // the QSlotObject is destroyed with the connection, unless an emission is in progress
+        orphans = connectionLists->takeOrphans();
     }
+    QObjectConnectionListVector::freeOrphans(orphans);
 
     const_cast<QMetaObject::Connection &>(connection).d_ptr = 0;
     c->deref(); // has been removed from the QMetaObject::Connection object
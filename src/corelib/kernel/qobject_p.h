@@ -124,28 +124,36 @@ public:
     };
 
     typedef void (*StaticMetaCallFunction)(QObject *, QMetaObject::Call, int, void **);
+    // QMetaObject::activate() reads receiver, receiverThreadData and
+    // nextConnectionList without holding the signalSlotLock(), all other
+    // members are only changed while no activate() can see the connection.
     struct Connection
     {
         QObject *sender;
-        QObject *receiver;
+        QAtomicPointer<QObject> receiver;
+        // the thread data of the receiver, referenced by the connection
+        QAtomicPointer<QThreadData> receiverThreadData;
         union {
             StaticMetaCallFunction callFunction;
             QtPrivate::QSlotObjectBase *slotObj;
         };
         // The next pointer for the singly-linked ConnectionList
-        Connection *nextConnectionList;
+        QAtomicPointer<Connection> nextConnectionList;
+        // The next pointer once the connection has been unlinked from its ConnectionList
+        Connection *nextInOrphanList;
         //senders linked list
         Connection *next;
         Connection **prev;
         QAtomicPointer<const int> argumentTypes;
         QAtomicInt ref_;
+        quint64 id; // increases along a ConnectionList, see QObjectConnectionListVector
         ushort method_offset;
         ushort method_relative;
         uint signal_index : 27; // In signal range (see QObjectPrivate::signalIndex())
         ushort connectionType : 3; // 0 == auto, 1 == direct, 2 == queued, 4 == blocking
         ushort isSlotObject : 1;
         ushort ownArgumentTypes : 1;
-        Connection() : nextConnectionList(0), ref_(2), ownArgumentTypes(true) {
+        Connection() : nextConnectionList(0), nextInOrphanList(0), ref_(2), id(0), ownArgumentTypes(true) {
             //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
         }
         ~Connection();
@@ -153,7 +161,7 @@ public:
         void ref() { ref_.ref(); }
         void deref() {
             if (!ref_.deref()) {
-                Q_ASSERT(!receiver);
+                Q_ASSERT(!receiver.load());
                 delete this;
             }
         }
@@ -161,8 +169,8 @@ public:
     // ConnectionList is a singly-linked list
     struct ConnectionList {
         ConnectionList() : first(0), last(0) {}
-        Connection *first;
-        Connection *last;
+        QAtomicPointer<Connection> first;
+        QAtomicPointer<Connection> last;
     };
 
     struct Sender
@@ -180,6 +188,7 @@ public:
     void setParent_helper(QObject *);
     void moveToThread_helper();
     void setThreadData_helper(QThreadData *currentData, QThreadData *targetData);
+    void setReceiverThreadData_helper(QThreadData *targetData);
     void _q_reregisterTimers(void *pointer);
 
     bool isSender(const QObject *receiver, const char *signal) const;
@@ -226,7 +235,7 @@ public:
     ExtraData *extraData;    // extra data set by the user
     QThreadData *threadData; // id of the thread that owns the object
 
-    QObjectConnectionListVector *connectionLists;
+    QAtomicPointer<QObjectConnectionListVector> connectionLists;
 
     Connection *senders;     // linked list of connections connected to this object
     Sender *currentSender;   // object currently activating the object
@@ -384,6 +393,11 @@ public:
 
     virtual void placeMetaCall(QObject *object);
 
+    // links the event into the lock-free stack of QPostEventList while it
+    // is being posted, see QCoreApplication::postEvent()
+    QMetaCallEvent *nextPosted;
+    QObject *postedReceiver;
+
 private:
     QtPrivate::QSlotObjectBase *slotObj_;
     const QObject *sender_;
@@ -53,6 +53,9 @@
 #endif
 
 #include <sys/times.h>
+#include <string.h>
+
+#include <algorithm>
 
 QT_BEGIN_NAMESPACE
 
@@ -85,6 +88,37 @@ QTimerInfoList::QTimerInfoList()
 #endif
 
     firstTimerInfo = 0;
+    timerWheel = 0;
+    timerWheelEnabled = false;
+}
+
+QTimerInfoList::~QTimerInfoList()
+{
+    // the timers in the list are deleted by the event dispatcher, but the
+    // ones in the wheel are ours
+    delete timerWheel;
+}
+
+/*
+  Returns true if the QT_TIMER_WHEEL environment variable asks for coarse
+  timers to be kept in a QTimerWheel. The wheel fires the precise timers of
+  an activation round before the coarse ones, so timers that are due
+  together may fire in a different order than with the sorted list; this is
+  why the event dispatchers leave it off by default.
+*/
+bool QTimerInfoList::isTimerWheelRequested()
+{
+    return !qEnvironmentVariableIsEmpty("QT_TIMER_WHEEL");
+}
+
+/*
+  Selects whether coarse and very coarse timers are kept in a QTimerWheel
+  instead of the sorted list. Must be called before any timer is registered.
+*/
+void QTimerInfoList::setTimerWheelEnabled(bool enable)
+{
+    Q_ASSERT(!timerWheel || timerWheel->isEmpty());
+    timerWheelEnabled = enable;
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -156,6 +190,8 @@ void QTimerInfoList::timerRepair(const timespec &diff)
         QTimerInfo *t = at(i);
         t->timeout = t->timeout + diff;
     }
+    if (timerWheel)
+        timerWheel->repair(diff, currentTime);
 }
 
 void QTimerInfoList::repairTimersIfNeeded()
@@ -175,6 +211,286 @@ void QTimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+/*
+ * QTimerWheel
+ *
+ * Time is counted in ticks of one millisecond. The wheel has LevelCount
+ * levels of SlotCount slots each; a slot on level L spans SlotCount^L ticks
+ * and the whole level spans SlotCount^(L+1) ticks. A timer is kept on the
+ * lowest level whose span, aligned to a multiple of itself, contains both
+ * the current tick and the timer's tick. Consequently, every timer on a
+ * level fires before every timer on the levels above it, and a timer on
+ * level 0 is in the slot of its exact tick.
+ *
+ * When the current tick moves on, the slots that were passed are emptied
+ * and their timers are placed again: the due ones go to the expired list,
+ * the others cascade down to a lower level. Timers that do not fit in the
+ * top level wait in the overflow list until the top level wraps around.
+ */
+
+static inline qint64 timespecToTick(const timespec &ts, bool roundUp)
+{
+    qint64 tick = qint64(ts.tv_sec) * 1000 + ts.tv_nsec / (1000 * 1000);
+    if (roundUp && ts.tv_nsec % (1000 * 1000))
+        ++tick;
+    return tick;
+}
+
+static inline int lowestSetBit(quint64 v)
+{
+    Q_ASSERT(v);
+#if defined(Q_CC_GNU)
+    return __builtin_ctzll(v);
+#else
+    int bit = 0;
+    while (!(v & 1)) {
+        v >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+static inline bool tickLessThan(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    return t1->wheelTick < t2->wheelTick;
+}
+
+QTimerWheel::QTimerWheel()
+    : currentTick(timespecToTick(qt_gettime(), false))
+{
+    init();
+}
+
+/*
+  Constructs a wheel whose current tick is \a currentTime instead of the
+  time now. Used by the autotest, which drives the wheel with its own clock.
+*/
+QTimerWheel::QTimerWheel(const timespec &currentTime)
+    : currentTick(timespecToTick(currentTime, false))
+{
+    init();
+}
+
+void QTimerWheel::init()
+{
+    memset(wheel, 0, sizeof(wheel));
+    memset(occupied, 0, sizeof(occupied));
+    expired.first = expired.last = 0;
+    batch.first = batch.last = 0;
+    overflow.first = overflow.last = 0;
+}
+
+QTimerWheel::~QTimerWheel()
+{
+    qDeleteAll(timers);
+}
+
+inline QTimerWheel::TimerList &QTimerWheel::list(int slot)
+{
+    switch (slot) {
+    case ExpiredSlot:
+        return expired;
+    case BatchSlot:
+        return batch;
+    case OverflowSlot:
+        return overflow;
+    }
+    return wheel[slot / SlotCount][slot % SlotCount];
+}
+
+void QTimerWheel::link(QTimerInfo *t, int slot)
+{
+    TimerList &l = list(slot);
+    t->wheelSlot = slot;
+    t->wheelNext = 0;
+    t->wheelPrev = l.last;
+    if (l.last)
+        l.last->wheelNext = t;
+    else
+        l.first = t;
+    l.last = t;
+    if (slot >= 0)
+        occupied[slot / SlotCount] |= Q_UINT64_C(1) << (slot % SlotCount);
+}
+
+void QTimerWheel::unlink(QTimerInfo *t)
+{
+    TimerList &l = list(t->wheelSlot);
+    if (t->wheelPrev)
+        t->wheelPrev->wheelNext = t->wheelNext;
+    else
+        l.first = t->wheelNext;
+    if (t->wheelNext)
+        t->wheelNext->wheelPrev = t->wheelPrev;
+    else
+        l.last = t->wheelPrev;
+    if (!l.first && t->wheelSlot >= 0)
+        occupied[t->wheelSlot / SlotCount] &= ~(Q_UINT64_C(1) << (t->wheelSlot % SlotCount));
+    t->wheelPrev = t->wheelNext = 0;
+}
+
+void QTimerWheel::place(QTimerInfo *t)
+{
+    const qint64 tick = t->wheelTick;
+    if (tick <= currentTick) {
+        link(t, ExpiredSlot);
+        return;
+    }
+
+    for (int level = 0; level < LevelCount; ++level) {
+        const int shift = SlotBits * (level + 1);
+        if ((tick >> shift) == (currentTick >> shift)) {
+            const int index = int((tick >> (SlotBits * level)) & (SlotCount - 1));
+            link(t, level * SlotCount + index);
+            return;
+        }
+    }
+    link(t, OverflowSlot);
+}
+
+void QTimerWheel::collect(TimerList &from, QVarLengthArray<QTimerInfo *, 64> &into)
+{
+    for (QTimerInfo *t = from.first; t; t = t->wheelNext)
+        into.append(t);
+    from.first = from.last = 0;
+}
+
+void QTimerWheel::insert(QTimerInfo *t)
+{
+    t->wheelTick = timespecToTick(t->timeout, true);
+    timers.insert(t->id, t);
+    place(t);
+}
+
+void QTimerWheel::remove(QTimerInfo *t)
+{
+    timers.remove(t->id);
+    unlink(t);
+}
+
+/*
+  Moves the wheel forward to \a currentTime, which puts every timer that is
+  due by then into the expired list.
+*/
+void QTimerWheel::advance(const timespec &currentTime)
+{
+    const qint64 now = timespecToTick(currentTime, false);
+    if (now <= currentTick)
+        return;
+
+    QVarLengthArray<QTimerInfo *, 64> moved;
+    for (int level = 0; level < LevelCount; ++level) {
+        const int shift = SlotBits * (level + 1);
+        const int slotShift = SlotBits * level;
+        if ((now >> shift) != (currentTick >> shift)) {
+            // we left the span of this level, so all its timers are either
+            // due or go to a lower level; continue with the level above
+            for (int i = 0; i < SlotCount; ++i) {
+                if (occupied[level] & (Q_UINT64_C(1) << i))
+                    collect(wheel[level][i], moved);
+            }
+            occupied[level] = 0;
+            continue;
+        }
+
+        // still in the same span: empty the slots we passed, including the
+        // one that 'now' falls into. The levels above are unaffected.
+        const int from = int((currentTick >> slotShift) & (SlotCount - 1)) + 1;
+        const int to = int((now >> slotShift) & (SlotCount - 1));
+        for (int i = from; i <= to; ++i) {
+            if (occupied[level] & (Q_UINT64_C(1) << i)) {
+                collect(wheel[level][i], moved);
+                occupied[level] &= ~(Q_UINT64_C(1) << i);
+            }
+        }
+        break;
+    }
+    if ((now >> (SlotBits * LevelCount)) != (currentTick >> (SlotBits * LevelCount)))
+        collect(overflow, moved);
+
+    currentTick = now;
+
+    // keep timers that are due at the same tick in the order they were started
+    std::stable_sort(moved.begin(), moved.end(), tickLessThan);
+    for (int i = 0; i < moved.size(); ++i)
+        place(moved.at(i));
+}
+
+/*
+  Returns the time at which the wheel needs to advance next, or false if the
+  wheel has no timers. For timers above level 0 this is the start of their
+  slot rather than their timeout: advancing to it moves them down a level,
+  which is cheaper than searching the slot for the earliest timer.
+*/
+bool QTimerWheel::nextTimeout(timespec &tm) const
+{
+    if (expired.first || batch.first) {
+        tm = expired.first ? expired.first->timeout : batch.first->timeout;
+        return true;
+    }
+
+    qint64 tick = -1;
+    for (int level = 0; level < LevelCount; ++level) {
+        if (occupied[level]) {
+            // the lowest occupied slot holds the earliest timers of the level
+            const int shift = SlotBits * (level + 1);
+            tick = ((currentTick >> shift) << shift)
+                   + (qint64(lowestSetBit(occupied[level])) << (SlotBits * level));
+            break;
+        }
+    }
+    if (tick < 0) {
+        if (!overflow.first)
+            return false;
+        // the overflow list is looked at when the top level wraps around
+        const int shift = SlotBits * LevelCount;
+        tick = ((currentTick >> shift) + 1) << shift;
+    }
+
+    tm.tv_sec = tick / 1000;
+    tm.tv_nsec = (tick % 1000) * 1000 * 1000;
+    return true;
+}
+
+/*
+  Starts an activation round: the timers that are expired now are the ones
+  returned by takeActivated(). Timers that expire again while they are being
+  activated wait for the next round.
+*/
+void QTimerWheel::beginActivation()
+{
+    while (QTimerInfo *t = expired.first) {
+        unlink(t);
+        link(t, BatchSlot);
+    }
+}
+
+QTimerInfo *QTimerWheel::takeActivated()
+{
+    QTimerInfo *t = batch.first;
+    if (t)
+        unlink(t);
+    return t;
+}
+
+void QTimerWheel::repair(const timespec &diff, const timespec &currentTime)
+{
+    QVarLengthArray<QTimerInfo *, 64> all;
+    for (QHash<int, QTimerInfo *>::const_iterator it = timers.constBegin(); it != timers.constEnd(); ++it) {
+        QTimerInfo *t = it.value();
+        unlink(t);
+        t->timeout = t->timeout + diff;
+        t->wheelTick = timespecToTick(t->timeout, true);
+        all.append(t);
+    }
+
+    currentTick = timespecToTick(currentTime, false);
+    std::stable_sort(all.begin(), all.end(), tickLessThan);
+    for (int i = 0; i < all.size(); ++i)
+        place(all.at(i));
+}
+
 /*
   insert timer info into list
 */
@@ -387,6 +703,29 @@ bool QTimerInfoList::timerWait(timespec &tm)
     timespec currentTime = updateCurrentTime();
     repairTimersIfNeeded();
 
+    timespec deadline;
+    if (!timerDeadline(deadline))
+        return false;
+
+    if (currentTime < deadline) {
+        // time to wait
+        tm = roundToMillisecond(deadline - currentTime);
+    } else {
+        // no time to wait
+        tm.tv_sec  = 0;
+        tm.tv_nsec = 0;
+    }
+
+    return true;
+}
+
+/*
+  Returns the absolute time at which the next timer is due, or false if no
+  timers are waiting. Unlike timerWait(), this does not read the clock. For
+  coarse timers, the time returned may be earlier than their timeout.
+*/
+bool QTimerInfoList::timerDeadline(timespec &tm)
+{
     // Find first waiting timer not already active
     QTimerInfo *t = 0;
     for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
@@ -396,19 +735,18 @@ bool QTimerInfoList::timerWait(timespec &tm)
         }
     }
 
-    if (!t)
-      return false;
-
-    if (currentTime < t->timeout) {
-        // time to wait
-        tm = roundToMillisecond(t->timeout - currentTime);
-    } else {
-        // no time to wait
-        tm.tv_sec  = 0;
-        tm.tv_nsec = 0;
+    bool found = false;
+    if (t) {
+        tm = t->timeout;
+        found = true;
     }
 
-    return true;
+    timespec wheelTimeout;
+    if (timerWheel && timerWheel->nextTimeout(wheelTimeout) && (!found || wheelTimeout < tm)) {
+        tm = wheelTimeout;
+        found = true;
+    }
+    return found;
 }
 
 /*
@@ -422,16 +760,19 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    QTimerInfo *t = timerWheel ? timerWheel->find(timerId) : 0;
+    for (int i = 0; !t && i < count(); ++i) {
+        if (at(i)->id == timerId)
+            t = at(i);
+    }
+
+    if (t) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -450,6 +791,9 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     t->timerType = timerType;
     t->obj = object;
     t->activateRef = 0;
+    t->wheelPrev = t->wheelNext = 0;
+    t->wheelTick = 0;
+    t->wheelSlot = 0;
 
     timespec expected = updateCurrentTime() + interval;
 
@@ -493,7 +837,13 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
             ++t->timeout.tv_sec;
     }
 
-    timerInsert(t);
+    if (timerWheelEnabled && t->timerType != Qt::PreciseTimer) {
+        if (!timerWheel)
+            timerWheel = new QTimerWheel;
+        timerWheel->insert(t);
+    } else {
+        timerInsert(t);
+    }
 
 #ifdef QTIMERINFO_DEBUG
     t->expected = expected;
@@ -507,6 +857,16 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
+    if (timerWheel) {
+        if (QTimerInfo *t = timerWheel->find(timerId)) {
+            timerWheel->remove(t);
+            if (t->activateRef)
+                *(t->activateRef) = 0;
+            delete t;
+            return true;
+        }
+    }
+
     // set timer inactive
     for (int i = 0; i < count(); ++i) {
         QTimerInfo *t = at(i);
@@ -527,8 +887,24 @@ bool QTimerInfoList::unregisterTimer(int timerId)
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
-    if (isEmpty())
+    if (isEmpty() && (!timerWheel || timerWheel->isEmpty()))
         return false;
+    if (timerWheel) {
+        QVarLengthArray<QTimerInfo *, 16> found;
+        const QHash<int, QTimerInfo *> &wheelTimers = timerWheel->allTimers();
+        for (QHash<int, QTimerInfo *>::const_iterator it = wheelTimers.constBegin();
+             it != wheelTimers.constEnd(); ++it) {
+            if (it.value()->obj == object)
+                found.append(it.value());
+        }
+        for (int i = 0; i < found.size(); ++i) {
+            QTimerInfo *t = found.at(i);
+            timerWheel->remove(t);
+            if (t->activateRef)
+                *(t->activateRef) = 0;
+            delete t;
+        }
+    }
     for (int i = 0; i < count(); ++i) {
         QTimerInfo *t = at(i);
         if (t->obj == object) {
@@ -546,17 +922,29 @@ bool QTimerInfoList::unregisterTimers(QObject *object)
     return true;
 }
 
+static inline QAbstractEventDispatcher::TimerInfo timerInfoFor(const QTimerInfo *t)
+{
+    return QAbstractEventDispatcher::TimerInfo(t->id,
+                                               (t->timerType == Qt::VeryCoarseTimer
+                                                ? t->interval * 1000
+                                                : t->interval),
+                                               t->timerType);
+}
+
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
     QList<QAbstractEventDispatcher::TimerInfo> list;
     for (int i = 0; i < count(); ++i) {
         const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
+        if (t->obj == object)
+            list << timerInfoFor(t);
+    }
+    if (timerWheel) {
+        const QHash<int, QTimerInfo *> &wheelTimers = timerWheel->allTimers();
+        for (QHash<int, QTimerInfo *>::const_iterator it = wheelTimers.constBegin();
+             it != wheelTimers.constEnd(); ++it) {
+            if (it.value()->obj == object)
+                list << timerInfoFor(it.value());
         }
     }
     return list;
@@ -567,7 +955,7 @@ QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObj
 */
 int QTimerInfoList::activateTimers()
 {
-    if (qt_disable_lowpriority_timers || isEmpty())
+    if (qt_disable_lowpriority_timers || (isEmpty() && (!timerWheel || timerWheel->isEmpty())))
         return 0; // nothing to do
 
     int n_act = 0, maxCount = 0;
@@ -648,8 +1036,41 @@ int QTimerInfoList::activateTimers()
     }
 
     firstTimerInfo = 0;
+
+    // the coarse timers in the wheel come after the precise ones
+    if (timerWheel)
+        n_act += activateWheelTimers(currentTime);
+
     // qDebug() << "Thread" << QThread::currentThreadId() << "activated" << n_act << "timers";
     return n_act;
 }
 
+int QTimerInfoList::activateWheelTimers(const timespec &currentTime)
+{
+    int n_act = 0;
+    timerWheel->advance(currentTime);
+    timerWheel->beginActivation();
+    while (QTimerInfo *currentTimerInfo = timerWheel->takeActivated()) {
+        // determine next timeout time
+        calculateNextTimeout(currentTimerInfo, currentTime);
+
+        // reinsert timer
+        timerWheel->insert(currentTimerInfo);
+        if (currentTimerInfo->interval > 0)
+            n_act++;
+
+        if (!currentTimerInfo->activateRef) {
+            // send event, but don't allow it to recurse
+            currentTimerInfo->activateRef = &currentTimerInfo;
+
+            QTimerEvent e(currentTimerInfo->id);
+            QCoreApplication::sendEvent(currentTimerInfo->obj, &e);
+
+            if (currentTimerInfo)
+                currentTimerInfo->activateRef = 0;
+        }
+    }
+    return n_act;
+}
+
 QT_END_NAMESPACE
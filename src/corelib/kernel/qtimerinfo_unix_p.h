@@ -56,6 +56,8 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
+#include "qvarlengtharray.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -70,6 +72,12 @@ struct QTimerInfo {
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
 
+    // bookkeeping for timers kept in a QTimerWheel
+    QTimerInfo *wheelPrev;
+    QTimerInfo *wheelNext;
+    qint64 wheelTick; // - timeout in whole milliseconds, rounded up
+    int wheelSlot;    // - index of the list the timer is linked into
+
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
     float cumulativeError;
@@ -77,6 +85,69 @@ struct QTimerInfo {
 #endif
 };
 
+/*
+  A hierarchical timing wheel for coarse timers. Inserting and removing a
+  timer is O(1), and finding the next timer to fire does not depend on the
+  number of timers either.
+*/
+class Q_CORE_EXPORT QTimerWheel
+{
+public:
+    enum {
+        SlotBits = 6,
+        SlotCount = 1 << SlotBits,
+        LevelCount = 6
+    };
+
+    QTimerWheel();
+    explicit QTimerWheel(const timespec &currentTime);
+    ~QTimerWheel();
+
+    bool isEmpty() const { return timers.isEmpty(); }
+    const QHash<int, QTimerInfo *> &allTimers() const { return timers; }
+    QTimerInfo *find(int timerId) const { return timers.value(timerId); }
+
+    void insert(QTimerInfo *t);
+    void remove(QTimerInfo *t);
+
+    void advance(const timespec &currentTime);
+    bool nextTimeout(timespec &tm) const;
+
+    void beginActivation();
+    QTimerInfo *takeActivated();
+
+    void repair(const timespec &diff, const timespec &currentTime);
+
+private:
+    struct TimerList {
+        QTimerInfo *first;
+        QTimerInfo *last;
+    };
+
+    enum {
+        ExpiredSlot = -1,
+        BatchSlot = -2,
+        OverflowSlot = -3
+    };
+
+    void init();
+    TimerList &list(int slot);
+    void link(QTimerInfo *t, int slot);
+    void unlink(QTimerInfo *t);
+    void place(QTimerInfo *t);
+    void collect(TimerList &from, QVarLengthArray<QTimerInfo *, 64> &into);
+
+    QHash<int, QTimerInfo *> timers;
+    TimerList wheel[LevelCount][SlotCount];
+    quint64 occupied[LevelCount];
+    TimerList expired;
+    TimerList batch;
+    TimerList overflow;
+    qint64 currentTick;
+
+    Q_DISABLE_COPY(QTimerWheel)
+};
+
 class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
@@ -92,8 +163,18 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     // state variables used by activateTimers()
     QTimerInfo *firstTimerInfo;
 
+    // coarse timers, if enabled; all other timers are kept in the list
+    QTimerWheel *timerWheel;
+    bool timerWheelEnabled;
+
+    int activateWheelTimers(const timespec &currentTime);
+
 public:
     QTimerInfoList();
+    ~QTimerInfoList();
+
+    static bool isTimerWheelRequested();
+    void setTimerWheelEnabled(bool enable);
 
     timespec currentTime;
     timespec updateCurrentTime();
@@ -102,6 +183,7 @@ public:
     void repairTimersIfNeeded();
 
     bool timerWait(timespec &);
+    bool timerDeadline(timespec &);
     void timerInsert(QTimerInfo *);
 
     int timerRemainingTime(int timerId);
@@ -112,6 +194,9 @@ public:
     QList<QAbstractEventDispatcher::TimerInfo> registeredTimers(QObject *object) const;
 
     int activateTimers();
+
+private:
+    Q_DISABLE_COPY(QTimerInfoList)
 };
 
 QT_END_NAMESPACE
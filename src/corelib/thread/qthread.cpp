@@ -83,6 +83,7 @@ QThreadData::~QThreadData()
     thread = 0;
     delete t;
 
+    takeLockFreePostedEvents();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -95,6 +96,40 @@ QThreadData::~QThreadData()
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
+bool QThreadData::takeLockFreePostedEvents()
+{
+    QMetaCallEvent *event = postEventList.lockFreeEvents.fetchAndStoreAcquire(0);
+    if (!event)
+        return false;
+
+    // the stack holds the newest event first, reverse it to keep the posting order
+    QMetaCallEvent *first = 0;
+    while (event) {
+        QMetaCallEvent *next = event->nextPosted;
+        event->nextPosted = first;
+        first = event;
+        event = next;
+    }
+
+    while (first) {
+        event = first;
+        first = event->nextPosted;
+        event->nextPosted = 0;
+
+        // the receiver can only have left this thread under a lock-free
+        // poster's feet in QObject::moveToThread(), which holds the mutexes
+        // of both threads while calling this function
+        QObject *receiver = event->postedReceiver;
+        QThreadData *data = receiver->d_func()->threadData;
+        data->postEventList.addEvent(QPostEvent(receiver, event, Qt::NormalEventPriority));
+        ++receiver->d_func()->postedEvents;
+        data->canWait = false;
+        if (data != this && data->eventDispatcher.load())
+            data->eventDispatcher.load()->wakeUp();
+    }
+    return true;
+}
+
 void QThreadData::ref()
 {
 #ifndef QT_NO_THREAD
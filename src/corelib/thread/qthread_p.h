@@ -110,10 +110,30 @@ public:
 
     QMutex mutex;
 
+    // queued signals posted without taking the mutex, newest first. They
+    // are moved into the list by QThreadData::takeLockFreePostedEvents().
+    QAtomicPointer<QMetaCallEvent> lockFreeEvents;
+    // number of threads currently inside the lock-free posting path
+    QAtomicInt lockFreePosters;
+
     inline QPostEventList()
         : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0)
     { }
 
+    inline bool hasLockFreeEvents() const
+    { return lockFreeEvents.load() != 0; }
+
+    // returns true if the stack was empty, i.e. the receiving thread needs a wake up
+    bool pushLockFree(QObject *receiver, QMetaCallEvent *event)
+    {
+        event->postedReceiver = receiver;
+        QMetaCallEvent *head = lockFreeEvents.load();
+        do {
+            event->nextPosted = head;
+        } while (!lockFreeEvents.testAndSetRelease(head, event, head));
+        return head == 0;
+    }
+
     void addEvent(const QPostEvent &ev) {
         int priority = ev.priority;
         if (isEmpty() ||
@@ -246,9 +266,12 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasLockFreeEvents();
     }
 
+    // postEventList.mutex must be locked
+    bool takeLockFreePostedEvents();
+
     // This class provides per-thread (by way of being a QThreadData
     // member) storage for qFlagLocation()
     class FlaggedDebugSignatures
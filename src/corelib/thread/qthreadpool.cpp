@@ -59,13 +59,43 @@ class QThreadPoolThread : public QThread
 public:
     QThreadPoolThread(QThreadPoolPrivate *manager);
     void run();
+    void runRunnable(QRunnable *r);
+    QRunnable *takeLocalTask();
     void registerThreadInactive();
 
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // runnables started from this thread while work stealing is enabled;
+    // the thread itself takes them from the back, others from the front
+    QMutex localMutex;
+    QList<QRunnable *> localQueue;
 };
 
+#if defined(Q_COMPILER_THREAD_LOCAL) || (defined(Q_CC_MSVC) && !defined(Q_OS_WINCE))
+#if defined(Q_CC_MSVC)
+static __declspec(thread) QThreadPoolThread *currentPoolThread = 0;
+#else
+static thread_local QThreadPoolThread *currentPoolThread = 0;
+#endif
+
+static inline void setCurrentPoolThread(QThreadPoolThread *thread)
+{
+    currentPoolThread = thread;
+}
+
+static inline QThreadPoolThread *poolThreadForCurrentThread()
+{
+    return currentPoolThread;
+}
+
+#else
+// without thread-local storage, all runnables go through the pool's queue
+static inline void setCurrentPoolThread(QThreadPoolThread *) { }
+static inline QThreadPoolThread *poolThreadForCurrentThread() { return 0; }
+#endif // (Q_COMPILER_THREAD_LOCAL) || ((Q_CC_MSVC) && !(Q_OS_WINCE))
+
 /*
     QThreadPool private class.
 */
@@ -83,6 +113,8 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    setCurrentPoolThread(this);
+
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -90,35 +122,37 @@ void QThreadPoolThread::run()
 
         do {
             if (r) {
-                const bool autoDelete = r->autoDelete();
-
-
-                // run the task
                 locker.unlock();
-#ifndef QT_NO_EXCEPTIONS
-                try {
-#endif
-                    r->run();
-#ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
+                if (manager->workStealing) {
+                    // run the task, and then the ones it started, without
+                    // taking the pool mutex in between
+                    do {
+                        const bool autoDelete = r->autoDelete();
+                        runRunnable(r);
+                        if (autoDelete && manager->derefRunnable(r))
+                            delete r;
+                    } while ((r = takeLocalTask()) != 0);
+                    locker.relock();
+                } else {
+                    const bool autoDelete = r->autoDelete();
+                    runRunnable(r);
+                    locker.relock();
+
+                    if (autoDelete && !--r->ref)
+                        delete r;
                 }
-#endif
-                locker.relock();
-
-                if (autoDelete && !--r->ref)
-                    delete r;
             }
 
             // if too many threads are active, expire this thread
             if (manager->tooManyThreadsActive())
                 break;
 
-            r = !manager->queue.isEmpty() ? manager->queue.takeFirst().first : 0;
+            if (!manager->queue.isEmpty())
+                r = manager->queue.takeFirst().first;
+            else if (manager->workStealing)
+                r = manager->stealTask(this);
+            else
+                r = 0;
         } while (r != 0);
 
         if (manager->isExiting) {
@@ -130,12 +164,25 @@ void QThreadPoolThread::run()
         bool expired = manager->tooManyThreadsActive();
         if (!expired) {
             manager->waitingThreads.enqueue(this);
+            manager->idleThreads.ref();
+            if (manager->workStealing) {
+                // a thread that queued a runnable locally before it could
+                // see this one waiting did not wake us up; look again
+                if (QRunnable *stolen = manager->stealTask(this)) {
+                    manager->waitingThreads.removeOne(this);
+                    manager->idleThreads.deref();
+                    runnable = stolen;
+                    continue;
+                }
+            }
             registerThreadInactive();
             // wait for work, exiting after the expiry timeout is reached
             runnableReady.wait(locker.mutex(), manager->expiryTimeout);
             ++manager->activeThreads;
-            if (manager->waitingThreads.removeOne(this))
+            if (manager->waitingThreads.removeOne(this)) {
+                manager->idleThreads.deref();
                 expired = true;
+            }
         }
         if (expired) {
             manager->expiredThreads.enqueue(this);
@@ -145,6 +192,32 @@ void QThreadPoolThread::run()
     }
 }
 
+/*
+    Runs \a r. Must be called without the pool mutex locked.
+*/
+void QThreadPoolThread::runRunnable(QRunnable *r)
+{
+#ifndef QT_NO_EXCEPTIONS
+    try {
+#endif
+        r->run();
+#ifndef QT_NO_EXCEPTIONS
+    } catch (...) {
+        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                 "This is not supported, exceptions thrown in worker threads must be\n"
+                 "caught before control returns to Qt Concurrent.");
+        registerThreadInactive();
+        throw;
+    }
+#endif
+}
+
+QRunnable *QThreadPoolThread::takeLocalTask()
+{
+    QMutexLocker locker(&localMutex);
+    return !localQueue.isEmpty() ? localQueue.takeLast() : 0;
+}
+
 void QThreadPoolThread::registerThreadInactive()
 {
     if (--manager->activeThreads == 0)
@@ -160,7 +233,8 @@ QThreadPoolPrivate:: QThreadPoolPrivate()
       expiryTimeout(30000),
       maxThreadCount(qAbs(QThread::idealThreadCount())),
       reservedThreads(0),
-      activeThreads(0)
+      activeThreads(0),
+      workStealing(false)
 { }
 
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
@@ -178,7 +252,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
     if (waitingThreads.count() > 0) {
         // recycle an available thread
         enqueueTask(task);
-        waitingThreads.takeFirst()->runnableReady.wakeOne();
+        wakeOneWaitingThread();
         return true;
     }
 
@@ -190,7 +264,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         ++activeThreads;
 
         if (task->autoDelete())
-            ++task->ref;
+            refRunnable(task);
         thread->runnable = task;
         thread->start();
         return true;
@@ -209,7 +283,7 @@ inline bool operator<(const QPair<QRunnable *, int> &p, int priority)
 void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
 {
     if (runnable->autoDelete())
-        ++runnable->ref;
+        refRunnable(runnable);
 
     // put it on the queue
     QList<QPair<QRunnable *, int> >::const_iterator begin = queue.constBegin();
@@ -251,7 +325,7 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     ++activeThreads;
 
     if (runnable->autoDelete())
-        ++runnable->ref;
+        refRunnable(runnable);
     thread->runnable = runnable;
     thread.take()->start();
 }
@@ -282,6 +356,7 @@ void QThreadPoolPrivate::reset()
     }
 
     waitingThreads.clear();
+    idleThreads.store(0);
     expiredThreads.clear();
 
     isExiting = false;
@@ -310,10 +385,19 @@ void QThreadPoolPrivate::clear()
     for (QList<QPair<QRunnable *, int> >::const_iterator it = queue.constBegin();
          it != queue.constEnd(); ++it) {
         QRunnable* r = it->first;
-        if (r->autoDelete() && !--r->ref)
+        if (r->autoDelete() && derefRunnable(r))
             delete r;
     }
     queue.clear();
+
+    foreach (QThreadPoolThread *thread, allThreads) {
+        QMutexLocker localLocker(&thread->localMutex);
+        foreach (QRunnable *r, thread->localQueue) {
+            if (r->autoDelete() && derefRunnable(r))
+                delete r;
+        }
+        thread->localQueue.clear();
+    }
 }
 
 /*!
@@ -340,13 +424,23 @@ void QThreadPoolPrivate::stealRunnable(QRunnable *runnable)
             }
             ++it;
         }
+
+        if (!found && workStealing) {
+            foreach (QThreadPoolThread *thread, allThreads) {
+                QMutexLocker localLocker(&thread->localMutex);
+                if (thread->localQueue.removeOne(runnable)) {
+                    found = true;
+                    break;
+                }
+            }
+        }
     }
 
     if (!found)
         return;
 
     const bool autoDelete = runnable->autoDelete();
-    bool del = autoDelete && !--runnable->ref;
+    bool del = autoDelete && derefRunnable(runnable);
 
     runnable->run();
 
@@ -355,6 +449,96 @@ void QThreadPoolPrivate::stealRunnable(QRunnable *runnable)
     }
 }
 
+void QThreadPoolPrivate::wakeOneWaitingThread()
+{
+    waitingThreads.takeFirst()->runnableReady.wakeOne();
+    idleThreads.deref();
+}
+
+/*!
+    \internal
+    Queues \a task on the pool thread that calls this function, so that the
+    task can be started without taking the pool mutex. Returns \c false if
+    the runnable has to go through the pool's queue instead.
+*/
+bool QThreadPoolPrivate::enqueueLocalTask(QRunnable *task)
+{
+    QThreadPoolThread *thread = poolThreadForCurrentThread();
+    if (!thread || thread->manager != this || !workStealing)
+        return false;
+
+    QMutexLocker locker(&thread->localMutex);
+    if (thread->localQueue.isEmpty()) {
+        // the other threads may have run out of work as well, or there may
+        // be threads left to start; give them this runnable if so
+        locker.unlock();
+        {
+            QMutexLocker poolLocker(&mutex);
+            if (tryStart(task))
+                return true;
+        }
+        locker.relock();
+    }
+
+    if (task->autoDelete())
+        refRunnable(task);
+    thread->localQueue.append(task);
+
+    // a waiting thread looks at the local queues after it became idle, see
+    // QThreadPoolThread::run(); so this must be read with the queue locked
+    const bool wakeUp = idleThreads.load() > 0;
+    locker.unlock();
+
+    if (wakeUp) {
+        QMutexLocker poolLocker(&mutex);
+        if (!waitingThreads.isEmpty())
+            wakeOneWaitingThread();
+    }
+    return true;
+}
+
+/*!
+    \internal
+    Takes the oldest runnable queued locally on a thread other than \a thief.
+    Must be called with the pool mutex locked.
+*/
+QRunnable *QThreadPoolPrivate::stealTask(QThreadPoolThread *thief)
+{
+    foreach (QThreadPoolThread *thread, allThreads) {
+        if (thread == thief)
+            continue;
+        QMutexLocker locker(&thread->localMutex);
+        if (!thread->localQueue.isEmpty())
+            return thread->localQueue.takeFirst();
+    }
+    return 0;
+}
+
+/*
+    The reference count of an auto-deleting runnable is protected by the pool
+    mutex. With work stealing, runnables are queued and completed without it,
+    so a mutex picked by the runnable's address is used instead.
+*/
+void QThreadPoolPrivate::refRunnable(QRunnable *runnable)
+{
+    if (workStealing) {
+        QMutexLocker locker(refMutexes.get(runnable));
+        ++runnable->ref;
+    } else {
+        ++runnable->ref;
+    }
+}
+
+// Returns \c true if the runnable has to be deleted
+bool QThreadPoolPrivate::derefRunnable(QRunnable *runnable)
+{
+    if (workStealing) {
+        QMutexLocker locker(refMutexes.get(runnable));
+        return !--runnable->ref;
+    }
+    return !--runnable->ref;
+}
+
 /*!
     \class QThreadPool
     \inmodule QtCore
@@ -453,12 +637,15 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->enqueueLocalTask(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
 
         if (!d->waitingThreads.isEmpty())
-            d->waitingThreads.takeFirst()->runnableReady.wakeOne();
+            d->wakeOneWaitingThread();
     }
 }
 
@@ -567,6 +754,52 @@ int QThreadPool::activeThreadCount() const
     return d->activeThreadCount();
 }
 
+/*! \property QThreadPool::workStealingEnabled
+    \since 5.4
+
+    This property holds whether runnables started from the pool's own threads
+    are queued on the starting thread.
+
+    By default, every runnable passed to start() goes through a single queue
+    shared by all threads of the pool. When work stealing is enabled, a
+    runnable that is started with the default priority from within one of the
+    pool's threads is instead queued on that thread, which runs it once the
+    current runnable returns. Threads that run out of work take runnables from
+    the other threads' queues. This avoids contention on the shared queue when
+    runnables start many small runnables of their own, at the cost of ignoring
+    the order in which they were started.
+
+    Runnables started from other threads, or with a priority other than 0, are
+    queued and prioritized as before.
+
+    This property can only be changed while the pool is not running any
+    runnables. The default is \c false.
+
+    \sa start()
+*/
+
+bool QThreadPool::workStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    return d->workStealing;
+}
+
+void QThreadPool::setWorkStealingEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+
+    if (enabled == d->workStealing)
+        return;
+
+    if (d->activeThreads > 0 || !d->queue.isEmpty()) {
+        qWarning("QThreadPool::setWorkStealingEnabled: cannot be changed while runnables are running");
+        return;
+    }
+    d->workStealing = enabled;
+}
+
 /*!
     Reserves one thread, disregarding activeThreadCount() and maxThreadCount().
 
@@ -58,7 +58,9 @@
 #include "QtCore/qwaitcondition.h"
 #include "QtCore/qset.h"
 #include "QtCore/qqueue.h"
+#include "QtCore/qatomic.h"
 #include "private/qobject_p.h"
+#include "private/qmutexpool_p.h"
 
 #ifndef QT_NO_THREAD
 
@@ -86,6 +88,12 @@ public:
     void clear();
     void stealRunnable(QRunnable *);
 
+    void wakeOneWaitingThread();
+    bool enqueueLocalTask(QRunnable *task);
+    QRunnable *stealTask(QThreadPoolThread *thief);
+    void refRunnable(QRunnable *runnable);
+    bool derefRunnable(QRunnable *runnable);
+
     mutable QMutex mutex;
     QSet<QThreadPoolThread *> allThreads;
     QQueue<QThreadPoolThread *> waitingThreads;
@@ -98,6 +106,12 @@ public:
     int maxThreadCount;
     int reservedThreads;
     int activeThreads;
+
+    bool workStealing;
+    // the size of waitingThreads, for threads that do not hold the mutex
+    QAtomicInt idleThreads;
+    // protects the reference counts of runnables when work stealing
+    QMutexPool refMutexes;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,773 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qhash.h>
+
+#include <string.h>
+
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+#include <initializer_list>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+template <class T> class QFlatSet;
+
+/*
+    The table is a single block: a header followed by the slots. Every slot
+    starts with the cached hash value of its item, 0 marking a free slot
+    whose node is not constructed, so a lookup usually touches a single
+    cache line. Collisions are resolved by linear probing, which wraps
+    around at the end of the 2^numBits buckets. The table grows when it is
+    three quarters full, so a probe always stops at a free bucket.
+
+    Iteration starts and ends at the origin, a bucket that is kept free,
+    so no run of colliding items crosses it and closing the gap of an
+    erased item only moves items to earlier positions. The slot after the
+    buckets is always free and marks the end.
+*/
+struct Q_CORE_EXPORT QFlatHashData
+{
+    QtPrivate::RefCount ref;
+    int size;
+    int numBits;
+    int numSlots;
+    int origin;
+    uint seed;
+    uint sharable : 1;
+    uint reserved : 31;
+    void *nodes;
+
+    static QFlatHashData *allocate(int numBits, int nodeSize, int nodeAlign, const QFlatHashData *other);
+    static void deallocate(QFlatHashData *d);
+    static int numBitsForSize(int size);
+
+    inline int bucket(uint h) const { return int((h * 0x9e3779b9U) >> (32 - numBits)); }
+    inline int nextBucket(int i) const { return (i + 1) & (numSlots - 2); }
+    inline int previousBucket(int i) const { return (i - 1) & (numSlots - 2); }
+    inline int capacity() const { return numBits ? (3 << numBits) / 4 : 0; }
+
+    static const QFlatHashData shared_null;
+};
+
+template <class Key, class T>
+struct QFlatHashNode
+{
+    uint h;
+    Key key;
+    T value;
+
+    inline QFlatHashNode(const Key &key0, const T &value0) : key(key0), value(value0) {}
+};
+
+template <class Key>
+struct QFlatHashNode<Key, QHashDummyValue>
+{
+    uint h;
+    Key key;
+    static QHashDummyValue value;
+
+    inline QFlatHashNode(const Key &key0, const QHashDummyValue &) : key(key0) {}
+};
+
+template <class Key>
+QHashDummyValue QFlatHashNode<Key, QHashDummyValue>::value;
+
+template <class Key, class T>
+class QFlatHash
+{
+    typedef QFlatHashNode<Key, T> Node;
+
+    QFlatHashData *d;
+
+    static inline Node *concrete(const QFlatHashData *d) { return static_cast<Node *>(d->nodes); }
+    static inline int alignOfNode() { return qMax<int>(sizeof(void*), Q_ALIGNOF(Node)); }
+    static inline bool isRelocatable() { return !QTypeInfo<Key>::isStatic && !QTypeInfo<T>::isStatic; }
+
+public:
+    inline QFlatHash() : d(const_cast<QFlatHashData *>(&QFlatHashData::shared_null)) { }
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+        : d(const_cast<QFlatHashData *>(&QFlatHashData::shared_null))
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<std::pair<Key,T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+#endif
+    inline QFlatHash(const QFlatHash<Key, T> &other) : d(other.d) { d->ref.ref(); if (!d->sharable) detach(); }
+    inline ~QFlatHash() { if (!d->ref.deref()) freeData(d); }
+
+    QFlatHash<Key, T> &operator=(const QFlatHash<Key, T> &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    inline QFlatHash(QFlatHash<Key, T> &&other) : d(other.d)
+    { other.d = const_cast<QFlatHashData *>(&QFlatHashData::shared_null); }
+    inline QFlatHash<Key, T> &operator=(QFlatHash<Key, T> &&other)
+    { qSwap(d, other.d); return *this; }
+#endif
+    inline void swap(QFlatHash<Key, T> &other) { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash<Key, T> &other) const;
+    inline bool operator!=(const QFlatHash<Key, T> &other) const { return !(*this == other); }
+
+    inline int size() const { return d->size; }
+
+    inline bool isEmpty() const { return d->size == 0; }
+
+    inline int capacity() const { return d->capacity(); }
+    void reserve(int size);
+    void squeeze();
+
+    inline void detach() { if (d->ref.isShared()) rehash(d->numBits ? d->numBits : QFlatHashData::numBitsForSize(0)); }
+    inline bool isDetached() const { return !d->ref.isShared(); }
+#if QT_SUPPORTS(UNSHARABLE_CONTAINERS)
+    inline void setSharable(bool sharable) { if (!sharable) detach(); if (d != &QFlatHashData::shared_null) d->sharable = sharable; }
+#endif
+    inline bool isSharedWith(const QFlatHash<Key, T> &other) const { return d == other.d; }
+
+    void clear();
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    bool contains(const Key &key) const;
+    const Key key(const T &value) const;
+    const Key key(const T &value, const Key &defaultKey) const;
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const;
+
+    QList<Key> keys() const;
+    QList<Key> keys(const T &value) const;
+    QList<T> values() const;
+    int count(const Key &key) const;
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class const_iterator;
+        friend class QFlatHash<Key, T>;
+        const QFlatHashData *d;
+        int i;
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        inline iterator() : d(0), i(0) { }
+        inline iterator(const QFlatHashData *data, int slot) : d(data), i(slot) { }
+
+        inline const Key &key() const { return concrete(d)[i].key; }
+        inline T &value() const { return concrete(d)[i].value; }
+        inline T &operator*() const { return concrete(d)[i].value; }
+        inline T *operator->() const { return &concrete(d)[i].value; }
+        inline bool operator==(const iterator &o) const { return i == o.i; }
+        inline bool operator!=(const iterator &o) const { return i != o.i; }
+
+        inline iterator &operator++() { i = nextSlot(d, i); return *this; }
+        inline iterator operator++(int) { iterator r = *this; ++*this; return r; }
+        inline iterator &operator--() { i = previousSlot(d, i); return *this; }
+        inline iterator operator--(int) { iterator r = *this; --*this; return r; }
+        inline iterator operator+(int j) const
+        { iterator r = *this; if (j > 0) while (j--) ++r; else while (j++) --r; return r; }
+        inline iterator operator-(int j) const { return operator+(-j); }
+        inline iterator &operator+=(int j) { return *this = *this + j; }
+        inline iterator &operator-=(int j) { return *this = *this - j; }
+
+#ifndef QT_STRICT_ITERATORS
+    public:
+        inline bool operator==(const const_iterator &o) const
+            { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const
+            { return i != o.i; }
+#endif
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class iterator;
+        friend class QFlatHash<Key, T>;
+        const QFlatHashData *d;
+        int i;
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() : d(0), i(0) { }
+        inline const_iterator(const QFlatHashData *data, int slot) : d(data), i(slot) { }
+#ifdef QT_STRICT_ITERATORS
+        explicit inline const_iterator(const iterator &o)
+#else
+        inline const_iterator(const iterator &o)
+#endif
+            : d(o.d), i(o.i) { }
+
+        inline const Key &key() const { return concrete(d)[i].key; }
+        inline const T &value() const { return concrete(d)[i].value; }
+        inline const T &operator*() const { return concrete(d)[i].value; }
+        inline const T *operator->() const { return &concrete(d)[i].value; }
+        inline bool operator==(const const_iterator &o) const { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return i != o.i; }
+
+        inline const_iterator &operator++() { i = nextSlot(d, i); return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++*this; return r; }
+        inline const_iterator &operator--() { i = previousSlot(d, i); return *this; }
+        inline const_iterator operator--(int) { const_iterator r = *this; --*this; return r; }
+        inline const_iterator operator+(int j) const
+        { const_iterator r = *this; if (j > 0) while (j--) ++r; else while (j++) --r; return r; }
+        inline const_iterator operator-(int j) const { return operator+(-j); }
+        inline const_iterator &operator+=(int j) { return *this = *this + j; }
+        inline const_iterator &operator-=(int j) { return *this = *this - j; }
+
+#ifdef QT_STRICT_ITERATORS
+    private:
+        inline bool operator==(const iterator &o) const { return operator==(const_iterator(o)); }
+        inline bool operator!=(const iterator &o) const { return operator!=(const_iterator(o)); }
+#endif
+    };
+    friend class const_iterator;
+
+    // STL style
+    inline iterator begin() { detach(); return iterator(d, firstSlot()); }
+    inline const_iterator begin() const { return const_iterator(d, firstSlot()); }
+    inline const_iterator cbegin() const { return const_iterator(d, firstSlot()); }
+    inline const_iterator constBegin() const { return const_iterator(d, firstSlot()); }
+    inline iterator end() { detach(); return iterator(d, d->numSlots - 1); }
+    inline const_iterator end() const { return const_iterator(d, d->numSlots - 1); }
+    inline const_iterator cend() const { return const_iterator(d, d->numSlots - 1); }
+    inline const_iterator constEnd() const { return const_iterator(d, d->numSlots - 1); }
+    iterator erase(iterator it);
+
+    // more Qt
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+    inline int count() const { return d->size; }
+    iterator find(const Key &key);
+    const_iterator find(const Key &key) const;
+    const_iterator constFind(const Key &key) const;
+    iterator insert(const Key &key, const T &value);
+    QFlatHash<Key, T> &unite(const QFlatHash<Key, T> &other);
+
+    // STL compatibility
+    typedef T mapped_type;
+    typedef Key key_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const { return isEmpty(); }
+
+private:
+    inline uint hashOf(const Key &key) const
+    { const uint h = qHash(key, d->seed); return h ? h : 1U; }
+    int findSlot(const Key &key, uint h) const;
+    int insertSlot(const Key &key, uint h, bool *found);
+    int firstSlot() const;
+    static int nextSlot(const QFlatHashData *d, int i);
+    static int previousSlot(const QFlatHashData *d, int i);
+    void rehash(int numBits);
+    void eraseSlot(int slot);
+    static void freeData(QFlatHashData *x);
+
+    bool isValidIterator(const iterator &it) const
+    { return it.d == d && it.i >= 0 && it.i < d->numSlots - 1 && concrete(d)[it.i].h; }
+    friend class QFlatSet<Key>;
+};
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::freeData(QFlatHashData *x)
+{
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+        Node *n = concrete(x);
+        for (int i = 0; i < x->numSlots; ++i) {
+            if (n[i].h)
+                n[i].~Node();
+        }
+    }
+    QFlatHashData::deallocate(x);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE QFlatHash<Key, T> &QFlatHash<Key, T>::operator=(const QFlatHash<Key, T> &other)
+{
+    if (d != other.d) {
+        QFlatHashData *o = other.d;
+        o->ref.ref();
+        if (!d->ref.deref())
+            freeData(d);
+        d = o;
+        if (!d->sharable)
+            rehash(d->numBits);
+    }
+    return *this;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::clear()
+{
+    *this = QFlatHash<Key, T>();
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::firstSlot() const
+{
+    return d->size ? nextSlot(d, d->origin) : d->numSlots - 1;
+}
+
+/*
+    Returns the slot of the item following slot i in iteration order, or
+    the end slot if there is none.
+*/
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::nextSlot(const QFlatHashData *d, int i)
+{
+    const Node *n = concrete(d);
+    do {
+        i = d->nextBucket(i);
+        if (i == d->origin)
+            return d->numSlots - 1;
+    } while (!n[i].h);
+    return i;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::previousSlot(const QFlatHashData *d, int i)
+{
+    const Node *n = concrete(d);
+    if (i == d->numSlots - 1)
+        i = d->origin;
+    do {
+        i = d->previousBucket(i);
+    } while (!n[i].h);
+    return i;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findSlot(const Key &akey, uint h) const
+{
+    if (d->size == 0)
+        return -1;
+    const Node *n = concrete(d);
+    for (int i = d->bucket(h); n[i].h; i = d->nextBucket(i)) {
+        if (n[i].h == h && n[i].key == akey)
+            return i;
+    }
+    return -1;
+}
+
+/*
+    Returns the slot holding akey, or else a free slot for it, in which case
+    found is set to false. Grows the table if it is full, and moves the
+    origin if the free slot is the origin. The table must be detached.
+*/
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::insertSlot(const Key &akey, uint h, bool *found)
+{
+    const Node *n = concrete(d);
+    int i = d->bucket(h);
+    for (; n[i].h; i = d->nextBucket(i)) {
+        if (n[i].h == h && n[i].key == akey) {
+            *found = true;
+            return i;
+        }
+    }
+    *found = false;
+    if (d->size >= d->capacity()) {
+        rehash(d->numBits + 1);
+        n = concrete(d);
+        i = d->bucket(h);
+        while (n[i].h)
+            i = d->nextBucket(i);
+    }
+
+    if (i == d->origin) {
+        int origin = d->nextBucket(i);
+        while (n[origin].h)
+            origin = d->nextBucket(origin);
+        d->origin = origin;
+    }
+    return i;
+}
+
+/*
+    Moves the items into a new table of at least 2^numBits buckets, or
+    copies them if the current table is shared. This detaches the hash.
+*/
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::rehash(int numBits)
+{
+    const bool shared = d->ref.isShared();
+    const bool move = !shared && isRelocatable();
+    const Node *from = concrete(d);
+    QFlatHashData *x = QFlatHashData::allocate(numBits, sizeof(Node), alignOfNode(), d);
+    x->sharable = shared || d->sharable;
+    Node *to = concrete(x);
+    for (int i = 0; i < d->numSlots; ++i) {
+        const uint h = from[i].h;
+        if (!h)
+            continue;
+        int j = x->bucket(h);
+        while (to[j].h)
+            j = x->nextBucket(j);
+        if (move) {
+            memcpy(static_cast<void *>(to + j), static_cast<const void *>(from + i), sizeof(Node));
+        } else {
+            QT_TRY {
+                new (to + j) Node(from[i]);
+            } QT_CATCH(...) {
+                to[j].h = 0;
+                freeData(x);
+                QT_RETHROW;
+            }
+        }
+    }
+    x->size = d->size;
+    while (to[x->origin].h)
+        ++x->origin;
+
+    if (move)
+        QFlatHashData::deallocate(d);
+    else if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+/*
+    Destroys the item in slot and closes the gap by shifting back the
+    items after it that were displaced past it. Items only ever move to
+    earlier positions in iteration order, so iterating while erasing
+    neither skips nor repeats one.
+*/
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::eraseSlot(int slot)
+{
+    Node *n = concrete(d);
+    const int mask = d->numSlots - 2;
+    n[slot].~Node();
+    int hole = slot;
+    for (int i = d->nextBucket(slot); n[i].h; i = d->nextBucket(i)) {
+        // leave the items whose bucket lies after the hole
+        if (((i - d->bucket(n[i].h)) & mask) < ((i - hole) & mask))
+            continue;
+        if (isRelocatable()) {
+            memcpy(static_cast<void *>(n + hole), static_cast<const void *>(n + i), sizeof(Node));
+        } else {
+            new (n + hole) Node(n[i]);
+            n[i].~Node();
+        }
+        hole = i;
+    }
+    n[hole].h = 0;
+    --d->size;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int asize)
+{
+    const int numBits = QFlatHashData::numBitsForSize(qMax(asize, d->size));
+    if (numBits > d->numBits)
+        rehash(numBits);
+    else
+        detach();
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::squeeze()
+{
+    if (d->size == 0) {
+        clear();
+        return;
+    }
+    const int numBits = QFlatHashData::numBitsForSize(d->size);
+    if (numBits < d->numBits)
+        rehash(numBits);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey) const
+{
+    const int i = findSlot(akey, hashOf(akey));
+    return i < 0 ? T() : concrete(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey, const T &adefaultValue) const
+{
+    const int i = findSlot(akey, hashOf(akey));
+    return i < 0 ? adefaultValue : concrete(d)[i].value;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    const_iterator i = begin();
+    while (i != end()) {
+        res.append(i.key());
+        ++i;
+    }
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys(const T &avalue) const
+{
+    QList<Key> res;
+    const_iterator i = begin();
+    while (i != end()) {
+        if (i.value() == avalue)
+            res.append(i.key());
+        ++i;
+    }
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue) const
+{
+    return key(avalue, Key());
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue, const Key &defaultValue) const
+{
+    const_iterator i = begin();
+    while (i != end()) {
+        if (i.value() == avalue)
+            return i.key();
+        ++i;
+    }
+    return defaultValue;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    const_iterator i = begin();
+    while (i != end()) {
+        res.append(i.value());
+        ++i;
+    }
+    return res;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::count(const Key &akey) const
+{
+    return findSlot(akey, hashOf(akey)) < 0 ? 0 : 1;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::operator[](const Key &akey) const
+{
+    return value(akey);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &akey)
+{
+    detach();
+
+    const uint h = hashOf(akey);
+    bool found;
+    const int i = insertSlot(akey, h, &found);
+    if (!found) {
+        new (concrete(d) + i) Node(akey, T());
+        concrete(d)[i].h = h;
+        ++d->size;
+    }
+    return concrete(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator
+QFlatHash<Key, T>::insert(const Key &akey, const T &avalue)
+{
+    detach();
+
+    const uint h = hashOf(akey);
+    bool found;
+    const int i = insertSlot(akey, h, &found);
+    if (!found) {
+        new (concrete(d) + i) Node(akey, avalue);
+        concrete(d)[i].h = h;
+        ++d->size;
+    } else if (!QTypeInfo<T>::isDummy) {
+        concrete(d)[i].value = avalue;
+    }
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE QFlatHash<Key, T> &QFlatHash<Key, T>::unite(const QFlatHash<Key, T> &other)
+{
+    if (d == other.d)
+        return *this;
+    if (isEmpty())
+        return *this = other;
+    QFlatHash<Key, T> copy(other);
+    reserve(size() + copy.size());
+    const_iterator it = copy.constBegin();
+    while (it != copy.constEnd()) {
+        insert(it.key(), it.value());
+        ++it;
+    }
+    return *this;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &akey)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return 0;
+    const uint h = hashOf(akey);
+    if (findSlot(akey, h) < 0)
+        return 0;
+    detach();
+    eraseSlot(findSlot(akey, h));
+    return 1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &akey)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return T();
+    const uint h = hashOf(akey);
+    if (findSlot(akey, h) < 0)
+        return T();
+    detach();
+    const int i = findSlot(akey, h);
+    T t = concrete(d)[i].value;
+    eraseSlot(i);
+    return t;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(iterator it)
+{
+    Q_ASSERT_X(isValidIterator(it) || it == iterator(d, d->numSlots - 1), "QFlatHash::erase",
+               "The specified iterator argument 'it' is invalid");
+
+    if (it == iterator(d, d->numSlots - 1))
+        return it;
+
+    if (d->ref.isShared()) {
+        const Key akey = it.key();
+        detach();
+        it = iterator(d, findSlot(akey, hashOf(akey)));
+    }
+
+    eraseSlot(it.i);
+    // an item shifted back into the erased slot has not been visited yet
+    if (!concrete(d)[it.i].h)
+        ++it;
+    return it;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::find(const Key &akey) const
+{
+    const int i = findSlot(akey, hashOf(akey));
+    return const_iterator(d, i < 0 ? d->numSlots - 1 : i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constFind(const Key &akey) const
+{
+    return find(akey);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &akey)
+{
+    detach();
+    const int i = findSlot(akey, hashOf(akey));
+    return iterator(d, i < 0 ? d->numSlots - 1 : i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE bool QFlatHash<Key, T>::contains(const Key &akey) const
+{
+    return findSlot(akey, hashOf(akey)) >= 0;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash<Key, T> &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+
+    const_iterator it = begin();
+    while (it != end()) {
+        const_iterator it2 = other.find(it.key());
+        if (it2 == other.end())
+            return false;
+        if (!QTypeInfo<T>::isDummy && !(it.value() == it2.value()))
+            return false;
+        ++it;
+    }
+    return true;
+}
+
+Q_DECLARE_ASSOCIATIVE_ITERATOR(FlatHash)
+Q_DECLARE_MUTABLE_ASSOCIATIVE_ITERATOR(FlatHash)
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_H
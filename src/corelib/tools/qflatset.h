@@ -0,0 +1,348 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATSET_H
+#define QFLATSET_H
+
+#include <QtCore/qflathash.h>
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+#include <initializer_list>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+
+template <class T>
+class QFlatSet
+{
+    typedef QFlatHash<T, QHashDummyValue> Hash;
+
+public:
+    inline QFlatSet() {}
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatSet(std::initializer_list<T> list)
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<T>::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(*it);
+    }
+#endif
+    inline QFlatSet(const QFlatSet<T> &other) : q_hash(other.q_hash) {}
+
+    inline QFlatSet<T> &operator=(const QFlatSet<T> &other)
+        { q_hash = other.q_hash; return *this; }
+#ifdef Q_COMPILER_RVALUE_REFS
+    inline QFlatSet(QFlatSet &&other) : q_hash(qMove(other.q_hash)) {}
+    inline QFlatSet<T> &operator=(QFlatSet<T> &&other)
+        { qSwap(q_hash, other.q_hash); return *this; }
+#endif
+    inline void swap(QFlatSet<T> &other) { q_hash.swap(other.q_hash); }
+
+    inline bool operator==(const QFlatSet<T> &other) const
+        { return q_hash == other.q_hash; }
+    inline bool operator!=(const QFlatSet<T> &other) const
+        { return q_hash != other.q_hash; }
+
+    inline int size() const { return q_hash.size(); }
+
+    inline bool isEmpty() const { return q_hash.isEmpty(); }
+
+    inline int capacity() const { return q_hash.capacity(); }
+    inline void reserve(int size) { q_hash.reserve(size); }
+    inline void squeeze() { q_hash.squeeze(); }
+
+    inline void detach() { q_hash.detach(); }
+    inline bool isDetached() const { return q_hash.isDetached(); }
+#if QT_SUPPORTS(UNSHARABLE_CONTAINERS)
+    inline void setSharable(bool sharable) { q_hash.setSharable(sharable); }
+#endif
+
+    inline void clear() { q_hash.clear(); }
+
+    inline bool remove(const T &value) { return q_hash.remove(value) != 0; }
+
+    inline bool contains(const T &value) const { return q_hash.contains(value); }
+
+    bool contains(const QFlatSet<T> &set) const;
+
+    class const_iterator;
+
+    class iterator
+    {
+        typedef QFlatHash<T, QHashDummyValue> Hash;
+        typename Hash::iterator i;
+        friend class const_iterator;
+        friend class QFlatSet<T>;
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline iterator() {}
+        inline iterator(typename Hash::iterator o) : i(o) {}
+        inline const T &operator*() const { return i.key(); }
+        inline const T *operator->() const { return &i.key(); }
+        inline bool operator==(const iterator &o) const { return i == o.i; }
+        inline bool operator!=(const iterator &o) const { return i != o.i; }
+        inline bool operator==(const const_iterator &o) const
+            { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const
+            { return i != o.i; }
+        inline iterator &operator++() { ++i; return *this; }
+        inline iterator operator++(int) { iterator r = *this; ++i; return r; }
+        inline iterator &operator--() { --i; return *this; }
+        inline iterator operator--(int) { iterator r = *this; --i; return r; }
+        inline iterator operator+(int j) const { return i + j; }
+        inline iterator operator-(int j) const { return i - j; }
+        inline iterator &operator+=(int j) { i += j; return *this; }
+        inline iterator &operator-=(int j) { i -= j; return *this; }
+    };
+
+    class const_iterator
+    {
+        typedef QFlatHash<T, QHashDummyValue> Hash;
+        typename Hash::const_iterator i;
+        friend class iterator;
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() {}
+        inline const_iterator(typename Hash::const_iterator o) : i(o) {}
+        inline const_iterator(const iterator &o)
+            : i(o.i) {}
+        inline const T &operator*() const { return i.key(); }
+        inline const T *operator->() const { return &i.key(); }
+        inline bool operator==(const const_iterator &o) const { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return i != o.i; }
+        inline const_iterator &operator++() { ++i; return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++i; return r; }
+        inline const_iterator &operator--() { --i; return *this; }
+        inline const_iterator operator--(int) { const_iterator r = *this; --i; return r; }
+        inline const_iterator operator+(int j) const { return i + j; }
+        inline const_iterator operator-(int j) const { return i - j; }
+        inline const_iterator &operator+=(int j) { i += j; return *this; }
+        inline const_iterator &operator-=(int j) { i -= j; return *this; }
+    };
+
+    // STL style
+    inline iterator begin() { return q_hash.begin(); }
+    inline const_iterator begin() const { return q_hash.begin(); }
+    inline const_iterator cbegin() const { return q_hash.begin(); }
+    inline const_iterator constBegin() const { return q_hash.constBegin(); }
+    inline iterator end() { return q_hash.end(); }
+    inline const_iterator end() const { return q_hash.end(); }
+    inline const_iterator cend() const { return q_hash.end(); }
+    inline const_iterator constEnd() const { return q_hash.constEnd(); }
+    iterator erase(iterator i)
+    {
+        Q_ASSERT_X(isValidIterator(i), "QFlatSet::erase", "The specified const_iterator argument 'i' is invalid");
+        return q_hash.erase(i.i);
+    }
+
+    // more Qt
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+    inline int count() const { return q_hash.count(); }
+    inline iterator insert(const T &value)
+        { return q_hash.insert(value, QHashDummyValue()); }
+    iterator find(const T &value) { return q_hash.find(value); }
+    const_iterator find(const T &value) const { return q_hash.find(value); }
+    inline const_iterator constFind(const T &value) const { return find(value); }
+    QFlatSet<T> &unite(const QFlatSet<T> &other);
+    QFlatSet<T> &intersect(const QFlatSet<T> &other);
+    QFlatSet<T> &subtract(const QFlatSet<T> &other);
+
+    // STL compatibility
+    typedef T key_type;
+    typedef T value_type;
+    typedef value_type *pointer;
+    typedef const value_type *const_pointer;
+    typedef value_type &reference;
+    typedef const value_type &const_reference;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const { return isEmpty(); }
+    // comfort
+    inline QFlatSet<T> &operator<<(const T &value) { insert(value); return *this; }
+    inline QFlatSet<T> &operator|=(const QFlatSet<T> &other) { unite(other); return *this; }
+    inline QFlatSet<T> &operator|=(const T &value) { insert(value); return *this; }
+    inline QFlatSet<T> &operator&=(const QFlatSet<T> &other) { intersect(other); return *this; }
+    inline QFlatSet<T> &operator&=(const T &value)
+        { QFlatSet<T> result; if (contains(value)) result.insert(value); return (*this = result); }
+    inline QFlatSet<T> &operator+=(const QFlatSet<T> &other) { unite(other); return *this; }
+    inline QFlatSet<T> &operator+=(const T &value) { insert(value); return *this; }
+    inline QFlatSet<T> &operator-=(const QFlatSet<T> &other) { subtract(other); return *this; }
+    inline QFlatSet<T> &operator-=(const T &value) { remove(value); return *this; }
+    inline QFlatSet<T> operator|(const QFlatSet<T> &other) const
+        { QFlatSet<T> result = *this; result |= other; return result; }
+    inline QFlatSet<T> operator&(const QFlatSet<T> &other) const
+        { QFlatSet<T> result = *this; result &= other; return result; }
+    inline QFlatSet<T> operator+(const QFlatSet<T> &other) const
+        { QFlatSet<T> result = *this; result += other; return result; }
+    inline QFlatSet<T> operator-(const QFlatSet<T> &other) const
+        { QFlatSet<T> result = *this; result -= other; return result; }
+
+    QList<T> toList() const;
+    inline QList<T> values() const { return toList(); }
+
+    static QFlatSet<T> fromList(const QList<T> &list);
+
+private:
+    Hash q_hash;
+    bool isValidIterator(const iterator &i) const
+    {
+        return q_hash.isValidIterator(i.i);
+    }
+};
+
+template <class T>
+Q_INLINE_TEMPLATE QFlatSet<T> &QFlatSet<T>::unite(const QFlatSet<T> &other)
+{
+    q_hash.unite(other.q_hash);
+    return *this;
+}
+
+template <class T>
+Q_INLINE_TEMPLATE QFlatSet<T> &QFlatSet<T>::intersect(const QFlatSet<T> &other)
+{
+    QFlatSet<T> copy(other);
+    iterator i = begin();
+    while (i != end()) {
+        if (copy.contains(*i))
+            ++i;
+        else
+            i = erase(i);
+    }
+    return *this;
+}
+
+template <class T>
+Q_INLINE_TEMPLATE QFlatSet<T> &QFlatSet<T>::subtract(const QFlatSet<T> &other)
+{
+    if (q_hash.isSharedWith(other.q_hash)) {
+        clear();
+        return *this;
+    }
+    typename QFlatSet<T>::const_iterator i = other.constBegin();
+    while (i != other.constEnd()) {
+        remove(*i);
+        ++i;
+    }
+    return *this;
+}
+
+template <class T>
+Q_INLINE_TEMPLATE bool QFlatSet<T>::contains(const QFlatSet<T> &other) const
+{
+    typename QFlatSet<T>::const_iterator i = other.constBegin();
+    while (i != other.constEnd()) {
+        if (!contains(*i))
+            return false;
+        ++i;
+    }
+    return true;
+}
+
+template <typename T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatSet<T>::toList() const
+{
+    return q_hash.keys();
+}
+
+template <typename T>
+Q_OUTOFLINE_TEMPLATE QFlatSet<T> QFlatSet<T>::fromList(const QList<T> &list)
+{
+    QFlatSet<T> result;
+    result.reserve(list.size());
+    for (int i = 0; i < list.size(); ++i)
+        result.insert(list.at(i));
+    return result;
+}
+
+Q_DECLARE_SEQUENTIAL_ITERATOR(FlatSet)
+
+template <typename T>
+class QMutableFlatSetIterator
+{
+    typedef typename QFlatSet<T>::iterator iterator;
+    QFlatSet<T> *c;
+    iterator i, n;
+    inline bool item_exists() const { return c->constEnd() != n; }
+
+public:
+    inline QMutableFlatSetIterator(QFlatSet<T> &container)
+        : c(&container)
+    { c->setSharable(false); i = c->begin(); n = c->end(); }
+    inline ~QMutableFlatSetIterator()
+    { c->setSharable(true); }
+    inline QMutableFlatSetIterator &operator=(QFlatSet<T> &container)
+    { c->setSharable(true); c = &container; c->setSharable(false);
+      i = c->begin(); n = c->end(); return *this; }
+    inline void toFront() { i = c->begin(); n = c->end(); }
+    inline void toBack() { i = c->end(); n = i; }
+    inline bool hasNext() const { return c->constEnd() != i; }
+    inline const T &next() { n = i++; return *n; }
+    inline const T &peekNext() const { return *i; }
+    inline bool hasPrevious() const { return c->constBegin() != i; }
+    inline const T &previous() { n = --i; return *n; }
+    inline const T &peekPrevious() const { iterator p = i; return *--p; }
+    inline void remove()
+    { if (c->constEnd() != n) { i = c->erase(n); n = c->end(); } }
+    inline const T &value() const { Q_ASSERT(item_exists()); return *n; }
+    inline bool findNext(const T &t)
+    { while (c->constEnd() != (n = i)) if (*i++ == t) return true; return false; }
+    inline bool findPrevious(const T &t)
+    { while (c->constBegin() != i) if (*(n = --i) == t) return true;
+      n = c->end(); return false;  }
+};
+
+QT_END_NAMESPACE
+
+#endif // QFLATSET_H
@@ -49,6 +49,8 @@
 #include <stdlib.h>
 
 #include "qhash.h"
+#include "qflathash.h"
+#include "qsmallstring.h"
 
 #ifdef truncate
 #undef truncate
@@ -191,6 +193,16 @@ uint qHash(const QStringRef &key, uint seed) Q_DECL_NOTHROW
     return hash(key.unicode(), key.size(), seed);
 }
 
+uint qHash(const QSmallString &key, uint seed) Q_DECL_NOTHROW
+{
+    return hash(key.unicode(), key.size(), seed);
+}
+
+uint qHash(const QSmallByteArray &key, uint seed) Q_DECL_NOTHROW
+{
+    return hash(reinterpret_cast<const uchar *>(key.constData()), key.size(), seed);
+}
+
 uint qHash(const QBitArray &bitArray, uint seed) Q_DECL_NOTHROW
 {
     int m = bitArray.d.size() - 1;
@@ -659,6 +671,71 @@ void QHashData::checkSanity()
 }
 #endif
 
+/*
+    A QFlatHash has at least pow(2, FlatMinNumBits) buckets, followed by
+    the free slot that marks the end.
+*/
+const int FlatMinNumBits = 3;
+
+// the shared null only has the free slot; just its hash value is ever read
+static const uint qt_flathash_free_slot[1] = { 0 };
+
+const QFlatHashData QFlatHashData::shared_null = {
+    Q_REFCOUNT_INITIALIZE_STATIC, 0, 0, 1, 0, 0, true, 0, const_cast<uint *>(qt_flathash_free_slot)
+};
+
+/*
+    Allocates an empty table of pow(2, numBits) buckets for nodes of
+    nodeSize bytes, which start with their hash value. The table uses the
+    seed of \a other, or the global QHash seed if \a other is the shared
+    null.
+*/
+QFlatHashData *QFlatHashData::allocate(int numBits, int nodeSize, int nodeAlign, const QFlatHashData *other)
+{
+    Q_ASSERT(numBits >= FlatMinNumBits && numBits <= 30);
+    const int numSlots = (1 << numBits) + 1;
+    const size_t nodesOffset = (sizeof(QFlatHashData) + nodeAlign - 1) & ~size_t(nodeAlign - 1);
+
+    char *block = static_cast<char *>(qMallocAligned(nodesOffset + size_t(numSlots) * nodeSize, nodeAlign));
+    Q_CHECK_PTR(block);
+    QFlatHashData *d = reinterpret_cast<QFlatHashData *>(block);
+    d->ref.initializeOwned();
+    d->size = 0;
+    d->numBits = numBits;
+    d->numSlots = numSlots;
+    d->origin = 0;
+    if (other == &shared_null) {
+        qt_initialize_qhash_seed();
+        d->seed = uint(qt_qhash_seed.load());
+    } else {
+        d->seed = other->seed;
+    }
+    d->sharable = true;
+    d->reserved = 0;
+    d->nodes = block + nodesOffset;
+    char *slot = block + nodesOffset;
+    for (int i = 0; i < numSlots; ++i, slot += nodeSize)
+        *reinterpret_cast<uint *>(slot) = 0;
+    return d;
+}
+
+void QFlatHashData::deallocate(QFlatHashData *d)
+{
+    qFreeAligned(d);
+}
+
+/*
+    Returns the number of bits of the smallest table that holds
+    \a size items without growing.
+*/
+int QFlatHashData::numBitsForSize(int size)
+{
+    int numBits = FlatMinNumBits;
+    while (((qint64(3) << numBits) / 4) < size)
+        ++numBits;
+    return numBits;
+}
+
 /*!
     \fn uint qHash(const QPair<T1, T2> &key, uint seed = 0)
     \since 5.0
@@ -813,6 +890,22 @@ uint qHash(long double key, uint seed) Q_DECL_NOTHROW
     Returns the hash value for the \a key, using \a seed to seed the calculation.
 */
 
+/*! \fn uint qHash(const QSmallString &key, uint seed = 0)
+    \relates QSmallString
+    \since 5.4
+
+    Returns the hash value for the \a key, using \a seed to seed the calculation.
+    The value is the same as for a QString holding the same characters.
+*/
+
+/*! \fn uint qHash(const QSmallByteArray &key, uint seed = 0)
+    \relates QSmallByteArray
+    \since 5.4
+
+    Returns the hash value for the \a key, using \a seed to seed the calculation.
+    The value is the same as for a QByteArray holding the same bytes.
+*/
+
 /*! \fn uint qHash(QLatin1String key, uint seed = 0)
     \relates QHash
     \since 5.0
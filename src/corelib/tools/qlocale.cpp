@@ -63,6 +63,9 @@
 #include "qstringbuilder.h"
 #include "private/qnumeric_p.h"
 #include "private/qsystemlibrary_p.h"
+
+#include <float.h>
+
 #ifdef Q_OS_WIN
 #   include <qt_windows.h>
 #   include <time.h>
@@ -2718,6 +2721,7 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
         precision = 6;
     if (width == -1)
         width = 0;
+    const bool shortest = precision == QLocale::FloatingPointShortest;
 
     bool negative = false;
     bool special_number = false; // nan, +/-inf
@@ -2740,11 +2744,13 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
 
 #ifdef QT_QLOCALE_USES_FCVT
         // NOT thread safe!
-        if (form == DFDecimal) {
+        if (form == DFDecimal && !shortest) {
             digits = QLatin1String(fcvt(d, precision, &decpt, &sign));
         } else {
             int pr = precision;
-            if (form == DFExponent)
+            if (shortest)
+                pr = DBL_DIG + 2; // enough to read back the same double
+            else if (form == DFExponent)
                 ++pr;
             else if (form == DFSignificantDigits && pr == 0)
                 pr = 1;
@@ -2763,7 +2769,9 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
 
 #else
         int mode;
-        if (form == DFDecimal)
+        if (shortest)
+            mode = 0;
+        else if (form == DFDecimal)
             mode = 3;
         else
             mode = 2;
@@ -2778,19 +2786,35 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
         if (form == DFExponent)
             ++pr;
 
-        char *rve = 0;
-        char *buff = 0;
-        QT_TRY {
-            digits = QLatin1String(qdtoa(d, mode, pr, &decpt, &sign, &rve, &buff));
-        } QT_CATCH(...) {
+        char fastBuff[FastDtoaMaxDigits];
+        int length;
+        if (qfastdtoa(d, mode, pr, fastBuff, &length, &decpt, &sign)) {
+            digits = QString::fromLatin1(fastBuff, length);
+        } else {
+            char *rve = 0;
+            char *buff = 0;
+            QT_TRY {
+                digits = QLatin1String(qdtoa(d, mode, pr, &decpt, &sign, &rve, &buff));
+            } QT_CATCH(...) {
+                if (buff != 0)
+                    free(buff);
+                QT_RETHROW;
+            }
             if (buff != 0)
                 free(buff);
-            QT_RETHROW;
         }
-        if (buff != 0)
-            free(buff);
 #endif // QT_QLOCALE_USES_FCVT
 
+        if (shortest) {
+            // Show exactly the digits we got
+            if (form == DFDecimal)
+                precision = qMax(digits.length() - decpt, 0);
+            else if (form == DFExponent)
+                precision = digits.length() - 1;
+            else
+                precision = digits.length();
+        }
+
         if (_zero.unicode() != '0') {
             ushort z = _zero.unicode() - '0';
             for (int i = 0; i < digits.length(); ++i)
@@ -2815,7 +2839,9 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
                 PrecisionMode mode = (flags & Alternate) ?
                             PMSignificantDigits : PMChopTrailingZeros;
 
-                if (decpt != digits.length() && (decpt <= -4 || decpt > precision))
+                // In the shortest form, switch to the exponent where %.17g would
+                int cutoff = shortest ? DBL_DIG + 2 : precision;
+                if (decpt != digits.length() && (decpt <= -4 || decpt > cutoff))
                     num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
                                            digits, decpt, precision, mode,
                                            always_show_decpt);
@@ -48,6 +48,7 @@
 #include <limits.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #ifdef Q_OS_WINCE
@@ -400,6 +401,561 @@ qlonglong qstrtoll(const char *nptr, const char **endptr, int base, bool *ok)
 
 #ifndef QT_QLOCALE_USES_FCVT
 
+/*
+    Fast double <-> decimal conversions.
+
+    qfastdtoa() implements Florian Loitsch's Grisu3 ("Printing Floating-Point
+    Numbers Quickly and Accurately with Integers", PLDI 2010) for the shortest
+    representation and its counted variant for a fixed number of digits.
+    fastStrtod() reads up to 19 significant digits into a 64-bit integer and
+    scales it with the same table of cached powers of ten. Both work on 64-bit
+    "do it yourself" floating point numbers, keep track of the error they
+    introduce and give up whenever it might change the result, in which case
+    the callers fall back to the exact Bigint code of qdtoa() and qstrtod().
+*/
+
+namespace {
+struct DiyFp
+{
+    quint64 f;
+    int e;
+};
+
+struct CachedPower
+{
+    quint64 significand;
+    short binaryExponent;
+    short decimalExponent;
+};
+}
+
+// 10^k for k = -348, -340, ..., 340, rounded to 64 significant bits
+static const CachedPower cachedPowers[] = {
+    { Q_UINT64_C(0xfa8fd5a0081c0288), -1220, -348 },
+    { Q_UINT64_C(0xbaaee17fa23ebf76), -1193, -340 },
+    { Q_UINT64_C(0x8b16fb203055ac76), -1166, -332 },
+    { Q_UINT64_C(0xcf42894a5dce35ea), -1140, -324 },
+    { Q_UINT64_C(0x9a6bb0aa55653b2d), -1113, -316 },
+    { Q_UINT64_C(0xe61acf033d1a45df), -1087, -308 },
+    { Q_UINT64_C(0xab70fe17c79ac6ca), -1060, -300 },
+    { Q_UINT64_C(0xff77b1fcbebcdc4f), -1034, -292 },
+    { Q_UINT64_C(0xbe5691ef416bd60c), -1007, -284 },
+    { Q_UINT64_C(0x8dd01fad907ffc3c),  -980, -276 },
+    { Q_UINT64_C(0xd3515c2831559a83),  -954, -268 },
+    { Q_UINT64_C(0x9d71ac8fada6c9b5),  -927, -260 },
+    { Q_UINT64_C(0xea9c227723ee8bcb),  -901, -252 },
+    { Q_UINT64_C(0xaecc49914078536d),  -874, -244 },
+    { Q_UINT64_C(0x823c12795db6ce57),  -847, -236 },
+    { Q_UINT64_C(0xc21094364dfb5637),  -821, -228 },
+    { Q_UINT64_C(0x9096ea6f3848984f),  -794, -220 },
+    { Q_UINT64_C(0xd77485cb25823ac7),  -768, -212 },
+    { Q_UINT64_C(0xa086cfcd97bf97f4),  -741, -204 },
+    { Q_UINT64_C(0xef340a98172aace5),  -715, -196 },
+    { Q_UINT64_C(0xb23867fb2a35b28e),  -688, -188 },
+    { Q_UINT64_C(0x84c8d4dfd2c63f3b),  -661, -180 },
+    { Q_UINT64_C(0xc5dd44271ad3cdba),  -635, -172 },
+    { Q_UINT64_C(0x936b9fcebb25c996),  -608, -164 },
+    { Q_UINT64_C(0xdbac6c247d62a584),  -582, -156 },
+    { Q_UINT64_C(0xa3ab66580d5fdaf6),  -555, -148 },
+    { Q_UINT64_C(0xf3e2f893dec3f126),  -529, -140 },
+    { Q_UINT64_C(0xb5b5ada8aaff80b8),  -502, -132 },
+    { Q_UINT64_C(0x87625f056c7c4a8b),  -475, -124 },
+    { Q_UINT64_C(0xc9bcff6034c13053),  -449, -116 },
+    { Q_UINT64_C(0x964e858c91ba2655),  -422, -108 },
+    { Q_UINT64_C(0xdff9772470297ebd),  -396, -100 },
+    { Q_UINT64_C(0xa6dfbd9fb8e5b88f),  -369,  -92 },
+    { Q_UINT64_C(0xf8a95fcf88747d94),  -343,  -84 },
+    { Q_UINT64_C(0xb94470938fa89bcf),  -316,  -76 },
+    { Q_UINT64_C(0x8a08f0f8bf0f156b),  -289,  -68 },
+    { Q_UINT64_C(0xcdb02555653131b6),  -263,  -60 },
+    { Q_UINT64_C(0x993fe2c6d07b7fac),  -236,  -52 },
+    { Q_UINT64_C(0xe45c10c42a2b3b06),  -210,  -44 },
+    { Q_UINT64_C(0xaa242499697392d3),  -183,  -36 },
+    { Q_UINT64_C(0xfd87b5f28300ca0e),  -157,  -28 },
+    { Q_UINT64_C(0xbce5086492111aeb),  -130,  -20 },
+    { Q_UINT64_C(0x8cbccc096f5088cc),  -103,  -12 },
+    { Q_UINT64_C(0xd1b71758e219652c),   -77,   -4 },
+    { Q_UINT64_C(0x9c40000000000000),   -50,    4 },
+    { Q_UINT64_C(0xe8d4a51000000000),   -24,   12 },
+    { Q_UINT64_C(0xad78ebc5ac620000),     3,   20 },
+    { Q_UINT64_C(0x813f3978f8940984),    30,   28 },
+    { Q_UINT64_C(0xc097ce7bc90715b3),    56,   36 },
+    { Q_UINT64_C(0x8f7e32ce7bea5c70),    83,   44 },
+    { Q_UINT64_C(0xd5d238a4abe98068),   109,   52 },
+    { Q_UINT64_C(0x9f4f2726179a2245),   136,   60 },
+    { Q_UINT64_C(0xed63a231d4c4fb27),   162,   68 },
+    { Q_UINT64_C(0xb0de65388cc8ada8),   189,   76 },
+    { Q_UINT64_C(0x83c7088e1aab65db),   216,   84 },
+    { Q_UINT64_C(0xc45d1df942711d9a),   242,   92 },
+    { Q_UINT64_C(0x924d692ca61be758),   269,  100 },
+    { Q_UINT64_C(0xda01ee641a708dea),   295,  108 },
+    { Q_UINT64_C(0xa26da3999aef774a),   322,  116 },
+    { Q_UINT64_C(0xf209787bb47d6b85),   348,  124 },
+    { Q_UINT64_C(0xb454e4a179dd1877),   375,  132 },
+    { Q_UINT64_C(0x865b86925b9bc5c2),   402,  140 },
+    { Q_UINT64_C(0xc83553c5c8965d3d),   428,  148 },
+    { Q_UINT64_C(0x952ab45cfa97a0b3),   455,  156 },
+    { Q_UINT64_C(0xde469fbd99a05fe3),   481,  164 },
+    { Q_UINT64_C(0xa59bc234db398c25),   508,  172 },
+    { Q_UINT64_C(0xf6c69a72a3989f5c),   534,  180 },
+    { Q_UINT64_C(0xb7dcbf5354e9bece),   561,  188 },
+    { Q_UINT64_C(0x88fcf317f22241e2),   588,  196 },
+    { Q_UINT64_C(0xcc20ce9bd35c78a5),   614,  204 },
+    { Q_UINT64_C(0x98165af37b2153df),   641,  212 },
+    { Q_UINT64_C(0xe2a0b5dc971f303a),   667,  220 },
+    { Q_UINT64_C(0xa8d9d1535ce3b396),   694,  228 },
+    { Q_UINT64_C(0xfb9b7cd9a4a7443c),   720,  236 },
+    { Q_UINT64_C(0xbb764c4ca7a44410),   747,  244 },
+    { Q_UINT64_C(0x8bab8eefb6409c1a),   774,  252 },
+    { Q_UINT64_C(0xd01fef10a657842c),   800,  260 },
+    { Q_UINT64_C(0x9b10a4e5e9913129),   827,  268 },
+    { Q_UINT64_C(0xe7109bfba19c0c9d),   853,  276 },
+    { Q_UINT64_C(0xac2820d9623bf429),   880,  284 },
+    { Q_UINT64_C(0x80444b5e7aa7cf85),   907,  292 },
+    { Q_UINT64_C(0xbf21e44003acdd2d),   933,  300 },
+    { Q_UINT64_C(0x8e679c2f5e44ff8f),   960,  308 },
+    { Q_UINT64_C(0xd433179d9c8cb841),   986,  316 },
+    { Q_UINT64_C(0x9e19db92b4e31ba9),  1013,  324 },
+    { Q_UINT64_C(0xeb96bf6ebadf77d9),  1039,  332 },
+    { Q_UINT64_C(0xaf87023b9bf0ee6b),  1066,  340 },
+};
+
+enum {
+    CachedPowersOffset = 348,          // -cachedPowers[0].decimalExponent
+    CachedPowersDecimalStep = 8,
+    CachedPowersMinDecimalExponent = -348,
+    CachedPowersMaxDecimalExponent = 340,
+
+    // Grisu scales the input into this binary exponent range so that the
+    // integral part of the result fits into 32 bits
+    GrisuMinTargetExponent = -60,
+    GrisuMaxTargetExponent = -32,
+
+    DoublePhysicalSignificandSize = 52,
+    DoubleSignificandSize = 53,
+    DoubleExponentBias = 0x3FF + DoublePhysicalSignificandSize,
+    DoubleDenormalExponent = 1 - DoubleExponentBias,
+    DoubleMaxExponent = 0x7FF - DoubleExponentBias,
+
+    MaxUint64DecimalDigits = 19
+};
+
+static const quint64 DoubleSignificandMask = Q_UINT64_C(0x000FFFFFFFFFFFFF);
+static const quint64 DoubleHiddenBit = Q_UINT64_C(0x0010000000000000);
+static const quint64 DoubleExponentMask = Q_UINT64_C(0x7FF0000000000000);
+
+static const quint32 smallPowersOfTen[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static inline DiyFp makeDiyFp(quint64 f, int e)
+{
+    DiyFp result;
+    result.f = f;
+    result.e = e;
+    return result;
+}
+
+static inline DiyFp normalized(DiyFp v)
+{
+    Q_ASSERT(v.f != 0);
+    while (!(v.f & Q_UINT64_C(0xFFC0000000000000))) {
+        v.f <<= 10;
+        v.e -= 10;
+    }
+    while (!(v.f & Q_UINT64_C(0x8000000000000000))) {
+        v.f <<= 1;
+        --v.e;
+    }
+    return v;
+}
+
+// Returns the upper 64 bits of the product, rounded
+static inline DiyFp multiplied(DiyFp x, DiyFp y)
+{
+    const quint64 M32 = 0xFFFFFFFFu;
+    const quint64 a = x.f >> 32;
+    const quint64 b = x.f & M32;
+    const quint64 c = y.f >> 32;
+    const quint64 d = y.f & M32;
+    const quint64 ac = a * c;
+    const quint64 bc = b * c;
+    const quint64 ad = a * d;
+    const quint64 bd = b * d;
+    quint64 tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+    tmp += Q_UINT64_C(1) << 31;
+    return makeDiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+}
+
+static inline quint64 doubleToBits(double d)
+{
+    quint64 bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+static inline double bitsToDouble(quint64 bits)
+{
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+// Splits the finite, positive d into significand and exponent, without normalizing
+static inline DiyFp doubleToDiyFp(double d)
+{
+    const quint64 bits = doubleToBits(d);
+    const int biasedExponent = int((bits & DoubleExponentMask) >> DoublePhysicalSignificandSize);
+    if (biasedExponent == 0)
+        return makeDiyFp(bits & DoubleSignificandMask, DoubleDenormalExponent);
+    return makeDiyFp((bits & DoubleSignificandMask) | DoubleHiddenBit,
+                     biasedExponent - DoubleExponentBias);
+}
+
+// Returns a cached power of ten c = 10^k such that the binary exponent of
+// the product of c and a normalized DiyFp with exponent e lies within the
+// Grisu target range
+static inline DiyFp cachedPowerForBinaryExponent(int e, int *decimalExponent)
+{
+    const int minExponent = GrisuMinTargetExponent - (e + 64);
+    const int k = int(ceil((minExponent + 63) * 0.30102999566398114)); // log10(2)
+    const int index = (CachedPowersOffset + k - 1) / CachedPowersDecimalStep + 1;
+    const CachedPower &power = cachedPowers[index];
+    Q_ASSERT(minExponent <= power.binaryExponent
+             && power.binaryExponent <= GrisuMaxTargetExponent - (e + 64));
+    *decimalExponent = power.decimalExponent;
+    return makeDiyFp(power.significand, power.binaryExponent);
+}
+
+// Returns the number of decimal digits of number, and the largest power of
+// ten not greater than it in power
+static inline int biggestPowerTen(quint32 number, quint32 *power)
+{
+    int exponent = 9;
+    while (exponent > 0 && number < smallPowersOfTen[exponent])
+        --exponent;
+    *power = smallPowersOfTen[exponent];
+    return exponent + 1;
+}
+
+/*
+    Moves the last digit of buffer towards w if that keeps it inside the safe
+    interval, and checks that the result is unambiguously the closest shortest
+    representation. All distances are in units of the scaled input, which is
+    off by at most unit.
+*/
+static bool grisuRoundWeed(char *buffer, int length, quint64 distanceTooHighW,
+                           quint64 unsafeInterval, quint64 rest, quint64 tenKappa,
+                           quint64 unit)
+{
+    const quint64 smallDistance = distanceTooHighW - unit;
+    const quint64 bigDistance = distanceTooHighW + unit;
+    while (rest < smallDistance
+           && unsafeInterval - rest >= tenKappa
+           && (rest + tenKappa < smallDistance
+               || smallDistance - rest >= rest + tenKappa - smallDistance)) {
+        --buffer[length - 1];
+        rest += tenKappa;
+    }
+
+    // If we could have moved one step further for some value within the
+    // error bounds of w, we can't tell which representation is the closest
+    if (rest < bigDistance
+        && unsafeInterval - rest >= tenKappa
+        && (rest + tenKappa < bigDistance
+            || bigDistance - rest > rest + tenKappa - bigDistance)) {
+        return false;
+    }
+
+    return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+static bool grisuDigitGen(DiyFp low, DiyFp w, DiyFp high, char *buffer, int *length, int *kappa)
+{
+    Q_ASSERT(low.e == w.e && w.e == high.e);
+    Q_ASSERT(w.e >= GrisuMinTargetExponent && w.e <= GrisuMaxTargetExponent);
+
+    // low, w and high are imprecise by one unit; generate digits for the
+    // widened interval and let grisuRoundWeed() reject unsafe results
+    quint64 unit = 1;
+    const DiyFp tooHigh = makeDiyFp(high.f + unit, high.e);
+    quint64 unsafeInterval = tooHigh.f - (low.f - unit);
+    const int shift = -w.e;
+    const quint64 one = Q_UINT64_C(1) << shift;
+    quint32 integrals = quint32(tooHigh.f >> shift);
+    quint64 fractionals = tooHigh.f & (one - 1);
+    quint32 divisor;
+    *kappa = biggestPowerTen(integrals, &divisor);
+    *length = 0;
+
+    while (*kappa > 0) {
+        buffer[(*length)++] = char('0' + integrals / divisor);
+        integrals %= divisor;
+        --*kappa;
+        const quint64 rest = (quint64(integrals) << shift) + fractionals;
+        if (rest < unsafeInterval) {
+            return grisuRoundWeed(buffer, *length, tooHigh.f - w.f, unsafeInterval, rest,
+                                  quint64(divisor) << shift, unit);
+        }
+        divisor /= 10;
+    }
+
+    for (;;) {
+        fractionals *= 10;
+        unit *= 10;
+        unsafeInterval *= 10;
+        buffer[(*length)++] = char('0' + (fractionals >> shift));
+        fractionals &= one - 1;
+        --*kappa;
+        if (fractionals < unsafeInterval) {
+            return grisuRoundWeed(buffer, *length, (tooHigh.f - w.f) * unit, unsafeInterval,
+                                  fractionals, one, unit);
+        }
+    }
+}
+
+// Writes the shortest digits that read back as v; v * 10^-decimalExponent is the buffer
+static bool grisuShortest(double v, char *buffer, int *length, int *decimalExponent)
+{
+    const DiyFp raw = doubleToDiyFp(v);
+    const DiyFp w = normalized(raw);
+
+    // The boundaries are half way between v and its neighbours
+    const DiyFp plus = normalized(makeDiyFp((raw.f << 1) + 1, raw.e - 1));
+    DiyFp minus;
+    if (raw.f == DoubleHiddenBit && raw.e != DoubleDenormalExponent)
+        minus = makeDiyFp((raw.f << 2) - 1, raw.e - 2); // the lower neighbour is closer
+    else
+        minus = makeDiyFp((raw.f << 1) - 1, raw.e - 1);
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    int mk;
+    const DiyFp tenMk = cachedPowerForBinaryExponent(w.e, &mk);
+    int kappa;
+    const bool result = grisuDigitGen(multiplied(minus, tenMk), multiplied(w, tenMk),
+                                      multiplied(plus, tenMk), buffer, length, &kappa);
+    *decimalExponent = kappa - mk;
+    return result;
+}
+
+static bool grisuRoundWeedCounted(char *buffer, int length, quint64 rest, quint64 tenKappa,
+                                  quint64 unit, int *kappa)
+{
+    Q_ASSERT(rest < tenKappa);
+    if (unit >= tenKappa || tenKappa - unit <= unit)
+        return false;
+
+    // Round down if even the largest value within the error bounds would
+    if (tenKappa - rest > rest && tenKappa - 2 * rest >= 2 * unit)
+        return true;
+
+    // Round up if even the smallest value within the error bounds would
+    if (rest > unit && tenKappa - (rest - unit) <= rest - unit) {
+        ++buffer[length - 1];
+        for (int i = length - 1; i > 0 && buffer[i] == '0' + 10; --i) {
+            buffer[i] = '0';
+            ++buffer[i - 1];
+        }
+        if (buffer[0] == '0' + 10) {
+            buffer[0] = '1';
+            ++*kappa;
+        }
+        return true;
+    }
+    return false;
+}
+
+/*
+    Writes v rounded to requestedDigits significant digits, or if fixed is true,
+    to requestedDigits digits after the decimal point. Trailing zeros are kept.
+*/
+static bool grisuCounted(double v, int requestedDigits, bool fixed, char *buffer, int *length,
+                         int *decimalExponent)
+{
+    const DiyFp w = normalized(doubleToDiyFp(v));
+    int mk;
+    const DiyFp tenMk = cachedPowerForBinaryExponent(w.e, &mk);
+    const DiyFp scaled = multiplied(w, tenMk);
+
+    // scaled is off by less than one unit
+    quint64 unit = 1;
+    const int shift = -scaled.e;
+    const quint64 one = Q_UINT64_C(1) << shift;
+    quint32 integrals = quint32(scaled.f >> shift);
+    quint64 fractionals = scaled.f & (one - 1);
+    quint32 divisor;
+    int kappa = biggestPowerTen(integrals, &divisor);
+    if (fixed)
+        requestedDigits += kappa - mk;
+    if (requestedDigits <= 0 || requestedDigits > FastDtoaMaxDigits)
+        return false;
+    *length = 0;
+
+    while (kappa > 0) {
+        buffer[(*length)++] = char('0' + integrals / divisor);
+        integrals %= divisor;
+        --kappa;
+        if (--requestedDigits == 0)
+            break;
+        divisor /= 10;
+    }
+
+    bool result;
+    if (requestedDigits == 0) {
+        const quint64 rest = (quint64(integrals) << shift) + fractionals;
+        result = grisuRoundWeedCounted(buffer, *length, rest, quint64(divisor) << shift, unit,
+                                       &kappa);
+    } else {
+        while (requestedDigits > 0 && fractionals > unit) {
+            fractionals *= 10;
+            unit *= 10;
+            buffer[(*length)++] = char('0' + (fractionals >> shift));
+            fractionals &= one - 1;
+            --kappa;
+            --requestedDigits;
+        }
+        result = requestedDigits == 0
+                 && grisuRoundWeedCounted(buffer, *length, fractionals, one, unit, &kappa);
+    }
+    *decimalExponent = kappa - mk;
+    return result;
+}
+
+/*
+    Converts the finite double d into decimal digits like qdtoa() does for the
+    given mode (0, 2 or 3) and ndigits, without trailing zeros. buf must have
+    room for FastDtoaMaxDigits characters; it is not null-terminated. Returns
+    false if the digits could not be determined with integer arithmetic, in
+    which case the caller has to use qdtoa().
+*/
+bool qfastdtoa(double d, int mode, int ndigits, char *buf, int *length, int *decpt, int *sign)
+{
+    quint64 bits = doubleToBits(d);
+    if ((bits & DoubleExponentMask) == DoubleExponentMask)
+        return false; // inf or nan
+    *sign = int(bits >> 63);
+    bits &= ~(Q_UINT64_C(1) << 63);
+    if (bits == 0) {
+        buf[0] = '0';
+        *length = 1;
+        *decpt = 1;
+        return true;
+    }
+    d = bitsToDouble(bits);
+
+    int decimalExponent;
+    bool ok;
+    switch (mode) {
+    case 0:
+        ok = grisuShortest(d, buf, length, &decimalExponent);
+        break;
+    case 2:
+        ok = grisuCounted(d, qMax(ndigits, 1), false, buf, length, &decimalExponent);
+        break;
+    case 3:
+        ok = grisuCounted(d, ndigits, true, buf, length, &decimalExponent);
+        break;
+    default:
+        ok = false;
+        break;
+    }
+    if (!ok)
+        return false;
+
+    *decpt = *length + decimalExponent;
+    while (*length > 1 && buf[*length - 1] == '0')
+        --*length;
+    return true;
+}
+
+/*
+    Computes the double closest to the integer made of totalDigits digits
+    starting at digits, times 10^exponent. A decimal point follows the first
+    integerDigits digits if there are more digits than that. Returns false if
+    the result is not a normal double or if it may be off by one ulp.
+*/
+static bool fastStrtod(const char *digits, int integerDigits, int totalDigits, int exponent,
+                       double *result)
+{
+    // Errors are kept in eighths of a unit of the last place of the DiyFp
+    const int DenominatorLog = 3;
+    const quint64 Denominator = 1 << DenominatorLog;
+
+    const int readDigits = qMin(totalDigits, int(MaxUint64DecimalDigits));
+    const char *p = digits;
+    quint64 significand = 0;
+    for (int i = 0; i < readDigits; ++i) {
+        if (i == integerDigits)
+            ++p; // skip the decimal point
+        significand = significand * 10 + (*p++ - '0');
+    }
+    quint64 error = 0;
+    if (readDigits < totalDigits) {
+        if (readDigits == integerDigits)
+            ++p;
+        if (*p >= '5')
+            ++significand;
+        exponent += totalDigits - readDigits;
+        error = Denominator / 2;
+    }
+
+    if (significand == 0
+        || exponent < CachedPowersMinDecimalExponent
+        || exponent > CachedPowersMaxDecimalExponent) {
+        return false;
+    }
+
+    DiyFp input = normalized(makeDiyFp(significand, 0));
+    error <<= -input.e;
+
+    const int index = (exponent + CachedPowersOffset) / CachedPowersDecimalStep;
+    const CachedPower &power = cachedPowers[index];
+    const int adjustment = exponent - power.decimalExponent;
+    if (adjustment) {
+        // The powers of ten up to 10^7 are exact, so this only adds rounding error
+        input = multiplied(input, normalized(makeDiyFp(smallPowersOfTen[adjustment], 0)));
+        error += Denominator / 2;
+    }
+    input = multiplied(input, makeDiyFp(power.significand, power.binaryExponent));
+
+    // The cached power is off by half a unit and the product is rounded
+    error += Denominator / 2 + (error ? 1 : 0) + Denominator / 2;
+    const int oldExponent = input.e;
+    input = normalized(input);
+    error <<= oldExponent - input.e;
+
+    // Denormals have fewer significant bits and are rare enough to leave to qstrtod()
+    if (64 + input.e < DoubleDenormalExponent + DoubleSignificandSize)
+        return false;
+
+    const int precisionBitsCount = 64 - DoubleSignificandSize;
+    const quint64 precisionBits = (input.f & ((Q_UINT64_C(1) << precisionBitsCount) - 1))
+                                  * Denominator;
+    const quint64 halfWay = (Q_UINT64_C(1) << (precisionBitsCount - 1)) * Denominator;
+    if (halfWay - error < precisionBits && precisionBits < halfWay + error)
+        return false; // too close to call
+
+    quint64 f = input.f >> precisionBitsCount;
+    int e = input.e + precisionBitsCount;
+    if (precisionBits >= halfWay + error)
+        ++f;
+    if (f > (DoubleHiddenBit | DoubleSignificandMask)) {
+        f >>= 1;
+        ++e;
+    }
+    if (e >= DoubleMaxExponent)
+        return false; // overflow, let qstrtod() report it
+
+    *result = bitsToDouble((f & DoubleSignificandMask)
+                           | (quint64(e + DoubleExponentBias) << DoublePhysicalSignificandSize));
+    return true;
+}
+
+#endif // QT_QLOCALE_USES_FCVT
+
+#ifndef QT_QLOCALE_USES_FCVT
+
 /*        From: NetBSD: strtod.c,v 1.26 1998/02/03 18:44:21 perry Exp */
 /* $FreeBSD: src/lib/libc/stdlib/netbsd_strtod.c,v 1.2.2.2 2001/03/02 17:14:15 tegge Exp $        */
 
@@ -1634,6 +2190,9 @@ Q_CORE_EXPORT double qstrtod(const char *s00, const char **se, bool *ok)
         }
 #endif
     }
+    if (fastStrtod(s0, nd0, nd, e, &rv))
+        goto ret;
+
     e1 += nd - k;
 
     /* Get starting approximation = rv * 10**e1 */
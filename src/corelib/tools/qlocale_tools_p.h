@@ -106,6 +106,10 @@ inline bool isZero(double d)
 
 Q_CORE_EXPORT char *qdtoa(double d, int mode, int ndigits, int *decpt,
                           int *sign, char **rve, char **digits_str);
+#ifndef QT_QLOCALE_USES_FCVT
+enum { FastDtoaMaxDigits = 17 };
+bool qfastdtoa(double d, int mode, int ndigits, char *buf, int *length, int *decpt, int *sign);
+#endif
 Q_CORE_EXPORT double qstrtod(const char *s00, char const **se, bool *ok);
 qlonglong qstrtoll(const char *nptr, const char **endptr, int base, bool *ok);
 qulonglong qstrtoull(const char *nptr, const char **endptr, int base, bool *ok);
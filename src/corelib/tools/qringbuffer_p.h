@@ -120,6 +120,25 @@ public:
         return buffers[tailBuffer].constData() + pos;
     }
 
+    // the first blocks of data, at most maxCount of them and maxLength
+    // bytes in total, for writing them with a single gathering call;
+    // returns the number of blocks
+    inline int readPointers(const char **pointers, qint64 *lengths, int maxCount,
+                            qint64 maxLength) const {
+        int count = 0;
+        for (int i = 0; count < maxCount && maxLength > 0 && i <= tailBuffer; ++i) {
+            const int start = (i == 0) ? head : 0;
+            const int end = (i == tailBuffer) ? tail : buffers.at(i).size();
+            if (end <= start)
+                continue;
+            pointers[count] = buffers.at(i).constData() + start;
+            lengths[count] = qMin<qint64>(end - start, maxLength);
+            maxLength -= lengths[count];
+            ++count;
+        }
+        return count;
+    }
+
     inline void free(int bytes) {
         bufferSize -= bytes;
         if (bufferSize < 0)
@@ -0,0 +1,349 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSMALLSTRING_H
+#define QSMALLSTRING_H
+
+#include <QtCore/qstring.h>
+#include <QtCore/qbytearray.h>
+
+#include <new>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+inline const ushort *smallStringData(const QString &str)
+{ return reinterpret_cast<const ushort *>(str.constData()); }
+inline const char *smallStringData(const QByteArray &ba)
+{ return ba.constData(); }
+inline QString smallStringToLong(const ushort *data, int size)
+{ return QString(reinterpret_cast<const QChar *>(data), size); }
+inline QByteArray smallStringToLong(const char *data, int size)
+{ return QByteArray(data, size); }
+
+/*
+    A fixed 24-byte block shared by QSmallString and QSmallByteArray. Its
+    last byte is a tag: for an inline payload it holds the unused capacity,
+    so a full buffer ends in zero and the tag doubles as the terminator.
+    A tag of LongTag means the block holds a String instead, placement
+    constructed at its start, and the payload stays implicitly shared.
+
+    String must be relocatable, so copying the raw bytes moves it.
+*/
+template <typename Char, typename String>
+class QSmallStringStorage
+{
+public:
+    enum {
+        StorageSize = 24,
+        InlineCapacity = StorageSize / sizeof(Char) - 1
+    };
+
+    inline QSmallStringStorage() { setInline(0, 0); }
+    inline QSmallStringStorage(const Char *data, int size)
+    {
+        if (size <= InlineCapacity)
+            setInline(data, size);
+        else
+            setLong(smallStringToLong(data, size));
+    }
+    inline QSmallStringStorage(const String &str)
+    {
+        if (str.size() <= InlineCapacity)
+            setInline(smallStringData(str), str.size());
+        else
+            setLong(str);
+    }
+    inline QSmallStringStorage(const QSmallStringStorage &other)
+    {
+        if (other.isLong())
+            setLong(other.longString());
+        else
+            u = other.u;
+    }
+#ifdef Q_COMPILER_RVALUE_REFS
+    inline QSmallStringStorage(QSmallStringStorage &&other)
+    {
+        u = other.u;
+        other.setInline(0, 0);
+    }
+    inline QSmallStringStorage &operator=(QSmallStringStorage &&other)
+    { swap(other); return *this; }
+#endif
+    inline ~QSmallStringStorage()
+    {
+        if (isLong())
+            reinterpret_cast<String *>(&u)->~String();
+    }
+
+    inline QSmallStringStorage &operator=(const QSmallStringStorage &other)
+    {
+        QSmallStringStorage copy(other);
+        swap(copy);
+        return *this;
+    }
+    inline void swap(QSmallStringStorage &other) { qSwap(u, other.u); }
+
+    inline bool isLong() const { return tag() == LongTag; }
+    inline int size() const
+    { return isLong() ? longString().size() : InlineCapacity - tag(); }
+    inline const Char *data() const
+    { return isLong() ? smallStringData(longString()) : u.chars; }
+    inline String toLong() const
+    { return isLong() ? longString() : smallStringToLong(u.chars, InlineCapacity - tag()); }
+
+    inline bool equals(const Char *other, int otherSize) const
+    {
+        return size() == otherSize
+                && (!otherSize || ::memcmp(data(), other, otherSize * sizeof(Char)) == 0);
+    }
+    inline int compare(const Char *other, int otherSize) const
+    {
+        typedef typename QIntegerForSizeof<Char>::Unsigned Unsigned;
+        const Char *p = data();
+        const int n = size();
+        const int len = qMin(n, otherSize);
+        for (int i = 0; i < len; ++i) {
+            if (p[i] != other[i])
+                return int(Unsigned(p[i])) - int(Unsigned(other[i]));
+        }
+        return n - otherSize;
+    }
+
+private:
+    enum { LongTag = 0xff };
+
+    inline uchar tag() const { return u.bytes[StorageSize - 1]; }
+    inline const String &longString() const
+    { return *reinterpret_cast<const String *>(&u); }
+
+    inline void setInline(const Char *data, int size)
+    {
+        Q_ASSERT(size >= 0 && size <= InlineCapacity);
+        if (size)
+            ::memcpy(u.chars, data, size * sizeof(Char));
+        u.chars[InlineCapacity] = 0;
+        u.chars[size] = 0;
+        u.bytes[StorageSize - 1] = uchar(InlineCapacity - size);
+    }
+    inline void setLong(const String &str)
+    {
+        new (&u) String(str);
+        u.bytes[StorageSize - 1] = LongTag;
+    }
+
+    union Data {
+        Char chars[StorageSize / sizeof(Char)];
+        uchar bytes[StorageSize];
+        void *align;
+    };
+    Data u;
+};
+
+} // namespace QtPrivate
+
+class QSmallString
+{
+    typedef QtPrivate::QSmallStringStorage<ushort, QString> Storage;
+public:
+    enum { InlineCapacity = Storage::InlineCapacity };
+
+    typedef const QChar *const_iterator;
+    typedef const_iterator ConstIterator;
+
+    inline QSmallString() {}
+    inline QSmallString(const QString &str) : d(str) {}
+    inline QSmallString(const QChar *unicode, int size)
+        : d(reinterpret_cast<const ushort *>(unicode), size) {}
+    inline explicit QSmallString(QLatin1String str);
+
+    inline QSmallString &operator=(const QString &str)
+    { Storage(str).swap(d); return *this; }
+
+    inline void swap(QSmallString &other) { d.swap(other.d); }
+
+    inline int size() const { return d.size(); }
+    inline int length() const { return d.size(); }
+    inline bool isEmpty() const { return d.size() == 0; }
+    inline bool isInline() const { return !d.isLong(); }
+    inline void clear() { Storage().swap(d); }
+
+    inline const QChar *unicode() const { return reinterpret_cast<const QChar *>(d.data()); }
+    inline const QChar *constData() const { return unicode(); }
+    inline const ushort *utf16() const { return d.data(); }
+    inline const QChar at(int i) const
+    { Q_ASSERT(uint(i) < uint(size())); return unicode()[i]; }
+    inline const QChar operator[](int i) const { return at(i); }
+
+    inline const_iterator begin() const { return unicode(); }
+    inline const_iterator cbegin() const { return unicode(); }
+    inline const_iterator constBegin() const { return unicode(); }
+    inline const_iterator end() const { return unicode() + size(); }
+    inline const_iterator cend() const { return end(); }
+    inline const_iterator constEnd() const { return end(); }
+
+    inline QString toString() const { return d.toLong(); }
+
+    inline bool operator==(const QSmallString &other) const
+    { return d.equals(other.d.data(), other.d.size()); }
+    inline bool operator!=(const QSmallString &other) const { return !operator==(other); }
+    inline bool operator<(const QSmallString &other) const
+    { return d.compare(other.d.data(), other.d.size()) < 0; }
+    inline bool operator>(const QSmallString &other) const { return other < *this; }
+    inline bool operator<=(const QSmallString &other) const { return !(other < *this); }
+    inline bool operator>=(const QSmallString &other) const { return !(*this < other); }
+
+    inline bool operator==(const QString &other) const
+    { return d.equals(reinterpret_cast<const ushort *>(other.constData()), other.size()); }
+    inline bool operator!=(const QString &other) const { return !operator==(other); }
+    inline bool operator==(QLatin1String other) const;
+    inline bool operator!=(QLatin1String other) const { return !operator==(other); }
+
+private:
+    Storage d;
+};
+
+Q_DECLARE_SHARED(QSmallString)
+
+inline QSmallString::QSmallString(QLatin1String str)
+{
+    if (str.size() <= InlineCapacity) {
+        ushort buffer[InlineCapacity];
+        for (int i = 0; i < str.size(); ++i)
+            buffer[i] = uchar(str.latin1()[i]);
+        Storage(buffer, str.size()).swap(d);
+    } else {
+        Storage(QString(str)).swap(d);
+    }
+}
+
+inline bool QSmallString::operator==(QLatin1String other) const
+{
+    if (size() != other.size())
+        return false;
+    const ushort *p = d.data();
+    const char *l = other.latin1();
+    for (int i = 0; i < other.size(); ++i) {
+        if (p[i] != uchar(l[i]))
+            return false;
+    }
+    return true;
+}
+
+inline bool operator==(const QString &s1, const QSmallString &s2) { return s2 == s1; }
+inline bool operator!=(const QString &s1, const QSmallString &s2) { return s2 != s1; }
+inline bool operator==(QLatin1String s1, const QSmallString &s2) { return s2 == s1; }
+inline bool operator!=(QLatin1String s1, const QSmallString &s2) { return s2 != s1; }
+
+class QSmallByteArray
+{
+    typedef QtPrivate::QSmallStringStorage<char, QByteArray> Storage;
+public:
+    enum { InlineCapacity = Storage::InlineCapacity };
+
+    typedef const char *const_iterator;
+    typedef const_iterator ConstIterator;
+
+    inline QSmallByteArray() {}
+    inline QSmallByteArray(const QByteArray &ba) : d(ba) {}
+    inline QSmallByteArray(const char *data, int size = -1)
+        : d(data, size < 0 ? int(qstrlen(data)) : size) {}
+
+    inline QSmallByteArray &operator=(const QByteArray &ba)
+    { Storage(ba).swap(d); return *this; }
+    inline QSmallByteArray &operator=(const char *str)
+    { Storage(str, int(qstrlen(str))).swap(d); return *this; }
+
+    inline void swap(QSmallByteArray &other) { d.swap(other.d); }
+
+    inline int size() const { return d.size(); }
+    inline int length() const { return d.size(); }
+    inline bool isEmpty() const { return d.size() == 0; }
+    inline bool isInline() const { return !d.isLong(); }
+    inline void clear() { Storage().swap(d); }
+
+    inline const char *constData() const { return d.data(); }
+    inline const char *data() const { return d.data(); }
+    inline char at(int i) const
+    { Q_ASSERT(uint(i) < uint(size())); return d.data()[i]; }
+    inline char operator[](int i) const { return at(i); }
+
+    inline const_iterator begin() const { return d.data(); }
+    inline const_iterator cbegin() const { return d.data(); }
+    inline const_iterator constBegin() const { return d.data(); }
+    inline const_iterator end() const { return d.data() + size(); }
+    inline const_iterator cend() const { return end(); }
+    inline const_iterator constEnd() const { return end(); }
+
+    inline QByteArray toByteArray() const { return d.toLong(); }
+
+    inline bool operator==(const QSmallByteArray &other) const
+    { return d.equals(other.d.data(), other.d.size()); }
+    inline bool operator!=(const QSmallByteArray &other) const { return !operator==(other); }
+    inline bool operator<(const QSmallByteArray &other) const
+    { return d.compare(other.d.data(), other.d.size()) < 0; }
+    inline bool operator>(const QSmallByteArray &other) const { return other < *this; }
+    inline bool operator<=(const QSmallByteArray &other) const { return !(other < *this); }
+    inline bool operator>=(const QSmallByteArray &other) const { return !(*this < other); }
+
+    inline bool operator==(const QByteArray &other) const
+    { return d.equals(other.constData(), other.size()); }
+    inline bool operator!=(const QByteArray &other) const { return !operator==(other); }
+    inline bool operator==(const char *other) const
+    { return d.equals(other, other ? int(qstrlen(other)) : 0); }
+    inline bool operator!=(const char *other) const { return !operator==(other); }
+
+private:
+    Storage d;
+};
+
+Q_DECLARE_SHARED(QSmallByteArray)
+
+inline bool operator==(const QByteArray &a1, const QSmallByteArray &a2) { return a2 == a1; }
+inline bool operator!=(const QByteArray &a1, const QSmallByteArray &a2) { return a2 != a1; }
+inline bool operator==(const char *a1, const QSmallByteArray &a2) { return a2 == a1; }
+inline bool operator!=(const char *a1, const QSmallByteArray &a2) { return a2 != a1; }
+
+QT_END_NAMESPACE
+
+#endif // QSMALLSTRING_H
@@ -368,6 +368,78 @@ static void qt_to_latin1(uchar *dst, const ushort *src, int length)
 #endif
 }
 
+#ifdef __SSE2__
+/*
+ * Helpers for the ASCII fast paths of the case-insensitive comparisons and
+ * of the case conversions. ASCII characters fold and convert by adding or
+ * subtracting 0x20 within a single range of letters, so eight of them can
+ * be handled at once; anything outside ASCII is left to the Unicode tables.
+ * Note that some non-ASCII characters fold to ASCII letters (U+017F LATIN
+ * SMALL LETTER LONG S and U+212A KELVIN SIGN), so a non-ASCII character can
+ * never be assumed to differ from an ASCII one.
+ */
+
+// Returns the _mm_movemask_epi8 of the characters in \a chunk above U+007F
+static inline uint nonAsciiMask(__m128i chunk)
+{
+    const __m128i highBits = _mm_and_si128(chunk, _mm_set1_epi16(short(0xff80)));
+    return ~_mm_movemask_epi8(_mm_cmpeq_epi16(highBits, _mm_setzero_si128())) & 0xffff;
+}
+
+// Returns a mask of the characters in \a chunk in [\a first, \a last], which
+// must be ASCII. The comparisons are signed, which is fine: every character
+// above U+7FFF compares as negative and so is out of range as well.
+static inline __m128i asciiRange(__m128i chunk, char first, char last)
+{
+    return _mm_and_si128(_mm_cmpgt_epi16(chunk, _mm_set1_epi16(first - 1)),
+                         _mm_cmplt_epi16(chunk, _mm_set1_epi16(last + 1)));
+}
+
+// Folds the ASCII letters in \a chunk to lowercase, leaving all other characters alone
+static inline __m128i asciiFoldCase(__m128i chunk)
+{
+    return _mm_or_si128(chunk, _mm_and_si128(asciiRange(chunk, 'A', 'Z'), _mm_set1_epi16(0x20)));
+}
+
+// Returns the first character in [\a p, \a e) that is either non-ASCII or in
+// [\a first, \a last], looking at eight characters at a time; may return a
+// pointer to one of the last seven characters without having looked at it.
+static inline const ushort *qt_skip_unchanged_ascii(const ushort *p, const ushort *e,
+                                                    char first, char last)
+{
+    for ( ; e - p >= 8; p += 8) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+        const uint mask = nonAsciiMask(chunk) | _mm_movemask_epi8(asciiRange(chunk, first, last));
+        if (mask)
+            return p + _bit_scan_forward(mask) / 2;
+    }
+    return p;
+}
+
+// Copies the ASCII characters at the start of [\a p, \a e) to \a dst, adding \a diff to
+// the ones in [\a first, \a last], eight at a time. \a dst must have room for as many
+// characters as there are in [\a p, \a e); stops at the first non-ASCII character or
+// when fewer than eight characters remain, and advances \a p and \a dst accordingly.
+static inline void qt_convert_case_ascii(const ushort *&p, const ushort *e, ushort *&dst,
+                                         char first, char last, short diff)
+{
+    while (e - p >= 8) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+        const __m128i converted = _mm_add_epi16(chunk, _mm_and_si128(asciiRange(chunk, first, last),
+                                                                     _mm_set1_epi16(diff)));
+
+        // store all eight; whatever follows a non-ASCII character is overwritten later
+        _mm_storeu_si128((__m128i *)dst, converted);
+        const uint nonAscii = nonAsciiMask(chunk);
+        const int n = nonAscii ? _bit_scan_forward(nonAscii) / 2 : 8;
+        p += n;
+        dst += n;
+        if (n != 8)
+            return;
+    }
+}
+#endif
+
 // Unicode case-insensitive comparison
 static int ucstricmp(const ushort *a, const ushort *ae, const ushort *b, const ushort *be)
 {
@@ -384,6 +456,31 @@ static int ucstricmp(const ushort *a, const ushort *ae, const ushort *b, const u
 
     uint alast = 0;
     uint blast = 0;
+#ifdef __SSE2__
+    while (e - a >= 8) {
+        const __m128i da = _mm_loadu_si128((const __m128i *)a);
+        const __m128i db = _mm_loadu_si128((const __m128i *)b);
+        if (nonAsciiMask(_mm_or_si128(da, db))) {
+            // at least one of them isn't ASCII, do these eight the slow way
+            for (const ushort *next = a + 8; a != next; ++a, ++b) {
+                int diff = foldCase(*a, alast) - foldCase(*b, blast);
+                if ((diff))
+                    return diff;
+            }
+            continue;
+        }
+
+        const uint mask = ~_mm_movemask_epi8(_mm_cmpeq_epi16(asciiFoldCase(da), asciiFoldCase(db))) & 0xffff;
+        if (mask) {
+            const int idx = _bit_scan_forward(mask) / 2;
+            return foldCase(a[idx]) - foldCase(b[idx]);
+        }
+        a += 8;
+        b += 8;
+        alast = a[-1];
+        blast = b[-1];
+    }
+#endif
     while (a < e) {
 //         qDebug() << hex << alast << blast;
 //         qDebug() << hex << "*a=" << *a << "alast=" << alast << "folded=" << foldCase (*a, alast);
@@ -417,6 +514,30 @@ static int ucstricmp(const ushort *a, const ushort *ae, const uchar *b, const uc
     if (be - b < ae - a)
         e = a + (be - b);
 
+#ifdef __SSE2__
+    const __m128i nullMask = _mm_setzero_si128();
+    while (e - a >= 8) {
+        const __m128i da = _mm_loadu_si128((const __m128i *)a);
+        const __m128i db = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)b), nullMask);
+        if (nonAsciiMask(_mm_or_si128(da, db))) {
+            // at least one of them isn't ASCII, do these eight the slow way
+            for (const ushort *next = a + 8; a != next; ++a, ++b) {
+                int diff = foldCase(*a) - foldCase(*b);
+                if ((diff))
+                    return diff;
+            }
+            continue;
+        }
+
+        const uint mask = ~_mm_movemask_epi8(_mm_cmpeq_epi16(asciiFoldCase(da), asciiFoldCase(db))) & 0xffff;
+        if (mask) {
+            const int idx = _bit_scan_forward(mask) / 2;
+            return foldCase(a[idx]) - foldCase(b[idx]);
+        }
+        a += 8;
+        b += 8;
+    }
+#endif
     while (a < e) {
         int diff = foldCase(*a) - foldCase(*b);
         if ((diff))
@@ -682,6 +803,24 @@ static int findChar(const QChar *str, int len, QChar ch, int from,
                     return  n - s;
         } else {
             c = foldCase(c);
+#ifdef __SSE2__
+            const __m128i mch = _mm_set1_epi16(c);
+            for (const ushort *next = n + 8; next <= e; n = next, next += 8) {
+                const __m128i data = _mm_loadu_si128((const __m128i *)n);
+                if (nonAsciiMask(data)) {
+                    // only the Unicode tables can tell what a non-ASCII character folds to
+                    for (int i = 0; i < 8; ++i) {
+                        if (foldCase(n[i]) == c)
+                            return n - s + i;
+                    }
+                    continue;
+                }
+
+                const uint mask = _mm_movemask_epi8(_mm_cmpeq_epi16(asciiFoldCase(data), mch));
+                if (mask)
+                    return n - s + _bit_scan_forward(mask) / 2;
+            }
+#endif
             --n;
             while (++n != e)
                 if (foldCase(*n) == c)
@@ -1058,7 +1197,9 @@ const QString::Null QString::null = { };
     the 'e', 'E', and 'f' formats, the \e precision represents the
     number of digits \e after the decimal point. For the 'g' and 'G'
     formats, the \e precision represents the maximum number of
-    significant digits (trailing zeroes are omitted).
+    significant digits (trailing zeroes are omitted). A \e precision of
+    QLocale::FloatingPointShortest selects the shortest representation
+    that converts back to the same number.
 
     \section1 More Efficient String Construction
 
@@ -2875,6 +3016,9 @@ int qFindString(
     if (sl == 1)
         return findChar(haystack0, haystackLen, needle0[0], from, cs);
 
+    if (from < 0)
+        from = 0; // the needle can't start before the haystack does
+
     /*
         We use the Boyer-Moore algorithm in cases where the overhead
         for the skip table should pay off, otherwise we use a simple
@@ -2897,6 +3041,34 @@ int qFindString(
     int hashNeedle = 0, hashHaystack = 0, idx;
 
     if (cs == Qt::CaseSensitive) {
+#ifdef __SSE2__
+        /*
+            Instead of hashing, compare the first and the last character
+            of the needle against eight positions at a time; that rejects
+            nearly every position without looking any further.
+        */
+        const __m128i first = _mm_set1_epi16(needle[0]);
+        const __m128i last = _mm_set1_epi16(needle[sl_minus_1]);
+
+        // we're going to read haystack[0..7] and haystack[sl_minus_1..sl_minus_1 + 7]
+        for ( ; end - haystack >= 7; haystack += 8) {
+            const __m128i dataFirst = _mm_loadu_si128((const __m128i *)haystack);
+            const __m128i dataLast = _mm_loadu_si128((const __m128i *)(haystack + sl_minus_1));
+            uint mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi16(dataFirst, first),
+                                                        _mm_cmpeq_epi16(dataLast, last)));
+            for (mask &= 0x5555; mask; mask &= mask - 1) {
+                const ushort *candidate = haystack + _bit_scan_forward(mask) / 2;
+                if (qMemEquals(needle + 1, candidate + 1, sl - 2))
+                    return candidate - (const ushort *)haystack0;
+            }
+        }
+        for ( ; haystack <= end; ++haystack) {
+            if (haystack[0] == needle[0] && haystack[sl_minus_1] == needle[sl_minus_1]
+                    && qMemEquals(needle + 1, haystack + 1, sl - 2))
+                return haystack - (const ushort *)haystack0;
+        }
+        return -1;
+#endif
         for (idx = 0; idx < sl; ++idx) {
             hashNeedle = ((hashNeedle<<1) + needle[idx]);
             hashHaystack = ((hashHaystack<<1) + haystack[idx]);
@@ -2913,6 +3085,17 @@ int qFindString(
             ++haystack;
         }
     } else {
+#ifdef __SSE2__
+        /*
+            findChar() looks for the first character of the needle eight
+            positions at a time, which leaves few candidates to compare.
+        */
+        for (idx = from; (idx = findChar(haystack0, l - sl_minus_1, needle0[0], idx, cs)) != -1; ++idx) {
+            if (ucstrnicmp(needle, (const ushort *)haystack0 + idx, sl) == 0)
+                return idx;
+        }
+        return -1;
+#endif
         const ushort *haystack_start = (const ushort *)haystack0;
         for (idx = 0; idx < sl; ++idx) {
             hashNeedle = (hashNeedle<<1) + foldCase(needle + idx, needle);
@@ -5487,140 +5670,170 @@ QString QString::rightJustified(int width, QChar fill, bool truncate) const
     return result;
 }
 
-/*!
-    Returns a lowercase copy of the string.
+namespace {
+struct LowercaseTraits
+{
+    enum { AsciiFirst = 'A', AsciiLast = 'Z', AsciiDiff = 'a' - 'A' };
+    static signed short caseDiff(const QUnicodeTables::Properties *prop)
+    { return prop->lowerCaseDiff; }
+    static bool caseSpecial(const QUnicodeTables::Properties *prop)
+    { return prop->lowerCaseSpecial; }
+};
 
-    \snippet qstring/main.cpp 75
+struct UppercaseTraits
+{
+    enum { AsciiFirst = 'a', AsciiLast = 'z', AsciiDiff = 'A' - 'a' };
+    static signed short caseDiff(const QUnicodeTables::Properties *prop)
+    { return prop->upperCaseDiff; }
+    static bool caseSpecial(const QUnicodeTables::Properties *prop)
+    { return prop->upperCaseSpecial; }
+};
 
-    The case conversion will always happen in the 'C' locale. For locale dependent
-    case folding use QLocale::toLower()
+struct CasefoldTraits
+{
+    enum { AsciiFirst = 'A', AsciiLast = 'Z', AsciiDiff = 'a' - 'A' };
+    static signed short caseDiff(const QUnicodeTables::Properties *prop)
+    { return prop->caseFoldDiff; }
+    static bool caseSpecial(const QUnicodeTables::Properties *prop)
+    { return prop->caseFoldSpecial; }
+};
+} // unnamed namespace
 
-    \sa toUpper(), QLocale::toLower()
+#ifdef __SSE2__
+/*
+    Case conversion tries to handle eight ASCII characters at a time. After
+    a non-ASCII character it goes on without SIMD for the next few, so that
+    text in other scripts doesn't pay for a failed attempt at every character;
+    the distance doubles, up to 256, each time an attempt doesn't get through
+    at least eight characters.
 */
+static inline int nextAsciiAttempt(bool progress, int distance)
+{
+    return progress ? 8 : qMin(distance * 2, 256);
+}
+#endif
 
-QString QString::toLower() const
+// Converts [\a p, \a e) of \a str into a copy of \a str, the part before \a p
+// needing no conversion
+template <typename Traits>
+static QString detachAndConvertCase(const QString &str, const ushort *p, const ushort *e)
 {
-    const ushort *p = d->data();
-    if (!p)
-        return *this;
+    const ushort *const begin = reinterpret_cast<const ushort *>(str.constData());
+    const ushort *const end = begin + str.size();
 
-    const ushort *e = p + d->size;
-    // this avoids out of bounds check in the loop
-    while (e != p && QChar::isHighSurrogate(*(e - 1)))
-        --e;
+    QString s(str.size(), Qt::Uninitialized);
+    ushort *pp = reinterpret_cast<ushort *>(s.data());
+    memcpy(pp, begin, (p - begin)*sizeof(ushort));
+    pp += p - begin;
 
+#ifdef __SSE2__
+    int scalarDistance = 8;
+#endif
     const QUnicodeTables::Properties *prop;
     while (p != e) {
-        if (QChar::isHighSurrogate(*p) && QChar::isLowSurrogate(p[1])) {
-            ushort high = *p++;
-            prop = qGetProp(QChar::surrogateToUcs4(high, *p));
-        } else {
-            prop = qGetProp(*p);
-        }
-        if (prop->lowerCaseDiff) {
-            if (QChar::isLowSurrogate(*p))
-                --p; // safe; diff is 0 for surrogates
-            QString s(d->size, Qt::Uninitialized);
-            memcpy(s.d->data(), d->data(), (p - d->data())*sizeof(ushort));
-            ushort *pp = s.d->data() + (p - d->data());
-            while (p != e) {
-                if (QChar::isHighSurrogate(*p) && QChar::isLowSurrogate(p[1])) {
-                    *pp = *p++;
-                    prop = qGetProp(QChar::surrogateToUcs4(*pp++, *p));
-                } else {
-                    prop = qGetProp(*p);
-                }
-                if (prop->lowerCaseSpecial) {
-                    const ushort *specialCase = specialCaseMap + prop->lowerCaseDiff;
-                    ushort length = *specialCase++;
-                    int pos = pp - s.d->data();
-                    s.resize(s.d->size + length - 1);
-                    pp = s.d->data() + pos;
-                    while (length--)
-                        *pp++ = *specialCase++;
-                } else {
-                    *pp++ = *p + prop->lowerCaseDiff;
-                }
-                ++p;
+#ifdef __SSE2__
+        const ushort *start = p;
+        qt_convert_case_ascii(p, e, pp, Traits::AsciiFirst, Traits::AsciiLast, Traits::AsciiDiff);
+        if (p == e)
+            break;
+        scalarDistance = nextAsciiAttempt(p - start >= 8, scalarDistance);
+        const ushort *scalarEnd = e - p > scalarDistance ? p + scalarDistance : e;
+#else
+        const ushort *scalarEnd = e;
+#endif
+        for ( ; p < scalarEnd; ++p) {
+            if (QChar::isHighSurrogate(*p) && QChar::isLowSurrogate(p[1])) {
+                *pp = *p++;
+                prop = qGetProp(QChar::surrogateToUcs4(*pp++, *p));
+            } else {
+                prop = qGetProp(*p);
+            }
+            if (Traits::caseSpecial(prop)) {
+                const ushort *specialCase = specialCaseMap + Traits::caseDiff(prop);
+                ushort length = *specialCase++;
+                int pos = pp - reinterpret_cast<ushort *>(s.data());
+                s.resize(s.size() + length - 1);
+                pp = reinterpret_cast<ushort *>(s.data()) + pos;
+                while (length--)
+                    *pp++ = *specialCase++;
+            } else {
+                *pp++ = *p + Traits::caseDiff(prop);
             }
-
-            // this restores high surrogate parts eaten above, if any
-            while (e != d->data() + d->size)
-                *pp++ = *e++;
-
-            return s;
         }
-        ++p;
     }
-    return *this;
+
+    // this restores high surrogate parts eaten above, if any
+    while (e != end)
+        *pp++ = *e++;
+
+    return s;
 }
 
-/*!
-    Returns the case folded equivalent of the string. For most Unicode
-    characters this is the same as toLower().
-*/
-QString QString::toCaseFolded() const
+template <typename Traits>
+static QString convertCase(const QString &str)
 {
-    const ushort *p = d->data();
-    if (!p)
-        return *this;
-
-    const ushort *e = p + d->size;
+    const ushort *p = reinterpret_cast<const ushort *>(str.constData());
+    const ushort *e = p + str.size();
     // this avoids out of bounds check in the loop
     while (e != p && QChar::isHighSurrogate(*(e - 1)))
         --e;
 
+#ifdef __SSE2__
+    int scalarDistance = 8;
+#endif
     const QUnicodeTables::Properties *prop;
     while (p != e) {
-        if (QChar::isHighSurrogate(*p) && QChar::isLowSurrogate(p[1])) {
-            ushort high = *p++;
-            prop = qGetProp(QChar::surrogateToUcs4(high, *p));
-        } else {
-            prop = qGetProp(*p);
-        }
-        if (prop->caseFoldDiff) {
-            if (QChar::isLowSurrogate(*p))
-                --p; // safe; diff is 0 for surrogates
-            QString s(d->size, Qt::Uninitialized);
-            memcpy(s.d->data(), d->data(), (p - d->data())*sizeof(ushort));
-            ushort *pp = s.d->data() + (p - d->data());
-            while (p != e) {
-                if (QChar::isHighSurrogate(*p) && QChar::isLowSurrogate(p[1])) {
-                    *pp = *p++;
-                    prop = qGetProp(QChar::surrogateToUcs4(*pp++, *p));
-                } else {
-                    prop = qGetProp(*p);
-                }
-                if (prop->caseFoldSpecial) {
-                    const ushort *specialCase = specialCaseMap + prop->caseFoldDiff;
-                    ushort length = *specialCase++;
-#if 0
-                    int pos = pp - s.d->data;
-                    s.resize(s.d->size + length - 1);
-                    pp = s.d->data + pos;
-                    while (length--)
-                        *pp++ = *specialCase++;
+#ifdef __SSE2__
+        const ushort *start = p;
+        p = qt_skip_unchanged_ascii(p, e, Traits::AsciiFirst, Traits::AsciiLast);
+        if (p == e)
+            break;
+        scalarDistance = nextAsciiAttempt(p - start >= 8, scalarDistance);
+        const ushort *scalarEnd = e - p > scalarDistance ? p + scalarDistance : e;
 #else
-                    //### we currently don't support full case foldings
-                    Q_ASSERT(length == 1);
-                    Q_UNUSED(length)
-                    *pp++ = *specialCase;
+        const ushort *scalarEnd = e;
 #endif
-                } else {
-                    *pp++ = *p + prop->caseFoldDiff;
-                }
-                ++p;
+        // a surrogate pair may take p one past scalarEnd, but never past e
+        for ( ; p < scalarEnd; ++p) {
+            if (QChar::isHighSurrogate(*p) && QChar::isLowSurrogate(p[1])) {
+                ushort high = *p++;
+                prop = qGetProp(QChar::surrogateToUcs4(high, *p));
+            } else {
+                prop = qGetProp(*p);
+            }
+            if (Traits::caseDiff(prop)) {
+                if (QChar::isLowSurrogate(*p))
+                    --p; // safe; diff is 0 for surrogates
+                return detachAndConvertCase<Traits>(str, p, e);
             }
-
-            // this restores high surrogate parts eaten above, if any
-            while (e != d->data() + d->size)
-                *pp++ = *e++;
-
-            return s;
         }
-        ++p;
     }
-    return *this;
+    return str;
+}
+
+/*!
+    Returns a lowercase copy of the string.
+
+    \snippet qstring/main.cpp 75
+
+    The case conversion will always happen in the 'C' locale. For locale dependent
+    case folding use QLocale::toLower()
+
+    \sa toUpper(), QLocale::toLower()
+*/
+
+QString QString::toLower() const
+{
+    return convertCase<LowercaseTraits>(*this);
+}
+
+/*!
+    Returns the case folded equivalent of the string. For most Unicode
+    characters this is the same as toLower().
+*/
+QString QString::toCaseFolded() const
+{
+    return convertCase<CasefoldTraits>(*this);
 }
 
 /*!
@@ -5635,59 +5848,7 @@ QString QString::toCaseFolded() const
 */
 QString QString::toUpper() const
 {
-    const ushort *p = d->data();
-    if (!p)
-        return *this;
-
-    const ushort *e = p + d->size;
-    // this avoids out of bounds check in the loop
-    while (e != p && QChar::isHighSurrogate(*(e - 1)))
-        --e;
-
-    const QUnicodeTables::Properties *prop;
-    while (p != e) {
-        if (QChar::isHighSurrogate(*p) && QChar::isLowSurrogate(p[1])) {
-            ushort high = *p++;
-            prop = qGetProp(QChar::surrogateToUcs4(high, *p));
-        } else {
-            prop = qGetProp(*p);
-        }
-        if (prop->upperCaseDiff) {
-            if (QChar::isLowSurrogate(*p))
-                --p; // safe; diff is 0 for surrogates
-            QString s(d->size, Qt::Uninitialized);
-            memcpy(s.d->data(), d->data(), (p - d->data())*sizeof(ushort));
-            ushort *pp = s.d->data() + (p - d->data());
-            while (p != e) {
-                if (QChar::isHighSurrogate(*p) && QChar::isLowSurrogate(p[1])) {
-                    *pp = *p++;
-                    prop = qGetProp(QChar::surrogateToUcs4(*pp++, *p));
-                } else {
-                    prop = qGetProp(*p);
-                }
-                if (prop->upperCaseSpecial) {
-                    const ushort *specialCase = specialCaseMap + prop->upperCaseDiff;
-                    ushort length = *specialCase++;
-                    int pos = pp - s.d->data();
-                    s.resize(s.d->size + length - 1);
-                    pp = s.d->data() + pos;
-                    while (length--)
-                        *pp++ = *specialCase++;
-                } else {
-                    *pp++ = *p + prop->upperCaseDiff;
-                }
-                ++p;
-            }
-
-            // this restores high surrogate parts eaten above, if any
-            while (e != d->data() + d->size)
-                *pp++ = *e++;
-
-            return s;
-        }
-        ++p;
-    }
-    return *this;
+    return convertCase<UppercaseTraits>(*this);
 }
 
 // ### Qt 6: Consider whether this function shouldn't be removed See task 202871.
@@ -23,6 +23,8 @@ HEADERS +=  \
         tools/qdatetime_p.h \
         tools/qdatetimeparser_p.h \
         tools/qeasingcurve.h \
+        tools/qflathash.h \
+        tools/qflatset.h \
         tools/qfreelist_p.h \
         tools/qhash.h \
         tools/qiterator.h \
@@ -55,6 +57,7 @@ HEADERS +=  \
         tools/qset.h \
         tools/qsimd_p.h \
         tools/qsize.h \
+        tools/qsmallstring.h \
         tools/qstack.h \
         tools/qstring.h \
         tools/qstringbuilder.h \
@@ -43,6 +43,7 @@ HEADERS += \
         painting/qregion.h \
         painting/qstroker_p.h \
         painting/qtextureglyphcache_p.h \
+        painting/qtiledrasterdevice_p.h \
         painting/qtransform.h \
         painting/qplatformbackingstore.h \
         painting/qpaintbuffer_p.h \
@@ -86,6 +87,7 @@ SOURCES += \
         painting/qregion.cpp \
         painting/qstroker.cpp \
         painting/qtextureglyphcache.cpp \
+        painting/qtiledrasterdevice.cpp \
         painting/qtransform.cpp \
         painting/qplatformbackingstore.cpp \
         painting/qpaintbuffer.cpp \
@@ -94,6 +96,8 @@ SOURCES += \
 contains(QT_CPU_FEATURES.$$QT_ARCH, sse2) {
     SOURCES += painting/qdrawhelper_sse2.cpp
     SSSE3_SOURCES += painting/qdrawhelper_ssse3.cpp
+    AVX2_SOURCES += painting/qdrawhelper_avx2.cpp
+    SSE4_1_SOURCES += painting/qimagescale_sse4.cpp
 }
 IWMMXT_SOURCES += painting/qdrawhelper_iwmmxt.cpp
 
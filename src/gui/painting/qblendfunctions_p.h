@@ -286,7 +286,8 @@ void qt_transform_image_rasterize(DestT *destPixels, int dbpl,
                                   int dudx, int dvdx, int dudy, int dvdy, int u0, int v0,
                                   Blender blender)
 {
-    int fromY = qMax(qRound(topY), clip.top());
+    int startY = qRound(topY);
+    int fromY = qMax(startY, clip.top());
     int toY = qMin(qRound(bottomY), clip.top() + clip.height());
     if (fromY >= toY)
         return;
@@ -295,8 +296,12 @@ void qt_transform_image_rasterize(DestT *destPixels, int dbpl,
     qreal rightSlope = (bottomRight.x - topRight.x) / (bottomRight.y - topRight.y);
     int dx_l = int(leftSlope * 0x10000);
     int dx_r = int(rightSlope * 0x10000);
-    int x_l = int((topLeft.x + (qreal(0.5) + fromY - topLeft.y) * leftSlope + qreal(0.5)) * 0x10000);
-    int x_r = int((topRight.x + (qreal(0.5) + fromY - topRight.y) * rightSlope + qreal(0.5)) * 0x10000);
+    // Step the edges from the unclipped top, so that the edges do not
+    // depend on the clip.
+    int x_l = int((topLeft.x + (qreal(0.5) + startY - topLeft.y) * leftSlope + qreal(0.5)) * 0x10000);
+    int x_r = int((topRight.x + (qreal(0.5) + startY - topRight.y) * rightSlope + qreal(0.5)) * 0x10000);
+    x_l = int(x_l + qint64(fromY - startY) * dx_l);
+    x_r = int(x_r + qint64(fromY - startY) * dx_r);
 
     int fromX, toX, x1, x2, u, v, i, ii;
     DestT *line;
@@ -4355,10 +4355,7 @@ static void blend_color_argb(int count, const QSpan *spans, void *userData)
             if (spans->coverage == 255) {
                 QT_MEMFILL_UINT(target, spans->len, data->solid.color);
             } else {
-                uint c = BYTE_MUL(data->solid.color, spans->coverage);
-                int ialpha = 255 - spans->coverage;
-                for (int i = 0; i < spans->len; ++i)
-                    target[i] = c + BYTE_MUL(target[i], ialpha);
+                op.funcSolid(target, spans->len, data->solid.color, spans->coverage);
             }
             ++spans;
         }
@@ -6571,6 +6568,23 @@ void qInitDrawhelperAsm()
 
     functionForModeAsm = qt_functionForMode_SSE2;
     functionForModeSolidAsm = qt_functionForModeSolid_SSE2;
+
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+    if (features & AVX2) {
+        qBlendFunctions[QImage::Format_RGB32][QImage::Format_RGB32] = qt_blend_rgb32_on_rgb32_avx2;
+        qBlendFunctions[QImage::Format_ARGB32_Premultiplied][QImage::Format_RGB32] = qt_blend_rgb32_on_rgb32_avx2;
+        qBlendFunctions[QImage::Format_RGB32][QImage::Format_ARGB32_Premultiplied] = qt_blend_argb32_on_argb32_avx2;
+        qBlendFunctions[QImage::Format_ARGB32_Premultiplied][QImage::Format_ARGB32_Premultiplied] = qt_blend_argb32_on_argb32_avx2;
+        qBlendFunctions[QImage::Format_RGBX8888][QImage::Format_RGBX8888] = qt_blend_rgb32_on_rgb32_avx2;
+        qBlendFunctions[QImage::Format_RGBA8888_Premultiplied][QImage::Format_RGBX8888] = qt_blend_rgb32_on_rgb32_avx2;
+        qBlendFunctions[QImage::Format_RGBX8888][QImage::Format_RGBA8888_Premultiplied] = qt_blend_argb32_on_argb32_avx2;
+        qBlendFunctions[QImage::Format_RGBA8888_Premultiplied][QImage::Format_RGBA8888_Premultiplied] = qt_blend_argb32_on_argb32_avx2;
+
+        functionForModeAsm[QPainter::CompositionMode_SourceOver] = comp_func_SourceOver_avx2;
+        functionForModeSolidAsm[QPainter::CompositionMode_SourceOver] = comp_func_solid_SourceOver_avx2;
+        functionForModeSolidAsm[QPainter::CompositionMode_Source] = comp_func_solid_Source_avx2;
+    }
+#endif // AVX2
 #endif // SSE2
 
 #ifdef QT_COMPILER_SUPPORTS_IWMMXT
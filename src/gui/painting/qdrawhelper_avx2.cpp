@@ -0,0 +1,340 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <private/qdrawhelper_x86_p.h>
+
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+
+QT_BEGIN_NAMESPACE
+
+// qblendfunctions.cpp
+void qt_blend_rgb32_on_rgb32(uchar *destPixels, int dbpl,
+                             const uchar *srcPixels, int sbpl,
+                             int w, int h,
+                             int const_alpha);
+
+// The AVX2 kernels below process 8 pixels per iteration. They work the same
+// way as their SSE2 counterparts in qdrawingprimitive_sse2_p.h: every pixel
+// is split into its AG and RB halves so that each channel is on 16 bits, the
+// channels are multiplied, and the division by 255 is approximated with
+// X/255 ~= (X + X/256 + 0x80) / 256.
+
+// Multiply each channel of the 8 pixels of pixelVector by alphaChannel.
+static inline __m256i BYTE_MUL_AVX2(__m256i pixelVector, __m256i alphaChannel,
+                                    __m256i colorMask, __m256i half)
+{
+    __m256i pixelVectorAG = _mm256_srli_epi16(pixelVector, 8);
+    __m256i pixelVectorRB = _mm256_and_si256(pixelVector, colorMask);
+
+    pixelVectorAG = _mm256_mullo_epi16(pixelVectorAG, alphaChannel);
+    pixelVectorRB = _mm256_mullo_epi16(pixelVectorRB, alphaChannel);
+
+    pixelVectorRB = _mm256_add_epi16(pixelVectorRB, _mm256_srli_epi16(pixelVectorRB, 8));
+    pixelVectorRB = _mm256_add_epi16(pixelVectorRB, half);
+    pixelVectorAG = _mm256_add_epi16(pixelVectorAG, _mm256_srli_epi16(pixelVectorAG, 8));
+    pixelVectorAG = _mm256_add_epi16(pixelVectorAG, half);
+
+    pixelVectorRB = _mm256_srli_epi16(pixelVectorRB, 8);
+    pixelVectorAG = _mm256_andnot_si256(colorMask, pixelVectorAG);
+
+    return _mm256_or_si256(pixelVectorAG, pixelVectorRB);
+}
+
+// result = (src * alpha + dst * oneMinusAlpha) / 255 for each channel.
+static inline __m256i INTERPOLATE_PIXEL_255_AVX2(__m256i srcVector, __m256i dstVector,
+                                                 __m256i alphaChannel, __m256i oneMinusAlphaChannel,
+                                                 __m256i colorMask, __m256i half)
+{
+    const __m256i srcVectorAG = _mm256_srli_epi16(srcVector, 8);
+    const __m256i dstVectorAG = _mm256_srli_epi16(dstVector, 8);
+    __m256i finalAG = _mm256_add_epi16(_mm256_mullo_epi16(srcVectorAG, alphaChannel),
+                                       _mm256_mullo_epi16(dstVectorAG, oneMinusAlphaChannel));
+    finalAG = _mm256_add_epi16(finalAG, _mm256_srli_epi16(finalAG, 8));
+    finalAG = _mm256_add_epi16(finalAG, half);
+    finalAG = _mm256_andnot_si256(colorMask, finalAG);
+
+    const __m256i srcVectorRB = _mm256_and_si256(srcVector, colorMask);
+    const __m256i dstVectorRB = _mm256_and_si256(dstVector, colorMask);
+    __m256i finalRB = _mm256_add_epi16(_mm256_mullo_epi16(srcVectorRB, alphaChannel),
+                                       _mm256_mullo_epi16(dstVectorRB, oneMinusAlphaChannel));
+    finalRB = _mm256_add_epi16(finalRB, _mm256_srli_epi16(finalRB, 8));
+    finalRB = _mm256_add_epi16(finalRB, half);
+    finalRB = _mm256_srli_epi16(finalRB, 8);
+
+    return _mm256_or_si256(finalAG, finalRB);
+}
+
+// Returns 255 - alpha of each pixel, spread over the two 16 bit channel slots
+// used by BYTE_MUL_AVX2. The shuffle never crosses the 128 bit lanes.
+static inline __m256i oneMinusAlpha_avx2(__m256i srcVector, __m256i one)
+{
+    const __m256i alphaShuffleMask = _mm256_set_epi8(char(0xff),15,char(0xff),15,char(0xff),11,char(0xff),11,
+                                                     char(0xff),7,char(0xff),7,char(0xff),3,char(0xff),3,
+                                                     char(0xff),15,char(0xff),15,char(0xff),11,char(0xff),11,
+                                                     char(0xff),7,char(0xff),7,char(0xff),3,char(0xff),3);
+    return _mm256_sub_epi16(one, _mm256_shuffle_epi8(srcVector, alphaShuffleMask));
+}
+
+static inline void blend_pixel(quint32 &dst, const quint32 src)
+{
+    if (src >= 0xff000000)
+        dst = src;
+    else if (src != 0)
+        dst = src + BYTE_MUL(dst, qAlpha(~src));
+}
+
+static inline void blend_pixel(quint32 &dst, quint32 src, const int const_alpha)
+{
+    if (src != 0) {
+        src = BYTE_MUL(src, const_alpha);
+        dst = src + BYTE_MUL(dst, qAlpha(~src));
+    }
+}
+
+// dst = src + dst * (1 - src.alpha), with shortcuts for fully opaque and
+// fully transparent groups of 8 pixels.
+static inline void blend_source_over_argb32_avx2(quint32 *dst, const quint32 *src, const int length)
+{
+    const __m256i half = _mm256_set1_epi16(0x80);
+    const __m256i one = _mm256_set1_epi16(0xff);
+    const __m256i colorMask = _mm256_set1_epi32(0x00ff00ff);
+    const __m256i alphaMask = _mm256_set1_epi32(0xff000000);
+
+    int x = 0;
+    ALIGNMENT_PROLOGUE_32BYTES(dst, x, length)
+        blend_pixel(dst[x], src[x]);
+
+    for (; x < length - 7; x += 8) {
+        const __m256i srcVector = _mm256_loadu_si256((const __m256i *)&src[x]);
+        if (_mm256_testz_si256(srcVector, alphaMask))
+            continue; // all transparent
+        if (_mm256_testc_si256(srcVector, alphaMask)) {
+            // all opaque
+            _mm256_store_si256((__m256i *)&dst[x], srcVector);
+        } else {
+            const __m256i alphaChannel = oneMinusAlpha_avx2(srcVector, one);
+            __m256i dstVector = _mm256_load_si256((const __m256i *)&dst[x]);
+            dstVector = BYTE_MUL_AVX2(dstVector, alphaChannel, colorMask, half);
+            _mm256_store_si256((__m256i *)&dst[x], _mm256_add_epi8(srcVector, dstVector));
+        }
+    }
+
+    for (; x < length; ++x)
+        blend_pixel(dst[x], src[x]);
+}
+
+// Same as blend_source_over_argb32_avx2(), with src multiplied by const_alpha first.
+static inline void blend_source_over_argb32_with_const_alpha_avx2(quint32 *dst, const quint32 *src,
+                                                                  const int length, const int const_alpha)
+{
+    const __m256i half = _mm256_set1_epi16(0x80);
+    const __m256i one = _mm256_set1_epi16(0xff);
+    const __m256i colorMask = _mm256_set1_epi32(0x00ff00ff);
+    const __m256i constAlphaVector = _mm256_set1_epi16(const_alpha);
+
+    int x = 0;
+    ALIGNMENT_PROLOGUE_32BYTES(dst, x, length)
+        blend_pixel(dst[x], src[x], const_alpha);
+
+    for (; x < length - 7; x += 8) {
+        __m256i srcVector = _mm256_loadu_si256((const __m256i *)&src[x]);
+        if (_mm256_testz_si256(srcVector, srcVector))
+            continue;
+        srcVector = BYTE_MUL_AVX2(srcVector, constAlphaVector, colorMask, half);
+        const __m256i alphaChannel = oneMinusAlpha_avx2(srcVector, one);
+        __m256i dstVector = _mm256_load_si256((const __m256i *)&dst[x]);
+        dstVector = BYTE_MUL_AVX2(dstVector, alphaChannel, colorMask, half);
+        _mm256_store_si256((__m256i *)&dst[x], _mm256_add_epi8(srcVector, dstVector));
+    }
+
+    for (; x < length; ++x)
+        blend_pixel(dst[x], src[x], const_alpha);
+}
+
+void qt_blend_argb32_on_argb32_avx2(uchar *destPixels, int dbpl,
+                                    const uchar *srcPixels, int sbpl,
+                                    int w, int h,
+                                    int const_alpha)
+{
+    const quint32 *src = (const quint32 *) srcPixels;
+    quint32 *dst = (quint32 *) destPixels;
+    if (const_alpha == 256) {
+        for (int y = 0; y < h; ++y) {
+            blend_source_over_argb32_avx2(dst, src, w);
+            dst = (quint32 *)(((uchar *) dst) + dbpl);
+            src = (const quint32 *)(((const uchar *) src) + sbpl);
+        }
+    } else if (const_alpha != 0) {
+        // dest = (s + d * sia) * ca + d * cia
+        //      = s * ca + d * (sia * ca + cia)
+        //      = s * ca + d * (1 - sa*ca)
+        const_alpha = (const_alpha * 255) >> 8;
+        for (int y = 0; y < h; ++y) {
+            blend_source_over_argb32_with_const_alpha_avx2(dst, src, w, const_alpha);
+            dst = (quint32 *)(((uchar *) dst) + dbpl);
+            src = (const quint32 *)(((const uchar *) src) + sbpl);
+        }
+    }
+}
+
+void qt_blend_rgb32_on_rgb32_avx2(uchar *destPixels, int dbpl,
+                                  const uchar *srcPixels, int sbpl,
+                                  int w, int h,
+                                  int const_alpha)
+{
+    if (const_alpha == 256) {
+        qt_blend_rgb32_on_rgb32(destPixels, dbpl, srcPixels, sbpl, w, h, const_alpha);
+        return;
+    }
+    if (const_alpha == 0)
+        return;
+
+    const quint32 *src = (const quint32 *) srcPixels;
+    quint32 *dst = (quint32 *) destPixels;
+
+    const __m256i half = _mm256_set1_epi16(0x80);
+    const __m256i colorMask = _mm256_set1_epi32(0x00ff00ff);
+
+    const_alpha = (const_alpha * 255) >> 8;
+    const int one_minus_const_alpha = 255 - const_alpha;
+    const __m256i constAlphaVector = _mm256_set1_epi16(const_alpha);
+    const __m256i oneMinusConstAlpha = _mm256_set1_epi16(one_minus_const_alpha);
+    for (int y = 0; y < h; ++y) {
+        int x = 0;
+
+        ALIGNMENT_PROLOGUE_32BYTES(dst, x, w)
+            dst[x] = INTERPOLATE_PIXEL_255(src[x], const_alpha, dst[x], one_minus_const_alpha);
+
+        for (; x < w - 7; x += 8) {
+            const __m256i srcVector = _mm256_loadu_si256((const __m256i *)&src[x]);
+            const __m256i dstVector = _mm256_load_si256((const __m256i *)&dst[x]);
+            const __m256i result = INTERPOLATE_PIXEL_255_AVX2(srcVector, dstVector, constAlphaVector,
+                                                              oneMinusConstAlpha, colorMask, half);
+            _mm256_store_si256((__m256i *)&dst[x], result);
+        }
+
+        for (; x < w; ++x)
+            dst[x] = INTERPOLATE_PIXEL_255(src[x], const_alpha, dst[x], one_minus_const_alpha);
+
+        dst = (quint32 *)(((uchar *) dst) + dbpl);
+        src = (const quint32 *)(((const uchar *) src) + sbpl);
+    }
+}
+
+void QT_FASTCALL comp_func_SourceOver_avx2(uint *destPixels, const uint *srcPixels, int length, uint const_alpha)
+{
+    Q_ASSERT(const_alpha < 256);
+
+    const quint32 *src = (const quint32 *) srcPixels;
+    quint32 *dst = (quint32 *) destPixels;
+
+    if (const_alpha == 255)
+        blend_source_over_argb32_avx2(dst, src, length);
+    else
+        blend_source_over_argb32_with_const_alpha_avx2(dst, src, length, const_alpha);
+}
+
+void QT_FASTCALL comp_func_solid_SourceOver_avx2(uint *destPixels, int length, uint color, uint const_alpha)
+{
+    if ((const_alpha & qAlpha(color)) == 255) {
+        qt_memfill32(destPixels, color, length);
+        return;
+    }
+
+    if (const_alpha != 255)
+        color = BYTE_MUL(color, const_alpha);
+
+    const quint32 minusAlphaOfColor = qAlpha(~color);
+    int x = 0;
+
+    quint32 *dst = (quint32 *) destPixels;
+    const __m256i colorVector = _mm256_set1_epi32(color);
+    const __m256i colorMask = _mm256_set1_epi32(0x00ff00ff);
+    const __m256i half = _mm256_set1_epi16(0x80);
+    const __m256i minusAlphaOfColorVector = _mm256_set1_epi16(minusAlphaOfColor);
+
+    ALIGNMENT_PROLOGUE_32BYTES(dst, x, length)
+        dst[x] = color + BYTE_MUL(dst[x], minusAlphaOfColor);
+
+    for (; x < length - 7; x += 8) {
+        __m256i dstVector = _mm256_load_si256((const __m256i *)&dst[x]);
+        dstVector = BYTE_MUL_AVX2(dstVector, minusAlphaOfColorVector, colorMask, half);
+        _mm256_store_si256((__m256i *)&dst[x], _mm256_add_epi8(colorVector, dstVector));
+    }
+
+    for (; x < length; ++x)
+        dst[x] = color + BYTE_MUL(dst[x], minusAlphaOfColor);
+}
+
+void QT_FASTCALL comp_func_solid_Source_avx2(uint *destPixels, int length, uint color, uint const_alpha)
+{
+    if (const_alpha == 255) {
+        qt_memfill32(destPixels, color, length);
+        return;
+    }
+
+    const int ialpha = 255 - const_alpha;
+    color = BYTE_MUL(color, const_alpha);
+    int x = 0;
+
+    quint32 *dst = (quint32 *) destPixels;
+    const __m256i colorVector = _mm256_set1_epi32(color);
+    const __m256i colorMask = _mm256_set1_epi32(0x00ff00ff);
+    const __m256i half = _mm256_set1_epi16(0x80);
+    const __m256i iAlphaVector = _mm256_set1_epi16(ialpha);
+
+    ALIGNMENT_PROLOGUE_32BYTES(dst, x, length)
+        dst[x] = color + BYTE_MUL(dst[x], ialpha);
+
+    for (; x < length - 7; x += 8) {
+        __m256i dstVector = _mm256_load_si256((const __m256i *)&dst[x]);
+        dstVector = BYTE_MUL_AVX2(dstVector, iAlphaVector, colorMask, half);
+        _mm256_store_si256((__m256i *)&dst[x], _mm256_add_epi8(colorVector, dstVector));
+    }
+
+    for (; x < length; ++x)
+        dst[x] = color + BYTE_MUL(dst[x], ialpha);
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_COMPILER_SUPPORTS_AVX2
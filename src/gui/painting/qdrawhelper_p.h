@@ -54,6 +54,7 @@
 //
 
 #include "QtCore/qglobal.h"
+#include "QtCore/qsharedpointer.h"
 #include "QtGui/qcolor.h"
 #include "QtGui/qpainter.h"
 #include "QtGui/qimage.h"
@@ -105,6 +106,7 @@ struct QLinearGradientData;
 struct QRadialGradientData;
 struct QConicalGradientData;
 struct QSpanData;
+struct QGradientCacheEntry;
 class QGradient;
 class QRasterBuffer;
 class QClipData;
@@ -327,6 +329,8 @@ struct QSpanData
     int fast_matrix : 1;
     bool bilinear;
     QImage *tempImage;
+    // keeps gradient.colorTable alive when the cache drops it
+    QSharedPointer<const QGradientCacheEntry> cachedGradient;
     union {
         QSolidData solid;
         QGradientData gradient;
@@ -82,6 +82,20 @@ extern CompositionFunction qt_functionForMode_SSE2[];
 extern CompositionFunctionSolid qt_functionForModeSolid_SSE2[];
 #endif // __SSE2__
 
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+void qt_blend_argb32_on_argb32_avx2(uchar *destPixels, int dbpl,
+                                    const uchar *srcPixels, int sbpl,
+                                    int w, int h,
+                                    int const_alpha);
+void qt_blend_rgb32_on_rgb32_avx2(uchar *destPixels, int dbpl,
+                                  const uchar *srcPixels, int sbpl,
+                                  int w, int h,
+                                  int const_alpha);
+void QT_FASTCALL comp_func_SourceOver_avx2(uint *destPixels, const uint *srcPixels, int length, uint const_alpha);
+void QT_FASTCALL comp_func_solid_SourceOver_avx2(uint *destPixels, int length, uint color, uint const_alpha);
+void QT_FASTCALL comp_func_solid_Source_avx2(uint *destPixels, int length, uint color, uint const_alpha);
+#endif // QT_COMPILER_SUPPORTS_AVX2
+
 #ifdef QT_COMPILER_SUPPORTS_IWMMXT
 void qt_blend_color_argb_iwmmxt(int count, const QSpan *spans, void *userData);
 
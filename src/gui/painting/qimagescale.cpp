@@ -44,15 +44,12 @@
 #include "qimage.h"
 #include "qcolor.h"
 
-QT_BEGIN_NAMESPACE
+#include <QtCore/qatomic.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthreadpool.h>
 
-namespace QImageScale {
-    struct QImageScaleInfo;
-}
-
-typedef void (*qt_qimageScaleFunc)(QImageScale::QImageScaleInfo *isi, unsigned int *dest,
-                                   int dxx, int dyy, int dx, int dy, int dw,
-                                   int dh, int dow, int sow);
+QT_BEGIN_NAMESPACE
 
 static void qt_qimageScaleAARGB(QImageScale::QImageScaleInfo *isi, unsigned int *dest,
                          int dxx, int dyy, int dx, int dy, int dw,
@@ -113,13 +110,6 @@ qt_qimageScaleFunc qt_qimageScaleRgb  = qt_qimageScaleAARGB;
 
 
 namespace QImageScale {
-    struct QImageScaleInfo {
-        int *xpoints;
-        unsigned int **ypoints;
-        int *xapoints, *yapoints;
-        int xup_yup;
-    };
-
     unsigned int** qimageCalcYPoints(unsigned int *src, int sw, int sh,
                                      int dh);
     int* qimageCalcXPoints(int sw, int dw);
@@ -997,6 +987,129 @@ static void qt_qimageScaleAARGBSetup(QImageScaleInfo *isi, unsigned int *dest,
 }
 #endif
 
+static bool qt_qimageScaleSimdEnabled = true;
+
+// Lets the autotests compare the SIMD scalers to the generic ones
+Q_AUTOTEST_EXPORT void qt_setImageScaleSimdEnabled(bool enabled)
+{
+    qt_qimageScaleSimdEnabled = enabled;
+}
+
+#ifndef QT_NO_THREAD
+/*
+  Splitting the work is only worth the synchronization for images where
+  both the source and the destination pixels touched add up to at least
+  this many pixels, and each band should have at least this many rows.
+*/
+enum {
+    QImageScaleParallelThreshold = 512 * 512,
+    QImageScaleMinimumBandHeight = 16
+};
+
+/*
+  The destination is cut into horizontal bands which are scaled
+  independently, since every destination row only depends on the scale
+  info and on the source. The calling thread takes bands too, so the
+  scaling never waits for a pool thread to become available and cannot
+  deadlock when it is itself running in the pool. The job is reference
+  counted because a pool thread may only get to run after all the bands
+  are done and qSmoothScaleImage has returned.
+
+  Scaling on the pool competes with the application's own use of the
+  global thread pool, so it is only done when QT_THREADED_IMAGE_SCALING
+  is set.
+*/
+struct QImageScaleJob
+{
+    qt_qimageScaleFunc func;
+    QImageScaleInfo *isi;
+    unsigned int *dest;
+    int dw, dh, dow, sow;
+    int bandHeight;
+    int bandCount;
+    QAtomicInt nextBand;
+    QAtomicInt ref;
+    QSemaphore bandsDone;
+
+    bool scaleNextBand()
+    {
+        const int band = nextBand.fetchAndAddRelaxed(1);
+        if (band >= bandCount)
+            return false;
+        const int y = band * bandHeight;
+        func(isi, dest, 0, y, 0, y, dw, qMin(bandHeight, dh - y), dow, sow);
+        bandsDone.release();
+        return true;
+    }
+
+    void deref()
+    {
+        if (!ref.deref())
+            delete this;
+    }
+};
+
+class QImageScaleRunnable : public QRunnable
+{
+public:
+    explicit QImageScaleRunnable(QImageScaleJob *job) : m_job(job) { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        while (m_job->scaleNextBand())
+            ;
+        m_job->deref();
+    }
+
+private:
+    QImageScaleJob *m_job;
+};
+#endif // QT_NO_THREAD
+
+static void qt_qimageScale(qt_qimageScaleFunc func, QImageScaleInfo *isi, unsigned int *dest,
+                           int sw, int sh, int dw, int dh, int dow, int sow)
+{
+#ifndef QT_NO_THREAD
+    static const bool threaded = !qEnvironmentVariableIsEmpty("QT_THREADED_IMAGE_SCALING");
+    QThreadPool *pool = threaded ? QThreadPool::globalInstance() : 0;
+    const qint64 work = qint64(sw) * sh + qint64(dw) * dh;
+    const int maxBands = qMin(dh / QImageScaleMinimumBandHeight, pool ? pool->maxThreadCount() : 0);
+    if (work >= QImageScaleParallelThreshold && maxBands > 1) {
+        QImageScaleJob *job = new QImageScaleJob;
+        job->func = func;
+        job->isi = isi;
+        job->dest = dest;
+        job->dw = dw;
+        job->dh = dh;
+        job->dow = dow;
+        job->sow = sow;
+        job->bandHeight = (dh + maxBands - 1) / maxBands;
+        job->bandCount = (dh + job->bandHeight - 1) / job->bandHeight;
+        job->ref.store(1);
+
+        for (int i = 1; i < job->bandCount; ++i) {
+            job->ref.ref();
+            QImageScaleRunnable *runnable = new QImageScaleRunnable(job);
+            if (!pool->tryStart(runnable)) {
+                delete runnable;
+                job->ref.deref();
+                break;
+            }
+        }
+
+        while (job->scaleNextBand())
+            ;
+        job->bandsDone.acquire(job->bandCount);
+        job->deref();
+        return;
+    }
+#else
+    Q_UNUSED(sw);
+    Q_UNUSED(sh);
+#endif
+    func(isi, dest, 0, 0, 0, 0, dw, dh, dow, sow);
+}
+
 QImage qSmoothScaleImage(const QImage &src, int dw, int dh)
 {
     QImage buffer;
@@ -1017,12 +1130,16 @@ QImage qSmoothScaleImage(const QImage &src, int dw, int dh)
         return QImage();
     }
 
-    if (src.format() == QImage::Format_ARGB32_Premultiplied || src.format() == QImage::Format_RGBA8888_Premultiplied)
-        qt_qimageScaleArgb(scaleinfo, (unsigned int *)buffer.scanLine(0),
-                           0, 0, 0, 0, dw, dh, dw, src.bytesPerLine() / 4);
-    else
-        qt_qimageScaleRgb(scaleinfo, (unsigned int *)buffer.scanLine(0),
-                          0, 0, 0, 0, dw, dh, dw, src.bytesPerLine() / 4);
+    const bool hasAlpha = src.format() == QImage::Format_ARGB32_Premultiplied
+                          || src.format() == QImage::Format_RGBA8888_Premultiplied;
+    qt_qimageScaleFunc func = hasAlpha ? qt_qimageScaleArgb : qt_qimageScaleRgb;
+#if defined(QT_COMPILER_SUPPORTS_SSE4_1)
+    if (qt_qimageScaleSimdEnabled && qCpuHasFeature(SSE4_1))
+        func = hasAlpha ? qt_qimageScaleAARGBA_sse4<false> : qt_qimageScaleAARGBA_sse4<true>;
+#endif
+
+    qt_qimageScale(func, scaleinfo, (unsigned int *)buffer.scanLine(0),
+                   w, h, dw, dh, dw, src.bytesPerLine() / 4);
 
     qimageFreeScaleInfo(scaleinfo);
     return buffer;
@@ -61,6 +61,26 @@ QT_BEGIN_NAMESPACE
 */
 QImage qSmoothScaleImage(const QImage &img, int w, int h);
 
+namespace QImageScale {
+    struct QImageScaleInfo {
+        int *xpoints;
+        unsigned int **ypoints;
+        int *xapoints, *yapoints;
+        int xup_yup;
+    };
+}
+
+typedef void (*qt_qimageScaleFunc)(QImageScale::QImageScaleInfo *isi, unsigned int *dest,
+                                   int dxx, int dyy, int dx, int dy, int dw,
+                                   int dh, int dow, int sow);
+
+#if defined(QT_COMPILER_SUPPORTS_SSE4_1)
+template<bool RGB>
+void qt_qimageScaleAARGBA_sse4(QImageScale::QImageScaleInfo *isi, unsigned int *dest,
+                               int dxx, int dyy, int dx, int dy, int dw,
+                               int dh, int dow, int sow);
+#endif
+
 QT_END_NAMESPACE
 
 #endif
@@ -0,0 +1,256 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <private/qimagescale_p.h>
+#include <private/qsimd_p.h>
+
+#if defined(QT_COMPILER_SUPPORTS_SSE4_1)
+
+QT_BEGIN_NAMESPACE
+
+using namespace QImageScale;
+
+// These are the SSE4.1 versions of qt_qimageScaleAARGBA and qt_qimageScaleAARGB
+// in qimagescale.cpp. Instead of accumulating the four channels in separate
+// integers, each pixel is unpacked into one vector of four 32 bit lanes, so
+// every step of the area sampling is done once per pixel instead of once per
+// channel. The integer arithmetic is exactly the one of the C version, so the
+// results are identical.
+//
+// If RGB is true, the alpha channel of the computed pixels is set to 0xff,
+// like qt_qimageScaleAARGB does.
+
+static inline __m128i qt_qimageScaleUnpack(unsigned int pixel)
+{
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(pixel));
+}
+
+template<bool RGB>
+static inline unsigned int qt_qimageScalePack(__m128i v)
+{
+    v = _mm_packus_epi32(v, v);
+    v = _mm_packus_epi16(v, v);
+    const unsigned int pixel = _mm_cvtsi128_si32(v);
+    return RGB ? (pixel | 0xff000000) : pixel;
+}
+
+// Sums the pixels covered by one destination pixel along one direction,
+// weighted by xyap for the first one and Cxy for the following ones.
+static inline __m128i qt_qimageScaleAARGBA_helper(const unsigned int *pix, int xyap, int Cxy, int step,
+                                                  const __m128i vxyap, const __m128i vCxy)
+{
+    __m128i vx = _mm_mullo_epi32(qt_qimageScaleUnpack(*pix), vxyap);
+    int i;
+    for (i = (1 << 14) - xyap; i > Cxy; i -= Cxy) {
+        pix += step;
+        vx = _mm_add_epi32(vx, _mm_mullo_epi32(qt_qimageScaleUnpack(*pix), vCxy));
+    }
+    if (i > 0) {
+        pix += step;
+        vx = _mm_add_epi32(vx, _mm_mullo_epi32(qt_qimageScaleUnpack(*pix), _mm_set1_epi32(i)));
+    }
+    return vx;
+}
+
+template<bool RGB>
+static void qt_qimageScaleAARGBA_up_xy_sse4(QImageScaleInfo *isi, unsigned int *dest,
+                                            int dxx, int dyy, int dx, int dy, int dw,
+                                            int dh, int dow, int sow)
+{
+    const unsigned int * const *ypoints = isi->ypoints;
+    const int *xpoints = isi->xpoints;
+    const int *xapoints = isi->xapoints;
+    const int *yapoints = isi->yapoints;
+    const int end = dxx + dw;
+
+    for (int y = 0; y < dh; y++) {
+        unsigned int *dptr = dest + dx + ((y + dy) * dow);
+        const unsigned int *sptr = ypoints[dyy + y];
+        const int yap = yapoints[dyy + y];
+        const __m128i vyap = _mm_set1_epi32(yap);
+        const __m128i vinvyap = _mm_set1_epi32(256 - yap);
+        for (int x = dxx; x < end; x++) {
+            const unsigned int *pix = sptr + xpoints[x];
+            const int xap = xapoints[x];
+            if (xap > 0) {
+                const __m128i vxap = _mm_set1_epi32(xap);
+                const __m128i vinvxap = _mm_set1_epi32(256 - xap);
+                __m128i vx = _mm_add_epi32(_mm_mullo_epi32(qt_qimageScaleUnpack(pix[0]), vinvxap),
+                                           _mm_mullo_epi32(qt_qimageScaleUnpack(pix[1]), vxap));
+                if (yap > 0) {
+                    const __m128i vxx = _mm_add_epi32(_mm_mullo_epi32(qt_qimageScaleUnpack(pix[sow]), vinvxap),
+                                                      _mm_mullo_epi32(qt_qimageScaleUnpack(pix[sow + 1]), vxap));
+                    vx = _mm_add_epi32(_mm_mullo_epi32(vxx, vyap), _mm_mullo_epi32(vx, vinvyap));
+                    vx = _mm_srli_epi32(vx, 16);
+                } else {
+                    vx = _mm_srli_epi32(vx, 8);
+                }
+                *dptr++ = qt_qimageScalePack<RGB>(vx);
+            } else if (yap > 0) {
+                __m128i vx = _mm_add_epi32(_mm_mullo_epi32(qt_qimageScaleUnpack(pix[0]), vinvyap),
+                                           _mm_mullo_epi32(qt_qimageScaleUnpack(pix[sow]), vyap));
+                *dptr++ = qt_qimageScalePack<RGB>(_mm_srli_epi32(vx, 8));
+            } else {
+                *dptr++ = *pix;
+            }
+        }
+    }
+}
+
+// Scales down vertically (xdown == false) or horizontally (xdown == true),
+// and up in the other direction.
+template<bool RGB, bool xdown>
+static void qt_qimageScaleAARGBA_down_sse4(QImageScaleInfo *isi, unsigned int *dest,
+                                           int dxx, int dyy, int dx, int dy, int dw,
+                                           int dh, int dow, int sow)
+{
+    const unsigned int * const *ypoints = isi->ypoints;
+    const int *xpoints = isi->xpoints;
+    const int *xapoints = isi->xapoints;
+    const int *yapoints = isi->yapoints;
+    const int end = dxx + dw;
+    const int step = xdown ? 1 : sow;
+    const int other = xdown ? sow : 1;
+
+    for (int y = 0; y < dh; y++) {
+        unsigned int *dptr = dest + dx + ((y + dy) * dow);
+        const int yap = yapoints[dyy + y];
+        for (int x = dxx; x < end; x++) {
+            const int downap = xdown ? xapoints[x] : yap;
+            const int upap = xdown ? yap : xapoints[x];
+            const int C = downap >> 16;
+            const int ap = downap & 0xffff;
+            const __m128i vap = _mm_set1_epi32(ap);
+            const __m128i vC = _mm_set1_epi32(C);
+
+            const unsigned int *pix = ypoints[dyy + y] + xpoints[x];
+            __m128i vx = qt_qimageScaleAARGBA_helper(pix, ap, C, step, vap, vC);
+            if (upap > 0) {
+                const __m128i vxx = qt_qimageScaleAARGBA_helper(pix + other, ap, C, step, vap, vC);
+                vx = _mm_add_epi32(_mm_mullo_epi32(vx, _mm_set1_epi32(256 - upap)),
+                                   _mm_mullo_epi32(vxx, _mm_set1_epi32(upap)));
+                vx = _mm_srli_epi32(vx, 12);
+            } else {
+                vx = _mm_srli_epi32(vx, 4);
+            }
+            *dptr++ = qt_qimageScalePack<RGB>(_mm_srli_epi32(vx, 10));
+        }
+    }
+}
+
+template<bool RGB>
+static void qt_qimageScaleAARGBA_down_xy_sse4(QImageScaleInfo *isi, unsigned int *dest,
+                                              int dxx, int dyy, int dx, int dy, int dw,
+                                              int dh, int dow, int sow)
+{
+    const unsigned int * const *ypoints = isi->ypoints;
+    const int *xpoints = isi->xpoints;
+    const int *xapoints = isi->xapoints;
+    const int *yapoints = isi->yapoints;
+    const int end = dxx + dw;
+
+    for (int y = 0; y < dh; y++) {
+        const int Cy = yapoints[dyy + y] >> 16;
+        const int yap = yapoints[dyy + y] & 0xffff;
+        const __m128i vCy = _mm_set1_epi32(Cy);
+        const __m128i vyap = _mm_set1_epi32(yap);
+
+        unsigned int *dptr = dest + dx + ((y + dy) * dow);
+        for (int x = dxx; x < end; x++) {
+            const int Cx = xapoints[x] >> 16;
+            const int xap = xapoints[x] & 0xffff;
+            const __m128i vCx = _mm_set1_epi32(Cx);
+            const __m128i vxap = _mm_set1_epi32(xap);
+
+            const unsigned int *sptr = ypoints[dyy + y] + xpoints[x];
+            __m128i vx = qt_qimageScaleAARGBA_helper(sptr, xap, Cx, 1, vxap, vCx);
+            __m128i v = _mm_mullo_epi32(_mm_srli_epi32(vx, 5), vyap);
+
+            int j;
+            for (j = (1 << 14) - yap; j > Cy; j -= Cy) {
+                sptr += sow;
+                vx = qt_qimageScaleAARGBA_helper(sptr, xap, Cx, 1, vxap, vCx);
+                v = _mm_add_epi32(v, _mm_mullo_epi32(_mm_srli_epi32(vx, 5), vCy));
+            }
+            if (j > 0) {
+                sptr += sow;
+                vx = qt_qimageScaleAARGBA_helper(sptr, xap, Cx, 1, vxap, vCx);
+                v = _mm_add_epi32(v, _mm_mullo_epi32(_mm_srli_epi32(vx, 5), _mm_set1_epi32(j)));
+            }
+
+            *dptr++ = qt_qimageScalePack<RGB>(_mm_srli_epi32(v, 23));
+        }
+    }
+}
+
+template<bool RGB>
+void qt_qimageScaleAARGBA_sse4(QImageScaleInfo *isi, unsigned int *dest,
+                               int dxx, int dyy, int dx, int dy, int dw,
+                               int dh, int dow, int sow)
+{
+    switch (isi->xup_yup) {
+    case 3: // scaling up both ways
+        qt_qimageScaleAARGBA_up_xy_sse4<RGB>(isi, dest, dxx, dyy, dx, dy, dw, dh, dow, sow);
+        break;
+    case 1: // scaling down vertically
+        qt_qimageScaleAARGBA_down_sse4<RGB, false>(isi, dest, dxx, dyy, dx, dy, dw, dh, dow, sow);
+        break;
+    case 2: // scaling down horizontally
+        qt_qimageScaleAARGBA_down_sse4<RGB, true>(isi, dest, dxx, dyy, dx, dy, dw, dh, dow, sow);
+        break;
+    default: // scaling down both ways
+        qt_qimageScaleAARGBA_down_xy_sse4<RGB>(isi, dest, dxx, dyy, dx, dy, dw, dh, dow, sow);
+        break;
+    }
+}
+
+template void qt_qimageScaleAARGBA_sse4<false>(QImageScaleInfo *isi, unsigned int *dest,
+                                               int dxx, int dyy, int dx, int dy, int dw,
+                                               int dh, int dow, int sow);
+
+template void qt_qimageScaleAARGBA_sse4<true>(QImageScaleInfo *isi, unsigned int *dest,
+                                              int dxx, int dyy, int dx, int dy, int dw,
+                                              int dh, int dow, int sow);
+
+QT_END_NAMESPACE
+
+#endif // QT_COMPILER_SUPPORTS_SSE4_1
@@ -98,6 +98,7 @@ public:
 private:
     friend class QPainterReplayer;
     friend class QOpenGLReplayer;
+    friend class QTiledRasterDevice;
 
     friend Q_GUI_EXPORT QDataStream &operator<<(QDataStream &stream, const QPaintBuffer &buffer);
     friend Q_GUI_EXPORT QDataStream &operator>>(QDataStream &stream, QPaintBuffer &buffer);
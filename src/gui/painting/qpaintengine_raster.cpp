@@ -500,6 +500,7 @@ bool QRasterPaintEngine::begin(QPaintDevice *device)
         d->outlineMapper->m_clip_rect.setHeight(QT_RASTER_COORD_LIMIT);
 
     d->rasterizer->setClipRect(d->deviceRect);
+    d->rasterizer->setDeviceRect(d->deviceRectUnclipped);
 
     s->penData.init(d->rasterBuffer.data(), this);
     s->penData.setup(s->pen.brush(), s->intOpacity, s->composition_mode);
@@ -2031,6 +2032,54 @@ void QRasterPaintEngine::drawPolygon(const QPoint *points, int pointCount, Polyg
     }
 }
 
+/*!
+    \reimp
+*/
+void QRasterPaintEngine::drawPolygons(const QPolygonF *polygons, int polygonCount, PolygonDrawMode mode)
+{
+    Q_D(QRasterPaintEngine);
+    QRasterPaintEngineState *s = state();
+
+#ifdef QT_DEBUG_DRAW
+    qDebug(" - QRasterPaintEngine::drawPolygons(), polygonCount=%d", polygonCount);
+#endif
+
+    ensurePen();
+    if (mode == PolylineMode && !s->penData.blend)
+        return;
+
+    // Share the pen setup and one cosmetic stroker between the polygons,
+    // drawing each of them the same way drawPolygon() does.
+    QCosmeticStroker stroker(s, d->deviceRect, d->deviceRectUnclipped);
+    stroker.setLegacyRoundingEnabled(s->flags.legacy_rounding);
+    for (int i = 0; i < polygonCount; ++i) {
+        const QPointF *points = polygons[i].constData();
+        const int pointCount = polygons[i].size();
+        if (pointCount < 2)
+            continue;
+
+        if (mode != PolylineMode) {
+            if (isRect((qreal *) points, pointCount)) {
+                QRectF r(points[0], points[2]);
+                drawRects(&r, 1);
+                continue;
+            }
+            // wide pens are filled through the brush data
+            ensureBrush();
+            if (s->brushData.blend)
+                fillPolygon(points, pointCount, mode);
+        }
+
+        if (!s->penData.blend)
+            continue;
+        QVectorPath vp((qreal *) points, pointCount, 0, QVectorPath::polygonFlags(mode));
+        if (s->flags.fast_pen)
+            stroker.drawPath(vp);
+        else
+            QPaintEngineEx::stroke(vp, s->lastPen);
+    }
+}
+
 /*!
     \internal
 */
@@ -4180,22 +4229,25 @@ void QRasterBuffer::flushToARGBImage(QImage *target) const
 }
 
 
-class QGradientCache
+struct QGradientCacheEntry
 {
-    struct CacheInfo
-    {
-        inline CacheInfo(QGradientStops s, int op, QGradient::InterpolationMode mode) :
-            stops(s), opacity(op), interpolationMode(mode) {}
-        uint buffer[GRADIENT_STOPTABLE_SIZE];
-        QGradientStops stops;
-        int opacity;
-        QGradient::InterpolationMode interpolationMode;
-    };
+    inline QGradientCacheEntry(QGradientStops s, int op, QGradient::InterpolationMode mode) :
+        stops(s), opacity(op), interpolationMode(mode) {}
+    uint buffer[GRADIENT_STOPTABLE_SIZE];
+    QGradientStops stops;
+    int opacity;
+    QGradient::InterpolationMode interpolationMode;
+};
 
-    typedef QMultiHash<quint64, CacheInfo> QGradientColorTableHash;
+class QGradientCache
+{
+    typedef QSharedPointer<const QGradientCacheEntry> CacheInfoPtr;
+    typedef QMultiHash<quint64, CacheInfoPtr> QGradientColorTableHash;
 
 public:
-    inline const uint *getBuffer(const QGradient &gradient, int opacity) {
+    // The entries are shared with the span data using them, as painters
+    // on other threads may remove them from the cache at any time.
+    inline CacheInfoPtr getBuffer(const QGradient &gradient, int opacity) {
         quint64 hash_val = 0;
 
         QGradientStops stops = gradient.stops();
@@ -4209,9 +4261,9 @@ public:
             return addCacheElement(hash_val, gradient, opacity);
         else {
             do {
-                const CacheInfo &cache_info = it.value();
-                if (cache_info.stops == stops && cache_info.opacity == opacity && cache_info.interpolationMode == gradient.interpolationMode())
-                    return cache_info.buffer;
+                const CacheInfoPtr &cache_info = it.value();
+                if (cache_info->stops == stops && cache_info->opacity == opacity && cache_info->interpolationMode == gradient.interpolationMode())
+                    return cache_info;
                 ++it;
             } while (it != cache.constEnd() && it.key() == hash_val);
             // an exact match for these stops and opacity was not found, create new cache
@@ -4225,14 +4277,14 @@ protected:
     inline void generateGradientColorTable(const QGradient& g,
                                            uint *colorTable,
                                            int size, int opacity) const;
-    uint *addCacheElement(quint64 hash_val, const QGradient &gradient, int opacity) {
+    CacheInfoPtr addCacheElement(quint64 hash_val, const QGradient &gradient, int opacity) {
         if (cache.size() == maxCacheSize()) {
             // may remove more than 1, but OK
             cache.erase(cache.begin() + (qrand() % maxCacheSize()));
         }
-        CacheInfo cache_entry(gradient.stops(), opacity, gradient.interpolationMode());
-        generateGradientColorTable(gradient, cache_entry.buffer, paletteSize(), opacity);
-        return cache.insert(hash_val, cache_entry).value().buffer;
+        QGradientCacheEntry *cache_entry = new QGradientCacheEntry(gradient.stops(), opacity, gradient.interpolationMode());
+        generateGradientColorTable(gradient, cache_entry->buffer, paletteSize(), opacity);
+        return cache.insert(hash_val, CacheInfoPtr(cache_entry)).value();
     }
 
     QGradientColorTableHash cache;
@@ -4468,7 +4520,8 @@ void QSpanData::setup(const QBrush &brush, int alpha, QPainter::CompositionMode
             type = LinearGradient;
             const QLinearGradient *g = static_cast<const QLinearGradient *>(brush.gradient());
             gradient.alphaColor = !brush.isOpaque() || alpha != 256;
-            gradient.colorTable = const_cast<uint*>(qt_gradient_cache()->getBuffer(*g, alpha));
+            cachedGradient = qt_gradient_cache()->getBuffer(*g, alpha);
+            gradient.colorTable = const_cast<uint*>(cachedGradient->buffer);
             gradient.spread = g->spread();
 
             QLinearGradientData &linearData = gradient.linear;
@@ -4485,7 +4538,8 @@ void QSpanData::setup(const QBrush &brush, int alpha, QPainter::CompositionMode
             type = RadialGradient;
             const QRadialGradient *g = static_cast<const QRadialGradient *>(brush.gradient());
             gradient.alphaColor = !brush.isOpaque() || alpha != 256;
-            gradient.colorTable = const_cast<uint*>(qt_gradient_cache()->getBuffer(*g, alpha));
+            cachedGradient = qt_gradient_cache()->getBuffer(*g, alpha);
+            gradient.colorTable = const_cast<uint*>(cachedGradient->buffer);
             gradient.spread = g->spread();
 
             QRadialGradientData &radialData = gradient.radial;
@@ -4506,7 +4560,8 @@ void QSpanData::setup(const QBrush &brush, int alpha, QPainter::CompositionMode
             type = ConicalGradient;
             const QConicalGradient *g = static_cast<const QConicalGradient *>(brush.gradient());
             gradient.alphaColor = !brush.isOpaque() || alpha != 256;
-            gradient.colorTable = const_cast<uint*>(qt_gradient_cache()->getBuffer(*g, alpha));
+            cachedGradient = qt_gradient_cache()->getBuffer(*g, alpha);
+            gradient.colorTable = const_cast<uint*>(cachedGradient->buffer);
             gradient.spread = QGradient::RepeatSpread;
 
             QConicalGradientData &conicalData = gradient.conical;
@@ -164,6 +164,7 @@ public:
 
     void drawPolygon(const QPointF *points, int pointCount, PolygonDrawMode mode);
     void drawPolygon(const QPoint *points, int pointCount, PolygonDrawMode mode);
+    void drawPolygons(const QPolygonF *polygons, int polygonCount, PolygonDrawMode mode);
     void fillPath(const QPainterPath &path, QSpanData *fillData);
     void fillPolygon(const QPointF *points, int pointCount, PolygonDrawMode mode);
 
@@ -937,6 +937,14 @@ void QPaintEngineEx::drawPolygon(const QPoint *points, int pointCount, PolygonDr
 
 }
 
+void QPaintEngineEx::drawPolygons(const QPolygonF *polygons, int polygonCount, PolygonDrawMode mode)
+{
+    for (int i = 0; i < polygonCount; ++i) {
+        if (polygons[i].size() >= 2)
+            drawPolygon(polygons[i].constData(), polygons[i].size(), mode);
+    }
+}
+
 void QPaintEngineEx::drawPixmap(const QPointF &pos, const QPixmap &pm)
 {
     drawPixmap(QRectF(pos, pm.size() / pm.devicePixelRatio()), pm, pm.rect());
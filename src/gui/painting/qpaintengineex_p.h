@@ -122,6 +122,7 @@ public:
 
     virtual void drawPolygon(const QPointF *points, int pointCount, PolygonDrawMode mode);
     virtual void drawPolygon(const QPoint *points, int pointCount, PolygonDrawMode mode);
+    virtual void drawPolygons(const QPolygonF *polygons, int polygonCount, PolygonDrawMode mode);
 
     virtual void drawPixmap(const QRectF &r, const QPixmap &pm, const QRectF &sr) = 0;
     virtual void drawPixmap(const QPointF &pos, const QPixmap &pm);
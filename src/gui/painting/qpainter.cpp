@@ -4783,6 +4783,46 @@ void QPainter::drawPolyline(const QPoint *points, int pointCount)
     current pen.
 */
 
+/*!
+    \since 5.4
+
+    Draws the first \a polylineCount polylines in the array \a polylines
+    using the current pen.
+
+    The result is the same as calling drawPolyline() for each polyline
+    in turn, but the paint engine can share the pen setup between them.
+    Polylines with fewer than two points are ignored.
+
+    \sa drawPolyline(), drawPolygons(), drawLines()
+*/
+void QPainter::drawPolylines(const QPolygonF *polylines, int polylineCount)
+{
+#ifdef QT_DEBUG_DRAW
+    if (qt_show_painter_debug_output)
+        printf("QPainter::drawPolylines(), count=%d\n", polylineCount);
+#endif
+    Q_D(QPainter);
+
+    if (!d->engine || polylineCount <= 0)
+        return;
+
+    if (d->extended) {
+        d->extended->drawPolygons(polylines, polylineCount, QPaintEngine::PolylineMode);
+        return;
+    }
+
+    for (int i = 0; i < polylineCount; ++i)
+        drawPolyline(polylines[i]);
+}
+
+/*!
+    \fn void QPainter::drawPolylines(const QVector<QPolygonF> &polylines)
+    \since 5.4
+    \overload
+
+    Draws the given \a polylines using the current pen.
+*/
+
 /*!
     Draws the polygon defined by the first \a pointCount points in the
     array \a points using the current pen and brush.
@@ -4894,6 +4934,46 @@ void QPainter::drawPolygon(const QPoint *points, int pointCount, Qt::FillRule fi
     rule \a fillRule.
 */
 
+/*!
+    \since 5.4
+
+    Draws the first \a polygonCount polygons in the array \a polygons
+    using the current pen and brush and the fill rule \a fillRule.
+
+    The result is the same as calling drawPolygon() for each polygon in
+    turn, but the paint engine can share the pen and brush setup between
+    them. Polygons with fewer than two points are ignored.
+
+    \sa drawPolygon(), drawPolylines()
+*/
+void QPainter::drawPolygons(const QPolygonF *polygons, int polygonCount, Qt::FillRule fillRule)
+{
+#ifdef QT_DEBUG_DRAW
+    if (qt_show_painter_debug_output)
+        printf("QPainter::drawPolygons(), count=%d\n", polygonCount);
+#endif
+    Q_D(QPainter);
+
+    if (!d->engine || polygonCount <= 0)
+        return;
+
+    if (d->extended) {
+        d->extended->drawPolygons(polygons, polygonCount, QPaintEngine::PolygonDrawMode(fillRule));
+        return;
+    }
+
+    for (int i = 0; i < polygonCount; ++i)
+        drawPolygon(polygons[i], fillRule);
+}
+
+/*!
+    \fn void QPainter::drawPolygons(const QVector<QPolygonF> &polygons, Qt::FillRule fillRule)
+    \since 5.4
+    \overload
+
+    Draws the given \a polygons using the fill rule \a fillRule.
+*/
+
 /*!
     \fn void QPainter::drawConvexPolygon(const QPointF *points, int pointCount)
 
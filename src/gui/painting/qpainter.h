@@ -324,11 +324,15 @@ public:
     inline void drawPolyline(const QPolygonF &polyline);
     void drawPolyline(const QPoint *points, int pointCount);
     inline void drawPolyline(const QPolygon &polygon);
+    void drawPolylines(const QPolygonF *polylines, int polylineCount);
+    inline void drawPolylines(const QVector<QPolygonF> &polylines);
 
     void drawPolygon(const QPointF *points, int pointCount, Qt::FillRule fillRule = Qt::OddEvenFill);
     inline void drawPolygon(const QPolygonF &polygon, Qt::FillRule fillRule = Qt::OddEvenFill);
     void drawPolygon(const QPoint *points, int pointCount, Qt::FillRule fillRule = Qt::OddEvenFill);
     inline void drawPolygon(const QPolygon &polygon, Qt::FillRule fillRule = Qt::OddEvenFill);
+    void drawPolygons(const QPolygonF *polygons, int polygonCount, Qt::FillRule fillRule = Qt::OddEvenFill);
+    inline void drawPolygons(const QVector<QPolygonF> &polygons, Qt::FillRule fillRule = Qt::OddEvenFill);
 
     void drawConvexPolygon(const QPointF *points, int pointCount);
     inline void drawConvexPolygon(const QPolygonF &polygon);
@@ -551,6 +555,11 @@ inline void QPainter::drawPolyline(const QPolygon &polyline)
     drawPolyline(polyline.constData(), polyline.size());
 }
 
+inline void QPainter::drawPolylines(const QVector<QPolygonF> &polylines)
+{
+    drawPolylines(polylines.constData(), polylines.size());
+}
+
 inline void QPainter::drawPolygon(const QPolygonF &polygon, Qt::FillRule fillRule)
 {
     drawPolygon(polygon.constData(), polygon.size(), fillRule);
@@ -561,6 +570,11 @@ inline void QPainter::drawPolygon(const QPolygon &polygon, Qt::FillRule fillRule
     drawPolygon(polygon.constData(), polygon.size(), fillRule);
 }
 
+inline void QPainter::drawPolygons(const QVector<QPolygonF> &polygons, Qt::FillRule fillRule)
+{
+    drawPolygons(polygons.constData(), polygons.size(), fillRule);
+}
+
 inline void QPainter::drawConvexPolygon(const QPolygonF &poly)
 {
     drawConvexPolygon(poly.constData(), poly.size());
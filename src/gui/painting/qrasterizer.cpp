@@ -203,6 +203,7 @@ public:
     ProcessSpans blend;
     void *data;
     QRect clipRect;
+    QRect deviceRect;
 
     QScanConverter scanConverter;
 };
@@ -669,6 +670,11 @@ void QRasterizer::setClipRect(const QRect &clipRect)
     d->clipRect = clipRect;
 }
 
+void QRasterizer::setDeviceRect(const QRect &deviceRect)
+{
+    d->deviceRect = deviceRect;
+}
+
 void QRasterizer::setLegacyRoundingEnabled(bool legacyRoundingEnabled)
 {
     d->legacyRounding = legacyRoundingEnabled;
@@ -781,8 +787,11 @@ void QRasterizer::rasterizeLine(const QPointF &a, const QPointF &b, qreal width,
         pb += (0.5f * width) * delta;
     }
 
+    // shorten the line to the device and not to the clip, so that the
+    // system clip does not change the pixels inside of it
     QPointF offs = QPointF(qAbs(b.y() - a.y()), qAbs(b.x() - a.x())) * width * 0.5;
-    const QRectF clip(d->clipRect.topLeft() - offs, d->clipRect.bottomRight() + QPoint(1, 1) + offs);
+    const QRect &bounds = d->deviceRect.isValid() ? d->deviceRect : d->clipRect;
+    const QRectF clip(bounds.topLeft() - offs, bounds.bottomRight() + QPoint(1, 1) + offs);
 
     if (!clip.contains(pa) || !clip.contains(pb)) {
         qreal t1 = 0;
@@ -0,0 +1,577 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qtiledrasterdevice_p.h"
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qpen.h>
+
+QT_BEGIN_NAMESPACE
+
+extern bool qHasPixmapTexture(const QBrush &);
+
+/*!
+    \class QTiledRasterDevice
+    \internal
+
+    \brief The QTiledRasterDevice class rasterizes painting on a QImage
+    with several threads.
+
+    Painting on a QTiledRasterDevice records the drawing commands in a
+    QPaintBuffer instead of rasterizing them right away. When the painter
+    ends, the image is cut into tiles of tileHeight() scanlines and the
+    recording is replayed once per tile by a QRasterPaintEngine whose system
+    clip is the tile, so each engine only generates and blends the spans of
+    its own tile. Before that, the drawing commands are binned to the tiles
+    their bounds reach, and each tile only replays its own bin and the
+    state commands. The tiles are rendered by the calling thread together
+    with up to threadCount() - 1 idle threads of
+    QThreadPool::globalInstance().
+
+    Every tile is painted at the image's own device coordinates and is only
+    clipped, so the result is identical to painting on the image directly.
+
+    Font engines and pixmaps must not be used from several threads at once,
+    so recordings containing text, pixmaps or pixmap brushes are rendered
+    on the calling thread only.
+*/
+
+class QTiledRasterEngine : public QPaintBufferEngine
+{
+public:
+    QTiledRasterEngine(QPaintBufferPrivate *buffer, QTiledRasterDevice *device)
+        : QPaintBufferEngine(buffer), m_device(device)
+    {
+    }
+
+    virtual bool end()
+    {
+        const bool ended = QPaintBufferEngine::end();
+        m_device->flush();
+        return ended;
+    }
+
+private:
+    QTiledRasterDevice *m_device;
+};
+
+/*
+  Replays the commands of a recording that were binned to a tile.
+*/
+class QTiledRasterReplayer : public QPaintEngineExReplayer
+{
+public:
+    void replay(QPaintBufferPrivate *recording, QPainter *p, const QVector<int> &commands)
+    {
+        d = recording;
+        painter = p;
+        for (int i = 0; i < commands.size(); ++i)
+            process(d->commands.at(commands.at(i)));
+    }
+};
+
+/*
+  Sorts the commands of a recording into the tiles they draw on. The
+  state commands are replayed on a painter of its own, which tracks the
+  pen and the transform the drawing commands are bounded with, and are
+  added to every tile. The drawing commands are only added to the tiles
+  that their device bounds reach. The bounds are conservative: they
+  include the pen and a pixel of antialiasing on each side, and commands
+  without known bounds are added to every tile.
+*/
+class QTiledRasterBinner : public QPaintEngineExReplayer
+{
+public:
+    QTiledRasterBinner(const QImage &target, int tileHeight, int tileCount)
+        : m_width(target.width()), m_tileHeight(tileHeight), m_bins(tileCount),
+          m_scratch(1, 1, QImage::Format_ARGB32_Premultiplied)
+    {
+        m_scratch.setDevicePixelRatio(target.devicePixelRatio());
+    }
+
+    QVector<QVector<int> > bin(QPaintBufferPrivate *recording, int commandCount)
+    {
+        d = recording;
+        QPainter scratchPainter(&m_scratch);
+        painter = &scratchPainter;
+        for (int i = 0; i < commandCount; ++i)
+            binCommand(i);
+        return m_bins;
+    }
+
+private:
+    void binCommand(int index)
+    {
+        const QPaintBufferCommand &cmd = d->commands.at(index);
+        switch (cmd.id) {
+        case QPaintBufferPrivate::Cmd_SystemStateChanged:
+            // an empty recorded system clip would reset the clip to the tile
+            return;
+        case QPaintBufferPrivate::Cmd_Save:
+        case QPaintBufferPrivate::Cmd_Restore:
+        case QPaintBufferPrivate::Cmd_SetBrush:
+        case QPaintBufferPrivate::Cmd_SetBrushOrigin:
+        case QPaintBufferPrivate::Cmd_SetClipEnabled:
+        case QPaintBufferPrivate::Cmd_SetCompositionMode:
+        case QPaintBufferPrivate::Cmd_SetOpacity:
+        case QPaintBufferPrivate::Cmd_SetPen:
+        case QPaintBufferPrivate::Cmd_SetRenderHints:
+        case QPaintBufferPrivate::Cmd_SetTransform:
+        case QPaintBufferPrivate::Cmd_SetBackgroundMode:
+        case QPaintBufferPrivate::Cmd_ClipPath:
+        case QPaintBufferPrivate::Cmd_ClipRect:
+        case QPaintBufferPrivate::Cmd_ClipRegion:
+        case QPaintBufferPrivate::Cmd_ClipVectorPath:
+        case QPaintBufferPrivate::Cmd_Translate:
+            process(cmd);
+            addToTiles(index, 0, m_bins.size() - 1);
+            return;
+        default:
+            break;
+        }
+
+        QRectF bounds;
+        if (!deviceBounds(cmd, &bounds)) {
+            addToTiles(index, 0, m_bins.size() - 1);
+        } else if (bounds.right() > 0 && bounds.left() < m_width) {
+            const qreal lastTile = m_bins.size() - 1;
+            addToTiles(index, int(qBound(qreal(0), bounds.top() / m_tileHeight, lastTile)),
+                       int(qBound(qreal(0), bounds.bottom() / m_tileHeight, lastTile)));
+        }
+    }
+
+    void addToTiles(int index, int firstTile, int lastTile)
+    {
+        for (int tile = firstTile; tile <= lastTile; ++tile)
+            m_bins[tile].append(index);
+    }
+
+    template <typename T>
+    static QRectF pointBounds(const T *coords, int count)
+    {
+        if (count <= 0)
+            return QRectF();
+        qreal minX = coords[0], maxX = coords[0];
+        qreal minY = coords[1], maxY = coords[1];
+        for (int i = 1; i < count; ++i) {
+            const qreal x = coords[2 * i];
+            const qreal y = coords[2 * i + 1];
+            minX = qMin(minX, x);
+            maxX = qMax(maxX, x);
+            minY = qMin(minY, y);
+            maxY = qMax(maxY, y);
+        }
+        return QRectF(minX, minY, maxX - minX, maxY - minY);
+    }
+
+    template <typename T>
+    static QRectF rectBounds(const T *rects, int count)
+    {
+        QRectF bounds;
+        for (int i = 0; i < count; ++i)
+            bounds |= QRectF(rects[i]);
+        return bounds;
+    }
+
+    // Returns false if the bounds of the command are not known
+    bool deviceBounds(const QPaintBufferCommand &cmd, QRectF *deviceBounds) const
+    {
+        QRectF bounds;
+        const QPen *pen = 0;
+        QPen strokePen;
+
+        switch (cmd.id) {
+        case QPaintBufferPrivate::Cmd_FillVectorPath:
+            bounds = pointBounds(d->floats.constData() + cmd.offset, cmd.size);
+            break;
+        case QPaintBufferPrivate::Cmd_StrokeVectorPath:
+            strokePen = qvariant_cast<QPen>(d->variants.at(cmd.extra));
+            pen = &strokePen;
+            bounds = pointBounds(d->floats.constData() + cmd.offset, cmd.size);
+            break;
+        case QPaintBufferPrivate::Cmd_DrawVectorPath:
+        case QPaintBufferPrivate::Cmd_DrawPolygonF:
+        case QPaintBufferPrivate::Cmd_DrawPolylineF:
+        case QPaintBufferPrivate::Cmd_DrawConvexPolygonF:
+        case QPaintBufferPrivate::Cmd_DrawPointsF:
+            pen = &painter->pen();
+            bounds = pointBounds(d->floats.constData() + cmd.offset, cmd.size);
+            break;
+        case QPaintBufferPrivate::Cmd_DrawPolygonI:
+        case QPaintBufferPrivate::Cmd_DrawPolylineI:
+        case QPaintBufferPrivate::Cmd_DrawConvexPolygonI:
+        case QPaintBufferPrivate::Cmd_DrawPointsI:
+            pen = &painter->pen();
+            bounds = pointBounds(d->ints.constData() + cmd.offset, cmd.size);
+            break;
+        case QPaintBufferPrivate::Cmd_DrawLineF:
+            pen = &painter->pen();
+            bounds = pointBounds(d->floats.constData() + cmd.offset, cmd.size * 2);
+            break;
+        case QPaintBufferPrivate::Cmd_DrawLineI:
+            pen = &painter->pen();
+            bounds = pointBounds(d->ints.constData() + cmd.offset, cmd.size * 2);
+            break;
+        case QPaintBufferPrivate::Cmd_DrawRectF:
+            pen = &painter->pen();
+            bounds = rectBounds((const QRectF *)(d->floats.constData() + cmd.offset), cmd.size);
+            break;
+        case QPaintBufferPrivate::Cmd_DrawRectI:
+            pen = &painter->pen();
+            bounds = rectBounds((const QRect *)(d->ints.constData() + cmd.offset), cmd.size);
+            break;
+        case QPaintBufferPrivate::Cmd_DrawEllipseF:
+            pen = &painter->pen();
+            bounds = *(const QRectF *)(d->floats.constData() + cmd.offset);
+            break;
+        case QPaintBufferPrivate::Cmd_DrawEllipseI:
+            pen = &painter->pen();
+            bounds = QRectF(*(const QRect *)(d->ints.constData() + cmd.offset));
+            break;
+        case QPaintBufferPrivate::Cmd_FillRectBrush:
+        case QPaintBufferPrivate::Cmd_FillRectColor:
+            bounds = *(const QRectF *)(d->floats.constData() + cmd.offset);
+            break;
+        default:
+            return false;
+        }
+
+        const QTransform &transform = painter->deviceTransform();
+        if (transform.type() == QTransform::TxProject)
+            return false;
+
+        // a miter join may extend up to miterLimit() half widths beyond the
+        // outline, and cosmetic pens are sized in device pixels
+        qreal extent = 0;
+        if (pen && pen->style() != Qt::NoPen)
+            extent = qMax(pen->widthF(), qreal(1)) * qMax(pen->miterLimit(), qreal(1));
+        bounds = transform.mapRect(bounds.normalized().adjusted(-extent, -extent, extent, extent));
+        bounds.adjust(-extent - 2, -extent - 2, extent + 2, extent + 2);
+
+        // invalid bounds, from degenerate or non-finite coordinates, are
+        // added to every tile
+        *deviceBounds = bounds;
+        return bounds.isValid();
+    }
+
+    int m_width;
+    int m_tileHeight;
+    QVector<QVector<int> > m_bins;
+    QImage m_scratch;
+};
+
+static void qt_renderTiledRasterTile(QPaintBufferPrivate *recording, const QVector<int> &commands,
+                                     const QImage &target, uchar *bits, const QRect &tile)
+{
+    QImage image(bits, target.width(), target.height(), target.bytesPerLine(), target.format());
+    if (target.colorCount())
+        image.setColorTable(target.colorTable());
+    image.setDotsPerMeterX(target.dotsPerMeterX());
+    image.setDotsPerMeterY(target.dotsPerMeterY());
+    image.setDevicePixelRatio(target.devicePixelRatio());
+
+    if (tile != target.rect())
+        image.paintEngine()->setSystemClip(QRegion(tile));
+
+    QPainter painter(&image);
+    QTiledRasterReplayer replayer;
+    replayer.replay(recording, &painter, commands);
+}
+
+#ifndef QT_NO_THREAD
+/*
+  Tiles are claimed through nextTile, by the thread calling flush() as
+  well, so the rendering never waits for a pool thread to become available.
+  The job is reference counted because a pool thread may only start after
+  all tiles are done and flush() has returned.
+*/
+struct QTiledRasterJob
+{
+    QPaintBufferPrivate *recording;
+    QVector<QVector<int> > bins;
+    const QImage *target;
+    uchar *bits;
+    int tileHeight;
+    int tileCount;
+    QAtomicInt nextTile;
+    QAtomicInt ref;
+    QSemaphore tilesDone;
+
+    bool renderNextTile()
+    {
+        const int tile = nextTile.fetchAndAddRelaxed(1);
+        if (tile >= tileCount)
+            return false;
+        const int y = tile * tileHeight;
+        const QRect rect(0, y, target->width(), qMin(tileHeight, target->height() - y));
+        qt_renderTiledRasterTile(recording, bins.at(tile), *target, bits, rect);
+        tilesDone.release();
+        return true;
+    }
+
+    void deref()
+    {
+        if (!ref.deref())
+            delete this;
+    }
+};
+
+class QTiledRasterRunnable : public QRunnable
+{
+public:
+    explicit QTiledRasterRunnable(QTiledRasterJob *job) : m_job(job) { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        while (m_job->renderNextTile())
+            ;
+        m_job->deref();
+    }
+
+private:
+    QTiledRasterJob *m_job;
+};
+#endif // QT_NO_THREAD
+
+/*!
+    Constructs a device that renders into \a image, which must outlive it
+    and must not be painted on by other means while a painter is active
+    on this device.
+*/
+QTiledRasterDevice::QTiledRasterDevice(QImage *image)
+    : m_image(image), m_engine(0), m_threadCount(1), m_tileHeight(128)
+{
+    Q_ASSERT(image);
+#ifndef QT_NO_THREAD
+    m_threadCount = qMax(1, QThread::idealThreadCount());
+#endif
+    // the bounding rect of the recording is not needed
+    m_buffer.setBoundingRect(QRectF(m_image->rect()));
+}
+
+QTiledRasterDevice::~QTiledRasterDevice()
+{
+    delete m_engine;
+}
+
+/*!
+    Sets the maximum number of threads rendering tiles, including the
+    thread ending the painter, to \a threadCount. With a single thread
+    the recording is replayed on the whole image at once.
+*/
+void QTiledRasterDevice::setThreadCount(int threadCount)
+{
+    m_threadCount = qMax(1, threadCount);
+}
+
+/*!
+    Sets the number of scanlines of each tile to \a tileHeight.
+*/
+void QTiledRasterDevice::setTileHeight(int tileHeight)
+{
+    m_tileHeight = qMax(1, tileHeight);
+}
+
+QPaintEngine *QTiledRasterDevice::paintEngine() const
+{
+    if (!m_engine) {
+        QTiledRasterDevice *that = const_cast<QTiledRasterDevice *>(this);
+        m_engine = new QTiledRasterEngine(that->m_buffer.d_ptr, that);
+        that->m_buffer.d_ptr->engine = m_engine;
+    }
+    return m_engine;
+}
+
+int QTiledRasterDevice::metric(PaintDeviceMetric m) const
+{
+    switch (m) {
+    case PdmWidth:
+        return m_image->width();
+    case PdmHeight:
+        return m_image->height();
+    case PdmWidthMM:
+        return m_image->widthMM();
+    case PdmHeightMM:
+        return m_image->heightMM();
+    case PdmNumColors:
+        return m_image->colorCount();
+    case PdmDepth:
+        return m_image->depth();
+    case PdmDpiX:
+        return m_image->logicalDpiX();
+    case PdmDpiY:
+        return m_image->logicalDpiY();
+    case PdmPhysicalDpiX:
+        return m_image->physicalDpiX();
+    case PdmPhysicalDpiY:
+        return m_image->physicalDpiY();
+    case PdmDevicePixelRatio:
+        return m_image->devicePixelRatio();
+    }
+    return QPaintDevice::metric(m);
+}
+
+int QTiledRasterDevice::devType() const
+{
+    return QInternal::PaintBuffer;
+}
+
+/*!
+    \internal
+
+    Returns \c true if the recording only uses objects that can be
+    rasterized by several threads at the same time, and prepares the
+    ones that are lazily initialized.
+*/
+bool QTiledRasterDevice::canRenderInParallel() const
+{
+    const QPaintBufferPrivate *recording = m_buffer.d_ptr;
+    for (int i = 0; i < recording->commands.size(); ++i) {
+        const QPaintBufferCommand &cmd = recording->commands.at(i);
+        switch (cmd.id) {
+        case QPaintBufferPrivate::Cmd_SystemStateChanged:
+            // the tiles are clipped with the system clip
+            if (!recording->variants.at(cmd.offset).value<QRegion>().isEmpty())
+                return false;
+            break;
+        case QPaintBufferPrivate::Cmd_DrawText:
+        case QPaintBufferPrivate::Cmd_DrawTextItem:
+        case QPaintBufferPrivate::Cmd_DrawStaticText:
+        case QPaintBufferPrivate::Cmd_DrawPixmapPos:
+        case QPaintBufferPrivate::Cmd_DrawPixmapRect:
+        case QPaintBufferPrivate::Cmd_DrawTiledPixmap:
+            return false;
+        default:
+            break;
+        }
+    }
+
+    for (int i = 0; i < recording->variants.size(); ++i) {
+        const QVariant &variant = recording->variants.at(i);
+        QBrush brush;
+        if (variant.userType() == QMetaType::QBrush)
+            brush = qvariant_cast<QBrush>(variant);
+        else if (variant.userType() == QMetaType::QPen)
+            brush = qvariant_cast<QPen>(variant).brush();
+        else
+            continue;
+        if (brush.style() == Qt::TexturePattern && qHasPixmapTexture(brush))
+            return false;
+    }
+
+    // QPen creates the dash pattern of its style on first use, in data
+    // that all the copies of the pen share
+    for (int i = 0; i < recording->variants.size(); ++i) {
+        const QVariant &variant = recording->variants.at(i);
+        if (variant.userType() == QMetaType::QPen)
+            qvariant_cast<QPen>(variant).dashPattern();
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Rasterizes the recorded commands into the image and starts a new
+    recording. Called when the painter on this device ends.
+*/
+void QTiledRasterDevice::flush()
+{
+    if (!m_buffer.isEmpty() && !m_image->isNull()) {
+        // detach once, so that all the tiles share the same pixels
+        uchar *bits = m_image->bits();
+        const int commandCount = m_buffer.d_ptr->commands.size();
+        const int tileCount = (m_image->height() + m_tileHeight - 1) / m_tileHeight;
+
+#ifndef QT_NO_THREAD
+        QThreadPool *pool = QThreadPool::globalInstance();
+        if (m_threadCount > 1 && tileCount > 1 && pool && canRenderInParallel()) {
+            QTiledRasterJob *job = new QTiledRasterJob;
+            job->recording = m_buffer.d_ptr;
+            job->bins = QTiledRasterBinner(*m_image, m_tileHeight, tileCount).bin(m_buffer.d_ptr, commandCount);
+            job->target = m_image;
+            job->bits = bits;
+            job->tileHeight = m_tileHeight;
+            job->tileCount = tileCount;
+            job->ref.store(1);
+
+            const int helpers = qMin(m_threadCount, tileCount) - 1;
+            for (int i = 0; i < helpers; ++i) {
+                job->ref.ref();
+                QTiledRasterRunnable *runnable = new QTiledRasterRunnable(job);
+                if (!pool->tryStart(runnable)) {
+                    delete runnable;
+                    job->ref.deref();
+                    break;
+                }
+            }
+
+            while (job->renderNextTile())
+                ;
+            job->tilesDone.acquire(tileCount);
+            job->deref();
+        } else
+#endif
+        {
+            QVector<int> commands(commandCount);
+            for (int i = 0; i < commandCount; ++i)
+                commands[i] = i;
+            qt_renderTiledRasterTile(m_buffer.d_ptr, commands, *m_image, bits, m_image->rect());
+        }
+    }
+
+    // start the next painting with an empty recording, the old one is
+    // released when recorded goes out of scope
+    QPaintBuffer recorded;
+    qSwap(recorded.d_ptr, m_buffer.d_ptr);
+    m_buffer.setBoundingRect(QRectF(m_image->rect()));
+    m_buffer.d_ptr->engine = m_engine;
+    m_engine->buffer = m_buffer.d_ptr;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,99 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QTILEDRASTERDEVICE_P_H
+#define QTILEDRASTERDEVICE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGui/qpaintdevice.h>
+#include <private/qpaintbuffer_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QImage;
+class QTiledRasterEngine;
+
+class Q_GUI_EXPORT QTiledRasterDevice : public QPaintDevice
+{
+public:
+    explicit QTiledRasterDevice(QImage *image);
+    ~QTiledRasterDevice();
+
+    QImage *image() const { return m_image; }
+
+    void setThreadCount(int threadCount);
+    int threadCount() const { return m_threadCount; }
+
+    void setTileHeight(int tileHeight);
+    int tileHeight() const { return m_tileHeight; }
+
+    virtual QPaintEngine *paintEngine() const;
+    virtual int metric(PaintDeviceMetric m) const;
+    virtual int devType() const;
+
+private:
+    Q_DISABLE_COPY(QTiledRasterDevice)
+    friend class QTiledRasterEngine;
+
+    void flush();
+    bool canRenderInParallel() const;
+
+    QImage *m_image;
+    QPaintBuffer m_buffer;
+    mutable QTiledRasterEngine *m_engine;
+    int m_threadCount;
+    int m_tileHeight;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTILEDRASTERDEVICE_P_H
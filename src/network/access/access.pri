@@ -7,9 +7,12 @@ HEADERS += \
     access/qhttpnetworkreply_p.h \
     access/qhttpnetworkconnection_p.h \
     access/qhttpnetworkconnectionchannel_p.h \
+    access/qhttpcontentdecoder_p.h \
     access/qabstractprotocolhandler_p.h \
     access/qhttpprotocolhandler_p.h \
     access/qspdyprotocolhandler_p.h \
+    access/qhpack_p.h \
+    access/qhttp2protocolhandler_p.h \
     access/qnetworkaccessauthenticationmanager_p.h \
     access/qnetworkaccessmanager.h \
     access/qnetworkaccessmanager_p.h \
@@ -35,6 +38,8 @@ HEADERS += \
     access/qabstractnetworkcache.h \
     access/qnetworkdiskcache_p.h \
     access/qnetworkdiskcache.h \
+    access/qnetworkindexeddiskcache_p.h \
+    access/qnetworkindexeddiskcache.h \
     access/qhttpthreaddelegate_p.h \
     access/qhttpmultipart.h \
     access/qhttpmultipart_p.h
@@ -46,9 +51,12 @@ SOURCES += \
     access/qhttpnetworkreply.cpp \
     access/qhttpnetworkconnection.cpp \
     access/qhttpnetworkconnectionchannel.cpp \
+    access/qhttpcontentdecoder.cpp \
     access/qabstractprotocolhandler.cpp \
     access/qhttpprotocolhandler.cpp \
     access/qspdyprotocolhandler.cpp \
+    access/qhpack.cpp \
+    access/qhttp2protocolhandler.cpp \
     access/qnetworkaccessauthenticationmanager.cpp \
     access/qnetworkaccessmanager.cpp \
     access/qnetworkaccesscache.cpp \
@@ -67,6 +75,7 @@ SOURCES += \
     access/qnetworkreplyfileimpl.cpp \
     access/qabstractnetworkcache.cpp \
     access/qnetworkdiskcache.cpp \
+    access/qnetworkindexeddiskcache.cpp \
     access/qhttpthreaddelegate.cpp \
     access/qhttpmultipart.cpp
 
@@ -0,0 +1,594 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhpack_p.h"
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+// RFC 7541, Appendix A
+static const struct {
+    const char *name;
+    const char *value;
+} staticTable[QHpackTable::StaticTableCount] = {
+    { ":authority", "" },
+    { ":method", "GET" },
+    { ":method", "POST" },
+    { ":path", "/" },
+    { ":path", "/index.html" },
+    { ":scheme", "http" },
+    { ":scheme", "https" },
+    { ":status", "200" },
+    { ":status", "204" },
+    { ":status", "206" },
+    { ":status", "304" },
+    { ":status", "400" },
+    { ":status", "404" },
+    { ":status", "500" },
+    { "accept-charset", "" },
+    { "accept-encoding", "gzip, deflate" },
+    { "accept-language", "" },
+    { "accept-ranges", "" },
+    { "accept", "" },
+    { "access-control-allow-origin", "" },
+    { "age", "" },
+    { "allow", "" },
+    { "authorization", "" },
+    { "cache-control", "" },
+    { "content-disposition", "" },
+    { "content-encoding", "" },
+    { "content-language", "" },
+    { "content-length", "" },
+    { "content-location", "" },
+    { "content-range", "" },
+    { "content-type", "" },
+    { "cookie", "" },
+    { "date", "" },
+    { "etag", "" },
+    { "expect", "" },
+    { "expires", "" },
+    { "from", "" },
+    { "host", "" },
+    { "if-match", "" },
+    { "if-modified-since", "" },
+    { "if-none-match", "" },
+    { "if-range", "" },
+    { "if-unmodified-since", "" },
+    { "last-modified", "" },
+    { "link", "" },
+    { "location", "" },
+    { "max-forwards", "" },
+    { "proxy-authenticate", "" },
+    { "proxy-authorization", "" },
+    { "range", "" },
+    { "referer", "" },
+    { "refresh", "" },
+    { "retry-after", "" },
+    { "server", "" },
+    { "set-cookie", "" },
+    { "strict-transport-security", "" },
+    { "transfer-encoding", "" },
+    { "user-agent", "" },
+    { "vary", "" },
+    { "via", "" },
+    { "www-authenticate", "" }
+};
+
+// RFC 7541, Appendix B; the last entry is EOS
+static const struct {
+    quint32 code;
+    quint8 length;
+} huffmanCodes[257] = {
+    { 0x1ff8, 13 }, { 0x7fffd8, 23 }, { 0xfffffe2, 28 }, { 0xfffffe3, 28 },
+    { 0xfffffe4, 28 }, { 0xfffffe5, 28 }, { 0xfffffe6, 28 }, { 0xfffffe7, 28 },
+    { 0xfffffe8, 28 }, { 0xffffea, 24 }, { 0x3ffffffc, 30 }, { 0xfffffe9, 28 },
+    { 0xfffffea, 28 }, { 0x3ffffffd, 30 }, { 0xfffffeb, 28 }, { 0xfffffec, 28 },
+    { 0xfffffed, 28 }, { 0xfffffee, 28 }, { 0xfffffef, 28 }, { 0xffffff0, 28 },
+    { 0xffffff1, 28 }, { 0xffffff2, 28 }, { 0x3ffffffe, 30 }, { 0xffffff3, 28 },
+    { 0xffffff4, 28 }, { 0xffffff5, 28 }, { 0xffffff6, 28 }, { 0xffffff7, 28 },
+    { 0xffffff8, 28 }, { 0xffffff9, 28 }, { 0xffffffa, 28 }, { 0xffffffb, 28 },
+    { 0x14, 6 }, { 0x3f8, 10 }, { 0x3f9, 10 }, { 0xffa, 12 },
+    { 0x1ff9, 13 }, { 0x15, 6 }, { 0xf8, 8 }, { 0x7fa, 11 },
+    { 0x3fa, 10 }, { 0x3fb, 10 }, { 0xf9, 8 }, { 0x7fb, 11 },
+    { 0xfa, 8 }, { 0x16, 6 }, { 0x17, 6 }, { 0x18, 6 },
+    { 0x0, 5 }, { 0x1, 5 }, { 0x2, 5 }, { 0x19, 6 },
+    { 0x1a, 6 }, { 0x1b, 6 }, { 0x1c, 6 }, { 0x1d, 6 },
+    { 0x1e, 6 }, { 0x1f, 6 }, { 0x5c, 7 }, { 0xfb, 8 },
+    { 0x7ffc, 15 }, { 0x20, 6 }, { 0xffb, 12 }, { 0x3fc, 10 },
+    { 0x1ffa, 13 }, { 0x21, 6 }, { 0x5d, 7 }, { 0x5e, 7 },
+    { 0x5f, 7 }, { 0x60, 7 }, { 0x61, 7 }, { 0x62, 7 },
+    { 0x63, 7 }, { 0x64, 7 }, { 0x65, 7 }, { 0x66, 7 },
+    { 0x67, 7 }, { 0x68, 7 }, { 0x69, 7 }, { 0x6a, 7 },
+    { 0x6b, 7 }, { 0x6c, 7 }, { 0x6d, 7 }, { 0x6e, 7 },
+    { 0x6f, 7 }, { 0x70, 7 }, { 0x71, 7 }, { 0x72, 7 },
+    { 0xfc, 8 }, { 0x73, 7 }, { 0xfd, 8 }, { 0x1ffb, 13 },
+    { 0x7fff0, 19 }, { 0x1ffc, 13 }, { 0x3ffc, 14 }, { 0x22, 6 },
+    { 0x7ffd, 15 }, { 0x3, 5 }, { 0x23, 6 }, { 0x4, 5 },
+    { 0x24, 6 }, { 0x5, 5 }, { 0x25, 6 }, { 0x26, 6 },
+    { 0x27, 6 }, { 0x6, 5 }, { 0x74, 7 }, { 0x75, 7 },
+    { 0x28, 6 }, { 0x29, 6 }, { 0x2a, 6 }, { 0x7, 5 },
+    { 0x2b, 6 }, { 0x76, 7 }, { 0x2c, 6 }, { 0x8, 5 },
+    { 0x9, 5 }, { 0x2d, 6 }, { 0x77, 7 }, { 0x78, 7 },
+    { 0x79, 7 }, { 0x7a, 7 }, { 0x7b, 7 }, { 0x7ffe, 15 },
+    { 0x7fc, 11 }, { 0x3ffd, 14 }, { 0x1ffd, 13 }, { 0xffffffc, 28 },
+    { 0xfffe6, 20 }, { 0x3fffd2, 22 }, { 0xfffe7, 20 }, { 0xfffe8, 20 },
+    { 0x3fffd3, 22 }, { 0x3fffd4, 22 }, { 0x3fffd5, 22 }, { 0x7fffd9, 23 },
+    { 0x3fffd6, 22 }, { 0x7fffda, 23 }, { 0x7fffdb, 23 }, { 0x7fffdc, 23 },
+    { 0x7fffdd, 23 }, { 0x7fffde, 23 }, { 0xffffeb, 24 }, { 0x7fffdf, 23 },
+    { 0xffffec, 24 }, { 0xffffed, 24 }, { 0x3fffd7, 22 }, { 0x7fffe0, 23 },
+    { 0xffffee, 24 }, { 0x7fffe1, 23 }, { 0x7fffe2, 23 }, { 0x7fffe3, 23 },
+    { 0x7fffe4, 23 }, { 0x1fffdc, 21 }, { 0x3fffd8, 22 }, { 0x7fffe5, 23 },
+    { 0x3fffd9, 22 }, { 0x7fffe6, 23 }, { 0x7fffe7, 23 }, { 0xffffef, 24 },
+    { 0x3fffda, 22 }, { 0x1fffdd, 21 }, { 0xfffe9, 20 }, { 0x3fffdb, 22 },
+    { 0x3fffdc, 22 }, { 0x7fffe8, 23 }, { 0x7fffe9, 23 }, { 0x1fffde, 21 },
+    { 0x7fffea, 23 }, { 0x3fffdd, 22 }, { 0x3fffde, 22 }, { 0xfffff0, 24 },
+    { 0x1fffdf, 21 }, { 0x3fffdf, 22 }, { 0x7fffeb, 23 }, { 0x7fffec, 23 },
+    { 0x1fffe0, 21 }, { 0x1fffe1, 21 }, { 0x3fffe0, 22 }, { 0x1fffe2, 21 },
+    { 0x7fffed, 23 }, { 0x3fffe1, 22 }, { 0x7fffee, 23 }, { 0x7fffef, 23 },
+    { 0xfffea, 20 }, { 0x3fffe2, 22 }, { 0x3fffe3, 22 }, { 0x3fffe4, 22 },
+    { 0x7ffff0, 23 }, { 0x3fffe5, 22 }, { 0x3fffe6, 22 }, { 0x7ffff1, 23 },
+    { 0x3ffffe0, 26 }, { 0x3ffffe1, 26 }, { 0xfffeb, 20 }, { 0x7fff1, 19 },
+    { 0x3fffe7, 22 }, { 0x7ffff2, 23 }, { 0x3fffe8, 22 }, { 0x1ffffec, 25 },
+    { 0x3ffffe2, 26 }, { 0x3ffffe3, 26 }, { 0x3ffffe4, 26 }, { 0x7ffffde, 27 },
+    { 0x7ffffdf, 27 }, { 0x3ffffe5, 26 }, { 0xfffff1, 24 }, { 0x1ffffed, 25 },
+    { 0x7fff2, 19 }, { 0x1fffe3, 21 }, { 0x3ffffe6, 26 }, { 0x7ffffe0, 27 },
+    { 0x7ffffe1, 27 }, { 0x3ffffe7, 26 }, { 0x7ffffe2, 27 }, { 0xfffff2, 24 },
+    { 0x1fffe4, 21 }, { 0x1fffe5, 21 }, { 0x3ffffe8, 26 }, { 0x3ffffe9, 26 },
+    { 0xffffffd, 28 }, { 0x7ffffe3, 27 }, { 0x7ffffe4, 27 }, { 0x7ffffe5, 27 },
+    { 0xfffec, 20 }, { 0xfffff3, 24 }, { 0xfffed, 20 }, { 0x1fffe6, 21 },
+    { 0x3fffe9, 22 }, { 0x1fffe7, 21 }, { 0x1fffe8, 21 }, { 0x7ffff3, 23 },
+    { 0x3fffea, 22 }, { 0x3fffeb, 22 }, { 0x1ffffee, 25 }, { 0x1ffffef, 25 },
+    { 0xfffff4, 24 }, { 0xfffff5, 24 }, { 0x3ffffea, 26 }, { 0x7ffff4, 23 },
+    { 0x3ffffeb, 26 }, { 0x7ffffe6, 27 }, { 0x3ffffec, 26 }, { 0x3ffffed, 26 },
+    { 0x7ffffe7, 27 }, { 0x7ffffe8, 27 }, { 0x7ffffe9, 27 }, { 0x7ffffea, 27 },
+    { 0x7ffffeb, 27 }, { 0xffffffe, 28 }, { 0x7ffffec, 27 }, { 0x7ffffed, 27 },
+    { 0x7ffffee, 27 }, { 0x7ffffef, 27 }, { 0x7fffff0, 27 }, { 0x3ffffee, 26 },
+    { 0x3fffffff, 30 }
+};
+
+static const quint16 huffmanDecodeSymbols[257] = {
+    48, 49, 50, 97, 99, 101, 105, 111, 115, 116, 32, 37,
+    45, 46, 47, 51, 52, 53, 54, 55, 56, 57, 61, 65,
+    95, 98, 100, 102, 103, 104, 108, 109, 110, 112, 114, 117,
+    58, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76,
+    77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 89,
+    106, 107, 113, 118, 119, 120, 121, 122, 38, 42, 44, 59,
+    88, 90, 33, 34, 40, 41, 63, 39, 43, 124, 35, 62,
+    0, 36, 64, 91, 93, 126, 94, 125, 60, 96, 123, 92,
+    195, 208, 128, 130, 131, 162, 184, 194, 224, 226, 153, 161,
+    167, 172, 176, 177, 179, 209, 216, 217, 227, 229, 230, 129,
+    132, 133, 134, 136, 146, 154, 156, 160, 163, 164, 169, 170,
+    173, 178, 181, 185, 186, 187, 189, 190, 196, 198, 228, 232,
+    233, 1, 135, 137, 138, 139, 140, 141, 143, 147, 149, 150,
+    151, 152, 155, 157, 158, 165, 166, 168, 174, 175, 180, 182,
+    183, 188, 191, 197, 231, 239, 9, 142, 144, 145, 148, 159,
+    171, 206, 215, 225, 236, 237, 199, 207, 234, 235, 192, 193,
+    200, 201, 202, 205, 210, 213, 218, 219, 238, 240, 242, 243,
+    255, 203, 204, 211, 212, 214, 221, 222, 223, 241, 244, 245,
+    246, 247, 248, 250, 251, 252, 253, 254, 2, 3, 4, 5,
+    6, 7, 8, 11, 12, 14, 15, 16, 17, 18, 19, 20,
+    21, 23, 24, 25, 26, 27, 28, 29, 30, 31, 127, 220,
+    249, 10, 13, 22, 256
+};
+
+static const struct {
+    quint64 limit;
+    quint32 firstCode;
+    quint16 offset;
+    quint8 length;
+} huffmanDecodeLengths[] = {
+    { Q_UINT64_C(0x50000000), 0x0, 0, 5 },
+    { Q_UINT64_C(0xb8000000), 0x14, 10, 6 },
+    { Q_UINT64_C(0xf8000000), 0x5c, 36, 7 },
+    { Q_UINT64_C(0xfe000000), 0xf8, 68, 8 },
+    { Q_UINT64_C(0xff400000), 0x3f8, 74, 10 },
+    { Q_UINT64_C(0xffa00000), 0x7fa, 79, 11 },
+    { Q_UINT64_C(0xffc00000), 0xffa, 82, 12 },
+    { Q_UINT64_C(0xfff00000), 0x1ff8, 84, 13 },
+    { Q_UINT64_C(0xfff80000), 0x3ffc, 90, 14 },
+    { Q_UINT64_C(0xfffe0000), 0x7ffc, 92, 15 },
+    { Q_UINT64_C(0xfffe6000), 0x7fff0, 95, 19 },
+    { Q_UINT64_C(0xfffee000), 0xfffe6, 98, 20 },
+    { Q_UINT64_C(0xffff4800), 0x1fffdc, 106, 21 },
+    { Q_UINT64_C(0xffffb000), 0x3fffd2, 119, 22 },
+    { Q_UINT64_C(0xffffea00), 0x7fffd8, 145, 23 },
+    { Q_UINT64_C(0xfffff600), 0xffffea, 174, 24 },
+    { Q_UINT64_C(0xfffff800), 0x1ffffec, 186, 25 },
+    { Q_UINT64_C(0xfffffbc0), 0x3ffffe0, 190, 26 },
+    { Q_UINT64_C(0xfffffe20), 0x7ffffde, 205, 27 },
+    { Q_UINT64_C(0xfffffff0), 0xfffffe2, 224, 28 },
+    { Q_UINT64_C(0x100000000), 0x3ffffffc, 253, 30 }
+};
+
+/*
+    The Huffman code is canonical: codes of the same length are consecutive
+    numbers and every length continues where the previous one left off. So
+    the length of the next code is the first one whose limit is above the
+    next 32 input bits, and its symbol is found by the distance from the
+    first code of that length.
+*/
+
+static quint32 huffmanEncodedSize(const QByteArray &string)
+{
+    quint64 bits = 0;
+    for (int i = 0; i < string.size(); ++i)
+        bits += huffmanCodes[uchar(string.at(i))].length;
+    return quint32((bits + 7) / 8);
+}
+
+static void huffmanEncode(QByteArray *out, const QByteArray &string)
+{
+    quint64 buffer = 0;
+    int bufferedBits = 0;
+    for (int i = 0; i < string.size(); ++i) {
+        const uchar c = string.at(i);
+        buffer = (buffer << huffmanCodes[c].length) | huffmanCodes[c].code;
+        bufferedBits += huffmanCodes[c].length;
+        while (bufferedBits >= 8) {
+            bufferedBits -= 8;
+            out->append(char(buffer >> bufferedBits));
+        }
+    }
+    // pad with the most significant bits of EOS, i.e. with ones
+    if (bufferedBits)
+        out->append(char((buffer << (8 - bufferedBits)) | (0xff >> bufferedBits)));
+}
+
+static bool huffmanDecode(const uchar *data, quint32 size, QByteArray *out)
+{
+    const uchar *end = data + size;
+    out->clear();
+    out->reserve(size * 8 / 5);
+
+    quint64 buffer = 0;
+    int bufferedBits = 0;
+    for (;;) {
+        while (bufferedBits <= 56 && data != end) {
+            buffer = (buffer << 8) | *data++;
+            bufferedBits += 8;
+        }
+        if (!bufferedBits)
+            return true;
+
+        // the next 32 bits, padded with ones past the end of the input
+        quint64 window;
+        if (bufferedBits >= 32)
+            window = (buffer >> (bufferedBits - 32)) & 0xffffffff;
+        else
+            window = ((buffer << (32 - bufferedBits)) | ((quint64(1) << (32 - bufferedBits)) - 1)) & 0xffffffff;
+
+        int i = 0;
+        while (window >= huffmanDecodeLengths[i].limit)
+            ++i;
+        const int length = huffmanDecodeLengths[i].length;
+        if (length > bufferedBits) {
+            // only padding is left: less than a byte of the EOS prefix
+            const quint64 mask = (quint64(1) << bufferedBits) - 1;
+            return bufferedBits < 8 && (buffer & mask) == mask;
+        }
+
+        const quint32 code = quint32(window >> (32 - length));
+        const quint16 symbol = huffmanDecodeSymbols[huffmanDecodeLengths[i].offset
+                                                    + code - huffmanDecodeLengths[i].firstCode];
+        if (symbol == 256) // EOS must not be encoded
+            return false;
+        out->append(char(symbol));
+        bufferedBits -= length;
+    }
+}
+
+// RFC 7541, section 5.1
+static void appendInteger(QByteArray *out, uchar flags, int prefixBits, quint32 value)
+{
+    const quint32 prefixMax = (1u << prefixBits) - 1;
+    if (value < prefixMax) {
+        out->append(char(flags | value));
+        return;
+    }
+    out->append(char(flags | prefixMax));
+    value -= prefixMax;
+    while (value >= 0x80) {
+        out->append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out->append(char(value));
+}
+
+static bool readInteger(const uchar *&pos, const uchar *end, int prefixBits, quint32 *value)
+{
+    if (pos == end)
+        return false;
+    const quint32 prefixMax = (1u << prefixBits) - 1;
+    quint64 result = *pos++ & prefixMax;
+    if (result < prefixMax) {
+        *value = quint32(result);
+        return true;
+    }
+    for (int shift = 0; pos != end && shift <= 28; shift += 7) {
+        const uchar byte = *pos++;
+        result += quint64(byte & 0x7f) << shift;
+        if (result > 0xffffffff)
+            return false;
+        if (!(byte & 0x80)) {
+            *value = quint32(result);
+            return true;
+        }
+    }
+    return false;
+}
+
+// RFC 7541, section 5.2
+static void appendString(QByteArray *out, const QByteArray &string)
+{
+    const quint32 huffmanSize = huffmanEncodedSize(string);
+    if (huffmanSize < quint32(string.size())) {
+        appendInteger(out, 0x80, 7, huffmanSize);
+        huffmanEncode(out, string);
+    } else {
+        appendInteger(out, 0, 7, string.size());
+        out->append(string);
+    }
+}
+
+static bool readString(const uchar *&pos, const uchar *end, QByteArray *string)
+{
+    if (pos == end)
+        return false;
+    const bool huffman = *pos & 0x80;
+    quint32 length;
+    if (!readInteger(pos, end, 7, &length) || length > quint32(end - pos))
+        return false;
+    if (huffman) {
+        if (!huffmanDecode(pos, length, string))
+            return false;
+    } else {
+        *string = QByteArray(reinterpret_cast<const char *>(pos), length);
+    }
+    pos += length;
+    return true;
+}
+
+
+QHpackTable::QHpackTable(quint32 maxSize)
+    : currentSize(0), maxTableSize(maxSize)
+{
+}
+
+void QHpackTable::setMaxSize(quint32 size)
+{
+    maxTableSize = size;
+    evict(0);
+}
+
+bool QHpackTable::field(quint32 index, QByteArray *name, QByteArray *value) const
+{
+    if (index == 0 || index > quint32(count()))
+        return false;
+    if (index <= StaticTableCount) {
+        *name = staticTable[index - 1].name;
+        *value = staticTable[index - 1].value;
+    } else {
+        const QHpackHeaderField &entry = entries.at(index - StaticTableCount - 1);
+        *name = entry.first;
+        *value = entry.second;
+    }
+    return true;
+}
+
+// Returns the index of an entry matching both \a name and \a value or, if
+// there is none, of the first one matching \a name; 0 if there is neither.
+quint32 QHpackTable::indexOf(const QByteArray &name, const QByteArray &value, bool *valueMatches) const
+{
+    quint32 nameIndex = 0;
+    for (int i = 0; i < StaticTableCount; ++i) {
+        if (name != staticTable[i].name)
+            continue;
+        if (value == staticTable[i].value) {
+            *valueMatches = true;
+            return i + 1;
+        }
+        if (!nameIndex)
+            nameIndex = i + 1;
+    }
+    for (int i = 0; i < entries.count(); ++i) {
+        const QHpackHeaderField &entry = entries.at(i);
+        if (entry.first != name)
+            continue;
+        if (entry.second == value) {
+            *valueMatches = true;
+            return StaticTableCount + i + 1;
+        }
+        if (!nameIndex)
+            nameIndex = StaticTableCount + i + 1;
+    }
+    *valueMatches = false;
+    return nameIndex;
+}
+
+void QHpackTable::insert(const QByteArray &name, const QByteArray &value)
+{
+    const quint32 size = entrySize(name, value);
+    if (size > maxTableSize) {
+        // not an error; the entry just empties the table (RFC 7541, section 4.4)
+        entries.clear();
+        currentSize = 0;
+        return;
+    }
+    evict(size);
+    entries.prepend(qMakePair(name, value));
+    currentSize += size;
+}
+
+void QHpackTable::evict(quint32 requiredSpace)
+{
+    while (!entries.isEmpty() && currentSize + requiredSpace > maxTableSize) {
+        const QHpackHeaderField &entry = entries.last();
+        currentSize -= entrySize(entry.first, entry.second);
+        entries.removeLast();
+    }
+}
+
+
+QHpackEncoder::QHpackEncoder(quint32 maxTableSize)
+    : table(maxTableSize), smallestPendingSize(maxTableSize), tableSizeChanged(false)
+{
+}
+
+void QHpackEncoder::setMaxTableSize(quint32 size)
+{
+    // a larger table than the default only costs us memory
+    size = qMin<quint32>(size, QHpackTable::DefaultMaxSize);
+    if (size == table.maxSize())
+        return;
+
+    // if the size went down and up again before the next header block,
+    // the decoder has to see the smallest size first (RFC 7541, section 4.2)
+    smallestPendingSize = tableSizeChanged ? qMin(smallestPendingSize, size) : size;
+    tableSizeChanged = true;
+    table.setMaxSize(size);
+}
+
+QByteArray QHpackEncoder::encode(const QHpackHeaderList &fields)
+{
+    QByteArray block;
+    block.reserve(fields.count() * 16);
+
+    if (tableSizeChanged) {
+        if (smallestPendingSize < table.maxSize())
+            appendInteger(&block, 0x20, 5, smallestPendingSize);
+        appendInteger(&block, 0x20, 5, table.maxSize());
+        tableSizeChanged = false;
+    }
+
+    for (int i = 0; i < fields.count(); ++i)
+        encodeField(&block, fields.at(i).first, fields.at(i).second);
+    return block;
+}
+
+void QHpackEncoder::encodeField(QByteArray *out, const QByteArray &name, const QByteArray &value)
+{
+    bool valueMatches = false;
+    const quint32 index = table.indexOf(name, value, &valueMatches);
+    if (valueMatches) {
+        appendInteger(out, 0x80, 7, index);
+        return;
+    }
+
+    if (name == "authorization" || name == "proxy-authorization") {
+        // credentials are never indexed, not even by intermediaries
+        appendInteger(out, 0x10, 4, index);
+    } else if (name == ":path" || name == "content-length") {
+        // these rarely repeat and would only push useful entries out of the table
+        appendInteger(out, 0x00, 4, index);
+    } else {
+        appendInteger(out, 0x40, 6, index);
+        table.insert(name, value);
+    }
+    if (!index)
+        appendString(out, name);
+    appendString(out, value);
+}
+
+
+QHpackDecoder::QHpackDecoder(quint32 maxTableSize, quint32 maxHeaderListSize)
+    : table(maxTableSize), maxAllowedTableSize(maxTableSize), maxHeaderListSize(maxHeaderListSize)
+{
+}
+
+QHpackDecoder::DecodeResult QHpackDecoder::decode(const QByteArray &block, QHpackHeaderList *fields)
+{
+    const uchar *pos = reinterpret_cast<const uchar *>(block.constData());
+    const uchar *end = pos + block.size();
+    bool fieldDecoded = false;
+    // a few bytes referring to a large table entry over and over again
+    // would otherwise expand into any amount of memory
+    quint64 headerListSize = 0;
+
+    while (pos != end) {
+        const uchar firstByte = *pos;
+        QByteArray name;
+        QByteArray value;
+
+        if (firstByte & 0x80) {
+            // indexed header field
+            quint32 index;
+            if (!readInteger(pos, end, 7, &index) || !table.field(index, &name, &value))
+                return Malformed;
+        } else if ((firstByte & 0xe0) == 0x20) {
+            // dynamic table size update, only allowed before the first field
+            quint32 size;
+            if (fieldDecoded || !readInteger(pos, end, 5, &size) || size > maxAllowedTableSize)
+                return Malformed;
+            table.setMaxSize(size);
+            continue;
+        } else {
+            // literal with incremental indexing, without indexing or never indexed
+            const bool indexing = firstByte & 0x40;
+            quint32 index;
+            if (!readInteger(pos, end, indexing ? 6 : 4, &index))
+                return Malformed;
+            if (index) {
+                QByteArray indexedValue;
+                if (!table.field(index, &name, &indexedValue))
+                    return Malformed;
+            } else if (!readString(pos, end, &name)) {
+                return Malformed;
+            }
+            if (!readString(pos, end, &value))
+                return Malformed;
+            if (indexing)
+                table.insert(name, value);
+        }
+
+        headerListSize += QHpackTable::entrySize(name, value);
+        if (maxHeaderListSize && headerListSize > maxHeaderListSize)
+            return HeaderListTooLarge;
+        fields->append(qMakePair(name, value));
+        fieldDecoded = true;
+    }
+    return Decoded;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
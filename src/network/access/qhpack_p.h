@@ -0,0 +1,148 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QHPACK_P_H
+#define QHPACK_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qpair.h>
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+// HPACK header compression for HTTP/2 (RFC 7541)
+
+typedef QPair<QByteArray, QByteArray> QHpackHeaderField;
+typedef QList<QHpackHeaderField> QHpackHeaderList;
+
+// The static table followed by the dynamic table, addressed with the
+// 1-based indices used on the wire.
+class Q_AUTOTEST_EXPORT QHpackTable
+{
+public:
+    enum {
+        StaticTableCount = 61,
+        DefaultMaxSize = 4096,
+        EntryOverhead = 32
+    };
+
+    explicit QHpackTable(quint32 maxSize = DefaultMaxSize);
+
+    quint32 size() const { return currentSize; }
+    quint32 maxSize() const { return maxTableSize; }
+    void setMaxSize(quint32 size);
+
+    int count() const { return StaticTableCount + entries.count(); }
+    bool field(quint32 index, QByteArray *name, QByteArray *value) const;
+    quint32 indexOf(const QByteArray &name, const QByteArray &value, bool *valueMatches) const;
+    void insert(const QByteArray &name, const QByteArray &value);
+
+    static quint32 entrySize(const QByteArray &name, const QByteArray &value)
+    { return name.size() + value.size() + EntryOverhead; }
+
+private:
+    void evict(quint32 requiredSpace);
+
+    QHpackHeaderList entries; // most recently inserted first
+    quint32 currentSize;
+    quint32 maxTableSize;
+};
+
+class Q_AUTOTEST_EXPORT QHpackEncoder
+{
+public:
+    explicit QHpackEncoder(quint32 maxTableSize = QHpackTable::DefaultMaxSize);
+
+    // the table size the peer allows us to use (SETTINGS_HEADER_TABLE_SIZE);
+    // the change is signalled at the start of the next header block
+    void setMaxTableSize(quint32 size);
+    QByteArray encode(const QHpackHeaderList &fields);
+
+private:
+    void encodeField(QByteArray *out, const QByteArray &name, const QByteArray &value);
+
+    QHpackTable table;
+    quint32 smallestPendingSize;
+    bool tableSizeChanged;
+};
+
+class Q_AUTOTEST_EXPORT QHpackDecoder
+{
+public:
+    enum DecodeResult {
+        Decoded,
+        // the connection must be terminated after either error, as the
+        // rest of the block is not decoded and the table state is lost
+        Malformed,
+        HeaderListTooLarge
+    };
+
+    // maxHeaderListSize limits the size of a decoded block, counted as in
+    // SETTINGS_MAX_HEADER_LIST_SIZE; 0 means no limit
+    explicit QHpackDecoder(quint32 maxTableSize = QHpackTable::DefaultMaxSize,
+                           quint32 maxHeaderListSize = 0);
+
+    DecodeResult decode(const QByteArray &block, QHpackHeaderList *fields);
+
+private:
+    QHpackTable table;
+    quint32 maxAllowedTableSize;
+    quint32 maxHeaderListSize;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
+
+#endif // QHPACK_P_H
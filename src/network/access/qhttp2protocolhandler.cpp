@@ -0,0 +1,986 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <private/qhttp2protocolhandler_p.h>
+#include <private/qnoncontiguousbytedevice_p.h>
+#include <private/qhttpnetworkconnectionchannel_p.h>
+#include <QtCore/QtEndian>
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+static const char connectionPreface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+// The HTTP/2 weight (1 to 256) of a stream, derived from the priority level
+// which also orders the queued requests: HighPriority gets 256, NormalPriority
+// 64 and LowPriority 16.
+static int streamWeight(const QHttpNetworkRequest &request)
+{
+    const int level = request.priorityLevel();
+    if (level <= 1)
+        return 256;
+    if (level >= 9)
+        return 1;
+    return 256 >> (level - 1);
+}
+
+QHttp2ProtocolHandler::QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *channel)
+    : QObject(0), QAbstractProtocolHandler(channel),
+      m_nextStreamID(1),
+      m_maxConcurrentStreams(100), // until the server tells us its limit
+      m_maxFrameSize(DefaultMaxFrameSize),
+      m_initialSendWindow(DefaultWindowSize),
+      m_sessionSendWindow(DefaultWindowSize),
+      m_sessionRecvWindow(SessionReceiveWindow),
+      m_prefaceSent(false),
+      m_goingAway(false),
+      m_decoder(QHpackTable::DefaultMaxSize, MaxHeaderListSize),
+      m_continuedStreamID(0),
+      m_continuedEndStream(false),
+      m_inputOffset(0)
+{
+}
+
+QHttp2ProtocolHandler::~QHttp2ProtocolHandler()
+{
+}
+
+bool QHttp2ProtocolHandler::sendRequest()
+{
+    Q_ASSERT(!m_reply);
+
+    if (!m_prefaceSent)
+        sendConnectionPreface();
+
+    QMultiMap<int, HttpMessagePair> &queue = m_channel->spdyRequestsToSend;
+    while (!m_goingAway && !queue.isEmpty()
+           && quint32(m_streams.count()) < m_maxConcurrentStreams) {
+        if (m_nextStreamID > quint32(MaxWindowSize)) {
+            // out of stream IDs, the rest has to go over a new connection
+            m_goingAway = true;
+            break;
+        }
+        // within a priority QMultiMap returns the most recently queued
+        // request first, so take them from the back to keep their order
+        QMultiMap<int, HttpMessagePair>::iterator it = queue.upperBound(queue.firstKey());
+        --it;
+        const HttpMessagePair pair = it.value();
+        queue.erase(it);
+        startStream(pair);
+    }
+
+    flush();
+    return true;
+}
+
+void QHttp2ProtocolHandler::_q_receiveReply()
+{
+    Q_ASSERT(m_socket);
+
+    if (!m_prefaceSent)
+        sendConnectionPreface();
+
+    // take everything the socket has in one read and handle all complete
+    // frames in it; an incomplete frame stays in the buffer for next time
+    const qint64 available = m_socket->bytesAvailable();
+    if (available > 0) {
+        const int oldSize = m_inputBuffer.size();
+        m_inputBuffer.resize(oldSize + available);
+        const qint64 haveRead = m_socket->read(m_inputBuffer.data() + oldSize, available);
+        m_inputBuffer.resize(oldSize + qMax<qint64>(haveRead, 0));
+        if (haveRead > 0)
+            m_connection->d_func()->statistics.bytesReceived += haveRead;
+    }
+
+    while (m_inputBuffer.size() - m_inputOffset >= FrameHeaderSize) {
+        const uchar *header = reinterpret_cast<const uchar *>(m_inputBuffer.constData()) + m_inputOffset;
+        const quint32 length = qFromBigEndian<quint32>(header) >> 8;
+        // we never raise SETTINGS_MAX_FRAME_SIZE above its default
+        if (length > DefaultMaxFrameSize) {
+            connectionError(ErrorCode_FRAME_SIZE_ERROR, "Server sent an oversized frame");
+            return;
+        }
+        if (quint32(m_inputBuffer.size() - m_inputOffset) < FrameHeaderSize + length)
+            break;
+
+        const FrameType type = FrameType(header[3]);
+        const uchar flags = header[4];
+        const quint32 streamID = qFromBigEndian<quint32>(header + 5) & 0x7fffffff;
+        m_inputOffset += FrameHeaderSize + length;
+        if (!handleFrame(type, flags, streamID, header + FrameHeaderSize, length))
+            return;
+    }
+
+    if (m_inputOffset == m_inputBuffer.size()) {
+        m_inputBuffer.clear();
+        m_inputOffset = 0;
+    } else if (m_inputOffset > 0) {
+        m_inputBuffer.remove(0, m_inputOffset);
+        m_inputOffset = 0;
+    }
+
+    for (QHash<quint32, Stream>::iterator it = m_streams.begin(); it != m_streams.end(); ++it)
+        updateReceiveWindow(it.key(), *it);
+
+    continueAfterPass();
+}
+
+void QHttp2ProtocolHandler::_q_readyRead()
+{
+    // also called through QHttpNetworkConnectionPrivate::readMoreLater(),
+    // when a reply's reader caught up and its window may be reopened
+    _q_receiveReply();
+}
+
+void QHttp2ProtocolHandler::handleConnectionClosure(QNetworkReply::NetworkError errorCode,
+                                                    const QString &errorString)
+{
+    m_goingAway = true;
+    m_inputBuffer.clear();
+    m_inputOffset = 0;
+    m_outputBuffer.clear();
+
+    const QList<quint32> streamIDs = m_streams.keys();
+    for (int i = 0; i < streamIDs.count(); ++i) {
+        if (m_streams.contains(streamIDs.at(i)))
+            replyFinishedWithError(streamIDs.at(i), errorCode, errorString);
+    }
+}
+
+void QHttp2ProtocolHandler::_q_uploadDataReadyRead()
+{
+    // the signal is queued, the device may be gone with its finished stream
+    QNonContiguousByteDevice *device = qobject_cast<QNonContiguousByteDevice *>(sender());
+    if (!device)
+        return;
+    uploadData(device->property("HTTP2StreamID").toUInt());
+    flush();
+}
+
+void QHttp2ProtocolHandler::_q_replyDestroyed(QObject *reply)
+{
+    const quint32 streamID = reply->property("HTTP2StreamID").toUInt();
+    QHash<quint32, Stream>::iterator it = m_streams.find(streamID);
+    if (it == m_streams.end())
+        return;
+
+    if (QNonContiguousByteDevice *device = it->request.uploadByteDevice())
+        device->disconnect(this);
+    m_streams.erase(it);
+    appendRST_STREAM(streamID, ErrorCode_CANCEL);
+    continueAfterPass();
+}
+
+void QHttp2ProtocolHandler::sendConnectionPreface()
+{
+    m_outputBuffer.append(connectionPreface, sizeof(connectionPreface) - 1);
+
+    // we do not take pushed streams, let the server send more than the
+    // default 64K per stream before it has to wait for us, and tell it how
+    // much header data we are willing to take
+    uchar settings[18];
+    qToBigEndian<quint16>(Settings_ENABLE_PUSH, settings);
+    qToBigEndian<quint32>(0, settings + 2);
+    qToBigEndian<quint16>(Settings_INITIAL_WINDOW_SIZE, settings + 6);
+    qToBigEndian<quint32>(StreamReceiveWindow, settings + 8);
+    qToBigEndian<quint16>(Settings_MAX_HEADER_LIST_SIZE, settings + 12);
+    qToBigEndian<quint32>(MaxHeaderListSize, settings + 14);
+    appendFrameHeader(sizeof(settings), FrameType_SETTINGS, 0, 0);
+    m_outputBuffer.append(reinterpret_cast<const char *>(settings), sizeof(settings));
+
+    // the connection window can only be changed by a WINDOW_UPDATE
+    appendWINDOW_UPDATE(0, SessionReceiveWindow - DefaultWindowSize);
+    m_prefaceSent = true;
+}
+
+void QHttp2ProtocolHandler::flush()
+{
+    // everything produced while handling a batch of frames or requests goes
+    // out in a single write
+    if (m_outputBuffer.isEmpty())
+        return;
+    m_socket->write(m_outputBuffer);
+    m_connection->d_func()->statistics.bytesSent += m_outputBuffer.size();
+    m_outputBuffer.clear();
+}
+
+void QHttp2ProtocolHandler::continueAfterPass()
+{
+    if (m_goingAway) {
+        flush();
+        // once the remaining streams are done the channel reconnects for
+        // whatever is still queued
+        if (m_streams.isEmpty() && m_socket->state() == QAbstractSocket::ConnectedState)
+            m_channel->close();
+    } else {
+        sendRequest();
+    }
+}
+
+void QHttp2ProtocolHandler::appendFrameHeader(quint32 length, FrameType type, uchar flags,
+                                              quint32 streamID)
+{
+    uchar header[FrameHeaderSize];
+    qToBigEndian<quint32>((length << 8) | type, header);
+    header[4] = flags;
+    qToBigEndian<quint32>(streamID, header + 5);
+    m_outputBuffer.append(reinterpret_cast<const char *>(header), FrameHeaderSize);
+}
+
+void QHttp2ProtocolHandler::appendHeaderBlock(quint32 streamID, const QByteArray &block,
+                                              bool endStream, int weight)
+{
+    // the first fragment goes into a HEADERS frame which also carries the
+    // stream's weight, the rest into CONTINUATION frames
+    const quint32 priorityLength = 5;
+    const quint32 blockSize = block.size();
+    quint32 fragment = qMin(blockSize, m_maxFrameSize - priorityLength);
+
+    uchar flags = FrameFlag_PRIORITY;
+    if (endStream)
+        flags |= FrameFlag_END_STREAM;
+    if (fragment == blockSize)
+        flags |= FrameFlag_END_HEADERS;
+    appendFrameHeader(priorityLength + fragment, FrameType_HEADERS, flags, streamID);
+
+    // not exclusive, depending on the root
+    const char priority[priorityLength] = { 0, 0, 0, 0, char(weight - 1) };
+    m_outputBuffer.append(priority, priorityLength);
+    m_outputBuffer.append(block.constData(), fragment);
+
+    for (quint32 offset = fragment; offset < blockSize; offset += fragment) {
+        fragment = qMin(blockSize - offset, m_maxFrameSize);
+        appendFrameHeader(fragment, FrameType_CONTINUATION,
+                          offset + fragment == blockSize ? FrameFlag_END_HEADERS : 0, streamID);
+        m_outputBuffer.append(block.constData() + offset, fragment);
+    }
+}
+
+void QHttp2ProtocolHandler::appendRST_STREAM(quint32 streamID, ErrorCode errorCode)
+{
+    uchar payload[4];
+    qToBigEndian<quint32>(errorCode, payload);
+    appendFrameHeader(sizeof(payload), FrameType_RST_STREAM, 0, streamID);
+    m_outputBuffer.append(reinterpret_cast<const char *>(payload), sizeof(payload));
+}
+
+void QHttp2ProtocolHandler::appendWINDOW_UPDATE(quint32 streamID, quint32 increment)
+{
+    uchar payload[4];
+    qToBigEndian<quint32>(increment, payload);
+    appendFrameHeader(sizeof(payload), FrameType_WINDOW_UPDATE, 0, streamID);
+    m_outputBuffer.append(reinterpret_cast<const char *>(payload), sizeof(payload));
+}
+
+void QHttp2ProtocolHandler::appendGOAWAY(ErrorCode errorCode)
+{
+    // we never accept streams from the server, so the last one is always 0
+    uchar payload[8];
+    qToBigEndian<quint32>(0, payload);
+    qToBigEndian<quint32>(errorCode, payload + 4);
+    appendFrameHeader(sizeof(payload), FrameType_GOAWAY, 0, 0);
+    m_outputBuffer.append(reinterpret_cast<const char *>(payload), sizeof(payload));
+}
+
+void QHttp2ProtocolHandler::startStream(const HttpMessagePair &pair)
+{
+    const QHttpNetworkRequest &request = pair.first;
+    QHttpNetworkReply *reply = pair.second;
+    const quint32 streamID = m_nextStreamID;
+    m_nextStreamID += 2; // streams initiated by the client are odd
+
+    reply->setHttp2WasUsed(true);
+    reply->setProperty("HTTP2StreamID", streamID);
+    reply->setRequest(request);
+    reply->d_func()->connection = m_connection;
+    reply->d_func()->connectionChannel = m_channel;
+    reply->d_func()->autoDecompress = request.d->autoDecompress;
+    connect(reply, SIGNAL(destroyed(QObject*)), this, SLOT(_q_replyDestroyed(QObject*)));
+
+    QNonContiguousByteDevice *uploadDevice = request.uploadByteDevice();
+    const bool hasBody = uploadDevice && request.contentLength() != 0;
+
+    Stream &stream = m_streams[streamID];
+    stream.request = request;
+    stream.reply = reply;
+    stream.sendWindow = m_initialSendWindow;
+    stream.recvWindow = StreamReceiveWindow;
+    stream.localClosed = !hasBody;
+    stream.headersReceived = false;
+    m_channel->requestStarted(reply, m_streams.count());
+    reply->d_func()->timings.mark(QHttpNetworkReplyTimings::RequestStart);
+
+    appendHeaderBlock(streamID, m_encoder.encode(requestHeaders(request)), !hasBody,
+                      streamWeight(request));
+
+    if (hasBody) {
+        uploadDevice->setProperty("HTTP2StreamID", streamID);
+        connect(uploadDevice, SIGNAL(readyRead()), this, SLOT(_q_uploadDataReadyRead()),
+                Qt::QueuedConnection);
+        uploadData(streamID);
+    }
+}
+
+QHpackHeaderList QHttp2ProtocolHandler::requestHeaders(const QHttpNetworkRequest &request) const
+{
+    QHpackHeaderList fields;
+    fields << qMakePair(QByteArray(":method"), request.methodName())
+           << qMakePair(QByteArray(":scheme"), QByteArray(m_channel->ssl ? "https" : "http"))
+           << qMakePair(QByteArray(":authority"), request.headerField("host"))
+           << qMakePair(QByteArray(":path"), request.uri(false));
+
+    const QList<QPair<QByteArray, QByteArray> > header = request.header();
+    for (int i = 0; i < header.count(); ++i) {
+        // field names are lower case in HTTP/2, and the connection specific
+        // ones have no meaning in it (RFC 7540, 8.1.2)
+        const QByteArray name = header.at(i).first.toLower();
+        if (name == "host" || name == "connection" || name == "keep-alive"
+            || name == "proxy-connection" || name == "transfer-encoding" || name == "upgrade")
+            continue;
+        fields << qMakePair(name, header.at(i).second);
+    }
+    return fields;
+}
+
+void QHttp2ProtocolHandler::uploadData(quint32 streamID)
+{
+    QHash<quint32, Stream>::iterator it = m_streams.find(streamID);
+    if (it == m_streams.end() || it->localClosed)
+        return;
+
+    Stream &stream = *it;
+    QHttpNetworkReply *reply = stream.reply;
+    QHttpNetworkReplyPrivate *replyPrivate = reply->d_func();
+    QNonContiguousByteDevice *device = stream.request.uploadByteDevice();
+    const qint64 contentLength = stream.request.contentLength();
+
+    while (!stream.localClosed) {
+        qint64 maxLength = qMin<qint64>(qMin(stream.sendWindow, m_sessionSendWindow), m_maxFrameSize);
+        if (contentLength >= 0)
+            maxLength = qMin(maxLength, contentLength - replyPrivate->totallyUploadedData);
+
+        qint64 length = 0;
+        const char *data = 0;
+        if (maxLength > 0) {
+            data = device->readPointer(maxLength, length);
+            if (length == -1) {
+                appendRST_STREAM(streamID, ErrorCode_CANCEL);
+                replyFinishedWithError(streamID, QNetworkReply::UnknownNetworkError,
+                                       tr("Upload data ended prematurely"));
+                return;
+            }
+            length = qMin(length, maxLength);
+        }
+
+        const qint64 uploaded = replyPrivate->totallyUploadedData + length;
+        const bool last = contentLength >= 0 ? uploaded == contentLength
+                                             : (length == 0 && device->atEnd());
+        if (length == 0 && !last)
+            break; // out of window or waiting for the device
+
+        appendFrameHeader(length, FrameType_DATA, last ? FrameFlag_END_STREAM : 0, streamID);
+        if (length > 0) {
+            m_outputBuffer.append(data, length);
+            device->advanceReadPointer(length);
+            stream.sendWindow -= length;
+            m_sessionSendWindow -= length;
+            replyPrivate->totallyUploadedData = uploaded;
+        }
+        if (last) {
+            stream.localClosed = true;
+            device->disconnect(this);
+        }
+        if (length > 0)
+            emit reply->dataSendProgress(uploaded, contentLength);
+    }
+}
+
+void QHttp2ProtocolHandler::resumeUploads()
+{
+    const QList<quint32> streamIDs = m_streams.keys();
+    for (int i = 0; i < streamIDs.count(); ++i)
+        uploadData(streamIDs.at(i));
+}
+
+void QHttp2ProtocolHandler::updateReceiveWindow(quint32 streamID, Stream &stream)
+{
+    const qint32 consumed = StreamReceiveWindow - stream.recvWindow;
+    if (consumed < StreamReceiveWindow / 2)
+        return;
+
+    // hold back the credit while the reader is behind; readMoreLater()
+    // brings us back here once it has caught up
+    const QHttpNetworkReplyPrivate *replyPrivate = stream.reply->d_func();
+    if (replyPrivate->downstreamLimited && replyPrivate->readBufferMaxSize
+        && replyPrivate->responseData.byteAmount() >= replyPrivate->readBufferMaxSize)
+        return;
+
+    appendWINDOW_UPDATE(streamID, consumed);
+    stream.recvWindow = StreamReceiveWindow;
+}
+
+bool QHttp2ProtocolHandler::handleFrame(FrameType type, uchar flags, quint32 streamID,
+                                        const uchar *payload, quint32 length)
+{
+    // nothing may come between the frames of a header block
+    if (m_continuedStreamID && type != FrameType_CONTINUATION) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "Server interrupted a header block");
+        return false;
+    }
+
+    switch (type) {
+    case FrameType_DATA:
+        return handleDATA(flags, streamID, payload, length);
+    case FrameType_HEADERS:
+        return handleHEADERS(flags, streamID, payload, length);
+    case FrameType_CONTINUATION:
+        return handleCONTINUATION(flags, streamID, payload, length);
+    case FrameType_RST_STREAM:
+        return handleRST_STREAM(streamID, payload, length);
+    case FrameType_SETTINGS:
+        return handleSETTINGS(flags, streamID, payload, length);
+    case FrameType_PING:
+        return handlePING(flags, streamID, payload, length);
+    case FrameType_GOAWAY:
+        return handleGOAWAY(streamID, payload, length);
+    case FrameType_WINDOW_UPDATE:
+        return handleWINDOW_UPDATE(streamID, payload, length);
+    case FrameType_PUSH_PROMISE:
+        connectionError(ErrorCode_PROTOCOL_ERROR, "Server pushed a stream although push is disabled");
+        return false;
+    case FrameType_PRIORITY:
+        // the server's view of the dependencies does not matter to us
+    default:
+        // unknown frame types are to be ignored (RFC 7540, 4.1)
+        return true;
+    }
+}
+
+bool QHttp2ProtocolHandler::isIdleStream(quint32 streamID) const
+{
+    // only the streams we opened can ever be referred to by the server
+    return !(streamID & 1) || streamID >= m_nextStreamID;
+}
+
+bool QHttp2ProtocolHandler::handleDATA(uchar flags, quint32 streamID, const uchar *payload,
+                                       quint32 length)
+{
+    if (streamID == 0 || isIdleStream(streamID)) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "Server sent data on an invalid stream");
+        return false;
+    }
+
+    // the whole frame, padding included, counts against the windows
+    const qint32 frameLength = length;
+    if (frameLength > m_sessionRecvWindow) {
+        connectionError(ErrorCode_FLOW_CONTROL_ERROR, "Server exceeded the connection window");
+        return false;
+    }
+    m_sessionRecvWindow -= frameLength;
+    if (m_sessionRecvWindow < SessionReceiveWindow / 2) {
+        appendWINDOW_UPDATE(0, SessionReceiveWindow - m_sessionRecvWindow);
+        m_sessionRecvWindow = SessionReceiveWindow;
+    }
+
+    if (flags & FrameFlag_PADDED) {
+        if (length == 0 || payload[0] >= length) {
+            connectionError(ErrorCode_PROTOCOL_ERROR, "Server sent invalid padding");
+            return false;
+        }
+        length -= payload[0] + 1;
+        ++payload;
+    }
+
+    QHash<quint32, Stream>::iterator it = m_streams.find(streamID);
+    if (it == m_streams.end())
+        return true; // a stream we reset ourselves may still have data in flight
+
+    Stream &stream = *it;
+    if (frameLength > stream.recvWindow) {
+        appendRST_STREAM(streamID, ErrorCode_FLOW_CONTROL_ERROR);
+        replyFinishedWithError(streamID, QNetworkReply::ProtocolFailure,
+                               tr("Server exceeded the stream window"));
+        return true;
+    }
+    stream.recvWindow -= frameLength;
+
+    if (!stream.headersReceived) {
+        appendRST_STREAM(streamID, ErrorCode_PROTOCOL_ERROR);
+        replyFinishedWithError(streamID, QNetworkReply::ProtocolFailure,
+                               tr("Server sent data before the response headers"));
+        return true;
+    }
+
+    QHttpNetworkReply *reply = stream.reply;
+    QHttpNetworkReplyPrivate *replyPrivate = reply->d_func();
+    if (length > 0) {
+        const char *data = reinterpret_cast<const char *>(payload);
+        if (replyPrivate->userProvidedDownloadBuffer) {
+            // the buffer was allocated for the announced content length
+            if (replyPrivate->totalProgress + length > replyPrivate->bodyLength) {
+                appendRST_STREAM(streamID, ErrorCode_PROTOCOL_ERROR);
+                replyFinishedWithError(streamID, QNetworkReply::ProtocolFailure,
+                                       tr("Server sent more data than announced"));
+                return true;
+            }
+            memcpy(replyPrivate->userProvidedDownloadBuffer + replyPrivate->totalProgress, data, length);
+            replyPrivate->totalProgress += length;
+            emit reply->dataReadProgress(replyPrivate->totalProgress, replyPrivate->bodyLength);
+        } else {
+            replyPrivate->totalProgress += length;
+            if (replyPrivate->autoDecompress) {
+                QByteDataBuffer compressed;
+                compressed.append(QByteArray(data, length));
+                if (replyPrivate->uncompressBodyData(&compressed, &replyPrivate->responseData) < 0) {
+                    appendRST_STREAM(streamID, ErrorCode_CANCEL);
+                    replyFinishedWithError(streamID, QNetworkReply::ProtocolFailure,
+                                           m_connection->d_func()->errorDetail(QNetworkReply::ProtocolFailure, m_socket));
+                    return true;
+                }
+            } else {
+                replyPrivate->responseData.append(QByteArray(data, length));
+            }
+            emit reply->readyRead();
+            emit reply->dataReadProgress(replyPrivate->totalProgress, replyPrivate->bodyLength);
+        }
+    }
+
+    // the signals may have led to the reply being deleted
+    if ((flags & FrameFlag_END_STREAM) && m_streams.contains(streamID))
+        replyFinished(streamID);
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleHEADERS(uchar flags, quint32 streamID, const uchar *payload,
+                                          quint32 length)
+{
+    if (streamID == 0) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "Server sent headers on stream 0");
+        return false;
+    }
+    if (flags & FrameFlag_PADDED) {
+        if (length == 0 || payload[0] >= length) {
+            connectionError(ErrorCode_PROTOCOL_ERROR, "Server sent invalid padding");
+            return false;
+        }
+        length -= payload[0] + 1;
+        ++payload;
+    }
+    if (flags & FrameFlag_PRIORITY) {
+        if (length < 5) {
+            connectionError(ErrorCode_FRAME_SIZE_ERROR, "Server sent a truncated HEADERS frame");
+            return false;
+        }
+        length -= 5;
+        payload += 5;
+    }
+
+    if (length > MaxHeaderListSize) {
+        connectionError(ErrorCode_ENHANCE_YOUR_CALM, "Server sent too large a header block");
+        return false;
+    }
+    m_headerBlock = QByteArray(reinterpret_cast<const char *>(payload), length);
+    m_continuedEndStream = flags & FrameFlag_END_STREAM;
+    if (!(flags & FrameFlag_END_HEADERS)) {
+        m_continuedStreamID = streamID;
+        return true;
+    }
+    return handleHeaderBlock(streamID, m_continuedEndStream);
+}
+
+bool QHttp2ProtocolHandler::handleCONTINUATION(uchar flags, quint32 streamID, const uchar *payload,
+                                               quint32 length)
+{
+    if (!m_continuedStreamID || streamID != m_continuedStreamID) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "Server sent an unexpected CONTINUATION frame");
+        return false;
+    }
+
+    // the decoded block is larger than the encoded one, except for some
+    // unusual Huffman codes, so this keeps the server from making us
+    // buffer without end
+    if (length > MaxHeaderListSize - quint32(m_headerBlock.size())) {
+        connectionError(ErrorCode_ENHANCE_YOUR_CALM, "Server sent too large a header block");
+        return false;
+    }
+    m_headerBlock.append(reinterpret_cast<const char *>(payload), length);
+    if (!(flags & FrameFlag_END_HEADERS))
+        return true;
+    m_continuedStreamID = 0;
+    return handleHeaderBlock(streamID, m_continuedEndStream);
+}
+
+bool QHttp2ProtocolHandler::handleHeaderBlock(quint32 streamID, bool endStream)
+{
+    // the block has to be decoded even if nobody is interested in it any
+    // more, the decoder's table depends on it
+    QHpackHeaderList fields;
+    const QHpackDecoder::DecodeResult result = m_decoder.decode(m_headerBlock, &fields);
+    m_headerBlock.clear();
+    if (result == QHpackDecoder::HeaderListTooLarge) {
+        connectionError(ErrorCode_ENHANCE_YOUR_CALM, "Server sent too large a header block");
+        return false;
+    }
+    if (result != QHpackDecoder::Decoded) {
+        connectionError(ErrorCode_COMPRESSION_ERROR, "Server sent an invalid header block");
+        return false;
+    }
+    if (isIdleStream(streamID)) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "Server sent headers on an invalid stream");
+        return false;
+    }
+
+    QHash<quint32, Stream>::iterator it = m_streams.find(streamID);
+    if (it == m_streams.end())
+        return true;
+
+    Stream &stream = *it;
+    if (stream.headersReceived) {
+        // trailers; they come too late to be reported to anyone
+        if (endStream) {
+            replyFinished(streamID);
+        } else {
+            appendRST_STREAM(streamID, ErrorCode_PROTOCOL_ERROR);
+            replyFinishedWithError(streamID, QNetworkReply::ProtocolFailure,
+                                   tr("Server sent headers after the response headers"));
+        }
+        return true;
+    }
+
+    int statusCode = 0;
+    for (int i = 0; i < fields.count(); ++i) {
+        if (fields.at(i).first == ":status") {
+            statusCode = fields.at(i).second.toInt();
+            break;
+        }
+    }
+    if (statusCode < 100 || statusCode > 999) {
+        appendRST_STREAM(streamID, ErrorCode_PROTOCOL_ERROR);
+        replyFinishedWithError(streamID, QNetworkReply::ProtocolFailure,
+                               tr("Server sent no valid status code"));
+        return true;
+    }
+    if (statusCode < 200)
+        return true; // an informational response, the real one follows
+
+    QHttpNetworkReply *reply = stream.reply;
+    QHttpNetworkReplyPrivate *replyPrivate = reply->d_func();
+    replyPrivate->timings.mark(QHttpNetworkReplyTimings::ResponseStart);
+    replyPrivate->statusCode = statusCode;
+    replyPrivate->majorVersion = 2;
+    replyPrivate->minorVersion = 0;
+    for (int i = 0; i < fields.count(); ++i) {
+        // the other pseudo header fields have no meaning in a response;
+        // fields are appended directly to keep repeated ones
+        if (!fields.at(i).first.startsWith(':'))
+            replyPrivate->fields.append(fields.at(i));
+    }
+    replyPrivate->bodyLength = replyPrivate->contentLength();
+    if (replyPrivate->autoDecompress && replyPrivate->isCompressed())
+        replyPrivate->removeAutoDecompressHeader();
+    else
+        replyPrivate->autoDecompress = false;
+    replyPrivate->state = QHttpNetworkReplyPrivate::ReadingDataState;
+    stream.headersReceived = true;
+
+    emit reply->headerChanged();
+
+    // the signal may have led to the reply being deleted
+    if (endStream && m_streams.contains(streamID))
+        replyFinished(streamID);
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleRST_STREAM(quint32 streamID, const uchar *payload, quint32 length)
+{
+    if (streamID == 0 || isIdleStream(streamID)) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "Server reset an invalid stream");
+        return false;
+    }
+    if (length != 4) {
+        connectionError(ErrorCode_FRAME_SIZE_ERROR, "Server sent an invalid RST_STREAM frame");
+        return false;
+    }
+    if (!m_streams.contains(streamID))
+        return true;
+
+    QNetworkReply::NetworkError errorCode = QNetworkReply::ProtocolFailure;
+    QString errorMessage;
+    switch (qFromBigEndian<quint32>(payload)) {
+    case ErrorCode_REFUSED_STREAM:
+        // The server did not process the request at all. If it has other
+        // streams running it most likely refused this one because we went
+        // over its stream limit before learning about it, so retry it later.
+        if (m_streams.count() > 1) {
+            m_maxConcurrentStreams = qMin<quint32>(m_maxConcurrentStreams, m_streams.count() - 1);
+            requeueStream(streamID);
+            return true;
+        }
+        errorCode = QNetworkReply::ServiceUnavailableError;
+        errorMessage = tr("Server refused the request");
+        break;
+    case ErrorCode_CANCEL:
+        errorCode = QNetworkReply::OperationCanceledError;
+        errorMessage = tr("Server canceled the request");
+        break;
+    case ErrorCode_INTERNAL_ERROR:
+        errorCode = QNetworkReply::InternalServerError;
+        errorMessage = tr("Server encountered an internal error");
+        break;
+    case ErrorCode_HTTP_1_1_REQUIRED:
+    case ErrorCode_INADEQUATE_SECURITY:
+        errorCode = QNetworkReply::ProtocolInvalidOperationError;
+        errorMessage = tr("Server does not accept the request over this connection");
+        break;
+    default:
+        errorMessage = tr("Server reset the stream");
+        break;
+    }
+    replyFinishedWithError(streamID, errorCode, errorMessage);
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleSETTINGS(uchar flags, quint32 streamID, const uchar *payload,
+                                           quint32 length)
+{
+    if (streamID != 0) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "Server sent settings for a stream");
+        return false;
+    }
+    if (flags & FrameFlag_ACK) {
+        if (length != 0) {
+            connectionError(ErrorCode_FRAME_SIZE_ERROR, "Server sent an invalid SETTINGS frame");
+            return false;
+        }
+        return true;
+    }
+    if (length % 6) {
+        connectionError(ErrorCode_FRAME_SIZE_ERROR, "Server sent an invalid SETTINGS frame");
+        return false;
+    }
+
+    for (quint32 i = 0; i < length; i += 6) {
+        const quint16 identifier = qFromBigEndian<quint16>(payload + i);
+        const quint32 value = qFromBigEndian<quint32>(payload + i + 2);
+        switch (identifier) {
+        case Settings_HEADER_TABLE_SIZE:
+            m_encoder.setMaxTableSize(value);
+            break;
+        case Settings_MAX_CONCURRENT_STREAMS:
+            m_maxConcurrentStreams = value;
+            break;
+        case Settings_INITIAL_WINDOW_SIZE: {
+            if (value > quint32(MaxWindowSize)) {
+                connectionError(ErrorCode_FLOW_CONTROL_ERROR, "Server sent an invalid window size");
+                return false;
+            }
+            // the change applies to the open streams as well (RFC 7540, 6.9.2)
+            const qint64 delta = qint64(value) - m_initialSendWindow;
+            for (QHash<quint32, Stream>::iterator it = m_streams.begin(); it != m_streams.end(); ++it) {
+                if (it->sendWindow + delta > MaxWindowSize) {
+                    connectionError(ErrorCode_FLOW_CONTROL_ERROR, "Server overflowed a stream window");
+                    return false;
+                }
+                it->sendWindow += delta;
+            }
+            m_initialSendWindow = value;
+            break;
+        }
+        case Settings_MAX_FRAME_SIZE:
+            if (value < DefaultMaxFrameSize || value > 0xffffff) {
+                connectionError(ErrorCode_PROTOCOL_ERROR, "Server sent an invalid frame size");
+                return false;
+            }
+            m_maxFrameSize = value;
+            break;
+        default:
+            // the others only concern the server, unknown ones are ignored
+            break;
+        }
+    }
+
+    appendFrameHeader(0, FrameType_SETTINGS, FrameFlag_ACK, 0);
+    resumeUploads();
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handlePING(uchar flags, quint32 streamID, const uchar *payload,
+                                       quint32 length)
+{
+    if (streamID != 0) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "Server sent a PING for a stream");
+        return false;
+    }
+    if (length != 8) {
+        connectionError(ErrorCode_FRAME_SIZE_ERROR, "Server sent an invalid PING frame");
+        return false;
+    }
+    if (!(flags & FrameFlag_ACK)) {
+        appendFrameHeader(length, FrameType_PING, FrameFlag_ACK, 0);
+        m_outputBuffer.append(reinterpret_cast<const char *>(payload), length);
+    }
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleGOAWAY(quint32 streamID, const uchar *payload, quint32 length)
+{
+    if (streamID != 0) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "Server sent GOAWAY for a stream");
+        return false;
+    }
+    if (length < 8) {
+        connectionError(ErrorCode_FRAME_SIZE_ERROR, "Server sent an invalid GOAWAY frame");
+        return false;
+    }
+
+    // no new streams on this connection; the ones the server has not looked
+    // at are retried on the next one
+    m_goingAway = true;
+    const quint32 lastStreamID = qFromBigEndian<quint32>(payload) & 0x7fffffff;
+    const QList<quint32> streamIDs = m_streams.keys();
+    for (int i = 0; i < streamIDs.count(); ++i) {
+        if (streamIDs.at(i) > lastStreamID && m_streams.contains(streamIDs.at(i)))
+            requeueStream(streamIDs.at(i));
+    }
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleWINDOW_UPDATE(quint32 streamID, const uchar *payload,
+                                                quint32 length)
+{
+    if (length != 4) {
+        connectionError(ErrorCode_FRAME_SIZE_ERROR, "Server sent an invalid WINDOW_UPDATE frame");
+        return false;
+    }
+    const quint32 increment = qFromBigEndian<quint32>(payload) & 0x7fffffff;
+
+    if (streamID == 0) {
+        if (increment == 0 || m_sessionSendWindow + qint64(increment) > MaxWindowSize) {
+            connectionError(increment ? ErrorCode_FLOW_CONTROL_ERROR : ErrorCode_PROTOCOL_ERROR,
+                            "Server sent an invalid connection window update");
+            return false;
+        }
+        m_sessionSendWindow += increment;
+        resumeUploads();
+        return true;
+    }
+
+    if (isIdleStream(streamID)) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "Server sent a window update for an invalid stream");
+        return false;
+    }
+    QHash<quint32, Stream>::iterator it = m_streams.find(streamID);
+    if (it == m_streams.end())
+        return true;
+    if (increment == 0 || it->sendWindow + qint64(increment) > MaxWindowSize) {
+        appendRST_STREAM(streamID, increment ? ErrorCode_FLOW_CONTROL_ERROR : ErrorCode_PROTOCOL_ERROR);
+        replyFinishedWithError(streamID, QNetworkReply::ProtocolFailure,
+                               tr("Server sent an invalid stream window update"));
+        return true;
+    }
+    it->sendWindow += increment;
+    uploadData(streamID);
+    return true;
+}
+
+void QHttp2ProtocolHandler::connectionError(ErrorCode errorCode, const char *errorMessage)
+{
+    appendGOAWAY(errorCode);
+    flush();
+    handleConnectionClosure(QNetworkReply::ProtocolFailure, tr(errorMessage));
+    m_channel->close();
+}
+
+void QHttp2ProtocolHandler::requeueStream(quint32 streamID)
+{
+    const Stream stream = m_streams.take(streamID);
+    QHttpNetworkReply *reply = stream.reply;
+    reply->disconnect(this);
+
+    if (QNonContiguousByteDevice *device = stream.request.uploadByteDevice()) {
+        device->disconnect(this);
+        if (!device->reset()) {
+            emit reply->finishedWithError(QNetworkReply::ContentReSendError,
+                                          m_connection->d_func()->errorDetail(QNetworkReply::ContentReSendError, m_socket));
+            return;
+        }
+        reply->d_func()->totallyUploadedData = 0;
+    }
+
+    m_channel->spdyRequestsToSend.insertMulti(stream.request.priority(),
+                                              qMakePair(stream.request, reply));
+}
+
+void QHttp2ProtocolHandler::replyFinished(quint32 streamID)
+{
+    const Stream stream = m_streams.take(streamID);
+    QHttpNetworkReply *reply = stream.reply;
+
+    // the server answered before we were done uploading
+    if (!stream.localClosed)
+        appendRST_STREAM(streamID, ErrorCode_NO_ERROR);
+
+    reply->d_func()->state = QHttpNetworkReplyPrivate::AllDoneState;
+    reply->disconnect(this);
+    if (QNonContiguousByteDevice *device = stream.request.uploadByteDevice())
+        device->disconnect(this);
+    emit reply->finished();
+}
+
+void QHttp2ProtocolHandler::replyFinishedWithError(quint32 streamID,
+                                                   QNetworkReply::NetworkError errorCode,
+                                                   const QString &errorMessage)
+{
+    const Stream stream = m_streams.take(streamID);
+    QHttpNetworkReply *reply = stream.reply;
+
+    reply->d_func()->state = QHttpNetworkReplyPrivate::AllDoneState;
+    reply->d_func()->errorString = errorMessage;
+    reply->disconnect(this);
+    if (QNonContiguousByteDevice *device = stream.request.uploadByteDevice())
+        device->disconnect(this);
+    emit reply->finishedWithError(errorCode, errorMessage);
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
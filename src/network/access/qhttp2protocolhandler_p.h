@@ -0,0 +1,219 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QHTTP2PROTOCOLHANDLER_H
+#define QHTTP2PROTOCOLHANDLER_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qabstractprotocolhandler_p.h>
+#include <private/qhttpnetworkrequest_p.h>
+#include <private/qhpack_p.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtCore/qhash.h>
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+#ifndef HttpMessagePair
+typedef QPair<QHttpNetworkRequest, QHttpNetworkReply*> HttpMessagePair;
+#endif
+
+// HTTP/2 (RFC 7540), either negotiated over TLS or spoken in clear text to
+// a server known to support it. Requests are taken from the channel's
+// spdyRequestsToSend queue and multiplexed as streams over the connection.
+class QHttp2ProtocolHandler : public QObject, public QAbstractProtocolHandler {
+    Q_OBJECT
+public:
+    QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *channel);
+    ~QHttp2ProtocolHandler();
+
+    virtual void _q_receiveReply() Q_DECL_OVERRIDE;
+    virtual void _q_readyRead() Q_DECL_OVERRIDE;
+    virtual bool sendRequest() Q_DECL_OVERRIDE;
+
+    // the connection went away; fails the streams that are still open
+    void handleConnectionClosure(QNetworkReply::NetworkError errorCode, const QString &errorString);
+
+private slots:
+    void _q_uploadDataReadyRead();
+    void _q_replyDestroyed(QObject*);
+
+private:
+    enum FrameType {
+        FrameType_DATA = 0x0,
+        FrameType_HEADERS = 0x1,
+        FrameType_PRIORITY = 0x2,
+        FrameType_RST_STREAM = 0x3,
+        FrameType_SETTINGS = 0x4,
+        FrameType_PUSH_PROMISE = 0x5,
+        FrameType_PING = 0x6,
+        FrameType_GOAWAY = 0x7,
+        FrameType_WINDOW_UPDATE = 0x8,
+        FrameType_CONTINUATION = 0x9
+    };
+
+    enum FrameFlag {
+        FrameFlag_END_STREAM = 0x01,
+        FrameFlag_ACK = 0x01,
+        FrameFlag_END_HEADERS = 0x04,
+        FrameFlag_PADDED = 0x08,
+        FrameFlag_PRIORITY = 0x20
+    };
+
+    enum SettingsID {
+        Settings_HEADER_TABLE_SIZE = 0x1,
+        Settings_ENABLE_PUSH = 0x2,
+        Settings_MAX_CONCURRENT_STREAMS = 0x3,
+        Settings_INITIAL_WINDOW_SIZE = 0x4,
+        Settings_MAX_FRAME_SIZE = 0x5,
+        Settings_MAX_HEADER_LIST_SIZE = 0x6
+    };
+
+    enum ErrorCode {
+        ErrorCode_NO_ERROR = 0x0,
+        ErrorCode_PROTOCOL_ERROR = 0x1,
+        ErrorCode_INTERNAL_ERROR = 0x2,
+        ErrorCode_FLOW_CONTROL_ERROR = 0x3,
+        ErrorCode_SETTINGS_TIMEOUT = 0x4,
+        ErrorCode_STREAM_CLOSED = 0x5,
+        ErrorCode_FRAME_SIZE_ERROR = 0x6,
+        ErrorCode_REFUSED_STREAM = 0x7,
+        ErrorCode_CANCEL = 0x8,
+        ErrorCode_COMPRESSION_ERROR = 0x9,
+        ErrorCode_CONNECT_ERROR = 0xa,
+        ErrorCode_ENHANCE_YOUR_CALM = 0xb,
+        ErrorCode_INADEQUATE_SECURITY = 0xc,
+        ErrorCode_HTTP_1_1_REQUIRED = 0xd
+    };
+
+    enum {
+        FrameHeaderSize = 9,
+        DefaultMaxFrameSize = 16384,
+        DefaultWindowSize = 65535,
+        MaxWindowSize = 0x7fffffff,
+        // what we allow the server to send ahead of the application reading it
+        StreamReceiveWindow = 1024 * 1024,
+        SessionReceiveWindow = 16 * 1024 * 1024,
+        // the largest header block, encoded or decoded, we accept
+        MaxHeaderListSize = 256 * 1024
+    };
+
+    struct Stream {
+        QHttpNetworkRequest request;
+        QHttpNetworkReply *reply;
+        qint32 sendWindow;
+        qint32 recvWindow;
+        bool localClosed;
+        bool headersReceived;
+    };
+
+    void sendConnectionPreface();
+    void flush();
+    void continueAfterPass();
+    void appendFrameHeader(quint32 length, FrameType type, uchar flags, quint32 streamID);
+    void appendHeaderBlock(quint32 streamID, const QByteArray &block, bool endStream, int weight);
+    void appendRST_STREAM(quint32 streamID, ErrorCode errorCode);
+    void appendWINDOW_UPDATE(quint32 streamID, quint32 increment);
+    void appendGOAWAY(ErrorCode errorCode);
+
+    void startStream(const HttpMessagePair &pair);
+    QHpackHeaderList requestHeaders(const QHttpNetworkRequest &request) const;
+    void uploadData(quint32 streamID);
+    void resumeUploads();
+    void updateReceiveWindow(quint32 streamID, Stream &stream);
+
+    bool isIdleStream(quint32 streamID) const;
+    bool handleFrame(FrameType type, uchar flags, quint32 streamID, const uchar *payload, quint32 length);
+    bool handleDATA(uchar flags, quint32 streamID, const uchar *payload, quint32 length);
+    bool handleHEADERS(uchar flags, quint32 streamID, const uchar *payload, quint32 length);
+    bool handleCONTINUATION(uchar flags, quint32 streamID, const uchar *payload, quint32 length);
+    bool handleRST_STREAM(quint32 streamID, const uchar *payload, quint32 length);
+    bool handleSETTINGS(uchar flags, quint32 streamID, const uchar *payload, quint32 length);
+    bool handlePING(uchar flags, quint32 streamID, const uchar *payload, quint32 length);
+    bool handleGOAWAY(quint32 streamID, const uchar *payload, quint32 length);
+    bool handleWINDOW_UPDATE(quint32 streamID, const uchar *payload, quint32 length);
+    bool handleHeaderBlock(quint32 streamID, bool endStream);
+
+    void connectionError(ErrorCode errorCode, const char *errorMessage);
+    void requeueStream(quint32 streamID);
+    void replyFinished(quint32 streamID);
+    void replyFinishedWithError(quint32 streamID, QNetworkReply::NetworkError errorCode,
+                                const QString &errorMessage);
+
+    QHash<quint32, Stream> m_streams;
+    quint32 m_nextStreamID;
+    quint32 m_maxConcurrentStreams;
+    quint32 m_maxFrameSize;
+    qint32 m_initialSendWindow;
+    qint32 m_sessionSendWindow;
+    qint32 m_sessionRecvWindow;
+    bool m_prefaceSent;
+    bool m_goingAway;
+
+    QHpackEncoder m_encoder;
+    QHpackDecoder m_decoder;
+
+    // a header block that continues in CONTINUATION frames
+    QByteArray m_headerBlock;
+    quint32 m_continuedStreamID;
+    bool m_continuedEndStream;
+
+    QByteArray m_inputBuffer;
+    int m_inputOffset;
+    QByteArray m_outputBuffer;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
+
+#endif // QHTTP2PROTOCOLHANDLER_H
@@ -0,0 +1,273 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttpcontentdecoder_p.h"
+
+#ifndef QT_NO_HTTP
+
+#ifndef QT_NO_COMPRESS
+#include <zlib.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*
+    QHttpContentDecoder is the streaming stage that undoes the
+    Content-Encoding of an HTTP reply body.
+
+    Compressed data is fed in as it arrives from the socket, the decoded
+    data is written into fixed size blocks. A block that has been filled
+    completely is handed to the output buffer without copying it, the
+    partially filled tail is copied out at the end of each decode() call
+    and the rest of the block is used for the next call. This avoids
+    guessing the uncompressed size up front and reallocating the output.
+
+    Supported codings are registered in the table at the end of this
+    file; the Accept-Encoding header sent with requests is derived from
+    that table as well.
+*/
+
+QHttpContentDecoder::QHttpContentDecoder()
+    : output(0), blockUsed(0), blockFlushed(0), finished(false)
+{
+}
+
+QHttpContentDecoder::~QHttpContentDecoder()
+{
+}
+
+/*
+    Decodes \a size bytes at \a data and appends the result to \a out.
+    Returns false if the data could not be decoded. Data following the
+    end of the encoded stream is ignored.
+*/
+bool QHttpContentDecoder::decode(const char *data, int size, QByteDataBuffer *out)
+{
+    if (finished)
+        return true;
+
+    output = out;
+    bool ok = decodeData(data, size);
+    if (blockUsed > blockFlushed) {
+        out->append(QByteArray(block.constData() + blockFlushed, blockUsed - blockFlushed));
+        blockFlushed = blockUsed;
+    }
+    output = 0;
+    return ok;
+}
+
+char *QHttpContentDecoder::outputBuffer()
+{
+    if (block.isEmpty()) {
+        block.resize(BlockSize);
+        blockUsed = 0;
+        blockFlushed = 0;
+    }
+    return block.data() + blockUsed;
+}
+
+void QHttpContentDecoder::outputBufferFilled(int bytes)
+{
+    Q_ASSERT(output);
+    Q_ASSERT(bytes <= outputBufferSize());
+    blockUsed += bytes;
+    if (blockUsed < BlockSize)
+        return;
+
+    // the block is full: hand it over and start a new one next time
+    if (blockFlushed == 0)
+        output->append(block);
+    else
+        output->append(QByteArray(block.constData() + blockFlushed, BlockSize - blockFlushed));
+    block = QByteArray();
+    blockUsed = 0;
+    blockFlushed = 0;
+}
+
+#ifndef QT_NO_COMPRESS
+class QHttpZlibDecoder : public QHttpContentDecoder
+{
+public:
+    QHttpZlibDecoder();
+    ~QHttpZlibDecoder();
+
+protected:
+    bool decodeData(const char *data, int size);
+
+private:
+    bool initialize(int windowBits);
+
+    z_stream stream;
+    bool initialized;
+    bool triedRawDeflate;
+};
+
+QHttpZlibDecoder::QHttpZlibDecoder()
+    : initialized(false), triedRawDeflate(false)
+{
+    // "windowBits can also be greater than 15 for optional gzip decoding.
+    // Add 32 to windowBits to enable zlib and gzip decoding with automatic header detection"
+    // http://www.zlib.net/manual.html
+    initialize(MAX_WBITS + 32);
+}
+
+QHttpZlibDecoder::~QHttpZlibDecoder()
+{
+    if (initialized)
+        inflateEnd(&stream);
+}
+
+bool QHttpZlibDecoder::initialize(int windowBits)
+{
+    if (initialized)
+        inflateEnd(&stream);
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.avail_in = 0;
+    stream.next_in = Z_NULL;
+    initialized = (inflateInit2(&stream, windowBits) == Z_OK);
+    return initialized;
+}
+
+bool QHttpZlibDecoder::decodeData(const char *data, int size)
+{
+    if (!initialized)
+        return false;
+
+    // input bytes will not be changed by zlib, so it is safe to const_cast here
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream.avail_in = size;
+
+    do {
+        stream.next_out = reinterpret_cast<Bytef *>(outputBuffer());
+        const int available = outputBufferSize();
+        stream.avail_out = available;
+
+        int ret = inflate(&stream, Z_NO_FLUSH);
+        // in the case where we get Z_DATA_ERROR this could be because we received raw deflate compressed data.
+        if (ret == Z_DATA_ERROR && !triedRawDeflate && stream.total_out == 0) {
+            triedRawDeflate = true;
+            if (!initialize(-MAX_WBITS))
+                return false;
+            stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+            stream.avail_in = size;
+            continue;
+        }
+
+        outputBufferFilled(available - stream.avail_out);
+
+        if (ret == Z_STREAM_END) {
+            setFinished();
+            return true;
+        }
+        // Z_BUF_ERROR only means that no progress was possible, i.e. all input
+        // has been consumed and all pending output has been written.
+        if (ret == Z_BUF_ERROR)
+            break;
+        // All other negative return codes are errors, in the context of HTTP compression, Z_NEED_DICT is also an error.
+        if (ret < 0 || ret == Z_NEED_DICT)
+            return false;
+    } while (stream.avail_in > 0 || stream.avail_out == 0);
+
+    return true;
+}
+
+static QHttpContentDecoder *createZlibDecoder()
+{
+    return new QHttpZlibDecoder;
+}
+#endif // QT_NO_COMPRESS
+
+// New content codings are added here, in the order of preference they
+// are announced with in the Accept-Encoding request header.
+static const struct {
+    const char *name;
+    QHttpContentDecoder *(*create)();
+} contentDecoders[] = {
+#ifndef QT_NO_COMPRESS
+    { "gzip", createZlibDecoder },
+    { "deflate", createZlibDecoder },
+#endif
+    { 0, 0 }
+};
+
+bool QHttpContentDecoder::isSupported(const QByteArray &contentEncoding)
+{
+    for (int i = 0; contentDecoders[i].name; ++i) {
+        if (qstricmp(contentEncoding.constData(), contentDecoders[i].name) == 0)
+            return true;
+    }
+    return false;
+}
+
+/*
+    Returns a new decoder for \a contentEncoding or 0 if that coding is
+    not supported. The caller takes ownership.
+*/
+QHttpContentDecoder *QHttpContentDecoder::create(const QByteArray &contentEncoding)
+{
+    for (int i = 0; contentDecoders[i].name; ++i) {
+        if (qstricmp(contentEncoding.constData(), contentDecoders[i].name) == 0)
+            return contentDecoders[i].create();
+    }
+    return 0;
+}
+
+/*
+    Returns the value for the Accept-Encoding request header listing all
+    supported codings, or an empty byte array if there are none.
+*/
+QByteArray QHttpContentDecoder::acceptEncoding()
+{
+    QByteArray result;
+    for (int i = 0; contentDecoders[i].name; ++i) {
+        if (!result.isEmpty())
+            result += ", ";
+        result += contentDecoders[i].name;
+    }
+    return result;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
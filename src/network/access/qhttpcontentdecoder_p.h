@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHTTPCONTENTDECODER_P_H
+#define QHTTPCONTENTDECODER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <private/qbytedata_p.h>
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+class QHttpContentDecoder
+{
+public:
+    enum { BlockSize = 16 * 1024 };
+
+    virtual ~QHttpContentDecoder();
+
+    bool decode(const char *data, int size, QByteDataBuffer *out);
+    bool isFinished() const { return finished; }
+
+    static bool isSupported(const QByteArray &contentEncoding);
+    static QHttpContentDecoder *create(const QByteArray &contentEncoding);
+    static QByteArray acceptEncoding();
+
+protected:
+    QHttpContentDecoder();
+
+    // Implementations decode into the free space of the current output
+    // block and report how much of it they used.
+    virtual bool decodeData(const char *data, int size) = 0;
+
+    char *outputBuffer();
+    int outputBufferSize() const { return BlockSize - blockUsed; }
+    void outputBufferFilled(int bytes);
+    void setFinished() { finished = true; }
+
+private:
+    Q_DISABLE_COPY(QHttpContentDecoder)
+
+    QByteDataBuffer *output;
+    QByteArray block;
+    int blockUsed;
+    int blockFlushed;
+    bool finished;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
+
+#endif // QHTTPCONTENTDECODER_P_H
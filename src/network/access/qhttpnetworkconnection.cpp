@@ -42,6 +42,7 @@
 #include "qhttpnetworkconnection_p.h"
 #include <private/qabstractsocket_p.h>
 #include "qhttpnetworkconnectionchannel_p.h"
+#include "qhttpcontentdecoder_p.h"
 #include "private/qnoncontiguousbytedevice_p.h"
 #include <private/qnetworkrequest_p.h>
 #include <private/qobject_p.h>
@@ -84,9 +85,10 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(const QString &host
   networkLayerState(Unknown),
   hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true)
 #ifndef QT_NO_SSL
-, channelCount((type == QHttpNetworkConnection::ConnectionTypeSPDY) ? 1 : defaultHttpChannelCount)
+, channelCount((type == QHttpNetworkConnection::ConnectionTypeSPDY
+                || type == QHttpNetworkConnection::ConnectionTypeHTTP2) ? 1 : defaultHttpChannelCount)
 #else
-, channelCount(defaultHttpChannelCount)
+, channelCount((type == QHttpNetworkConnection::ConnectionTypeHTTP2) ? 1 : defaultHttpChannelCount)
 #endif // QT_NO_SSL
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
@@ -297,13 +299,12 @@ void QHttpNetworkConnectionPrivate::prepareRequest(HttpMessagePair &messagePair)
     // encoding.
     value = request.headerField("accept-encoding");
     if (value.isEmpty()) {
-#ifndef QT_NO_COMPRESS
-        request.setHeaderField("Accept-Encoding", "gzip, deflate");
-        request.d->autoDecompress = true;
-#else
-        // if zlib is not available set this to false always
-        request.d->autoDecompress = false;
-#endif
+        // announce all content codings we can decode; if there are none
+        // (e.g. zlib is not available) set this to false always
+        const QByteArray acceptEncoding = QHttpContentDecoder::acceptEncoding();
+        if (!acceptEncoding.isEmpty())
+            request.setHeaderField("Accept-Encoding", acceptEncoding);
+        request.d->autoDecompress = !acceptEncoding.isEmpty();
     }
 
     // some websites mandate an accept-language header and fail
@@ -544,12 +545,55 @@ void QHttpNetworkConnectionPrivate::createAuthorization(QAbstractSocket *socket,
     }
 }
 
+void QHttpNetworkRequestQueue::enqueue(const HttpMessagePair &pair)
+{
+    Key key(pair.first.priorityLevel(), nextSequenceNumber++);
+    pairs.insert(key, pair);
+    keys.insert(pair.second, key);
+}
+
+HttpMessagePair QHttpNetworkRequestQueue::takeFirst()
+{
+    return take(pairs.begin());
+}
+
+HttpMessagePair QHttpNetworkRequestQueue::take(iterator it)
+{
+    HttpMessagePair pair = it.value();
+    keys.remove(pair.second);
+    pairs.erase(it);
+    return pair;
+}
+
+bool QHttpNetworkRequestQueue::remove(QHttpNetworkReply *reply)
+{
+    QHash<QHttpNetworkReply *, Key>::iterator it = keys.find(reply);
+    if (it == keys.end())
+        return false;
+    pairs.remove(it.value());
+    keys.erase(it);
+    return true;
+}
+
+bool QHttpNetworkRequestQueue::setPriorityLevel(QHttpNetworkReply *reply, int level)
+{
+    QHash<QHttpNetworkReply *, Key>::iterator it = keys.find(reply);
+    if (it == keys.end())
+        return false;
+    HttpMessagePair pair = pairs.take(it.value());
+    pair.first.setPriorityLevel(level);
+    it.value() = Key(level, nextSequenceNumber++);
+    pairs.insert(it.value(), pair);
+    return true;
+}
+
 QHttpNetworkReply* QHttpNetworkConnectionPrivate::queueRequest(const QHttpNetworkRequest &request)
 {
     Q_Q(QHttpNetworkConnection);
 
     // The reply component of the pair is created initially.
     QHttpNetworkReply *reply = new QHttpNetworkReply(request.url());
+    reply->d_func()->timings.mark(QHttpNetworkReplyTimings::Queued);
     reply->setRequest(request);
     reply->d_func()->connection = q;
     reply->d_func()->connectionChannel = &channels[0]; // will have the correct one set later
@@ -559,23 +603,12 @@ QHttpNetworkReply* QHttpNetworkConnectionPrivate::queueRequest(const QHttpNetwor
         preConnectRequests++;
 
     if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP) {
-        switch (request.priority()) {
-        case QHttpNetworkRequest::HighPriority:
-            highPriorityQueue.prepend(pair);
-            break;
-        case QHttpNetworkRequest::NormalPriority:
-        case QHttpNetworkRequest::LowPriority:
-            lowPriorityQueue.prepend(pair);
-            break;
-        }
-    }
-#ifndef QT_NO_SSL
-    else { // SPDY
+        requestQueue.enqueue(pair);
+    } else { // SPDY, HTTP/2
         if (!pair.second->d_func()->requestIsPrepared)
             prepareRequest(pair);
         channels[0].spdyRequestsToSend.insertMulti(request.priority(), pair);
     }
-#endif // QT_NO_SSL
 
     // For Happy Eyeballs the networkLayerState is set to Unknown
     // untill we have started the first connection attempt. So no
@@ -601,16 +634,7 @@ void QHttpNetworkConnectionPrivate::requeueRequest(const HttpMessagePair &pair)
 {
     Q_Q(QHttpNetworkConnection);
 
-    QHttpNetworkRequest request = pair.first;
-    switch (request.priority()) {
-    case QHttpNetworkRequest::HighPriority:
-        highPriorityQueue.prepend(pair);
-        break;
-    case QHttpNetworkRequest::NormalPriority:
-    case QHttpNetworkRequest::LowPriority:
-        lowPriorityQueue.prepend(pair);
-        break;
-    }
+    requestQueue.enqueue(pair);
 
     QMetaObject::invokeMethod(q, "_q_startNextRequest", Qt::QueuedConnection);
 }
@@ -621,23 +645,14 @@ bool QHttpNetworkConnectionPrivate::dequeueRequest(QAbstractSocket *socket)
     if (socket)
         i = indexOf(socket);
 
-    if (!highPriorityQueue.isEmpty()) {
-        // remove from queue before sendRequest! else we might pipeline the same request again
-        HttpMessagePair messagePair = highPriorityQueue.takeLast();
-        if (!messagePair.second->d_func()->requestIsPrepared)
-            prepareRequest(messagePair);
-        channels[i].request = messagePair.first;
-        channels[i].reply = messagePair.second;
-        return true;
-    }
-
-    if (!lowPriorityQueue.isEmpty()) {
+    if (!requestQueue.isEmpty()) {
         // remove from queue before sendRequest! else we might pipeline the same request again
-        HttpMessagePair messagePair = lowPriorityQueue.takeLast();
+        HttpMessagePair messagePair = requestQueue.takeFirst();
         if (!messagePair.second->d_func()->requestIsPrepared)
             prepareRequest(messagePair);
         channels[i].request = messagePair.first;
         channels[i].reply = messagePair.second;
+        channels[i].requestStarted(messagePair.second, 1);
         return true;
     }
     return false;
@@ -645,10 +660,8 @@ bool QHttpNetworkConnectionPrivate::dequeueRequest(QAbstractSocket *socket)
 
 QHttpNetworkRequest QHttpNetworkConnectionPrivate::predictNextRequest()
 {
-    if (!highPriorityQueue.isEmpty())
-        return highPriorityQueue.last().first;
-    if (!lowPriorityQueue.isEmpty())
-        return lowPriorityQueue.last().first;
+    if (!requestQueue.isEmpty())
+        return requestQueue.first().first;
     return QHttpNetworkRequest();
 }
 
@@ -656,7 +669,7 @@ QHttpNetworkRequest QHttpNetworkConnectionPrivate::predictNextRequest()
 void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
 {
     // return fast if there is nothing to pipeline
-    if (highPriorityQueue.isEmpty() && lowPriorityQueue.isEmpty())
+    if (requestQueue.isEmpty())
         return;
 
     int i = indexOf(socket);
@@ -705,22 +718,9 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
         return;
 
     int lengthBefore;
-    while (!highPriorityQueue.isEmpty()) {
+    while (!requestQueue.isEmpty()) {
         lengthBefore = channels[i].alreadyPipelinedRequests.length();
-        fillPipeline(highPriorityQueue, channels[i]);
-
-        if (channels[i].alreadyPipelinedRequests.length() >= defaultPipelineLength) {
-            channels[i].pipelineFlush();
-            return;
-        }
-
-        if (lengthBefore == channels[i].alreadyPipelinedRequests.length())
-            break; // did not process anything, now do the low prio queue
-    }
-
-    while (!lowPriorityQueue.isEmpty()) {
-        lengthBefore = channels[i].alreadyPipelinedRequests.length();
-        fillPipeline(lowPriorityQueue, channels[i]);
+        fillPipeline(channels[i]);
 
         if (channels[i].alreadyPipelinedRequests.length() >= defaultPipelineLength) {
             channels[i].pipelineFlush();
@@ -736,14 +736,13 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
 }
 
 // returns true when the processing of a queue has been done
-bool QHttpNetworkConnectionPrivate::fillPipeline(QList<HttpMessagePair> &queue, QHttpNetworkConnectionChannel &channel)
+bool QHttpNetworkConnectionPrivate::fillPipeline(QHttpNetworkConnectionChannel &channel)
 {
-    if (queue.isEmpty())
+    if (requestQueue.isEmpty())
         return true;
 
-    for (int i = queue.count() - 1; i >= 0; --i) {
-        HttpMessagePair messagePair = queue.at(i);
-        const QHttpNetworkRequest &request = messagePair.first;
+    for (QHttpNetworkRequestQueue::iterator it = requestQueue.begin(); it != requestQueue.end(); ++it) {
+        const QHttpNetworkRequest &request = it.value().first;
 
         // we currently do not support pipelining if HTTP authentication is used
         if (!request.url().userInfo().isEmpty())
@@ -757,7 +756,7 @@ bool QHttpNetworkConnectionPrivate::fillPipeline(QList<HttpMessagePair> &queue,
             continue;
 
         // remove it from the queue
-        queue.takeAt(i);
+        HttpMessagePair messagePair = requestQueue.take(it);
         // we modify the queue we iterate over here, but since we return from the function
         // afterwards this is fine.
 
@@ -868,42 +867,29 @@ void QHttpNetworkConnectionPrivate::removeReply(QHttpNetworkReply *reply)
                return;
             }
         }
-#ifndef QT_NO_SSL
-        // is the reply inside the SPDY pipeline of this channel already?
+        // is the reply inside the SPDY or HTTP/2 queue of this channel already?
         QMultiMap<int, HttpMessagePair>::iterator it = channels[i].spdyRequestsToSend.begin();
         QMultiMap<int, HttpMessagePair>::iterator end = channels[i].spdyRequestsToSend.end();
         for (; it != end; ++it) {
             if (it.value().second == reply) {
-                channels[i].spdyRequestsToSend.remove(it.key());
+                // only this one, others may be queued with the same priority
+                channels[i].spdyRequestsToSend.erase(it);
 
-                QMetaObject::invokeMethod(q, "_q_startNextRequest", Qt::QueuedConnection);
-                return;
-            }
-        }
-#endif
-    }
-    // remove from the high priority queue
-    if (!highPriorityQueue.isEmpty()) {
-        for (int j = highPriorityQueue.count() - 1; j >= 0; --j) {
-            HttpMessagePair messagePair = highPriorityQueue.at(j);
-            if (messagePair.second == reply) {
-                highPriorityQueue.removeAt(j);
-                QMetaObject::invokeMethod(q, "_q_startNextRequest", Qt::QueuedConnection);
-                return;
-            }
-        }
-    }
-    // remove from the low priority queue
-    if (!lowPriorityQueue.isEmpty()) {
-        for (int j = lowPriorityQueue.count() - 1; j >= 0; --j) {
-            HttpMessagePair messagePair = lowPriorityQueue.at(j);
-            if (messagePair.second == reply) {
-                lowPriorityQueue.removeAt(j);
                 QMetaObject::invokeMethod(q, "_q_startNextRequest", Qt::QueuedConnection);
                 return;
             }
         }
     }
+    // remove from the queue
+    if (requestQueue.remove(reply))
+        QMetaObject::invokeMethod(q, "_q_startNextRequest", Qt::QueuedConnection);
+}
+
+// Moves \a reply, if it is still waiting for a channel, behind all queued
+// requests of the same or a lower priority level.
+void QHttpNetworkConnectionPrivate::setPriorityLevel(QHttpNetworkReply *reply, int level)
+{
+    requestQueue.setPriorityLevel(reply, level);
 }
 
 
@@ -939,7 +925,7 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
     switch (connectionType) {
     case QHttpNetworkConnection::ConnectionTypeHTTP: {
         // return fast if there is nothing to do
-        if (highPriorityQueue.isEmpty() && lowPriorityQueue.isEmpty())
+        if (requestQueue.isEmpty())
             return;
 
         // try to get a free AND connected socket
@@ -953,10 +939,13 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
         }
         break;
     }
-    case QHttpNetworkConnection::ConnectionTypeSPDY: {
-#ifndef QT_NO_SSL
+    case QHttpNetworkConnection::ConnectionTypeSPDY:
+    case QHttpNetworkConnection::ConnectionTypeHTTP2: {
         if (channels[0].spdyRequestsToSend.isEmpty())
             return;
+        // a session that is shutting down reconnects once it is disconnected
+        if (channels[0].state == QHttpNetworkConnectionChannel::ClosingState)
+            return;
 
         if (networkLayerState == IPv4)
             channels[0].networkLayerPreference = QAbstractSocket::IPv4Protocol;
@@ -966,7 +955,6 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
         if (channels[0].socket && channels[0].socket->state() == QAbstractSocket::ConnectedState
                 && !channels[0].pendingEncrypt)
             channels[0].sendRequest();
-#endif // QT_NO_SSL
         break;
     }
     }
@@ -979,7 +967,7 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
     // on the connected sockets
     //tryToFillPipeline(socket);
     // return fast if there is nothing to pipeline
-    if (highPriorityQueue.isEmpty() && lowPriorityQueue.isEmpty())
+    if (requestQueue.isEmpty())
         return;
     for (int i = 0; i < channelCount; i++)
         if (channels[i].socket && channels[i].socket->state() == QAbstractSocket::ConnectedState)
@@ -988,7 +976,7 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
     // If there is not already any connected channels we need to connect a new one.
     // We do not pair the channel with the request until we know if it is
     // connected or not. This is to reuse connected channels before we connect new once.
-    int queuedRequests = highPriorityQueue.count() + lowPriorityQueue.count();
+    int queuedRequests = requestQueue.count();
 
     // in case we have in-flight preconnect requests and normal requests,
     // we only need one socket for each (preconnect, normal request) pair
@@ -1027,6 +1015,12 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
 
 void QHttpNetworkConnectionPrivate::readMoreLater(QHttpNetworkReply *reply)
 {
+    if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2) {
+        // all streams share the one channel; this lets the HTTP/2 handler
+        // reopen the reply's window
+        QMetaObject::invokeMethod(&channels[0], "_q_readyRead", Qt::QueuedConnection);
+        return;
+    }
     for (int i = 0 ; i < channelCount; ++i) {
         if (channels[i].reply ==  reply) {
             // emulate a readyRead() from the socket
@@ -1118,8 +1112,8 @@ void QHttpNetworkConnectionPrivate::_q_hostLookupFinished(QHostInfo info)
             emitReplyError(channels[0].socket, channels[0].reply, QNetworkReply::HostNotFoundError);
             networkLayerState = QHttpNetworkConnectionPrivate::Unknown;
         }
-#ifndef QT_NO_SSL
-        else if (connectionType == QHttpNetworkConnection::ConnectionTypeSPDY) {
+        else if (connectionType == QHttpNetworkConnection::ConnectionTypeSPDY
+                 || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2) {
             QList<HttpMessagePair> spdyPairs = channels[0].spdyRequestsToSend.values();
             for (int a = 0; a < spdyPairs.count(); ++a) {
                 // emit error for all replies
@@ -1128,7 +1122,6 @@ void QHttpNetworkConnectionPrivate::_q_hostLookupFinished(QHostInfo info)
                 emitReplyError(channels[0].socket, currentReply, QNetworkReply::HostNotFoundError);
             }
         }
-#endif // QT_NO_SSL
         else {
             // Should not happen
             qWarning() << "QHttpNetworkConnectionPrivate::_q_hostLookupFinished could not dequeu request";
@@ -1381,6 +1374,23 @@ void QHttpNetworkConnection::preConnectFinished()
     d_func()->preConnectRequests--;
 }
 
+QHttpNetworkConnectionStatistics QHttpNetworkConnection::statistics() const
+{
+    return d_func()->statistics;
+}
+
+QVariantMap QHttpNetworkConnectionStatistics::toVariantMap() const
+{
+    QVariantMap map;
+    map.insert(QStringLiteral("connectionsOpened"), connectionsOpened);
+    map.insert(QStringLiteral("requestsStarted"), requestsStarted);
+    map.insert(QStringLiteral("requestsReused"), requestsReused);
+    map.insert(QStringLiteral("maxRequestsInFlight"), maxRequestsInFlight);
+    map.insert(QStringLiteral("bytesSent"), bytesSent);
+    map.insert(QStringLiteral("bytesReceived"), bytesReceived);
+    return map;
+}
+
 #ifndef QT_NO_NETWORKPROXY
 // only called from QHttpNetworkConnectionChannel::_q_proxyAuthenticationRequired, not
 // from QHttpNetworkConnectionChannel::handleAuthenticationChallenge
@@ -1391,19 +1401,16 @@ void QHttpNetworkConnectionPrivate::emitProxyAuthenticationRequired(const QHttpN
     // dialog is displaying
     pauseConnection();
     QHttpNetworkReply *reply;
-#ifndef QT_NO_SSL
-    if (connectionType == QHttpNetworkConnection::ConnectionTypeSPDY) {
+    if (connectionType == QHttpNetworkConnection::ConnectionTypeSPDY
+        || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2) {
         // we choose the reply to emit the proxyAuth signal from somewhat arbitrarily,
         // but that does not matter because the signal will ultimately be emitted
         // by the QNetworkAccessManager.
         Q_ASSERT(chan->spdyRequestsToSend.count() > 0);
         reply = chan->spdyRequestsToSend.values().first().second;
     } else { // HTTP
-#endif // QT_NO_SSL
         reply = chan->reply;
-#ifndef QT_NO_SSL
     }
-#endif // QT_NO_SSL
 
     Q_ASSERT(reply);
     emit reply->proxyAuthenticationRequired(proxy, auth);
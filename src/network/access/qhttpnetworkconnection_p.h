@@ -63,6 +63,8 @@
 #include <qbuffer.h>
 #include <qtimer.h>
 #include <qsharedpointer.h>
+#include <qhash.h>
+#include <qmap.h>
 
 #include <private/qhttpnetworkheader_p.h>
 #include <private/qhttpnetworkrequest_p.h>
@@ -88,6 +90,24 @@ class QHttpNetworkReply;
 class QByteArray;
 class QHostInfo;
 
+// Counters over the lifetime of a QHttpNetworkConnection, for all its channels
+struct QHttpNetworkConnectionStatistics
+{
+    QHttpNetworkConnectionStatistics()
+        : connectionsOpened(0), requestsStarted(0), requestsReused(0),
+          maxRequestsInFlight(0), bytesSent(0), bytesReceived(0)
+    { }
+
+    QVariantMap toVariantMap() const;
+
+    int connectionsOpened;
+    int requestsStarted;
+    int requestsReused; // started on a connection that had been used before
+    int maxRequestsInFlight; // on one channel, pipelined or multiplexed
+    qint64 bytesSent;
+    qint64 bytesReceived;
+};
+
 class QHttpNetworkConnectionPrivate;
 class Q_AUTOTEST_EXPORT QHttpNetworkConnection : public QObject
 {
@@ -96,7 +116,8 @@ public:
 
     enum ConnectionType {
         ConnectionTypeHTTP,
-        ConnectionTypeSPDY
+        ConnectionTypeSPDY,
+        ConnectionTypeHTTP2
     };
 
 #ifndef QT_NO_BEARERMANAGEMENT
@@ -151,6 +172,8 @@ public:
 
     void preConnectFinished();
 
+    QHttpNetworkConnectionStatistics statistics() const;
+
 private:
     Q_DECLARE_PRIVATE(QHttpNetworkConnection)
     Q_DISABLE_COPY(QHttpNetworkConnection)
@@ -159,6 +182,7 @@ private:
     friend class QHttpNetworkConnectionChannel;
     friend class QHttpProtocolHandler;
     friend class QSpdyProtocolHandler;
+    friend class QHttp2ProtocolHandler;
 
     Q_PRIVATE_SLOT(d_func(), void _q_startNextRequest())
     Q_PRIVATE_SLOT(d_func(), void _q_hostLookupFinished(QHostInfo))
@@ -169,6 +193,35 @@ private:
 // private classes
 typedef QPair<QHttpNetworkRequest, QHttpNetworkReply*> HttpMessagePair;
 
+// The requests waiting for a channel, ordered by their priority level and,
+// within a level, by the order in which they were queued. Removing or
+// reprioritising a queued request takes O(log n).
+class QHttpNetworkRequestQueue
+{
+public:
+    typedef QPair<int, quint64> Key; // priority level, sequence number
+    typedef QMap<Key, HttpMessagePair>::iterator iterator;
+
+    QHttpNetworkRequestQueue() : nextSequenceNumber(0) { }
+
+    bool isEmpty() const { return pairs.isEmpty(); }
+    int count() const { return pairs.count(); }
+    iterator begin() { return pairs.begin(); }
+    iterator end() { return pairs.end(); }
+
+    void enqueue(const HttpMessagePair &pair);
+    const HttpMessagePair &first() const { return pairs.first(); }
+    HttpMessagePair takeFirst();
+    HttpMessagePair take(iterator it);
+    bool remove(QHttpNetworkReply *reply);
+    bool setPriorityLevel(QHttpNetworkReply *reply, int level);
+
+private:
+    QMap<Key, HttpMessagePair> pairs;
+    QHash<QHttpNetworkReply *, Key> keys;
+    quint64 nextSequenceNumber;
+};
+
 
 class QHttpNetworkConnectionPrivate : public QObjectPrivate
 {
@@ -214,7 +267,7 @@ public:
     QHttpNetworkRequest predictNextRequest();
 
     void fillPipeline(QAbstractSocket *socket);
-    bool fillPipeline(QList<HttpMessagePair> &queue, QHttpNetworkConnectionChannel &channel);
+    bool fillPipeline(QHttpNetworkConnectionChannel &channel);
 
     // read more HTTP body after the next event loop spin
     void readMoreLater(QHttpNetworkReply *reply);
@@ -237,6 +290,7 @@ public:
                         const QString &extraDetail = QString());
 
     void removeReply(QHttpNetworkReply *reply);
+    void setPriorityLevel(QHttpNetworkReply *reply, int level);
 
     QString hostName;
     quint16 port;
@@ -260,14 +314,15 @@ public:
     void emitProxyAuthenticationRequired(const QHttpNetworkConnectionChannel *chan, const QNetworkProxy &proxy, QAuthenticator* auth);
 #endif
 
-    //The request queues
-    QList<HttpMessagePair> highPriorityQueue;
-    QList<HttpMessagePair> lowPriorityQueue;
+    //The request queue
+    QHttpNetworkRequestQueue requestQueue;
 
     int preConnectRequests;
 
     QHttpNetworkConnection::ConnectionType connectionType;
 
+    QHttpNetworkConnectionStatistics statistics;
+
 #ifndef QT_NO_SSL
     QSharedPointer<QSslContext> sslContext;
 #endif
@@ -51,6 +51,7 @@
 
 #include <private/qhttpprotocolhandler_p.h>
 #include <private/qspdyprotocolhandler_p.h>
+#include <private/qhttp2protocolhandler_p.h>
 
 #ifndef QT_NO_SSL
 #    include <QtNetwork/qsslkey.h>
@@ -89,6 +90,7 @@ QHttpNetworkConnectionChannel::QHttpNetworkConnectionChannel()
     , pipeliningSupported(PipeliningSupportUnknown)
     , networkLayerPreference(QAbstractSocket::AnyIPProtocol)
     , connection(0)
+    , requestsOnConnection(0)
 {
     // Inlining this function in the header leads to compiler error on
     // release-armv5, on at least timebox 9.2 and 10.1.
@@ -120,6 +122,9 @@ void QHttpNetworkConnectionChannel::init()
     QObject::connect(socket, SIGNAL(connected()),
                      this, SLOT(_q_connected()),
                      Qt::DirectConnection);
+    QObject::connect(socket, SIGNAL(hostFound()),
+                     this, SLOT(_q_hostFound()),
+                     Qt::DirectConnection);
     QObject::connect(socket, SIGNAL(readyRead()),
                      this, SLOT(_q_readyRead()),
                      Qt::DirectConnection);
@@ -169,7 +174,9 @@ void QHttpNetworkConnectionChannel::init()
            sslSocket->setSslConfiguration(sslConfiguration);
     } else {
 #endif // QT_NO_SSL
-        protocolHandler.reset(new QHttpProtocolHandler(this));
+        // an HTTP/2 session is started for each connection in _q_connected()
+        if (connection->connectionType() != QHttpNetworkConnection::ConnectionTypeHTTP2)
+            protocolHandler.reset(new QHttpProtocolHandler(this));
 #ifndef QT_NO_SSL
     }
 #endif
@@ -193,6 +200,7 @@ void QHttpNetworkConnectionChannel::close()
 
     // pendingEncrypt must only be true in between connected and encrypted states
     pendingEncrypt = false;
+    requestsOnConnection = 0;
 
     if (socket)
         socket->close();
@@ -264,6 +272,9 @@ bool QHttpNetworkConnectionChannel::ensureConnection()
         // connect to the host if not already connected.
         state = QHttpNetworkConnectionChannel::ConnectingState;
         pendingEncrypt = ssl;
+        connectTimings = QHttpNetworkReplyTimings();
+        connectTimings.mark(QHttpNetworkReplyTimings::ConnectStart);
+        requestsOnConnection = reply ? 1 : 0;
 
         // reset state
         pipeliningSupported = PipeliningSupportUnknown;
@@ -606,6 +617,7 @@ void QHttpNetworkConnectionChannel::pipelineInto(HttpMessagePair &pair)
     reply->d_func()->connectionChannel = this;
     reply->d_func()->autoDecompress = request.d->autoDecompress;
     reply->d_func()->pipeliningUsed = true;
+    reply->d_func()->timings.mark(QHttpNetworkReplyTimings::RequestStart);
 
 #ifndef QT_NO_NETWORKPROXY
     pipeline.append(QHttpNetworkRequestPrivate::header(request,
@@ -615,10 +627,28 @@ void QHttpNetworkConnectionChannel::pipelineInto(HttpMessagePair &pair)
 #endif
 
     alreadyPipelinedRequests.append(pair);
+    requestStarted(reply, alreadyPipelinedRequests.count() + 1);
 
     // pipelineFlush() needs to be called at some point afterwards
 }
 
+// Records that reply was given to this channel, with requestsInFlight
+// requests (including it) now sent or being sent over its connection.
+void QHttpNetworkConnectionChannel::requestStarted(QHttpNetworkReply *reply, int requestsInFlight)
+{
+    QHttpNetworkReplyTimings &timings = reply->d_func()->timings;
+    timings.mark(QHttpNetworkReplyTimings::Dequeued);
+    timings.connectionReused = requestsOnConnection > 0 && socket
+            && socket->state() == QAbstractSocket::ConnectedState;
+    ++requestsOnConnection;
+
+    QHttpNetworkConnectionStatistics &statistics = connection->d_func()->statistics;
+    ++statistics.requestsStarted;
+    if (timings.connectionReused)
+        ++statistics.requestsReused;
+    statistics.maxRequestsInFlight = qMax(statistics.maxRequestsInFlight, requestsInFlight);
+}
+
 void QHttpNetworkConnectionChannel::pipelineFlush()
 {
     if (pipeline.isEmpty())
@@ -630,6 +660,7 @@ void QHttpNetworkConnectionChannel::pipelineFlush()
     // Also, sometimes the OS does it for us (Nagle's algorithm) but that
     // happens only sometimes.
     socket->write(pipeline);
+    connection->d_func()->statistics.bytesSent += pipeline.size();
     pipeline.clear();
 }
 
@@ -693,13 +724,27 @@ void QHttpNetworkConnectionChannel::_q_disconnected()
     }
     state = QHttpNetworkConnectionChannel::IdleState;
 
+    if (connection->connectionType() == QHttpNetworkConnection::ConnectionTypeHTTP2 && protocolHandler) {
+        QHttp2ProtocolHandler *http2Handler = static_cast<QHttp2ProtocolHandler *>(protocolHandler.data());
+        http2Handler->handleConnectionClosure(QNetworkReply::RemoteHostClosedError,
+                                              connection->d_func()->errorDetail(QNetworkReply::RemoteHostClosedError, socket));
+    }
+
     requeueCurrentlyPipelinedRequests();
     close();
 }
 
 
+void QHttpNetworkConnectionChannel::_q_hostFound()
+{
+    connectTimings.mark(QHttpNetworkReplyTimings::DomainLookupEnd);
+}
+
 void QHttpNetworkConnectionChannel::_q_connected()
 {
+    connectTimings.mark(QHttpNetworkReplyTimings::ConnectEnd);
+    ++connection->d_func()->statistics.connectionsOpened;
+
     // For the Happy Eyeballs we need to check if this is the first channel to connect.
     if (connection->d_func()->networkLayerState == QHttpNetworkConnectionPrivate::HostLookupPending || connection->d_func()->networkLayerState == QHttpNetworkConnectionPrivate::IPv4or6) {
         if (connection->d_func()->delayedConnectionTimer.isActive())
@@ -752,6 +797,11 @@ void QHttpNetworkConnectionChannel::_q_connected()
                 connection->setSslContext(socketSslContext);
         }
 #endif
+    } else if (connection->connectionType() == QHttpNetworkConnection::ConnectionTypeHTTP2) {
+        // HTTP/2 over TCP (h2c) with prior knowledge; every connection is a new session
+        state = QHttpNetworkConnectionChannel::IdleState;
+        protocolHandler.reset(new QHttp2ProtocolHandler(this));
+        sendRequest();
     } else {
         state = QHttpNetworkConnectionChannel::IdleState;
         if (!reply)
@@ -886,11 +936,15 @@ void QHttpNetworkConnectionChannel::_q_error(QAbstractSocket::SocketError socket
             if (protocolHandler)
                 protocolHandler->setReply(0);
         }
-    } while (!connection->d_func()->highPriorityQueue.isEmpty()
-             || !connection->d_func()->lowPriorityQueue.isEmpty());
-#ifndef QT_NO_SSL
-    if (connection->connectionType() == QHttpNetworkConnection::ConnectionTypeSPDY) {
+    } while (!connection->d_func()->requestQueue.isEmpty());
+    if (connection->connectionType() == QHttpNetworkConnection::ConnectionTypeHTTP2 && protocolHandler) {
+        // the streams in flight
+        static_cast<QHttp2ProtocolHandler *>(protocolHandler.data())->handleConnectionClosure(errorCode, errorString);
+    }
+    if (connection->connectionType() == QHttpNetworkConnection::ConnectionTypeSPDY
+        || connection->connectionType() == QHttpNetworkConnection::ConnectionTypeHTTP2) {
         QList<HttpMessagePair> spdyPairs = spdyRequestsToSend.values();
+        spdyRequestsToSend.clear();
         for (int a = 0; a < spdyPairs.count(); ++a) {
             // emit error for all replies
             QHttpNetworkReply *currentReply = spdyPairs.at(a).second;
@@ -898,7 +952,6 @@ void QHttpNetworkConnectionChannel::_q_error(QAbstractSocket::SocketError socket
             emit currentReply->finishedWithError(errorCode, errorString);
         }
     }
-#endif // QT_NO_SSL
 
     // send the next request
     QMetaObject::invokeMethod(that, "_q_startNextRequest", Qt::QueuedConnection);
@@ -910,19 +963,16 @@ void QHttpNetworkConnectionChannel::_q_error(QAbstractSocket::SocketError socket
 #ifndef QT_NO_NETWORKPROXY
 void QHttpNetworkConnectionChannel::_q_proxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator* auth)
 {
-#ifndef QT_NO_SSL
-    if (connection->connectionType() == QHttpNetworkConnection::ConnectionTypeSPDY) {
+    if (connection->connectionType() == QHttpNetworkConnection::ConnectionTypeSPDY
+        || connection->connectionType() == QHttpNetworkConnection::ConnectionTypeHTTP2) {
         connection->d_func()->emitProxyAuthenticationRequired(this, proxy, auth);
     } else { // HTTP
-#endif // QT_NO_SSL
         // Need to dequeue the request before we can emit the error.
         if (!reply)
             connection->d_func()->dequeueRequest(socket);
         if (reply)
             connection->d_func()->emitProxyAuthenticationRequired(this, proxy, auth);
-#ifndef QT_NO_SSL
     }
-#endif // QT_NO_SSL
 }
 #endif
 
@@ -936,6 +986,7 @@ void QHttpNetworkConnectionChannel::_q_encrypted()
 {
     QSslSocket *sslSocket = qobject_cast<QSslSocket *>(socket);
     Q_ASSERT(sslSocket);
+    connectTimings.mark(QHttpNetworkReplyTimings::SecureConnectionEnd);
 
     if (!protocolHandler) {
         switch (sslSocket->sslConfiguration().nextProtocolNegotiationStatus()) {
@@ -943,6 +994,11 @@ void QHttpNetworkConnectionChannel::_q_encrypted()
             QByteArray nextProtocol = sslSocket->sslConfiguration().nextNegotiatedProtocol();
             if (nextProtocol == QSslConfiguration::NextProtocolHttp1_1) {
                 // fall through to create a QHttpProtocolHandler
+            } else if (nextProtocol == QSslConfiguration::NextProtocolHttp2_0) {
+                protocolHandler.reset(new QHttp2ProtocolHandler(this));
+                connection->setConnectionType(QHttpNetworkConnection::ConnectionTypeHTTP2);
+                // like with SPDY the requests are in the right queue already
+                break;
             } else if (nextProtocol == QSslConfiguration::NextProtocolSpdy3_0) {
                 protocolHandler.reset(new QSpdyProtocolHandler(this));
                 connection->setConnectionType(QHttpNetworkConnection::ConnectionTypeSPDY);
@@ -969,6 +1025,9 @@ void QHttpNetworkConnectionChannel::_q_encrypted()
             emitFinishedWithError(QNetworkReply::SslHandshakeFailedError,
                                   "detected unknown Next Protocol Negotiation protocol");
         }
+    } else if (connection->connectionType() == QHttpNetworkConnection::ConnectionTypeHTTP2) {
+        // an HTTP/2 session does not survive its connection
+        protocolHandler.reset(new QHttp2ProtocolHandler(this));
     }
 
     if (!socket)
@@ -981,6 +1040,10 @@ void QHttpNetworkConnectionChannel::_q_encrypted()
         if (spdyRequestsToSend.count() > 0)
             // wait for data from the server first (e.g. initial window, max concurrent requests)
             QMetaObject::invokeMethod(connection, "_q_startNextRequest", Qt::QueuedConnection);
+    } else if (connection->connectionType() == QHttpNetworkConnection::ConnectionTypeHTTP2) {
+        // the HTTP/2 handler opens the streams right away and learns the
+        // server's limits as it goes
+        sendRequest();
     } else { // HTTP
         if (!reply)
             connection->d_func()->dequeueRequest(socket);
@@ -123,14 +123,15 @@ public:
     bool ignoreAllSslErrors;
     QList<QSslError> ignoreSslErrorsList;
     QSslConfiguration sslConfiguration;
-    QMultiMap<int, HttpMessagePair> spdyRequestsToSend; // sorted by priority
     void ignoreSslErrors();
     void ignoreSslErrors(const QList<QSslError> &errors);
     void setSslConfiguration(const QSslConfiguration &config);
-    void requeueSpdyRequests(); // when we wanted SPDY but got HTTP
+    void requeueSpdyRequests(); // when we wanted SPDY or HTTP/2 but got HTTP
     // to emit the signal for all in-flight replies:
     void emitFinishedWithError(QNetworkReply::NetworkError error, const char *message);
 #endif
+    // also used by HTTP/2, which does not need SSL
+    QMultiMap<int, HttpMessagePair> spdyRequestsToSend; // sorted by priority
 #ifndef QT_NO_BEARERMANAGEMENT
     QSharedPointer<QNetworkSession> networkSession;
 #endif
@@ -176,6 +177,11 @@ public:
     void handleUnexpectedEOF();
     void closeAndResendCurrentRequest();
 
+    // the connection stages of the current connection, see QHttpNetworkReply::timings()
+    QHttpNetworkReplyTimings connectTimings;
+    int requestsOnConnection; // the requests started on the current connection
+    void requestStarted(QHttpNetworkReply *reply, int requestsInFlight);
+
     bool isSocketBusy() const;
     bool isSocketWriting() const;
     bool isSocketWaiting() const;
@@ -187,6 +193,7 @@ public:
     void _q_readyRead(); // pending data to read
     void _q_disconnected(); // disconnected from host
     void _q_connected(); // start sending request
+    void _q_hostFound();
     void _q_error(QAbstractSocket::SocketError); // error from socket
 #ifndef QT_NO_NETWORKPROXY
     void _q_proxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *auth); // from transparent proxy
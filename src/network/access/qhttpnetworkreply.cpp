@@ -41,8 +41,10 @@
 
 #include "qhttpnetworkreply_p.h"
 #include "qhttpnetworkconnection_p.h"
+#include "qhttpcontentdecoder_p.h"
 
 #include <qbytearraymatcher.h>
+#include <qelapsedtimer.h>
 
 #ifndef QT_NO_HTTP
 
@@ -52,12 +54,49 @@
 #    include <QtNetwork/qsslconfiguration.h>
 #endif
 
-#ifndef QT_NO_COMPRESS
-#include <zlib.h>
-#endif
-
 QT_BEGIN_NAMESPACE
 
+namespace {
+struct StartedElapsedTimer : public QElapsedTimer
+{
+    StartedElapsedTimer() { start(); }
+};
+}
+Q_GLOBAL_STATIC(StartedElapsedTimer, timingClock)
+
+QHttpNetworkReplyTimings::QHttpNetworkReplyTimings()
+    : decodingTime(0), connectionReused(false)
+{
+    for (int i = 0; i < StageCount; ++i)
+        stamps[i] = -1;
+}
+
+qint64 QHttpNetworkReplyTimings::now()
+{
+    return timingClock()->nsecsElapsed();
+}
+
+// The stages in milliseconds since the request was queued, under the
+// names of the corresponding resource timing attributes.
+QVariantMap QHttpNetworkReplyTimings::toVariantMap() const
+{
+    static const char * const names[StageCount] = {
+        "queued", "dequeued", "connectStart", "domainLookupEnd", "connectEnd",
+        "secureConnectionEnd", "requestStart", "responseStart", "responseEnd"
+    };
+
+    QVariantMap map;
+    if (stamps[Queued] < 0)
+        return map;
+    for (int i = 0; i < StageCount; ++i) {
+        if (stamps[i] >= 0)
+            map.insert(QLatin1String(names[i]), (stamps[i] - stamps[Queued]) / 1000000.0);
+    }
+    map.insert(QStringLiteral("decodingTime"), decodingTime / 1000000.0);
+    map.insert(QStringLiteral("connectionReused"), connectionReused);
+    return map;
+}
+
 QHttpNetworkReply::QHttpNetworkReply(const QUrl &url, QObject *parent)
     : QObject(*new QHttpNetworkReplyPrivate(url), parent)
 {
@@ -69,11 +108,6 @@ QHttpNetworkReply::~QHttpNetworkReply()
     if (d->connection) {
         d->connection->d_func()->removeReply(this);
     }
-
-#ifndef QT_NO_COMPRESS
-    if (d->autoDecompress && d->isCompressed() && d->inflateStrm)
-        inflateEnd(d->inflateStrm);
-#endif
 }
 
 QUrl QHttpNetworkReply::url() const
@@ -236,6 +270,15 @@ void QHttpNetworkReply::setReadBufferSize(qint64 size)
     d->readBufferMaxSize = size;
 }
 
+// only has an effect while the request is still queued
+void QHttpNetworkReply::setPriorityLevel(int level)
+{
+    Q_D(QHttpNetworkReply);
+    d->request.setPriorityLevel(level);
+    if (d->connection)
+        d->connection->d_func()->setPriorityLevel(this, level);
+}
+
 bool QHttpNetworkReply::supportsUserProvidedDownloadBuffer()
 {
     Q_D(QHttpNetworkReply);
@@ -275,11 +318,35 @@ void QHttpNetworkReply::setSpdyWasUsed(bool spdy)
     d_func()->spdyUsed = spdy;
 }
 
+bool QHttpNetworkReply::isHttp2Used() const
+{
+    return d_func()->http2Used;
+}
+
+void QHttpNetworkReply::setHttp2WasUsed(bool http2)
+{
+    d_func()->http2Used = http2;
+}
+
 QHttpNetworkConnection* QHttpNetworkReply::connection()
 {
     return d_func()->connection;
 }
 
+QHttpNetworkReplyTimings QHttpNetworkReply::timings() const
+{
+    Q_D(const QHttpNetworkReply);
+    QHttpNetworkReplyTimings timings = d->timings;
+    // the channel keeps the stages of its connection for whichever
+    // request was the first one sent over it
+    if (!timings.connectionReused && d->connectionChannel) {
+        const QHttpNetworkReplyTimings &connectTimings = d->connectionChannel->connectTimings;
+        for (int i = QHttpNetworkReplyTimings::ConnectStart; i <= QHttpNetworkReplyTimings::SecureConnectionEnd; ++i)
+            timings.stamps[i] = connectTimings.stamps[i];
+    }
+    return timings;
+}
+
 
 QHttpNetworkReplyPrivate::QHttpNetworkReplyPrivate(const QUrl &newUrl)
     : QHttpNetworkHeaderPrivate(newUrl)
@@ -299,12 +366,8 @@ QHttpNetworkReplyPrivate::QHttpNetworkReplyPrivate(const QUrl &newUrl)
       totallyUploadedData(0),
       connection(0),
       autoDecompress(false), responseData(), requestIsPrepared(false)
-      ,pipeliningUsed(false), spdyUsed(false), downstreamLimited(false)
-      ,userProvidedDownloadBuffer(0)
-#ifndef QT_NO_COMPRESS
-      ,inflateStrm(0)
-#endif
-
+      ,pipeliningUsed(false), spdyUsed(false), http2Used(false), downstreamLimited(false)
+      ,userProvidedDownloadBuffer(0), decoder(0)
 {
     QString scheme = newUrl.scheme();
     if (scheme == QLatin1String("preconnect-http")
@@ -315,10 +378,7 @@ QHttpNetworkReplyPrivate::QHttpNetworkReplyPrivate(const QUrl &newUrl)
 
 QHttpNetworkReplyPrivate::~QHttpNetworkReplyPrivate()
 {
-#ifndef QT_NO_COMPRESS
-      if (inflateStrm)
-          delete inflateStrm;
-#endif
+    delete decoder;
 }
 
 void QHttpNetworkReplyPrivate::clearHttpLayerInformation()
@@ -332,10 +392,8 @@ void QHttpNetworkReplyPrivate::clearHttpLayerInformation()
     currentChunkRead = 0;
     lastChunkRead = false;
     connectionCloseEnabled = true;
-#ifndef QT_NO_COMPRESS
-    if (autoDecompress && inflateStrm)
-        inflateEnd(inflateStrm);
-#endif
+    delete decoder;
+    decoder = 0;
     fields.clear();
 }
 
@@ -356,8 +414,7 @@ qint64 QHttpNetworkReplyPrivate::bytesAvailable() const
 
 bool QHttpNetworkReplyPrivate::isCompressed()
 {
-    QByteArray encoding = headerField("content-encoding");
-    return qstricmp(encoding.constData(), "gzip") == 0 || qstricmp(encoding.constData(), "deflate") == 0;
+    return QHttpContentDecoder::isSupported(headerField("content-encoding"));
 }
 
 void QHttpNetworkReplyPrivate::removeAutoDecompressHeader()
@@ -561,16 +618,12 @@ qint64 QHttpNetworkReplyPrivate::readHeader(QAbstractSocket *socket)
             (majorVersion == 1 && minorVersion == 0 &&
             (connectionHeaderField.isEmpty() && !headerField("proxy-connection").toLower().contains("keep-alive")));
 
-#ifndef QT_NO_COMPRESS
         if (autoDecompress && isCompressed()) {
-            // allocate inflate state
-            if (!inflateStrm)
-                inflateStrm = new z_stream;
-            int ret = initializeInflateStream();
-            if (ret != Z_OK)
+            delete decoder;
+            decoder = QHttpContentDecoder::create(headerField("content-encoding"));
+            if (!decoder)
                 return -1;
         }
-#endif
 
     }
     return bytes;
@@ -675,13 +728,9 @@ qint64 QHttpNetworkReplyPrivate::readBody(QAbstractSocket *socket, QByteDataBuff
 {
     qint64 bytes = 0;
 
-#ifndef QT_NO_COMPRESS
-    // for gzip we'll allocate a temporary one that we then decompress
-    QByteDataBuffer *tempOutDataBuffer = (autoDecompress ? new QByteDataBuffer : out);
-#else
-    QByteDataBuffer *tempOutDataBuffer = out;
-#endif
-
+    // for compressed replies read into a temporary buffer that we then decode
+    QByteDataBuffer compressed;
+    QByteDataBuffer *tempOutDataBuffer = (autoDecompress ? &compressed : out);
 
     if (isChunked()) {
         // chunked transfer encoding (rfc 2616, sec 3.6)
@@ -696,92 +745,37 @@ qint64 QHttpNetworkReplyPrivate::readBody(QAbstractSocket *socket, QByteDataBuff
         bytes += readReplyBodyRaw(socket, tempOutDataBuffer, socket->bytesAvailable());
     }
 
-#ifndef QT_NO_COMPRESS
     // This is true if there is compressed encoding and we're supposed to use it.
     if (autoDecompress) {
         qint64 uncompressRet = uncompressBodyData(tempOutDataBuffer, out);
-        delete tempOutDataBuffer;
         if (uncompressRet < 0)
             return -1;
     }
-#endif
 
     contentRead += bytes;
     return bytes;
 }
 
-#ifndef QT_NO_COMPRESS
-int QHttpNetworkReplyPrivate::initializeInflateStream()
-{
-    inflateStrm->zalloc = Z_NULL;
-    inflateStrm->zfree = Z_NULL;
-    inflateStrm->opaque = Z_NULL;
-    inflateStrm->avail_in = 0;
-    inflateStrm->next_in = Z_NULL;
-    // "windowBits can also be greater than 15 for optional gzip decoding.
-    // Add 32 to windowBits to enable zlib and gzip decoding with automatic header detection"
-    // http://www.zlib.net/manual.html
-    int ret = inflateInit2(inflateStrm, MAX_WBITS+32);
-    Q_ASSERT(ret == Z_OK);
-    return ret;
-}
-
 qint64 QHttpNetworkReplyPrivate::uncompressBodyData(QByteDataBuffer *in, QByteDataBuffer *out)
 {
-    if (!inflateStrm) { // happens when called from the SPDY protocol handler
-        inflateStrm = new z_stream;
-        initializeInflateStream();
+    if (!decoder) { // happens when called from the SPDY or HTTP/2 protocol handler
+        decoder = QHttpContentDecoder::create(headerField("content-encoding"));
+        if (!decoder)
+            return -1;
     }
 
-    if (!inflateStrm)
-        return -1;
-
-    bool triedRawDeflate = false;
+    const qint64 decodingStart = QHttpNetworkReplyTimings::now();
     for (int i = 0; i < in->bufferCount(); i++) {
-        QByteArray &bIn = (*in)[i];
-
-        inflateStrm->avail_in = bIn.size();
-        inflateStrm->next_in = reinterpret_cast<Bytef*>(bIn.data());
-
-        do {
-            QByteArray bOut;
-            // make a wild guess about the uncompressed size.
-            bOut.reserve(inflateStrm->avail_in * 3 + 512);
-            inflateStrm->avail_out = bOut.capacity();
-            inflateStrm->next_out = reinterpret_cast<Bytef*>(bOut.data());
-
-            int ret = inflate(inflateStrm, Z_NO_FLUSH);
-            //All negative return codes are errors, in the context of HTTP compression, Z_NEED_DICT is also an error.
-            // in the case where we get Z_DATA_ERROR this could be because we received raw deflate compressed data.
-            if (ret == Z_DATA_ERROR && !triedRawDeflate) {
-                inflateEnd(inflateStrm);
-                triedRawDeflate = true;
-                inflateStrm->zalloc = Z_NULL;
-                inflateStrm->zfree = Z_NULL;
-                inflateStrm->opaque = Z_NULL;
-                inflateStrm->avail_in = 0;
-                inflateStrm->next_in = Z_NULL;
-                int ret = inflateInit2(inflateStrm, -MAX_WBITS);
-                if (ret != Z_OK) {
-                    return -1;
-                } else {
-                    inflateStrm->avail_in = bIn.size();
-                    inflateStrm->next_in = reinterpret_cast<Bytef*>(bIn.data());
-                    continue;
-                }
-            } else if (ret < 0 || ret == Z_NEED_DICT) {
-                return -1;
-            }
-            bOut.resize(bOut.capacity() - inflateStrm->avail_out);
-            out->append(bOut);
-            if (ret == Z_STREAM_END)
-                return out->byteAmount();
-        } while (inflateStrm->avail_in > 0);
+        const QByteArray &bIn = (*in)[i];
+        if (!decoder->decode(bIn.constData(), bIn.size(), out))
+            return -1;
+        if (decoder->isFinished())
+            break;
     }
+    timings.decodingTime += QHttpNetworkReplyTimings::now() - decodingStart;
 
     return out->byteAmount();
 }
-#endif
 
 qint64 QHttpNetworkReplyPrivate::readReplyBodyRaw(QAbstractSocket *socket, QByteDataBuffer *out, qint64 size)
 {
@@ -946,7 +940,6 @@ bool QHttpNetworkReplyPrivate::expectContent()
 
 void QHttpNetworkReplyPrivate::eraseData()
 {
-    compressedData.clear();
     responseData.clear();
 }
 
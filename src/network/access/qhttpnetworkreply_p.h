@@ -55,10 +55,6 @@
 #include <qplatformdefs.h>
 #ifndef QT_NO_HTTP
 
-#ifndef QT_NO_COMPRESS
-struct z_stream_s;
-#endif
-
 #include <QtNetwork/qtcpsocket.h>
 // it's safe to include these even if SSL support is not enabled
 #include <QtNetwork/qsslsocket.h>
@@ -67,6 +63,7 @@ struct z_stream_s;
 #include <QtNetwork/qnetworkrequest.h>
 #include <QtNetwork/qnetworkreply.h>
 #include <qbuffer.h>
+#include <qvariant.h>
 
 #include <private/qobject_p.h>
 #include <private/qhttpnetworkheader_p.h>
@@ -82,6 +79,40 @@ class QHttpNetworkConnectionChannel;
 class QHttpNetworkRequest;
 class QHttpNetworkConnectionPrivate;
 class QHttpNetworkReplyPrivate;
+class QHttpContentDecoder;
+
+// When a request passed through each stage of its transfer, in nanoseconds
+// on a monotonic clock shared by all requests, or -1 for the stages it did
+// not pass through. The connection stages are only set if the request was
+// the first one sent over its connection.
+struct QHttpNetworkReplyTimings
+{
+    enum Stage {
+        Queued,             // given to the QHttpNetworkConnection
+        Dequeued,           // given to a channel
+        ConnectStart,
+        DomainLookupEnd,
+        ConnectEnd,
+        SecureConnectionEnd,
+        RequestStart,       // started writing the request
+        ResponseStart,      // read the first byte of the response
+        ResponseEnd,
+        StageCount
+    };
+
+    QHttpNetworkReplyTimings();
+
+    static qint64 now();
+    inline void mark(Stage stage)
+    { if (stamps[stage] < 0) stamps[stage] = now(); }
+
+    QVariantMap toVariantMap() const;
+
+    qint64 stamps[StageCount];
+    qint64 decodingTime; // nanoseconds spent decompressing the body
+    bool connectionReused;
+};
+
 class Q_AUTOTEST_EXPORT QHttpNetworkReply : public QObject, public QHttpNetworkHeader
 {
     Q_OBJECT
@@ -124,6 +155,7 @@ public:
     qint64 sizeNextBlock();
     void setDownstreamLimited(bool t);
     void setReadBufferSize(qint64 size);
+    void setPriorityLevel(int level);
 
     bool supportsUserProvidedDownloadBuffer();
     void setUserProvidedDownloadBuffer(char*);
@@ -134,9 +166,13 @@ public:
     bool isPipeliningUsed() const;
     bool isSpdyUsed() const;
     void setSpdyWasUsed(bool spdy);
+    bool isHttp2Used() const;
+    void setHttp2WasUsed(bool http2);
 
     QHttpNetworkConnection* connection();
 
+    QHttpNetworkReplyTimings timings() const;
+
 #ifndef QT_NO_SSL
     QSslConfiguration sslConfiguration() const;
     void setSslConfiguration(const QSslConfiguration &config);
@@ -168,6 +204,7 @@ private:
     friend class QHttpNetworkConnectionChannel;
     friend class QHttpProtocolHandler;
     friend class QSpdyProtocolHandler;
+    friend class QHttp2ProtocolHandler;
 };
 
 
@@ -237,27 +274,26 @@ public:
     qint32 windowSizeUpload; // only for SPDY
     qint32 currentlyReceivedDataInWindow; // only for SPDY
     qint32 currentlyUploadedDataInWindow; // only for SPDY
-    qint64 totallyUploadedData; // only for SPDY
+    qint64 totallyUploadedData; // only for SPDY and HTTP/2
     QPointer<QHttpNetworkConnection> connection;
     QPointer<QHttpNetworkConnectionChannel> connectionChannel;
 
     bool autoDecompress;
 
     QByteDataBuffer responseData; // uncompressed body
-    QByteArray compressedData; // compressed body (temporary)
     bool requestIsPrepared;
 
     bool pipeliningUsed;
     bool spdyUsed;
+    bool http2Used;
     bool downstreamLimited;
 
     char* userProvidedDownloadBuffer;
 
-#ifndef QT_NO_COMPRESS
-    z_stream_s *inflateStrm;
-    int initializeInflateStream();
+    QHttpContentDecoder *decoder;
     qint64 uncompressBodyData(QByteDataBuffer *in, QByteDataBuffer *out);
-#endif
+
+    QHttpNetworkReplyTimings timings;
 };
 
 
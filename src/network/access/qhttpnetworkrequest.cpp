@@ -48,9 +48,10 @@ QT_BEGIN_NAMESPACE
 
 QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(QHttpNetworkRequest::Operation op,
         QHttpNetworkRequest::Priority pri, const QUrl &newUrl)
-    : QHttpNetworkHeaderPrivate(newUrl), operation(op), priority(pri), uploadByteDevice(0),
+    : QHttpNetworkHeaderPrivate(newUrl), operation(op), priority(pri),
+      priorityLevel(defaultPriorityLevel(pri)), uploadByteDevice(0),
       autoDecompress(false), pipeliningAllowed(false), spdyAllowed(false),
-      withCredentials(true), preConnect(false)
+      http2Allowed(false), withCredentials(true), preConnect(false)
 {
 }
 
@@ -59,10 +60,12 @@ QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(const QHttpNetworkRequest
 {
     operation = other.operation;
     priority = other.priority;
+    priorityLevel = other.priorityLevel;
     uploadByteDevice = other.uploadByteDevice;
     autoDecompress = other.autoDecompress;
     pipeliningAllowed = other.pipeliningAllowed;
     spdyAllowed = other.spdyAllowed;
+    http2Allowed = other.http2Allowed;
     customVerb = other.customVerb;
     withCredentials = other.withCredentials;
     ssl = other.ssl;
@@ -78,10 +81,12 @@ bool QHttpNetworkRequestPrivate::operator==(const QHttpNetworkRequestPrivate &ot
     return QHttpNetworkHeaderPrivate::operator==(other)
         && (operation == other.operation)
         && (priority == other.priority)
+        && (priorityLevel == other.priorityLevel)
         && (uploadByteDevice == other.uploadByteDevice)
         && (autoDecompress == other.autoDecompress)
         && (pipeliningAllowed == other.pipeliningAllowed)
         && (spdyAllowed == other.spdyAllowed)
+        && (http2Allowed == other.http2Allowed)
         // we do not clear the customVerb in setOperation
         && (operation != QHttpNetworkRequest::Custom || (customVerb == other.customVerb))
         && (withCredentials == other.withCredentials)
@@ -89,6 +94,20 @@ bool QHttpNetworkRequestPrivate::operator==(const QHttpNetworkRequestPrivate &ot
         && (preConnect == other.preConnect);
 }
 
+// the levels match the values of QNetworkRequest::Priority
+int QHttpNetworkRequestPrivate::defaultPriorityLevel(QHttpNetworkRequest::Priority priority)
+{
+    switch (priority) {
+    case QHttpNetworkRequest::HighPriority:
+        return 1;
+    case QHttpNetworkRequest::LowPriority:
+        return 5;
+    case QHttpNetworkRequest::NormalPriority:
+    default:
+        return 3;
+    }
+}
+
 QByteArray QHttpNetworkRequest::methodName() const
 {
     switch (d->operation) {
@@ -289,6 +308,17 @@ QHttpNetworkRequest::Priority QHttpNetworkRequest::priority() const
 void QHttpNetworkRequest::setPriority(Priority priority)
 {
     d->priority = priority;
+    d->priorityLevel = QHttpNetworkRequestPrivate::defaultPriorityLevel(priority);
+}
+
+int QHttpNetworkRequest::priorityLevel() const
+{
+    return d->priorityLevel;
+}
+
+void QHttpNetworkRequest::setPriorityLevel(int level)
+{
+    d->priorityLevel = level;
 }
 
 bool QHttpNetworkRequest::isPipeliningAllowed() const
@@ -311,6 +341,16 @@ void QHttpNetworkRequest::setSPDYAllowed(bool b)
     d->spdyAllowed = b;
 }
 
+bool QHttpNetworkRequest::isHTTP2Allowed() const
+{
+    return d->http2Allowed;
+}
+
+void QHttpNetworkRequest::setHTTP2Allowed(bool b)
+{
+    d->http2Allowed = b;
+}
+
 bool QHttpNetworkRequest::withCredentials() const
 {
     return d->withCredentials;
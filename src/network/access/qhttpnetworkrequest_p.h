@@ -111,12 +111,19 @@ public:
     Priority priority() const;
     void setPriority(Priority priority);
 
+    // finer grained than priority(), lower levels are sent first
+    int priorityLevel() const;
+    void setPriorityLevel(int level);
+
     bool isPipeliningAllowed() const;
     void setPipeliningAllowed(bool b);
 
     bool isSPDYAllowed() const;
     void setSPDYAllowed(bool b);
 
+    bool isHTTP2Allowed() const;
+    void setHTTP2Allowed(bool b);
+
     bool withCredentials() const;
     void setWithCredentials(bool b);
 
@@ -139,6 +146,7 @@ private:
     friend class QHttpNetworkConnectionChannel;
     friend class QHttpProtocolHandler;
     friend class QSpdyProtocolHandler;
+    friend class QHttp2ProtocolHandler;
 };
 
 class QHttpNetworkRequestPrivate : public QHttpNetworkHeaderPrivate
@@ -151,14 +159,17 @@ public:
     bool operator==(const QHttpNetworkRequestPrivate &other) const;
 
     static QByteArray header(const QHttpNetworkRequest &request, bool throughProxy);
+    static int defaultPriorityLevel(QHttpNetworkRequest::Priority priority);
 
     QHttpNetworkRequest::Operation operation;
     QByteArray customVerb;
     QHttpNetworkRequest::Priority priority;
+    int priorityLevel;
     mutable QNonContiguousByteDevice* uploadByteDevice;
     bool autoDecompress;
     bool pipeliningAllowed;
     bool spdyAllowed;
+    bool http2Allowed;
     bool withCredentials;
     bool ssl;
     bool preConnect;
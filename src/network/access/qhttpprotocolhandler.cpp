@@ -110,6 +110,8 @@ void QHttpProtocolHandler::_q_receiveReply()
                 m_channel->handleUnexpectedEOF();
                 return;
             }
+            if (statusBytes > 0)
+                m_reply->d_func()->timings.mark(QHttpNetworkReplyTimings::ResponseStart);
             bytes += statusBytes;
             m_channel->lastStatus = m_reply->d_func()->statusCode;
             break;
@@ -161,6 +163,7 @@ void QHttpProtocolHandler::_q_receiveReply()
                // We only do this when shouldEmitSignals==true because our HTTP parsing
                // always needs to parse the 401/407 replies. Therefore they don't really obey
                // to the read buffer maximum size, but we don't care since they should be small.
+               m_connection->d_func()->statistics.bytesReceived += bytes;
                return;
            }
 
@@ -224,6 +227,8 @@ void QHttpProtocolHandler::_q_receiveReply()
             break;
         }
     } while (bytes != lastBytes && m_reply);
+
+    m_connection->d_func()->statistics.bytesReceived += bytes;
 }
 
 void QHttpProtocolHandler::_q_readyRead()
@@ -317,7 +322,10 @@ bool QHttpProtocolHandler::sendRequest()
 #else
         QByteArray header = QHttpNetworkRequestPrivate::header(m_channel->request, false);
 #endif
+        if (m_channel->reply)
+            m_channel->reply->d_func()->timings.mark(QHttpNetworkReplyTimings::RequestStart);
         m_socket->write(header);
+        m_connection->d_func()->statistics.bytesSent += header.size();
         // flushing is dangerous (QSslSocket calls transmit which might read or error)
 //        m_socket->flush();
         QNonContiguousByteDevice* uploadByteDevice = m_channel->request.uploadByteDevice();
@@ -383,6 +391,7 @@ bool QHttpProtocolHandler::sendRequest()
                     return false;
                 } else {
                     m_channel->written += currentWriteSize;
+                    m_connection->d_func()->statistics.bytesSent += currentWriteSize;
                     uploadByteDevice->advanceReadPointer(currentWriteSize);
 
                     emit m_reply->dataSendProgress(m_channel->written, m_channel->bytesTotal);
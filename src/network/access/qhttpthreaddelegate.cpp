@@ -46,6 +46,8 @@
 #include <QTimer>
 #include <QAuthenticator>
 #include <QEventLoop>
+#include <QFile>
+#include <QLoggingCategory>
 
 #include "private/qhttpnetworkreply_p.h"
 #include "private/qnetworkaccesscache_p.h"
@@ -55,6 +57,8 @@
 
 QT_BEGIN_NAMESPACE
 
+Q_LOGGING_CATEGORY(lcHttpTiming, "qt.network.http.timing")
+
 static QNetworkReply::NetworkError statusCodeFromHttp(int httpStatusCode, const QUrl &url)
 {
     QNetworkReply::NetworkError code;
@@ -180,15 +184,15 @@ class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
     // Q_OBJECT
 public:
 #ifdef QT_NO_BEARERMANAGEMENT
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
-                                       QHttpNetworkConnection::ConnectionType connectionType)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType)
+    QNetworkAccessCachedHttpConnection(quint16 channelCount, const QString &hostName, quint16 port,
+                                       bool encrypt, QHttpNetworkConnection::ConnectionType connectionType)
+        : QHttpNetworkConnection(channelCount, hostName, port, encrypt, /*parent=*/0, connectionType)
 #else
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
-                                       QHttpNetworkConnection::ConnectionType connectionType,
+    QNetworkAccessCachedHttpConnection(quint16 channelCount, const QString &hostName, quint16 port,
+                                       bool encrypt, QHttpNetworkConnection::ConnectionType connectionType,
                                        QSharedPointer<QNetworkSession> networkSession)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType, /*parent=*/0,
-                                 networkSession)
+        : QHttpNetworkConnection(channelCount, hostName, port, encrypt, /*parent=*/0,
+                                 networkSession, connectionType)
 #endif
     {
         setExpires(true);
@@ -227,6 +231,7 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     QObject(parent)
     , ssl(false)
     , downloadBufferMaximumSize(0)
+    , channelCount(0)
     , readBufferMaxSize(0)
     , bytesEmitted(0)
     , pendingDownloadData(0)
@@ -235,9 +240,12 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     , incomingStatusCode(0)
     , isPipeliningUsed(false)
     , isSpdyUsed(false)
+    , isHttp2Used(false)
     , incomingContentLength(-1)
     , incomingErrorCode(QNetworkReply::NoError)
     , downloadBuffer(0)
+    , downloadFile(0)
+    , downloadFileSize(0)
     , httpConnection(0)
     , httpReply(0)
     , synchronousRequestLoop(0)
@@ -289,7 +297,16 @@ void QHttpThreadDelegate::startRequest()
     QHttpNetworkConnection::ConnectionType connectionType
             = QHttpNetworkConnection::ConnectionTypeHTTP;
 #ifndef QT_NO_SSL
-    if (httpRequest.isSPDYAllowed() && ssl) {
+    if (httpRequest.isHTTP2Allowed() && ssl) {
+        connectionType = QHttpNetworkConnection::ConnectionTypeHTTP2;
+        urlCopy.setScheme(QStringLiteral("h2")); // to differentiate HTTP/2 requests from HTTPS requests
+        QList<QByteArray> nextProtocols;
+        nextProtocols << QSslConfiguration::NextProtocolHttp2_0;
+        if (httpRequest.isSPDYAllowed())
+            nextProtocols << QSslConfiguration::NextProtocolSpdy3_0;
+        nextProtocols << QSslConfiguration::NextProtocolHttp1_1;
+        incomingSslConfiguration.setAllowedNextProtocols(nextProtocols);
+    } else if (httpRequest.isSPDYAllowed() && ssl) {
         connectionType = QHttpNetworkConnection::ConnectionTypeSPDY;
         urlCopy.setScheme(QStringLiteral("spdy")); // to differentiate SPDY requests from HTTPS requests
         QList<QByteArray> nextProtocols;
@@ -298,6 +315,16 @@ void QHttpThreadDelegate::startRequest()
         incomingSslConfiguration.setAllowedNextProtocols(nextProtocols);
     }
 #endif // QT_NO_SSL
+    // Without TLS there is nothing to negotiate with; the server is known to
+    // speak HTTP/2 (prior knowledge), which an HTTP proxy would not forward.
+    if (httpRequest.isHTTP2Allowed() && !ssl
+#ifndef QT_NO_NETWORKPROXY
+        && cacheProxy.type() == QNetworkProxy::NoProxy
+#endif
+        ) {
+        connectionType = QHttpNetworkConnection::ConnectionTypeHTTP2;
+        urlCopy.setScheme(QStringLiteral("h2c"));
+    }
 
 #ifndef QT_NO_NETWORKPROXY
     if (transparentProxy.type() != QNetworkProxy::NoProxy)
@@ -308,6 +335,16 @@ void QHttpThreadDelegate::startRequest()
 #endif
         cacheKey = makeCacheKey(urlCopy, 0);
 
+    // SPDY and HTTP/2 multiplex all requests over a single channel
+    quint16 connectionChannelCount = QHttpNetworkConnectionPrivate::defaultHttpChannelCount;
+    if (connectionType == QHttpNetworkConnection::ConnectionTypeSPDY
+        || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2) {
+        connectionChannelCount = 1;
+    } else if (channelCount > 0) {
+        // don't hand this request to a connection with a different number of channels
+        connectionChannelCount = quint16(qMin(channelCount, 0xffff));
+        cacheKey += "/channels:" + QByteArray::number(channelCount);
+    }
 
     // the http object is actually a QHttpNetworkConnection
     httpConnection = static_cast<QNetworkAccessCachedHttpConnection *>(connections.localData()->requestEntryNow(cacheKey));
@@ -315,11 +352,11 @@ void QHttpThreadDelegate::startRequest()
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
 #ifdef QT_NO_BEARERMANAGEMENT
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
-                                                                connectionType);
+        httpConnection = new QNetworkAccessCachedHttpConnection(connectionChannelCount, urlCopy.host(),
+                                                                urlCopy.port(), ssl, connectionType);
 #else
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
-                                                                connectionType,
+        httpConnection = new QNetworkAccessCachedHttpConnection(connectionChannelCount, urlCopy.host(),
+                                                                urlCopy.port(), ssl, connectionType,
                                                                 networkSession);
 #endif
 #ifndef QT_NO_SSL
@@ -414,6 +451,14 @@ void QHttpThreadDelegate::readBufferSizeChanged(qint64 size)
     }
 }
 
+// This gets called from the user thread when the reply was reprioritised
+void QHttpThreadDelegate::priorityLevelChanged(int level)
+{
+    httpRequest.setPriorityLevel(level);
+    if (httpReply)
+        httpReply->setPriorityLevel(level);
+}
+
 void QHttpThreadDelegate::readBufferFreed(qint64 size)
 {
     if (readBufferMaxSize) {
@@ -432,6 +477,14 @@ void QHttpThreadDelegate::readyReadSlot()
     if (!downloadBuffer.isNull())
         return;
 
+    if (downloadFile) {
+        if (writeToDownloadFile()) {
+            pendingDownloadProgress->fetchAndAddRelease(1);
+            emit downloadProgress(downloadFileSize, incomingContentLength);
+        }
+        return;
+    }
+
     if (readBufferMaxSize) {
         if (bytesEmitted < readBufferMaxSize) {
             qint64 sizeEmitted = 0;
@@ -469,6 +522,15 @@ void QHttpThreadDelegate::finishedSlot()
     qDebug() << "QHttpThreadDelegate::finishedSlot() thread=" << QThread::currentThreadId() << "result=" << httpReply->statusCode();
 #endif
 
+    if (downloadFile) {
+        // the file is complete once the reply has finished
+        if (!writeToDownloadFile())
+            return;
+        downloadFile->close();
+        pendingDownloadProgress->fetchAndAddRelease(1);
+        emit downloadProgress(downloadFileSize, downloadFileSize);
+    }
+
     // If there is still some data left emit that now
     while (httpReply->readAnyAvailable()) {
         pendingDownloadData->fetchAndAddRelease(1);
@@ -480,6 +542,9 @@ void QHttpThreadDelegate::finishedSlot()
         emit sslConfigurationChanged(httpReply->sslConfiguration());
 #endif
 
+    collectStatistics();
+    emit statistics(incomingTimings, incomingConnectionStatistics);
+
     if (httpReply->statusCode() >= 400) {
             // it's an error reply
             QString msg = QLatin1String(QT_TRANSLATE_NOOP("QNetworkReply",
@@ -512,6 +577,7 @@ void QHttpThreadDelegate::synchronousFinishedSlot()
     }
 
     synchronousDownloadData = httpReply->readAll();
+    collectStatistics();
 
     QMetaObject::invokeMethod(httpReply, "deleteLater", Qt::QueuedConnection);
     QMetaObject::invokeMethod(synchronousRequestLoop, "quit", Qt::QueuedConnection);
@@ -531,6 +597,8 @@ void QHttpThreadDelegate::finishedWithErrorSlot(QNetworkReply::NetworkError erro
     if (ssl)
         emit sslConfigurationChanged(httpReply->sslConfiguration());
 #endif
+    collectStatistics();
+    emit statistics(incomingTimings, incomingConnectionStatistics);
     emit error(errorCode,detail);
     emit downloadFinished();
 
@@ -551,6 +619,7 @@ void QHttpThreadDelegate::synchronousFinishedWithErrorSlot(QNetworkReply::Networ
 #endif
     incomingErrorCode = errorCode;
     incomingErrorDetail = detail;
+    collectStatistics();
 
     QMetaObject::invokeMethod(httpReply, "deleteLater", Qt::QueuedConnection);
     QMetaObject::invokeMethod(synchronousRequestLoop, "quit", Qt::QueuedConnection);
@@ -576,17 +645,34 @@ void QHttpThreadDelegate::headerChangedSlot()
         emit sslConfigurationChanged(httpReply->sslConfiguration());
 #endif
 
+    // Should the body of this reply go to a file instead of the user thread?
+    if (!downloadFileName.isEmpty() && httpReply->statusCode() >= 200 && httpReply->statusCode() < 300) {
+        QScopedPointer<QFile> file(new QFile(downloadFileName, this));
+        if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QString msg = QLatin1String(QT_TRANSLATE_NOOP("QNetworkReply", "Error writing %1: %2"));
+            finishedWithErrorSlot(QNetworkReply::UnknownContentError,
+                                  msg.arg(downloadFileName, file->errorString()));
+            return;
+        }
+        downloadFile = file.take();
+    }
+
     // Is using a zerocopy buffer allowed by user and possible with this reply?
-    if (httpReply->supportsUserProvidedDownloadBuffer()
+    if (!downloadFile && httpReply->supportsUserProvidedDownloadBuffer()
         && (downloadBufferMaximumSize > 0) && (httpReply->contentLength() <= downloadBufferMaximumSize)) {
-        QT_TRY {
-            char *buf = new char[httpReply->contentLength()]; // throws if allocation fails
-            if (buf) {
-                downloadBuffer = QSharedPointer<char>(buf, downloadBufferDeleter);
-                httpReply->setUserProvidedDownloadBuffer(buf);
+        if (!userDownloadBuffer.isNull()) {
+            downloadBuffer = userDownloadBuffer;
+            httpReply->setUserProvidedDownloadBuffer(downloadBuffer.data());
+        } else {
+            QT_TRY {
+                char *buf = new char[httpReply->contentLength()]; // throws if allocation fails
+                if (buf) {
+                    downloadBuffer = QSharedPointer<char>(buf, downloadBufferDeleter);
+                    httpReply->setUserProvidedDownloadBuffer(buf);
+                }
+            } QT_CATCH(const std::bad_alloc &) {
+                // in out of memory situations, don't use downloadbuffer.
             }
-        } QT_CATCH(const std::bad_alloc &) {
-            // in out of memory situations, don't use downloadbuffer.
         }
     }
 
@@ -597,6 +683,7 @@ void QHttpThreadDelegate::headerChangedSlot()
     isPipeliningUsed = httpReply->isPipeliningUsed();
     incomingContentLength = httpReply->contentLength();
     isSpdyUsed = httpReply->isSpdyUsed();
+    isHttp2Used = httpReply->isHttp2Used();
 
     emit downloadMetaData(incomingHeaders,
                           incomingStatusCode,
@@ -604,7 +691,8 @@ void QHttpThreadDelegate::headerChangedSlot()
                           isPipeliningUsed,
                           downloadBuffer,
                           incomingContentLength,
-                          isSpdyUsed);
+                          isSpdyUsed,
+                          isHttp2Used);
 }
 
 void QHttpThreadDelegate::synchronousHeaderChangedSlot()
@@ -621,6 +709,7 @@ void QHttpThreadDelegate::synchronousHeaderChangedSlot()
     incomingReasonPhrase = httpReply->reasonPhrase();
     isPipeliningUsed = httpReply->isPipeliningUsed();
     isSpdyUsed = httpReply->isSpdyUsed();
+    isHttp2Used = httpReply->isHttp2Used();
     incomingContentLength = httpReply->contentLength();
 }
 
@@ -636,6 +725,35 @@ void QHttpThreadDelegate::dataReadProgressSlot(qint64 done, qint64 total)
     emit downloadProgress(done, total);
 }
 
+// Moves the body data received so far into the download file, without
+// passing it to the user thread
+bool QHttpThreadDelegate::writeToDownloadFile()
+{
+    while (httpReply->readAnyAvailable()) {
+        const QByteArray data = httpReply->readAny();
+        if (downloadFile->write(data) != data.size()) {
+            QString msg = QLatin1String(QT_TRANSLATE_NOOP("QNetworkReply", "Error writing %1: %2"));
+            finishedWithErrorSlot(QNetworkReply::UnknownContentError,
+                                  msg.arg(downloadFileName, downloadFile->errorString()));
+            return false;
+        }
+        downloadFileSize += data.size();
+    }
+    return true;
+}
+
+// Takes the timings of the finished reply and the counters of its connection
+void QHttpThreadDelegate::collectStatistics()
+{
+    QHttpNetworkReplyTimings timings = httpReply->timings();
+    timings.mark(QHttpNetworkReplyTimings::ResponseEnd);
+    incomingTimings = timings.toVariantMap();
+    if (httpConnection)
+        incomingConnectionStatistics = httpConnection->statistics().toVariantMap();
+
+    qCDebug(lcHttpTiming) << httpRequest.url() << incomingTimings << incomingConnectionStatistics;
+}
+
 void QHttpThreadDelegate::cacheCredentialsSlot(const QHttpNetworkRequest &request, QAuthenticator *authenticator)
 {
     authenticationManager->cacheCredentials(request.url(), authenticator);
@@ -73,6 +73,7 @@
 QT_BEGIN_NAMESPACE
 
 class QAuthenticator;
+class QFile;
 class QHttpNetworkReply;
 class QEventLoop;
 class QNetworkAccessCache;
@@ -93,6 +94,12 @@ public:
 #endif
     QHttpNetworkRequest httpRequest;
     qint64 downloadBufferMaximumSize;
+    // A zerocopy buffer of downloadBufferMaximumSize bytes provided by the user
+    QSharedPointer<char> userDownloadBuffer;
+    // The file that a successful reply's body is written to, if any
+    QString downloadFileName;
+    // The number of parallel connections to the host, 0 for the default
+    int channelCount;
     qint64 readBufferMaxSize;
     qint64 bytesEmitted;
     // From backend, modified by us for signal compression
@@ -112,7 +119,10 @@ public:
     QString incomingReasonPhrase;
     bool isPipeliningUsed;
     bool isSpdyUsed;
+    bool isHttp2Used;
     qint64 incomingContentLength;
+    QVariantMap incomingTimings;
+    QVariantMap incomingConnectionStatistics;
     QNetworkReply::NetworkError incomingErrorCode;
     QString incomingErrorDetail;
 #ifndef QT_NO_BEARERMANAGEMENT
@@ -122,6 +132,9 @@ public:
 protected:
     // The zerocopy download buffer, if used:
     QSharedPointer<char> downloadBuffer;
+    // The file the body is written to, if used:
+    QFile *downloadFile;
+    qint64 downloadFileSize;
     // The QHttpNetworkConnection that is used
     QNetworkAccessCachedHttpConnection *httpConnection;
     QByteArray cacheKey;
@@ -130,6 +143,9 @@ protected:
     // Used for implementing the synchronous HTTP, see startRequestSynchronously()
     QEventLoop *synchronousRequestLoop;
 
+    bool writeToDownloadFile();
+    void collectStatistics();
+
 signals:
     void authenticationRequired(const QHttpNetworkRequest &request, QAuthenticator *);
 #ifndef QT_NO_NETWORKPROXY
@@ -141,9 +157,10 @@ signals:
     void sslConfigurationChanged(const QSslConfiguration);
 #endif
     void downloadMetaData(QList<QPair<QByteArray,QByteArray> >, int, QString, bool,
-                          QSharedPointer<char>, qint64, bool);
+                          QSharedPointer<char>, qint64, bool, bool);
     void downloadProgress(qint64, qint64);
     void downloadData(QByteArray);
+    void statistics(QVariantMap, QVariantMap);
     void error(QNetworkReply::NetworkError, const QString);
     void downloadFinished();
 public slots:
@@ -152,6 +169,7 @@ public slots:
     void abortRequest();
     void readBufferSizeChanged(qint64 size);
     void readBufferFreed(qint64 size);
+    void priorityLevelChanged(int level);
 
     // This is called with a BlockingQueuedConnection from user thread
     void startRequestSynchronously();
@@ -981,7 +981,8 @@ QNetworkAccessManager::NetworkAccessibility QNetworkAccessManager::networkAccess
     on \a sslConfiguration with QSslConfiguration::NextProtocolSpdy3_0 contained in
     the list of allowed protocols. When using SPDY, one single connection per host is
     enough, i.e. calling this method multiple times per host will not result in faster
-    network transactions.
+    network transactions. The same goes for HTTP/2 and
+    QSslConfiguration::NextProtocolHttp2_0.
 
     \note This function has no possibility to report errors.
 
@@ -998,11 +999,14 @@ void QNetworkAccessManager::connectToHostEncrypted(const QString &hostName, quin
     if (sslConfiguration != QSslConfiguration::defaultConfiguration())
         request.setSslConfiguration(sslConfiguration);
 
-    // There is no way to enable SPDY via a request, so we need to check
-    // the ssl configuration whether SPDY is allowed here.
+    // There is no way to enable SPDY or HTTP/2 via a request, so we need to
+    // check the ssl configuration whether they are allowed here.
     if (sslConfiguration.allowedNextProtocols().contains(
                 QSslConfiguration::NextProtocolSpdy3_0))
         request.setAttribute(QNetworkRequest::SpdyAllowedAttribute, true);
+    if (sslConfiguration.allowedNextProtocols().contains(
+                QSslConfiguration::NextProtocolHttp2_0))
+        request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
 
     get(request);
 }
@@ -0,0 +1,961 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+//#define QNETWORKINDEXEDDISKCACHE_DEBUG
+
+
+#include "qnetworkindexeddiskcache.h"
+#include "qnetworkindexeddiskcache_p.h"
+#include "QtCore/qscopedpointer.h"
+
+#include <qfile.h>
+#include <qdir.h>
+#include <qsavefile.h>
+#include <qurl.h>
+#include <qdebug.h>
+
+#define INDEXED_DATA_DIR QLatin1String("indexed")
+#define INDEX_FILE QLatin1String("index")
+#define SEGMENT_POSTFIX QLatin1String(".seg")
+#define PREPARED_SLASH QLatin1String("prepared/")
+
+// items up to this size are packed into the shared segments, larger ones
+// are moved into a segment of their own without copying
+#define MAX_PACKED_SIZE (64 * 1024)
+// payloads smaller than this are read into memory by data(), larger ones
+// are memory mapped and read from the mapping without copying
+#define MIN_MAPPED_SIZE (16 * 1024)
+// the index log is rewritten once it holds this many records more than
+// twice the number of entries
+#define MIN_INDEX_RECORDS 256
+
+#ifndef QT_NO_NETWORKDISKCACHE
+
+QT_BEGIN_NAMESPACE
+
+enum
+{
+    RecordMagic = 0xe9,
+    RecordVersion = 1,
+    IndexMagic = 0x51494443,
+    IndexVersion = 1
+};
+
+/*!
+    \class QNetworkIndexedDiskCache
+    \since 5.4
+    \inmodule QtNetwork
+
+    \brief The QNetworkIndexedDiskCache class provides a disk cache that keeps
+    its entries in a small number of files and an index.
+
+    QNetworkIndexedDiskCache can be used in place of QNetworkDiskCache when
+    the cache holds many entries. Instead of storing each url in a file of its
+    own, items are appended back to back to segment files inside the
+    cacheDirectory, and an index records for every url the segment, offset and
+    size of its item. Items larger than 64KB get a segment of their own.
+
+    The index is kept in memory and persisted as an append only log, so
+    looking up, inserting and removing an item never touches more than one
+    segment and one index record on disk. Entries are kept in least recently
+    used order; metaData() and data() mark an entry as used. expire() evicts
+    the least recently used entries without scanning the cache directory.
+    The order of use is written to disk by sync() and when the cache is
+    destroyed.
+
+    Space left behind in the segments by removed or replaced items is
+    reclaimed by copying the remaining items of mostly unused segments into
+    the current one, once the unused space in all segments exceeds a quarter
+    of maximumCacheSize().
+
+    Like QNetworkDiskCache, files with a text MimeType are compressed using
+    qCompress, and data is only written to disk in insert() and
+    updateMetaData(). The cache files cannot be shared with more than one
+    cache object, nor with a QNetworkDiskCache.
+
+    \sa QNetworkDiskCache
+*/
+
+/*!
+    Creates a new disk cache. The \a parent argument is passed to
+    QAbstractNetworkCache's constructor.
+ */
+QNetworkIndexedDiskCache::QNetworkIndexedDiskCache(QObject *parent)
+    : QAbstractNetworkCache(*new QNetworkIndexedDiskCachePrivate, parent)
+{
+}
+
+/*!
+    Destroys the cache object after writing its index with sync(). This does
+    not clear the disk cache.
+ */
+QNetworkIndexedDiskCache::~QNetworkIndexedDiskCache()
+{
+    Q_D(QNetworkIndexedDiskCache);
+    qDeleteAll(d->inserting);
+    d->close();
+}
+
+/*!
+    Returns the location where cached files will be stored.
+*/
+QString QNetworkIndexedDiskCache::cacheDirectory() const
+{
+    Q_D(const QNetworkIndexedDiskCache);
+    return d->cacheDirectory;
+}
+
+/*!
+    Sets the directory where cached files will be stored to \a cacheDir
+
+    QNetworkIndexedDiskCache will create this directory if it does not exist
+    and load the index of any cache previously stored in it.
+
+    Prepared cache items will be stored in the new cache directory when
+    they are inserted.
+
+    \sa QStandardPaths::CacheLocation
+*/
+void QNetworkIndexedDiskCache::setCacheDirectory(const QString &cacheDir)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::setCacheDirectory()" << cacheDir;
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+    if (cacheDir.isEmpty())
+        return;
+    d->close();
+    d->cacheDirectory = cacheDir;
+    QDir dir(d->cacheDirectory);
+    d->cacheDirectory = dir.absolutePath();
+    if (!d->cacheDirectory.endsWith(QLatin1Char('/')))
+        d->cacheDirectory += QLatin1Char('/');
+
+    d->dataDirectory = d->cacheDirectory + INDEXED_DATA_DIR + QString::number(IndexVersion) + QLatin1Char('/');
+    d->open();
+}
+
+/*!
+    \reimp
+*/
+qint64 QNetworkIndexedDiskCache::cacheSize() const
+{
+    Q_D(const QNetworkIndexedDiskCache);
+    return d->currentCacheSize;
+}
+
+/*!
+    \reimp
+*/
+QIODevice *QNetworkIndexedDiskCache::prepare(const QNetworkCacheMetaData &metaData)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::prepare()" << metaData.url();
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+    if (!metaData.isValid() || !metaData.url().isValid() || !metaData.saveToDisk())
+        return 0;
+
+    if (d->cacheDirectory.isEmpty()) {
+        qWarning() << "QNetworkIndexedDiskCache::prepare() The cache directory is not set";
+        return 0;
+    }
+
+    qint64 contentLength = -1;
+    foreach (const QNetworkCacheMetaData::RawHeader &header, metaData.rawHeaders()) {
+        if (header.first.toLower() == "content-length") {
+            contentLength = header.second.toLongLong();
+            if (contentLength > (maximumCacheSize() * 3)/4)
+                return 0;
+            break;
+        }
+    }
+    QScopedPointer<QIndexedCacheItem> cacheItem(new QIndexedCacheItem);
+    cacheItem->metaData = metaData;
+
+    QIODevice *device = 0;
+    if (cacheItem->canCompress() || (contentLength >= 0 && contentLength <= MAX_PACKED_SIZE)) {
+        cacheItem->data.open(QBuffer::ReadWrite);
+        device = &(cacheItem->data);
+    } else {
+        QString templateName = d->dataDirectory + PREPARED_SLASH + QLatin1String("XXXXXX");
+        QT_TRY {
+            cacheItem->file = new QTemporaryFile(templateName, &cacheItem->data);
+        } QT_CATCH(...) {
+            cacheItem->file = 0;
+        }
+        if (!cacheItem->file || !cacheItem->file->open()) {
+            qWarning() << "QNetworkIndexedDiskCache::prepare() unable to open temporary file";
+            cacheItem.reset();
+            return 0;
+        }
+        QDataStream out(cacheItem->file);
+        out << qint32(RecordMagic) << qint32(RecordVersion)
+            << QNetworkIndexedDiskCachePrivate::cacheKey(metaData.url()) << metaData << false;
+        cacheItem->headerSize = cacheItem->file->pos();
+        device = cacheItem->file;
+    }
+    d->inserting[device] = cacheItem.take();
+    return device;
+}
+
+/*!
+    \reimp
+*/
+void QNetworkIndexedDiskCache::insert(QIODevice *device)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::insert()" << device;
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+    QHash<QIODevice*, QIndexedCacheItem*>::iterator it = d->inserting.find(device);
+    if (it == d->inserting.end()) {
+        qWarning() << "QNetworkIndexedDiskCache::insert() called on a device we don't know about" << device;
+        return;
+    }
+
+    d->storeItem(it.value());
+    delete it.value();
+    d->inserting.erase(it);
+}
+
+void QNetworkIndexedDiskCachePrivate::storeItem(QIndexedCacheItem *cacheItem)
+{
+    Q_Q(QNetworkIndexedDiskCache);
+    Q_ASSERT(cacheItem->metaData.saveToDisk());
+
+    QScopedPointer<Entry> entry(new Entry);
+    entry->key = cacheKey(cacheItem->metaData.url());
+    entry->prev = entry->next = 0;
+
+    bool stored = false;
+    if (!cacheItem->file) {
+        QByteArray record;
+        QDataStream out(&record, QIODevice::WriteOnly);
+        bool compressed = cacheItem->canCompress();
+        out << qint32(RecordMagic) << qint32(RecordVersion) << entry->key << cacheItem->metaData << compressed;
+        entry->headerSize = record.size();
+        record += compressed ? qCompress(cacheItem->data.data()) : cacheItem->data.data();
+        stored = appendRecord(record, entry.data());
+    } else if (cacheItem->file->isOpen() && cacheItem->file->error() == QFile::NoError) {
+        QTemporaryFile *file = cacheItem->file;
+        const qint64 size = file->size();
+        entry->headerSize = cacheItem->headerSize;
+        if (size <= MAX_PACKED_SIZE) {
+            file->seek(0);
+            stored = appendRecord(file->readAll(), entry.data());
+        } else {
+            const quint32 segment = nextSegment++;
+            file->setAutoRemove(false);
+            if (file->rename(segmentFileName(segment))) {
+                Segment &s = segments[segment];
+                s.size = s.liveBytes = size;
+                entry->segment = segment;
+                entry->offset = 0;
+                entry->size = size;
+                stored = true;
+            } else {
+                file->setAutoRemove(true);
+            }
+        }
+    }
+    if (!stored)
+        return;
+
+    // the insert record replaces the old entry when the index is loaded
+    if (Entry *oldEntry = entries.value(entry->key))
+        removeEntry(oldEntry, false);
+
+    Entry *e = entry.take();
+    entries.insert(e->key, e);
+    linkLast(e);
+    currentCacheSize += e->size;
+    appendToIndex(InsertRecord, e);
+
+    if (currentCacheSize >= maximumCacheSize)
+        q->expire();
+    else
+        compactSegments();
+}
+
+/*!
+    \reimp
+*/
+bool QNetworkIndexedDiskCache::remove(const QUrl &url)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::remove()" << url;
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+
+    // remove is also used to cancel insertions, not a common operation
+    const QByteArray key = QNetworkIndexedDiskCachePrivate::cacheKey(url);
+    QHashIterator<QIODevice*, QIndexedCacheItem*> it(d->inserting);
+    while (it.hasNext()) {
+        it.next();
+        QIndexedCacheItem *item = it.value();
+        if (item && QNetworkIndexedDiskCachePrivate::cacheKey(item->metaData.url()) == key) {
+            delete item;
+            d->inserting.remove(it.key());
+            return true;
+        }
+    }
+
+    QNetworkIndexedDiskCachePrivate::Entry *entry = d->findEntry(url);
+    if (!entry)
+        return false;
+    d->removeEntry(entry);
+    d->compactSegments();
+    return true;
+}
+
+/*!
+    \reimp
+*/
+QNetworkCacheMetaData QNetworkIndexedDiskCache::metaData(const QUrl &url)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::metaData()" << url;
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+    QNetworkIndexedDiskCachePrivate::Entry *entry = d->findEntry(url);
+    if (!entry)
+        return QNetworkCacheMetaData();
+
+    QFile file(d->segmentFileName(entry->segment));
+    QNetworkCacheMetaData metaData;
+    bool compressed;
+    if (!file.open(QFile::ReadOnly) || !d->readHeader(entry, &file, &metaData, &compressed)) {
+        d->removeEntry(entry);
+        return QNetworkCacheMetaData();
+    }
+    d->touch(entry);
+    return metaData;
+}
+
+/*!
+    \reimp
+*/
+QIODevice *QNetworkIndexedDiskCache::data(const QUrl &url)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::data()" << url;
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+    if (!url.isValid())
+        return 0;
+    QNetworkIndexedDiskCachePrivate::Entry *entry = d->findEntry(url);
+    if (!entry)
+        return 0;
+
+    QScopedPointer<QFile> file(new QFile(d->segmentFileName(entry->segment)));
+    QNetworkCacheMetaData metaData;
+    bool compressed;
+    if (!file->open(QFile::ReadOnly) || !d->readHeader(entry, file.data(), &metaData, &compressed)) {
+        d->removeEntry(entry);
+        return 0;
+    }
+    d->touch(entry);
+
+    // readHeader() left the file positioned at the payload
+    const qint64 offset = entry->offset + entry->headerSize;
+    const qint64 size = entry->size - entry->headerSize;
+    QScopedPointer<QBuffer> buffer(new QBuffer);
+    if (compressed) {
+        buffer->setData(qUncompress(file->read(size)));
+    } else {
+        const uchar *p = 0;
+#if !defined(Q_OS_WINCE) && !defined(Q_OS_INTEGRITY)
+        if (size >= MIN_MAPPED_SIZE)
+            p = file->map(offset, size);
+#endif
+        if (p) {
+            // the buffer reads the mapping in place, the file keeps it alive
+            buffer->setData(QByteArray::fromRawData(reinterpret_cast<const char *>(p), size));
+            file.take()->setParent(buffer.data());
+        } else {
+            buffer->setData(file->read(size));
+        }
+    }
+    buffer->open(QBuffer::ReadOnly);
+    return buffer.take();
+}
+
+/*!
+    \reimp
+*/
+void QNetworkIndexedDiskCache::updateMetaData(const QNetworkCacheMetaData &metaData)
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::updateMetaData()" << metaData.url();
+#endif
+    QUrl url = metaData.url();
+    QIODevice *oldDevice = data(url);
+    if (!oldDevice)
+        return;
+
+    QIODevice *newDevice = prepare(metaData);
+    if (!newDevice) {
+        delete oldDevice;
+        return;
+    }
+    char data[1024];
+    while (!oldDevice->atEnd()) {
+        qint64 s = oldDevice->read(data, 1024);
+        newDevice->write(data, s);
+    }
+    delete oldDevice;
+    insert(newDevice);
+}
+
+/*!
+    Returns the current maximum size for the disk cache.
+
+    \sa setMaximumCacheSize()
+ */
+qint64 QNetworkIndexedDiskCache::maximumCacheSize() const
+{
+    Q_D(const QNetworkIndexedDiskCache);
+    return d->maximumCacheSize;
+}
+
+/*!
+    Sets the maximum size of the disk cache to be \a size.
+
+    If the new size is smaller then the current cache size then the cache will call expire().
+
+    \sa maximumCacheSize()
+ */
+void QNetworkIndexedDiskCache::setMaximumCacheSize(qint64 size)
+{
+    Q_D(QNetworkIndexedDiskCache);
+    bool expireCache = (size < d->maximumCacheSize);
+    d->maximumCacheSize = size;
+    if (expireCache && !d->dataDirectory.isEmpty())
+        expire();
+}
+
+/*!
+    Cleans the cache so that its size is under the maximum cache size.
+    Returns the current size of the cache.
+
+    When the current size of the cache is greater than the maximumCacheSize()
+    the least recently used items are removed until the total size is less
+    than 90% of maximumCacheSize(). Only the index is consulted, the cache
+    directory is not scanned.
+
+    \sa maximumCacheSize()
+ */
+qint64 QNetworkIndexedDiskCache::expire()
+{
+    Q_D(QNetworkIndexedDiskCache);
+    if (d->currentCacheSize < maximumCacheSize())
+        return d->currentCacheSize;
+
+    if (d->dataDirectory.isEmpty()) {
+        qWarning() << "QNetworkIndexedDiskCache::expire() The cache directory is not set";
+        return 0;
+    }
+
+    int removedEntries = 0;
+    qint64 goal = (maximumCacheSize() * 9) / 10;
+    while (d->first && d->currentCacheSize >= goal) {
+        d->removeEntry(d->first);
+        ++removedEntries;
+    }
+    d->compactSegments();
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::expire()"
+             << "Removed:" << removedEntries
+             << "Kept:" << d->entries.count();
+#else
+    Q_UNUSED(removedEntries);
+#endif
+    return d->currentCacheSize;
+}
+
+/*!
+    \reimp
+*/
+void QNetworkIndexedDiskCache::clear()
+{
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::clear()";
+#endif
+    Q_D(QNetworkIndexedDiskCache);
+    if (d->dataDirectory.isEmpty())
+        return;
+
+    delete d->activeSegmentFile;
+    d->activeSegmentFile = 0;
+    d->activeSegment = 0;
+    QHash<quint32, QNetworkIndexedDiskCachePrivate::Segment>::const_iterator it = d->segments.constBegin();
+    for (; it != d->segments.constEnd(); ++it)
+        QFile::remove(d->segmentFileName(it.key()));
+    d->segments.clear();
+    qDeleteAll(d->entries);
+    d->entries.clear();
+    d->first = d->last = 0;
+    d->currentCacheSize = 0;
+    d->garbageSize = 0;
+    d->writeIndex();
+}
+
+/*!
+    Writes the index of the cache, including the order in which its items
+    were last used, to disk. Insertions and removals are written to the index
+    as they happen, but the order of use is only saved by this function and
+    when the cache is destroyed.
+ */
+void QNetworkIndexedDiskCache::sync()
+{
+    Q_D(QNetworkIndexedDiskCache);
+    if (!d->dataDirectory.isEmpty())
+        d->writeIndex();
+}
+
+/*!
+    Returns the encoded \a url without the password and fragment, which
+    QNetworkCacheMetaData::setUrl() strips as well.
+ */
+QByteArray QNetworkIndexedDiskCachePrivate::cacheKey(const QUrl &url)
+{
+    return url.toEncoded(QUrl::RemovePassword | QUrl::RemoveFragment);
+}
+
+QString QNetworkIndexedDiskCachePrivate::segmentFileName(quint32 segment) const
+{
+    return dataDirectory + QString::number(segment) + SEGMENT_POSTFIX;
+}
+
+/*!
+    Small items are appended to the current segment until it reaches this
+    size. Keeping segments a fraction of the cache size lets compaction
+    reclaim space without copying much.
+ */
+qint64 QNetworkIndexedDiskCachePrivate::segmentSizeLimit() const
+{
+    return qBound(qint64(1024 * 1024), maximumCacheSize / 8, qint64(64 * 1024 * 1024));
+}
+
+/*!
+    Loads the index of the cache in dataDirectory, dropping entries whose
+    records are missing and segments no entry refers to.
+ */
+void QNetworkIndexedDiskCachePrivate::open()
+{
+    QDir helper;
+    helper.mkpath(dataDirectory + PREPARED_SLASH);
+
+    // prepared items of a previous session that were never inserted
+    QDir prepared(dataDirectory + PREPARED_SLASH);
+    foreach (const QString &fileName, prepared.entryList(QDir::Files))
+        prepared.remove(fileName);
+
+    QDir dir(dataDirectory);
+    QStringList filter(QLatin1Char('*') + SEGMENT_POSTFIX);
+    foreach (const QFileInfo &info, dir.entryInfoList(filter, QDir::Files)) {
+        bool ok;
+        const quint32 segment = info.completeBaseName().toUInt(&ok);
+        if (!ok || !segment)
+            continue;
+        segments[segment].size = info.size();
+        nextSegment = qMax(nextSegment, segment + 1);
+    }
+
+    bool rewriteIndex = loadIndex();
+
+    Entry *entry = first;
+    while (entry) {
+        Entry *next = entry->next;
+        QHash<quint32, Segment>::iterator it = segments.find(entry->segment);
+        if (it == segments.end() || entry->headerSize <= 0 || entry->headerSize > entry->size
+            || entry->offset < 0 || entry->offset + entry->size > it->size) {
+            unlink(entry);
+            entries.remove(entry->key);
+            delete entry;
+            rewriteIndex = true;
+        } else {
+            it->liveBytes += entry->size;
+            currentCacheSize += entry->size;
+        }
+        entry = next;
+    }
+
+    QHash<quint32, Segment>::iterator it = segments.begin();
+    while (it != segments.end()) {
+        if (!it->liveBytes) {
+            QFile::remove(segmentFileName(it.key()));
+            it = segments.erase(it);
+        } else {
+            garbageSize += it->size - it->liveBytes;
+            ++it;
+        }
+    }
+
+    if (rewriteIndex || indexRecords > 2 * entries.size() + MIN_INDEX_RECORDS) {
+        writeIndex();
+    } else {
+        indexFile = new QFile(dataDirectory + INDEX_FILE);
+        if (!indexFile->open(QFile::WriteOnly | QFile::Append)) {
+            qWarning() << "QNetworkIndexedDiskCache: unable to open the index" << indexFile->fileName();
+            delete indexFile;
+            indexFile = 0;
+        }
+    }
+}
+
+/*!
+    Saves the index and forgets about the current cache directory.
+ */
+void QNetworkIndexedDiskCachePrivate::close()
+{
+    if (dataDirectory.isEmpty())
+        return;
+    writeIndex();
+    delete indexFile;
+    indexFile = 0;
+    delete activeSegmentFile;
+    activeSegmentFile = 0;
+    activeSegment = 0;
+    nextSegment = 1;
+
+    qDeleteAll(entries);
+    entries.clear();
+    first = last = 0;
+    segments.clear();
+    currentCacheSize = 0;
+    garbageSize = 0;
+    indexRecords = 0;
+    dataDirectory.clear();
+}
+
+/*!
+    Replays the index log into the entry list. A record cut short by a crash
+    ends the log. Returns \c true if the log needs to be rewritten.
+ */
+bool QNetworkIndexedDiskCachePrivate::loadIndex()
+{
+    QFile file(dataDirectory + INDEX_FILE);
+    if (!file.open(QFile::ReadOnly))
+        return true;
+
+    QDataStream in(&file);
+    quint32 magic;
+    qint32 version;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != IndexMagic || version != IndexVersion)
+        return true;
+
+    while (!in.atEnd()) {
+        quint8 type;
+        QByteArray key;
+        quint32 segment = 0;
+        qint64 offset = 0;
+        qint64 headerSize = 0;
+        qint64 size = 0;
+        in >> type >> key;
+        if (type != RemoveRecord)
+            in >> segment >> offset >> headerSize >> size;
+        if (in.status() != QDataStream::Ok)
+            return true;
+
+        Entry *entry = entries.value(key);
+        switch (type) {
+        case InsertRecord:
+            if (entry) {
+                unlink(entry);
+            } else {
+                entry = new Entry;
+                entry->key = key;
+                entries.insert(key, entry);
+            }
+            linkLast(entry);
+            // fall through
+        case MoveRecord:
+            if (entry) {
+                entry->segment = segment;
+                entry->offset = offset;
+                entry->headerSize = headerSize;
+                entry->size = size;
+            }
+            break;
+        case RemoveRecord:
+            if (entry) {
+                unlink(entry);
+                entries.remove(key);
+                delete entry;
+            }
+            break;
+        default:
+            return true;
+        }
+        ++indexRecords;
+    }
+    return false;
+}
+
+/*!
+    Replaces the index log with one insert record per entry, in least
+    recently used order.
+ */
+void QNetworkIndexedDiskCachePrivate::writeIndex()
+{
+    delete indexFile;
+    indexFile = 0;
+
+    QSaveFile file(dataDirectory + INDEX_FILE);
+    if (file.open(QFile::WriteOnly)) {
+        QDataStream out(&file);
+        out << quint32(IndexMagic) << qint32(IndexVersion);
+        for (const Entry *entry = first; entry; entry = entry->next) {
+            out << quint8(InsertRecord) << entry->key << entry->segment
+                << entry->offset << entry->headerSize << entry->size;
+        }
+    }
+    if (!file.commit()) {
+        qWarning() << "QNetworkIndexedDiskCache: unable to write the index" << file.fileName();
+        return;
+    }
+    indexRecords = entries.size();
+
+    indexFile = new QFile(dataDirectory + INDEX_FILE);
+    if (!indexFile->open(QFile::WriteOnly | QFile::Append)) {
+        delete indexFile;
+        indexFile = 0;
+    }
+}
+
+void QNetworkIndexedDiskCachePrivate::appendToIndex(IndexRecord type, const Entry *entry)
+{
+    if (!indexFile)
+        return;
+    QDataStream out(indexFile);
+    out << quint8(type) << entry->key;
+    if (type != RemoveRecord)
+        out << entry->segment << entry->offset << entry->headerSize << entry->size;
+    indexFile->flush();
+
+    if (++indexRecords > 2 * entries.size() + MIN_INDEX_RECORDS)
+        writeIndex();
+}
+
+void QNetworkIndexedDiskCachePrivate::linkLast(Entry *entry)
+{
+    entry->prev = last;
+    entry->next = 0;
+    if (last)
+        last->next = entry;
+    else
+        first = entry;
+    last = entry;
+}
+
+void QNetworkIndexedDiskCachePrivate::unlink(Entry *entry)
+{
+    if (entry->prev)
+        entry->prev->next = entry->next;
+    else
+        first = entry->next;
+    if (entry->next)
+        entry->next->prev = entry->prev;
+    else
+        last = entry->prev;
+    entry->prev = entry->next = 0;
+}
+
+QNetworkIndexedDiskCachePrivate::Entry *QNetworkIndexedDiskCachePrivate::findEntry(const QUrl &url) const
+{
+    if (entries.isEmpty())
+        return 0;
+    return entries.value(cacheKey(url));
+}
+
+/*!
+    Drops \a entry from the index. Its record stays in the segment as garbage
+    until the segment is compacted or none of its records are used anymore.
+ */
+void QNetworkIndexedDiskCachePrivate::removeEntry(Entry *entry, bool logRemoval)
+{
+    unlink(entry);
+    entries.remove(entry->key);
+    currentCacheSize -= entry->size;
+    releaseSegmentBytes(entry->segment, entry->size);
+    if (logRemoval)
+        appendToIndex(RemoveRecord, entry);
+    delete entry;
+}
+
+void QNetworkIndexedDiskCachePrivate::releaseSegmentBytes(quint32 segment, qint64 bytes)
+{
+    QHash<quint32, Segment>::iterator it = segments.find(segment);
+    if (it == segments.end())
+        return;
+    it->liveBytes -= bytes;
+    garbageSize += bytes;
+    if (it->liveBytes <= 0 && segment != activeSegment) {
+        QFile::remove(segmentFileName(segment));
+        garbageSize -= it->size;
+        segments.erase(it);
+    }
+}
+
+/*!
+    Reads the record header of \a entry from \a file, which is left
+    positioned at the payload. Returns \c false if the record does not
+    belong to the entry.
+ */
+bool QNetworkIndexedDiskCachePrivate::readHeader(const Entry *entry, QFile *file,
+                                                 QNetworkCacheMetaData *metaData,
+                                                 bool *compressed) const
+{
+    if (!file->seek(entry->offset))
+        return false;
+    const QByteArray header = file->read(entry->headerSize);
+    if (header.size() != entry->headerSize)
+        return false;
+
+    QDataStream in(header);
+    qint32 marker;
+    qint32 version;
+    in >> marker >> version;
+    if (marker != RecordMagic || version != RecordVersion)
+        return false;
+    QByteArray key;
+    in >> key >> *metaData >> *compressed;
+    return in.status() == QDataStream::Ok && key == entry->key;
+}
+
+/*!
+    Appends \a record to the current segment, starting a new one if it is
+    full, and points \a entry at it.
+ */
+bool QNetworkIndexedDiskCachePrivate::appendRecord(const QByteArray &record, Entry *entry)
+{
+    if (activeSegmentFile && segments.value(activeSegment).size >= segmentSizeLimit()) {
+        delete activeSegmentFile;
+        activeSegmentFile = 0;
+        const quint32 previous = activeSegment;
+        activeSegment = 0;
+        releaseSegmentBytes(previous, 0);
+    }
+    if (!activeSegmentFile) {
+        activeSegment = nextSegment++;
+        activeSegmentFile = new QFile(segmentFileName(activeSegment));
+        if (!activeSegmentFile->open(QFile::WriteOnly | QFile::Truncate)) {
+            qWarning() << "QNetworkIndexedDiskCache: unable to create" << activeSegmentFile->fileName();
+            delete activeSegmentFile;
+            activeSegmentFile = 0;
+            activeSegment = 0;
+            return false;
+        }
+        segments.insert(activeSegment, Segment());
+    }
+
+    Segment &segment = segments[activeSegment];
+    if (activeSegmentFile->write(record) != record.size() || !activeSegmentFile->flush()) {
+        // whatever made it to the file is garbage now
+        const qint64 size = activeSegmentFile->size();
+        garbageSize += size - segment.size;
+        segment.size = size;
+        return false;
+    }
+    entry->segment = activeSegment;
+    entry->offset = segment.size;
+    entry->size = record.size();
+    segment.size += record.size();
+    segment.liveBytes += record.size();
+    return true;
+}
+
+/*!
+    Reclaims the space of removed items once it exceeds a quarter of the
+    maximum cache size by moving the items of segments that are more than
+    half garbage into the current segment.
+ */
+void QNetworkIndexedDiskCachePrivate::compactSegments()
+{
+    if (garbageSize <= qMax(segmentSizeLimit(), maximumCacheSize / 4))
+        return;
+
+    QHash<quint32, QFile *> victims;
+    QHash<quint32, Segment>::const_iterator it = segments.constBegin();
+    for (; it != segments.constEnd(); ++it) {
+        if (it.key() != activeSegment && it->liveBytes * 2 < it->size)
+            victims.insert(it.key(), 0);
+    }
+    if (victims.isEmpty())
+        return;
+
+    QList<QPair<quint32, qint64> > moved;
+    for (Entry *entry = first; entry; entry = entry->next) {
+        QHash<quint32, QFile *>::iterator victim = victims.find(entry->segment);
+        if (victim == victims.end())
+            continue;
+        if (!victim.value()) {
+            victim.value() = new QFile(segmentFileName(entry->segment));
+            victim.value()->open(QFile::ReadOnly);
+        }
+        QFile *file = victim.value();
+        if (!file->seek(entry->offset))
+            continue;
+        const QByteArray record = file->read(entry->size);
+        if (record.size() != entry->size)
+            continue;
+        const quint32 segment = entry->segment;
+        if (!appendRecord(record, entry))
+            break;
+        moved.append(qMakePair(segment, entry->size));
+        appendToIndex(MoveRecord, entry);
+    }
+    qDeleteAll(victims);
+
+    for (int i = 0; i < moved.count(); ++i)
+        releaseSegmentBytes(moved.at(i).first, moved.at(i).second);
+#if defined(QNETWORKINDEXEDDISKCACHE_DEBUG)
+    qDebug() << "QNetworkIndexedDiskCache::compactSegments()" << "Moved:" << moved.count();
+#endif
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_NETWORKDISKCACHE
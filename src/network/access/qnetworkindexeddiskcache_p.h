@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QNETWORKINDEXEDDISKCACHE_P_H
+#define QNETWORKINDEXEDDISKCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qnetworkdiskcache.h"
+#include "private/qnetworkdiskcache_p.h"
+
+#include <qhash.h>
+
+#ifndef QT_NO_NETWORKDISKCACHE
+
+QT_BEGIN_NAMESPACE
+
+class QFile;
+class QNetworkIndexedDiskCache;
+
+class QIndexedCacheItem : public QCacheItem
+{
+public:
+    QIndexedCacheItem() : headerSize(0)
+    {
+    }
+
+    qint64 headerSize;
+};
+
+class QNetworkIndexedDiskCachePrivate : public QAbstractNetworkCachePrivate
+{
+public:
+    // One cached url, keyed by its encoded form. Entries are kept in a doubly linked list ordered from
+    // the least to the most recently used one, which is the order in which
+    // expire() evicts them.
+    struct Entry
+    {
+        QByteArray key;
+        quint32 segment;
+        qint64 offset;
+        qint64 headerSize;
+        qint64 size;
+        Entry *prev;
+        Entry *next;
+    };
+
+    // A file holding the records of one or more entries back to back.
+    // liveBytes is the part of it still referenced from the index, the
+    // rest is garbage left behind by removed or replaced entries.
+    struct Segment
+    {
+        Segment() : size(0), liveBytes(0) {}
+        qint64 size;
+        qint64 liveBytes;
+    };
+
+    enum IndexRecord {
+        InsertRecord = 1,
+        RemoveRecord,
+        MoveRecord
+    };
+
+    QNetworkIndexedDiskCachePrivate()
+        : QAbstractNetworkCachePrivate()
+        , maximumCacheSize(1024 * 1024 * 50)
+        , currentCacheSize(0)
+        , garbageSize(0)
+        , first(0)
+        , last(0)
+        , indexFile(0)
+        , indexRecords(0)
+        , activeSegment(0)
+        , activeSegmentFile(0)
+        , nextSegment(1)
+        {}
+
+    static QByteArray cacheKey(const QUrl &url);
+    QString segmentFileName(quint32 segment) const;
+    qint64 segmentSizeLimit() const;
+
+    void open();
+    void close();
+    bool loadIndex();
+    void writeIndex();
+    void appendToIndex(IndexRecord type, const Entry *entry);
+
+    void linkLast(Entry *entry);
+    void unlink(Entry *entry);
+    inline void touch(Entry *entry)
+    {
+        if (entry != last) {
+            unlink(entry);
+            linkLast(entry);
+        }
+    }
+    Entry *findEntry(const QUrl &url) const;
+    void removeEntry(Entry *entry, bool logRemoval = true);
+    void releaseSegmentBytes(quint32 segment, qint64 bytes);
+    bool readHeader(const Entry *entry, QFile *file, QNetworkCacheMetaData *metaData,
+                    bool *compressed) const;
+
+    bool appendRecord(const QByteArray &record, Entry *entry);
+    void storeItem(QIndexedCacheItem *item);
+    void compactSegments();
+
+    QString cacheDirectory;
+    QString dataDirectory;
+    qint64 maximumCacheSize;
+    qint64 currentCacheSize;
+    qint64 garbageSize;
+
+    QHash<QByteArray, Entry *> entries;
+    Entry *first;
+    Entry *last;
+
+    QHash<quint32, Segment> segments;
+    QFile *indexFile;
+    int indexRecords;
+    quint32 activeSegment;
+    QFile *activeSegmentFile;
+    quint32 nextSegment;
+
+    QHash<QIODevice*, QIndexedCacheItem*> inserting;
+    Q_DECLARE_PUBLIC(QNetworkIndexedDiskCache)
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_NETWORKDISKCACHE
+
+#endif // QNETWORKINDEXEDDISKCACHE_P_H
@@ -463,6 +463,32 @@ void QNetworkReply::setReadBufferSize(qint64 size)
     d->readBufferMaxSize = size;
 }
 
+/*!
+    \since 5.4
+
+    Changes the priority level of this reply's request to \a level, which
+    then becomes the value of the QNetworkRequest::HttpPriorityLevelAttribute
+    of request().
+
+    A queued HTTP request is moved behind all other queued requests to the
+    same host with the same or a lower level, so that a request that is no
+    longer urgent can make way for others without being aborted and
+    reissued. Requests that have already been sent, and requests of other
+    protocols, are not affected.
+
+    \sa QNetworkRequest::setPriority()
+*/
+void QNetworkReply::setPriorityLevel(int level)
+{
+    Q_D(QNetworkReply);
+    d->setPriorityLevel(level);
+}
+
+void QNetworkReplyPrivate::setPriorityLevel(int level)
+{
+    request.setAttribute(QNetworkRequest::HttpPriorityLevelAttribute, level);
+}
+
 /*!
     Returns the QNetworkAccessManager that was used to create this
     QNetworkReply object. Initially, it is also the parent object.
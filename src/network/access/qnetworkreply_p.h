@@ -66,6 +66,7 @@ class QNetworkReplyPrivate: public QIODevicePrivate, public QNetworkHeadersPriva
 {
 public:
     QNetworkReplyPrivate();
+    virtual void setPriorityLevel(int level);
     QNetworkRequest request;
     QUrl url;
     QPointer<QNetworkAccessManager> manager;
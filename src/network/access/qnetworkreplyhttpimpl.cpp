@@ -374,6 +374,14 @@ void QNetworkReplyHttpImpl::setReadBufferSize(qint64 size)
     return;
 }
 
+void QNetworkReplyHttpImplPrivate::setPriorityLevel(int level)
+{
+    Q_Q(QNetworkReplyHttpImpl);
+    QNetworkReplyPrivate::setPriorityLevel(level);
+    httpRequest.setPriorityLevel(level);
+    emit q->priorityLevelChanged(level);
+}
+
 bool QNetworkReplyHttpImpl::canReadLine () const
 {
     Q_D(const QNetworkReplyHttpImpl);
@@ -440,6 +448,7 @@ QNetworkReplyHttpImplPrivate::QNetworkReplyHttpImplPrivate()
     , downloadBufferReadPosition(0)
     , downloadBufferCurrentSize(0)
     , downloadZerocopyBuffer(0)
+    , downloadToFile(false)
     , pendingDownloadDataEmissions(new QAtomicInt())
     , pendingDownloadProgressEmissions(new QAtomicInt())
     #ifndef QT_NO_SSL
@@ -676,6 +685,9 @@ void QNetworkReplyHttpImplPrivate::postRequest()
 
     bool loadedFromCache = false;
     httpRequest.setPriority(convert(request.priority()));
+    QVariant priorityLevel = request.attribute(QNetworkRequest::HttpPriorityLevelAttribute);
+    if (priorityLevel.isValid())
+        httpRequest.setPriorityLevel(priorityLevel.toInt());
 
     switch (operation) {
     case QNetworkAccessManager::GetOperation:
@@ -754,6 +766,9 @@ void QNetworkReplyHttpImplPrivate::postRequest()
     if (request.attribute(QNetworkRequest::SpdyAllowedAttribute).toBool() == true)
         httpRequest.setSPDYAllowed(true);
 
+    if (request.attribute(QNetworkRequest::Http2AllowedAttribute).toBool() == true)
+        httpRequest.setHTTP2Allowed(true);
+
     if (static_cast<QNetworkRequest::LoadControl>
         (request.attribute(QNetworkRequest::AuthenticationReuseAttribute,
                              QNetworkRequest::Automatic).toInt()) == QNetworkRequest::Manual)
@@ -794,12 +809,16 @@ void QNetworkReplyHttpImplPrivate::postRequest()
         QVariant downloadBufferMaximumSizeAttribute = request.attribute(QNetworkRequest::MaximumDownloadBufferSizeAttribute);
         if (downloadBufferMaximumSizeAttribute.isValid()) {
             delegate->downloadBufferMaximumSize = downloadBufferMaximumSizeAttribute.toLongLong();
+            delegate->userDownloadBuffer = request.attribute(QNetworkRequest::UserDownloadBufferAttribute)
+                                           .value<QSharedPointer<char> >();
         } else {
             // If there is no MaximumDownloadBufferSizeAttribute set (which is for the majority
             // of QNetworkRequest) then we can assume we'll do it anyway for small HTTP replies.
             // This helps with performance and memory fragmentation.
             delegate->downloadBufferMaximumSize = 128*1024;
         }
+        delegate->downloadFileName = request.attribute(QNetworkRequest::DownloadFileNameAttribute).toString();
+        delegate->channelCount = request.attribute(QNetworkRequest::HttpConnectionsPerHostAttribute).toInt();
 
 
         // These atomic integers are used for signal compression
@@ -815,14 +834,17 @@ void QNetworkReplyHttpImplPrivate::postRequest()
                 Qt::QueuedConnection);
         QObject::connect(delegate, SIGNAL(downloadMetaData(QList<QPair<QByteArray,QByteArray> >,
                                                            int, QString, bool,
-                                                           QSharedPointer<char>, qint64, bool)),
+                                                           QSharedPointer<char>, qint64, bool, bool)),
                 q, SLOT(replyDownloadMetaData(QList<QPair<QByteArray,QByteArray> >,
                                               int, QString, bool,
-                                              QSharedPointer<char>, qint64, bool)),
+                                              QSharedPointer<char>, qint64, bool, bool)),
                 Qt::QueuedConnection);
         QObject::connect(delegate, SIGNAL(downloadProgress(qint64,qint64)),
                 q, SLOT(replyDownloadProgressSlot(qint64,qint64)),
                 Qt::QueuedConnection);
+        QObject::connect(delegate, SIGNAL(statistics(QVariantMap,QVariantMap)),
+                q, SLOT(replyStatistics(QVariantMap,QVariantMap)),
+                Qt::QueuedConnection);
         QObject::connect(delegate, SIGNAL(error(QNetworkReply::NetworkError,QString)),
                 q, SLOT(httpError(QNetworkReply::NetworkError,QString)),
                 Qt::QueuedConnection);
@@ -854,6 +876,7 @@ void QNetworkReplyHttpImplPrivate::postRequest()
         // To throttle the connection.
         QObject::connect(q, SIGNAL(readBufferSizeChanged(qint64)), delegate, SLOT(readBufferSizeChanged(qint64)));
         QObject::connect(q, SIGNAL(readBufferFreed(qint64)), delegate, SLOT(readBufferFreed(qint64)));
+        QObject::connect(q, SIGNAL(priorityLevelChanged(int)), delegate, SLOT(priorityLevelChanged(int)));
 
         if (uploadByteDevice) {
             QNonContiguousByteDeviceThreadForwardImpl *forwardUploadDevice =
@@ -914,8 +937,10 @@ void QNetworkReplyHttpImplPrivate::postRequest()
                      delegate->isPipeliningUsed,
                      QSharedPointer<char>(),
                      delegate->incomingContentLength,
-                     delegate->isSpdyUsed);
+                     delegate->isSpdyUsed,
+                     delegate->isHttp2Used);
             replyDownloadData(delegate->synchronousDownloadData);
+            replyStatistics(delegate->incomingTimings, delegate->incomingConnectionStatistics);
             httpError(delegate->incomingErrorCode, delegate->incomingErrorDetail);
         } else {
             replyDownloadMetaData
@@ -925,8 +950,10 @@ void QNetworkReplyHttpImplPrivate::postRequest()
                      delegate->isPipeliningUsed,
                      QSharedPointer<char>(),
                      delegate->incomingContentLength,
-                     delegate->isSpdyUsed);
+                     delegate->isSpdyUsed,
+                     delegate->isHttp2Used);
             replyDownloadData(delegate->synchronousDownloadData);
+            replyStatistics(delegate->incomingTimings, delegate->incomingConnectionStatistics);
         }
 
         thread->quit();
@@ -1049,6 +1076,14 @@ void QNetworkReplyHttpImplPrivate::replyDownloadData(QByteArray d)
 
 }
 
+void QNetworkReplyHttpImplPrivate::replyStatistics(const QVariantMap &timings,
+                                                   const QVariantMap &connectionStatistics)
+{
+    Q_Q(QNetworkReplyHttpImpl);
+    q->setAttribute(QNetworkRequest::HttpTimingsAttribute, timings);
+    q->setAttribute(QNetworkRequest::HttpConnectionStatisticsAttribute, connectionStatistics);
+}
+
 void QNetworkReplyHttpImplPrivate::replyFinished()
 {
     // We are already loading from cache, we still however
@@ -1082,7 +1117,7 @@ void QNetworkReplyHttpImplPrivate::replyDownloadMetaData
         (QList<QPair<QByteArray,QByteArray> > hm,
          int sc,QString rp,bool pu,
          QSharedPointer<char> db,
-         qint64 contentLength, bool spdyWasUsed)
+         qint64 contentLength, bool spdyWasUsed, bool http2WasUsed)
 {
     Q_Q(QNetworkReplyHttpImpl);
     Q_UNUSED(contentLength);
@@ -1090,6 +1125,13 @@ void QNetworkReplyHttpImplPrivate::replyDownloadMetaData
     statusCode = sc;
     reasonPhrase = rp;
 
+    // The HTTP thread writes the body of successful replies to the file
+    QString downloadFileName = request.attribute(QNetworkRequest::DownloadFileNameAttribute).toString();
+    if (!synchronous && !downloadFileName.isEmpty() && statusCode >= 200 && statusCode < 300) {
+        downloadToFile = true;
+        q->setAttribute(QNetworkRequest::DownloadFileNameAttribute, downloadFileName);
+    }
+
     // Download buffer
     if (!db.isNull()) {
         downloadBufferPointer = db;
@@ -1100,6 +1142,7 @@ void QNetworkReplyHttpImplPrivate::replyDownloadMetaData
 
     q->setAttribute(QNetworkRequest::HttpPipeliningWasUsedAttribute, pu);
     q->setAttribute(QNetworkRequest::SpdyWasUsedAttribute, spdyWasUsed);
+    q->setAttribute(QNetworkRequest::Http2WasUsedAttribute, http2WasUsed);
 
     // reconstruct the HTTP header
     QList<QPair<QByteArray, QByteArray> > headerMap = hm;
@@ -1158,7 +1201,7 @@ void QNetworkReplyHttpImplPrivate::replyDownloadMetaData
     }
 
 
-    if (statusCode != 304 && statusCode != 303) {
+    if (statusCode != 304 && statusCode != 303 && !downloadToFile) {
         if (!isCachingEnabled())
             setCachingEnabled(true);
     }
@@ -1174,7 +1217,7 @@ void QNetworkReplyHttpImplPrivate::replyDownloadProgressSlot(qint64 bytesReceive
     if (!q->isOpen())
         return;
 
-    // we can be sure here that there is a download buffer
+    // we can be sure here that there is a download buffer or file
 
     int pendingSignals = (int)pendingDownloadProgressEmissions->fetchAndAddAcquire(-1) - 1;
     if (pendingSignals > 0) {
@@ -1186,6 +1229,16 @@ void QNetworkReplyHttpImplPrivate::replyDownloadProgressSlot(qint64 bytesReceive
     if (!q->isOpen())
         return;
 
+    if (downloadToFile) {
+        // the data went to the file, there is nothing to read
+        bytesDownloaded = bytesReceived;
+        if (downloadProgressSignalChoke.elapsed() >= progressSignalInterval) {
+            downloadProgressSignalChoke.restart();
+            emit q->downloadProgress(bytesDownloaded, bytesTotal);
+        }
+        return;
+    }
+
     if (cacheEnabled && isCachingAllowed() && bytesReceived == bytesTotal) {
         // Write everything in one go if we use a download buffer. might be more performant.
         initCacheSaveDevice();
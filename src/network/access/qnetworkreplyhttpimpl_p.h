@@ -113,8 +113,9 @@ public:
     Q_PRIVATE_SLOT(d_func(), void replyFinished())
     Q_PRIVATE_SLOT(d_func(), void replyDownloadMetaData(QList<QPair<QByteArray,QByteArray> >,
                                                         int, QString, bool, QSharedPointer<char>,
-                                                        qint64, bool))
+                                                        qint64, bool, bool))
     Q_PRIVATE_SLOT(d_func(), void replyDownloadProgressSlot(qint64,qint64))
+    Q_PRIVATE_SLOT(d_func(), void replyStatistics(const QVariantMap &, const QVariantMap &))
     Q_PRIVATE_SLOT(d_func(), void httpAuthenticationRequired(const QHttpNetworkRequest &, QAuthenticator *))
     Q_PRIVATE_SLOT(d_func(), void httpError(QNetworkReply::NetworkError, const QString &))
 #ifndef QT_NO_SSL
@@ -146,6 +147,7 @@ signals:
     void abortHttpRequest();
     void readBufferSizeChanged(qint64 size);
     void readBufferFreed(qint64 size);
+    void priorityLevelChanged(int level);
 
     void startHttpRequestSynchronously();
 
@@ -192,6 +194,7 @@ public:
     void metaDataChanged();
 
     void checkForRedirect(const int statusCode);
+    void setPriorityLevel(int level);
 
     // incoming from user
     QNetworkAccessManager *manager;
@@ -252,6 +255,9 @@ public:
     QSharedPointer<char> downloadBufferPointer;
     char* downloadZerocopyBuffer;
 
+    // set when the HTTP thread writes the body to the DownloadFileNameAttribute file
+    bool downloadToFile;
+
     // Will be increased by HTTP thread:
     QSharedPointer<QAtomicInt> pendingDownloadDataEmissions;
     QSharedPointer<QAtomicInt> pendingDownloadProgressEmissions;
@@ -279,8 +285,9 @@ public:
     void replyDownloadData(QByteArray);
     void replyFinished();
     void replyDownloadMetaData(QList<QPair<QByteArray,QByteArray> >, int, QString, bool,
-                               QSharedPointer<char>, qint64, bool);
+                               QSharedPointer<char>, qint64, bool, bool);
     void replyDownloadProgressSlot(qint64,qint64);
+    void replyStatistics(const QVariantMap &timings, const QVariantMap &connectionStatistics);
     void httpAuthenticationRequired(const QHttpNetworkRequest &request, QAuthenticator *auth);
     void httpError(QNetworkReply::NetworkError error, const QString &errorString);
 #ifndef QT_NO_SSL
@@ -257,6 +257,85 @@ QT_BEGIN_NAMESPACE
         Indicates whether SPDY was used for receiving
         this reply.
 
+    \value DownloadFileNameAttribute
+        Requests and replies, type: QMetaType::QString
+        On an asynchronous HTTP request, names a file that the body of
+        a successful (2xx) reply is written to directly by the network
+        thread, replacing the file's contents. The data is then not
+        available for reading from the reply; downloadProgress() reports
+        how much has been written, and the file is complete when
+        finished() is emitted. The reply has this attribute set only if
+        its body was written to the file.
+        (This value was introduced in 5.4.)
+
+    \value UserDownloadBufferAttribute
+        Requests only, type: QSharedPointer<char>
+        A buffer of MaximumDownloadBufferSizeAttribute bytes that the
+        network thread writes the body of an asynchronous HTTP reply into
+        when its length is known in advance and fits. The reply then
+        reads from this buffer instead of copying the data.
+        (This value was introduced in 5.4.)
+
+    \value HttpConnectionsPerHostAttribute
+        Requests only, type: QMetaType::Int (default: 6)
+        The number of connections that are opened in parallel to the
+        host of an HTTP request. Requests with different values do not
+        share connections, so all requests to a host should use the same
+        value. It has no effect on SPDY, which uses a single connection.
+        (This value was introduced in 5.4.)
+
+    \value HttpPriorityLevelAttribute
+        Requests only, type: QMetaType::Int (default: priority())
+        A finer grained version of priority(): queued HTTP requests to
+        the same host are sent in the order of their priority level,
+        lowest first, and in the order in which they were issued within
+        a level. The levels of HighPriority, NormalPriority and
+        LowPriority are their values, 1, 3 and 5. The level can be
+        changed with QNetworkReply::setPriorityLevel() while the request
+        is queued.
+        (This value was introduced in 5.4.)
+
+    \value Http2AllowedAttribute
+        Requests only, type: QMetaType::Bool (default: false)
+        Indicates whether the QNetworkAccessManager code is
+        allowed to use HTTP/2 with this request. For SSL requests it
+        is negotiated with the server; for unencrypted requests the
+        server is expected to support HTTP/2, which is then used
+        without asking (unless an HTTP proxy is in use). All HTTP/2
+        requests to a host share a single connection.
+        (This value was introduced in 5.4.)
+
+    \value Http2WasUsedAttribute
+        Replies only, type: QMetaType::Bool
+        Indicates whether HTTP/2 was used for receiving this reply.
+        (This value was introduced in 5.4.)
+
+    \value HttpTimingsAttribute
+        Replies only, type: QMetaType::QVariantMap
+        When the request passed through each stage of its transfer, in
+        milliseconds (as double) since it was queued: \c dequeued (sent
+        to a connection), \c connectStart, \c domainLookupEnd,
+        \c connectEnd, \c secureConnectionEnd, \c requestStart,
+        \c responseStart and \c responseEnd. Stages the request did not
+        pass through are left out; the connection stages only appear if
+        a new connection was made for the request. \c decodingTime holds
+        the milliseconds spent decompressing the body and
+        \c connectionReused whether the request was sent over a
+        connection that had been used before. Set when the reply has
+        finished. The same information is logged to the
+        \c qt.network.http.timing logging category.
+        (This value was introduced in 5.4.)
+
+    \value HttpConnectionStatisticsAttribute
+        Replies only, type: QMetaType::QVariantMap
+        Counters of the HTTP connection to the host the reply came
+        from, over all its channels, at the time the reply finished:
+        \c connectionsOpened, \c requestsStarted, \c requestsReused
+        (started over a connection that had been used before),
+        \c maxRequestsInFlight (on one connection, pipelined or
+        multiplexed), \c bytesSent and \c bytesReceived.
+        (This value was introduced in 5.4.)
+
     \value User
         Special type. Additional information can be passed in
         QVariants with types ranging from User to UserMax. The default
@@ -88,6 +88,14 @@ public:
         BackgroundRequestAttribute,
         SpdyAllowedAttribute,
         SpdyWasUsedAttribute,
+        DownloadFileNameAttribute,
+        UserDownloadBufferAttribute,
+        HttpConnectionsPerHostAttribute,
+        HttpPriorityLevelAttribute,
+        Http2AllowedAttribute,
+        Http2WasUsedAttribute,
+        HttpTimingsAttribute,
+        HttpConnectionStatisticsAttribute,
 
         User = 1000,
         UserMax = 32767
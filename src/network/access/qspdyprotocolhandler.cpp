@@ -316,6 +316,8 @@ bool QSpdyProtocolHandler::sendRequest()
         currentReply->d_func()->connectionChannel = m_channel;
         m_inFlightStreams.insert(streamID, currentPair);
         connect(currentReply, SIGNAL(destroyed(QObject*)), this, SLOT(_q_replyDestroyed(QObject*)));
+        m_channel->requestStarted(currentReply, m_inFlightStreams.count());
+        currentReply->d_func()->timings.mark(QHttpNetworkReplyTimings::RequestStart);
 
         sendSYN_STREAM(currentPair, streamID, /* associatedToStreamID = */ 0);
         int requestsRemoved = m_channel->spdyRequestsToSend.remove(
@@ -579,6 +581,8 @@ bool QSpdyProtocolHandler::readNextChunk(qint64 length, char *sink)
         expectedReadBytes -= requiredBytesFromBuffer;
     }
     qint64 readBytes = m_socket->read(sink + requiredBytesFromBuffer, expectedReadBytes);
+    if (readBytes > 0)
+        m_connection->d_func()->statistics.bytesReceived += readBytes;
 
     if (readBytes < expectedReadBytes) {
         m_waitingForCompleteStream = true;
@@ -630,6 +634,7 @@ void QSpdyProtocolHandler::sendControlFrame(FrameType type,
     written = m_socket->write(data, length);
     Q_ASSERT(written == length);
     Q_UNUSED(written); // silence -Wunused-variable
+    m_connection->d_func()->statistics.bytesSent += 8 + length;
 }
 
 void QSpdyProtocolHandler::sendSYN_STREAM(HttpMessagePair messagePair,
@@ -807,9 +812,12 @@ qint64 QSpdyProtocolHandler::sendDataFrame(qint32 streamID, DataFrameFlags flags
 
     Q_ASSERT(m_socket);
     m_socket->write(wireData);
+    m_connection->d_func()->statistics.bytesSent += wireData.size();
 
     if (data) {
         qint64 ret = m_socket->write(data, length);
+        if (ret > 0)
+            m_connection->d_func()->statistics.bytesSent += ret;
         return ret;
     } else {
         return 0; // nothing to write, e.g. FIN flag
@@ -915,6 +923,7 @@ void QSpdyProtocolHandler::parseHttpHeaders(char flags, const QByteArray &frameD
         sendRST_STREAM(streamID, RST_STREAM_STREAM_ALREADY_CLOSED);
         return;
     }
+    httpReply->d_func()->timings.mark(QHttpNetworkReplyTimings::ResponseStart);
 
     QByteArray uncompressedHeader;
     if (!uncompressHeader(headerValuePairs, &uncompressedHeader)) {
@@ -1261,9 +1270,6 @@ void QSpdyProtocolHandler::handleDataFrame(const QByteArray &frameHeaders)
         replyPrivate->currentlyReceivedDataInWindow = 0;
     }
 
-    httpReply->d_func()->compressedData.append(data);
-
-
     replyPrivate->totalProgress += length;
 
     if (httpRequest.d->autoDecompress && httpReply->d_func()->isCompressed()) {
@@ -119,11 +119,13 @@ public:
     { }
     void run();
 
+    // also used by QHostInfoRunnable to find out how long a result may be cached
+    static void query(const int requestType, const QByteArray &requestName, const QHostAddress &nameserver, QDnsLookupReply *reply);
+
 signals:
     void finished(const QDnsLookupReply &reply);
 
 private:
-    static void query(const int requestType, const QByteArray &requestName, const QHostAddress &nameserver, QDnsLookupReply *reply);
     QDnsLookup::Type requestType;
     QByteArray requestName;
     QHostAddress nameserver;
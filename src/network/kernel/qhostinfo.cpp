@@ -41,6 +41,7 @@
 
 #include "qhostinfo.h"
 #include "qhostinfo_p.h"
+#include "qdnslookup_p.h"
 
 #include "QtCore/qscopedpointer.h"
 #include <qabstracteventdispatcher.h>
@@ -455,6 +456,7 @@ void QHostInfoRunnable::run()
     }
 
     QHostInfo hostInfo;
+    bool refreshTtl = false;
 
     // QHostInfo::lookupHost already checks the cache. However we need to check
     // it here too because it might have been cache saved by another QHostInfoRunnable
@@ -464,9 +466,13 @@ void QHostInfoRunnable::run()
         bool valid = false;
         hostInfo = manager->cache.get(toBeLookedUp, &valid);
         if (!valid) {
+            // An expired entry means the name is used repeatedly, only then
+            // is it worth asking the DNS for how long the answer may be kept.
+            const bool expired = !hostInfo.addresses().isEmpty();
             // not in cache, we need to do the lookup and store the result in the cache
             hostInfo = QHostInfoAgent::fromName(toBeLookedUp);
             manager->cache.put(toBeLookedUp, hostInfo);
+            refreshTtl = expired && hostInfo.error() == QHostInfo::NoError;
         }
     } else {
         // cache is not enabled, just do the lookup and continue
@@ -499,6 +505,15 @@ void QHostInfoRunnable::run()
         }
     }
 
+    // The system resolver does not tell us for how long its answer is valid.
+    // Ask the DNS for the TTL now that the result has been delivered, so that
+    // the extra round trip does not delay the connection that is waiting for it.
+    if (refreshTtl && !manager->wasAborted(id)) {
+        int ttl = lookupTtl(toBeLookedUp, hostInfo.addresses());
+        if (ttl >= 0)
+            manager->cache.put(toBeLookedUp, hostInfo, ttl);
+    }
+
     manager->lookupFinished(this);
 
     // thread goes back to QThreadPool
@@ -705,7 +720,67 @@ void Q_AUTOTEST_EXPORT qt_qhostinfo_enable_cache(bool e)
     }
 }
 
-// cache for 60 seconds
+void Q_AUTOTEST_EXPORT qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &hostinfo, int ttl)
+{
+    QAbstractHostInfoLookupManager* manager = theHostInfoLookupManager();
+    if (!manager || !manager->cache.isEnabled())
+        return;
+
+    manager->cache.put(hostname, hostinfo, ttl);
+}
+
+static inline void updateTtl(int *ttl, quint32 recordTtl)
+{
+    // RFC 2181: a TTL with the most significant bit set is to be treated as zero
+    const int value = (recordTtl & 0x80000000U) ? 0 : int(recordTtl);
+    if (*ttl < 0 || value < *ttl)
+        *ttl = value;
+}
+
+/*! \internal
+
+    Returns the smallest time to live, in seconds, of the A and AAAA records
+    (and the CNAME records leading to them) of \a hostName, or -1 if the DNS
+    could not be asked. Only the record types of the families found in
+    \a addresses are queried. Names without a dot are usually resolved from
+    the hosts file or a search domain, so they are not queried.
+*/
+int QHostInfoRunnable::lookupTtl(const QString &hostName, const QList<QHostAddress> &addresses)
+{
+    QHostAddress address;
+    if (address.setAddress(hostName))
+        return -1;
+    const QByteArray aceHostName = QUrl::toAce(hostName);
+    if (aceHostName.isEmpty() || !aceHostName.contains('.'))
+        return -1;
+
+    bool hasIPv4 = false;
+    bool hasIPv6 = false;
+    foreach (const QHostAddress &address, addresses) {
+        if (address.protocol() == QAbstractSocket::IPv6Protocol)
+            hasIPv6 = true;
+        else
+            hasIPv4 = true;
+    }
+
+    int ttl = -1;
+    const QDnsLookup::Type types[] = { QDnsLookup::A, QDnsLookup::AAAA };
+    for (uint i = 0; i < sizeof(types) / sizeof(types[0]); ++i) {
+        if (!(types[i] == QDnsLookup::A ? hasIPv4 : hasIPv6))
+            continue;
+        QDnsLookupReply reply;
+        QDnsLookupRunnable::query(types[i], aceHostName, QHostAddress(), &reply);
+        if (reply.error != QDnsLookup::NoError)
+            continue;
+        foreach (const QDnsHostAddressRecord &record, reply.hostAddressRecords)
+            updateTtl(&ttl, record.timeToLive());
+        foreach (const QDnsDomainNameRecord &record, reply.canonicalNameRecords)
+            updateTtl(&ttl, record.timeToLive());
+    }
+    return ttl;
+}
+
+// cache for 60 seconds unless the DNS told us otherwise
 // cache 128 items
 QHostInfoCache::QHostInfoCache() : max_age(60), enabled(true), cache(128)
 {
@@ -734,7 +809,7 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
     *valid = false;
     if (cache.contains(name)) {
         QHostInfoCacheElement *element = cache.object(name);
-        if (element->age.elapsed() < max_age*1000)
+        if (element->age.elapsed() < element->maxAge)
             *valid = true;
         return element->info;
 
@@ -746,16 +821,24 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
     return QHostInfo();
 }
 
-void QHostInfoCache::put(const QString &name, const QHostInfo &info)
+void QHostInfoCache::put(const QString &name, const QHostInfo &info, int ttl)
 {
     // if the lookup failed, don't cache
     if (info.error() != QHostInfo::NoError)
         return;
 
+    if (ttl == 0) {
+        // the DNS asked us not to cache this answer at all
+        QMutexLocker locker(&this->mutex);
+        cache.remove(name);
+        return;
+    }
+
     QHostInfoCacheElement* element = new QHostInfoCacheElement();
     element->info = info;
     element->age = QElapsedTimer();
     element->age.start();
+    element->maxAge = qint64(ttl < 0 ? max_age : ttl) * 1000;
 
     QMutexLocker locker(&this->mutex);
     cache.insert(name, element); // cache will take ownership
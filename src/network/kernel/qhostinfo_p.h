@@ -125,15 +125,16 @@ public:
 QHostInfo Q_NETWORK_EXPORT qt_qhostinfo_lookup(const QString &name, QObject *receiver, const char *member, bool *valid, int *id);
 void Q_AUTOTEST_EXPORT qt_qhostinfo_clear_cache();
 void Q_AUTOTEST_EXPORT qt_qhostinfo_enable_cache(bool e);
+void Q_AUTOTEST_EXPORT qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &hostinfo, int ttl = -1);
 
 class QHostInfoCache
 {
 public:
     QHostInfoCache();
-    const int max_age; // seconds
+    const int max_age; // seconds, used when the TTL of an entry is not known
 
     QHostInfo get(const QString &name, bool *valid);
-    void put(const QString &name, const QHostInfo &info);
+    void put(const QString &name, const QHostInfo &info, int ttl = -1);
     void clear();
 
     bool isEnabled();
@@ -143,6 +144,7 @@ private:
     struct QHostInfoCacheElement {
         QHostInfo info;
         QElapsedTimer age;
+        qint64 maxAge; // msecs
     };
     QCache<QString,QHostInfoCacheElement> cache;
     QMutex mutex;
@@ -155,6 +157,7 @@ class QHostInfoRunnable : public QRunnable
 public:
     QHostInfoRunnable (QString hn, int i);
     void run();
+    static int lookupTtl(const QString &hostName, const QList<QHostAddress> &addresses);
 
     QString toBeLookedUp;
     int id;
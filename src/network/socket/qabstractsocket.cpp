@@ -491,6 +491,7 @@
 #define QABSTRACTSOCKET_BUFFERSIZE 32768
 #endif
 #define QT_CONNECT_TIMEOUT 30000
+#define QT_CONNECTION_ATTEMPT_DELAY 250
 #define QT_TRANSFER_TIMEOUT 120000
 
 QT_BEGIN_NAMESPACE
@@ -567,11 +568,18 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
       cachedSocketDescriptor(-1),
       readBufferMaxSize(0),
       writeBuffer(QABSTRACTSOCKET_BUFFERSIZE),
+      pendingFileOffset(0),
+      pendingFileSize(0),
+      writeBufferBeforeFile(0),
+      pendingFileCopied(false),
       isBuffered(false),
       blockingTimeout(30000),
       connectTimer(0),
       disconnectTimer(0),
       connectTimeElapsed(0),
+      raceEngine(0),
+      raceTimer(0),
+      raceReceiver(this),
       hostLookupId(-1),
       socketType(QAbstractSocket::UnknownSocketType),
       state(QAbstractSocket::UnconnectedState),
@@ -599,6 +607,7 @@ void QAbstractSocketPrivate::resetSocketLayer()
     qDebug("QAbstractSocketPrivate::resetSocketLayer()");
 #endif
 
+    cancelConnectionRace();
     if (socketEngine) {
         socketEngine->close();
         socketEngine->disconnect();
@@ -814,20 +823,20 @@ bool QAbstractSocketPrivate::canWriteNotification()
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::canWriteNotification() flushing");
 #endif
-    int tmp = writeBuffer.size();
+    qint64 tmp = pendingWriteSize();
     flush();
 
     if (socketEngine) {
 #if defined (Q_OS_WIN)
-        if (!writeBuffer.isEmpty())
+        if (hasPendingWrites())
             socketEngine->setWriteNotificationEnabled(true);
 #else
-        if (writeBuffer.isEmpty() && socketEngine->bytesToWrite() == 0)
+        if (!hasPendingWrites() && socketEngine->bytesToWrite() == 0)
             socketEngine->setWriteNotificationEnabled(false);
 #endif
     }
 
-    return (writeBuffer.size() < tmp);
+    return (pendingWriteSize() < tmp);
 }
 
 /*! \internal
@@ -860,7 +869,7 @@ void QAbstractSocketPrivate::connectionNotification()
 bool QAbstractSocketPrivate::flush()
 {
     Q_Q(QAbstractSocket);
-    if (!socketEngine || !socketEngine->isValid() || (writeBuffer.isEmpty()
+    if (!socketEngine || !socketEngine->isValid() || (!hasPendingWrites()
         && socketEngine->bytesToWrite() == 0)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::flush() nothing to do: valid ? %s, writeBuffer.isEmpty() ? %s",
@@ -874,16 +883,12 @@ bool QAbstractSocketPrivate::flush()
         return false;
     }
 
-    int nextSize = writeBuffer.nextDataBlockSize();
-    const char *ptr = writeBuffer.readPointer();
-
-    // Attempt to write it all in one chunk.
-    qint64 written = socketEngine->write(ptr, nextSize);
+    // Attempt to write it all in one go.
+    qint64 written = (pendingFileSize > 0 && writeBufferBeforeFile == 0)
+                     ? writeFromFile() : writeToSocket();
     if (written < 0) {
-        socketError = socketEngine->error();
-        q->setErrorString(socketEngine->errorString());
 #if defined (QABSTRACTSOCKET_DEBUG)
-        qDebug() << "QAbstractSocketPrivate::flush() write error, aborting." << socketEngine->errorString();
+        qDebug() << "QAbstractSocketPrivate::flush() write error, aborting." << q->errorString();
 #endif
         emit q->error(socketError);
         // an unexpected error so close the socket.
@@ -896,8 +901,6 @@ bool QAbstractSocketPrivate::flush()
            written);
 #endif
 
-    // Remove what we wrote so far.
-    writeBuffer.free(written);
     if (written > 0) {
         // Don't emit bytesWritten() recursively.
         if (!emittedBytesWritten) {
@@ -907,7 +910,7 @@ bool QAbstractSocketPrivate::flush()
         }
     }
 
-    if (writeBuffer.isEmpty() && socketEngine && socketEngine->isWriteNotificationEnabled()
+    if (!hasPendingWrites() && socketEngine && socketEngine->isWriteNotificationEnabled()
         && !socketEngine->bytesToWrite())
         socketEngine->setWriteNotificationEnabled(false);
     if (state == QAbstractSocket::ClosingState)
@@ -916,6 +919,130 @@ bool QAbstractSocketPrivate::flush()
     return true;
 }
 
+/*! \internal
+
+    Writes as much of the write buffer as the socket engine takes in one
+    call, gathering its blocks, but nothing past a pending file. Returns
+    the number of bytes written, or -1 if an error occurred.
+*/
+qint64 QAbstractSocketPrivate::writeToSocket()
+{
+    Q_Q(QAbstractSocket);
+    enum { MaxBlocks = 16 };
+    const char *blocks[MaxBlocks];
+    qint64 sizes[MaxBlocks];
+    const qint64 maxSize = pendingFileSize > 0 ? writeBufferBeforeFile : qint64(writeBuffer.size());
+    const int count = writeBuffer.readPointers(blocks, sizes, MaxBlocks, maxSize);
+    if (count == 0)
+        return 0;
+
+    const qint64 written = (count == 1) ? socketEngine->write(blocks[0], sizes[0])
+                                        : socketEngine->writeBlocks(blocks, sizes, count);
+    if (written < 0) {
+        socketError = socketEngine->error();
+        q->setErrorString(socketEngine->errorString());
+        return -1;
+    }
+
+    // Remove what we wrote so far.
+    writeBuffer.free(written);
+    if (pendingFileSize > 0)
+        writeBufferBeforeFile -= written;
+    return written;
+}
+
+/*! \internal
+
+    Writes the next part of the pending file, by the socket engine's
+    sendFile() where possible and else through memory. Returns the number
+    of bytes written, or -1 if an error occurred.
+*/
+qint64 QAbstractSocketPrivate::writeFromFile()
+{
+    Q_Q(QAbstractSocket);
+    if (!pendingFile) {
+        socketError = QAbstractSocket::UnknownSocketError;
+        q->setErrorString(QAbstractSocket::tr("File was deleted while being written"));
+        return -1;
+    }
+
+    qint64 written = -1;
+    const int fileDescriptor = pendingFile->handle();
+    if (!pendingFileCopied && fileDescriptor != -1) {
+        written = socketEngine->sendFile(fileDescriptor, pendingFileOffset, pendingFileSize);
+        if (written == -2)
+            return 0;
+        if (written == 0) {
+            // the file shrank after writeFile(), there is nothing left to send
+            socketError = QAbstractSocket::UnknownSocketError;
+            q->setErrorString(QAbstractSocket::tr("File was truncated while being written"));
+            return -1;
+        }
+        if (written < 0 && socketEngine->error() == QAbstractSocket::UnsupportedSocketOperationError)
+            pendingFileCopied = true;
+    } else {
+        pendingFileCopied = true;
+    }
+
+    if (pendingFileCopied) {
+        // no zero-copy path for this socket or file, copy one block at a time
+        QByteArray block;
+        if (pendingFile->seek(pendingFileOffset))
+            block = pendingFile->read(qMin<qint64>(pendingFileSize, QABSTRACTSOCKET_BUFFERSIZE));
+        if (block.isEmpty()) {
+            socketError = QAbstractSocket::UnknownSocketError;
+            q->setErrorString(pendingFile->errorString());
+            return -1;
+        }
+        written = socketEngine->write(block.constData(), block.size());
+    }
+
+    if (written < 0) {
+        socketError = socketEngine->error();
+        q->setErrorString(socketEngine->errorString());
+        return -1;
+    }
+
+    pendingFileOffset += written;
+    pendingFileSize -= written;
+    if (pendingFileSize == 0)
+        pendingFile = 0;
+    return written;
+}
+
+/*! \internal
+
+    Passes the next block of the pending file to write(), for sockets that
+    have no socket engine of their own and write through another socket
+    (QSslSocket). The caller decides when the previous block has drained.
+    Returns false if an error occurred.
+*/
+bool QAbstractSocketPrivate::writeFileBlock()
+{
+    Q_Q(QAbstractSocket);
+    QByteArray block;
+    if (pendingFile && pendingFile->seek(pendingFileOffset))
+        block = pendingFile->read(qMin<qint64>(pendingFileSize, QABSTRACTSOCKET_BUFFERSIZE));
+    if (block.isEmpty()) {
+        socketError = QAbstractSocket::UnknownSocketError;
+        q->setErrorString(pendingFile ? pendingFile->errorString()
+                          : QAbstractSocket::tr("File was deleted while being written"));
+        pendingFile = 0;
+        pendingFileSize = 0;
+        return false;
+    }
+
+    pendingFileOffset += block.size();
+    pendingFileSize -= block.size();
+    if (pendingFileSize == 0)
+        pendingFile = 0;
+    if (q->write(block) != block.size()) {
+        socketError = QAbstractSocket::UnknownSocketError;
+        return false;
+    }
+    return true;
+}
+
 #ifndef QT_NO_NETWORKPROXY
 /*! \internal
 
@@ -1037,6 +1164,28 @@ void QAbstractSocketPrivate::_q_startConnecting(const QHostInfo &hostInfo)
     qDebug("QAbstractSocketPrivate::_q_startConnecting(hostInfo == %s)", s.toLatin1().constData());
 #endif
 
+    // Alternate between the address families, so that a family that
+    // does not work does not have to fail on every address before the
+    // other family gets a chance (RFC 6555).
+    if (addresses.count() > 2) {
+        QList<QHostAddress> first;
+        QList<QHostAddress> second;
+        const QAbstractSocket::NetworkLayerProtocol firstProtocol = addresses.first().protocol();
+        foreach (const QHostAddress &address, addresses) {
+            if (address.protocol() == firstProtocol)
+                first += address;
+            else
+                second += address;
+        }
+        addresses.clear();
+        while (!first.isEmpty() || !second.isEmpty()) {
+            if (!first.isEmpty())
+                addresses += first.takeFirst();
+            if (!second.isEmpty())
+                addresses += second.takeFirst();
+        }
+    }
+
     // Try all addresses twice.
     addresses += addresses;
 
@@ -1163,6 +1312,7 @@ void QAbstractSocketPrivate::_q_connectToNextAddress()
         // Wait for a write notification that will eventually call
         // _q_testConnection().
         socketEngine->setWriteNotificationEnabled(true);
+        scheduleConnectionRace();
         break;
     } while (state != QAbstractSocket::ConnectedState);
 }
@@ -1201,6 +1351,13 @@ void QAbstractSocketPrivate::_q_testConnection()
             connectTimer->stop();
     }
 
+    if (raceEngine) {
+        // An attempt to the other address family is still in progress,
+        // let it become the current one instead of starting a new one.
+        takeOverRaceEngine();
+        return;
+    }
+
 #if defined(QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::_q_testConnection() connection failed,"
            " checking for alternative addresses");
@@ -1226,7 +1383,9 @@ void QAbstractSocketPrivate::_q_abortConnectionAttempt()
 
     connectTimer->stop();
 
-    if (addresses.isEmpty()) {
+    if (raceEngine) {
+        takeOverRaceEngine();
+    } else if (addresses.isEmpty()) {
         state = QAbstractSocket::UnconnectedState;
         socketError = QAbstractSocket::SocketTimeoutError;
         q->setErrorString(QAbstractSocket::tr("Connection timed out"));
@@ -1237,6 +1396,175 @@ void QAbstractSocketPrivate::_q_abortConnectionAttempt()
     }
 }
 
+/*! \internal
+
+    Called after a connection attempt has started. If the attempt does
+    not complete within QT_CONNECTION_ATTEMPT_DELAY milliseconds and one
+    of the pending addresses belongs to the other address family,
+    _q_startConnectionRace() tries that address in parallel (RFC 6555),
+    so that a family that silently drops packets does not hold up the
+    connection until the connect timeout.
+*/
+void QAbstractSocketPrivate::scheduleConnectionRace()
+{
+    Q_Q(QAbstractSocket);
+    if (raceEngine || socketType != QAbstractSocket::TcpSocket
+        || !threadData->hasEventDispatcher()) {
+        return;
+    }
+#ifndef QT_NO_NETWORKPROXY
+    if (proxyInUse.type() != QNetworkProxy::NoProxy)
+        return;
+#endif
+
+    bool otherFamilyPending = false;
+    for (int i = 0; i < addresses.count() && !otherFamilyPending; ++i)
+        otherFamilyPending = addresses.at(i).protocol() != host.protocol();
+    if (!otherFamilyPending)
+        return;
+
+    if (!raceTimer) {
+        raceTimer = new QTimer(q);
+        raceTimer->setSingleShot(true);
+        QObject::connect(raceTimer, SIGNAL(timeout()),
+                         q, SLOT(_q_startConnectionRace()),
+                         Qt::DirectConnection);
+    }
+    raceTimer->start(QT_CONNECTION_ATTEMPT_DELAY);
+}
+
+/*! \internal
+
+    Starts connecting to the first pending address of the other address
+    family, while the current connection attempt goes on. Whichever
+    attempt succeeds first is kept.
+*/
+void QAbstractSocketPrivate::_q_startConnectionRace()
+{
+#ifdef QT_NO_NETWORKPROXY
+    static const QNetworkProxy &proxyInUse = *(QNetworkProxy *)0;
+#endif
+    Q_Q(QAbstractSocket);
+    if (state != QAbstractSocket::ConnectingState || !socketEngine || raceEngine)
+        return;
+
+    int i = 0;
+    while (i < addresses.count() && addresses.at(i).protocol() == host.protocol())
+        ++i;
+    if (i == addresses.count())
+        return;
+    raceHost = addresses.takeAt(i);
+
+#if defined(QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::_q_startConnectionRace(), connecting to %s:%i",
+           raceHost.toString().toLatin1().constData(), port);
+#endif
+
+    raceEngine = QAbstractSocketEngine::createSocketEngine(q->socketType(), proxyInUse, q);
+    if (!raceEngine)
+        return;
+#ifndef QT_NO_BEARERMANAGEMENT
+    raceEngine->setProperty("_q_networksession", q->property("_q_networksession"));
+#endif
+    if (!raceEngine->initialize(q->socketType(), raceHost.protocol())) {
+        cancelConnectionRace();
+        return;
+    }
+    raceEngine->setReceiver(&raceReceiver);
+
+    if (raceEngine->connectToHost(raceHost, port)) {
+        takeOverRaceEngine();
+        return;
+    }
+    if (raceEngine->state() != QAbstractSocket::ConnectingState) {
+        cancelConnectionRace();
+        return;
+    }
+    raceEngine->setWriteNotificationEnabled(true);
+}
+
+void QAbstractSocketRaceReceiver::connectionNotification()
+{
+    d->testRaceConnection();
+}
+
+/*! \internal
+
+    Called when the racing connection attempt has completed. If it
+    succeeded, it replaces the current one; otherwise it is dropped and
+    the current attempt carries on.
+*/
+void QAbstractSocketPrivate::testRaceConnection()
+{
+    if (!raceEngine || state != QAbstractSocket::ConnectingState)
+        return;
+
+    if (raceEngine->state() == QAbstractSocket::ConnectedState) {
+        takeOverRaceEngine();
+    } else {
+#if defined(QABSTRACTSOCKET_DEBUG)
+        qDebug("QAbstractSocketPrivate::testRaceConnection() connection to %s failed",
+               raceHost.toString().toLatin1().constData());
+#endif
+        cancelConnectionRace();
+    }
+}
+
+/*! \internal
+
+    Makes the racing connection attempt the current one, closing the
+    socket of the attempt it replaces. If the racing attempt is already
+    connected, connected() is emitted; otherwise it is given the full
+    connect timeout, and another race may be started from it.
+*/
+void QAbstractSocketPrivate::takeOverRaceEngine()
+{
+    Q_Q(QAbstractSocket);
+    QAbstractSocketEngine *engine = raceEngine;
+    raceEngine = 0;
+    resetSocketLayer();
+
+    socketEngine = engine;
+    socketEngine->setReceiver(this);
+    cachedSocketDescriptor = socketEngine->socketDescriptor();
+    host = raceHost;
+    raceHost.clear();
+
+#if defined(QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::takeOverRaceEngine(), now using %s:%i",
+           host.toString().toLatin1().constData(), port);
+#endif
+
+    if (socketEngine->state() == QAbstractSocket::ConnectedState) {
+        fetchConnectionParameters();
+        if (pendingClose) {
+            q->disconnectFromHost();
+            pendingClose = false;
+        }
+        return;
+    }
+
+    if (connectTimer)
+        connectTimer->start(QT_CONNECT_TIMEOUT);
+    scheduleConnectionRace();
+}
+
+/*! \internal
+
+    Abandons the racing connection attempt, if any.
+*/
+void QAbstractSocketPrivate::cancelConnectionRace()
+{
+    if (raceTimer)
+        raceTimer->stop();
+    if (raceEngine) {
+        raceEngine->close();
+        raceEngine->disconnect();
+        delete raceEngine;
+        raceEngine = 0;
+    }
+}
+
 void QAbstractSocketPrivate::_q_forceDisconnect()
 {
     Q_Q(QAbstractSocket);
@@ -1583,6 +1911,11 @@ bool QAbstractSocket::isValid() const
     "example.com"). QAbstractSocket will do a lookup only if
     required. \a port is in native byte order.
 
+    If the lookup returns addresses of both IPv4 and IPv6, QAbstractSocket
+    alternates between the two families. When a connection attempt takes
+    longer than a short delay, the next address of the other family is
+    tried in parallel, and the first connection to be established is used.
+
     \sa state(), peerName(), peerAddress(), peerPort(), waitForConnected()
 */
 void QAbstractSocket::connectToHost(const QString &hostName, quint16 port,
@@ -1609,7 +1942,7 @@ void QAbstractSocket::connectToHost(const QString &hostName, quint16 port,
     d->port = port;
     d->state = UnconnectedState;
     d->buffer.clear();
-    d->writeBuffer.clear();
+    d->clearWriteBuffer();
     d->abortCalled = false;
     d->closeCalled = false;
     d->pendingClose = false;
@@ -1705,9 +2038,9 @@ qint64 QAbstractSocket::bytesToWrite() const
 {
     Q_D(const QAbstractSocket);
 #if defined(QABSTRACTSOCKET_DEBUG)
-    qDebug("QAbstractSocket::bytesToWrite() == %i", d->writeBuffer.size());
+    qDebug("QAbstractSocket::bytesToWrite() == %lli", d->pendingWriteSize());
 #endif
-    return (qint64)d->writeBuffer.size();
+    return d->pendingWriteSize();
 }
 
 /*!
@@ -1846,7 +2179,7 @@ bool QAbstractSocket::setSocketDescriptor(qintptr socketDescriptor, SocketState
     Q_D(QAbstractSocket);
 
     d->resetSocketLayer();
-    d->writeBuffer.clear();
+    d->clearWriteBuffer();
     d->buffer.clear();
     d->socketEngine = QAbstractSocketEngine::createSocketEngine(socketDescriptor, this);
     if (!d->socketEngine) {
@@ -2057,6 +2390,13 @@ bool QAbstractSocket::waitForConnected(int msecs)
     if (state() == UnconnectedState)
         return false; // connect not im progress anymore!
 
+    // Only one connection attempt can be waited for; give up the racing
+    // one, but keep its address to be tried next.
+    if (d->raceEngine) {
+        d->addresses.prepend(d->raceHost);
+        d->cancelConnectionRace();
+    }
+
     bool timedOut = true;
 #if defined (QABSTRACTSOCKET_DEBUG)
     int attempt = 1;
@@ -2137,7 +2477,7 @@ bool QAbstractSocket::waitForReadyRead(int msecs)
     do {
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty(),
+        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, d->hasPendingWrites(),
                                                qt_timeout_value(msecs, stopWatch.elapsed()))) {
             d->socketError = d->socketEngine->error();
             setErrorString(d->socketEngine->errorString());
@@ -2180,7 +2520,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         return false;
     }
 
-    if (d->writeBuffer.isEmpty())
+    if (!d->hasPendingWrites())
         return false;
 
     QElapsedTimer stopWatch;
@@ -2195,7 +2535,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
     forever {
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty(),
+        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, d->hasPendingWrites(),
                                                qt_timeout_value(msecs, stopWatch.elapsed()))) {
             d->socketError = d->socketEngine->error();
             setErrorString(d->socketEngine->errorString());
@@ -2274,7 +2614,7 @@ bool QAbstractSocket::waitForDisconnected(int msecs)
         bool readyToRead = false;
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, state() == ConnectedState,
-                                               !d->writeBuffer.isEmpty(),
+                                               d->hasPendingWrites(),
                                                qt_timeout_value(msecs, stopWatch.elapsed()))) {
             d->socketError = d->socketEngine->error();
             setErrorString(d->socketEngine->errorString());
@@ -2312,7 +2652,7 @@ void QAbstractSocket::abort()
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocket::abort()");
 #endif
-    d->writeBuffer.clear();
+    d->clearWriteBuffer();
     if (d->state == UnconnectedState)
         return;
 #ifndef QT_NO_SSL
@@ -2449,7 +2789,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
         return -1;
     }
 
-    if (!d->isBuffered && d->socketType == TcpSocket && d->writeBuffer.isEmpty()) {
+    if (!d->isBuffered && d->socketType == TcpSocket && !d->hasPendingWrites()) {
         // This code is for the new Unbuffered QTcpSocket use case
         qint64 written = d->socketEngine->write(data, size);
         if (written < 0) {
@@ -2695,14 +3035,14 @@ void QAbstractSocket::disconnectFromHost()
         }
 
         // Wait for pending data to be written.
-        if (d->socketEngine && d->socketEngine->isValid() && (d->writeBuffer.size() > 0
+        if (d->socketEngine && d->socketEngine->isValid() && (d->hasPendingWrites()
             || d->socketEngine->bytesToWrite() > 0)) {
             // hack: when we are waiting for the socket engine to write bytes (only
             // possible when using Socks5 or HTTP socket engine), then close
             // anyway after 2 seconds. This is to prevent a timeout on Mac, where we
             // sometimes just did not get the write notifier from the underlying
             // CFSocket and no progress was made.
-            if (d->writeBuffer.size() == 0 && d->socketEngine->bytesToWrite() > 0) {
+            if (!d->hasPendingWrites() && d->socketEngine->bytesToWrite() > 0) {
                 if (!d->disconnectTimer) {
                     d->disconnectTimer = new QTimer(this);
                     connect(d->disconnectTimer, SIGNAL(timeout()), this,
@@ -2748,7 +3088,7 @@ void QAbstractSocket::disconnectFromHost()
         qDebug("QAbstractSocket::disconnectFromHost() closed!");
 #endif
         d->buffer.clear();
-        d->writeBuffer.clear();
+        d->clearWriteBuffer();
         QIODevice::close();
     }
 }
@@ -226,6 +226,7 @@ private:
     Q_PRIVATE_SLOT(d_func(), void _q_abortConnectionAttempt())
     Q_PRIVATE_SLOT(d_func(), void _q_testConnection())
     Q_PRIVATE_SLOT(d_func(), void _q_forceDisconnect())
+    Q_PRIVATE_SLOT(d_func(), void _q_startConnectionRace())
 };
 
 
@@ -57,6 +57,8 @@
 #include "QtCore/qbytearray.h"
 #include "QtCore/qlist.h"
 #include "QtCore/qtimer.h"
+#include "QtCore/qpointer.h"
+#include "QtCore/qfile.h"
 #include "private/qringbuffer_p.h"
 #include "private/qiodevice_p.h"
 #include "private/qabstractsocketengine_p.h"
@@ -65,6 +67,27 @@
 QT_BEGIN_NAMESPACE
 
 class QHostInfo;
+class QAbstractSocketPrivate;
+
+// Receives the notifications of a connection attempt that is racing the
+// current one, see QAbstractSocketPrivate::_q_startConnectionRace().
+class QAbstractSocketRaceReceiver : public QAbstractSocketEngineReceiver
+{
+public:
+    inline explicit QAbstractSocketRaceReceiver(QAbstractSocketPrivate *d) : d(d) {}
+
+    inline void readNotification() {}
+    inline void writeNotification() {}
+    inline void exceptionNotification() {}
+    inline void closeNotification() {}
+    void connectionNotification();
+#ifndef QT_NO_NETWORKPROXY
+    inline void proxyAuthenticationRequired(const QNetworkProxy &, QAuthenticator *) {}
+#endif
+
+private:
+    QAbstractSocketPrivate *d;
+};
 
 class QAbstractSocketPrivate : public QIODevicePrivate, public QAbstractSocketEngineReceiver
 {
@@ -96,6 +119,7 @@ public:
     void _q_testConnection();
     void _q_abortConnectionAttempt();
     void _q_forceDisconnect();
+    void _q_startConnectionRace();
 
     bool readSocketNotifierCalled;
     bool readSocketNotifierState;
@@ -136,6 +160,11 @@ public:
     void resetSocketLayer();
     bool flush();
 
+    void scheduleConnectionRace();
+    void testRaceConnection();
+    void takeOverRaceEngine();
+    void cancelConnectionRace();
+
     bool initSocketLayer(QAbstractSocket::NetworkLayerProtocol protocol);
     void startConnectingByName(const QString &host);
     void fetchConnectionParameters();
@@ -145,6 +174,29 @@ public:
     qint64 readBufferMaxSize;
     QRingBuffer writeBuffer;
 
+    // a file region queued by QTcpSocket::writeFile(); it goes out after
+    // the first writeBufferBeforeFile bytes of the write buffer
+    QPointer<QFile> pendingFile;
+    qint64 pendingFileOffset;
+    qint64 pendingFileSize;
+    qint64 writeBufferBeforeFile;
+    bool pendingFileCopied;
+
+    inline bool hasPendingWrites() const
+    { return !writeBuffer.isEmpty() || pendingFileSize > 0; }
+    inline qint64 pendingWriteSize() const
+    { return writeBuffer.size() + pendingFileSize; }
+    inline void clearWriteBuffer()
+    {
+        writeBuffer.clear();
+        pendingFile = 0;
+        pendingFileSize = 0;
+        writeBufferBeforeFile = 0;
+    }
+    qint64 writeToSocket();
+    qint64 writeFromFile();
+    bool writeFileBlock();
+
     bool isBuffered;
     int blockingTimeout;
 
@@ -152,6 +204,13 @@ public:
     QTimer *disconnectTimer;
     int connectTimeElapsed;
 
+    // RFC 6555 (happy eyeballs): second connection attempt, to an address of
+    // the other family, started when the current attempt is slow to complete
+    QAbstractSocketEngine *raceEngine;
+    QHostAddress raceHost;
+    QTimer *raceTimer;
+    QAbstractSocketRaceReceiver raceReceiver;
+
     int hostLookupId;
 
     QAbstractSocket::SocketType socketType;
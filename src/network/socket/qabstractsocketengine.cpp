@@ -263,4 +263,92 @@ void QAbstractSocketEngine::setPeerPort(quint16 port)
     d_func()->peerPort = port;
 }
 
+/*
+    Writes the \a count blocks of \a sizes[\e i] bytes at \a data[\e i],
+    in order, and returns the number of bytes written, or -1 if an error
+    occurred before anything was written.
+
+    This implementation writes one block at a time and stops at the
+    first one the socket does not take completely; engines that can
+    gather several blocks into one call reimplement it.
+*/
+qint64 QAbstractSocketEngine::writeBlocks(const char * const *data, const qint64 *sizes, int count)
+{
+    qint64 total = 0;
+    for (int i = 0; i < count; ++i) {
+        const qint64 written = write(data[i], sizes[i]);
+        if (written < 0)
+            return total ? total : -1;
+        total += written;
+        if (written < sizes[i])
+            break;
+    }
+    return total;
+}
+
+/*
+    Writes up to \a size bytes, read from the file \a fileDescriptor
+    starting at \a offset, without copying them through user space.
+    Returns the number of bytes written, 0 if the file ended before
+    \a offset, -2 if nothing could be written without blocking, or -1 if
+    an error occurred.
+
+    This implementation fails with QAbstractSocket::UnsupportedSocketOperationError,
+    upon which the caller is expected to copy the data itself.
+*/
+qint64 QAbstractSocketEngine::sendFile(int fileDescriptor, qint64 offset, qint64 size)
+{
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(size);
+    setError(QAbstractSocket::UnsupportedSocketOperationError,
+             QAbstractSocketEngine::tr("Operation on socket is not supported"));
+    return -1;
+}
+
+#ifndef QT_NO_UDPSOCKET
+/*
+    Reads up to \a maxCount pending datagrams. Datagram \e i is stored
+    at \a data + \e i * \a maxlen, its size in \a sizes[\e i] and its
+    sender in \a addrs[\e i] and \a ports[\e i] if these are non-null.
+    Returns the number of datagrams read, 0 if none was pending, or -1
+    if an error occurred before any datagram could be read.
+
+    This implementation reads one datagram at a time; engines that can
+    read several with one call reimplement it.
+*/
+int QAbstractSocketEngine::readDatagrams(char *data, qint64 maxlen, int maxCount, qint64 *sizes,
+                                         QHostAddress *addrs, quint16 *ports)
+{
+    int count = 0;
+    while (count < maxCount && hasPendingDatagrams()) {
+        const qint64 size = readDatagram(data + count * maxlen, maxlen,
+                                         addrs ? addrs + count : 0, ports ? ports + count : 0);
+        if (size < 0)
+            return count ? count : -1;
+        sizes[count++] = size;
+    }
+    return count;
+}
+
+/*
+    Writes the \a count datagrams of \a sizes[\e i] bytes at \a data[\e i]
+    to \a addr on \a port. Returns the number of datagrams written,
+    which is less than \a count if the socket could not take all of them,
+    or -1 if an error occurred before any datagram was written.
+
+    This implementation writes one datagram at a time; engines that can
+    write several with one call reimplement it.
+*/
+int QAbstractSocketEngine::writeDatagrams(const char * const *data, const qint64 *sizes, int count,
+                                          const QHostAddress &addr, quint16 port)
+{
+    for (int i = 0; i < count; ++i) {
+        if (writeDatagram(data[i], sizes[i], addr, port) < 0)
+            return i ? i : -1;
+    }
+    return count;
+}
+#endif // QT_NO_UDPSOCKET
+
 QT_END_NAMESPACE
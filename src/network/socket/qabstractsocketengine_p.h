@@ -123,6 +123,8 @@ public:
 
     virtual qint64 read(char *data, qint64 maxlen) = 0;
     virtual qint64 write(const char *data, qint64 len) = 0;
+    virtual qint64 writeBlocks(const char * const *data, const qint64 *sizes, int count);
+    virtual qint64 sendFile(int fileDescriptor, qint64 offset, qint64 size);
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -140,6 +142,11 @@ public:
                                  quint16 port) = 0;
     virtual bool hasPendingDatagrams() const = 0;
     virtual qint64 pendingDatagramSize() const = 0;
+
+    virtual int readDatagrams(char *data, qint64 maxlen, int maxCount, qint64 *sizes,
+                              QHostAddress *addrs = 0, quint16 *ports = 0);
+    virtual int writeDatagrams(const char * const *data, const qint64 *sizes, int count,
+                               const QHostAddress &addr, quint16 port);
 #endif // QT_NO_UDPSOCKET
 
     virtual qint64 bytesToWrite() const = 0;
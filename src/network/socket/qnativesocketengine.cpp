@@ -789,6 +789,48 @@ qint64 QNativeSocketEngine::writeDatagram(const char *data, qint64 size,
     return d->nativeSendDatagram(data, size, host, port);
 }
 
+/*!
+    Reads up to \a maxCount pending datagrams with as few system calls
+    as the platform allows. Datagram \e i is stored at \a data + \e i
+    * \a maxSize and its size in \a sizes[\e i]. If \a addresses and
+    \a ports are non-null, the sender of each datagram is stored in
+    them as well. Datagrams larger than \a maxSize are truncated.
+
+    Returns the number of datagrams read, 0 if no datagram was pending,
+    or -1 if an error occurred.
+
+    \sa readDatagram()
+*/
+int QNativeSocketEngine::readDatagrams(char *data, qint64 maxSize, int maxCount, qint64 *sizes,
+                                       QHostAddress *addresses, quint16 *ports)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::readDatagrams(), QAbstractSocket::UdpSocket, -1);
+
+    return d->nativeReceiveDatagrams(data, maxSize, maxCount, sizes, addresses, ports);
+}
+
+/*!
+    Writes \a count UDP datagrams to the address \a host on port \a
+    port with as few system calls as the platform allows. Datagram \e
+    i has \a sizes[\e i] bytes, stored at \a data[\e i].
+
+    Returns the number of datagrams written, which is less than \a
+    count if the socket's send buffer filled up, or -1 if an error
+    occurred before the first datagram was written.
+
+    \sa writeDatagram()
+*/
+int QNativeSocketEngine::writeDatagrams(const char * const *data, const qint64 *sizes, int count,
+                                        const QHostAddress &host, quint16 port)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::UdpSocket, -1);
+    return d->nativeSendDatagrams(data, sizes, count, host, port);
+}
+
 /*!
     Writes a block of \a size bytes from \a data to the socket.
     Returns the number of bytes written, or -1 if an error occurred.
@@ -801,6 +843,37 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
     return d->nativeWrite(data, size);
 }
 
+/*!
+    Writes the \a count blocks of \a sizes[\e i] bytes at \a data[\e i]
+    to the socket, in order, with as few system calls as the platform
+    allows. Returns the number of bytes written, or -1 if an error
+    occurred.
+*/
+qint64 QNativeSocketEngine::writeBlocks(const char * const *data, const qint64 *sizes, int count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeBlocks(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::writeBlocks(), QAbstractSocket::ConnectedState, -1);
+    return d->nativeWriteBlocks(data, sizes, count);
+}
+
+/*!
+    Writes up to \a size bytes of the file \a fileDescriptor, starting
+    at \a offset, to the socket without copying them through user
+    space. Returns the number of bytes written, 0 if the file ended
+    before \a offset, -2 if the socket cannot take more data right now,
+    or -1 if an error occurred. The error is
+    QAbstractSocket::UnsupportedSocketOperationError if the platform or
+    the file does not support this.
+*/
+qint64 QNativeSocketEngine::sendFile(int fileDescriptor, qint64 offset, qint64 size)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::sendFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::sendFile(), QAbstractSocket::ConnectedState, -1);
+    return d->nativeSendFile(fileDescriptor, offset, size);
+}
+
 
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
@@ -140,6 +140,8 @@ public:
 
     qint64 read(char *data, qint64 maxlen);
     qint64 write(const char *data, qint64 len);
+    qint64 writeBlocks(const char * const *data, const qint64 *sizes, int count);
+    qint64 sendFile(int fileDescriptor, qint64 offset, qint64 size);
 
     qint64 readDatagram(char *data, qint64 maxlen, QHostAddress *addr = 0,
                             quint16 *port = 0);
@@ -148,6 +150,11 @@ public:
     bool hasPendingDatagrams() const;
     qint64 pendingDatagramSize() const;
 
+    int readDatagrams(char *data, qint64 maxlen, int maxCount, qint64 *sizes,
+                      QHostAddress *addrs = 0, quint16 *ports = 0);
+    int writeDatagrams(const char * const *data, const qint64 *sizes, int count,
+                       const QHostAddress &addr, quint16 port);
+
     qint64 bytesToWrite() const;
 
     qint64 receiveBufferSize() const;
@@ -267,8 +274,14 @@ public:
                                      QHostAddress *address, quint16 *port);
     qint64 nativeSendDatagram(const char *data, qint64 length,
                                   const QHostAddress &host, quint16 port);
+    int nativeReceiveDatagrams(char *data, qint64 maxLength, int maxCount, qint64 *sizes,
+                               QHostAddress *addresses, quint16 *ports);
+    int nativeSendDatagrams(const char * const *data, const qint64 *lengths, int count,
+                            const QHostAddress &host, quint16 port);
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+    qint64 nativeWriteBlocks(const char * const *data, const qint64 *lengths, int count);
+    qint64 nativeSendFile(int fileDescriptor, qint64 offset, qint64 length);
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
@@ -50,6 +50,7 @@
 #include <time.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <sys/uio.h>
 #ifndef QT_NO_IPV6IFNAME
 #include <net/if.h>
 #endif
@@ -64,6 +65,18 @@
 
 #include <netinet/tcp.h>
 
+// recvmmsg() and sendmmsg() move many datagrams with one system call
+#if defined(Q_OS_LINUX) && defined(__GLIBC__) \
+    && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 14))
+#  define QT_SOCKET_MMSG
+#endif
+
+// sendfile() copies from a file to a socket inside the kernel
+#if defined(Q_OS_LINUX)
+#  include <sys/sendfile.h>
+#  define QT_SOCKET_SENDFILE
+#endif
+
 QT_BEGIN_NAMESPACE
 
 #if defined QNATIVESOCKETENGINE_DEBUG
@@ -884,40 +897,54 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
     return qint64(maxSize ? recvFromResult : recvFromResult == -1 ? -1 : 0);
 }
 
-qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len,
-                                                   const QHostAddress &host, quint16 port)
+/*
+    Fills in the sockaddr for sending to \a host on \a port from a socket
+    of protocol \a socketProtocol, and returns its size.
+*/
+static QT_SOCKLEN_T qt_socket_setPortAndAddress(QAbstractSocket::NetworkLayerProtocol socketProtocol,
+                                                const QHostAddress &host, quint16 port,
+                                                sockaddr_in *sockAddrIPv4, sockaddr_in6 *sockAddrIPv6,
+                                                sockaddr **sockAddrPtr)
 {
-    struct sockaddr_in sockAddrIPv4;
-    struct sockaddr *sockAddrPtr = 0;
-    QT_SOCKLEN_T sockAddrSize = 0;
-
-    struct sockaddr_in6 sockAddrIPv6;
     if (host.protocol() == QAbstractSocket::IPv6Protocol
         || socketProtocol == QAbstractSocket::IPv6Protocol
         || socketProtocol == QAbstractSocket::AnyIPProtocol) {
-        memset(&sockAddrIPv6, 0, sizeof(sockAddrIPv6));
-        sockAddrIPv6.sin6_family = AF_INET6;
-        sockAddrIPv6.sin6_port = htons(port);
+        memset(sockAddrIPv6, 0, sizeof(*sockAddrIPv6));
+        sockAddrIPv6->sin6_family = AF_INET6;
+        sockAddrIPv6->sin6_port = htons(port);
 
         Q_IPV6ADDR tmp = host.toIPv6Address();
-        memcpy(&sockAddrIPv6.sin6_addr.s6_addr, &tmp, sizeof(tmp));
+        memcpy(&sockAddrIPv6->sin6_addr.s6_addr, &tmp, sizeof(tmp));
         QString scopeid = host.scopeId();
         bool ok;
-        sockAddrIPv6.sin6_scope_id = scopeid.toInt(&ok);
+        sockAddrIPv6->sin6_scope_id = scopeid.toInt(&ok);
 #ifndef QT_NO_IPV6IFNAME
         if (!ok)
-            sockAddrIPv6.sin6_scope_id = ::if_nametoindex(scopeid.toLatin1());
+            sockAddrIPv6->sin6_scope_id = ::if_nametoindex(scopeid.toLatin1());
 #endif
-        sockAddrSize = sizeof(sockAddrIPv6);
-        sockAddrPtr = (struct sockaddr *)&sockAddrIPv6;
+        *sockAddrPtr = (struct sockaddr *)sockAddrIPv6;
+        return sizeof(*sockAddrIPv6);
     } else if (host.protocol() == QAbstractSocket::IPv4Protocol) {
-        memset(&sockAddrIPv4, 0, sizeof(sockAddrIPv4));
-        sockAddrIPv4.sin_family = AF_INET;
-        sockAddrIPv4.sin_port = htons(port);
-        sockAddrIPv4.sin_addr.s_addr = htonl(host.toIPv4Address());
-        sockAddrSize = sizeof(sockAddrIPv4);
-        sockAddrPtr = (struct sockaddr *)&sockAddrIPv4;
+        memset(sockAddrIPv4, 0, sizeof(*sockAddrIPv4));
+        sockAddrIPv4->sin_family = AF_INET;
+        sockAddrIPv4->sin_port = htons(port);
+        sockAddrIPv4->sin_addr.s_addr = htonl(host.toIPv4Address());
+        *sockAddrPtr = (struct sockaddr *)sockAddrIPv4;
+        return sizeof(*sockAddrIPv4);
     }
+    *sockAddrPtr = 0;
+    return 0;
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len,
+                                                   const QHostAddress &host, quint16 port)
+{
+    struct sockaddr_in sockAddrIPv4;
+    struct sockaddr_in6 sockAddrIPv6;
+    struct sockaddr *sockAddrPtr = 0;
+    QT_SOCKLEN_T sockAddrSize = qt_socket_setPortAndAddress(socketProtocol, host, port,
+                                                            &sockAddrIPv4, &sockAddrIPv6,
+                                                            &sockAddrPtr);
 
     ssize_t sentBytes = qt_safe_sendto(socketDescriptor, data, len,
                                        0, sockAddrPtr, sockAddrSize);
@@ -941,6 +968,130 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     return qint64(sentBytes);
 }
 
+int QNativeSocketEnginePrivate::nativeReceiveDatagrams(char *data, qint64 maxSize, int maxCount,
+                                                       qint64 *sizes, QHostAddress *addresses,
+                                                       quint16 *ports)
+{
+    int count = 0;
+#ifdef QT_SOCKET_MMSG
+    // recvmmsg() takes the datagrams in batches of up to MaxBatch; a short
+    // batch means the receive queue is empty
+    enum { MaxBatch = 64 };
+    while (count < maxCount) {
+        const int batch = qMin<int>(maxCount - count, MaxBatch);
+        mmsghdr messages[MaxBatch];
+        iovec vectors[MaxBatch];
+        qt_sockaddr senders[MaxBatch];
+        memset(messages, 0, batch * sizeof(mmsghdr));
+        for (int i = 0; i < batch; ++i) {
+            vectors[i].iov_base = data + (count + i) * maxSize;
+            vectors[i].iov_len = maxSize;
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            if (addresses || ports) {
+                messages[i].msg_hdr.msg_name = &senders[i];
+                messages[i].msg_hdr.msg_namelen = sizeof(qt_sockaddr);
+            }
+        }
+
+        int received;
+        EINTR_LOOP(received, ::recvmmsg(socketDescriptor, messages, batch, MSG_DONTWAIT, 0));
+        if (received == -1) {
+            if (errno == ENOSYS)
+                break; // an older kernel, read them one by one
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return count;
+            if (count)
+                return count;
+            setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+            return -1;
+        }
+
+        for (int i = 0; i < received; ++i) {
+            sizes[count + i] = messages[i].msg_len;
+            if (addresses || ports) {
+                qt_socket_getPortAndAddress(&senders[i], ports ? ports + count + i : 0,
+                                            addresses ? addresses + count + i : 0);
+            }
+        }
+        count += received;
+        if (received < batch)
+            return count;
+    }
+    if (count == maxCount)
+        return count;
+#endif
+
+    while (count < maxCount && nativeHasPendingDatagrams()) {
+        const qint64 size = nativeReceiveDatagram(data + count * maxSize, maxSize,
+                                                  addresses ? addresses + count : 0,
+                                                  ports ? ports + count : 0);
+        if (size < 0)
+            return count ? count : -1;
+        sizes[count++] = size;
+    }
+    return count;
+}
+
+int QNativeSocketEnginePrivate::nativeSendDatagrams(const char * const *data, const qint64 *lengths,
+                                                    int count, const QHostAddress &host,
+                                                    quint16 port)
+{
+    int sent = 0;
+#ifdef QT_SOCKET_MMSG
+    struct sockaddr_in sockAddrIPv4;
+    struct sockaddr_in6 sockAddrIPv6;
+    struct sockaddr *sockAddrPtr = 0;
+    QT_SOCKLEN_T sockAddrSize = qt_socket_setPortAndAddress(socketProtocol, host, port,
+                                                            &sockAddrIPv4, &sockAddrIPv6,
+                                                            &sockAddrPtr);
+
+    enum { MaxBatch = 64 };
+    while (sent < count) {
+        const int batch = qMin<int>(count - sent, MaxBatch);
+        mmsghdr messages[MaxBatch];
+        iovec vectors[MaxBatch];
+        memset(messages, 0, batch * sizeof(mmsghdr));
+        for (int i = 0; i < batch; ++i) {
+            vectors[i].iov_base = const_cast<char *>(data[sent + i]);
+            vectors[i].iov_len = lengths[sent + i];
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = sockAddrPtr;
+            messages[i].msg_hdr.msg_namelen = sockAddrSize;
+        }
+
+        int result;
+        EINTR_LOOP(result, ::sendmmsg(socketDescriptor, messages, batch, MSG_NOSIGNAL));
+        if (result == -1) {
+            if (errno == ENOSYS)
+                break; // an older kernel, send them one by one
+            if (sent)
+                return sent;
+            switch (errno) {
+            case EMSGSIZE:
+                setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
+                break;
+            default:
+                setError(QAbstractSocket::NetworkError, SendDatagramErrorString);
+            }
+            return -1;
+        }
+        sent += result;
+        if (result < batch)
+            return sent; // the send buffer is full
+    }
+    if (sent == count)
+        return sent;
+#endif
+
+    for (; sent < count; ++sent) {
+        if (nativeSendDatagram(data[sent], lengths[sent], host, port) < 0)
+            return sent ? sent : -1;
+    }
+    return sent;
+}
+
 bool QNativeSocketEnginePrivate::fetchConnectionParameters()
 {
     localPort = 0;
@@ -1072,6 +1223,96 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 
     return qint64(writtenBytes);
 }
+
+qint64 QNativeSocketEnginePrivate::nativeWriteBlocks(const char * const *data, const qint64 *lengths,
+                                                     int count)
+{
+    Q_Q(QNativeSocketEngine);
+
+    enum { MaxBlocks = 64 };
+    iovec vectors[MaxBlocks];
+    count = qMin<int>(count, MaxBlocks);
+    for (int i = 0; i < count; ++i) {
+        vectors[i].iov_base = const_cast<char *>(data[i]);
+        vectors[i].iov_len = lengths[i];
+    }
+
+    qt_ignore_sigpipe();
+    ssize_t writtenBytes;
+    EINTR_LOOP(writtenBytes, ::writev(socketDescriptor, vectors, count));
+
+    if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            writtenBytes = -1;
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            writtenBytes = 0;
+            break;
+        default:
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWriteBlocks(%p, %p, %i) == %i",
+           data, lengths, count, (int) writtenBytes);
+#endif
+
+    return qint64(writtenBytes);
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendFile(int fileDescriptor, qint64 offset, qint64 length)
+{
+#ifdef QT_SOCKET_SENDFILE
+    Q_Q(QNativeSocketEngine);
+
+    qt_ignore_sigpipe();
+    off_t fileOffset = offset;
+    ssize_t writtenBytes;
+    EINTR_LOOP(writtenBytes, ::sendfile(socketDescriptor, fileDescriptor, &fileOffset,
+                                        size_t(qMin<qint64>(length, 0x7ffff000))));
+
+    if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            // the socket is full, unlike 0 which means the end of the file
+            writtenBytes = -2;
+            break;
+        case EINVAL:
+        case ENOSYS:
+            // not a file that can be mapped, the caller copies it instead
+            setError(QAbstractSocket::UnsupportedSocketOperationError, OperationUnsupportedErrorString);
+            break;
+        default:
+            setError(QAbstractSocket::NetworkError, WriteErrorString);
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendFile(%i, %lli, %lli) == %i",
+           fileDescriptor, offset, length, (int) writtenBytes);
+#endif
+
+    return qint64(writtenBytes);
+#else
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(length);
+    setError(QAbstractSocket::UnsupportedSocketOperationError, OperationUnsupportedErrorString);
+    return -1;
+#endif
+}
+
 /*
 */
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
@@ -1339,6 +1339,34 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     return ret;
 }
 
+// Winsock has no call for several datagrams; take them one at a time
+int QNativeSocketEnginePrivate::nativeReceiveDatagrams(char *data, qint64 maxLength, int maxCount,
+                                                       qint64 *sizes, QHostAddress *addresses,
+                                                       quint16 *ports)
+{
+    int count = 0;
+    while (count < maxCount && nativeHasPendingDatagrams()) {
+        const qint64 size = nativeReceiveDatagram(data + count * maxLength, maxLength,
+                                                  addresses ? addresses + count : 0,
+                                                  ports ? ports + count : 0);
+        if (size < 0)
+            return count ? count : -1;
+        sizes[count++] = size;
+    }
+    return count;
+}
+
+int QNativeSocketEnginePrivate::nativeSendDatagrams(const char * const *data, const qint64 *lengths,
+                                                    int count, const QHostAddress &address,
+                                                    quint16 port)
+{
+    for (int i = 0; i < count; ++i) {
+        if (nativeSendDatagram(data[i], lengths[i], address, port) < 0)
+            return i ? i : -1;
+    }
+    return count;
+}
+
 
 qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 {
@@ -1398,6 +1426,31 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
     return ret;
 }
 
+qint64 QNativeSocketEnginePrivate::nativeWriteBlocks(const char * const *data, const qint64 *lengths,
+                                                     int count)
+{
+    qint64 total = 0;
+    for (int i = 0; i < count; ++i) {
+        const qint64 written = nativeWrite(data[i], lengths[i]);
+        if (written < 0)
+            return total ? total : -1;
+        total += written;
+        if (written < lengths[i])
+            break;
+    }
+    return total;
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendFile(int fileDescriptor, qint64 offset, qint64 length)
+{
+    // TransmitFile() wants a blocking or overlapped socket; let the caller copy
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(length);
+    setError(QAbstractSocket::UnsupportedSocketOperationError, OperationUnsupportedErrorString);
+    return -1;
+}
+
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxLength)
 {
     qint64 ret = -1;
@@ -70,6 +70,7 @@
 #include "qtcpsocket_p.h"
 #include "qlist.h"
 #include "qhostaddress.h"
+#include "qfile.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -102,6 +103,63 @@ QTcpSocket::~QTcpSocket()
 #endif
 }
 
+/*!
+    \since 5.4
+
+    Queues \a size bytes of \a file, starting at \a offset, to be written
+    to the socket after any data already written. If \a size is -1, the
+    rest of the file is written. Returns \c true if the region was queued;
+    otherwise returns \c false.
+
+    Where the platform supports it, the data is passed from the file to
+    the socket inside the kernel, without being copied into the write
+    buffer; on other platforms, and for QSslSocket, it is read one block
+    at a time once the previous block has been sent, so only a block of
+    the region is held in memory. Like data passed to write(), the region
+    is counted by bytesToWrite() and reported by bytesWritten().
+
+    The socket must be connected and \a file must be open for reading.
+    The file must not be closed or deleted before the region has been
+    written. Only one file region can be pending at a time.
+
+    \sa write(), bytesToWrite()
+*/
+bool QTcpSocket::writeFile(QFile *file, qint64 offset, qint64 size)
+{
+    Q_D(QTcpSocket);
+    if (!file || !file->isReadable() || file->isSequential()) {
+        qWarning("QTcpSocket::writeFile: File is not open for reading");
+        return false;
+    }
+    if (d->state != ConnectedState || !isWritable())
+        return false;
+    if (d->pendingFileSize > 0)
+        return false;
+
+    if (size < 0)
+        size = file->size() - offset;
+    if (offset < 0 || size < 0 || offset + size > file->size())
+        return false;
+    if (size == 0)
+        return true;
+
+    d->pendingFile = file;
+    d->pendingFileOffset = offset;
+    d->pendingFileSize = size;
+    d->pendingFileCopied = false;
+
+    if (!d->socketEngine) {
+        // the socket writes through another one (QSslSocket), which
+        // asks for the following blocks as the previous ones drain
+        d->writeBufferBeforeFile = 0;
+        return d->writeFileBlock();
+    }
+
+    d->writeBufferBeforeFile = d->writeBuffer.size();
+    d->socketEngine->setWriteNotificationEnabled(true);
+    return true;
+}
+
 /*!
     \internal
 */
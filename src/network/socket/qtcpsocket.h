@@ -48,6 +48,7 @@
 QT_BEGIN_NAMESPACE
 
 
+class QFile;
 class QTcpSocketPrivate;
 
 class Q_NETWORK_EXPORT QTcpSocket : public QAbstractSocket
@@ -57,6 +58,8 @@ public:
     explicit QTcpSocket(QObject *parent = 0);
     virtual ~QTcpSocket();
 
+    bool writeFile(QFile *file, qint64 offset = 0, qint64 size = -1);
+
 protected:
     QTcpSocket(QTcpSocketPrivate &dd, QObject *parent = 0);
 
@@ -68,7 +68,9 @@
     The readyRead() signal is emitted whenever datagrams arrive. In
     that case, hasPendingDatagrams() returns \c true. Call
     pendingDatagramSize() to obtain the size of the first pending
-    datagram, and readDatagram() to read it.
+    datagram, and readDatagram() to read it. When datagrams arrive or
+    leave at a high rate, readDatagrams() and writeDatagrams() move many of
+    them with a single call.
 
     \note An incoming datagram should be read when you receive the readyRead()
     signal, otherwise this signal will not be emitted for the next datagram.
@@ -102,6 +104,7 @@
 #include "qhostaddress.h"
 #include "qnetworkinterface.h"
 #include "qabstractsocket_p.h"
+#include "qvarlengtharray.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -396,6 +399,113 @@ qint64 QUdpSocket::readDatagram(char *data, qint64 maxSize, QHostAddress *addres
     }
     return readBytes;
 }
+
+/*!
+    \since 5.4
+
+    Receives up to \a maxCount pending datagrams at once. Datagram \e i
+    is stored at \a data + \e i * \a maxSize, so \a data must have room
+    for \a maxCount * \a maxSize bytes. Its size is stored in \a
+    sizes[\e i], and its sender's host address and port in \a
+    hosts[\e i] and \a ports[\e i] (unless the pointers are 0).
+
+    Returns the number of datagrams received, which is 0 if there was no
+    pending datagram, or -1 if an error occurred.
+
+    Datagrams larger than \a maxSize are truncated. Where the platform
+    supports it (\c recvmmsg() on Linux) all datagrams are received with
+    a single system call, which makes this function considerably faster
+    than calling readDatagram() for each of them when datagrams arrive
+    at a high rate.
+
+    \sa readDatagram(), writeDatagrams()
+*/
+int QUdpSocket::readDatagrams(char *data, qint64 maxSize, int maxCount, qint64 *sizes,
+                              QHostAddress *hosts, quint16 *ports)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::readDatagrams(%p, %llu, %i, %p, %p, %p)", data, maxSize, maxCount,
+           sizes, hosts, ports);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::readDatagrams()", -1);
+    int count = d->socketEngine->readDatagrams(data, maxSize, maxCount, sizes, hosts, ports);
+    d->socketEngine->setReadNotificationEnabled(true);
+    if (count < 0) {
+        d->socketError = d->socketEngine->error();
+        setErrorString(d->socketEngine->errorString());
+        emit error(d->socketError);
+    }
+    return count;
+}
+
+/*!
+    \since 5.4
+
+    Sends \a count datagrams to the host address \a host at port \a
+    port. Datagram \e i has \a sizes[\e i] bytes, stored at \a
+    data[\e i].
+
+    Returns the number of datagrams sent, or -1 if an error occurred
+    before the first one was sent. Fewer than \a count datagrams are
+    sent if the socket's send buffer fills up; the remaining ones can
+    be sent again later.
+
+    Where the platform supports it (\c sendmmsg() on Linux) all
+    datagrams are sent with a single system call. The bytesWritten()
+    signal is emitted once, with the total size of the datagrams sent.
+
+    \sa writeDatagram(), readDatagrams()
+*/
+int QUdpSocket::writeDatagrams(const char * const *data, const qint64 *sizes, int count,
+                               const QHostAddress &host, quint16 port)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%p, %p, %i, \"%s\", %i)", data, sizes, count,
+           host.toString().toLatin1().constData(), port);
+#endif
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, host))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+
+    int sent = d->socketEngine->writeDatagrams(data, sizes, count, host, port);
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    if (sent >= 0) {
+        qint64 bytes = 0;
+        for (int i = 0; i < sent; ++i)
+            bytes += sizes[i];
+        if (sent)
+            emit bytesWritten(bytes);
+    } else {
+        d->socketError = d->socketEngine->error();
+        setErrorString(d->socketEngine->errorString());
+        emit error(d->socketError);
+    }
+    return sent;
+}
+
+/*!
+    \since 5.4
+    \overload
+
+    Sends the \a datagrams to the host address \a host at port \a port.
+*/
+int QUdpSocket::writeDatagrams(const QList<QByteArray> &datagrams, const QHostAddress &host,
+                               quint16 port)
+{
+    const int count = datagrams.count();
+    QVarLengthArray<const char *, 64> data(count);
+    QVarLengthArray<qint64, 64> sizes(count);
+    for (int i = 0; i < count; ++i) {
+        data[i] = datagrams.at(i).constData();
+        sizes[i] = datagrams.at(i).size();
+    }
+    return writeDatagrams(data.constData(), sizes.constData(), count, host, port);
+}
 #endif // QT_NO_UDPSOCKET
 
 QT_END_NAMESPACE
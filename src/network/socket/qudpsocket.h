@@ -44,6 +44,7 @@
 
 #include <QtNetwork/qabstractsocket.h>
 #include <QtNetwork/qhostaddress.h>
+#include <QtCore/qlist.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -79,6 +80,12 @@ public:
     inline qint64 writeDatagram(const QByteArray &datagram, const QHostAddress &host, quint16 port)
         { return writeDatagram(datagram.constData(), datagram.size(), host, port); }
 
+    int readDatagrams(char *data, qint64 maxSize, int maxCount, qint64 *sizes,
+                      QHostAddress *hosts = 0, quint16 *ports = 0);
+    int writeDatagrams(const char * const *data, const qint64 *sizes, int count,
+                       const QHostAddress &host, quint16 port);
+    int writeDatagrams(const QList<QByteArray> &datagrams, const QHostAddress &host, quint16 port);
+
 private:
     Q_DISABLE_COPY(QUdpSocket)
     Q_DECLARE_PRIVATE(QUdpSocket)
@@ -162,7 +162,10 @@ QT_BEGIN_NAMESPACE
     option can allow connections for legacy servers, but it introduces the
     possibility that an attacker could inject plaintext into the SSL session.
     \value SslOptionDisableSessionSharing Disables SSL session sharing via
-    the session ID handshake attribute.
+    the session ID handshake attribute. By default, client sockets resume
+    the session of an earlier connection to the same host and port, and
+    server sockets with the same configuration accept each other's sessions,
+    which saves a full handshake on reconnects.
     \value SslOptionDisableSessionPersistence Disables storing the SSL session
     in ASN.1 format as returned by QSslConfiguration::sessionTicket(). Enabling
     this feature adds memory overhead of approximately 1K per used session
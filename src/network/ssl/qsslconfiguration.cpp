@@ -55,6 +55,7 @@ const QSsl::SslOptions QSslConfigurationPrivate::defaultSslOptions = QSsl::SslOp
 
 const char QSslConfiguration::NextProtocolSpdy3_0[] = "spdy/3";
 const char QSslConfiguration::NextProtocolHttp1_1[] = "http/1.1";
+const char QSslConfiguration::NextProtocolHttp2_0[] = "h2";
 
 /*!
     \class QSslConfiguration
@@ -143,6 +144,13 @@ const char QSslConfiguration::NextProtocolHttp1_1[] = "http/1.1";
     Protocol Negotiation.
 */
 
+/*!
+    \variable QSslConfiguration::NextProtocolHttp2_0
+    \brief The value used for negotiating HTTP/2 during the Next
+    Protocol Negotiation.
+    \since 5.4
+*/
+
 /*!
     Constructs an empty SSL configuration. This configuration contains
     no valid settings and the state will be empty. isNull() will
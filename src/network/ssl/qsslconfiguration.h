@@ -146,6 +146,7 @@ public:
 
     static const char NextProtocolSpdy3_0[];
     static const char NextProtocolHttp1_1[];
+    static const char NextProtocolHttp2_0[];
 
 private:
     friend class QSslSocket;
@@ -42,6 +42,7 @@
 
 
 #include <QtNetwork/qsslsocket.h>
+#include <QtCore/qcryptographichash.h>
 #include <QtCore/qmutex.h>
 
 #include "private/qsslcontext_p.h"
@@ -55,6 +56,29 @@ QT_BEGIN_NAMESPACE
 extern int q_X509Callback(int ok, X509_STORE_CTX *ctx);
 extern QString getErrorsFromOpenSsl();
 
+struct QSslSessionTicketKeys
+{
+    QMutex mutex;
+    QByteArray keys;
+};
+Q_GLOBAL_STATIC(QSslSessionTicketKeys, serverSessionTicketKeys)
+Q_GLOBAL_STATIC(QSslSessionCache, globalSessionCache)
+
+// The keys used by all server contexts of this process to encrypt session
+// tickets, so that a ticket issued by one server socket is accepted by the
+// others.
+static QByteArray sessionTicketKeys()
+{
+    QSslSessionTicketKeys *ticketKeys = serverSessionTicketKeys();
+    QMutexLocker locker(&ticketKeys->mutex);
+    if (ticketKeys->keys.isEmpty()) {
+        QByteArray keys(48, Qt::Uninitialized); // name, HMAC secret and AES key
+        if (q_RAND_bytes(reinterpret_cast<unsigned char *>(keys.data()), keys.size()) == 1)
+            ticketKeys->keys = keys;
+    }
+    return ticketKeys->keys;
+}
+
 // Default DH params
 // 1024-bit MODP Group with 160-bit Prime Order Subgroup
 // From RFC 5114
@@ -304,6 +328,31 @@ init_context:
     if (sslContext->sslConfiguration.peerVerifyDepth() != 0)
         q_SSL_CTX_set_verify_depth(sslContext->ctx, sslContext->sslConfiguration.peerVerifyDepth());
 
+    if (!client && !(configuration.d->sslOptions & QSsl::SslOptionDisableSessionSharing)) {
+        // Every server socket creates a context of its own. Give the contexts
+        // of identically configured sockets the same session ID context and
+        // ticket keys, so that clients can resume their sessions on any of
+        // them, but never on a server that would negotiate differently.
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(configuration.localCertificate().toDer());
+        hash.addData(QByteArray::number(int(configuration.protocol())));
+        hash.addData(QByteArray::number(int(configuration.peerVerifyMode())));
+        hash.addData(QByteArray::number(configuration.peerVerifyDepth()));
+        foreach (const QSslCertificate &certificate, configuration.caCertificates())
+            hash.addData(certificate.digest(QCryptographicHash::Sha1));
+        const QByteArray sessionIdContext = hash.result();
+        q_SSL_CTX_set_session_id_context(sslContext->ctx,
+                                         reinterpret_cast<const unsigned char *>(sessionIdContext.constData()),
+                                         sessionIdContext.size());
+#if OPENSSL_VERSION_NUMBER >= 0x0090808fL && !defined(OPENSSL_NO_TLSEXT)
+        if (!(configuration.d->sslOptions & QSsl::SslOptionDisableSessionTickets)) {
+            QByteArray keys = sessionTicketKeys();
+            if (!keys.isEmpty())
+                q_SSL_CTX_ctrl(sslContext->ctx, SSL_CTRL_SET_TLSEXT_TICKET_KEYS, keys.size(), keys.data());
+        }
+#endif
+    }
+
     // set persisted session if the user set it
     if (!configuration.sessionTicket().isEmpty())
         sslContext->setSessionASN1(configuration.sessionTicket());
@@ -459,4 +508,125 @@ QString QSslContext::errorString() const
     return errorStr;
 }
 
+QSslSessionCache::Entry::~Entry()
+{
+    if (session)
+        q_SSL_SESSION_free(session);
+}
+
+// keep the sessions of the 128 most recently used servers
+QSslSessionCache::QSslSessionCache()
+    : cache(128)
+{
+}
+
+QSslSessionCache *QSslSessionCache::instance()
+{
+    return globalSessionCache();
+}
+
+// A session may only be resumed by a connection that would have negotiated
+// the same parameters from scratch, and that would have accepted the
+// certificates of the server: resuming a session skips their verification.
+QByteArray QSslSessionCache::key(const QString &peerName, quint16 port,
+                                 const QSslConfigurationPrivate &configuration, bool ignoresErrors)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(int(configuration.protocol)));
+    hash.addData(QByteArray::number(int(configuration.peerVerifyMode)));
+    hash.addData(QByteArray::number(configuration.peerVerifyDepth));
+    hash.addData(ignoresErrors ? "i" : "v", 1);
+    if (!configuration.localCertificateChain.isEmpty())
+        hash.addData(configuration.localCertificateChain.first().digest(QCryptographicHash::Sha1));
+    hash.addData("/", 1);
+    foreach (const QSslCertificate &certificate, configuration.caCertificates)
+        hash.addData(certificate.digest(QCryptographicHash::Sha1));
+
+    QByteArray key = peerName.toLower().toUtf8();
+    key += ':';
+    key += QByteArray::number(port);
+    key += '/';
+    key += hash.result().toHex();
+    return key;
+}
+
+// Sets the cached session for \a key on \a ssl, which must not have
+// done its handshake yet. Returns false if there is none.
+bool QSslSessionCache::offerSession(SSL *ssl, const QByteArray &key)
+{
+    QMutexLocker locker(&mutex);
+    ++stats.lookups;
+
+    Entry *entry = cache.object(key);
+    if (!entry)
+        return false;
+    if (entry->age.hasExpired(entry->lifeTime)) {
+        cache.remove(key);
+        return false;
+    }
+    // SSL_set_session() takes its own reference
+    if (!q_SSL_set_session(ssl, entry->session)) {
+        cache.remove(key);
+        return false;
+    }
+
+    ++stats.hits;
+    return true;
+}
+
+// Stores the session negotiated by \a ssl for later connections. Only
+// sessions of handshakes that verified the server without any errors,
+// ignored or not, may be stored.
+void QSslSessionCache::sessionEstablished(SSL *ssl, const QByteArray &key, bool resumed)
+{
+    SSL_SESSION *session = q_SSL_get1_session(ssl);
+
+    QMutexLocker locker(&mutex);
+    if (resumed)
+        ++stats.resumptions;
+    if (!session)
+        return;
+
+    Entry *entry = cache.object(key);
+    if (entry && entry->session == session) {
+        // the session we offered was resumed, it is still the current one
+        q_SSL_SESSION_free(session);
+        return;
+    }
+
+    entry = new Entry;
+    entry->session = session;
+    entry->age.start();
+    // how long the server said it would accept the session
+    long lifeTime = session->tlsext_tick_lifetime_hint > 0
+            ? long(session->tlsext_tick_lifetime_hint) : session->timeout;
+    entry->lifeTime = qint64(lifeTime) * 1000;
+    cache.insert(key, entry);
+    ++stats.insertions;
+}
+
+void QSslSessionCache::remove(const QByteArray &key)
+{
+    QMutexLocker locker(&mutex);
+    cache.remove(key);
+}
+
+void QSslSessionCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    cache.clear();
+}
+
+QSslSessionCache::Statistics QSslSessionCache::statistics() const
+{
+    QMutexLocker locker(&mutex);
+    return stats;
+}
+
+void QSslSessionCache::resetStatistics()
+{
+    QMutexLocker locker(&mutex);
+    stats = Statistics();
+}
+
 QT_END_NAMESPACE
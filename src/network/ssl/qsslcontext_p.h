@@ -45,6 +45,9 @@
 #define QSSLCONTEXT_H
 
 #include <QtCore/qvariant.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
 #include <QtNetwork/qsslcertificate.h>
 #include <QtNetwork/qsslconfiguration.h>
 #include <openssl/ssl.h>
@@ -106,6 +109,49 @@ private:
 #endif // OPENSSL_VERSION_NUMBER >= 0x1000100fL ...
 };
 
+// Process wide cache of client sessions, so that a new connection to a
+// server we talked to before can resume the session (by session ID or
+// session ticket) even if it does not share a QSslContext with the
+// connection that established it.
+class Q_AUTOTEST_EXPORT QSslSessionCache
+{
+public:
+    struct Statistics {
+        Statistics() : lookups(0), hits(0), resumptions(0), insertions(0) { }
+        qint64 lookups;     // client handshakes that looked for a session
+        qint64 hits;        // ... and found one to offer to the server
+        qint64 resumptions; // handshakes in which the server resumed a session
+        qint64 insertions;
+    };
+
+    static QSslSessionCache *instance();
+    static QByteArray key(const QString &peerName, quint16 port,
+                          const QSslConfigurationPrivate &configuration, bool ignoresErrors);
+
+    bool offerSession(SSL *ssl, const QByteArray &key);
+    void sessionEstablished(SSL *ssl, const QByteArray &key, bool resumed);
+    void remove(const QByteArray &key);
+    void clear();
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+    QSslSessionCache();
+
+private:
+    struct Entry {
+        Entry() : session(0), lifeTime(0) { }
+        ~Entry();
+        SSL_SESSION *session;
+        QElapsedTimer age;
+        qint64 lifeTime; // msecs
+    };
+
+    mutable QMutex mutex;
+    QCache<QByteArray, Entry> cache;
+    Statistics stats;
+};
+
 #endif // QT_NO_SSL
 
 QT_END_NAMESPACE
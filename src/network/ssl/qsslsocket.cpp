@@ -301,6 +301,10 @@
 #include <QtNetwork/qhostaddress.h>
 #include <QtNetwork/qhostinfo.h>
 
+// how much of a file region passed to writeFile() may wait in the plain
+// socket before the next block is read
+#define QSSLSOCKET_FILEBLOCKSIZE 65536
+
 QT_BEGIN_NAMESPACE
 
 /*
@@ -721,8 +725,8 @@ qint64 QSslSocket::bytesToWrite() const
 {
     Q_D(const QSslSocket);
     if (d->mode == UnencryptedMode)
-        return d->plainSocket ? d->plainSocket->bytesToWrite() : 0;
-    return d->writeBuffer.size();
+        return (d->plainSocket ? d->plainSocket->bytesToWrite() : 0) + d->pendingFileSize;
+    return d->pendingWriteSize();
 }
 
 /*!
@@ -783,7 +787,7 @@ void QSslSocket::close()
 
     // must be cleared, reading/writing not possible on closed socket:
     d->buffer.clear();
-    d->writeBuffer.clear();
+    d->clearWriteBuffer();
 }
 
 /*!
@@ -1831,6 +1835,14 @@ void QSslSocket::disconnectFromHost()
     if (d->state == UnconnectedState)
         return;
     if (d->mode == UnencryptedMode && !d->autoStartHandshake) {
+        if (d->pendingFileSize > 0) {
+            // disconnect once the rest of the file region has been written
+            if (d->state != ClosingState) {
+                d->state = ClosingState;
+                emit stateChanged(d->state);
+            }
+            return;
+        }
         d->plainSocket->disconnectFromHost();
         return;
     }
@@ -1845,7 +1857,7 @@ void QSslSocket::disconnectFromHost()
         emit stateChanged(d->state);
     }
 
-    if (!d->writeBuffer.isEmpty())
+    if (d->hasPendingWrites())
         return;
 
     if (d->mode == UnencryptedMode) {
@@ -1944,7 +1956,7 @@ void QSslSocketPrivate::init()
 //    ignoreErrorsList.clear();
 
     buffer.clear();
-    writeBuffer.clear();
+    clearWriteBuffer();
     configuration.peerCertificate.clear();
     configuration.peerCertificateChain.clear();
 }
@@ -2150,7 +2162,7 @@ void QSslSocketPrivate::createPlainSocket(QIODevice::OpenMode openMode)
 #endif
 
     buffer.clear();
-    writeBuffer.clear();
+    clearWriteBuffer();
     connectionEncrypted = false;
     configuration.peerCertificate.clear();
     configuration.peerCertificateChain.clear();
@@ -2298,7 +2310,19 @@ void QSslSocketPrivate::_q_bytesWrittenSlot(qint64 written)
         emit q->bytesWritten(written);
     else
         emit q->encryptedBytesWritten(written);
-    if (state == QAbstractSocket::ClosingState && writeBuffer.isEmpty())
+
+    // pass on the next block of a file region once the plain socket has
+    // sent the previous one, rather than reading it all into memory
+    if (pendingFileSize > 0 && writeBuffer.isEmpty()
+        && plainSocket->bytesToWrite() < QSSLSOCKET_FILEBLOCKSIZE) {
+        if (!writeFileBlock()) {
+            emit q->error(socketError);
+            q->abort();
+            return;
+        }
+    }
+
+    if (state == QAbstractSocket::ClosingState && !hasPendingWrites())
         q->disconnectFromHost();
 }
 
@@ -350,6 +350,22 @@ bool QSslSocketBackendPrivate::initSslContext()
         return false;
     }
 
+    // Offer the session of an earlier connection to the same server, unless
+    // the context already provided one (QHttpNetworkConnection shares its
+    // context between its channels, and QSslConfiguration::setSessionTicket()
+    // sets one explicitly).
+    sessionCacheKey.clear();
+    if (mode == QSslSocket::SslClientMode
+        && !(configuration.sslOptions & QSsl::SslOptionDisableSessionSharing)) {
+        QString sessionPeerName = verificationPeerName.isEmpty() ? q->peerName() : verificationPeerName;
+        if (sessionPeerName.isEmpty())
+            sessionPeerName = hostName;
+        sessionCacheKey = QSslSessionCache::key(sessionPeerName, q->peerPort(), configuration,
+                                                ignoreAllSslErrors || !ignoreErrorsList.isEmpty());
+        if (!q_SSL_get_session(ssl))
+            QSslSessionCache::instance()->offerSession(ssl, sessionCacheKey);
+    }
+
 #if OPENSSL_VERSION_NUMBER >= 0x0090806fL && !defined(OPENSSL_NO_TLSEXT)
     if ((configuration.protocol == QSsl::TlsV1SslV3 ||
         configuration.protocol == QSsl::TlsV1_0 ||
@@ -1489,6 +1505,18 @@ void QSslSocketBackendPrivate::continueHandshake()
         }
     }
 
+    // ... and in the process wide cache, for connections with a context of their own.
+    // A resumed session is not verified again, so only sessions of handshakes
+    // that verified the server without any errors are stored.
+    if (!sessionCacheKey.isEmpty()) {
+        if (sslErrors.isEmpty() && configuration.peerVerifyMode != QSslSocket::VerifyNone
+            && configuration.peerVerifyMode != QSslSocket::QueryPeer) {
+            QSslSessionCache::instance()->sessionEstablished(ssl, sessionCacheKey, configuration.peerSessionShared);
+        } else {
+            QSslSessionCache::instance()->remove(sessionCacheKey);
+        }
+    }
+
 #if OPENSSL_VERSION_NUMBER >= 0x1000100fL && !defined(OPENSSL_NO_TLSEXT) && !defined(OPENSSL_NO_NEXTPROTONEG)
     const unsigned char *proto = 0;
     unsigned int proto_len = 0;
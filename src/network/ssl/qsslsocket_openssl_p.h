@@ -121,6 +121,7 @@ public:
     BIO *readBio;
     BIO *writeBio;
     SSL_SESSION *session;
+    QByteArray sessionCacheKey; // key into QSslSessionCache, empty if not used
     QList<QPair<int, int> > errorList;
 
     // Platform specific functions
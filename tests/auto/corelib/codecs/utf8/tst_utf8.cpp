@@ -77,6 +77,9 @@ private slots:
 
     void nonCharacters_data();
     void nonCharacters();
+
+    void longStrings_data();
+    void longStrings();
 };
 
 void tst_Utf8::initTestCase()
@@ -297,5 +300,65 @@ void tst_Utf8::nonCharacters()
         qWarning("System codec reports failure when it shouldn't. Should report bug upstream.");
 }
 
+void tst_Utf8::longStrings_data()
+{
+    // Each row is a short piece that gets repeated, after a US-ASCII prefix of
+    // varying length, to build strings long enough for the vectorized paths.
+    // The expected result is the concatenation of the decoded pieces.
+    QTest::addColumn<QByteArray>("utf8");
+    QTest::addColumn<bool>("valid");
+
+    QTest::newRow("cyrillic") << QByteArray("\320\257\320\267\321\213\320\272 ") << true;
+    QTest::newRow("greek") << QByteArray("\316\223\316\273\317\216\317\203\317\203\316\261") << true;
+    QTest::newRow("cjk") << QByteArray("\350\250\200\350\252\236") << true;
+    QTest::newRow("mixed") << QByteArray("a\320\257\350\250\200b") << true;
+    QTest::newRow("limits") << QByteArray("\302\200\337\277\340\240\200\355\237\277\356\200\200\357\277\277")
+                            << true;
+    QTest::newRow("bom") << QByteArray("x\357\273\277") << true;
+    QTest::newRow("nul") << QByteArray("\320\257\0", 3) << true;
+    QTest::newRow("supplementary") << QByteArray("\320\257\360\237\230\200") << true;
+
+    QTest::newRow("lone-continuation") << QByteArray("\320\257\200") << false;
+    QTest::newRow("truncated-2") << QByteArray("\320a") << false;
+    QTest::newRow("truncated-3") << QByteArray("\350\250a") << false;
+    QTest::newRow("overlong-2") << QByteArray("\301\277\320\257") << false;
+    QTest::newRow("overlong-3") << QByteArray("\340\237\277\320\257") << false;
+    QTest::newRow("surrogate") << QByteArray("\320\257\355\240\200") << false;
+    QTest::newRow("out-of-range") << QByteArray("\365\200\200\200") << false;
+}
+
+void tst_Utf8::longStrings()
+{
+    QFETCH(QByteArray, utf8);
+    QFETCH(bool, valid);
+
+    const QString piece = from8Bit(utf8);
+    for (int prefix = 0; prefix < 18; ++prefix) {
+        QByteArray encoded(prefix, 'a');
+        QString decoded(prefix, QLatin1Char('a'));
+        for (int i = 0; i < 20; ++i) {
+            encoded += utf8;
+            decoded += piece;
+        }
+
+        QCOMPARE(from8Bit(encoded), decoded);
+        if (valid)
+            QCOMPARE((decoded.*to8Bit)(), encoded);
+
+        QSharedPointer<QTextDecoder> decoder(codec->makeDecoder());
+        QString chunked;
+        for (int i = 0; i < encoded.size(); i += 37)
+            chunked += decoder->toUnicode(encoded.constData() + i, qMin(37, encoded.size() - i));
+        QCOMPARE(chunked, decoded);
+        QCOMPARE(decoder->hasFailure(), !valid);
+
+        if (valid) {
+            QSharedPointer<QTextEncoder> encoder(codec->makeEncoder(QTextCodec::IgnoreHeader));
+            QCOMPARE(encoder->fromUnicode(decoded), encoded);
+            QVERIFY(!encoder->hasFailure());
+        }
+    }
+}
+
 QTEST_MAIN(tst_Utf8)
 #include "tst_utf8.moc"
@@ -117,6 +117,8 @@ private Q_SLOTS:
     void compactObject();
 
     void validation();
+    void validationOnAccess();
+    void fromBinaryFile();
 
     void assignToDocument();
 
@@ -1327,19 +1329,17 @@ void tst_QtJson::toJsonLargeNumericValues()
             "    \"Array\": [\n"
             "        1.234567,\n"
             "        1.7976931348623157e+308,\n"
-            //     ((4.9406564584124654e-324 == 5e-324) == true)
-            // I can only think JavaScript has a special formatter to
-            //  emit this value for this IEEE754 bit pattern.
-            "        4.9406564584124654e-324,\n"
+            // numbers are written in the shortest form that reads back the same
+            "        5e-324,\n"
             "        2.2250738585072014e-308,\n"
             "        1.7976931348623157e+308,\n"
-            "        2.2204460492503131e-16,\n"
-            "        4.9406564584124654e-324,\n"
+            "        2.220446049250313e-16,\n"
+            "        5e-324,\n"
             "        0,\n"
             "        -2.2250738585072014e-308,\n"
             "        -1.7976931348623157e+308,\n"
-            "        -2.2204460492503131e-16,\n"
-            "        -4.9406564584124654e-324,\n"
+            "        -2.220446049250313e-16,\n"
+            "        -5e-324,\n"
             "        0,\n"
             "        9007199254740992,\n"
             "        -9007199254740992\n"
@@ -1993,6 +1993,86 @@ void tst_QtJson::validation()
     }
 }
 
+void tst_QtJson::validationOnAccess()
+{
+    QFile file(testDataDir + "/test3.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(!doc.isNull());
+
+    const QByteArray binary = doc.toBinaryData();
+    QJsonDocument lazy = QJsonDocument::fromBinaryData(binary, QJsonDocument::ValidateOnAccess);
+    QVERIFY(!lazy.isNull());
+    QCOMPARE(lazy, doc);
+    QCOMPARE(lazy.toJson(), doc.toJson());
+
+    for (int i = 0; i < binary.size(); ++i) {
+        for (int c = 0; c < 2; ++c) {
+            QByteArray corrupted = binary;
+            corrupted[i] = c ? char(0xff) : char(0x00);
+            QJsonDocument validated = QJsonDocument::fromBinaryData(corrupted);
+            QJsonDocument lazy = QJsonDocument::fromBinaryData(corrupted, QJsonDocument::ValidateOnAccess);
+            if (!validated.isNull()) {
+                QVERIFY(!lazy.isNull());
+                QCOMPARE(lazy.toJson(), validated.toJson());
+                continue;
+            }
+            if (lazy.isNull())
+                continue;
+            // must not crash, the invalid parts read as undefined values
+            lazy.toVariant();
+            QVERIFY(lazy.toJson().isEmpty());
+
+            // compacting copies the nested containers that were never
+            // accessed, corrupt ones have to be dropped instead
+            if (!lazy.isObject())
+                continue;
+            QJsonObject object = lazy.object();
+            lazy = QJsonDocument();
+            if (object.isEmpty())
+                continue;
+            object.remove(object.begin().key());
+            const QVariantMap expected = object.toVariantMap();
+            QJsonDocument compacted(object);
+            QCOMPARE(compacted.toVariant().toMap(), expected);
+        }
+    }
+}
+
+void tst_QtJson::fromBinaryFile()
+{
+    QFile file(testDataDir + "/test.bjson");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray binary = file.readAll();
+    const QJsonDocument expected = QJsonDocument::fromBinaryData(binary);
+    QVERIFY(!expected.isNull());
+
+    QTemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    tempFile.write(binary);
+    tempFile.close();
+
+    QJsonDocument doc = QJsonDocument::fromBinaryFile(tempFile.fileName());
+    QVERIFY(!doc.isNull());
+    QCOMPARE(doc, expected);
+
+    doc = QJsonDocument::fromBinaryFile(tempFile.fileName(), QJsonDocument::ValidateOnAccess);
+    QVERIFY(!doc.isNull());
+    QCOMPARE(doc.toVariant(), expected.toVariant());
+
+    // modifying the document must not write to the file
+    QJsonArray array = doc.array();
+    doc = QJsonDocument();
+    QVERIFY(!array.isEmpty());
+    array.removeFirst();
+    array.append(QStringLiteral("new"));
+    QVERIFY(tempFile.open());
+    QCOMPARE(tempFile.readAll(), binary);
+
+    QVERIFY(QJsonDocument::fromBinaryFile(testDataDir + "/test.json").isNull());
+    QVERIFY(QJsonDocument::fromBinaryFile(testDataDir + "/nonexistent.bjson").isNull());
+}
+
 void tst_QtJson::assignToDocument()
 {
     {
@@ -2,6 +2,7 @@ TEMPLATE=subdirs
 SUBDIRS=\
     qcoreapplication \
     qeventdispatcher \
+    qeventdispatcher_epoll \
     qeventloop \
     qmath \
     qmetaobject \
@@ -16,8 +17,11 @@ SUBDIRS=\
     qsignalblocker \
     qsignalmapper \
     qsocketnotifier \
+    qsocketnotifier_epoll \
     qsystemsemaphore \
     qtimer \
+    qtimer_epoll \
+    qtimerwheel \
     qtranslator \
     qvariant \
     qwineventnotifier
@@ -28,12 +32,22 @@ SUBDIRS=\
 !qtHaveModule(network): SUBDIRS -= \
     qeventloop \
     qobject \
-    qsocketnotifier
+    qsocketnotifier \
+    qsocketnotifier_epoll
 
 !contains(QT_CONFIG, private_tests): SUBDIRS -= \
     qsocketnotifier \
+    qsocketnotifier_epoll \
     qsharedmemory
 
+!contains(QT_CONFIG, epoll): SUBDIRS -= \
+    qeventdispatcher_epoll \
+    qsocketnotifier_epoll \
+    qtimer_epoll
+
+# QTimerWheel is part of the UNIX timer implementation
+!unix: SUBDIRS -= qtimerwheel
+
 # This test is only applicable on Windows
 !win32*|winrt: SUBDIRS -= qwineventnotifier
 
@@ -460,6 +460,120 @@ void tst_QCoreApplication::deliverInDefinedOrder()
     QObject::connect(&obj, SIGNAL(done()), &app, SLOT(quit()));
     app.exec();
 }
+
+class SequenceEvent : public QEvent
+{
+public:
+    SequenceEvent(int sender, int value)
+        : QEvent(QEvent::User), sender(sender), value(value)
+    { }
+    int sender;
+    int value;
+};
+
+class SequenceThread : public QThread
+{
+    Q_OBJECT
+public:
+    SequenceThread(QObject *receiver, int index, int count)
+        : receiver(receiver), index(index), count(count)
+    { }
+
+signals:
+    void sequence(int sender, int value);
+
+protected:
+    void run()
+    {
+        for (int i = 0; i < count; ++i) {
+            emit sequence(index, i);
+            QCoreApplication::postEvent(receiver, new SequenceEvent(index, i));
+        }
+    }
+
+private:
+    QObject *receiver;
+    int index;
+    int count;
+};
+
+class SequenceReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    SequenceReceiver(int senders)
+        : lastSignal(senders, -1), lastEvent(senders, -1), errors(0)
+    { }
+
+    QVector<int> lastSignal;
+    QVector<int> lastEvent;
+    int errors;
+
+    bool event(QEvent *e)
+    {
+        if (e->type() != QEvent::User)
+            return QObject::event(e);
+
+        // the event was posted after the signal with the same value
+        SequenceEvent *se = static_cast<SequenceEvent *>(e);
+        if (se->value != lastEvent.at(se->sender) + 1 || lastSignal.at(se->sender) != se->value)
+            ++errors;
+        lastEvent[se->sender] = se->value;
+        return true;
+    }
+
+public slots:
+    void sequence(int sender, int value)
+    {
+        if (value != lastSignal.at(sender) + 1)
+            ++errors;
+        lastSignal[sender] = value;
+    }
+};
+
+void tst_QCoreApplication::queuedSignalsFromManyThreads()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    const int threadCount = 8;
+    const int count = 2000;
+    SequenceReceiver receiver(threadCount);
+    QList<SequenceThread *> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        SequenceThread *thread = new SequenceThread(&receiver, i, count);
+        connect(thread, SIGNAL(sequence(int,int)), &receiver, SLOT(sequence(int,int)),
+                Qt::QueuedConnection);
+        threads << thread;
+        thread->start();
+    }
+
+    // deliver while the threads are still posting
+    foreach (SequenceThread *thread, threads) {
+        while (!thread->wait(1))
+            QCoreApplication::processEvents();
+    }
+    QCoreApplication::processEvents();
+
+    QCOMPARE(receiver.errors, 0);
+    for (int i = 0; i < threadCount; ++i) {
+        QCOMPARE(receiver.lastSignal.at(i), count - 1);
+        QCOMPARE(receiver.lastEvent.at(i), count - 1);
+    }
+
+    // queued signals that were never delivered are removed with the receiver
+    SequenceReceiver *doomed = new SequenceReceiver(1);
+    SequenceThread thread(doomed, 0, count);
+    connect(&thread, SIGNAL(sequence(int,int)), doomed, SLOT(sequence(int,int)),
+            Qt::QueuedConnection);
+    thread.start();
+    QVERIFY(thread.wait());
+    delete doomed;
+    QCoreApplication::processEvents();
+
+    qDeleteAll(threads);
+}
 #endif // QT_NO_QTHREAD
 
 void tst_QCoreApplication::applicationPid()
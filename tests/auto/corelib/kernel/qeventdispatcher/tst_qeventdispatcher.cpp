@@ -46,6 +46,15 @@
 #endif
 #include <QtTest/QtTest>
 
+#ifdef QT_TEST_EPOLL_DISPATCHER
+// qeventdispatcher_epoll builds this test again with QEventDispatcherEpoll.
+static void forceEpollDispatcher()
+{
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+}
+Q_CONSTRUCTOR_FUNCTION(forceEpollDispatcher)
+#endif
+
 enum {
     PreciseTimerInterval    =   10,
     CoarseTimerInterval     =  200,
@@ -73,6 +82,9 @@ public:
 
 private slots:
     void initTestCase();
+#ifdef QT_TEST_EPOLL_DISPATCHER
+    void epollDispatcher();
+#endif
     void registerTimer();
     /* void registerSocketNotifier(); */ // Not implemented here, see tst_QSocketNotifier instead
     /* void registerEventNotifiier(); */ // Not implemented here, see tst_QWinEventNotifier instead
@@ -105,6 +117,13 @@ void tst_QEventDispatcher::initTestCase()
     }
 }
 
+#ifdef QT_TEST_EPOLL_DISPATCHER
+void tst_QEventDispatcher::epollDispatcher()
+{
+    QVERIFY(QAbstractEventDispatcher::instance()->inherits("QEventDispatcherEpoll"));
+}
+#endif
+
 // test that the eventDispatcher's timer implementation is complete and working
 void tst_QEventDispatcher::registerTimer()
 {
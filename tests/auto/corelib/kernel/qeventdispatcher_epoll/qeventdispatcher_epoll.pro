@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = tst_qeventdispatcher_epoll
+QT = core testlib
+SOURCES += ../qeventdispatcher/tst_qeventdispatcher.cpp
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
+DEFINES += QT_TEST_EPOLL_DISPATCHER tst_QEventDispatcher=tst_QEventDispatcher_Epoll
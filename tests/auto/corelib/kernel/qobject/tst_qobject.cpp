@@ -155,6 +155,11 @@ private slots:
     void qmlConnect();
     void exceptions();
     void noDeclarativeParentChangedOnDestruction();
+    void concurrentEmission();
+    void concurrentConnectDisconnect();
+    void concurrentReceiverDeletion();
+    void concurrentSenderDeletion();
+    void concurrentEmissionFreesOrphans();
 };
 
 struct QObjectCreatedOnShutdown
@@ -6355,6 +6360,281 @@ void tst_QObject::noDeclarativeParentChangedOnDestruction()
 #endif
 }
 
+class ConcurrentSender : public QObject
+{
+    Q_OBJECT
+public:
+    void fire() { emit fired(); }
+signals:
+    void fired();
+    void fired1();
+    void fired2();
+    void fired3();
+    void fired4();
+    void fired5();
+};
+
+class ConcurrentCounter : public QObject
+{
+    Q_OBJECT
+public slots:
+    void count() { counter.ref(); }
+public:
+    QAtomicInt counter;
+};
+
+// Runs a function on a thread of its own
+class FunctionThread : public QThread
+{
+public:
+    typedef void (*Function)(void *);
+    FunctionThread(Function function, void *context)
+        : function(function), context(context)
+    { }
+    void run() { function(context); }
+
+private:
+    Function function;
+    void *context;
+};
+
+struct EmitterContext
+{
+    ConcurrentSender *sender;
+    int emissions;
+    QAtomicInt running;
+};
+
+static void emitRepeatedly(void *context)
+{
+    EmitterContext *c = static_cast<EmitterContext *>(context);
+    for (int i = 0; i < c->emissions; ++i)
+        c->sender->fire();
+    c->running.deref();
+}
+
+static QList<FunctionThread *> startThreads(int count, FunctionThread::Function function, void *context)
+{
+    QList<FunctionThread *> threads;
+    for (int i = 0; i < count; ++i) {
+        threads.append(new FunctionThread(function, context));
+        threads.last()->start();
+    }
+    return threads;
+}
+
+static bool joinThreads(QList<FunctionThread *> threads)
+{
+    bool ok = true;
+    foreach (FunctionThread *thread, threads)
+        ok = thread->wait(60000) && ok;
+    qDeleteAll(threads);
+    return ok;
+}
+
+enum { EmitterThreads = 4, Emissions = 20000 };
+
+void tst_QObject::concurrentEmission()
+{
+    ConcurrentSender sender;
+    ConcurrentCounter receiver;
+    for (int i = 0; i < 3; ++i)
+        connect(&sender, SIGNAL(fired()), &receiver, SLOT(count()), Qt::DirectConnection);
+
+    EmitterContext context;
+    context.sender = &sender;
+    context.emissions = Emissions;
+    context.running.store(EmitterThreads);
+    QVERIFY(joinThreads(startThreads(EmitterThreads, emitRepeatedly, &context)));
+
+    QCOMPARE(receiver.counter.load(), EmitterThreads * Emissions * 3);
+}
+
+// Emission while another thread connects and disconnects on the same sender,
+// both to the emitted signal and to the sender's other signals.
+void tst_QObject::concurrentConnectDisconnect()
+{
+    static const char * const signalNames[] = {
+        SIGNAL(fired1()), SIGNAL(fired2()), SIGNAL(fired3()),
+        SIGNAL(fired4()), SIGNAL(fired5())
+    };
+
+    for (int round = 0; round < 20; ++round) {
+        ConcurrentSender sender;
+        ConcurrentCounter permanent;
+        connect(&sender, SIGNAL(fired()), &permanent, SLOT(count()), Qt::DirectConnection);
+
+        EmitterContext context;
+        context.sender = &sender;
+        context.emissions = Emissions / 10;
+        context.running.store(EmitterThreads);
+        QList<FunctionThread *> threads = startThreads(EmitterThreads, emitRepeatedly, &context);
+
+        ConcurrentCounter transient[5];
+        int iteration = 0;
+        bool ok = true;
+        do {
+            const int n = iteration++ % 5;
+            const int signal = 4 - n;
+            ok = connect(&sender, signalNames[signal], &transient[n], SLOT(count()),
+                         Qt::DirectConnection) && ok;
+            ok = connect(&sender, SIGNAL(fired()), &transient[n], SLOT(count()),
+                         Qt::DirectConnection) && ok;
+            ok = sender.disconnect(&transient[n]) && ok;
+        } while (context.running.load());
+
+        // join before verifying: the emitters must not outlive the sender
+        QVERIFY(joinThreads(threads));
+        QVERIFY(ok);
+        QCOMPARE(permanent.counter.load(), EmitterThreads * Emissions / 10);
+        for (int n = 0; n < 5; ++n)
+            QVERIFY(transient[n].counter.load() <= EmitterThreads * Emissions / 10);
+    }
+}
+
+struct ReceiverDeletionContext
+{
+    ConcurrentSender *sender;
+    int receivers;
+};
+
+// The receivers live in the deleting thread, which runs no event loop, and
+// take queued connections: the emitting threads post events to receivers
+// that are being destroyed.
+static void createAndDeleteReceivers(void *context)
+{
+    ReceiverDeletionContext *c = static_cast<ReceiverDeletionContext *>(context);
+    for (int i = 0; i < c->receivers; ++i) {
+        ConcurrentCounter *receiver = new ConcurrentCounter;
+        QObject::connect(c->sender, SIGNAL(fired()), receiver, SLOT(count()), Qt::QueuedConnection);
+        QObject::connect(c->sender, SIGNAL(fired()), receiver, SLOT(count()), Qt::AutoConnection);
+        if (i % 2)
+            QCoreApplication::processEvents();
+        delete receiver;
+    }
+}
+
+void tst_QObject::concurrentReceiverDeletion()
+{
+    ConcurrentSender sender;
+    ConcurrentCounter permanent;
+    connect(&sender, SIGNAL(fired()), &permanent, SLOT(count()), Qt::DirectConnection);
+
+    EmitterContext context;
+    context.sender = &sender;
+    context.emissions = Emissions;
+    context.running.store(EmitterThreads);
+
+    ReceiverDeletionContext deletion;
+    deletion.sender = &sender;
+    deletion.receivers = 2000;
+
+    QList<FunctionThread *> threads = startThreads(EmitterThreads, emitRepeatedly, &context);
+    threads += startThreads(2, createAndDeleteReceivers, &deletion);
+    QVERIFY(joinThreads(threads));
+
+    QCOMPARE(permanent.counter.load(), EmitterThreads * Emissions);
+}
+
+struct SenderDeletionContext
+{
+    ConcurrentCounter *receiver;
+    int senders;
+    int emissions;
+};
+
+static void createEmitAndDeleteSenders(void *context)
+{
+    SenderDeletionContext *c = static_cast<SenderDeletionContext *>(context);
+    for (int i = 0; i < c->senders; ++i) {
+        ConcurrentSender *sender = new ConcurrentSender;
+        QObject::connect(sender, SIGNAL(fired()), c->receiver, SLOT(count()), Qt::DirectConnection);
+        for (int j = 0; j < c->emissions; ++j)
+            sender->fire();
+        delete sender;
+    }
+}
+
+// Senders connected to one receiver are destroyed on several threads at
+// once, each unlinking itself from the receiver's list of senders, while
+// the receiver's thread connects and disconnects senders of its own.
+void tst_QObject::concurrentSenderDeletion()
+{
+    ConcurrentCounter receiver;
+    SenderDeletionContext context;
+    context.receiver = &receiver;
+    context.senders = 2000;
+    context.emissions = 10;
+
+    QList<FunctionThread *> threads = startThreads(EmitterThreads, createEmitAndDeleteSenders, &context);
+    ConcurrentCounter local;
+    int iterations = 0;
+    bool running = true;
+    while (running) {
+        ConcurrentSender sender;
+        connect(&sender, SIGNAL(fired()), &receiver, SLOT(count()), Qt::DirectConnection);
+        connect(&sender, SIGNAL(fired()), &local, SLOT(count()), Qt::DirectConnection);
+        sender.fire();
+        QVERIFY(sender.disconnect(&receiver));
+        sender.fire();
+        ++iterations;
+        running = false;
+        foreach (FunctionThread *thread, threads)
+            running = running || thread->isRunning();
+    }
+    QVERIFY(joinThreads(threads));
+
+    QCOMPARE(local.counter.load(), 2 * iterations);
+    QCOMPARE(receiver.counter.load(), EmitterThreads * context.senders * context.emissions + iterations);
+}
+
+// Counts the functors still owned by connections
+struct CountedFunctor
+{
+    static QAtomicInt alive;
+    CountedFunctor() { alive.ref(); }
+    CountedFunctor(const CountedFunctor &) { alive.ref(); }
+    ~CountedFunctor() { alive.deref(); }
+    void operator()() const { }
+};
+QAtomicInt CountedFunctor::alive;
+
+struct StoppableEmitterContext
+{
+    ConcurrentSender *sender;
+    QAtomicInt stop;
+};
+
+static void emitUntilStopped(void *context)
+{
+    StoppableEmitterContext *c = static_cast<StoppableEmitterContext *>(context);
+    while (!c->stop.load())
+        c->sender->fire();
+}
+
+// Disconnected connections must be freed while emissions from several threads
+// keep overlapping, not only once no emission is in progress on the sender.
+void tst_QObject::concurrentEmissionFreesOrphans()
+{
+    ConcurrentSender sender;
+    ConcurrentCounter receiver;
+    connect(&sender, SIGNAL(fired()), &receiver, SLOT(count()), Qt::DirectConnection);
+
+    StoppableEmitterContext context;
+    context.sender = &sender;
+    context.stop.store(0);
+    QList<FunctionThread *> threads = startThreads(EmitterThreads, emitUntilStopped, &context);
+
+    for (int i = 0; i < 10000; ++i) {
+        QMetaObject::Connection connection = connect(&sender, &ConcurrentSender::fired, CountedFunctor());
+        QVERIFY(QObject::disconnect(connection));
+    }
+    QTRY_VERIFY_WITH_TIMEOUT(CountedFunctor::alive.load() == 0, 10000);
+
+    context.stop.store(1);
+    QVERIFY(joinThreads(threads));
+}
+
 // Test for QtPrivate::HasQ_OBJECT_Macro
 Q_STATIC_ASSERT(QtPrivate::HasQ_OBJECT_Macro<tst_QObject>::Value);
 Q_STATIC_ASSERT(!QtPrivate::HasQ_OBJECT_Macro<SiblingDeleter>::Value);
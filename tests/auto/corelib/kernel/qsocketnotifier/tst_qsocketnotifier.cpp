@@ -43,6 +43,7 @@
 #include <QtTest/QSignalSpy>
 #include <QtTest/QTestEventLoop>
 
+#include <QtCore/QAbstractEventDispatcher>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QTimer>
 #include <QtCore/QSocketNotifier>
@@ -65,10 +66,22 @@
 #  undef min
 #endif // Q_CC_MSVC
 
+#ifdef QT_TEST_EPOLL_DISPATCHER
+// qsocketnotifier_epoll builds this test again with QEventDispatcherEpoll.
+static void forceEpollDispatcher()
+{
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+}
+Q_CONSTRUCTOR_FUNCTION(forceEpollDispatcher)
+#endif
+
 class tst_QSocketNotifier : public QObject
 {
     Q_OBJECT
 private slots:
+#ifdef QT_TEST_EPOLL_DISPATCHER
+    void epollDispatcher();
+#endif
     void unexpectedDisconnection();
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
@@ -76,6 +89,13 @@ private slots:
 #endif
 };
 
+#ifdef QT_TEST_EPOLL_DISPATCHER
+void tst_QSocketNotifier::epollDispatcher()
+{
+    QVERIFY(QAbstractEventDispatcher::instance()->inherits("QEventDispatcherEpoll"));
+}
+#endif
+
 class UnexpectedDisconnectTester : public QObject
 {
     Q_OBJECT
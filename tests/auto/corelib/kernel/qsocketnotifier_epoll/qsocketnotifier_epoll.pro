@@ -0,0 +1,11 @@
+CONFIG += testcase
+CONFIG += parallel_test
+TARGET = tst_qsocketnotifier_epoll
+QT = core-private network-private testlib
+SOURCES = ../qsocketnotifier/tst_qsocketnotifier.cpp
+
+requires(contains(QT_CONFIG,private_tests))
+
+include(../../../network/socket/platformsocketengine/platformsocketengine.pri)
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
+DEFINES += QT_TEST_EPOLL_DISPATCHER tst_QSocketNotifier=tst_QSocketNotifier_Epoll
@@ -54,10 +54,22 @@
 #include <unistd.h>
 #endif
 
+#ifdef QT_TEST_EPOLL_DISPATCHER
+// qtimer_epoll builds this test again with QEventDispatcherEpoll.
+static void forceEpollDispatcher()
+{
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+}
+Q_CONSTRUCTOR_FUNCTION(forceEpollDispatcher)
+#endif
+
 class tst_QTimer : public QObject
 {
     Q_OBJECT
 private slots:
+#ifdef QT_TEST_EPOLL_DISPATCHER
+    void epollDispatcher();
+#endif
     void zeroTimer();
     void singleShotTimeout();
     void timeout();
@@ -82,6 +94,13 @@ private slots:
     void postedEventsShouldNotStarveTimers();
 };
 
+#ifdef QT_TEST_EPOLL_DISPATCHER
+void tst_QTimer::epollDispatcher()
+{
+    QVERIFY(QAbstractEventDispatcher::instance()->inherits("QEventDispatcherEpoll"));
+}
+#endif
+
 class TimerHelper : public QObject
 {
     Q_OBJECT
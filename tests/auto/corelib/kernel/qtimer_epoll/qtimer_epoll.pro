@@ -0,0 +1,6 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qtimer_epoll
+QT = core testlib
+SOURCES = ../qtimer/tst_qtimer.cpp
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
+DEFINES += QT_TEST_EPOLL_DISPATCHER tst_QTimer=tst_QTimer_Epoll
@@ -0,0 +1,5 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qtimerwheel
+QT = core-private testlib
+SOURCES = tst_qtimerwheel.cpp
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
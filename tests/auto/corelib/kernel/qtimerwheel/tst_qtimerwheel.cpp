@@ -0,0 +1,310 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <private/qtimerinfo_unix_p.h>
+
+typedef QPair<int, qint64> Firing; // timer id, tick it fired at
+
+static timespec toTimespec(qint64 ms)
+{
+    timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000 * 1000;
+    return ts;
+}
+
+static qint64 toMs(const timespec &ts)
+{
+    return qint64(ts.tv_sec) * 1000 + ts.tv_nsec / (1000 * 1000);
+}
+
+// Drives a QTimerWheel the way QTimerInfoList does, with a simulated clock
+class WheelDriver
+{
+public:
+    explicit WheelDriver(qint64 start)
+        : wheel(toTimespec(start)), now(start), wakeUps(0)
+    { }
+
+    QTimerInfo *add(int id, qint64 timeout)
+    {
+        return add(id, toTimespec(timeout));
+    }
+
+    QTimerInfo *add(int id, const timespec &timeout)
+    {
+        QTimerInfo *t = new QTimerInfo();
+        t->id = id;
+        t->timerType = Qt::CoarseTimer;
+        t->timeout = timeout;
+        wheel.insert(t);
+        return t;
+    }
+
+    void cancel(QTimerInfo *t)
+    {
+        wheel.remove(t);
+        delete t;
+    }
+
+    // Sleeps until the wheel's next wake-up as long as that is not after
+    // 'until', activating the expired timers at every wake-up.
+    void runUntil(qint64 until)
+    {
+        timespec tm;
+        while (wheel.nextTimeout(tm)) {
+            const qint64 next = toMs(tm);
+            if (next > until)
+                break;
+            now = qMax(now, next);
+            ++wakeUps;
+            activate();
+        }
+        now = qMax(now, until);
+        activate();
+    }
+
+    void activate()
+    {
+        wheel.advance(toTimespec(now));
+        wheel.beginActivation();
+        while (QTimerInfo *t = wheel.takeActivated())
+            fired.append(Firing(t->id, now));
+    }
+
+    QTimerWheel wheel;
+    qint64 now;
+    int wakeUps;
+    QList<Firing> fired;
+};
+
+// not aligned to any level of the wheel
+static const qint64 Start = Q_INT64_C(1400000000000) + 12345;
+
+class tst_QTimerWheel : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insertAndFire_data();
+    void insertAndFire();
+    void cascade();
+    void sameTickOrder();
+    void manyTimers();
+    void cancel();
+    void cancelExpired();
+    void roundsUp();
+};
+
+void tst_QTimerWheel::insertAndFire_data()
+{
+    QTest::addColumn<qint64>("delay");
+
+    QTest::newRow("next-tick") << qint64(1);
+    QTest::newRow("level0") << qint64(5);
+    QTest::newRow("level0-end") << qint64(63);
+    QTest::newRow("level1") << qint64(100);
+    QTest::newRow("level2") << qint64(5000);
+    QTest::newRow("level3") << qint64(300000);
+    QTest::newRow("level5") << Q_INT64_C(1073741831);
+    QTest::newRow("overflow") << Q_INT64_C(68719476739);
+}
+
+void tst_QTimerWheel::insertAndFire()
+{
+    QFETCH(qint64, delay);
+
+    WheelDriver driver(Start);
+    driver.add(1, Start + delay);
+
+    driver.runUntil(Start + delay - 1);
+    QVERIFY(driver.fired.isEmpty());
+
+    driver.runUntil(Start + delay);
+    QCOMPARE(driver.fired.size(), 1);
+    QCOMPARE(driver.fired.at(0), Firing(1, Start + delay));
+
+    // one wake-up per level the timer cascades through, plus the overflow
+    QVERIFY(driver.wakeUps <= QTimerWheel::LevelCount + 1);
+}
+
+void tst_QTimerWheel::cascade()
+{
+    WheelDriver driver(Start);
+    const qint64 timeout = Start + 5000;
+    driver.add(1, timeout);
+
+    // the first wake-up is at the start of the timer's slot, which only
+    // moves it down a level
+    timespec tm;
+    QVERIFY(driver.wheel.nextTimeout(tm));
+    qint64 previous = toMs(tm);
+    QVERIFY(previous > Start);
+    QVERIFY(previous < timeout);
+
+    int steps = 0;
+    while (driver.fired.isEmpty()) {
+        QVERIFY(driver.wheel.nextTimeout(tm));
+        const qint64 next = toMs(tm);
+        QVERIFY(next >= previous);
+        QVERIFY(next <= timeout);
+        previous = next;
+        driver.now = next;
+        driver.activate();
+        QVERIFY(++steps <= QTimerWheel::LevelCount);
+    }
+    QCOMPARE(driver.fired.at(0), Firing(1, timeout));
+    QVERIFY(steps > 1);
+}
+
+void tst_QTimerWheel::sameTickOrder()
+{
+    WheelDriver driver(Start);
+    driver.add(1, Start + 200);
+    driver.add(2, Start + 200);
+    driver.add(3, Start + 100);
+    driver.add(4, Start + 200);
+    driver.add(5, Start + 100);
+
+    driver.runUntil(Start + 1000);
+
+    QList<Firing> expected;
+    expected << Firing(3, Start + 100) << Firing(5, Start + 100)
+             << Firing(1, Start + 200) << Firing(2, Start + 200) << Firing(4, Start + 200);
+    QCOMPARE(driver.fired, expected);
+}
+
+void tst_QTimerWheel::manyTimers()
+{
+    WheelDriver driver(Start);
+    QHash<int, qint64> timeouts;
+    qsrand(42);
+    for (int id = 1; id <= 5000; ++id) {
+        // spread over the lowest four levels
+        const qint64 timeout = Start + 1 + (qint64(qrand()) * qrand()) % (1 << 24);
+        driver.add(id, timeout);
+        timeouts.insert(id, timeout);
+    }
+
+    driver.runUntil(Start + (1 << 24) + 1);
+
+    QCOMPARE(driver.fired.size(), timeouts.size());
+    QSet<int> seen;
+    for (int i = 0; i < driver.fired.size(); ++i) {
+        const Firing &f = driver.fired.at(i);
+        QCOMPARE(f.second, timeouts.value(f.first));
+        if (i)
+            QVERIFY(f.second >= driver.fired.at(i - 1).second);
+        seen.insert(f.first);
+    }
+    QCOMPARE(seen.size(), timeouts.size());
+}
+
+void tst_QTimerWheel::cancel()
+{
+    WheelDriver driver(Start);
+    const qint64 delays[] = { 3, 60, 70, 5000, 5001, 300000, Q_INT64_C(68719476739) };
+    const int count = sizeof(delays) / sizeof(delays[0]);
+    QVector<QTimerInfo *> timers;
+    for (int i = 0; i < count; ++i)
+        timers.append(driver.add(i + 1, Start + delays[i]));
+
+    // let the timers above level 0 cascade once before cancelling some
+    driver.runUntil(Start + 2);
+    QVERIFY(driver.fired.isEmpty());
+
+    QList<Firing> expected;
+    for (int i = 0; i < count; ++i) {
+        if (i % 2)
+            driver.cancel(timers.at(i));
+        else
+            expected << Firing(i + 1, Start + delays[i]);
+    }
+    QCOMPARE(driver.wheel.allTimers().size(), expected.size());
+    QVERIFY(!driver.wheel.find(2));
+
+    driver.runUntil(Start + delays[count - 1]);
+    QCOMPARE(driver.fired, expected);
+
+    // cancelling everything leaves nothing to wake up for
+    WheelDriver empty(Start);
+    QTimerInfo *t1 = empty.add(1, Start + 10);
+    QTimerInfo *t2 = empty.add(2, Start + 100000);
+    empty.cancel(t1);
+    empty.cancel(t2);
+    timespec tm;
+    QVERIFY(!empty.wheel.nextTimeout(tm));
+    QVERIFY(empty.wheel.isEmpty());
+}
+
+void tst_QTimerWheel::cancelExpired()
+{
+    WheelDriver driver(Start);
+    QTimerInfo *t1 = driver.add(1, Start + 10);
+    driver.add(2, Start + 10);
+
+    // expired, but not activated yet
+    driver.wheel.advance(toTimespec(Start + 20));
+    driver.cancel(t1);
+
+    driver.wheel.beginActivation();
+    QTimerInfo *t = driver.wheel.takeActivated();
+    QVERIFY(t);
+    QCOMPARE(t->id, 2);
+    QVERIFY(!driver.wheel.takeActivated());
+}
+
+void tst_QTimerWheel::roundsUp()
+{
+    WheelDriver driver(Start);
+    timespec timeout = toTimespec(Start + 50);
+    timeout.tv_nsec += 500 * 1000;
+    driver.add(1, timeout);
+
+    driver.runUntil(Start + 50);
+    QVERIFY(driver.fired.isEmpty());
+    driver.runUntil(Start + 51);
+    QCOMPARE(driver.fired, QList<Firing>() << Firing(1, Start + 51));
+}
+
+QTEST_APPLESS_MAIN(tst_QTimerWheel)
+#include "tst_qtimerwheel.moc"
@@ -100,6 +100,7 @@ private slots:
     void priorityStart();
     void waitForDone();
     void clear();
+    void workStealing();
     void waitForDoneTimeout();
     void destroyingWaitsForTasksToFinish();
     void stressTest();
@@ -963,6 +964,57 @@ void tst_QThreadPool::clear()
     QCOMPARE(count.load(), threadPool.maxThreadCount());
 }
 
+void tst_QThreadPool::workStealing()
+{
+    // every task starts two more until the given depth is reached
+    class SpawningRunnable : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        int depth;
+        SpawningRunnable(QThreadPool *pool, int depth) : pool(pool), depth(depth) {}
+        void run()
+        {
+            count.ref();
+            if (depth > 0) {
+                pool->start(new SpawningRunnable(pool, depth - 1));
+                pool->start(new SpawningRunnable(pool, depth - 1));
+            }
+        }
+    };
+
+    QThreadPool threadPool;
+    QVERIFY(!threadPool.workStealingEnabled());
+    threadPool.setMaxThreadCount(4);
+    threadPool.setWorkStealingEnabled(true);
+    QVERIFY(threadPool.workStealingEnabled());
+
+    for (int i = 0; i < 10; ++i) {
+        count.store(0);
+        threadPool.start(new SpawningRunnable(&threadPool, 12));
+        threadPool.waitForDone();
+        QCOMPARE(count.load(), (1 << 13) - 1);
+    }
+
+    // cannot be changed while running
+    QSemaphore sem(0);
+    class BlockingRunnable : public QRunnable
+    {
+    public:
+        QSemaphore &sem;
+        BlockingRunnable(QSemaphore &sem) : sem(sem) {}
+        void run() { sem.acquire(); }
+    };
+    threadPool.start(new BlockingRunnable(sem));
+    QTest::ignoreMessage(QtWarningMsg, "QThreadPool::setWorkStealingEnabled: cannot be changed while runnables are running");
+    threadPool.setWorkStealingEnabled(false);
+    QVERIFY(threadPool.workStealingEnabled());
+    sem.release();
+    threadPool.waitForDone();
+    threadPool.setWorkStealingEnabled(false);
+    QVERIFY(!threadPool.workStealingEnabled());
+}
+
 void tst_QThreadPool::destroyingWaitsForTasksToFinish()
 {
     QTime total, pass;
@@ -0,0 +1,606 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qflathash.h>
+#include <qhash.h>
+#include <qstring.h>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insert();
+    void operator_bracket();
+    void removeAndTake();
+    void erase();
+    void eraseWhileIterating();
+    void iterators();
+    void javaStyleIterators();
+    void implicitSharing();
+    void copyAndAssign();
+    void equality();
+    void keysAndValues();
+    void reserveAndSqueeze();
+    void largeIntKeys();
+    void stringKeys();
+    void collidingHashes();
+    void wrappingProbes();
+    void complexValues();
+    void unite();
+    void swap();
+    void initializerList();
+};
+
+struct Counted
+{
+    static int instances;
+
+    Counted(int v = 0) : value(v) { ++instances; }
+    Counted(const Counted &other) : value(other.value) { ++instances; }
+    ~Counted() { --instances; }
+    Counted &operator=(const Counted &other) { value = other.value; return *this; }
+    bool operator==(const Counted &other) const { return value == other.value; }
+
+    int value;
+};
+
+int Counted::instances = 0;
+
+QT_BEGIN_NAMESPACE
+// every key lands in the same bucket
+struct BadKey
+{
+    BadKey(int v = 0) : value(v) {}
+    bool operator==(const BadKey &other) const { return value == other.value; }
+    int value;
+};
+
+inline uint qHash(const BadKey &, uint seed = 0)
+{
+    return 42 ^ seed;
+}
+
+// every key lands in the last bucket, whatever the table size
+struct LastBucketKey
+{
+    LastBucketKey(int v = 0) : value(v) {}
+    bool operator==(const LastBucketKey &other) const { return value == other.value; }
+    int value;
+};
+
+inline uint qHash(const LastBucketKey &, uint = 0)
+{
+    // the inverse of the multiplier QFlatHashData::bucket() applies
+    return 0xebb34377U;
+}
+QT_END_NAMESPACE
+
+void tst_QFlatHash::insert()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.size(), 0);
+    QVERIFY(!hash.contains(1));
+    QCOMPARE(hash.value(1), 0);
+    QCOMPARE(hash.value(1, -1), -1);
+    QVERIFY(hash.find(1) == hash.end());
+
+    QFlatHash<int, int>::iterator it = hash.insert(1, 10);
+    QCOMPARE(it.key(), 1);
+    QCOMPARE(it.value(), 10);
+    QCOMPARE(hash.size(), 1);
+    QVERIFY(hash.contains(1));
+    QCOMPARE(hash.value(1), 10);
+    QCOMPARE(hash.count(1), 1);
+    QCOMPARE(hash.count(2), 0);
+
+    // inserting an existing key replaces the value
+    hash.insert(1, 11);
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(hash.value(1), 11);
+
+    hash.insert(2, 20);
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.constFind(2).value(), 20);
+    QCOMPARE(*hash.find(2), 20);
+}
+
+void tst_QFlatHash::operator_bracket()
+{
+    QFlatHash<QString, int> hash;
+    hash["one"] = 1;
+    ++hash["one"];
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(hash.value("one"), 2);
+
+    // a missing key inserts a default-constructed value
+    QCOMPARE(hash["two"], 0);
+    QCOMPARE(hash.size(), 2);
+
+    const QFlatHash<QString, int> &constHash = hash;
+    QCOMPARE(constHash["one"], 2);
+    QCOMPARE(constHash["three"], 0);
+    QCOMPARE(hash.size(), 2);
+}
+
+void tst_QFlatHash::removeAndTake()
+{
+    QFlatHash<int, QString> hash;
+    QCOMPARE(hash.remove(1), 0);
+    QCOMPARE(hash.take(1), QString());
+
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, QString::number(i));
+
+    QCOMPARE(hash.remove(1000), 0);
+    QCOMPARE(hash.remove(10), 1);
+    QCOMPARE(hash.remove(10), 0);
+    QCOMPARE(hash.take(20), QString("20"));
+    QCOMPARE(hash.take(20), QString());
+    QCOMPARE(hash.size(), 98);
+
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(hash.contains(i), i != 10 && i != 20);
+        if (i != 10 && i != 20)
+            QCOMPARE(hash.value(i), QString::number(i));
+    }
+
+    for (int i = 0; i < 100; ++i)
+        hash.remove(i);
+    QVERIFY(hash.isEmpty());
+    QVERIFY(hash.begin() == hash.end());
+}
+
+void tst_QFlatHash::erase()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 10; ++i)
+        hash.insert(i, i * 10);
+
+    QFlatHash<int, int>::iterator it = hash.find(5);
+    it = hash.erase(it);
+    QCOMPARE(hash.size(), 9);
+    QVERIFY(!hash.contains(5));
+
+    // erasing through an iterator of a hash that got shared detaches it
+    QFlatHash<int, int> copy = hash;
+    it = hash.find(6);
+    copy = hash;
+    hash.erase(it);
+    QCOMPARE(hash.size(), 8);
+    QCOMPARE(copy.size(), 9);
+    QVERIFY(!hash.contains(6));
+    QVERIFY(copy.contains(6));
+
+    QVERIFY(hash.erase(hash.end()) == hash.end());
+}
+
+void tst_QFlatHash::eraseWhileIterating()
+{
+    // keys spaced so that they share buckets, to exercise the shifting
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 5000; ++i)
+        hash.insert(i << 12, i);
+
+    int visited = 0;
+    QFlatHash<int, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        ++visited;
+        if (it.value() % 3)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(visited, 5000);
+    QCOMPARE(hash.size(), 1667);
+    for (int i = 0; i < 5000; ++i)
+        QCOMPARE(hash.contains(i << 12), i % 3 == 0);
+}
+
+void tst_QFlatHash::iterators()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.constBegin() == hash.constEnd());
+    QVERIFY(hash.cbegin() == hash.cend());
+
+    int sum = 0;
+    for (int i = 1; i <= 100; ++i) {
+        hash.insert(i, i);
+        sum += i;
+    }
+
+    int forward = 0;
+    int count = 0;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        QCOMPARE(it.key(), it.value());
+        forward += *it;
+        ++count;
+    }
+    QCOMPARE(count, 100);
+    QCOMPARE(forward, sum);
+
+    int backward = 0;
+    QFlatHash<int, int>::const_iterator it = hash.constEnd();
+    while (it != hash.constBegin()) {
+        --it;
+        backward += it.value();
+    }
+    QCOMPARE(backward, sum);
+
+    for (QFlatHash<int, int>::iterator it = hash.begin(); it != hash.end(); ++it)
+        it.value() *= 2;
+    QCOMPARE(hash.value(50), 100);
+
+    QFlatHash<int, int>::const_iterator first = hash.constBegin();
+    QVERIFY((first + 3) - 3 == first);
+    QFlatHash<int, int>::const_iterator converted = hash.begin();
+    QVERIFY(converted == hash.constBegin());
+}
+
+void tst_QFlatHash::javaStyleIterators()
+{
+    QFlatHash<int, QString> hash;
+    for (int i = 0; i < 10; ++i)
+        hash.insert(i, QString::number(i));
+
+    int count = 0;
+    QFlatHashIterator<int, QString> it(hash);
+    while (it.hasNext()) {
+        it.next();
+        QCOMPARE(it.value(), QString::number(it.key()));
+        ++count;
+    }
+    QCOMPARE(count, 10);
+
+    QMutableFlatHashIterator<int, QString> mit(hash);
+    while (mit.hasNext()) {
+        mit.next();
+        if (mit.key() % 2)
+            mit.remove();
+        else
+            mit.setValue(mit.value() + QLatin1Char('!'));
+    }
+    QCOMPARE(hash.size(), 5);
+    QCOMPARE(hash.value(4), QString("4!"));
+    QVERIFY(!hash.contains(5));
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, int> hash;
+    hash.insert(1, 1);
+    QVERIFY(hash.isDetached());
+
+    QFlatHash<int, int> copy = hash;
+    QVERIFY(copy.isSharedWith(hash));
+    QVERIFY(!hash.isDetached());
+
+    copy.insert(2, 2);
+    QVERIFY(!copy.isSharedWith(hash));
+    QVERIFY(hash.isDetached());
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(copy.size(), 2);
+
+    copy = hash;
+    copy[1] = 10;
+    QCOMPARE(hash.value(1), 1);
+    QCOMPARE(copy.value(1), 10);
+
+    // const access does not detach
+    copy = hash;
+    (void)copy.value(1);
+    (void)copy.constBegin();
+    QVERIFY(copy.isSharedWith(hash));
+
+    // removing a key that is not there does not detach
+    copy.remove(1000);
+    QVERIFY(copy.isSharedWith(hash));
+}
+
+void tst_QFlatHash::copyAndAssign()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, "one");
+    {
+        QFlatHash<int, QString> copy(hash);
+        QCOMPARE(copy.value(1), QString("one"));
+        copy = QFlatHash<int, QString>();
+        QVERIFY(copy.isEmpty());
+    }
+    QCOMPARE(hash.value(1), QString("one"));
+
+#ifdef Q_COMPILER_RVALUE_REFS
+    QFlatHash<int, QString> moved(qMove(hash));
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(moved.value(1), QString("one"));
+    hash = qMove(moved);
+    QCOMPARE(hash.value(1), QString("one"));
+#endif
+
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::equality()
+{
+    QFlatHash<int, int> a;
+    QFlatHash<int, int> b;
+    QVERIFY(a == b);
+
+    for (int i = 0; i < 100; ++i)
+        a.insert(i, i);
+    for (int i = 99; i >= 0; --i)
+        b.insert(i, i);
+    QVERIFY(a == b);
+
+    b[50] = -1;
+    QVERIFY(a != b);
+    b.remove(50);
+    QVERIFY(a != b);
+}
+
+void tst_QFlatHash::keysAndValues()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 10; ++i)
+        hash.insert(i, i % 3);
+
+    QList<int> keys = hash.keys();
+    std::sort(keys.begin(), keys.end());
+    QCOMPARE(keys, QList<int>() << 0 << 1 << 2 << 3 << 4 << 5 << 6 << 7 << 8 << 9);
+
+    QList<int> keysForOne = hash.keys(1);
+    std::sort(keysForOne.begin(), keysForOne.end());
+    QCOMPARE(keysForOne, QList<int>() << 1 << 4 << 7);
+
+    QList<int> values = hash.values();
+    QCOMPARE(values.size(), 10);
+    QCOMPARE(values.count(0), 4);
+
+    QCOMPARE(hash.key(2) % 3, 2);
+    QCOMPARE(hash.key(5, -1), -1);
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    QCOMPARE(hash.capacity(), 0);
+
+    hash.reserve(1000);
+    const int capacity = hash.capacity();
+    QVERIFY(capacity >= 1000);
+
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QVERIFY(hash.capacity() >= 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i), i);
+
+    hash.clear();
+    hash.squeeze();
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::largeIntKeys()
+{
+    QFlatHash<int, int> hash;
+    const int count = 200000;
+    for (int i = 0; i < count; ++i)
+        hash.insert(i * 7919, i);
+    QCOMPARE(hash.size(), count);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(hash.value(i * 7919, -1), i);
+    QVERIFY(!hash.contains(1));
+
+    QFlatHash<quint64, int> wide;
+    for (int i = 0; i < 1000; ++i)
+        wide.insert(quint64(i) << 32, i);
+    QCOMPARE(wide.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(wide.value(quint64(i) << 32, -1), i);
+}
+
+void tst_QFlatHash::stringKeys()
+{
+    QFlatHash<QString, int> hash;
+    QHash<QString, int> reference;
+    for (int i = 0; i < 5000; ++i) {
+        const QString key = QString::number(i * 31, 16);
+        hash.insert(key, i);
+        reference.insert(key, i);
+    }
+    QCOMPARE(hash.size(), reference.size());
+    QHash<QString, int>::const_iterator it = reference.constBegin();
+    for (; it != reference.constEnd(); ++it)
+        QCOMPARE(hash.value(it.key(), -1), it.value());
+
+    QFlatHash<QString, int> empty;
+    QVERIFY(!empty.contains(QString()));
+    empty.insert(QString(), 1);
+    QCOMPARE(empty.value(QString()), 1);
+}
+
+void tst_QFlatHash::collidingHashes()
+{
+    QFlatHash<BadKey, int> hash;
+    for (int i = 0; i < 200; ++i)
+        hash.insert(BadKey(i), i);
+    QCOMPARE(hash.size(), 200);
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.value(BadKey(i), -1), i);
+
+    // collisions alone never grow the table
+    QFlatHash<int, int> reference;
+    for (int i = 0; i < 200; ++i)
+        reference.insert(i, i);
+    QCOMPARE(hash.capacity(), reference.capacity());
+
+    for (int i = 0; i < 200; i += 2)
+        QCOMPARE(hash.remove(BadKey(i)), 1);
+    QCOMPARE(hash.size(), 100);
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.contains(BadKey(i)), i % 2 == 1);
+}
+
+void tst_QFlatHash::wrappingProbes()
+{
+    // the probes run past the end of the table and wrap around
+    QFlatHash<LastBucketKey, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(LastBucketKey(i), i);
+    QCOMPARE(hash.size(), 1000);
+    QVERIFY(hash.capacity() < 2000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(LastBucketKey(i), -1), i);
+
+    int visited = 0;
+    QFlatHash<LastBucketKey, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        ++visited;
+        if (it.value() % 3)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(visited, 1000);
+    QCOMPARE(hash.size(), 334);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.contains(LastBucketKey(i)), i % 3 == 0);
+
+    visited = 0;
+    for (QFlatHash<LastBucketKey, int>::const_iterator it = hash.constEnd(); it != hash.constBegin(); ) {
+        --it;
+        ++visited;
+    }
+    QCOMPARE(visited, 334);
+
+    for (int i = 0; i < 1000; i += 3)
+        QCOMPARE(hash.take(LastBucketKey(i)), i);
+    QVERIFY(hash.isEmpty());
+    QVERIFY(hash.begin() == hash.end());
+}
+
+void tst_QFlatHash::complexValues()
+{
+    QCOMPARE(Counted::instances, 0);
+    {
+        QFlatHash<int, Counted> hash;
+        for (int i = 0; i < 1000; ++i)
+            hash.insert(i, Counted(i));
+        QCOMPARE(Counted::instances, 1000);
+
+        QFlatHash<int, Counted> copy = hash;
+        copy.insert(5000, Counted(5000));
+        QCOMPARE(Counted::instances, 2001);
+
+        for (int i = 0; i < 1000; i += 2)
+            hash.remove(i);
+        QCOMPARE(Counted::instances, 1501);
+        for (int i = 1; i < 1000; i += 2)
+            QCOMPARE(hash.value(i).value, i);
+
+        hash.squeeze();
+        QCOMPARE(Counted::instances, 1501);
+    }
+    QCOMPARE(Counted::instances, 0);
+}
+
+void tst_QFlatHash::unite()
+{
+    QFlatHash<int, int> a;
+    a.insert(1, 1);
+    a.insert(2, 2);
+    QFlatHash<int, int> b;
+    b.insert(2, 20);
+    b.insert(3, 30);
+
+    a.unite(b);
+    QCOMPARE(a.size(), 3);
+    QCOMPARE(a.value(1), 1);
+    QCOMPARE(a.value(2), 20);
+    QCOMPARE(a.value(3), 30);
+
+    a.unite(a);
+    QCOMPARE(a.size(), 3);
+
+    QFlatHash<int, int> empty;
+    empty.unite(b);
+    QVERIFY(empty.isSharedWith(b));
+}
+
+void tst_QFlatHash::swap()
+{
+    QFlatHash<int, QString> a;
+    QFlatHash<int, QString> b;
+    a.insert(1, "one");
+    b.insert(2, "two");
+    a.swap(b);
+    QCOMPARE(a.value(2), QString("two"));
+    QCOMPARE(b.value(1), QString("one"));
+    QVERIFY(!a.contains(1));
+}
+
+void tst_QFlatHash::initializerList()
+{
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    QFlatHash<int, QString> hash = {{1, "hello"}, {2, "initializer_list"}};
+    QCOMPARE(hash.count(), 2);
+    QCOMPARE(hash[1], QString("hello"));
+    QCOMPARE(hash[2], QString("initializer_list"));
+
+    QFlatHash<int, int> emptyHash{};
+    QVERIFY(emptyHash.isEmpty());
+#else
+    QSKIP("Compiler doesn't support initializer lists");
+#endif
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
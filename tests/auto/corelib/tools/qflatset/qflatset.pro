@@ -0,0 +1,5 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qflatset
+QT = core testlib
+SOURCES = tst_qflatset.cpp
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,215 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qflatset.h>
+#include <qstring.h>
+
+class tst_QFlatSet : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insertAndRemove();
+    void contains();
+    void iterators();
+    void javaStyleIterators();
+    void setOperations();
+    void implicitSharing();
+    void toListAndFromList();
+    void initializerList();
+};
+
+void tst_QFlatSet::insertAndRemove()
+{
+    QFlatSet<int> set;
+    QVERIFY(set.isEmpty());
+    set.insert(1);
+    set.insert(1);
+    set << 2 << 3;
+    QCOMPARE(set.size(), 3);
+    QVERIFY(set.remove(2));
+    QVERIFY(!set.remove(2));
+    QCOMPARE(set.size(), 2);
+
+    for (int i = 0; i < 10000; ++i)
+        set.insert(i);
+    QCOMPARE(set.size(), 10000);
+    for (int i = 0; i < 10000; i += 2)
+        set.remove(i);
+    QCOMPARE(set.size(), 5000);
+    for (int i = 0; i < 10000; ++i)
+        QCOMPARE(set.contains(i), i % 2 == 1);
+
+    set.clear();
+    QVERIFY(set.isEmpty());
+}
+
+void tst_QFlatSet::contains()
+{
+    QFlatSet<QString> set;
+    set << "a" << "b" << "c";
+    QVERIFY(set.contains("a"));
+    QVERIFY(!set.contains("d"));
+
+    QFlatSet<QString> subset;
+    subset << "a" << "c";
+    QVERIFY(set.contains(subset));
+    subset << "d";
+    QVERIFY(!set.contains(subset));
+    QVERIFY(set.contains(QFlatSet<QString>()));
+}
+
+void tst_QFlatSet::iterators()
+{
+    QFlatSet<int> set;
+    for (int i = 0; i < 100; ++i)
+        set.insert(i);
+
+    int sum = 0;
+    for (QFlatSet<int>::const_iterator it = set.constBegin(); it != set.constEnd(); ++it)
+        sum += *it;
+    QCOMPARE(sum, 4950);
+
+    QFlatSet<int>::iterator it = set.begin();
+    while (it != set.end()) {
+        if (*it % 2)
+            it = set.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(set.size(), 50);
+    QVERIFY(set.find(3) == set.end());
+    QCOMPARE(*set.constFind(4), 4);
+}
+
+void tst_QFlatSet::javaStyleIterators()
+{
+    QFlatSet<int> set;
+    for (int i = 0; i < 10; ++i)
+        set.insert(i);
+
+    int count = 0;
+    QFlatSetIterator<int> it(set);
+    while (it.hasNext()) {
+        it.next();
+        ++count;
+    }
+    QCOMPARE(count, 10);
+
+    QMutableFlatSetIterator<int> mit(set);
+    while (mit.hasNext()) {
+        if (mit.next() >= 5)
+            mit.remove();
+    }
+    QCOMPARE(set.size(), 5);
+    QVERIFY(!set.contains(7));
+}
+
+void tst_QFlatSet::setOperations()
+{
+    QFlatSet<int> a;
+    QFlatSet<int> b;
+    a << 1 << 2 << 3;
+    b << 2 << 3 << 4;
+
+    QFlatSet<int> expected;
+    expected << 1 << 2 << 3 << 4;
+    QCOMPARE(a | b, expected);
+
+    expected.clear();
+    expected << 2 << 3;
+    QCOMPARE(a & b, expected);
+
+    expected.clear();
+    expected << 1;
+    QCOMPARE(a - b, expected);
+
+    QFlatSet<int> c = a;
+    c -= c;
+    QVERIFY(c.isEmpty());
+    c = a;
+    c &= c;
+    QCOMPARE(c, a);
+    c &= 2;
+    QCOMPARE(c.size(), 1);
+    QVERIFY(c.contains(2));
+}
+
+void tst_QFlatSet::implicitSharing()
+{
+    QFlatSet<int> a;
+    a << 1 << 2;
+    QFlatSet<int> b = a;
+    QVERIFY(!a.isDetached());
+    b.insert(3);
+    QVERIFY(a.isDetached());
+    QCOMPARE(a.size(), 2);
+    QCOMPARE(b.size(), 3);
+}
+
+void tst_QFlatSet::toListAndFromList()
+{
+    QList<int> list;
+    list << 3 << 1 << 2 << 1;
+    QFlatSet<int> set = QFlatSet<int>::fromList(list);
+    QCOMPARE(set.size(), 3);
+
+    QList<int> values = set.toList();
+    std::sort(values.begin(), values.end());
+    QCOMPARE(values, QList<int>() << 1 << 2 << 3);
+    QCOMPARE(set.values().size(), 3);
+}
+
+void tst_QFlatSet::initializerList()
+{
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    QFlatSet<int> set = {1, 1, 2, 3, 4, 5};
+    QCOMPARE(set.count(), 5);
+    QVERIFY(set.contains(1));
+    QVERIFY(set.contains(5));
+#else
+    QSKIP("Compiler doesn't support initializer lists");
+#endif
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatSet)
+#include "tst_qflatset.moc"
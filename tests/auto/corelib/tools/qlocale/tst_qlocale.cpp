@@ -50,6 +50,7 @@
 #include <qdatetime.h>
 #include <qprocess.h>
 #include <float.h>
+#include <limits>
 
 #include <qlocale.h>
 #include <qnumeric.h>
@@ -155,6 +156,9 @@ private slots:
     void testInfAndNan();
     void fpExceptions();
     void negativeZero();
+    void doubleToStringShortest_data();
+    void doubleToStringShortest();
+    void doubleRoundTrip();
     void dayOfWeek();
     void dayOfWeek_data();
     void formatDate();
@@ -988,6 +992,89 @@ void tst_QLocale::negativeZero()
     QCOMPARE(s, QString("0"));
 }
 
+void tst_QLocale::doubleToStringShortest_data()
+{
+    QTest::addColumn<double>("num");
+    QTest::addColumn<char>("format");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("0 g") << 0.0 << 'g' << QString("0");
+    QTest::newRow("0 e") << 0.0 << 'e' << QString("0e+00");
+    QTest::newRow("0 f") << 0.0 << 'f' << QString("0");
+    QTest::newRow("0.1 g") << 0.1 << 'g' << QString("0.1");
+    QTest::newRow("0.1 e") << 0.1 << 'e' << QString("1e-01");
+    QTest::newRow("0.1 f") << 0.1 << 'f' << QString("0.1");
+    QTest::newRow("-1.5 g") << -1.5 << 'g' << QString("-1.5");
+    QTest::newRow("0.3 g") << 0.3 << 'g' << QString("0.3");
+    QTest::newRow("1/3 g") << 1.0 / 3 << 'g' << QString("0.3333333333333333");
+    QTest::newRow("2/3 g") << 2.0 / 3 << 'g' << QString("0.6666666666666666");
+    QTest::newRow("2/3 E") << 2.0 / 3 << 'E' << QString("6.666666666666666E-01");
+    QTest::newRow("1.234567 g") << 1.234567 << 'g' << QString("1.234567");
+    QTest::newRow("12.5 f") << 12.5 << 'f' << QString("12.5");
+    QTest::newRow("1000 g") << 1000.0 << 'g' << QString("1000");
+    QTest::newRow("1000 e") << 1000.0 << 'e' << QString("1e+03");
+    QTest::newRow("1000 f") << 1000.0 << 'f' << QString("1000");
+    QTest::newRow("0.0001 g") << 0.0001 << 'g' << QString("0.0001");
+    QTest::newRow("0.00001 g") << 0.00001 << 'g' << QString("1e-05");
+    QTest::newRow("1e16 g") << 1e16 << 'g' << QString("10000000000000000");
+    QTest::newRow("1e17 g") << 1e17 << 'g' << QString("1e+17");
+    QTest::newRow("1e23 g") << 1e23 << 'g' << QString("1e+23");
+    QTest::newRow("2^53 g") << 9007199254740992.0 << 'g' << QString("9007199254740992");
+    QTest::newRow("1.2345678901234568e17 g") << 123456789012345678.0 << 'g'
+                                             << QString("1.2345678901234568e+17");
+    QTest::newRow("DBL_MAX g") << DBL_MAX << 'g' << QString("1.7976931348623157e+308");
+    QTest::newRow("DBL_MIN g") << DBL_MIN << 'g' << QString("2.2250738585072014e-308");
+    QTest::newRow("DBL_EPSILON g") << DBL_EPSILON << 'g' << QString("2.220446049250313e-16");
+    QTest::newRow("denorm_min g") << std::numeric_limits<double>::denorm_min() << 'g'
+                                  << QString("5e-324");
+    QTest::newRow("inf g") << qInf() << 'g' << QString("inf");
+}
+
+void tst_QLocale::doubleToStringShortest()
+{
+    QFETCH(double, num);
+    QFETCH(char, format);
+    QFETCH(QString, expected);
+
+    QLocale locale = QLocale::c();
+    locale.setNumberOptions(QLocale::OmitGroupSeparator);
+    QCOMPARE(QString::number(num, format, QLocale::FloatingPointShortest), expected);
+    QCOMPARE(locale.toString(num, format, QLocale::FloatingPointShortest), expected);
+    QCOMPARE(QByteArray::number(num, format, QLocale::FloatingPointShortest), expected.toLatin1());
+}
+
+void tst_QLocale::doubleRoundTrip()
+{
+    // Run a fixed pseudo-random sequence of bit patterns through the fast
+    // paths and the exact fallbacks of both conversions
+    quint64 state = Q_UINT64_C(88172645463325252);
+    for (int i = 0; i < 100000; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        double d;
+        memcpy(&d, &state, sizeof(d));
+        if (!qIsFinite(d))
+            continue;
+
+        bool ok;
+        const QString shortest = QString::number(d, 'e', QLocale::FloatingPointShortest);
+        QCOMPARE(shortest.toDouble(&ok), d);
+        QVERIFY(ok);
+
+        // one digit less must not be enough
+        const int digits = shortest.indexOf(QLatin1Char('e')) - (shortest.contains('.') ? 1 : 0)
+                           - (d < 0 ? 1 : 0);
+        if (digits > 1)
+            QVERIFY(QString::number(d, 'e', digits - 2).toDouble() != d);
+
+        QCOMPARE(QByteArray::number(d, 'g', 17).toDouble(&ok), d);
+        QVERIFY(ok);
+        QCOMPARE(QString::number(d, 'e', 24).toDouble(&ok), d);
+        QVERIFY(ok);
+    }
+}
+
 void tst_QLocale::dayOfWeek_data()
 {
     QTest::addColumn<QDate>("date");
@@ -0,0 +1,380 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qsmallstring.h>
+#include <qflathash.h>
+#include <qhash.h>
+#include <qmap.h>
+
+class tst_QSmallString : public QObject
+{
+    Q_OBJECT
+private slots:
+    void storageSize();
+    void construct_data();
+    void construct();
+    void fromLatin1();
+    void copyAndAssign();
+    void implicitSharing();
+    void compare_data();
+    void compare();
+    void hash();
+    void containerKeys();
+    void byteArray_data();
+    void byteArray();
+    void byteArrayCompare();
+    void byteArrayHash();
+};
+
+void tst_QSmallString::storageSize()
+{
+    QCOMPARE(sizeof(QSmallString), size_t(24));
+    QCOMPARE(sizeof(QSmallByteArray), size_t(24));
+    QCOMPARE(int(QSmallString::InlineCapacity), 11);
+    QCOMPARE(int(QSmallByteArray::InlineCapacity), 23);
+}
+
+void tst_QSmallString::construct_data()
+{
+    QTest::addColumn<QString>("str");
+    QTest::addColumn<bool>("isInline");
+
+    QTest::newRow("null") << QString() << true;
+    QTest::newRow("empty") << QString("") << true;
+    QTest::newRow("one") << QString("a") << true;
+    QTest::newRow("ten") << QString("0123456789") << true;
+    QTest::newRow("eleven") << QString("0123456789a") << true;
+    QTest::newRow("twelve") << QString("0123456789ab") << false;
+    QTest::newRow("long") << QString(100, QLatin1Char('x')) << false;
+    QTest::newRow("non-latin1") << QString::fromUtf8("\xd0\x9c\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2\xd0\xb0") << true;
+    QTest::newRow("embedded-nul") << QString::fromLatin1("a\0b", 3) << true;
+    QTest::newRow("all-ones") << QString(11, QChar(0xffff)) << true;
+}
+
+void tst_QSmallString::construct()
+{
+    QFETCH(QString, str);
+    QFETCH(bool, isInline);
+
+    QSmallString s(str);
+    QCOMPARE(s.size(), str.size());
+    QCOMPARE(s.length(), str.size());
+    QCOMPARE(s.isEmpty(), str.isEmpty());
+    QCOMPARE(s.isInline(), isInline);
+    QCOMPARE(s.toString(), str);
+    QVERIFY(s == str);
+    QVERIFY(str == s);
+    QVERIFY(!(s != str));
+    QCOMPARE(s.unicode()[s.size()], QChar());
+    for (int i = 0; i < str.size(); ++i) {
+        QCOMPARE(s.at(i), str.at(i));
+        QCOMPARE(s[i], str.at(i));
+    }
+    QCOMPARE(int(s.end() - s.begin()), str.size());
+    QVERIFY(std::equal(s.begin(), s.end(), str.constBegin()));
+
+    QSmallString fromData(str.constData(), str.size());
+    QCOMPARE(fromData.isInline(), isInline);
+    QVERIFY(fromData == s);
+
+    QSmallString assigned;
+    assigned = str;
+    QVERIFY(assigned == s);
+
+    s.clear();
+    QVERIFY(s.isEmpty());
+    QVERIFY(s.isInline());
+    QCOMPARE(s.unicode()[0], QChar());
+}
+
+void tst_QSmallString::fromLatin1()
+{
+    QSmallString s(QLatin1String("abc\xe9"));
+    QVERIFY(s.isInline());
+    QCOMPARE(s.toString(), QString::fromLatin1("abc\xe9"));
+    QVERIFY(s == QLatin1String("abc\xe9"));
+    QVERIFY(QLatin1String("abc\xe9") == s);
+    QVERIFY(s != QLatin1String("abc"));
+    QVERIFY(s != QLatin1String("abce"));
+
+    const char longText[] = "a latin-1 string too long to be inline";
+    QSmallString l((QLatin1String(longText)));
+    QVERIFY(!l.isInline());
+    QCOMPARE(l.toString(), QString::fromLatin1(longText));
+    QVERIFY(l == QLatin1String(longText));
+}
+
+void tst_QSmallString::copyAndAssign()
+{
+    const QString shortText("short");
+    const QString longText("a string that does not fit inline");
+
+    QSmallString a(shortText);
+    QSmallString b(longText);
+
+    QSmallString c(a);
+    QVERIFY(c == shortText);
+    c = b;
+    QVERIFY(c == longText);
+    QVERIFY(b == longText);
+    c = a;
+    QVERIFY(c == shortText);
+    c = c;
+    QVERIFY(c == shortText);
+
+    a.swap(b);
+    QVERIFY(a == longText);
+    QVERIFY(b == shortText);
+    qSwap(a, b);
+    QVERIFY(a == shortText);
+    QVERIFY(b == longText);
+
+#ifdef Q_COMPILER_RVALUE_REFS
+    QSmallString moved(std::move(b));
+    QVERIFY(moved == longText);
+    QVERIFY(b.isEmpty());
+    b = std::move(moved);
+    QVERIFY(b == longText);
+#endif
+
+    QVector<QSmallString> vector;
+    for (int i = 0; i < 100; ++i)
+        vector.append(QSmallString(i % 2 ? longText + QString::number(i) : QString::number(i)));
+    vector.insert(0, a);
+    QVERIFY(vector.first() == shortText);
+    for (int i = 0; i < 100; ++i)
+        QVERIFY(vector.at(i + 1) == (i % 2 ? longText + QString::number(i) : QString::number(i)));
+}
+
+void tst_QSmallString::implicitSharing()
+{
+    const QString longText("a string that does not fit inline");
+
+    QSmallString s(longText);
+    QVERIFY(!s.isInline());
+    QCOMPARE(s.constData(), longText.constData());
+    QCOMPARE(s.toString().constData(), longText.constData());
+
+    QSmallString copy(s);
+    QCOMPARE(copy.constData(), longText.constData());
+
+    QString detached = longText;
+    detached[0] = QLatin1Char('A');
+    QVERIFY(copy == longText);
+
+    QSmallString shortString(QString("short"));
+    QVERIFY(shortString.constData() != shortString.toString().constData());
+}
+
+void tst_QSmallString::compare_data()
+{
+    QTest::addColumn<QString>("s1");
+    QTest::addColumn<QString>("s2");
+
+    QTest::newRow("empty") << QString() << QString("");
+    QTest::newRow("equal") << QString("abc") << QString("abc");
+    QTest::newRow("prefix") << QString("abc") << QString("abcd");
+    QTest::newRow("order") << QString("abd") << QString("abc");
+    QTest::newRow("case") << QString("ABC") << QString("abc");
+    QTest::newRow("inline-vs-long") << QString("abcdefghijk") << QString("abcdefghijkl");
+    QTest::newRow("long") << QString("a string that does not fit inline")
+                          << QString("a string that does not fit inline!");
+    QTest::newRow("high-code-unit") << QString(QChar(0xfffd)) << QString(QChar(0x41));
+    QTest::newRow("surrogates") << QString::fromUtf8("\xf0\x9f\x98\x80") << QString(QChar(0xfffd));
+}
+
+void tst_QSmallString::compare()
+{
+    QFETCH(QString, s1);
+    QFETCH(QString, s2);
+
+    const QSmallString a(s1);
+    const QSmallString b(s2);
+
+    QCOMPARE(a == b, s1 == s2);
+    QCOMPARE(a != b, s1 != s2);
+    QCOMPARE(a < b, s1 < s2);
+    QCOMPARE(b < a, s2 < s1);
+    QCOMPARE(a > b, s1 > s2);
+    QCOMPARE(a <= b, s1 <= s2);
+    QCOMPARE(a >= b, s1 >= s2);
+    QCOMPARE(a == s2, s1 == s2);
+    QCOMPARE(s1 != b, s1 != s2);
+}
+
+void tst_QSmallString::hash()
+{
+    const QString strings[] = {
+        QString(), QString("x"), QString("0123456789a"), QString("0123456789ab"),
+        QString::fromUtf8("\xd0\x9c\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2\xd0\xb0"),
+        QString("a string that does not fit inline")
+    };
+    for (size_t i = 0; i < sizeof(strings) / sizeof(strings[0]); ++i) {
+        QCOMPARE(qHash(QSmallString(strings[i])), qHash(strings[i]));
+        QCOMPARE(qHash(QSmallString(strings[i]), 42U), qHash(strings[i], 42U));
+    }
+}
+
+void tst_QSmallString::containerKeys()
+{
+    QHash<QSmallString, int> hash;
+    QFlatHash<QSmallString, int> flatHash;
+    QMap<QSmallString, int> map;
+    QMap<QString, int> reference;
+
+    for (int i = 0; i < 1000; ++i) {
+        const QString key = QString::number(i * 7919, 36).repeated(1 + i % 5);
+        hash.insert(key, i);
+        flatHash.insert(key, i);
+        map.insert(key, i);
+        reference.insert(key, i);
+    }
+
+    QCOMPARE(hash.size(), reference.size());
+    QCOMPARE(flatHash.size(), reference.size());
+    QCOMPARE(map.size(), reference.size());
+
+    QMap<QSmallString, int>::const_iterator it = map.constBegin();
+    for (QMap<QString, int>::const_iterator r = reference.constBegin(); r != reference.constEnd(); ++r, ++it) {
+        QVERIFY(it.key() == r.key());
+        QCOMPARE(it.value(), r.value());
+        QCOMPARE(hash.value(r.key(), -1), r.value());
+        QCOMPARE(flatHash.value(r.key(), -1), r.value());
+    }
+}
+
+void tst_QSmallString::byteArray_data()
+{
+    QTest::addColumn<QByteArray>("ba");
+    QTest::addColumn<bool>("isInline");
+
+    QTest::newRow("null") << QByteArray() << true;
+    QTest::newRow("empty") << QByteArray("") << true;
+    QTest::newRow("one") << QByteArray("a") << true;
+    QTest::newRow("twenty-three") << QByteArray(23, 'x') << true;
+    QTest::newRow("twenty-four") << QByteArray(24, 'x') << false;
+    QTest::newRow("embedded-nul") << QByteArray("a\0b", 3) << true;
+    QTest::newRow("high-bytes") << QByteArray(23, '\xff') << true;
+    QTest::newRow("long") << QByteArray(200, 'y') << false;
+}
+
+void tst_QSmallString::byteArray()
+{
+    QFETCH(QByteArray, ba);
+    QFETCH(bool, isInline);
+
+    QSmallByteArray a(ba);
+    QCOMPARE(a.size(), ba.size());
+    QCOMPARE(a.isEmpty(), ba.isEmpty());
+    QCOMPARE(a.isInline(), isInline);
+    QCOMPARE(a.toByteArray(), ba);
+    QCOMPARE(a.constData()[a.size()], '\0');
+    QVERIFY(a == ba);
+    QVERIFY(ba == a);
+    for (int i = 0; i < ba.size(); ++i)
+        QCOMPARE(a.at(i), ba.at(i));
+    QVERIFY(std::equal(a.begin(), a.end(), ba.constBegin()));
+
+    QSmallByteArray fromData(ba.constData(), ba.size());
+    QVERIFY(fromData == a);
+    QCOMPARE(fromData.isInline(), isInline);
+
+    QSmallByteArray copy(a);
+    QVERIFY(copy == ba);
+    copy.clear();
+    QVERIFY(copy.isEmpty());
+    QVERIFY(a == ba);
+
+    if (!isInline)
+        QCOMPARE(a.constData(), ba.constData());
+}
+
+void tst_QSmallString::byteArrayCompare()
+{
+    QSmallByteArray a("abc");
+    QVERIFY(a == "abc");
+    QVERIFY("abc" == a);
+    QVERIFY(a != "abcd");
+    QVERIFY(a != QByteArray("ab"));
+    QCOMPARE(QSmallByteArray("ab", 1).toByteArray(), QByteArray("a"));
+
+    a = "replaced";
+    QVERIFY(a == "replaced");
+    a = QByteArray(30, 'z');
+    QVERIFY(a == QByteArray(30, 'z'));
+    QVERIFY(!a.isInline());
+
+    const QByteArray samples[] = {
+        QByteArray(), QByteArray("a"), QByteArray("ab"), QByteArray("b"),
+        QByteArray("\x80"), QByteArray("\x7f"), QByteArray(23, 'q'), QByteArray(24, 'q')
+    };
+    const int count = sizeof(samples) / sizeof(samples[0]);
+    for (int i = 0; i < count; ++i) {
+        for (int j = 0; j < count; ++j) {
+            const QSmallByteArray x(samples[i]);
+            const QSmallByteArray y(samples[j]);
+            QCOMPARE(x < y, samples[i] < samples[j]);
+            QCOMPARE(x == y, samples[i] == samples[j]);
+            QCOMPARE(x >= y, samples[i] >= samples[j]);
+        }
+    }
+}
+
+void tst_QSmallString::byteArrayHash()
+{
+    const QByteArray samples[] = {
+        QByteArray(), QByteArray("tag"), QByteArray(23, 'q'), QByteArray(100, 'r')
+    };
+    for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); ++i) {
+        QCOMPARE(qHash(QSmallByteArray(samples[i])), qHash(samples[i]));
+        QCOMPARE(qHash(QSmallByteArray(samples[i]), 7U), qHash(samples[i], 7U));
+    }
+
+    QSet<QSmallByteArray> set;
+    set << QSmallByteArray("highway") << QSmallByteArray("amenity") << QSmallByteArray("highway");
+    QCOMPARE(set.size(), 2);
+    QVERIFY(set.contains("amenity"));
+}
+
+QTEST_APPLESS_MAIN(tst_QSmallString)
+#include "tst_qsmallstring.moc"
@@ -229,6 +229,9 @@ private slots:
     void nanAndInf();
     void compare_data();
     void compare();
+    void compareCaseInsensitiveLong();
+    void indexOfLong();
+    void caseConversionLong();
     void resizeAfterFromRawData();
     void resizeAfterReserve();
     void resizeWithNegative() const;
@@ -5386,6 +5389,164 @@ void tst_QString::compare()
     }
 }
 
+// Characters that make the vectorized code paths fall back to the Unicode tables,
+// and what they fold to; U+212A KELVIN SIGN and U+017F LATIN SMALL LETTER LONG S
+// are outside ASCII but fold to ASCII letters.
+static const struct {
+    ushort ch;
+    ushort folded;
+} nonAsciiFolds[] = {
+    { 0x212a, 'k' },
+    { 0x017f, 's' },
+    { 0x00c9, 0x00e9 },
+    { 0x0416, 0x0436 },
+    { 0x03a9, 0x03c9 },
+    { 0x4e2d, 0x4e2d }
+};
+
+// lowercase ASCII filler without any 'k', 's' or 'z', which the tests look for
+static QString longFiller(int length)
+{
+    static const char filler[] = "abcdefghijlmnopqrtuvwxy0123456789 .-";
+    QString s;
+    for (int i = 0; i < length; ++i)
+        s += QLatin1Char(filler[i % (sizeof filler - 1)]);
+    return s;
+}
+
+void tst_QString::compareCaseInsensitiveLong()
+{
+    for (int length = 1; length <= 40; ++length) {
+        const QString lower = longFiller(length);
+        const QString upper = lower.toUpper();
+        QCOMPARE(QString::compare(lower, upper, Qt::CaseInsensitive), 0);
+        QCOMPARE(QString::compare(upper, QLatin1String(lower.toLatin1()), Qt::CaseInsensitive), 0);
+
+        for (int pos = 0; pos < length; ++pos) {
+            const QByteArray where = "length " + QByteArray::number(length) + ", position " + QByteArray::number(pos);
+
+            QString s1 = upper;
+            s1[pos] = QLatin1Char('z');
+            QVERIFY2(QString::compare(s1, lower, Qt::CaseInsensitive) > 0, where);
+            QVERIFY2(QString::compare(lower, s1, Qt::CaseInsensitive) < 0, where);
+            QVERIFY2(QString::compare(lower, QLatin1String(s1.toLatin1()), Qt::CaseInsensitive) < 0, where);
+            QVERIFY2(QString::compare(s1, QLatin1String(lower.toLatin1()), Qt::CaseInsensitive) > 0, where);
+
+            for (uint i = 0; i < sizeof nonAsciiFolds / sizeof nonAsciiFolds[0]; ++i) {
+                QString s2 = lower;
+                s2[pos] = QChar(nonAsciiFolds[i].folded);
+                s1 = upper;
+                s1[pos] = QChar(nonAsciiFolds[i].ch);
+                QVERIFY2(QString::compare(s1, s2, Qt::CaseInsensitive) == 0, where);
+                QVERIFY2(QString::compare(s1.toCaseFolded(), s2, Qt::CaseSensitive) == 0, where);
+                if (nonAsciiFolds[i].folded <= 0xff) {
+                    QVERIFY2(QString::compare(s1, QLatin1String(s2.toLatin1()), Qt::CaseInsensitive) == 0, where);
+                    QVERIFY2(sign(QString::compare(s1, QLatin1String(lower.toLatin1()), Qt::CaseInsensitive))
+                             == sign(nonAsciiFolds[i].folded - lower.at(pos).unicode()), where);
+                }
+            }
+        }
+    }
+
+    // a surrogate pair straddling the eighth character
+    QString upper = longFiller(7).toUpper();
+    QString lower = longFiller(7);
+    upper += QChar(QChar::highSurrogate(0x10400));
+    upper += QChar(QChar::lowSurrogate(0x10400));
+    lower += QChar(QChar::highSurrogate(0x10428));
+    lower += QChar(QChar::lowSurrogate(0x10428));
+    upper += longFiller(16).toUpper();
+    lower += longFiller(16);
+    QCOMPARE(QString::compare(upper, lower, Qt::CaseInsensitive), 0);
+}
+
+void tst_QString::indexOfLong()
+{
+    for (int length = 1; length <= 40; ++length) {
+        const QString filler = longFiller(length);
+        QCOMPARE(filler.indexOf(QLatin1Char('Z'), 0, Qt::CaseInsensitive), -1);
+        QCOMPARE(filler.indexOf(QLatin1String("Zk"), 0, Qt::CaseInsensitive), -1);
+        QCOMPARE(filler.indexOf(QLatin1String("zk"), 0, Qt::CaseSensitive), -1);
+
+        for (int pos = 0; pos < length; ++pos) {
+            const QByteArray where = "length " + QByteArray::number(length) + ", position " + QByteArray::number(pos);
+
+            QString s = filler;
+            s[pos] = QLatin1Char('Z');
+            QVERIFY2(s.indexOf(QLatin1Char('z'), 0, Qt::CaseInsensitive) == pos, where);
+            QVERIFY2(s.indexOf(QLatin1Char('Z'), pos, Qt::CaseInsensitive) == pos, where);
+            QVERIFY2(s.indexOf(QLatin1Char('z'), pos + 1, Qt::CaseInsensitive) == -1, where);
+
+            // a non-ASCII match before an ASCII one must win
+            s[pos] = QChar(0x212a);
+            if (pos + 1 < length)
+                s[pos + 1] = QLatin1Char('K');
+            QVERIFY2(s.indexOf(QLatin1Char('k'), 0, Qt::CaseInsensitive) == pos, where);
+            QVERIFY2(s.indexOf(QChar(0x212a), 0, Qt::CaseInsensitive) == pos, where);
+            QVERIFY2(s.indexOf(QChar(0x212a), 0, Qt::CaseSensitive) == pos, where);
+            QVERIFY2(s.indexOf(QLatin1Char('k'), 0, Qt::CaseSensitive) == -1, where);
+
+            // substrings ending at pos
+            for (int sl = 2; sl <= pos + 1 && sl <= 20; ++sl) {
+                const QByteArray where2 = where + ", needle length " + QByteArray::number(sl);
+                s = filler;
+                s[pos] = QLatin1Char('z');
+                const QString needle = s.mid(pos - sl + 1, sl);
+                QVERIFY2(s.indexOf(needle, 0, Qt::CaseSensitive) == pos - sl + 1, where2);
+                QVERIFY2(s.indexOf(needle.toUpper(), 0, Qt::CaseInsensitive) == pos - sl + 1, where2);
+                QVERIFY2(s.indexOf(needle.toUpper(), 0, Qt::CaseSensitive) == -1, where2);
+                QVERIFY2(s.indexOf(needle, pos - sl + 2, Qt::CaseSensitive) == -1, where2);
+
+                s[pos] = QChar(0x017f);
+                QVERIFY2(s.indexOf(needle, 0, Qt::CaseSensitive) == -1, where2);
+                QVERIFY2(s.indexOf(needle.left(sl - 1) + QLatin1Char('S'), 0, Qt::CaseInsensitive) == pos - sl + 1, where2);
+                QVERIFY2(s.indexOf(needle.left(sl - 1) + QChar(0x017f), 0, Qt::CaseSensitive) == pos - sl + 1, where2);
+            }
+        }
+    }
+}
+
+void tst_QString::caseConversionLong()
+{
+    for (int length = 1; length <= 40; ++length) {
+        const QString lower = longFiller(length);
+        const QString upper = lower.toUpper();
+        QCOMPARE(lower.toLower(), lower);
+        QCOMPARE(upper.toLower(), lower);
+        QCOMPARE(upper.toCaseFolded(), lower);
+        QCOMPARE(lower.toUpper(), upper);
+        QCOMPARE(QString(lower + upper).toUpper(), QString(upper + upper));
+        QCOMPARE(QString(lower + upper).toLower(), QString(lower + lower));
+
+        for (int pos = 0; pos < length; ++pos) {
+            const QByteArray where = "length " + QByteArray::number(length) + ", position " + QByteArray::number(pos);
+
+            for (uint i = 0; i < sizeof nonAsciiFolds / sizeof nonAsciiFolds[0]; ++i) {
+                const QChar ch(nonAsciiFolds[i].ch);
+                QString s = upper;
+                s[pos] = ch;
+                QString expected = lower;
+                expected[pos] = ch.toLower();
+                QVERIFY2(s.toLower() == expected, where);
+                expected[pos] = ch.toCaseFolded();
+                QVERIFY2(s.toCaseFolded() == expected, where);
+
+                s = lower;
+                s[pos] = ch;
+                expected = upper;
+                expected[pos] = ch.toUpper();
+                QVERIFY2(s.toUpper() == expected, where);
+            }
+
+            // U+00DF LATIN SMALL LETTER SHARP S uppercases to two letters
+            QString s = lower;
+            s[pos] = QChar(0xdf);
+            const QString expected = upper.left(pos) + QLatin1String("SS") + upper.mid(pos + 1);
+            QVERIFY2(s.toUpper() == expected, where);
+        }
+    }
+}
+
 void tst_QString::resizeAfterFromRawData()
 {
     QString buffer("hello world");
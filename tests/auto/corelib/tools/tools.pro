@@ -18,6 +18,8 @@ SUBDIRS=\
     qeasingcurve \
     qelapsedtimer \
     qexplicitlyshareddatapointer \
+    qflathash \
+    qflatset \
     qfreelist \
     qhash \
     qhash_strictiterators \
@@ -44,6 +46,7 @@ SUBDIRS=\
     qsharedpointer \
     qsize \
     qsizef \
+    qsmallstring \
     qstl \
     qstring \
     qstring_no_cast_from_bytearray \
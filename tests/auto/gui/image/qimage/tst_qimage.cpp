@@ -54,6 +54,12 @@
 Q_DECLARE_METATYPE(QImage::Format)
 Q_DECLARE_METATYPE(Qt::GlobalColor)
 
+#ifdef QT_BUILD_INTERNAL
+QT_BEGIN_NAMESPACE
+extern void qt_setImageScaleSimdEnabled(bool enabled); // qimagescale.cpp
+QT_END_NAMESPACE
+#endif
+
 class tst_QImage : public QObject
 {
     Q_OBJECT
@@ -120,6 +126,8 @@ private slots:
 
     void smoothScaleBig();
     void smoothScaleAlpha();
+    void smoothScaleSimd_data();
+    void smoothScaleSimd();
 
     void transformed_data();
     void transformed();
@@ -1647,6 +1655,50 @@ void tst_QImage::smoothScaleAlpha()
     QCOMPARE(dst, expected);
 }
 
+void tst_QImage::smoothScaleSimd_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<QSize>("scaledSize");
+
+    // the source is 61x47, the sizes cover the four cases of the scaler
+    const QImage::Format formats[] = { QImage::Format_ARGB32_Premultiplied, QImage::Format_RGB32 };
+    const char * const formatNames[] = { "ARGB32_Premultiplied", "RGB32" };
+    for (int i = 0; i < 2; ++i) {
+        QTest::newRow(QByteArray(formatNames[i]) + " up") << formats[i] << QSize(153, 100);
+        QTest::newRow(QByteArray(formatNames[i]) + " down") << formats[i] << QSize(17, 13);
+        QTest::newRow(QByteArray(formatNames[i]) + " down horizontally") << formats[i] << QSize(29, 90);
+        QTest::newRow(QByteArray(formatNames[i]) + " down vertically") << formats[i] << QSize(130, 11);
+        QTest::newRow(QByteArray(formatNames[i]) + " one pixel") << formats[i] << QSize(1, 1);
+    }
+}
+
+// compares the SIMD scalers against the generic ones, they must be bit-identical
+void tst_QImage::smoothScaleSimd()
+{
+#ifdef QT_BUILD_INTERNAL
+    QFETCH(QImage::Format, format);
+    QFETCH(QSize, scaledSize);
+
+    QImage src(61, 47, QImage::Format_ARGB32);
+    qsrand(7);
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x)
+            src.setPixel(x, y, qRgba(rand8(), rand8(), rand8(), rand8()));
+    }
+    src = src.convertToFormat(format);
+
+    const QImage simd = src.scaled(scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    qt_setImageScaleSimdEnabled(false);
+    const QImage generic = src.scaled(scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    qt_setImageScaleSimdEnabled(true);
+
+    QCOMPARE(simd.size(), scaledSize);
+    QCOMPARE(simd, generic);
+#else
+    QSKIP("This test requires a developer build.");
+#endif
+}
+
 static int count(const QImage &img, int x, int y, int dx, int dy, QRgb pixel)
 {
     int i = 0;
@@ -76,6 +76,9 @@
 #include <qlayout.h>
 #endif
 #include <qfontdatabase.h>
+#include <qthreadpool.h>
+
+#include <private/qtiledrasterdevice_p.h>
 
 Q_DECLARE_METATYPE(QGradientStops)
 Q_DECLARE_METATYPE(QPainterPath)
@@ -278,6 +281,7 @@ private slots:
     void drawPointScaled();
 
     void QTBUG14614_gradientCacheRaceCondition();
+    void gradientCacheEviction();
     void drawTextOpacity();
 
     void QTBUG17053_zeroDashPattern();
@@ -291,9 +295,21 @@ private slots:
     void cosmeticStrokerClipping_data();
     void cosmeticStrokerClipping();
 
+    void systemClipBands_data();
+    void systemClipBands();
+    void drawThickLineInTallImage();
+
     void blendARGBonRGB_data();
     void blendARGBonRGB();
 
+    void tiledRasterDevice_data();
+    void tiledRasterDevice();
+
+    void drawPolylines_data();
+    void drawPolylines();
+    void drawPolygons_data();
+    void drawPolygons();
+
 private:
     void fillData();
     void setPenColor(QPainter& p);
@@ -4429,6 +4445,64 @@ void tst_QPainter::QTBUG14614_gradientCacheRaceCondition()
         producers[i].wait();
 }
 
+static QLinearGradient evictionGradient(int thread, int index)
+{
+    QLinearGradient g(0, 0, 64, 0);
+    g.setColorAt(0, QColor(index * 4, thread * 16, 0));
+    g.setColorAt(1, QColor(0, 255 - index * 4, 255 - thread * 16));
+    return g;
+}
+
+class GradientEvictionPainter : public QThread
+{
+public:
+    enum { Gradients = 64 };
+
+    GradientEvictionPainter() : id(0), mismatches(0) { }
+
+    int id;
+    QVector<QImage> expected;
+    int mismatches;
+
+protected:
+    void run()
+    {
+        QImage image(64, 16, QImage::Format_RGB32);
+        QPainter p(&image);
+        for (int i = 0; i < 2000; ++i) {
+            const int index = i % Gradients;
+            p.fillRect(image.rect(), evictionGradient(id, index));
+            if (image != expected.at(index))
+                ++mismatches;
+        }
+    }
+};
+
+// The threads use many more gradients than the cache holds, so that they
+// keep evicting the entries the other threads are painting with.
+void tst_QPainter::gradientCacheEviction()
+{
+    const int threadCount = 8;
+    GradientEvictionPainter painters[threadCount];
+    for (int i = 0; i < threadCount; ++i) {
+        painters[i].id = i;
+        for (int index = 0; index < GradientEvictionPainter::Gradients; ++index) {
+            QImage image(64, 16, QImage::Format_RGB32);
+            QPainter p(&image);
+            p.fillRect(image.rect(), evictionGradient(i, index));
+            p.end();
+            painters[i].expected.append(image);
+        }
+    }
+
+    for (int i = 0; i < threadCount; ++i)
+        painters[i].start();
+    for (int i = 0; i < threadCount; ++i)
+        QVERIFY(painters[i].wait(60000));
+    for (int i = 0; i < threadCount; ++i)
+        QCOMPARE(painters[i].mismatches, 0);
+}
+
 void tst_QPainter::drawTextOpacity()
 {
     QImage image(32, 32, QImage::Format_RGB32);
@@ -4755,6 +4829,324 @@ void tst_QPainter::cosmeticStrokerClipping()
     QCOMPARE(old, image);
 }
 
+enum BandedPaint
+{
+    AliasedPath,
+    AntialiasedPath,
+    AliasedThickLine,
+    TransformedImage
+};
+
+static void paint_func(QPainter *p, BandedPaint type)
+{
+    p->save();
+    switch (type) {
+    case AliasedPath:
+    case AntialiasedPath: {
+        // many spans on every row, so that the span buffers fill up mid-row
+        QPainterPath path;
+        for (int i = 0; i < 150; ++i)
+            path.addEllipse(QRectF(i * 3.7, 10 + i * 0.9, 2.3, 700 - i * 3.3));
+        p->setRenderHint(QPainter::Antialiasing, type == AntialiasedPath);
+        p->fillPath(path, QColor(0, 0, 255, 160));
+        break; }
+    case AliasedThickLine:
+        p->setPen(QPen(Qt::black, 5.5, Qt::SolidLine, Qt::FlatCap));
+        p->drawLine(QPointF(3.3, -40.2), QPointF(530.7, 790.1));
+        p->drawLine(QPointF(20.6, 797.4), QPointF(300.2, 2.9));
+        break;
+    case TransformedImage: {
+        QImage image(64, 48, QImage::Format_RGB32);
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x)
+                image.setPixel(x, y, qRgb(x * 4, y * 5, (x ^ y) * 4));
+        }
+        p->translate(319.27, -44.99);
+        p->rotate(69.87);
+        p->scale(10.52, 5.6);
+        p->drawImage(0, 0, image);
+        break; }
+    default:
+        Q_ASSERT(false);
+        break;
+    }
+    p->restore();
+}
+
+Q_DECLARE_METATYPE(BandedPaint)
+
+void tst_QPainter::systemClipBands_data()
+{
+    QTest::addColumn<BandedPaint>("paint");
+
+    QTest::newRow("aliased path") << AliasedPath;
+    QTest::newRow("antialiased path") << AntialiasedPath;
+    QTest::newRow("aliased thick line") << AliasedThickLine;
+    QTest::newRow("transformed image") << TransformedImage;
+}
+
+// Painting band by band, with a system clip for each band, must give the
+// same image as painting it all at once.
+void tst_QPainter::systemClipBands()
+{
+    QFETCH(BandedPaint, paint);
+
+    QImage expected(560, 800, QImage::Format_RGB32);
+    expected.fill(Qt::white);
+    QPainter p(&expected);
+    paint_func(&p, paint);
+    p.end();
+
+    for (int bandHeight = 1; bandHeight <= 32; bandHeight *= 2) {
+        QImage image(expected.size(), QImage::Format_RGB32);
+        image.fill(Qt::white);
+        for (int y = 0; y < image.height(); y += bandHeight) {
+            image.paintEngine()->setSystemClip(QRect(0, y, image.width(), bandHeight));
+            p.begin(&image);
+            paint_func(&p, paint);
+            p.end();
+        }
+        image.paintEngine()->setSystemClip(QRegion());
+        QCOMPARE(image, expected);
+    }
+}
+
+// Lines were shortened to rows within +-16384 before they were
+// rasterized, so thick lines did not reach the rows below.
+void tst_QPainter::drawThickLineInTallImage()
+{
+    QImage image(16, 20000, QImage::Format_RGB32);
+    image.fill(Qt::white);
+    QPainter p(&image);
+    p.setPen(QPen(Qt::black, 4, Qt::SolidLine, Qt::FlatCap));
+    p.drawLine(QPointF(8, 0), QPointF(8, 20000));
+    p.drawLine(QPointF(0, 18000), QPointF(16, 18000));
+    p.end();
+
+    QCOMPARE(image.pixel(8, 100), QColor(Qt::black).rgb());
+    QCOMPARE(image.pixel(8, 19900), QColor(Qt::black).rgb());
+    QCOMPARE(image.pixel(2, 18000), QColor(Qt::black).rgb());
+}
+
+// The raster engine calls qrand() as well, so the scene has its own
+// generator to be the same every time it is painted.
+struct TiledSceneRandom
+{
+    TiledSceneRandom() : state(42) { }
+    int operator()(int max)
+    {
+        state = state * 1103515245u + 12345u;
+        return int((state >> 16) % uint(max));
+    }
+    uint state;
+};
+
+static void paintTiledScene(QPainter *p, const QSize &size)
+{
+    p->fillRect(QRect(QPoint(0, 0), size), Qt::white);
+
+    QLinearGradient linear(0, 0, size.width(), size.height());
+    linear.setColorAt(0, QColor(255, 0, 0, 180));
+    linear.setColorAt(1, QColor(0, 0, 255, 120));
+    QRadialGradient radial(size.width() / 2, size.height() / 2, size.width() / 3);
+    radial.setColorAt(0, QColor(0, 255, 0, 200));
+    radial.setColorAt(1, QColor(255, 0, 255, 90));
+
+    QImage texture(32, 32, QImage::Format_ARGB32_Premultiplied);
+    texture.fill(QColor(0, 128, 0, 128));
+
+    TiledSceneRandom random;
+    for (int i = 0; i < 120; ++i) {
+        const QPointF pos(random(size.width()), random(size.height()));
+        p->setRenderHint(QPainter::Antialiasing, i % 2);
+        p->setRenderHint(QPainter::SmoothPixmapTransform, i % 3);
+
+        QPen pen(i % 4 ? QBrush(radial) : QBrush(QColor(random(256), 40, 90)), random(30) / 10.);
+        if (i % 5 == 0)
+            pen.setStyle(Qt::DashDotLine);
+        p->setPen(pen);
+        p->setBrush(i % 3 ? QBrush(linear) : QBrush(QColor(20, random(256), 200, 100)));
+
+        if (i % 11 == 0) {
+            p->save();
+            p->setClipRect(QRectF(pos, QSizeF(150, 100)));
+            p->setOpacity(0.5);
+        }
+
+        switch (i % 6) {
+        case 0: {
+            QPainterPath path(pos);
+            for (int j = 0; j < 3; ++j)
+                path.cubicTo(random(size.width()), random(size.height()),
+                             random(size.width()), random(size.height()),
+                             random(size.width()), random(size.height()));
+            path.closeSubpath();
+            p->drawPath(path);
+            break; }
+        case 1:
+            p->drawEllipse(QRectF(pos, QSizeF(random(150), random(150))));
+            break;
+        case 2:
+            p->drawLine(pos, QPointF(random(size.width()), random(size.height())));
+            break;
+        case 3:
+            p->drawRect(QRectF(pos + QPointF(0.3, 0.7), QSizeF(random(200), random(200))));
+            break;
+        case 4:
+            p->save();
+            p->translate(pos);
+            p->rotate(random(360));
+            p->drawImage(QRectF(0, 0, 120, 80), texture);
+            p->restore();
+            break;
+        case 5:
+            p->fillRect(QRectF(pos, QSizeF(90.5, 33.3)), radial);
+            break;
+        }
+
+        if (i % 11 == 0)
+            p->restore();
+    }
+}
+
+void tst_QPainter::tiledRasterDevice_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<int>("tileHeight");
+
+    QTest::newRow("1 thread") << 1 << 64;
+    QTest::newRow("2 threads") << 2 << 64;
+    QTest::newRow("4 threads, small tiles") << 4 << 7;
+}
+
+void tst_QPainter::tiledRasterDevice()
+{
+    QFETCH(int, threadCount);
+    QFETCH(int, tileHeight);
+
+    const QSize size(400, 300);
+    QImage expected(size, QImage::Format_ARGB32_Premultiplied);
+    QPainter p(&expected);
+    paintTiledScene(&p, size);
+    p.end();
+
+    QThreadPool::globalInstance()->setMaxThreadCount(qMax(threadCount, 1));
+
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    QTiledRasterDevice device(&image);
+    device.setThreadCount(threadCount);
+    device.setTileHeight(tileHeight);
+
+    // the device can be painted on several times
+    for (int i = 0; i < 2; ++i) {
+        image.fill(Qt::black);
+        QVERIFY(p.begin(&device));
+        paintTiledScene(&p, size);
+        QVERIFY(p.end());
+        QCOMPARE(image, expected);
+    }
+}
+
+static QVector<QPolygonF> batchPolygons()
+{
+    QVector<QPolygonF> polygons;
+    for (int i = 0; i < 60; ++i) {
+        const QPointF origin(7 * (i % 10) + 2.5, 13 * (i / 10) + 1.25);
+        QPolygonF polygon;
+        polygon << origin << origin + QPointF(9, 3) << origin + QPointF(4, 11);
+        if (i % 3)
+            polygon << origin + QPointF(-2, 8);
+        polygons << polygon;
+    }
+    // overlapping, degenerate and rectangular polygons
+    polygons << (QPolygonF() << QPointF(1, 1) << QPointF(79, 70) << QPointF(75, 2));
+    polygons << (QPolygonF() << QPointF(40, 40));
+    polygons << QPolygonF();
+    polygons << QPolygonF(QRectF(20, 20, 30, 15));
+    return polygons;
+}
+
+void tst_QPainter::drawPolylines_data()
+{
+    QTest::addColumn<QPen>("pen");
+    QTest::addColumn<bool>("antialiased");
+
+    QTest::newRow("cosmetic") << QPen(Qt::red, 0) << false;
+    QTest::newRow("cosmetic antialiased") << QPen(QColor(255, 0, 0, 128), 0) << true;
+    QTest::newRow("cosmetic dashed") << QPen(Qt::blue, 0, Qt::DashLine) << false;
+    QTest::newRow("wide") << QPen(Qt::green, 3) << false;
+}
+
+void tst_QPainter::drawPolylines()
+{
+    QFETCH(QPen, pen);
+    QFETCH(bool, antialiased);
+
+    const QVector<QPolygonF> polylines = batchPolygons();
+
+    QImage expected(80, 80, QImage::Format_ARGB32_Premultiplied);
+    expected.fill(Qt::white);
+    QPainter p(&expected);
+    p.setRenderHint(QPainter::Antialiasing, antialiased);
+    p.setPen(pen);
+    for (int i = 0; i < polylines.size(); ++i)
+        p.drawPolyline(polylines.at(i));
+    p.end();
+
+    QImage image(80, 80, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    p.begin(&image);
+    p.setRenderHint(QPainter::Antialiasing, antialiased);
+    p.setPen(pen);
+    p.drawPolylines(polylines);
+    p.end();
+
+    QCOMPARE(image, expected);
+}
+
+void tst_QPainter::drawPolygons_data()
+{
+    QTest::addColumn<QPen>("pen");
+    QTest::addColumn<bool>("antialiased");
+    QTest::addColumn<int>("fillRule");
+
+    QTest::newRow("no pen") << QPen(Qt::NoPen) << false << int(Qt::OddEvenFill);
+    QTest::newRow("cosmetic") << QPen(Qt::red, 0) << false << int(Qt::OddEvenFill);
+    QTest::newRow("cosmetic antialiased") << QPen(QColor(255, 0, 0, 128), 0) << true << int(Qt::WindingFill);
+    QTest::newRow("wide antialiased") << QPen(QColor(0, 0, 255, 128), 2.5) << true << int(Qt::OddEvenFill);
+}
+
+void tst_QPainter::drawPolygons()
+{
+    QFETCH(QPen, pen);
+    QFETCH(bool, antialiased);
+    QFETCH(int, fillRule);
+
+    const QVector<QPolygonF> polygons = batchPolygons();
+    const QBrush brush(QColor(0, 128, 0, 100));
+
+    QImage expected(80, 80, QImage::Format_ARGB32_Premultiplied);
+    expected.fill(Qt::white);
+    QPainter p(&expected);
+    p.setRenderHint(QPainter::Antialiasing, antialiased);
+    p.setPen(pen);
+    p.setBrush(brush);
+    for (int i = 0; i < polygons.size(); ++i)
+        p.drawPolygon(polygons.at(i), Qt::FillRule(fillRule));
+    p.end();
+
+    QImage image(80, 80, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    p.begin(&image);
+    p.setRenderHint(QPainter::Antialiasing, antialiased);
+    p.setPen(pen);
+    p.setBrush(brush);
+    p.drawPolygons(polygons, Qt::FillRule(fillRule));
+    p.end();
+
+    QCOMPARE(image, expected);
+}
+
 QTEST_MAIN(tst_QPainter)
 
 #include "tst_qpainter.moc"
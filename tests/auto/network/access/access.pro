@@ -1,6 +1,7 @@
 TEMPLATE=subdirs
 SUBDIRS=\
    qnetworkdiskcache \
+   qnetworkindexeddiskcache \
    qnetworkcookiejar \
    qnetworkaccessmanager \
    qnetworkcookie \
@@ -8,6 +9,7 @@ SUBDIRS=\
    qhttpnetworkconnection \
    qnetworkreply \
    spdy \
+   http2 \
    qnetworkcachemetadata \
    qftp \
    qhttpnetworkreply \
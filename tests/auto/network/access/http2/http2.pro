@@ -0,0 +1,6 @@
+CONFIG += testcase
+CONFIG += parallel_test
+TARGET = tst_http2
+SOURCES  += tst_http2.cpp
+
+QT = core network testlib
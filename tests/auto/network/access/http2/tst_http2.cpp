@@ -0,0 +1,725 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkProxy>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include <QtCore/QtEndian>
+
+// A stand-in for an HTTP/2 server speaking clear text (h2c). It cannot
+// decode the requests' HPACK blocks, so it answers each request with a
+// ":status: 200" field followed by the request's own header block. Sent in
+// the order they arrived the blocks keep the client's decoder in step with
+// its encoder, and the client sees its request fields as response fields.
+class Http2TestServer : public QObject
+{
+    Q_OBJECT
+public:
+    enum FrameType {
+        DATA = 0x0,
+        HEADERS = 0x1,
+        PRIORITY = 0x2,
+        RST_STREAM = 0x3,
+        SETTINGS = 0x4,
+        PUSH_PROMISE = 0x5,
+        PING = 0x6,
+        GOAWAY = 0x7,
+        WINDOW_UPDATE = 0x8,
+        CONTINUATION = 0x9
+    };
+
+    Http2TestServer();
+
+    quint16 port() const { return server.serverPort(); }
+    static QByteArray body(quint32 streamID, int size);
+
+    // configuration
+    quint32 maxConcurrentStreams; // 0: not announced
+    qint32 initialWindowSize;     // -1: not announced
+    int bodySize;                 // of GET responses
+    int holdResponses;            // answer in reverse order once that many requests are complete
+    int goAwayAfter;              // send GOAWAY with the stream of that request as the last one
+    QByteArray fixedHeaderBlock;  // answer with this instead of the request's header block
+
+    // what the server saw
+    bool prefaceReceived;
+    bool pushDisabled;
+    quint32 maxHeaderListSize;    // 0: not announced
+    qint64 goAwayErrorCode;       // -1: no GOAWAY received
+    int connectionCount;
+    int requestCount;
+    int maxOpenStreams;
+    int windowUpdates;
+    int refusedStreams;
+    QString error;
+    QByteArray uploadedData;
+
+private slots:
+    void newConnection();
+    void readyRead();
+
+private:
+    struct Stream {
+        Stream() : sendWindow(0), recvWindow(0), sent(0), complete(false) {}
+        qint64 sendWindow;
+        qint64 recvWindow;
+        QByteArray upload;
+        QByteArray response;
+        int sent;
+        bool complete;
+    };
+
+    void handleFrame(uchar type, uchar flags, quint32 streamID, const QByteArray &payload);
+    void handleRequest(quint32 streamID, bool endStream);
+    void requestComplete(quint32 streamID);
+    void sendFrame(uchar type, uchar flags, quint32 streamID, const QByteArray &payload = QByteArray());
+    void sendHeaderBlock(quint32 streamID, const QByteArray &block);
+    void sendUInt32Frame(uchar type, quint32 streamID, quint32 value);
+    void pump();
+    void fail(const QString &message);
+
+    QTcpServer server;
+    QTcpSocket *socket;
+    QByteArray buffer;
+    QMap<quint32, Stream> streams;
+    QList<quint32> sending;
+    QList<quint32> held;
+    qint64 connectionSendWindow;
+    qint64 connectionRecvWindow;
+    qint64 clientInitialWindow;
+    bool settingsAcked;
+    bool goingAway;
+    quint32 lastStreamID;
+    quint32 headerStreamID;
+    QByteArray headerBlock;
+    bool headerEndStream;
+};
+
+Http2TestServer::Http2TestServer()
+    : maxConcurrentStreams(0), initialWindowSize(-1), bodySize(64), holdResponses(0),
+      goAwayAfter(0), prefaceReceived(false), pushDisabled(false), maxHeaderListSize(0),
+      goAwayErrorCode(-1), connectionCount(0),
+      requestCount(0), maxOpenStreams(0), windowUpdates(0), refusedStreams(0), socket(0)
+{
+    connect(&server, SIGNAL(newConnection()), this, SLOT(newConnection()));
+    server.listen(QHostAddress::LocalHost);
+}
+
+QByteArray Http2TestServer::body(quint32 streamID, int size)
+{
+    QByteArray pattern = "stream " + QByteArray::number(streamID) + ';';
+    return pattern.repeated(size / pattern.size() + 1).left(size);
+}
+
+void Http2TestServer::newConnection()
+{
+    if (socket)
+        socket->deleteLater();
+    socket = server.nextPendingConnection();
+    connect(socket, SIGNAL(readyRead()), this, SLOT(readyRead()));
+    ++connectionCount;
+
+    buffer.clear();
+    streams.clear();
+    sending.clear();
+    held.clear();
+    connectionSendWindow = 65535;
+    connectionRecvWindow = 65535;
+    clientInitialWindow = 65535;
+    settingsAcked = false;
+    goingAway = false;
+    headerStreamID = 0;
+
+    QByteArray settings;
+    if (maxConcurrentStreams) {
+        settings.append(char(0)).append(char(0x3)).append(char(0)).append(char(0)).append(char(0));
+        settings.append(char(maxConcurrentStreams));
+    }
+    if (initialWindowSize >= 0) {
+        uchar setting[6];
+        qToBigEndian<quint16>(0x4, setting);
+        qToBigEndian<quint32>(initialWindowSize, setting + 2);
+        settings.append(reinterpret_cast<char *>(setting), 6);
+    }
+    sendFrame(SETTINGS, 0, 0, settings);
+}
+
+void Http2TestServer::readyRead()
+{
+    if (QTcpSocket *s = qobject_cast<QTcpSocket *>(sender())) {
+        if (s != socket)
+            return;
+    }
+    buffer += socket->readAll();
+
+    static const QByteArray preface("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n");
+    if (!buffer.isEmpty() && connectionCount && !socket->property("preface").toBool()) {
+        if (buffer.size() < preface.size())
+            return;
+        if (!buffer.startsWith(preface))
+            return fail("no connection preface");
+        buffer.remove(0, preface.size());
+        socket->setProperty("preface", true);
+        prefaceReceived = true;
+    }
+
+    while (buffer.size() >= 9) {
+        const uchar *header = reinterpret_cast<const uchar *>(buffer.constData());
+        const quint32 length = qFromBigEndian<quint32>(header) >> 8;
+        if (quint32(buffer.size()) < 9 + length)
+            break;
+        const uchar type = header[3];
+        const uchar flags = header[4];
+        const quint32 streamID = qFromBigEndian<quint32>(header + 5) & 0x7fffffff;
+        const QByteArray payload = buffer.mid(9, length);
+        buffer.remove(0, 9 + length);
+        handleFrame(type, flags, streamID, payload);
+    }
+    pump();
+}
+
+void Http2TestServer::handleFrame(uchar type, uchar flags, quint32 streamID, const QByteArray &payload)
+{
+    const uchar *data = reinterpret_cast<const uchar *>(payload.constData());
+
+    if (headerStreamID && type != CONTINUATION)
+        return fail("header block interrupted");
+
+    switch (type) {
+    case SETTINGS:
+        if (flags & 0x1) {
+            // our window size applies from now on
+            if (!settingsAcked && initialWindowSize >= 0) {
+                for (QMap<quint32, Stream>::iterator it = streams.begin(); it != streams.end(); ++it)
+                    it->recvWindow += initialWindowSize - 65535;
+            }
+            settingsAcked = true;
+            return;
+        }
+        for (int i = 0; i + 6 <= payload.size(); i += 6) {
+            const quint16 identifier = qFromBigEndian<quint16>(data + i);
+            const quint32 value = qFromBigEndian<quint32>(data + i + 2);
+            if (identifier == 0x2)
+                pushDisabled = (value == 0);
+            if (identifier == 0x6)
+                maxHeaderListSize = value;
+            if (identifier == 0x4) {
+                for (QMap<quint32, Stream>::iterator it = streams.begin(); it != streams.end(); ++it)
+                    it->sendWindow += qint64(value) - clientInitialWindow;
+                clientInitialWindow = value;
+            }
+        }
+        sendFrame(SETTINGS, 0x1, 0);
+        return;
+    case WINDOW_UPDATE: {
+        const quint32 increment = qFromBigEndian<quint32>(data);
+        if (streamID == 0) {
+            connectionSendWindow += increment;
+        } else {
+            ++windowUpdates;
+            if (streams.contains(streamID))
+                streams[streamID].sendWindow += increment;
+        }
+        return;
+    }
+    case HEADERS: {
+        int offset = (flags & 0x20) ? 5 : 0; // PRIORITY
+        headerBlock = payload.mid(offset);
+        headerEndStream = flags & 0x1;
+        if (flags & 0x4)
+            handleRequest(streamID, headerEndStream);
+        else
+            headerStreamID = streamID;
+        return;
+    }
+    case CONTINUATION:
+        if (streamID != headerStreamID)
+            return fail("unexpected CONTINUATION");
+        headerBlock += payload;
+        if (flags & 0x4) {
+            headerStreamID = 0;
+            handleRequest(streamID, headerEndStream);
+        }
+        return;
+    case DATA: {
+        connectionRecvWindow -= payload.size();
+        if (connectionRecvWindow < 0)
+            return fail("connection window exceeded");
+        if (!streams.contains(streamID))
+            return;
+        Stream &stream = streams[streamID];
+        stream.recvWindow -= payload.size();
+        if (stream.recvWindow < 0)
+            return fail("stream window exceeded");
+        stream.upload += payload;
+        if (!payload.isEmpty()) {
+            // take the data right away
+            sendUInt32Frame(WINDOW_UPDATE, 0, payload.size());
+            sendUInt32Frame(WINDOW_UPDATE, streamID, payload.size());
+            connectionRecvWindow += payload.size();
+            stream.recvWindow += payload.size();
+        }
+        if (flags & 0x1)
+            requestComplete(streamID);
+        return;
+    }
+    case PUSH_PROMISE:
+        return fail("client sent PUSH_PROMISE");
+    case GOAWAY:
+        if (payload.size() >= 8)
+            goAwayErrorCode = qFromBigEndian<quint32>(data + 4);
+        return;
+    default:
+        return;
+    }
+}
+
+void Http2TestServer::handleRequest(quint32 streamID, bool endStream)
+{
+    if (goingAway && streamID > lastStreamID)
+        return;
+
+    // answer right away to keep the HPACK tables in step
+    QByteArray block = fixedHeaderBlock;
+    if (block.isEmpty())
+        block = char(0x88) + headerBlock; // indexed ":status: 200"
+
+    int openStreams = 0;
+    for (QMap<quint32, Stream>::const_iterator it = streams.constBegin(); it != streams.constEnd(); ++it)
+        ++openStreams;
+    if (maxConcurrentStreams && quint32(openStreams) >= maxConcurrentStreams) {
+        // the block goes to the closed stream so the client's table still sees it
+        ++refusedStreams;
+        sendUInt32Frame(RST_STREAM, streamID, 0x7); // REFUSED_STREAM
+        sendHeaderBlock(streamID, block);
+        return;
+    }
+
+    ++requestCount;
+    Stream &stream = streams[streamID];
+    stream.sendWindow = clientInitialWindow;
+    stream.recvWindow = (settingsAcked && initialWindowSize >= 0) ? initialWindowSize : 65535;
+    maxOpenStreams = qMax(maxOpenStreams, openStreams + 1);
+
+    sendHeaderBlock(streamID, block);
+
+    if (goAwayAfter && requestCount == goAwayAfter) {
+        goingAway = true;
+        lastStreamID = streamID;
+        uchar payload[8];
+        qToBigEndian<quint32>(lastStreamID, payload);
+        qToBigEndian<quint32>(0, payload + 4);
+        sendFrame(GOAWAY, 0, 0, QByteArray(reinterpret_cast<char *>(payload), 8));
+    }
+
+    if (endStream)
+        requestComplete(streamID);
+}
+
+void Http2TestServer::requestComplete(quint32 streamID)
+{
+    Stream &stream = streams[streamID];
+    stream.complete = true;
+    stream.response = stream.upload.isEmpty() ? body(streamID, bodySize) : stream.upload;
+    if (stream.upload.size() > uploadedData.size())
+        uploadedData = stream.upload;
+
+    if (holdResponses) {
+        held.append(streamID);
+        if (held.count() == holdResponses) {
+            for (int i = held.count() - 1; i >= 0; --i)
+                sending.append(held.at(i));
+            held.clear();
+        }
+    } else {
+        sending.append(streamID);
+    }
+}
+
+void Http2TestServer::pump()
+{
+    int i = 0;
+    while (socket && i < sending.count()) {
+        const quint32 streamID = sending.at(i);
+        Stream &stream = streams[streamID];
+        while (stream.sent < stream.response.size() && stream.sendWindow > 0 && connectionSendWindow > 0) {
+            const int chunk = qMin<qint64>(qMin<qint64>(stream.response.size() - stream.sent, 16384),
+                                           qMin(stream.sendWindow, connectionSendWindow));
+            const bool last = stream.sent + chunk == stream.response.size();
+            sendFrame(DATA, last ? 0x1 : 0, streamID, stream.response.mid(stream.sent, chunk));
+            stream.sent += chunk;
+            stream.sendWindow -= chunk;
+            connectionSendWindow -= chunk;
+        }
+        if (stream.response.isEmpty())
+            sendFrame(DATA, 0x1, streamID);
+        if (stream.sent == stream.response.size()) {
+            streams.remove(streamID);
+            sending.removeAt(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void Http2TestServer::sendFrame(uchar type, uchar flags, quint32 streamID, const QByteArray &payload)
+{
+    uchar header[9];
+    qToBigEndian<quint32>((payload.size() << 8) | type, header);
+    header[4] = flags;
+    qToBigEndian<quint32>(streamID, header + 5);
+    socket->write(reinterpret_cast<char *>(header), 9);
+    socket->write(payload);
+}
+
+// a HEADERS frame followed by as many CONTINUATION frames as the block needs
+void Http2TestServer::sendHeaderBlock(quint32 streamID, const QByteArray &block)
+{
+    const int maxFrameSize = 16384;
+    int sent = 0;
+    do {
+        const int chunk = qMin(block.size() - sent, maxFrameSize);
+        const bool last = sent + chunk == block.size();
+        sendFrame(sent ? CONTINUATION : HEADERS, last ? 0x4 : 0, streamID, block.mid(sent, chunk));
+        sent += chunk;
+    } while (sent < block.size());
+}
+
+void Http2TestServer::sendUInt32Frame(uchar type, quint32 streamID, quint32 value)
+{
+    uchar payload[4];
+    qToBigEndian<quint32>(value, payload);
+    sendFrame(type, 0, streamID, QByteArray(reinterpret_cast<char *>(payload), 4));
+}
+
+void Http2TestServer::fail(const QString &message)
+{
+    if (error.isEmpty())
+        error = message;
+    socket->abort();
+}
+
+class tst_Http2: public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void singleRequest();
+    void multipleRequests();
+    void repliesInAnyOrder();
+    void maxConcurrentStreams();
+    void downloadFlowControl();
+    void uploadFlowControl();
+    void goAway();
+    void huffmanEncodedHeaders();
+    void oversizedHeaderBlock();
+    void oversizedHeaderList();
+
+protected Q_SLOTS:
+    void replyFinished();
+
+private:
+    QNetworkRequest request(const QByteArray &path) const;
+    bool waitForReplies(int count);
+
+    Http2TestServer *server;
+    QNetworkAccessManager *manager;
+    QList<QNetworkReply *> finishedReplies;
+    int expectedReplies;
+};
+
+void tst_Http2::init()
+{
+    server = new Http2TestServer;
+    QVERIFY(server->port());
+    manager = new QNetworkAccessManager;
+    manager->setProxy(QNetworkProxy::NoProxy);
+    finishedReplies.clear();
+    expectedReplies = 0;
+}
+
+void tst_Http2::cleanup()
+{
+    delete manager;
+    delete server;
+}
+
+QNetworkRequest tst_Http2::request(const QByteArray &path) const
+{
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server->port()) + path));
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    return request;
+}
+
+void tst_Http2::replyFinished()
+{
+    finishedReplies.append(qobject_cast<QNetworkReply *>(sender()));
+    if (finishedReplies.count() == expectedReplies)
+        QTestEventLoop::instance().exitLoop();
+}
+
+bool tst_Http2::waitForReplies(int count)
+{
+    expectedReplies = count;
+    if (finishedReplies.count() < count)
+        QTestEventLoop::instance().enterLoop(30);
+    return finishedReplies.count() == count;
+}
+
+void tst_Http2::singleRequest()
+{
+    QNetworkReply *reply = manager->get(request("/single"));
+    connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    QVERIFY(waitForReplies(1));
+
+    QCOMPARE(server->error, QString());
+    QVERIFY(server->prefaceReceived);
+    QVERIFY(server->pushDisabled);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
+    QVERIFY(reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool());
+    QCOMPARE(reply->readAll(), Http2TestServer::body(1, 64));
+    reply->deleteLater();
+}
+
+void tst_Http2::multipleRequests()
+{
+    const int count = 100;
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < count; ++i) {
+        QNetworkRequest tileRequest = request("/tile/" + QByteArray::number(i));
+        tileRequest.setRawHeader("X-Tile", QByteArray::number(i));
+        replies << manager->get(tileRequest);
+        connect(replies.last(), SIGNAL(finished()), this, SLOT(replyFinished()));
+    }
+    QVERIFY(waitForReplies(count));
+
+    QCOMPARE(server->error, QString());
+    QCOMPARE(server->connectionCount, 1);
+    QVERIFY(server->maxOpenStreams > 1);
+    for (int i = 0; i < count; ++i) {
+        QNetworkReply *reply = replies.at(i);
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QVERIFY(reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool());
+        // the stand-in echoes the request's fields
+        QCOMPARE(reply->rawHeader("x-tile"), QByteArray::number(i));
+        // streams are opened in the order the requests were made
+        QCOMPARE(reply->readAll(), Http2TestServer::body(2 * i + 1, 64));
+        reply->deleteLater();
+    }
+}
+
+void tst_Http2::repliesInAnyOrder()
+{
+    // responses are sent last request first, none waits for the others
+    const int count = 10;
+    server->holdResponses = count;
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < count; ++i) {
+        replies << manager->get(request("/order"));
+        connect(replies.last(), SIGNAL(finished()), this, SLOT(replyFinished()));
+    }
+    QVERIFY(waitForReplies(count));
+
+    QCOMPARE(server->error, QString());
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(finishedReplies.at(i), replies.at(count - 1 - i));
+        QCOMPARE(finishedReplies.at(i)->error(), QNetworkReply::NoError);
+        finishedReplies.at(i)->deleteLater();
+    }
+}
+
+void tst_Http2::maxConcurrentStreams()
+{
+    // streams the server refuses because the client opened them before
+    // learning about the limit are sent again
+    const int count = 20;
+    server->maxConcurrentStreams = 2;
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < count; ++i) {
+        QNetworkRequest tileRequest = request("/limited");
+        tileRequest.setRawHeader("X-Tile", QByteArray::number(i));
+        replies << manager->get(tileRequest);
+        connect(replies.last(), SIGNAL(finished()), this, SLOT(replyFinished()));
+    }
+    QVERIFY(waitForReplies(count));
+
+    QCOMPARE(server->error, QString());
+    QCOMPARE(server->connectionCount, 1);
+    QCOMPARE(server->requestCount, count);
+    QVERIFY(server->maxOpenStreams <= 2);
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(replies.at(i)->error(), QNetworkReply::NoError);
+        QCOMPARE(replies.at(i)->rawHeader("x-tile"), QByteArray::number(i));
+        replies.at(i)->deleteLater();
+    }
+}
+
+void tst_Http2::downloadFlowControl()
+{
+    // more than the client's stream window, which it has to reopen
+    const int size = 4 * 1024 * 1024;
+    server->bodySize = size;
+    QNetworkReply *reply = manager->get(request("/large"));
+    connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    QVERIFY(waitForReplies(1));
+
+    QCOMPARE(server->error, QString());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QVERIFY(server->windowUpdates > 0);
+    const QByteArray data = reply->readAll();
+    QCOMPARE(data.size(), size);
+    QVERIFY(data == Http2TestServer::body(1, size));
+    reply->deleteLater();
+}
+
+void tst_Http2::uploadFlowControl()
+{
+    // the server only takes 1000 bytes at a time
+    server->initialWindowSize = 1000;
+    QByteArray data(100 * 1024, 'x');
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = char('a' + i % 26);
+
+    QNetworkRequest postRequest = request("/upload");
+    postRequest.setHeader(QNetworkRequest::ContentTypeHeader, "application/octet-stream");
+    QNetworkReply *reply = manager->post(postRequest, data);
+    connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    QVERIFY(waitForReplies(1));
+
+    QCOMPARE(server->error, QString());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QVERIFY(server->uploadedData == data);
+    QVERIFY(reply->readAll() == data);
+    reply->deleteLater();
+}
+
+void tst_Http2::goAway()
+{
+    // the server stops after the third request; the rest goes over a new connection
+    const int count = 10;
+    server->goAwayAfter = 3;
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < count; ++i) {
+        QNetworkRequest tileRequest = request("/goaway");
+        tileRequest.setRawHeader("X-Tile", QByteArray::number(i));
+        replies << manager->get(tileRequest);
+        connect(replies.last(), SIGNAL(finished()), this, SLOT(replyFinished()));
+    }
+    QVERIFY(waitForReplies(count));
+
+    QCOMPARE(server->error, QString());
+    QCOMPARE(server->connectionCount, 2);
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(replies.at(i)->error(), QNetworkReply::NoError);
+        QCOMPARE(replies.at(i)->rawHeader("x-tile"), QByteArray::number(i));
+        replies.at(i)->deleteLater();
+    }
+}
+
+void tst_Http2::huffmanEncodedHeaders()
+{
+    // the first response of RFC 7541, C.6.1
+    server->fixedHeaderBlock = QByteArray::fromHex(
+                "488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1bff6e919d29ad171863c78f0b97c8e9ae82ae43d3");
+    server->bodySize = 0;
+    QNetworkReply *reply = manager->get(request("/huffman"));
+    connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    QVERIFY(waitForReplies(1));
+
+    QCOMPARE(server->error, QString());
+    QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 302);
+    QCOMPARE(reply->rawHeader("cache-control"), QByteArray("private"));
+    QCOMPARE(reply->rawHeader("date"), QByteArray("Mon, 21 Oct 2013 20:13:21 GMT"));
+    QCOMPARE(reply->rawHeader("location"), QByteArray("https://www.example.com"));
+    reply->deleteLater();
+}
+
+void tst_Http2::oversizedHeaderBlock()
+{
+    // more CONTINUATION frames than the client is willing to buffer
+    server->fixedHeaderBlock = QByteArray(300 * 1024, char(0x88));
+    QNetworkReply *reply = manager->get(request("/oversized"));
+    connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    QVERIFY(waitForReplies(1));
+
+    QCOMPARE(server->error, QString());
+    QCOMPARE(server->maxHeaderListSize, quint32(256 * 1024));
+    QCOMPARE(reply->error(), QNetworkReply::ProtocolFailure);
+    QTRY_COMPARE(server->goAwayErrorCode, qint64(0xb)); // ENHANCE_YOUR_CALM
+    reply->deleteLater();
+}
+
+void tst_Http2::oversizedHeaderList()
+{
+    // A small block that adds a 4000 byte field to the table and then
+    // refers to it a hundred times, which decodes to more than 256K.
+    QByteArray block;
+    block += char(0x88);                           // :status: 200
+    block += char(0x40);                           // literal with indexing, new name
+    block += char(5);
+    block += "x-big";
+    block += char(0x7f);                           // value length 4000 = 127 + 3873
+    block += char(0x80 | (3873 & 0x7f));
+    block += char(3873 >> 7);
+    block += QByteArray(4000, 'x');
+    block += QByteArray(100, char(0x80 | 62));     // indexed, the first dynamic entry
+    server->fixedHeaderBlock = block;
+
+    QNetworkReply *reply = manager->get(request("/bomb"));
+    connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    QVERIFY(waitForReplies(1));
+
+    QCOMPARE(server->error, QString());
+    QCOMPARE(reply->error(), QNetworkReply::ProtocolFailure);
+    QTRY_COMPARE(server->goAwayErrorCode, qint64(0xb)); // ENHANCE_YOUR_CALM
+    reply->deleteLater();
+}
+
+QTEST_MAIN(tst_Http2)
+
+#include "tst_http2.moc"
@@ -0,0 +1,5 @@
+CONFIG += testcase
+CONFIG += parallel_test
+TARGET = tst_qnetworkindexeddiskcache
+QT = core network testlib
+SOURCES  += tst_qnetworkindexeddiskcache.cpp
@@ -400,6 +400,13 @@ private Q_SLOTS:
     void getFromHttpIntoBuffer2_data();
     void getFromHttpIntoBuffer2();
     void getFromHttpIntoBufferCanReadLine();
+    void getFromHttpIntoUserBuffer();
+    void getFromHttpIntoFile_data();
+    void getFromHttpIntoFile();
+    void getFromHttpIntoFileNotFound();
+    void getFromHttpIntoFileUnwritable();
+    void getFromHttpInPriorityOrder();
+    void httpTimingsAndStatistics();
 
     void ioGetFromHttpWithoutContentLength();
 
@@ -6454,6 +6461,279 @@ void tst_QNetworkReply::getFromHttpIntoBufferCanReadLine()
     QVERIFY(!reply->canReadLine());
 }
 
+static void userDownloadBufferDeleter(char *ptr)
+{
+    delete[] ptr;
+}
+
+void tst_QNetworkReply::getFromHttpIntoUserBuffer()
+{
+    const int dataSize = 64 * 1024;
+    QByteArray header = "HTTP/1.0 200 OK\r\nContent-Length: " + QByteArray::number(dataSize) + "\r\n\r\n";
+    QByteArray data(dataSize, '@');
+    MiniHttpServer server(header + data);
+    server.doClose = true;
+
+    QSharedPointer<char> buffer(new char[dataSize], userDownloadBufferDeleter);
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    request.setAttribute(QNetworkRequest::MaximumDownloadBufferSizeAttribute, dataSize);
+    request.setAttribute(QNetworkRequest::UserDownloadBufferAttribute, QVariant::fromValue(buffer));
+    QNetworkReplyPtr reply(manager.get(request));
+
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QSharedPointer<char> downloadBuffer =
+            reply->attribute(QNetworkRequest::DownloadBufferAttribute).value<QSharedPointer<char> >();
+    QCOMPARE(downloadBuffer.data(), buffer.data());
+    QCOMPARE(QByteArray(buffer.data(), dataSize), data);
+    QCOMPARE(reply->readAll(), data);
+}
+
+void tst_QNetworkReply::getFromHttpIntoFile_data()
+{
+    QTest::addColumn<QByteArray>("header");
+    QTest::addColumn<int>("dataSize");
+
+    QTest::newRow("content-length") << QByteArray("HTTP/1.0 200 OK\r\nContent-Length: 300000\r\n\r\n") << 300000;
+    QTest::newRow("no-content-length") << QByteArray("HTTP/1.0 200 OK\r\n\r\n") << 300000;
+    QTest::newRow("empty") << QByteArray("HTTP/1.0 200 OK\r\nContent-Length: 0\r\n\r\n") << 0;
+}
+
+void tst_QNetworkReply::getFromHttpIntoFile()
+{
+    QFETCH(QByteArray, header);
+    QFETCH(int, dataSize);
+
+    QByteArray data;
+    for (int i = 0; i < dataSize; ++i)
+        data.append(char('a' + i % 26));
+    MiniHttpServer server(header + data);
+    server.doClose = true;
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.path() + "/download";
+
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    request.setAttribute(QNetworkRequest::DownloadFileNameAttribute, fileName);
+    QNetworkReplyPtr reply(manager.get(request));
+    QSignalSpy progressSpy(reply.data(), SIGNAL(downloadProgress(qint64,qint64)));
+
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->attribute(QNetworkRequest::DownloadFileNameAttribute).toString(), fileName);
+    QCOMPARE(reply->bytesAvailable(), qint64(0));
+    QVERIFY(reply->readAll().isEmpty());
+
+    QVERIFY(!progressSpy.isEmpty());
+    QCOMPARE(progressSpy.last().at(0).toLongLong(), qint64(dataSize));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.size(), qint64(dataSize));
+    QVERIFY(file.readAll() == data);
+}
+
+void tst_QNetworkReply::getFromHttpIntoFileNotFound()
+{
+    // Only successful responses go to the file, anything else stays readable.
+    MiniHttpServer server("HTTP/1.0 404 Not Found\r\nContent-Length: 9\r\n\r\nnot found");
+    server.doClose = true;
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.path() + "/download";
+
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    request.setAttribute(QNetworkRequest::DownloadFileNameAttribute, fileName);
+    QNetworkReplyPtr reply(manager.get(request));
+
+    QVERIFY2(waitForFinish(reply) == Failure, msgWaitForFinished(reply));
+
+    QCOMPARE(reply->error(), QNetworkReply::ContentNotFoundError);
+    QVERIFY(!reply->attribute(QNetworkRequest::DownloadFileNameAttribute).isValid());
+    QCOMPARE(reply->readAll(), QByteArray("not found"));
+    QVERIFY(!QFile::exists(fileName));
+}
+
+void tst_QNetworkReply::getFromHttpIntoFileUnwritable()
+{
+    MiniHttpServer server("HTTP/1.0 200 OK\r\nContent-Length: 5\r\n\r\nhello");
+    server.doClose = true;
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.path() + "/does/not/exist";
+
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    request.setAttribute(QNetworkRequest::DownloadFileNameAttribute, fileName);
+    QNetworkReplyPtr reply(manager.get(request));
+
+    QVERIFY2(waitForFinish(reply) == Failure, msgWaitForFinished(reply));
+
+    QCOMPARE(reply->error(), QNetworkReply::UnknownContentError);
+    QVERIFY(!QFile::exists(fileName));
+}
+
+
+// Records the paths of the requests it receives, one at a time, and holds
+// back the response to the first one until release() is called.
+class QueueOrderHttpServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    QStringList paths;
+
+    QueueOrderHttpServer() : heldSocket(0), held(true)
+    {
+        listen(QHostAddress::LocalHost);
+    }
+
+    void release()
+    {
+        held = false;
+        if (QTcpSocket *socket = heldSocket) {
+            heldSocket = 0;
+            respond(socket);
+            serve(socket);
+        }
+    }
+
+protected:
+    void incomingConnection(qintptr socketDescriptor)
+    {
+        QTcpSocket *socket = new QTcpSocket(this);
+        socket->setSocketDescriptor(socketDescriptor);
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readyReadSlot()));
+    }
+
+private slots:
+    void readyReadSlot()
+    {
+        QTcpSocket *socket = static_cast<QTcpSocket *>(sender());
+        received[socket] += socket->readAll();
+        serve(socket);
+    }
+
+private:
+    void serve(QTcpSocket *socket)
+    {
+        QByteArray &data = received[socket];
+        int end;
+        while (!heldSocket && (end = data.indexOf("\r\n\r\n")) != -1) {
+            const QByteArray requestLine = data.left(data.indexOf("\r\n"));
+            paths << QString::fromLatin1(requestLine.split(' ').value(1));
+            data.remove(0, end + 4);
+            if (held)
+                heldSocket = socket;
+            else
+                respond(socket);
+        }
+    }
+
+    void respond(QTcpSocket *socket)
+    {
+        socket->write("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+    }
+
+    QHash<QTcpSocket *, QByteArray> received;
+    QTcpSocket *heldSocket;
+    bool held;
+};
+
+void tst_QNetworkReply::getFromHttpInPriorityOrder()
+{
+    QueueOrderHttpServer server;
+    QVERIFY(server.isListening());
+    const QString baseUrl = "http://127.0.0.1:" + QString::number(server.serverPort()) + '/';
+
+    QList<QNetworkReplyPtr> replies;
+
+    // keep the only channel busy while the others are queued
+    QNetworkRequest request(baseUrl + "first");
+    request.setAttribute(QNetworkRequest::HttpConnectionsPerHostAttribute, 1);
+    replies << QNetworkReplyPtr(manager.get(request));
+    QTRY_COMPARE(server.paths.count(), 1);
+
+    request.setUrl(baseUrl + "low");
+    request.setPriority(QNetworkRequest::LowPriority);
+    replies << QNetworkReplyPtr(manager.get(request));
+    request.setUrl(baseUrl + "normal");
+    request.setPriority(QNetworkRequest::NormalPriority);
+    replies << QNetworkReplyPtr(manager.get(request));
+    request.setUrl(baseUrl + "high");
+    request.setPriority(QNetworkRequest::HighPriority);
+    replies << QNetworkReplyPtr(manager.get(request));
+    request.setUrl(baseUrl + "level0");
+    request.setAttribute(QNetworkRequest::HttpPriorityLevelAttribute, 0);
+    replies << QNetworkReplyPtr(manager.get(request));
+    request.setUrl(baseUrl + "moved");
+    replies << QNetworkReplyPtr(manager.get(request));
+    replies.last()->setPriorityLevel(10);
+    QCOMPARE(replies.last()->request().attribute(QNetworkRequest::HttpPriorityLevelAttribute).toInt(), 10);
+    request.setUrl(baseUrl + "aborted");
+    QNetworkReplyPtr aborted(manager.get(request));
+    aborted->abort();
+
+    // let the HTTP thread queue everything before the channel becomes free
+    QTest::qWait(200);
+    server.release();
+
+    for (int i = 0; i < replies.count(); ++i)
+        QVERIFY2(waitForFinish(replies[i]) == Success, msgWaitForFinished(replies[i]));
+
+    // with a single channel, the requests are sent one at a time in queue order
+    QCOMPARE(server.paths, QStringList() << "/first" << "/level0" << "/high" << "/normal" << "/low" << "/moved");
+}
+
+void tst_QNetworkReply::httpTimingsAndStatistics()
+{
+    const QByteArray response = "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello";
+    MiniHttpServer server(response);
+    server.doClose = false;
+    server.multiple = true;
+
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/timings"));
+    request.setAttribute(QNetworkRequest::HttpConnectionsPerHostAttribute, 1);
+
+    // the first request opens the connection, the second one reuses it
+    QNetworkReplyPtr first(manager.get(request));
+    QVERIFY2(waitForFinish(first) == Success, msgWaitForFinished(first));
+    QNetworkReplyPtr second(manager.get(request));
+    QVERIFY2(waitForFinish(second) == Success, msgWaitForFinished(second));
+    QCOMPARE(server.totalConnections, 1);
+
+    const QVariantMap timings = first->attribute(QNetworkRequest::HttpTimingsAttribute).toMap();
+    QCOMPARE(timings.value("queued").toDouble(), 0.0);
+    QVERIFY(!timings.value("connectionReused").toBool());
+    const char * const stages[] = { "connectStart", "domainLookupEnd", "connectEnd",
+                                    "requestStart", "responseStart", "responseEnd" };
+    double last = 0;
+    for (uint i = 0; i < sizeof(stages) / sizeof(stages[0]); ++i) {
+        QVERIFY2(timings.contains(stages[i]), stages[i]);
+        QVERIFY2(timings.value(stages[i]).toDouble() >= last, stages[i]);
+        last = timings.value(stages[i]).toDouble();
+    }
+    // the connection may be opened before or after the request is handed to its channel
+    QVERIFY(timings.contains("dequeued"));
+    QVERIFY(timings.value("dequeued").toDouble() <= timings.value("requestStart").toDouble());
+    QVERIFY(!timings.contains("secureConnectionEnd"));
+
+    const QVariantMap reusedTimings = second->attribute(QNetworkRequest::HttpTimingsAttribute).toMap();
+    QVERIFY(reusedTimings.value("connectionReused").toBool());
+    QVERIFY(!reusedTimings.contains("connectStart"));
+    QVERIFY(reusedTimings.contains("responseEnd"));
+
+    const QVariantMap statistics = second->attribute(QNetworkRequest::HttpConnectionStatisticsAttribute).toMap();
+    QCOMPARE(statistics.value("connectionsOpened").toInt(), 1);
+    QCOMPARE(statistics.value("requestsStarted").toInt(), 2);
+    QCOMPARE(statistics.value("requestsReused").toInt(), 1);
+    QCOMPARE(statistics.value("maxRequestsInFlight").toInt(), 1);
+    QVERIFY(statistics.value("bytesSent").toLongLong() > 0);
+    QCOMPARE(statistics.value("bytesReceived").toLongLong(), qint64(2 * response.size()));
+}
 
 
 // Is handled somewhere else too, introduced this special test to have it more accessible
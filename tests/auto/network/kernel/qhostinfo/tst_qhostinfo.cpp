@@ -132,6 +132,7 @@ private slots:
     void multipleDifferentLookups();
 
     void cache();
+    void cacheTtl();
 
     void abortHostLookup();
     void abortHostLookupInDifferentThread();
@@ -594,6 +595,45 @@ void tst_QHostInfo::cache()
     QCOMPARE(lookupsDoneCounter, 2);
 }
 
+void tst_QHostInfo::cacheTtl()
+{
+    QFETCH_GLOBAL(bool, cache);
+    if (!cache)
+        return; // test makes only sense when cache enabled
+
+    QHostInfo info;
+    info.setAddresses(QList<QHostAddress>() << QHostAddress(QHostAddress::LocalHost));
+
+    // an entry with a TTL of one second expires after a second,
+    // not after the default maximum age
+    qt_qhostinfo_cache_inject("ttl-one" TEST_DOMAIN, info, 1);
+    bool valid = false;
+    int id = -1;
+    QHostInfo result = qt_qhostinfo_lookup("ttl-one" TEST_DOMAIN, this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(valid);
+    QCOMPARE(result.addresses(), info.addresses());
+
+    QTest::qWait(1100);
+    result = qt_qhostinfo_lookup("ttl-one" TEST_DOMAIN, this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(!valid);
+    QHostInfo::abortHostLookup(id);
+
+    // a TTL of zero means the answer must not be cached at all
+    qt_qhostinfo_cache_inject("ttl-zero" TEST_DOMAIN, info, 0);
+    result = qt_qhostinfo_lookup("ttl-zero" TEST_DOMAIN, this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(!valid);
+    QHostInfo::abortHostLookup(id);
+
+    // without a TTL the default maximum age applies
+    qt_qhostinfo_cache_inject("ttl-unknown" TEST_DOMAIN, info);
+    QTest::qWait(1100);
+    result = qt_qhostinfo_lookup("ttl-unknown" TEST_DOMAIN, this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(valid);
+    QCOMPARE(result.addresses(), info.addresses());
+
+    qt_qhostinfo_clear_cache();
+}
+
 void tst_QHostInfo::resultsReady(const QHostInfo &hi)
 {
     lookupDone = true;
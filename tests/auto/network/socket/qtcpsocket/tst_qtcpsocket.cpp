@@ -48,6 +48,7 @@
 #else
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <netinet/in.h>
 #include <fcntl.h>
 #include <unistd.h>
 #define SOCKET int
@@ -70,6 +71,7 @@
 #include <QStringList>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QTemporaryFile>
 #ifndef QT_NO_SSL
 #include <QSslSocket>
 #endif
@@ -173,6 +175,8 @@ private slots:
     void nestedEventLoopInErrorSlot();
 #ifndef Q_OS_WIN
     void connectToLocalHostNoService();
+    void connectWithUnreachableFamily_data();
+    void connectWithUnreachableFamily();
 #endif
     void waitForConnectedInHostLookupSlot();
     void waitForConnectedInHostLookupSlot2();
@@ -204,6 +208,8 @@ private slots:
     void qtbug14268_peek();
 
     void setSocketOption();
+    void writeFile();
+    void writeFileTruncated();
 
 
 protected slots:
@@ -1897,6 +1903,84 @@ void tst_QTcpSocket::connectToLocalHostNoService()
     QCOMPARE(socket->state(), QTcpSocket::UnconnectedState);
     delete socket;
 }
+
+void tst_QTcpSocket::connectWithUnreachableFamily_data()
+{
+    QTest::addColumn<int>("unreachableProtocol");
+
+    QTest::newRow("ipv6-unreachable") << int(QAbstractSocket::IPv6Protocol);
+    QTest::newRow("ipv4-unreachable") << int(QAbstractSocket::IPv4Protocol);
+}
+
+void tst_QTcpSocket::connectWithUnreachableFamily()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return; // the race only happens for direct connections
+    QFETCH(int, unreachableProtocol);
+
+    const QHostAddress unreachable(unreachableProtocol == QAbstractSocket::IPv6Protocol
+                                   ? QHostAddress::LocalHostIPv6 : QHostAddress::LocalHost);
+    const QHostAddress reachable(unreachableProtocol == QAbstractSocket::IPv6Protocol
+                                 ? QHostAddress::LocalHost : QHostAddress::LocalHostIPv6);
+
+    QTcpServer server;
+    if (!server.listen(reachable))
+        QSKIP("Both IPv4 and IPv6 loopback are needed for this test");
+
+    // A listening socket on the other family whose accept queue is full:
+    // the kernel drops further SYNs, so connecting to it just hangs.
+    int fd = ::socket(unreachableProtocol == QAbstractSocket::IPv6Protocol ? AF_INET6 : AF_INET,
+                      SOCK_STREAM, 0);
+    QVERIFY(fd != -1);
+    int ok = -1;
+    if (unreachableProtocol == QAbstractSocket::IPv6Protocol) {
+        int on = 1;
+        ::setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, (char *)&on, sizeof(on));
+        sockaddr_in6 sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sin6_family = AF_INET6;
+        sa.sin6_port = htons(server.serverPort());
+        sa.sin6_addr = in6addr_loopback;
+        ok = ::bind(fd, (sockaddr *)&sa, sizeof(sa));
+    } else {
+        sockaddr_in sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(server.serverPort());
+        sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ok = ::bind(fd, (sockaddr *)&sa, sizeof(sa));
+    }
+    if (ok == -1 || ::listen(fd, 0) == -1) {
+        ::close(fd);
+        QSKIP("Could not listen on both loopback addresses with the same port");
+    }
+    QTcpSocket fillers[3];
+    for (int i = 0; i < 3; ++i)
+        fillers[i].connectToHost(unreachable, server.serverPort());
+    QTest::qWait(200);
+
+    // The unreachable address comes first, as a resolver preferring that
+    // family would return it.
+    const QString hostName = QStringLiteral("dualstack.qt-project.invalid");
+    QHostInfo info;
+    info.setHostName(hostName);
+    info.setAddresses(QList<QHostAddress>() << unreachable << reachable);
+    qt_qhostinfo_cache_inject(hostName, info);
+
+    QTcpSocket socket;
+    QElapsedTimer timer;
+    timer.start();
+    socket.connectToHost(hostName, server.serverPort());
+    QTRY_COMPARE_WITH_TIMEOUT(socket.state(), QAbstractSocket::ConnectedState, 5000);
+    QVERIFY(timer.elapsed() < 5000);
+    QCOMPARE(socket.peerAddress(), reachable);
+    QTRY_VERIFY(server.hasPendingConnections());
+
+    for (int i = 0; i < 3; ++i)
+        fillers[i].abort();
+    ::close(fd);
+}
 #endif
 
 //----------------------------------------------------------------------------------
@@ -2823,5 +2907,90 @@ void tst_QTcpSocket::setSocketOption()
     QVERIFY(v.isValid() && v.toInt() == 32);
 }
 
+void tst_QTcpSocket::writeFile()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QByteArray contents;
+    for (int i = 0; i < 100000; ++i)
+        contents += QByteArray::number(i % 997).rightJustified(4, '0');
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+    QVERIFY(file.flush());
+
+    SocketPair socketPair;
+    QVERIFY(socketPair.create());
+    QTcpSocket *outgoing = socketPair.endPoints[0];
+    QTcpSocket *incoming = socketPair.endPoints[1];
+
+    // the file region goes out between the data written around it
+    const qint64 offset = 10;
+    const qint64 size = contents.size() - 2 * offset;
+    QCOMPARE(outgoing->write("head"), qint64(4));
+    QVERIFY(outgoing->writeFile(&file, offset, size));
+    QVERIFY(!outgoing->writeFile(&file));
+    QCOMPARE(outgoing->write("tail"), qint64(4));
+    QCOMPARE(outgoing->bytesToWrite(), size + 8);
+
+    const QByteArray expected = "head" + contents.mid(offset, size) + "tail";
+    QByteArray received;
+    while (received.size() < expected.size()) {
+        outgoing->flush();
+        if (!incoming->bytesAvailable())
+            QVERIFY(incoming->waitForReadyRead(5000));
+        received += incoming->readAll();
+    }
+    QCOMPARE(received.size(), expected.size());
+    QVERIFY(received == expected);
+    QCOMPARE(outgoing->bytesToWrite(), qint64(0));
+
+    // the rest of the file
+    QVERIFY(outgoing->writeFile(&file, size));
+    received.clear();
+    while (received.size() < contents.size() - size) {
+        outgoing->flush();
+        if (!incoming->bytesAvailable())
+            QVERIFY(incoming->waitForReadyRead(5000));
+        received += incoming->readAll();
+    }
+    QVERIFY(received == contents.mid(size));
+}
+
+void tst_QTcpSocket::writeFileTruncated()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    const QByteArray contents(1024 * 1024, 'x');
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+    QVERIFY(file.flush());
+
+    SocketPair socketPair;
+    QVERIFY(socketPair.create());
+    QTcpSocket *outgoing = socketPair.endPoints[0];
+    QTcpSocket *incoming = socketPair.endPoints[1];
+    QSignalSpy errorSpy(outgoing, SIGNAL(error(QAbstractSocket::SocketError)));
+
+    // the file shrinks while it is being written: what is left fails instead of spinning
+    QVERIFY(outgoing->writeFile(&file));
+    QVERIFY(file.resize(contents.size() / 2));
+    QByteArray received;
+    for (int i = 0; i < 1000 && errorSpy.isEmpty(); ++i) {
+        outgoing->flush();
+        incoming->waitForReadyRead(100);
+        received += incoming->readAll();
+    }
+    QCOMPARE(errorSpy.count(), 1);
+    QCOMPARE(outgoing->error(), QAbstractSocket::UnknownSocketError);
+    QCOMPARE(outgoing->state(), QAbstractSocket::UnconnectedState);
+    QVERIFY(received.size() <= contents.size() / 2);
+}
+
 QTEST_MAIN(tst_QTcpSocket)
 #include "tst_qtcpsocket.moc"
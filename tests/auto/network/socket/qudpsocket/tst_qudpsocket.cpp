@@ -95,6 +95,7 @@ private slots:
     void readLine();
     void pendingDatagramSize();
     void writeDatagram();
+    void readWriteDatagrams();
     void performance();
     void bindMode();
     void writeDatagramToNonExistingPeer_data();
@@ -729,6 +730,65 @@ void tst_QUdpSocket::writeDatagram()
     }
 }
 
+void tst_QUdpSocket::readWriteDatagrams()
+{
+    QUdpSocket server;
+#ifdef FORCE_SESSION
+    server.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+    QVERIFY2(server.bind(), server.errorString().toLatin1().constData());
+
+    QHostAddress serverAddress = QHostAddress::LocalHost;
+    if (!(server.localAddress() == QHostAddress::AnyIPv4 || server.localAddress() == QHostAddress::AnyIPv6))
+        serverAddress = server.localAddress();
+
+    QUdpSocket client;
+#ifdef FORCE_SESSION
+    client.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+
+    // more than one batch of the native engine, including an empty
+    // datagram and one that does not fit into the receive slot
+    const int count = 100;
+    const int slotSize = 64;
+    QList<QByteArray> datagrams;
+    for (int i = 0; i < count; ++i)
+        datagrams << QByteArray(i % 10 ? i : 0, char('a' + i % 26));
+    datagrams[50] = QByteArray(slotSize * 2, 'x');
+
+    QSignalSpy bytesspy(&client, SIGNAL(bytesWritten(qint64)));
+    QCOMPARE(client.writeDatagrams(datagrams, serverAddress, server.localPort()), count);
+    QCOMPARE(bytesspy.count(), 1);
+    qint64 total = 0;
+    foreach (const QByteArray &datagram, datagrams)
+        total += datagram.size();
+    QCOMPARE(bytesspy.at(0).at(0).toLongLong(), total);
+
+    QByteArray buffer(count * slotSize, '\0');
+    QVector<qint64> sizes(count);
+    QVector<QHostAddress> hosts(count);
+    QVector<quint16> ports(count);
+    int received = 0;
+    while (received < count) {
+        if (!server.hasPendingDatagrams() && !server.waitForReadyRead(5000))
+            QSKIP(QString("UDP packet lost after %1 datagrams, unable to complete the test.").arg(received).toLatin1().data());
+        const int n = server.readDatagrams(buffer.data() + received * slotSize, slotSize,
+                                           count - received, sizes.data() + received,
+                                           hosts.data() + received, ports.data() + received);
+        QVERIFY(n >= 0);
+        received += n;
+    }
+    QVERIFY(!server.hasPendingDatagrams());
+    QCOMPARE(server.readDatagrams(buffer.data(), slotSize, 1, sizes.data()), 0);
+
+    for (int i = 0; i < count; ++i) {
+        const QByteArray expected = datagrams.at(i).left(slotSize);
+        QCOMPARE(sizes.at(i), qint64(expected.size()));
+        QCOMPARE(buffer.mid(i * slotSize, expected.size()), expected);
+        QCOMPARE(ports.at(i), client.localPort());
+    }
+}
+
 void tst_QUdpSocket::performance()
 {
     QByteArray arr(8192, '@');
@@ -59,6 +59,7 @@
 #include "private/qsslsocket_openssl_p.h"
 #include "private/qsslsocket_openssl_symbols_p.h"
 #include "private/qsslconfiguration_p.h"
+#include "private/qsslcontext_p.h"
 #endif
 
 #include "../../../network-settings.h"
@@ -142,6 +143,7 @@ private slots:
     void protocol();
     void protocolServerSide_data();
     void protocolServerSide();
+    void resumeSessionFromCache();
     void setCaCertificates();
     void setLocalCertificate();
     void localCertificateChain();
@@ -184,6 +186,7 @@ private slots:
     void ignoreSslErrorsListWithSlot();
     void readFromClosedSocket();
     void writeBigChunk();
+    void writeFile();
     void blacklistedCertificates();
     void versionAccessors();
     void sslOptions();
@@ -1172,6 +1175,122 @@ void tst_QSslSocket::protocolServerSide()
     QCOMPARE(client->isEncrypted(), works);
 }
 
+void tst_QSslSocket::resumeSessionFromCache()
+{
+    if (!QSslSocket::supportsSsl())
+        return;
+
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QSslSessionCache *cache = QSslSessionCache::instance();
+    cache->clear();
+    cache->resetStatistics();
+
+    // a certificate the clients can verify without errors
+    const QList<QSslCertificate> serverCertificates =
+        QSslCertificate::fromPath(SRCDIR "certs/selfsigned-127.0.0.1.crt");
+    QVERIFY(!serverCertificates.isEmpty());
+    SslServer server(SRCDIR "certs/selfsigned-127.0.0.1.key", SRCDIR "certs/selfsigned-127.0.0.1.crt");
+    QVERIFY(server.listen());
+
+    for (int i = 0; i < 2; ++i) {
+        QEventLoop loop;
+        QTimer::singleShot(5000, &loop, SLOT(quit()));
+
+        QSslSocketPtr client(new QSslSocket);
+        socket = client.data();
+        client->setCaCertificates(serverCertificates);
+        connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), &loop, SLOT(quit()));
+        connect(socket, SIGNAL(encrypted()), &loop, SLOT(quit()));
+
+        client->connectToHostEncrypted(QHostAddress(QHostAddress::LocalHost).toString(), server.serverPort());
+        loop.exec();
+
+        QVERIFY(client->isEncrypted());
+        // the first handshake is a full one, the second resumes the session it left behind
+        QCOMPARE(QSslConfigurationPrivate::peerSessionWasShared(client->sslConfiguration()), i == 1);
+        client->disconnectFromHost();
+    }
+
+    QSslSessionCache::Statistics stats = cache->statistics();
+    QCOMPARE(stats.lookups, qint64(2));
+    QCOMPARE(stats.hits, qint64(1));
+    QCOMPARE(stats.resumptions, qint64(1));
+
+    // Sessions of handshakes with ignored errors are never stored, since
+    // resuming them would skip the verification of the server.
+    cache->clear();
+    cache->resetStatistics();
+    for (int i = 0; i < 2; ++i) {
+        QEventLoop loop;
+        QTimer::singleShot(5000, &loop, SLOT(quit()));
+
+        QSslSocketPtr client(new QSslSocket);
+        socket = client.data();
+        connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), &loop, SLOT(quit()));
+        connect(socket, SIGNAL(sslErrors(QList<QSslError>)), this, SLOT(ignoreErrorSlot()));
+        connect(socket, SIGNAL(encrypted()), &loop, SLOT(quit()));
+
+        client->connectToHostEncrypted(QHostAddress(QHostAddress::LocalHost).toString(), server.serverPort());
+        loop.exec();
+
+        QVERIFY(client->isEncrypted());
+        QVERIFY(!QSslConfigurationPrivate::peerSessionWasShared(client->sslConfiguration()));
+        client->disconnectFromHost();
+    }
+    stats = cache->statistics();
+    QCOMPARE(stats.lookups, qint64(2));
+    QCOMPARE(stats.hits, qint64(0));
+    QCOMPARE(stats.insertions, qint64(0));
+
+    // The next socket that does not ignore them still verifies the server:
+    // without the CA certificate the handshake fails, with it a full one is done.
+    for (int i = 0; i < 2; ++i) {
+        QEventLoop loop;
+        QTimer::singleShot(5000, &loop, SLOT(quit()));
+
+        QSslSocketPtr client(new QSslSocket);
+        socket = client.data();
+        if (i == 1)
+            client->setCaCertificates(serverCertificates);
+        QSignalSpy sslErrorsSpy(socket, SIGNAL(sslErrors(QList<QSslError>)));
+        connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), &loop, SLOT(quit()));
+        connect(socket, SIGNAL(encrypted()), &loop, SLOT(quit()));
+
+        client->connectToHostEncrypted(QHostAddress(QHostAddress::LocalHost).toString(), server.serverPort());
+        loop.exec();
+
+        QCOMPARE(client->isEncrypted(), i == 1);
+        QCOMPARE(sslErrorsSpy.count(), i == 1 ? 0 : 1);
+        QVERIFY(!QSslConfigurationPrivate::peerSessionWasShared(client->sslConfiguration()));
+        client->disconnectFromHost();
+    }
+    stats = cache->statistics();
+    QCOMPARE(stats.lookups, qint64(4));
+    QCOMPARE(stats.hits, qint64(0));
+    QCOMPARE(stats.insertions, qint64(1));
+
+    // opting out of session sharing must not touch the cache
+    QEventLoop loop;
+    QTimer::singleShot(5000, &loop, SLOT(quit()));
+    QSslSocketPtr client(new QSslSocket);
+    socket = client.data();
+    QSslConfiguration configuration = client->sslConfiguration();
+    configuration.setSslOption(QSsl::SslOptionDisableSessionSharing, true);
+    configuration.setCaCertificates(serverCertificates);
+    client->setSslConfiguration(configuration);
+    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), &loop, SLOT(quit()));
+    connect(socket, SIGNAL(encrypted()), &loop, SLOT(quit()));
+    client->connectToHostEncrypted(QHostAddress(QHostAddress::LocalHost).toString(), server.serverPort());
+    loop.exec();
+
+    QVERIFY(client->isEncrypted());
+    QVERIFY(!QSslConfigurationPrivate::peerSessionWasShared(client->sslConfiguration()));
+    QCOMPARE(cache->statistics().lookups, qint64(4));
+}
+
 void tst_QSslSocket::setCaCertificates()
 {
     if (!QSslSocket::supportsSsl())
@@ -2236,6 +2355,48 @@ void tst_QSslSocket::writeBigChunk()
     socket->close();
 }
 
+void tst_QSslSocket::writeFile()
+{
+    if (!QSslSocket::supportsSsl())
+        return;
+
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QByteArray data(4 * 1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = char(i * 7);
+    QCOMPARE(file.write(data), qint64(data.size()));
+    QVERIFY(file.flush());
+
+    SslServer server;
+    QVERIFY(server.listen());
+
+    QEventLoop loop;
+    QTimer::singleShot(5000, &loop, SLOT(quit()));
+    QSslSocketPtr client(new QSslSocket);
+    socket = client.data();
+    connect(socket, SIGNAL(sslErrors(QList<QSslError>)), this, SLOT(ignoreErrorSlot()));
+    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), &loop, SLOT(quit()));
+    connect(socket, SIGNAL(encrypted()), &loop, SLOT(quit()));
+    client->connectToHostEncrypted(QHostAddress(QHostAddress::LocalHost).toString(), server.serverPort());
+    loop.exec();
+    QVERIFY(client->isEncrypted());
+    QVERIFY(server.socket);
+
+    // the region is read block by block as it is sent, but counted as a whole
+    QVERIFY(client->writeFile(&file, 1, data.size() - 2));
+    QCOMPARE(client->bytesToWrite(), qint64(data.size() - 2));
+    client->disconnectFromHost();
+
+    QTRY_COMPARE_WITH_TIMEOUT(server.socket->bytesAvailable(), qint64(data.size() - 2), 30000);
+    QVERIFY(server.socket->readAll() == data.mid(1, data.size() - 2));
+    QTRY_COMPARE(client->state(), QAbstractSocket::UnconnectedState);
+}
+
 void tst_QSslSocket::blacklistedCertificates()
 {
     QFETCH_GLOBAL(bool, setProxy);
@@ -55,6 +55,10 @@ private slots:
     void fromUnicode() const;
     void toUnicode_data() const;
     void toUnicode() const;
+    void utf8FromUnicode_data() const;
+    void utf8FromUnicode() const;
+    void utf8ToUnicode_data() const;
+    void utf8ToUnicode() const;
 };
 
 void tst_QTextCodec::codecForName() const
@@ -177,6 +181,57 @@ void tst_QTextCodec::toUnicode() const
 
 
 
+void tst_QTextCodec::utf8FromUnicode_data() const
+{
+    QTest::addColumn<QString>("file");
+
+    QTest::newRow("mixed") << QString("utf-8.txt");
+    QTest::newRow("russian") << QString("russian.txt");
+    QTest::newRow("chinese") << QString("chinese.txt");
+    QTest::newRow("names") << QString("names.txt");
+}
+
+void tst_QTextCodec::utf8FromUnicode() const
+{
+    QFETCH(QString, file);
+    QString testFile = QFINDTESTDATA(file);
+    QVERIFY2(!testFile.isEmpty(), qPrintable("cannot find test file " + file));
+    QFile f(testFile);
+    QVERIFY(f.open(QFile::ReadOnly));
+    QString s = QString::fromUtf8(f.readAll());
+    s = s + s + s;
+    s = s + s + s;
+
+    QTextCodec *codec = QTextCodec::codecForMib(106);
+    QBENCHMARK {
+        for (int i = 0; i < 10; i ++)
+            codec->fromUnicode(s);
+    }
+}
+
+void tst_QTextCodec::utf8ToUnicode_data() const
+{
+    utf8FromUnicode_data();
+}
+
+void tst_QTextCodec::utf8ToUnicode() const
+{
+    QFETCH(QString, file);
+    QString testFile = QFINDTESTDATA(file);
+    QVERIFY2(!testFile.isEmpty(), qPrintable("cannot find test file " + file));
+    QFile f(testFile);
+    QVERIFY(f.open(QFile::ReadOnly));
+    QByteArray data = f.readAll();
+    data = data + data + data;
+    data = data + data + data;
+
+    QTextCodec *codec = QTextCodec::codecForMib(106);
+    QBENCHMARK {
+        for (int i = 0; i < 10; i ++)
+            codec->toUnicode(data);
+    }
+}
+
 QTEST_MAIN(tst_QTextCodec)
 
 #include "main.moc"
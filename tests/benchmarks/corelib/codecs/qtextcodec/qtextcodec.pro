@@ -2,6 +2,6 @@ TARGET = tst_bench_qtextcodec
 QT = core testlib
 SOURCES += main.cpp
 
-TESTDATA = utf-8.txt
+TESTDATA = utf-8.txt russian.txt chinese.txt names.txt
 
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
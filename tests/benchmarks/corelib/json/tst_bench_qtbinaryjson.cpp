@@ -42,6 +42,7 @@
 #include <QtTest>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonarray.h>
 
 class BenchmarkQtBinaryJson: public QObject
 {
@@ -64,6 +65,15 @@ private Q_SLOTS:
 
     void jsonObjectInsert();
     void variantMapInsert();
+
+    void loadLargeDocument_data();
+    void loadLargeDocument();
+
+private:
+    QString largeBinaryFile();
+
+    QTemporaryDir tempDir;
+    QString largeFileName;
 };
 
 BenchmarkQtBinaryJson::BenchmarkQtBinaryJson(QObject *parent) : QObject(parent)
@@ -187,6 +197,69 @@ void BenchmarkQtBinaryJson::variantMapInsert()
     }
 }
 
+// writes a binary JSON document of about 100 MB, the first time it is needed
+QString BenchmarkQtBinaryJson::largeBinaryFile()
+{
+    if (!largeFileName.isEmpty())
+        return largeFileName;
+
+    QByteArray json("[");
+    for (int i = 0; i < 320000; ++i) {
+        if (i)
+            json += ',';
+        json += "{\"id\":" + QByteArray::number(i)
+                + ",\"name\":\"item number " + QByteArray::number(i)
+                + "\",\"enabled\":true,\"values\":[";
+        for (int j = 0; j < 20; ++j)
+            json += QByteArray::number(i + j + 0.5) + (j < 19 ? "," : "");
+        json += "],\"tags\":{\"first\":\"a\",\"second\":\"b\",\"third\":\"c\"}}";
+    }
+    json += ']';
+
+    QJsonDocument doc = QJsonDocument::fromJson(json);
+    if (doc.isNull())
+        return QString();
+
+    QFile file(tempDir.path() + QLatin1String("/large.bjson"));
+    if (!file.open(QFile::WriteOnly) || file.write(doc.toBinaryData()) < 0)
+        return QString();
+    largeFileName = file.fileName();
+    return largeFileName;
+}
+
+void BenchmarkQtBinaryJson::loadLargeDocument_data()
+{
+    QTest::addColumn<bool>("mapped");
+    QTest::addColumn<int>("validation");
+
+    QTest::newRow("read, validate") << false << int(QJsonDocument::Validate);
+    QTest::newRow("mapped, validate") << true << int(QJsonDocument::Validate);
+    QTest::newRow("mapped, validate on access") << true << int(QJsonDocument::ValidateOnAccess);
+}
+
+void BenchmarkQtBinaryJson::loadLargeDocument()
+{
+    // Example: load a large static table and look up a single entry
+    QFETCH(bool, mapped);
+    QFETCH(int, validation);
+
+    const QString fileName = largeBinaryFile();
+    QVERIFY(!fileName.isEmpty());
+
+    QBENCHMARK {
+        QJsonDocument doc;
+        if (mapped) {
+            doc = QJsonDocument::fromBinaryFile(fileName, QJsonDocument::DataValidation(validation));
+        } else {
+            QFile file(fileName);
+            QVERIFY(file.open(QFile::ReadOnly));
+            doc = QJsonDocument::fromBinaryData(file.readAll(), QJsonDocument::DataValidation(validation));
+        }
+        QJsonArray items = doc.array();
+        QCOMPARE(items.at(123456).toObject().value(QStringLiteral("id")).toInt(), 123456);
+    }
+}
+
 QTEST_MAIN(BenchmarkQtBinaryJson)
 #include "tst_bench_qtbinaryjson.moc"
 
@@ -43,6 +43,10 @@
 #include <qtest.h>
 #include <qtesteventloop.h>
 
+#ifdef Q_OS_UNIX
+#  include <unistd.h>
+#endif
+
 class PingPong : public QObject
 {
 public:
@@ -96,6 +100,75 @@ int EventTester::foo(int bar)
     return bar + 1;
 }
 
+class SocketNotifierReader : public QObject
+{
+    Q_OBJECT
+public:
+    SocketNotifierReader() : activated(false) {}
+    bool activated;
+
+public slots:
+    void readByte(int fd)
+    {
+        char c;
+        if (::read(fd, &c, 1) == 1)
+            activated = true;
+    }
+};
+
+class QueuedReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    QueuedReceiver() : received(0), expected(0) {}
+    int received;
+    int expected;
+
+protected:
+    bool event(QEvent *e)
+    {
+        if (e->type() != QEvent::User)
+            return QObject::event(e);
+        count();
+        return true;
+    }
+
+public slots:
+    void count()
+    {
+        if (++received == expected)
+            QTestEventLoop::instance().exitLoop();
+    }
+};
+
+class QueuedSender : public QThread
+{
+    Q_OBJECT
+public:
+    QueuedSender(QObject *receiver, int count, bool useSignals)
+        : receiver(receiver), count(count), useSignals(useSignals)
+    {}
+
+signals:
+    void ping();
+
+protected:
+    void run()
+    {
+        for (int i = 0; i < count; ++i) {
+            if (useSignals)
+                emit ping();
+            else
+                QCoreApplication::postEvent(receiver, new QEvent(QEvent::User));
+        }
+    }
+
+private:
+    QObject *receiver;
+    int count;
+    bool useSignals;
+};
+
 class EventsBench : public QObject
 {
     Q_OBJECT
@@ -109,6 +182,12 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+    void crossThreadPosting_data();
+    void crossThreadPosting();
+#ifdef Q_OS_UNIX
+    void socketNotifiers_data();
+    void socketNotifiers();
+#endif
 };
 
 void EventsBench::initTestCase()
@@ -182,6 +261,98 @@ void EventsBench::postEvent()
     }
 }
 
+void EventsBench::crossThreadPosting_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("useSignals");
+    // Queued signals take the lock-free posting path, plain posted events
+    // still go through the post event mutex.
+    QTest::newRow("1 thread, queued signals") << 1 << true;
+    QTest::newRow("1 thread, posted events") << 1 << false;
+    QTest::newRow("4 threads, queued signals") << 4 << true;
+    QTest::newRow("4 threads, posted events") << 4 << false;
+    QTest::newRow("16 threads, queued signals") << 16 << true;
+    QTest::newRow("16 threads, posted events") << 16 << false;
+}
+
+void EventsBench::crossThreadPosting()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, useSignals);
+
+    const int total = 100000;
+    QueuedReceiver receiver;
+    QList<QueuedSender *> senders;
+    for (int i = 0; i < threadCount; ++i) {
+        QueuedSender *sender = new QueuedSender(&receiver, total / threadCount, useSignals);
+        connect(sender, SIGNAL(ping()), &receiver, SLOT(count()), Qt::QueuedConnection);
+        senders << sender;
+    }
+
+    QBENCHMARK {
+        receiver.received = 0;
+        receiver.expected = (total / threadCount) * threadCount;
+        foreach (QueuedSender *sender, senders)
+            sender->start();
+        QTestEventLoop::instance().enterLoop(60);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        foreach (QueuedSender *sender, senders)
+            sender->wait();
+    }
+
+    qDeleteAll(senders);
+}
+
+#ifdef Q_OS_UNIX
+void EventsBench::socketNotifiers_data()
+{
+    QTest::addColumn<int>("notifierCount");
+    // Only one of the notifiers ever becomes active, the others measure how
+    // the cost of an event loop iteration scales with idle notifiers. Run with
+    // QT_EVENT_DISPATCHER_EPOLL=1 to compare against the epoll dispatcher.
+    QTest::newRow("1 notifier") << 1;
+    QTest::newRow("10 notifiers") << 10;
+    QTest::newRow("100 notifiers") << 100;
+    QTest::newRow("400 notifiers") << 400;
+}
+
+void EventsBench::socketNotifiers()
+{
+    QFETCH(int, notifierCount);
+
+    QVector<int> readFds;
+    QVector<int> writeFds;
+    QList<QSocketNotifier *> notifiers;
+    SocketNotifierReader reader;
+    for (int i = 0; i < notifierCount; ++i) {
+        int fds[2];
+        QVERIFY(::pipe(fds) == 0);
+        readFds << fds[0];
+        writeFds << fds[1];
+        QSocketNotifier *notifier = new QSocketNotifier(fds[0], QSocketNotifier::Read);
+        connect(notifier, SIGNAL(activated(int)), &reader, SLOT(readByte(int)));
+        notifiers << notifier;
+    }
+
+    const int activeFd = writeFds.last();
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            char c = 'x';
+            QCOMPARE(int(::write(activeFd, &c, 1)), 1);
+            reader.activated = false;
+            while (!reader.activated)
+                QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+        }
+    }
+
+    qDeleteAll(notifiers);
+    for (int i = 0; i < notifierCount; ++i) {
+        ::close(readFds.at(i));
+        ::close(writeFds.at(i));
+    }
+}
+#endif
+
 QTEST_MAIN(EventsBench)
 
 #include "main.moc"
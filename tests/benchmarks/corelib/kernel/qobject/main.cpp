@@ -47,7 +47,8 @@
 
 enum {
     CreationDeletionBenckmarkConstant = 34567,
-    SignalsAndSlotsBenchmarkConstant = 456789
+    SignalsAndSlotsBenchmarkConstant = 456789,
+    ConcurrentEmitBenchmarkConstant = 200000
 };
 
 class QObjectBenchmark : public QObject
@@ -62,12 +63,45 @@ private slots:
     void connect_disconnect_benchmark_data();
     void connect_disconnect_benchmark();
     void receiver_destroyed_benchmark();
+    void concurrent_emit_benchmark_data();
+    void concurrent_emit_benchmark();
 };
 
 struct Functor {
     void operator()(){}
 };
 
+class EmitThread : public QThread
+{
+public:
+    EmitThread(Object *sender, int count) : sender(sender), count(count) { }
+    void run()
+    {
+        for (int i = 0; i < count; ++i)
+            sender->emitSignal0();
+    }
+
+    Object *sender;
+    int count;
+};
+
+class ConnectThread : public QThread
+{
+public:
+    explicit ConnectThread(Object *sender) : sender(sender) { }
+    void run()
+    {
+        Object receiver;
+        while (!stop.load()) {
+            QObject::connect(sender, SIGNAL(signal0()), &receiver, SLOT(slot1()), Qt::DirectConnection);
+            QObject::disconnect(sender, SIGNAL(signal0()), &receiver, SLOT(slot1()));
+        }
+    }
+
+    Object *sender;
+    QAtomicInt stop;
+};
+
 void QObjectBenchmark::signal_slot_benchmark_data()
 {
     QTest::addColumn<int>("type");
@@ -246,6 +280,61 @@ void QObjectBenchmark::receiver_destroyed_benchmark()
     }
 }
 
+void QObjectBenchmark::concurrent_emit_benchmark_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("sharedSender");
+    QTest::addColumn<bool>("connectDuringEmit");
+
+    const int threadCounts[] = { 1, 2, 4, 8 };
+    for (uint i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); ++i) {
+        const int threads = threadCounts[i];
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 threads, own sender").arg(threads)))
+            << threads << false << false;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 threads, shared sender").arg(threads)))
+            << threads << true << false;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 threads, shared sender, connect/disconnect").arg(threads)))
+            << threads << true << true;
+    }
+}
+
+void QObjectBenchmark::concurrent_emit_benchmark()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, sharedSender);
+    QFETCH(bool, connectDuringEmit);
+
+    // the same number of emissions, split across the threads
+    const int emitsPerThread = ConcurrentEmitBenchmarkConstant / threadCount;
+
+    Object receiver;
+    QVector<Object *> senders(sharedSender ? 1 : threadCount);
+    for (int i = 0; i < senders.size(); ++i) {
+        senders[i] = new Object;
+        QObject::connect(senders[i], SIGNAL(signal0()), &receiver, SLOT(slot0()), Qt::DirectConnection);
+    }
+
+    QBENCHMARK {
+        ConnectThread connectThread(senders.first());
+        if (connectDuringEmit)
+            connectThread.start();
+
+        QVector<EmitThread *> threads(threadCount);
+        for (int i = 0; i < threadCount; ++i)
+            threads[i] = new EmitThread(senders.at(sharedSender ? 0 : i), emitsPerThread);
+        for (int i = 0; i < threadCount; ++i)
+            threads.at(i)->start();
+        for (int i = 0; i < threadCount; ++i)
+            threads.at(i)->wait();
+        qDeleteAll(threads);
+
+        connectThread.stop.store(1);
+        connectThread.wait();
+    }
+
+    qDeleteAll(senders);
+}
+
 QTEST_MAIN(QObjectBenchmark)
 
 #include "main.moc"
@@ -0,0 +1,197 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore>
+#include <QtTest/QtTest>
+
+Q_DECLARE_METATYPE(Qt::TimerType)
+
+// Coarse timers are only kept in the timer wheel when QT_TIMER_WHEEL is set;
+// run the benchmark with and without it to compare.
+
+class TimerBench : public QObject
+{
+    Q_OBJECT
+private slots:
+    void startAndKill_data();
+    void startAndKill();
+    void idleIteration_data();
+    void idleIteration();
+    void activate_data();
+    void activate();
+};
+
+// One timer per object, the way per-request timeouts are usually set up
+class TimerObject : public QObject
+{
+public:
+    TimerObject() : timerId(0) {}
+
+    void timerEvent(QTimerEvent *)
+    {
+        killTimer(timerId);
+        timerId = 0;
+        if (--pending == 0)
+            QTestEventLoop::instance().exitLoop();
+    }
+
+    int timerId;
+    static int pending;
+};
+
+int TimerObject::pending = 0;
+
+class TimerObjects
+{
+public:
+    explicit TimerObjects(int count)
+        : objects(count)
+    {
+        for (int i = 0; i < count; ++i)
+            objects[i] = new TimerObject;
+    }
+
+    ~TimerObjects()
+    {
+        qDeleteAll(objects);
+    }
+
+    // intervals between maxInterval / 2 and maxInterval, in decreasing order
+    void startTimers(int maxInterval, Qt::TimerType type)
+    {
+        TimerObject::pending = objects.count();
+        for (int i = 0; i < objects.count(); ++i) {
+            TimerObject *o = objects.at(i);
+            o->timerId = o->startTimer(maxInterval - i % (maxInterval / 2), type);
+        }
+    }
+
+    void killTimers()
+    {
+        for (int i = 0; i < objects.count(); ++i) {
+            TimerObject *o = objects.at(i);
+            o->killTimer(o->timerId);
+            o->timerId = 0;
+        }
+    }
+
+private:
+    QVector<TimerObject *> objects;
+};
+
+static void addTimerRows(bool withVeryCoarse)
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<Qt::TimerType>("type");
+
+    static const int counts[] = { 10000, 100000 };
+    for (uint i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+        const QByteArray n = QByteArray::number(counts[i]);
+        // precise timers are kept in a sorted list, which makes 100000 of
+        // them take minutes
+        if (counts[i] <= 10000)
+            QTest::newRow(n + " precise") << counts[i] << Qt::PreciseTimer;
+        QTest::newRow(n + " coarse") << counts[i] << Qt::CoarseTimer;
+        if (withVeryCoarse)
+            QTest::newRow(n + " very coarse") << counts[i] << Qt::VeryCoarseTimer;
+    }
+}
+
+void TimerBench::startAndKill_data()
+{
+    addTimerRows(true);
+}
+
+void TimerBench::startAndKill()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, type);
+
+    TimerObjects objects(count);
+    QBENCHMARK {
+        objects.startTimers(3600 * 1000, type);
+        objects.killTimers();
+    }
+}
+
+void TimerBench::idleIteration_data()
+{
+    addTimerRows(true);
+}
+
+void TimerBench::idleIteration()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, type);
+
+    // none of the timers fires, so this measures the cost of finding out
+    TimerObjects objects(count);
+    objects.startTimers(3600 * 1000, type);
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i)
+            QCoreApplication::processEvents();
+    }
+    objects.killTimers();
+}
+
+void TimerBench::activate_data()
+{
+    addTimerRows(false);
+}
+
+void TimerBench::activate()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, type);
+
+    // the timers are due within 100 ms; anything beyond that is overhead
+    TimerObjects objects(count);
+    QBENCHMARK {
+        objects.startTimers(100, type);
+        QTestEventLoop::instance().enterLoop(60);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        QCOMPARE(TimerObject::pending, 0);
+    }
+}
+
+QTEST_MAIN(TimerBench)
+
+#include "main.moc"
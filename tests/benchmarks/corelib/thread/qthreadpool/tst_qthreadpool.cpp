@@ -53,6 +53,10 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void manyTinyTasks_data();
+    void manyTinyTasks();
+    void nestedSubmission_data();
+    void nestedSubmission();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -88,5 +92,112 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+// Counts down the runnables of one benchmark iteration
+class Countdown
+{
+public:
+    void reset(int count) { remaining.store(count); }
+    void done() { if (!remaining.deref()) finished.release(); }
+    void wait() { finished.acquire(); }
+
+private:
+    QAtomicInt remaining;
+    QSemaphore finished;
+};
+
+class TinyRunnable : public QRunnable
+{
+public:
+    TinyRunnable(Countdown *countdown) : countdown(countdown) {}
+    void run() Q_DECL_OVERRIDE {
+        countdown->done();
+    }
+
+    Countdown *countdown;
+};
+
+// Starts many tiny runnables from within the pool
+class SpawningRunnable : public QRunnable
+{
+public:
+    SpawningRunnable(QThreadPool *pool, Countdown *countdown, int count)
+        : pool(pool), countdown(countdown), count(count) {}
+    void run() Q_DECL_OVERRIDE {
+        for (int i = 0; i < count; ++i)
+            pool->start(new TinyRunnable(countdown));
+        countdown->done();
+    }
+
+    QThreadPool *pool;
+    Countdown *countdown;
+    int count;
+};
+
+// Starts two more of itself until the given depth is reached
+class NestedRunnable : public QRunnable
+{
+public:
+    NestedRunnable(QThreadPool *pool, Countdown *countdown, int depth)
+        : pool(pool), countdown(countdown), depth(depth) {}
+    void run() Q_DECL_OVERRIDE {
+        if (depth > 0) {
+            pool->start(new NestedRunnable(pool, countdown, depth - 1));
+            pool->start(new NestedRunnable(pool, countdown, depth - 1));
+        }
+        countdown->done();
+    }
+
+    QThreadPool *pool;
+    Countdown *countdown;
+    int depth;
+};
+
+static void addWorkStealingRows()
+{
+    QTest::addColumn<bool>("workStealing");
+    QTest::newRow("shared queue") << false;
+    QTest::newRow("work stealing") << true;
+}
+
+void tst_QThreadPool::manyTinyTasks_data()
+{
+    addWorkStealingRows();
+}
+
+void tst_QThreadPool::manyTinyTasks()
+{
+    QFETCH(bool, workStealing);
+    const int count = 100000;
+
+    QThreadPool threadPool;
+    threadPool.setWorkStealingEnabled(workStealing);
+    Countdown countdown;
+    QBENCHMARK {
+        countdown.reset(count + 1);
+        threadPool.start(new SpawningRunnable(&threadPool, &countdown, count));
+        countdown.wait();
+    }
+}
+
+void tst_QThreadPool::nestedSubmission_data()
+{
+    addWorkStealingRows();
+}
+
+void tst_QThreadPool::nestedSubmission()
+{
+    QFETCH(bool, workStealing);
+    const int depth = 16;
+
+    QThreadPool threadPool;
+    threadPool.setWorkStealingEnabled(workStealing);
+    Countdown countdown;
+    QBENCHMARK {
+        countdown.reset((1 << (depth + 1)) - 1);
+        threadPool.start(new NestedRunnable(&threadPool, &countdown, depth));
+        countdown.wait();
+    }
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
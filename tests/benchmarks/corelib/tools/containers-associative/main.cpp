@@ -38,10 +38,17 @@
 ** $QT_END_LICENSE$
 **
 ****************************************************************************/
+#include <QFlatHash>
+#include <QHash>
+#include <QMap>
 #include <QString>
 
 #include <qtest.h>
 
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
 class tst_associative_containers : public QObject
 {
     Q_OBJECT
@@ -50,8 +57,32 @@ private slots:
     void insert();
     void lookup_data();
     void lookup();
+    void iterate_data();
+    void iterate();
+    void memory_data();
+    void memory();
+
+private:
+    void data();
 };
 
+enum Container { Hash, FlatHash, Map };
+
+void tst_associative_containers::data()
+{
+    QTest::addColumn<int>("container");
+    QTest::addColumn<int>("size");
+
+    for (int size = 10; size < 20000; size += 100) {
+
+        const QByteArray sizeString = QByteArray::number(size);
+
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << int(Hash) << size;
+        QTest::newRow(QByteArray("flathash--" + sizeString).constData()) << int(FlatHash) << size;
+        QTest::newRow(QByteArray("map--" + sizeString).constData()) << int(Map) << size;
+    }
+}
+
 template <typename T>
 void testInsert(int size)
 {
@@ -65,30 +96,24 @@ void testInsert(int size)
 
 void tst_associative_containers::insert_data()
 {
-    QTest::addColumn<bool>("useHash");
-    QTest::addColumn<int>("size");
-
-    for (int size = 10; size < 20000; size += 100) {
-
-        const QByteArray sizeString = QByteArray::number(size);
-
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
-    }
+    data();
 }
 
 void tst_associative_containers::insert()
 {
-    QFETCH(bool, useHash);
+    QFETCH(int, container);
     QFETCH(int, size);
 
-    QHash<int, int> testHash;
-    QMap<int, int> testMap;
-
-    if (useHash) {
+    switch (container) {
+    case Hash:
         testInsert<QHash<int, int> >(size);
-    } else {
+        break;
+    case FlatHash:
+        testInsert<QFlatHash<int, int> >(size);
+        break;
+    case Map:
         testInsert<QMap<int, int> >(size);
+        break;
     }
 }
 
@@ -97,16 +122,7 @@ void tst_associative_containers::lookup_data()
 //    setReportType(LineChartReport);
 //    setChartTitle("Time to call value(), with an increasing number of items in the container");
 
-    QTest::addColumn<bool>("useHash");
-    QTest::addColumn<int>("size");
-
-    for (int size = 10; size < 20000; size += 100) {
-
-        const QByteArray sizeString = QByteArray::number(size);
-
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
-    }
+    data();
 }
 
 template <typename T>
@@ -117,24 +133,124 @@ void testLookup(int size)
     for (int i = 0; i < size; ++i)
         container.insert(i, i);
 
-    int val;
+    qint64 sum = 0;
 
     QBENCHMARK {
         for (int i = 0; i < size; ++i)
-            val = container.value(i);
+            sum += container.value(i);
 
     }
+    QVERIFY(sum >= 0); // keeps the lookups from being optimized away
 }
 
 void tst_associative_containers::lookup()
 {
-    QFETCH(bool, useHash);
+    QFETCH(int, container);
     QFETCH(int, size);
 
-    if (useHash) {
+    switch (container) {
+    case Hash:
         testLookup<QHash<int, int> >(size);
-    } else {
+        break;
+    case FlatHash:
+        testLookup<QFlatHash<int, int> >(size);
+        break;
+    case Map:
         testLookup<QMap<int, int> >(size);
+        break;
+    }
+}
+
+void tst_associative_containers::iterate_data()
+{
+    data();
+}
+
+template <typename T>
+void testIterate(int size)
+{
+    T container;
+
+    for (int i = 0; i < size; ++i)
+        container.insert(i, i);
+
+    qint64 sum = 0;
+
+    QBENCHMARK {
+        for (typename T::const_iterator it = container.constBegin(); it != container.constEnd(); ++it)
+            sum += it.value();
+    }
+    QVERIFY(sum >= 0);
+}
+
+void tst_associative_containers::iterate()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+
+    switch (container) {
+    case Hash:
+        testIterate<QHash<int, int> >(size);
+        break;
+    case FlatHash:
+        testIterate<QFlatHash<int, int> >(size);
+        break;
+    case Map:
+        testIterate<QMap<int, int> >(size);
+        break;
+    }
+}
+
+void tst_associative_containers::memory_data()
+{
+    data();
+}
+
+#if defined(__GLIBC__)
+// Approximate: blocks handed out from the allocator's per-thread cache
+// were already counted as in use.
+static qint64 heapInUse()
+{
+#if __GLIBC_PREREQ(2, 33)
+    const struct mallinfo2 info = mallinfo2();
+#else
+    const struct mallinfo info = mallinfo();
+#endif
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+}
+#endif
+
+template <typename T>
+void testMemory(int size)
+{
+#if defined(__GLIBC__)
+    const qint64 before = heapInUse();
+    T *container = new T;
+    for (int i = 0; i < size; ++i)
+        container->insert(i, i);
+    QTest::setBenchmarkResult(heapInUse() - before, QTest::BytesAllocated);
+    delete container;
+#else
+    Q_UNUSED(size);
+    QSKIP("Heap usage is only measured with glibc");
+#endif
+}
+
+void tst_associative_containers::memory()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+
+    switch (container) {
+    case Hash:
+        testMemory<QHash<int, int> >(size);
+        break;
+    case FlatHash:
+        testMemory<QFlatHash<int, int> >(size);
+        break;
+    case Map:
+        testMemory<QMap<int, int> >(size);
+        break;
     }
 }
 
@@ -42,6 +42,7 @@
 #include "main.h"
 
 #include <QFile>
+#include <QFlatHash>
 #include <QHash>
 #include <QString>
 #include <QStringList>
@@ -56,13 +57,20 @@ class tst_QHash : public QObject
 private slots:
     void initTestCase();
     void qhash_current_data() { data(); }
-    void qhash_current() { qhash_template<QString>(); }
+    void qhash_current() { qhash_template<QString, QHash>(); }
     void qhash_qt50_data() { data(); }
-    void qhash_qt50() { qhash_template<Qt50String>(); }
+    void qhash_qt50() { qhash_template<Qt50String, QHash>(); }
     void qhash_qt4_data() { data(); }
-    void qhash_qt4() { qhash_template<Qt4String>(); }
+    void qhash_qt4() { qhash_template<Qt4String, QHash>(); }
     void qhash_javaString_data() { data(); }
-    void qhash_javaString() { qhash_template<JavaString>(); }
+    void qhash_javaString() { qhash_template<JavaString, QHash>(); }
+    void qflathash_current_data() { data(); }
+    void qflathash_current() { qhash_template<QString, QFlatHash>(); }
+
+    void lookup_qhash_data() { data(); }
+    void lookup_qhash() { lookup_template<QHash>(); }
+    void lookup_qflathash_data() { data(); }
+    void lookup_qflathash() { lookup_template<QFlatHash>(); }
 
     void hashing_current_data() { data(); }
     void hashing_current() { hashing_template<QString>(); }
@@ -75,7 +83,8 @@ private slots:
 
 private:
     void data();
-    template <typename String> void qhash_template();
+    template <typename String, template <class, class> class Hash> void qhash_template();
+    template <template <class, class> class Hash> void lookup_template();
     template <typename String> void hashing_template();
 
     QStringList smallFilePaths;
@@ -148,10 +157,10 @@ void tst_QHash::data()
     QTest::newRow("numbers") << numbers;
 }
 
-template <typename String> void tst_QHash::qhash_template()
+template <typename String, template <class, class> class Hash> void tst_QHash::qhash_template()
 {
     QFETCH(QStringList, items);
-    QHash<String, int> hash;
+    Hash<String, int> hash;
 
     QList<String> realitems;
     foreach (const QString &s, items)
@@ -164,6 +173,21 @@ template <typename String> void tst_QHash::qhash_template()
     }
 }
 
+template <template <class, class> class Hash> void tst_QHash::lookup_template()
+{
+    QFETCH(QStringList, items);
+    Hash<QString, int> hash;
+    for (int i = 0, n = items.size(); i != n; ++i)
+        hash.insert(items.at(i), i);
+
+    int found = 0;
+    QBENCHMARK {
+        for (int i = 0, n = items.size(); i != n; ++i)
+            found += hash.contains(items.at(i));
+    }
+    QVERIFY(found > 0);
+}
+
 template <typename String> void tst_QHash::hashing_template()
 {
     // just the hashing function
@@ -41,6 +41,7 @@
 
 #include <QLocale>
 #include <QTest>
+#include <QVector>
 
 class tst_QLocale : public QObject
 {
@@ -50,6 +51,11 @@ private Q_SLOTS:
     void toUpper_QLocale_1();
     void toUpper_QLocale_2();
     void toUpper_QString();
+    void number_double_data();
+    void number_double();
+    void toString_double();
+    void toDouble_data();
+    void toDouble();
 };
 
 static QString data()
@@ -78,6 +84,81 @@ void tst_QLocale::toUpper_QString()
     QBENCHMARK { LOOP(s.toUpper()) }
 }
 
+// Coordinate-like values, as found in GeoJSON and CSV exports
+static QVector<double> doubles()
+{
+    QVector<double> result;
+    result.reserve(1000);
+    double lat = 52.520008, lon = 13.404954;
+    for (int i = 0; i < 1000; ++i) {
+        lat += 0.000137 * ((i * 7) % 13 - 6);
+        lon -= 0.000291 * ((i * 5) % 11 - 5);
+        result << lat << lon;
+    }
+    return result;
+}
+
+void tst_QLocale::number_double_data()
+{
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+
+    QTest::newRow("g, default") << 'g' << 6;
+    QTest::newRow("g, 17") << 'g' << 17;
+    QTest::newRow("g, shortest") << 'g' << int(QLocale::FloatingPointShortest);
+    QTest::newRow("f, 6") << 'f' << 6;
+    QTest::newRow("e, 10") << 'e' << 10;
+}
+
+void tst_QLocale::number_double()
+{
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    const QVector<double> values = doubles();
+
+    QBENCHMARK {
+        foreach (double d, values)
+            QString::number(d, format, precision);
+    }
+}
+
+void tst_QLocale::toString_double()
+{
+    const QVector<double> values = doubles();
+    QLocale l(QLocale::German);
+
+    QBENCHMARK {
+        foreach (double d, values)
+            l.toString(d, 'g', QLocale::FloatingPointShortest);
+    }
+}
+
+void tst_QLocale::toDouble_data()
+{
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+
+    QTest::newRow("8 digits") << 'g' << 8;
+    QTest::newRow("15 digits") << 'g' << 15;
+    QTest::newRow("17 digits") << 'g' << 17;
+    QTest::newRow("shortest") << 'g' << int(QLocale::FloatingPointShortest);
+    QTest::newRow("exponent") << 'e' << 12;
+}
+
+void tst_QLocale::toDouble()
+{
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    QList<QByteArray> strings;
+    foreach (double d, doubles())
+        strings << QByteArray::number(d, format, precision);
+
+    QBENCHMARK {
+        foreach (const QByteArray &s, strings)
+            s.toDouble();
+    }
+}
+
 QTEST_MAIN(tst_QLocale)
 
 #include "main.moc"
@@ -0,0 +1,299 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QByteArray>
+#include <QHash>
+#include <QSmallString>
+#include <QString>
+#include <QVector>
+
+#include <qtest.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#include <unistd.h>
+#include <stdio.h>
+
+// Count every block handed out by the allocator. Calls made from inside
+// QtCore resolve to these definitions as well.
+extern "C" void *__libc_malloc(size_t);
+extern "C" void *__libc_calloc(size_t, size_t);
+extern "C" void *__libc_realloc(void *, size_t);
+
+static qint64 allocationCount = 0;
+
+extern "C" void *malloc(size_t size)
+{
+    ++allocationCount;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    ++allocationCount;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    ++allocationCount;
+    return __libc_realloc(ptr, size);
+}
+
+static qint64 heapInUse()
+{
+#if __GLIBC_PREREQ(2, 33)
+    const struct mallinfo2 info = mallinfo2();
+#else
+    const struct mallinfo info = mallinfo();
+#endif
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+}
+
+static qint64 residentSetSize()
+{
+    // Give freed pages back first so the numbers of consecutive rows do
+    // not depend on each other.
+    malloc_trim(0);
+    long size = 0;
+    long pages = 0;
+    if (FILE *f = fopen("/proc/self/statm", "r")) {
+        if (fscanf(f, "%ld %ld", &size, &pages) != 2)
+            pages = 0;
+        fclose(f);
+    }
+    return qint64(pages) * sysconf(_SC_PAGESIZE);
+}
+#endif
+
+class tst_QSmallString : public QObject
+{
+    Q_OBJECT
+public:
+    enum Type { String, SmallString, ByteArray, SmallByteArray };
+    enum Workload { ShortTags, Mixed };
+
+private slots:
+    void create_data() { setupData(); }
+    void create();
+    void allocations_data() { setupData(); }
+    void allocations();
+    void heapUsage_data() { setupData(); }
+    void heapUsage();
+    void residentMemory_data() { setupData(); }
+    void residentMemory();
+    void lookup_data() { setupData(); }
+    void lookup();
+
+private:
+    void setupData();
+};
+
+enum Measurement { Create, Allocations, HeapUsage, ResidentMemory, Lookup };
+
+// Point of interest attributes: mostly short keys and values, plus the
+// occasional name that does not fit inline.
+static QVector<QByteArray> workload(int kind)
+{
+    static const char * const tags[] = {
+        "amenity", "restaurant", "cafe", "highway", "residential", "bus_stop",
+        "name", "building", "yes", "shop", "bakery", "addr:street", "ref",
+        "cuisine", "pizza", "opening_hours", "24/7", "wheelchair", "no",
+        "level", "0", "1", "2", "source", "survey", "access", "private"
+    };
+    static const char * const names[] = {
+        "Restaurant Zum Goldenen Hirschen", "Central Station Parking Garage",
+        "Saint Mary's Primary School", "Hauptstrasse / Bahnhofstrasse"
+    };
+    const int tagCount = sizeof(tags) / sizeof(tags[0]);
+    const int nameCount = sizeof(names) / sizeof(names[0]);
+    const int count = 500000;
+
+    QVector<QByteArray> source;
+    source.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        if (kind == tst_QSmallString::Mixed && i % 8 == 7) {
+            source.append(QByteArray(names[i % nameCount]) + ' ' + QByteArray::number(i));
+        } else if (i % 5 == 4) {
+            source.append(QByteArray::number(i % 997));
+        } else {
+            source.append(QByteArray(tags[(i * 7) % tagCount]));
+        }
+    }
+    return source;
+}
+
+template <typename T> struct Maker;
+template <> struct Maker<QString>
+{
+    static QString make(const QByteArray &s) { return QString::fromLatin1(s.constData(), s.size()); }
+};
+template <> struct Maker<QSmallString>
+{
+    static QSmallString make(const QByteArray &s) { return QSmallString(QLatin1String(s.constData(), s.size())); }
+};
+template <> struct Maker<QByteArray>
+{
+    static QByteArray make(const QByteArray &s) { return QByteArray(s.constData(), s.size()); }
+};
+template <> struct Maker<QSmallByteArray>
+{
+    static QSmallByteArray make(const QByteArray &s) { return QSmallByteArray(s.constData(), s.size()); }
+};
+
+template <typename T>
+static void fill(QVector<T> &strings, const QVector<QByteArray> &source)
+{
+    strings.reserve(source.size());
+    for (int i = 0; i < source.size(); ++i)
+        strings.append(Maker<T>::make(source.at(i)));
+}
+
+template <typename T>
+static void run(Measurement measurement, const QVector<QByteArray> &source)
+{
+    switch (measurement) {
+    case Create:
+        QBENCHMARK {
+            QVector<T> strings;
+            fill(strings, source);
+        }
+        break;
+    case Allocations:
+    case HeapUsage:
+    case ResidentMemory: {
+#if defined(__GLIBC__)
+        const qint64 allocationsBefore = allocationCount;
+        const qint64 heapBefore = heapInUse();
+        const qint64 rssBefore = residentSetSize();
+        QVector<T> *strings = new QVector<T>;
+        fill(*strings, source);
+        if (measurement == Allocations)
+            QTest::setBenchmarkResult(allocationCount - allocationsBefore, QTest::Events);
+        else if (measurement == HeapUsage)
+            QTest::setBenchmarkResult(heapInUse() - heapBefore, QTest::BytesAllocated);
+        else
+            QTest::setBenchmarkResult(residentSetSize() - rssBefore, QTest::BytesAllocated);
+        delete strings;
+#else
+        QSKIP("Memory use is only measured with glibc");
+#endif
+        break;
+    }
+    case Lookup: {
+        QVector<T> strings;
+        fill(strings, source);
+        QHash<T, int> hash;
+        for (int i = 0; i < strings.size(); ++i)
+            hash.insert(strings.at(i), i);
+        int found = 0;
+        QBENCHMARK {
+            for (int i = 0; i < strings.size(); ++i)
+                found += hash.contains(strings.at(i));
+        }
+        QVERIFY(found);
+        break;
+    }
+    }
+}
+
+void tst_QSmallString::setupData()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<int>("workload");
+
+    static const char * const typeNames[] = { "QString", "QSmallString", "QByteArray", "QSmallByteArray" };
+    for (int workload = ShortTags; workload <= Mixed; ++workload) {
+        for (int type = String; type <= SmallByteArray; ++type) {
+            QTest::newRow(QByteArray(typeNames[type]) + (workload == ShortTags ? "-short" : "-mixed"))
+                    << type << workload;
+        }
+    }
+}
+
+static void runMeasurement(Measurement measurement)
+{
+    QFETCH(int, type);
+    QFETCH(int, workload);
+
+    const QVector<QByteArray> source = ::workload(workload);
+    switch (type) {
+    case tst_QSmallString::String:
+        run<QString>(measurement, source);
+        break;
+    case tst_QSmallString::SmallString:
+        run<QSmallString>(measurement, source);
+        break;
+    case tst_QSmallString::ByteArray:
+        run<QByteArray>(measurement, source);
+        break;
+    case tst_QSmallString::SmallByteArray:
+        run<QSmallByteArray>(measurement, source);
+        break;
+    }
+}
+
+void tst_QSmallString::create()
+{
+    runMeasurement(Create);
+}
+
+void tst_QSmallString::allocations()
+{
+    runMeasurement(Allocations);
+}
+
+void tst_QSmallString::heapUsage()
+{
+    runMeasurement(HeapUsage);
+}
+
+void tst_QSmallString::residentMemory()
+{
+    runMeasurement(ResidentMemory);
+}
+
+void tst_QSmallString::lookup()
+{
+    runMeasurement(Lookup);
+}
+
+QTEST_MAIN(tst_QSmallString)
+#include "main.moc"
@@ -68,7 +68,10 @@ private slots:
     void equals2() const;
     void ucstrncmp_data() const;
     void ucstrncmp() const;
+    void fromUtf8_data() const;
     void fromUtf8() const;
+    void toUtf8_data() const;
+    void toUtf8() const;
     void fromLatin1_data() const;
     void fromLatin1() const;
     void fromLatin1Alternatives_data() const;
@@ -82,6 +85,13 @@ private slots:
     void toLower();
     void toCaseFolded_data();
     void toCaseFolded();
+
+    void indexOf_char_data() const;
+    void indexOf_char() const;
+    void indexOf_data() const;
+    void indexOf() const;
+    void compare_caseInsensitive_data() const;
+    void compare_caseInsensitive() const;
 };
 
 void tst_QString::equals() const
@@ -1406,10 +1416,21 @@ void tst_QString::ucstrncmp() const
     }
 }
 
+void tst_QString::fromUtf8_data() const
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("mixed") << QString("utf-8.txt");
+    QTest::newRow("russian") << QString("russian.txt");
+    QTest::newRow("chinese") << QString("chinese.txt");
+    QTest::newRow("names") << QString("names.txt");
+}
+
 void tst_QString::fromUtf8() const
 {
-    QString testFile = QFINDTESTDATA("utf-8.txt");
-    QVERIFY2(!testFile.isEmpty(), "cannot find test file utf-8.txt!");
+    QFETCH(QString, fileName);
+    QString testFile = QFINDTESTDATA(fileName);
+    QVERIFY2(!testFile.isEmpty(), qPrintable("cannot find test file " + fileName));
     QFile file(testFile);
     if (!file.open(QFile::ReadOnly)) {
         qFatal("Cannot open input file");
@@ -1424,6 +1445,25 @@ void tst_QString::fromUtf8() const
     }
 }
 
+void tst_QString::toUtf8_data() const
+{
+    fromUtf8_data();
+}
+
+void tst_QString::toUtf8() const
+{
+    QFETCH(QString, fileName);
+    QString testFile = QFINDTESTDATA(fileName);
+    QVERIFY2(!testFile.isEmpty(), qPrintable("cannot find test file " + fileName));
+    QFile file(testFile);
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QString s = QString::fromUtf8(file.readAll());
+
+    QBENCHMARK {
+        s.toUtf8();
+    }
+}
+
 void tst_QString::fromLatin1_data() const
 {
     QTest::addColumn<QByteArray>("latin1");
@@ -2595,6 +2635,23 @@ void tst_QString::fromUtf8Alternatives() const
     }
 }
 
+static QString textForBenchmark(const QString &name)
+{
+    if (name == QLatin1String("english")) {
+        const QString sentence = QStringLiteral("The city stands on the high bank of the River Volga, "
+                                                "where it turns wide towards the East. ");
+        QString text;
+        while (text.size() < 2000)
+            text += sentence;
+        return text;
+    }
+
+    QFile file(QFINDTESTDATA(name));
+    if (!file.open(QFile::ReadOnly))
+        qFatal("Cannot open input file");
+    return QString::fromUtf8(file.readAll());
+}
+
 void tst_QString::toUpper_data()
 {
     QTest::addColumn<QString>("s");
@@ -2639,6 +2696,9 @@ void tst_QString::toUpper_data()
     QTest::newRow("300A+150<10428>") << (upperLatin1 + lowerDeseret);
 
     QTest::newRow("600<FB03> (ligature)") << lowerLigature;
+
+    QTest::newRow("english") << textForBenchmark("english");
+    QTest::newRow("russian") << textForBenchmark("russian.txt");
 }
 
 void tst_QString::toUpper()
@@ -2678,6 +2738,96 @@ void tst_QString::toCaseFolded()
     }
 }
 
+void tst_QString::indexOf_char_data() const
+{
+    QTest::addColumn<QString>("s");
+    QTest::addColumn<QChar>("ch");
+    QTest::addColumn<bool>("caseSensitive");
+
+    // none of the texts contain a '~' or a 'z', so the whole string is scanned
+    const char *texts[] = { "english", "mixed", "russian" };
+    const char *files[] = { "english", "utf-8.txt", "russian.txt" };
+    for (int i = 0; i < 3; ++i) {
+        const QString s = textForBenchmark(files[i]);
+        const QByteArray name = texts[i];
+        QTest::newRow((name + "-sensitive").constData()) << s << QChar('~') << true;
+        QTest::newRow((name + "-insensitive").constData()) << s << QChar('Z') << false;
+    }
+}
+
+void tst_QString::indexOf_char() const
+{
+    QFETCH(QString, s);
+    QFETCH(QChar, ch);
+    QFETCH(bool, caseSensitive);
+    const Qt::CaseSensitivity cs = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    QBENCHMARK {
+        s.indexOf(ch, 0, cs);
+    }
+}
+
+void tst_QString::indexOf_data() const
+{
+    QTest::addColumn<QString>("s");
+    QTest::addColumn<QString>("needle");
+    QTest::addColumn<bool>("caseSensitive");
+
+    // none of the texts contain the needles, so the whole string is scanned
+    const char *texts[] = { "english", "mixed", "russian" };
+    const char *files[] = { "english", "utf-8.txt", "russian.txt" };
+    for (int i = 0; i < 3; ++i) {
+        const QString s = textForBenchmark(files[i]);
+        const QString shortText = s.left(400);
+        const QByteArray name = texts[i];
+        QTest::newRow((name + "-400-short-sensitive").constData()) << shortText << QString("zebra") << true;
+        QTest::newRow((name + "-400-short-insensitive").constData()) << shortText << QString("Zebra") << false;
+        QTest::newRow((name + "-400-long-sensitive").constData()) << shortText << QString("the zebra crossing") << true;
+        QTest::newRow((name + "-400-long-insensitive").constData()) << shortText << QString("The Zebra Crossing") << false;
+        QTest::newRow((name + "-short-sensitive").constData()) << s << QString("zebra") << true;
+        QTest::newRow((name + "-short-insensitive").constData()) << s << QString("Zebra") << false;
+        QTest::newRow((name + "-long-sensitive").constData()) << s << QString("the zebra crossing") << true;
+        QTest::newRow((name + "-long-insensitive").constData()) << s << QString("The Zebra Crossing") << false;
+    }
+}
+
+void tst_QString::indexOf() const
+{
+    QFETCH(QString, s);
+    QFETCH(QString, needle);
+    QFETCH(bool, caseSensitive);
+    const Qt::CaseSensitivity cs = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    QBENCHMARK {
+        s.indexOf(needle, 0, cs);
+    }
+}
+
+void tst_QString::compare_caseInsensitive_data() const
+{
+    QTest::addColumn<QString>("a");
+    QTest::addColumn<QString>("b");
+
+    const char *texts[] = { "english", "mixed", "russian" };
+    const char *files[] = { "english", "utf-8.txt", "russian.txt" };
+    for (int i = 0; i < 3; ++i) {
+        const QString s = textForBenchmark(files[i]);
+        const QByteArray name = texts[i];
+        QTest::newRow((name + "-16").constData()) << s.left(16) << s.left(16).toUpper();
+        QTest::newRow((name + "-full").constData()) << s << s.toUpper();
+    }
+}
+
+void tst_QString::compare_caseInsensitive() const
+{
+    QFETCH(QString, a);
+    QFETCH(QString, b);
+
+    QBENCHMARK {
+        QString::compare(a, b, Qt::CaseInsensitive);
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
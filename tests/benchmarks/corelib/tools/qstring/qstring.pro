@@ -3,7 +3,7 @@ QT -= gui
 QT += core-private testlib
 SOURCES += main.cpp data.cpp fromlatin1.cpp fromutf8.cpp
 
-TESTDATA = utf-8.txt
+TESTDATA = utf-8.txt russian.txt chinese.txt names.txt
 
 sse4:QMAKE_CXXFLAGS += -msse4
 else:ssse3:QMAKE_FLAGS += -mssse3
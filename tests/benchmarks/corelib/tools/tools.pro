@@ -11,6 +11,7 @@ SUBDIRS = \
         qmap \
         qrect \
         qregexp \
+        qsmallstring \
         qstring \
         qstringbuilder \
         qstringlist \
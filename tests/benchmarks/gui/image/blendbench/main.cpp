@@ -109,6 +109,9 @@ private slots:
 
     void unalignedBlendArgb32_data();
     void unalignedBlendArgb32();
+
+    void blendKernels_data();
+    void blendKernels();
 };
 
 void BlendBench::blendBench_data()
@@ -222,6 +225,98 @@ void BlendBench::unalignedBlendArgb32()
     qFreeAligned(dstMemory);
 }
 
+enum BlendKernel {
+    BlendArgb32OnArgb32,
+    BlendArgb32OnArgb32ConstAlpha,
+    BlendRgb32OnRgb32ConstAlpha,
+    CompSourceOver,
+    CompSourceOverConstAlpha,
+    CompSolidSourceOver,
+    CompSolidSourceOverConstAlpha,
+    CompSolidSourcePartialCoverage
+};
+
+void BlendBench::blendKernels_data()
+{
+    // Each row exercises one of the untransformed blend functions or
+    // composition functions of the raster engine for 32 bit images, so the
+    // effect of the SIMD variant selected at runtime can be measured in
+    // isolation. Every iteration touches dimension * dimension pixels.
+    QTest::addColumn<int>("kernel");
+    QTest::newRow("blend argb32 on argb32") << int(BlendArgb32OnArgb32);
+    QTest::newRow("blend argb32 on argb32, const alpha") << int(BlendArgb32OnArgb32ConstAlpha);
+    QTest::newRow("blend rgb32 on rgb32, const alpha") << int(BlendRgb32OnRgb32ConstAlpha);
+    QTest::newRow("comp SourceOver") << int(CompSourceOver);
+    QTest::newRow("comp SourceOver, const alpha") << int(CompSourceOverConstAlpha);
+    QTest::newRow("comp solid SourceOver") << int(CompSolidSourceOver);
+    QTest::newRow("comp solid SourceOver, const alpha") << int(CompSolidSourceOverConstAlpha);
+    QTest::newRow("comp solid Source, partial coverage") << int(CompSolidSourcePartialCoverage);
+}
+
+void BlendBench::blendKernels()
+{
+    QFETCH(int, kernel);
+
+    const int dimension = 1024;
+    const bool opaque = (kernel == BlendRgb32OnRgb32ConstAlpha);
+    const QImage::Format format = opaque ? QImage::Format_RGB32 : QImage::Format_ARGB32_Premultiplied;
+
+    QImage destination(dimension, dimension, format);
+    destination.fill(0x12345678);
+    QImage src(dimension, dimension, format);
+    src.fill(0x87654321);
+
+    QPainter painter(&destination);
+    painter.setPen(Qt::NoPen);
+
+    switch (kernel) {
+    case BlendArgb32OnArgb32ConstAlpha:
+    case BlendRgb32OnRgb32ConstAlpha:
+    case CompSourceOverConstAlpha:
+    case CompSolidSourceOverConstAlpha:
+        painter.setOpacity(0.7);
+        break;
+    case CompSolidSourcePartialCoverage:
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.setRenderHint(QPainter::Antialiasing);
+        break;
+    default:
+        break;
+    }
+
+    switch (kernel) {
+    case BlendArgb32OnArgb32:
+    case BlendArgb32OnArgb32ConstAlpha:
+    case BlendRgb32OnRgb32ConstAlpha:
+        QBENCHMARK {
+            painter.drawImage(QPoint(), src);
+        }
+        break;
+    case CompSourceOver:
+    case CompSourceOverConstAlpha:
+        painter.setBrush(QBrush(src));
+        QBENCHMARK {
+            painter.drawRect(0, 0, dimension, dimension);
+        }
+        break;
+    case CompSolidSourceOver:
+    case CompSolidSourceOverConstAlpha:
+        painter.setBrush(QColor(127, 127, 127, 127));
+        QBENCHMARK {
+            painter.drawRect(0, 0, dimension, dimension);
+        }
+        break;
+    case CompSolidSourcePartialCoverage:
+        // half pixel high rectangles cover every scanline with a coverage of 50%
+        painter.setBrush(QColor(127, 127, 127));
+        QBENCHMARK {
+            for (int y = 0; y < dimension; ++y)
+                painter.drawRect(QRectF(0, y + 0.25, dimension, 0.5));
+        }
+        break;
+    }
+}
+
 QTEST_MAIN(BlendBench)
 
 #include "main.moc"
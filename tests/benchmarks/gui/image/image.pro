@@ -3,6 +3,7 @@ SUBDIRS = \
         blendbench \
         qimageconversion \
         qimagereader \
+        qimagescale \
         qpixmap \
         qpixmapcache
 
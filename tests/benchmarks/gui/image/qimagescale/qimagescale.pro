@@ -0,0 +1,4 @@
+TEMPLATE = app
+TARGET = tst_bench_qimagescale
+QT += testlib
+SOURCES += tst_qimagescale.cpp
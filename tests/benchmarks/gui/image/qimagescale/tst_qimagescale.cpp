@@ -0,0 +1,154 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <qtest.h>
+#include <QImage>
+#include <QThreadPool>
+
+Q_DECLARE_METATYPE(QImage::Format)
+
+// Large scales only use the global thread pool when asked to
+static void enableThreadedScaling()
+{
+    qputenv("QT_THREADED_IMAGE_SCALING", "1");
+}
+Q_CONSTRUCTOR_FUNCTION(enableThreadedScaling)
+
+class tst_QImageScale : public QObject
+{
+    Q_OBJECT
+private slots:
+    void smoothScale_data();
+    void smoothScale();
+
+    void smoothScaleThreads_data();
+    void smoothScaleThreads();
+
+private:
+    QImage generateImage(int width, int height, QImage::Format format);
+};
+
+QImage tst_QImageScale::generateImage(int width, int height, QImage::Format format)
+{
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int alpha = (x ^ y) & 0xff;
+            line[x] = qPremultiply(qRgba(x & 0xff, y & 0xff, (x + y) & 0xff, alpha | 0x40));
+        }
+    }
+    return image.convertToFormat(format);
+}
+
+void tst_QImageScale::smoothScale_data()
+{
+    QTest::addColumn<QImage>("image");
+    QTest::addColumn<QSize>("size");
+
+    // Covers the four code paths of the area sampling scaler: up, down,
+    // down vertically only and down horizontally only.
+    const QSize source(1000, 1000);
+    struct Ratio { const char *name; qreal x; qreal y; };
+    const Ratio ratios[] = {
+        { "down 1/8", 0.125, 0.125 },
+        { "down 1/4", 0.25, 0.25 },
+        { "down 1/2", 0.5, 0.5 },
+        { "down 3/4", 0.75, 0.75 },
+        { "up 3/2", 1.5, 1.5 },
+        { "up 2", 2.0, 2.0 },
+        { "down x, up y", 0.5, 1.5 },
+        { "up x, down y", 1.5, 0.5 }
+    };
+    const QImage::Format formats[] = { QImage::Format_ARGB32_Premultiplied, QImage::Format_RGB32 };
+    const char *formatNames[] = { "argb32pm", "rgb32" };
+
+    for (int f = 0; f < 2; ++f) {
+        const QImage image = generateImage(source.width(), source.height(), formats[f]);
+        for (size_t r = 0; r < sizeof(ratios) / sizeof(ratios[0]); ++r) {
+            const QSize size(qRound(source.width() * ratios[r].x), qRound(source.height() * ratios[r].y));
+            QTest::newRow(QByteArray(formatNames[f]) + ", " + ratios[r].name) << image << size;
+        }
+    }
+}
+
+void tst_QImageScale::smoothScale()
+{
+    QFETCH(QImage, image);
+    QFETCH(QSize, size);
+
+    QBENCHMARK {
+        QImage scaled = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        Q_UNUSED(scaled);
+    }
+}
+
+void tst_QImageScale::smoothScaleThreads_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("ideal thread count") << QThread::idealThreadCount();
+}
+
+void tst_QImageScale::smoothScaleThreads()
+{
+    // Large images are split across the global thread pool.
+    QFETCH(int, threadCount);
+
+    const QImage image = generateImage(3000, 2000, QImage::Format_ARGB32_Premultiplied);
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int oldMaxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(threadCount);
+
+    QBENCHMARK {
+        QImage scaled = image.scaled(image.size() / 3, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        Q_UNUSED(scaled);
+    }
+
+    pool->setMaxThreadCount(oldMaxThreadCount);
+}
+
+QTEST_MAIN(tst_QImageScale)
+
+#include "tst_qimagescale.moc"
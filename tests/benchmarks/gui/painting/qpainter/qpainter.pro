@@ -1,5 +1,5 @@
 QT += widgets testlib
-QT += gui-private widgets-private
+QT += core-private gui-private widgets-private
 
 TEMPLATE = app
 TARGET = tst_bench_qpainter
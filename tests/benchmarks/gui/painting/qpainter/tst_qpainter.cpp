@@ -52,6 +52,9 @@
 #endif
 
 #include <private/qpixmap_raster_p.h>
+#include <private/qtiledrasterdevice_p.h>
+#include <qthread.h>
+#include <qthreadpool.h>
 
 Q_DECLARE_METATYPE(QPainterPath)
 Q_DECLARE_METATYPE(QPainter::RenderHint)
@@ -236,6 +239,12 @@ private slots:
     void drawTransformedSemiTransparentImage();
     void drawTransformedFilledImage();
 
+    void tiledRasterDevice_data();
+    void tiledRasterDevice();
+
+    void drawPolylines_data();
+    void drawPolylines();
+
 private:
     void setupBrushes();
     void createPrimitives();
@@ -1659,6 +1668,126 @@ void tst_QPainter::drawTransformedFilledImage()
 }
 
 
+void tst_QPainter::tiledRasterDevice_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("direct") << 0;
+    QTest::newRow("threads=1") << 1;
+    QTest::newRow("threads=2") << 2;
+    QTest::newRow("threads=4") << 4;
+    QTest::newRow("threads=8") << 8;
+}
+
+// a fixed generator so that every row paints the same scene
+static int sceneRandom(uint *seed, int n)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return (*seed >> 16) % n;
+}
+
+static void paintPathScene(QPainter *p, const QSize &size)
+{
+    uint seed = 1;
+
+    p->fillRect(QRect(QPoint(0, 0), size), Qt::white);
+    p->setRenderHint(QPainter::Antialiasing);
+    for (int i = 0; i < 2000; ++i) {
+        const QPointF c(sceneRandom(&seed, size.width()), sceneRandom(&seed, size.height()));
+        const qreal r = 8 + sceneRandom(&seed, 56);
+
+        QPainterPath path;
+        path.moveTo(c + QPointF(r, 0));
+        for (int j = 1; j < 7; ++j) {
+            const qreal a = j * 2 * M_PI / 7;
+            const qreal rr = (j & 1) ? r / 2 : r;
+            path.quadTo(c + QPointF(r * cos(a - 0.4), r * sin(a - 0.4)),
+                        c + QPointF(rr * cos(a), rr * sin(a)));
+        }
+        path.closeSubpath();
+
+        QLinearGradient gradient(c - QPointF(r, r), c + QPointF(r, r));
+        gradient.setColorAt(0, QColor::fromRgb(sceneRandom(&seed, 256), sceneRandom(&seed, 256), sceneRandom(&seed, 256), 128 + sceneRandom(&seed, 128)));
+        gradient.setColorAt(1, QColor::fromRgb(sceneRandom(&seed, 256), sceneRandom(&seed, 256), sceneRandom(&seed, 256), 128 + sceneRandom(&seed, 128)));
+        p->setBrush(gradient);
+        p->setPen(QPen(QColor::fromRgb(sceneRandom(&seed, 256), sceneRandom(&seed, 256), sceneRandom(&seed, 256)), 1 + sceneRandom(&seed, 3)));
+        p->drawPath(path);
+    }
+}
+
+void tst_QPainter::tiledRasterDevice()
+{
+    QFETCH(int, threads);
+
+    QImage image(2048, 2048, QImage::Format_ARGB32_Premultiplied);
+    QTiledRasterDevice device(&image);
+    if (threads) {
+        device.setThreadCount(threads);
+        QThreadPool::globalInstance()->setMaxThreadCount(qMax(threads, QThread::idealThreadCount()));
+    }
+
+    QBENCHMARK {
+        QPainter p;
+        if (threads)
+            p.begin(&device);
+        else
+            p.begin(&image);
+        paintPathScene(&p, image.size());
+    }
+}
+
+void tst_QPainter::drawPolylines_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::addColumn<QPen>("pen");
+    QTest::addColumn<bool>("antialiased");
+
+    const QPen cosmetic(Qt::darkGray, 0);
+    const QPen wide(Qt::darkGray, 2.5);
+    QTest::newRow("single, cosmetic") << false << cosmetic << false;
+    QTest::newRow("batched, cosmetic") << true << cosmetic << false;
+    QTest::newRow("single, cosmetic antialiased") << false << cosmetic << true;
+    QTest::newRow("batched, cosmetic antialiased") << true << cosmetic << true;
+    QTest::newRow("single, wide antialiased") << false << wide << true;
+    QTest::newRow("batched, wide antialiased") << true << wide << true;
+}
+
+void tst_QPainter::drawPolylines()
+{
+    QFETCH(bool, batched);
+    QFETCH(QPen, pen);
+    QFETCH(bool, antialiased);
+
+    // 100k short polylines, like the roads of a map
+    uint seed = 1;
+    QVector<QPolygonF> polylines(100000);
+    for (int i = 0; i < polylines.size(); ++i) {
+        QPointF point(sceneRandom(&seed, 1024), sceneRandom(&seed, 1024));
+        QPolygonF &polyline = polylines[i];
+        polyline.reserve(5);
+        polyline << point;
+        for (int j = 0; j < 4; ++j) {
+            point += QPointF(sceneRandom(&seed, 17) - 8, sceneRandom(&seed, 17) - 8);
+            polyline << point;
+        }
+    }
+
+    QImage image(1024, 1024, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter p(&image);
+    p.setRenderHint(QPainter::Antialiasing, antialiased);
+    p.setPen(pen);
+
+    QBENCHMARK {
+        if (batched) {
+            p.drawPolylines(polylines);
+        } else {
+            for (int i = 0; i < polylines.size(); ++i)
+                p.drawPolyline(polylines.at(i));
+        }
+    }
+}
+
 QTEST_MAIN(tst_QPainter)
 
 #include "tst_qpainter.moc"
@@ -40,6 +40,7 @@
 ****************************************************************************/
 
 #include <QNetworkDiskCache>
+#include <QNetworkIndexedDiskCache>
 #include <QNetworkCacheMetaData>
 #include <QDir>
 #include <QBuffer>
@@ -55,6 +56,7 @@ enum Numbers { NumFakeCacheObjects   = 200,    //entries in pre-populated cache
                NumInsertions  = 100,           //insertions to be timed
                NumRemovals    = 100,           //removals to be timed
                NumReadContent = 100,           //meta requests to be timed
+               NumStartupObjects = 5000,       //entries in the cache opened by timeStartup
                HugeCacheLimit = 50*1024*1024,  // max size for a big cache
                TinyCacheLimit = 1*512*1024}; //  max size for a tiny cache
 
@@ -66,14 +68,17 @@ class tst_qnetworkdiskcache : public QObject
 {
     Q_OBJECT
 private:
-    void injectFakeData();
+    void addCacheRows();
+    void setCacheDirectory(const QString &path);
+    void setMaximumCacheSize(qint64 size);
+    void injectFakeData(quint32 count = NumFakeCacheObjects);
     void insertOneItem();
     bool isUrlCached(quint32 id);
     void cleanRecursive(QString &path);
     void cleanupCacheObject();
-    void initCacheObject();
+    void initCacheObject(bool indexed);
     QString cacheDir;
-    QNetworkDiskCache *cache;
+    QAbstractNetworkCache *cache;
 
 public slots:
     void initTestCase();
@@ -90,6 +95,9 @@ private slots:
 
     void timeExpiration_data();
     void timeExpiration();
+
+    void timeStartup_data();
+    void timeStartup();
 };
 
 
@@ -107,10 +115,7 @@ void tst_qnetworkdiskcache::cleanupTestCase()
 
 void tst_qnetworkdiskcache::timeInsertion_data()
 {
-    QTest::addColumn<QString>("cacheRootDirectory");
-
-    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+    addCacheRows();
 }
 
 //This functions times an insert() operation.
@@ -121,6 +126,7 @@ void tst_qnetworkdiskcache::timeInsertion()
 {
 
     QFETCH(QString, cacheRootDirectory);
+    QFETCH(bool, indexed);
 
     cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
     QDir d;
@@ -128,10 +134,10 @@ void tst_qnetworkdiskcache::timeInsertion()
 
     //Housekeeping
     cleanRecursive(cacheDir); // slow op.
-    initCacheObject();
+    initCacheObject(indexed);
 
-    cache->setCacheDirectory(cacheDir);
-    cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    setCacheDirectory(cacheDir);
+    setMaximumCacheSize(qint64(HugeCacheLimit));
     cache->clear();
 
     //populate some fake data to simulate partially full cache
@@ -168,10 +174,7 @@ void tst_qnetworkdiskcache::timeInsertion()
 
 void tst_qnetworkdiskcache::timeRead_data()
 {
-    QTest::addColumn<QString>("cacheRootDirectory");
-
-    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+    addCacheRows();
 }
 
 //Times metadata as well payload lookup
@@ -180,6 +183,7 @@ void tst_qnetworkdiskcache::timeRead()
 {
 
     QFETCH(QString, cacheRootDirectory);
+    QFETCH(bool, indexed);
 
     cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
     QDir d;
@@ -187,9 +191,9 @@ void tst_qnetworkdiskcache::timeRead()
 
     //Housekeeping
     cleanRecursive(cacheDir); // slow op.
-    initCacheObject();
-    cache->setCacheDirectory(cacheDir);
-    cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    initCacheObject(indexed);
+    setCacheDirectory(cacheDir);
+    setMaximumCacheSize(qint64(HugeCacheLimit));
     cache->clear();
 
     //populate some fake data to simulate partially full cache
@@ -227,27 +231,25 @@ void tst_qnetworkdiskcache::timeRead()
 
 void tst_qnetworkdiskcache::timeRemoval_data()
 {
-    QTest::addColumn<QString>("cacheRootDirectory");
-
-    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+    addCacheRows();
 }
 
 void tst_qnetworkdiskcache::timeRemoval()
 {
 
     QFETCH(QString, cacheRootDirectory);
+    QFETCH(bool, indexed);
 
     cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
     QDir d;
     qDebug() << "Setting cache directory to = " << d.absoluteFilePath(cacheDir);
 
     //Housekeeping
-    initCacheObject();
+    initCacheObject(indexed);
     cleanRecursive(cacheDir); // slow op.
-    cache->setCacheDirectory(cacheDir);
+    setCacheDirectory(cacheDir);
     // Make max cache size HUGE, so that evictions don't happen below
-    cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    setMaximumCacheSize(qint64(HugeCacheLimit));
     cache->clear();
 
     //populate some fake data to simulate partially full cache
@@ -277,27 +279,25 @@ void tst_qnetworkdiskcache::timeRemoval()
 
 void tst_qnetworkdiskcache::timeExpiration_data()
 {
-    QTest::addColumn<QString>("cacheRootDirectory");
-
-    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+    addCacheRows();
 }
 
 void tst_qnetworkdiskcache::timeExpiration()
 {
 
     QFETCH(QString, cacheRootDirectory);
+    QFETCH(bool, indexed);
 
     cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
     QDir d;
     qDebug() << "Setting cache directory to = " << d.absoluteFilePath(cacheDir);
 
     //Housekeeping
-    initCacheObject();
+    initCacheObject(indexed);
     cleanRecursive(cacheDir); // slow op.
-    cache->setCacheDirectory(cacheDir);
+    setCacheDirectory(cacheDir);
     // Make max cache size HUGE, so that evictions don't happen below
-    cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    setMaximumCacheSize(qint64(HugeCacheLimit));
     cache->clear();
 
     //populate some fake data to simulate partially full cache
@@ -310,7 +310,7 @@ void tst_qnetworkdiskcache::timeExpiration()
 
 
     //Set cache limit lower, so this force 1 round of eviction
-    cache->setMaximumCacheSize(qint64(TinyCacheLimit));
+    setMaximumCacheSize(qint64(TinyCacheLimit));
 
     //time insertions of additional content, which is likely to internally cause evictions
     QBENCHMARK_ONCE {
@@ -336,11 +336,72 @@ void tst_qnetworkdiskcache::timeExpiration()
     cleanRecursive(cacheDir);
 
 }
+void tst_qnetworkdiskcache::timeStartup_data()
+{
+    addCacheRows();
+}
+
+// Times opening a large cache and finding out its size, which
+// QNetworkDiskCache does by scanning the cache directory.
+void tst_qnetworkdiskcache::timeStartup()
+{
+    QFETCH(QString, cacheRootDirectory);
+    QFETCH(bool, indexed);
+
+    cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
+
+    //Housekeeping
+    cleanRecursive(cacheDir); // slow op.
+    initCacheObject(indexed);
+    setCacheDirectory(cacheDir);
+    setMaximumCacheSize(qint64(HugeCacheLimit));
+    cache->clear();
+    injectFakeData(NumStartupObjects);
+    cleanupCacheObject();
+
+    QBENCHMARK_ONCE {
+        initCacheObject(indexed);
+        setCacheDirectory(cacheDir);
+        QVERIFY(cache->cacheSize() > 0);
+        QVERIFY(isUrlCached(NumStartupObjects - 1));
+    }
+
+    //Cleanup (slow)
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
+void tst_qnetworkdiskcache::addCacheRows()
+{
+    QTest::addColumn<QString>("cacheRootDirectory");
+    QTest::addColumn<bool>("indexed");
+
+    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QTest::newRow("QNetworkDiskCache") << cacheLoc << false;
+    QTest::newRow("QNetworkIndexedDiskCache") << cacheLoc << true;
+}
+
+void tst_qnetworkdiskcache::setCacheDirectory(const QString &path)
+{
+    if (QNetworkIndexedDiskCache *indexedCache = qobject_cast<QNetworkIndexedDiskCache *>(cache))
+        indexedCache->setCacheDirectory(path);
+    else
+        static_cast<QNetworkDiskCache *>(cache)->setCacheDirectory(path);
+}
+
+void tst_qnetworkdiskcache::setMaximumCacheSize(qint64 size)
+{
+    if (QNetworkIndexedDiskCache *indexedCache = qobject_cast<QNetworkIndexedDiskCache *>(cache))
+        indexedCache->setMaximumCacheSize(size);
+    else
+        static_cast<QNetworkDiskCache *>(cache)->setMaximumCacheSize(size);
+}
+
 // This function simulates a partially or fully occupied disk cache
 // like a normal user of a cache might encounter is real-life browsing.
 // The point of this is to trigger degradation in file-system and media performance
 // that occur due to the quantity and layout of data.
-void tst_qnetworkdiskcache::injectFakeData()
+void tst_qnetworkdiskcache::injectFakeData(quint32 count)
 {
 
     QNetworkCacheMetaData::RawHeaderList headers;
@@ -348,7 +409,7 @@ void tst_qnetworkdiskcache::injectFakeData()
 
 
     //Prep cache dir with fake data using QNetworkDiskCache APIs
-    for (quint32 i = 0; i < NumFakeCacheObjects; i++) {
+    for (quint32 i = 0; i < count; i++) {
 
         //prepare metata for url
         QNetworkCacheMetaData meta;
@@ -406,11 +467,12 @@ void tst_qnetworkdiskcache::cleanupCacheObject()
     cache = 0;
 }
 
-void tst_qnetworkdiskcache::initCacheObject()
+void tst_qnetworkdiskcache::initCacheObject(bool indexed)
 {
-
-   cache = new QNetworkDiskCache();
-
+    if (indexed)
+        cache = new QNetworkIndexedDiskCache();
+    else
+        cache = new QNetworkDiskCache();
 }
 QTEST_MAIN(tst_qnetworkdiskcache)
 #include "tst_qnetworkdiskcache.moc"
@@ -429,6 +429,44 @@ public slots:
     }
 };
 
+class CompressedHttpDownloadPerformanceServer : QObject {
+    Q_OBJECT
+    QByteArray body;
+    QByteArray contentEncoding;
+    QTcpServer server;
+    QTcpSocket *client;
+
+public:
+    CompressedHttpDownloadPerformanceServer(const QByteArray &b, const QByteArray &ce)
+        : body(b), contentEncoding(ce), client(0) {
+        server.listen();
+        connect(&server, SIGNAL(newConnection()), this, SLOT(newConnectionSlot()));
+    }
+
+    int serverPort() {
+        return server.serverPort();
+    }
+
+public slots:
+    void newConnectionSlot() {
+        client = server.nextPendingConnection();
+        client->setParent(this);
+        connect(client, SIGNAL(readyRead()), this, SLOT(readyReadSlot()));
+    }
+
+    void readyReadSlot() {
+        client->readAll();
+        client->write("HTTP/1.1 200 OK\r\n");
+        if (!contentEncoding.isEmpty())
+            client->write("Content-Encoding: " + contentEncoding + "\r\n");
+        client->write("Content-Length: " + QByteArray::number(body.size()) + "\r\n");
+        client->write("Connection: close\r\n\r\n");
+        client->write(body);
+        client->disconnectFromHost();
+        server.close();
+    }
+};
+
 class HttpDownloadPerformanceClient : QObject {
     Q_OBJECT;
     QIODevice *device;
@@ -476,6 +514,8 @@ private slots:
     void httpDownloadPerformance();
     void httpDownloadPerformanceDownloadBuffer_data();
     void httpDownloadPerformanceDownloadBuffer();
+    void httpCompressedDownloadPerformance_data();
+    void httpCompressedDownloadPerformance();
     void httpsRequestChain();
     void httpsUpload();
     void preConnect_data();
@@ -778,7 +818,9 @@ void tst_qnetworkreply::httpDownloadPerformance()
 enum HttpDownloadPerformanceDownloadBufferTestType {
     JustDownloadBuffer,
     DownloadBufferButUseRead,
-    NoDownloadBuffer
+    NoDownloadBuffer,
+    UserDownloadBuffer,
+    DownloadToFile
 };
 Q_DECLARE_METATYPE(HttpDownloadPerformanceDownloadBufferTestType)
 
@@ -798,7 +840,7 @@ public:
 
     public slots:
     void finishedSlot() {
-        if (testType == JustDownloadBuffer) {
+        if (testType == JustDownloadBuffer || testType == UserDownloadBuffer) {
             // We have a download buffer and use it. This should be the fastest benchmark result.
             QVariant downloadBufferAttribute = reply->attribute(QNetworkRequest::DownloadBufferAttribute);
             QSharedPointer<char> data = downloadBufferAttribute.value<QSharedPointer<char> >();
@@ -813,6 +855,9 @@ public:
             char* replyData = (char*) malloc(uploadSize);
             QVERIFY(reply->read(replyData, uploadSize) == uploadSize);
             free(replyData);
+        } else if (testType == DownloadToFile) {
+            // The data was written to the file by the network thread, there is nothing left to read.
+            QVERIFY(reply->bytesAvailable() == 0);
         }
 
         QMetaObject::invokeMethod(&QTestEventLoop::instance(), "exitLoop", Qt::QueuedConnection);
@@ -826,6 +871,13 @@ void tst_qnetworkreply::httpDownloadPerformanceDownloadBuffer_data()
     QTest::newRow("use-download-buffer") << JustDownloadBuffer;
     QTest::newRow("use-download-buffer-but-use-read") << DownloadBufferButUseRead;
     QTest::newRow("do-not-use-download-buffer") << NoDownloadBuffer;
+    QTest::newRow("use-user-download-buffer") << UserDownloadBuffer;
+    QTest::newRow("download-to-file") << DownloadToFile;
+}
+
+static void userDownloadBufferDeleter(char *ptr)
+{
+    delete[] ptr;
 }
 
 // Please note that the whole "zero copy" download buffer API is private right now. Do not use it.
@@ -846,6 +898,16 @@ void tst_qnetworkreply::httpDownloadPerformanceDownloadBuffer()
     QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/?bare=1"));
     if (testType == JustDownloadBuffer || testType == DownloadBufferButUseRead)
         request.setAttribute(QNetworkRequest::MaximumDownloadBufferSizeAttribute, 1024*1024*128); // 128 MB is max allowed
+    if (testType == UserDownloadBuffer) {
+        QSharedPointer<char> buffer(new char[UploadSize], userDownloadBufferDeleter);
+        request.setAttribute(QNetworkRequest::MaximumDownloadBufferSizeAttribute, int(UploadSize));
+        request.setAttribute(QNetworkRequest::UserDownloadBufferAttribute, QVariant::fromValue(buffer));
+    }
+    QTemporaryDir tempDir;
+    if (testType == DownloadToFile) {
+        QVERIFY(tempDir.isValid());
+        request.setAttribute(QNetworkRequest::DownloadFileNameAttribute, tempDir.path() + "/download");
+    }
 
     QNetworkAccessManager manager;
     QNetworkReplyPtr reply(manager.get(request));
@@ -860,6 +922,60 @@ void tst_qnetworkreply::httpDownloadPerformanceDownloadBuffer()
     }
 }
 
+void tst_qnetworkreply::httpCompressedDownloadPerformance_data()
+{
+    QTest::addColumn<QByteArray>("contentEncoding");
+
+    QTest::newRow("identity") << QByteArray();
+#ifndef QT_NO_COMPRESS
+    QTest::newRow("deflate") << QByteArray("deflate");
+#endif
+}
+
+void tst_qnetworkreply::httpCompressedDownloadPerformance()
+{
+    QFETCH(QByteArray, contentEncoding);
+#if defined(Q_OS_WINCE_WM)
+    // Show some mercy to non-desktop platform/s
+    enum {UncompressedSize = 4*1024*1024}; // 4 MB
+#else
+    enum {UncompressedSize = 64*1024*1024}; // 64 MB
+#endif
+
+    // text-like payload so that the compression ratio is realistic
+    QByteArray data;
+    data.reserve(UncompressedSize);
+    int line = 0;
+    while (data.size() < UncompressedSize)
+        data += "<tr><td>" + QByteArray::number(line++) + "</td><td>Lorem ipsum dolor sit amet</td></tr>\n";
+    data.truncate(UncompressedSize);
+
+    QByteArray body = data;
+#ifndef QT_NO_COMPRESS
+    // HTTP "deflate" is the zlib format; qCompress() prepends a 4 byte length
+    if (contentEncoding == "deflate")
+        body = qCompress(data).mid(4);
+#endif
+
+    CompressedHttpDownloadPerformanceServer server(body, contentEncoding);
+
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/?bare=1"));
+    QNetworkReplyPtr reply(manager.get(request));
+
+    connect(reply, SIGNAL(finished()), &QTestEventLoop::instance(), SLOT(exitLoop()), Qt::QueuedConnection);
+    HttpDownloadPerformanceClient client(reply.data());
+
+    QTime time;
+    time.start();
+    QTestEventLoop::instance().enterLoop(40);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+
+    qint64 elapsed = time.elapsed();
+    qDebug() << "tst_QNetworkReply::httpCompressedDownloadPerformance" << body.size() << "bytes on the wire,"
+             << elapsed << "msec, " << ((UncompressedSize/1024.0)/(elapsed/1000.0)) << " kB/sec";
+}
+
 
 class HttpsRequestChainHelper : public QObject {
     Q_OBJECT
@@ -49,6 +49,7 @@
 #include <qstringlist.h>
 #include <qplatformdefs.h>
 #include <qhostinfo.h>
+#include <qtemporaryfile.h>
 
 #include <QNetworkProxy>
 
@@ -72,6 +73,8 @@ private slots:
     void ipv4LoopbackPerformanceTest();
     void ipv6LoopbackPerformanceTest();
     void ipv4PerformanceTest();
+    void largeTransfer_data();
+    void largeTransfer();
 };
 
 tst_QTcpServer::tst_QTcpServer()
@@ -277,5 +280,62 @@ void tst_QTcpServer::ipv4PerformanceTest()
     delete clientB;
 }
 
+//----------------------------------------------------------------------------------
+void tst_QTcpServer::largeTransfer_data()
+{
+    QTest::addColumn<bool>("useWriteFile");
+
+    QTest::newRow("write") << false;
+    QTest::newRow("writeFile") << true;
+}
+
+void tst_QTcpServer::largeTransfer()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    QFETCH(bool, useWriteFile);
+
+    const qint64 fileSize = 64 * 1024 * 1024;
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    const QByteArray block(1024 * 1024, '@');
+    for (qint64 i = 0; i < fileSize; i += block.size())
+        QCOMPARE(file.write(block), qint64(block.size()));
+    QVERIFY(file.flush());
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QTcpSocket clientA;
+    clientA.connectToHost(QHostAddress::LocalHost, server.serverPort());
+    QVERIFY(clientA.waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection());
+    QTcpSocket *clientB = server.nextPendingConnection();
+    QVERIFY(clientB);
+
+    QByteArray buffer(256 * 1024, Qt::Uninitialized);
+    QBENCHMARK {
+        if (useWriteFile) {
+            QVERIFY(clientA.writeFile(&file));
+        } else {
+            QVERIFY(file.seek(0));
+            QCOMPARE(clientA.write(file.readAll()), fileSize);
+        }
+
+        qint64 received = 0;
+        while (received < fileSize) {
+            clientA.flush();
+            if (!clientB->bytesAvailable())
+                QVERIFY(clientB->waitForReadyRead(5000));
+            received += clientB->read(buffer.data(), buffer.size());
+        }
+        QCOMPARE(received, fileSize);
+        QCOMPARE(clientA.bytesToWrite(), qint64(0));
+    }
+
+    delete clientB;
+}
+
 QTEST_MAIN(tst_QTcpServer)
 #include "tst_qtcpserver.moc"
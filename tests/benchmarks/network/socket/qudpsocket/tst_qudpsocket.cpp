@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtNetwork/QUdpSocket>
+
+class tst_QUdpSocket : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void loopbackThroughput_data();
+    void loopbackThroughput();
+};
+
+void tst_QUdpSocket::loopbackThroughput_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("one-by-one, 64 bytes") << false << 64;
+    QTest::newRow("batched, 64 bytes") << true << 64;
+    QTest::newRow("one-by-one, 512 bytes") << false << 512;
+    QTest::newRow("batched, 512 bytes") << true << 512;
+    QTest::newRow("one-by-one, 1400 bytes") << false << 1400;
+    QTest::newRow("batched, 1400 bytes") << true << 1400;
+}
+
+void tst_QUdpSocket::loopbackThroughput()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, size);
+
+    // rounds of datagrams small enough to never overflow the receive buffer
+    const int rounds = 100;
+    const int count = 64;
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost)));
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 1024 * 1024);
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress(QHostAddress::LocalHost)));
+    const QHostAddress address = QHostAddress::LocalHost;
+    const quint16 port = receiver.localPort();
+
+    QByteArray payload(size * count, 'x');
+    QVector<const char *> data(count);
+    QVector<qint64> sizes(count, size);
+    for (int i = 0; i < count; ++i)
+        data[i] = payload.constData() + i * size;
+    QByteArray buffer(size * count, '\0');
+    QVector<qint64> receivedSizes(count);
+
+    QBENCHMARK {
+        for (int round = 0; round < rounds; ++round) {
+            if (batched) {
+                QCOMPARE(sender.writeDatagrams(data.constData(), sizes.constData(), count,
+                                               address, port), count);
+            } else {
+                for (int i = 0; i < count; ++i)
+                    QCOMPARE(sender.writeDatagram(data.at(i), size, address, port), qint64(size));
+            }
+
+            int received = 0;
+            while (received < count) {
+                if (!receiver.hasPendingDatagrams())
+                    QVERIFY(receiver.waitForReadyRead(5000));
+                if (batched) {
+                    const int n = receiver.readDatagrams(buffer.data() + received * size, size,
+                                                         count - received,
+                                                         receivedSizes.data() + received);
+                    QVERIFY(n >= 0);
+                    received += n;
+                } else {
+                    QCOMPARE(receiver.readDatagram(buffer.data() + received * size, size),
+                             qint64(size));
+                    ++received;
+                }
+            }
+        }
+    }
+}
+
+QTEST_MAIN(tst_QUdpSocket)
+
+#include "tst_qudpsocket.moc"